@@ -22,6 +22,12 @@ ifeq ($(SUPPORT_M), 1)
     DEFINES += -DSUPPORT_M
 endif
 
+# Modify ARCH and DEFINES if SUPPORT_C is set
+ifeq ($(SUPPORT_C), 1)
+	ARCH := $(ARCH)c
+    DEFINES += -DSUPPORT_C
+endif
+
 # Modify ARCH and DEFINES if SUPPORT_M is set
 ifeq ($(SUPPORT_B), 1)
 	ARCH := $(ARCH)_zic64b_zicbom_zicbop
@@ -34,6 +40,126 @@ ifeq ($(SUPPORT_ZICSR), 1)
     DEFINES += -DSUPPORT_ZICSR
 endif
 
+# Modify ARCH and DEFINES if SUPPORT_ZAAMO is set
+ifeq ($(SUPPORT_ZAAMO), 1)
+	ARCH := $(ARCH)_zaamo
+    DEFINES += -DSUPPORT_ZAAMO
+endif
+
+# Add the instruction cache in front of tl_interface if SUPPORT_ICACHE is set
+ifeq ($(SUPPORT_ICACHE), 1)
+    DEFINES += -DSUPPORT_ICACHE
+endif
+
+# Add the write-through data cache and store buffer if SUPPORT_DCACHE is set
+ifeq ($(SUPPORT_DCACHE), 1)
+    DEFINES += -DSUPPORT_DCACHE
+endif
+
+# Put the cpu_tcm scratchpad on the tl_cpu load/store path if SUPPORT_TCM is set, start.S puts the stack there.
+# TCM_BASE and TCM_SIZE have to match the TCM_BASE/TCM_SIZE parameters of tl_cpu.sv
+TCM_BASE ?= 0x00100000
+TCM_SIZE ?= 4096
+ifeq ($(SUPPORT_TCM), 1)
+ifeq ($(PIPELINED), 1)
+    $(error SUPPORT_TCM=1 is only supported by tl_cpu.sv, not with PIPELINED=1)
+endif
+    DEFINES += -DSUPPORT_TCM -DTCM_BASE=$(TCM_BASE) -DTCM_SIZE=$(TCM_SIZE)
+endif
+
+# Link the bios .data and .bss into the scratchpad if TCM_DATA is set, start.S sets them up on every hart
+ifeq ($(TCM_DATA), 1)
+ifneq ($(SUPPORT_TCM), 1)
+    $(error TCM_DATA=1 needs SUPPORT_TCM=1)
+endif
+    DEFINES += -DTCM_DATA
+endif
+
+# Fetch the predicted target of jumps and branches early if BRANCH_PREDICT is set
+ifeq ($(BRANCH_PREDICT), 1)
+    DEFINES += -DBRANCH_PREDICT
+endif
+
+# Execute ALU and Zba/Zbb/Zbs operations on the shared data paths of cpu_exu.sv if FUSED_EXU is set
+ifeq ($(FUSED_EXU), 1)
+    DEFINES += -DFUSED_EXU
+endif
+
+# Read registers combinationally in tl_cpu.sv, skipping STATE_ID and STATE_WB for ALU ops, if FAST_REGFILE is set
+ifeq ($(FAST_REGFILE), 1)
+    DEFINES += -DFAST_REGFILE
+endif
+
+# Use the pipelined multiplier and radix-4 divider in cpu_mdu.sv if MDU_FAST is set
+ifeq ($(MDU_FAST), 1)
+    DEFINES += -DMDU_FAST
+endif
+
+# Build tl_switch as a crossbar with per-slave arbiters if SWITCH_CROSSBAR is set
+ifeq ($(SWITCH_CROSSBAR), 1)
+    DEFINES += -DSWITCH_CROSSBAR
+endif
+
+# Decode tl_switch slaves with a mask compare instead of a range compare if SWITCH_DECODE_MASK is set
+ifeq ($(SWITCH_DECODE_MASK), 1)
+    DEFINES += -DSWITCH_DECODE_MASK
+endif
+
+# Register the tl_switch address decode if SWITCH_DECODE_REG is set
+ifeq ($(SWITCH_DECODE_REG), 1)
+    DEFINES += -DSWITCH_DECODE_REG
+endif
+
+# Accept TL-UH multi-beat bursts in tl_switch and tl_memory if TL_BURST is set
+ifeq ($(TL_BURST), 1)
+    DEFINES += -DTL_BURST
+endif
+
+# Build tl_memory on an XLEN wide byte-enable block_ram if MEM_WIDE is set
+ifeq ($(MEM_WIDE), 1)
+    DEFINES += -DMEM_WIDE
+endif
+
+# Count per master and per slave transactions and latency in tl_switch if BUS_STATS is set
+ifeq ($(BUS_STATS), 1)
+    DEFINES += -DBUS_STATS
+endif
+
+# Put NUM_HARTS cores on the tl_soc switch if NUM_HARTS is set, start.S needs mhartid for it
+ifneq ($(NUM_HARTS),)
+ifneq ($(NUM_HARTS), 1)
+ifneq ($(SUPPORT_ZICSR), 1)
+    $(error NUM_HARTS=$(NUM_HARTS) needs SUPPORT_ZICSR=1)
+endif
+endif
+    DEFINES += -DNUM_HARTS=$(NUM_HARTS)
+endif
+
+# Use the pipelined CPU core (tl_cpu_pipe.sv) instead of tl_cpu.sv if PIPELINED is set
+PIPELINED_UNSUPPORTED := SUPPORT_C SUPPORT_ZAAMO FUSED_EXU FAST_REGFILE BRANCH_PREDICT
+ifeq ($(PIPELINED), 1)
+$(foreach flag,$(PIPELINED_UNSUPPORTED),$(if $(filter 1,$($(flag))),\
+    $(error $(flag)=1 is only supported by tl_cpu.sv, not with PIPELINED=1)))
+    DEFINES += -DPIPELINED
+endif
+
+# Clock tl_soc.sv from an rPLL at about PLL_MHZ MHz if PLL_MHZ is set, etc/scripts/gowin_pll.py picks the dividers
+ifneq ($(PLL_MHZ),)
+    DEFINES += -DCLK_PLL -DPLL_DEVICE=\"$(FAMILY)\" $(shell python etc/scripts/gowin_pll.py $(PLL_MHZ) -f $(FAMILY) -d)
+endif
+
+# Bios compiler flags, BIOS_OPT=-O2 trades ROM space for speed and BIOS_LTO=0 turns off link time optimization
+BIOS_OPT ?= -Os
+BIOS_LTO ?= 1
+BIOS_CFLAGS := $(DEFINES) -march=$(ARCH) -mabi=$(ABI) -mcmodel=medany $(BIOS_OPT) -ffreestanding \
+               -ffunction-sections -fdata-sections -nostartfiles -nostdlib
+ifeq ($(BIOS_LTO), 1)
+    BIOS_CFLAGS += -flto
+endif
+
+# etc/lib runtime, kept out of LTO and loop pattern matching so GCC's own memcpy/memset calls resolve to it
+LIB_CFLAGS := -fno-lto -fno-tree-loop-distribute-patterns
+
 all:
 	@echo "################################################################################"
 	@echo "#                                                                              #"
@@ -44,10 +170,13 @@ all:
 	@echo "make p_soc ................. Build a SOC with a paralell bus"
 	@echo "make tl_soc ................ Build a SOC with a TileLink bus"
 	@echo "make load .................. Load the built SoC to the FPGA"
+	@echo "make timing ................ Place and route the SoCs, report Fmax and usage"
 	@echo ""
 	@echo "make test .................. Run all testbenches"
 	@echo "make run_cpu ............... Simulate the cpu in iverilog"
 	@echo "make run_soc ............... Simulate the soc in iverilog"
+	@echo "make run_sim ............... Simulate the cpu in verilator"
+	@echo "make bench ................. Run the benchmarks in verilator"
 
 ##
 # SOC Build 1
@@ -58,23 +187,26 @@ p_soc: bios out
 # Compile a C program in riscv asm
 bios: etc/main.c
 	echo $(ARCH)
-	riscv64-unknown-elf-gcc $(DEFINES) -c -fPIC -march=$(ARCH) -mabi=$(ABI) -nostartfiles -nostdlib -o etc/bios/start.o etc/bios/start.S
-	riscv64-unknown-elf-gcc $(DEFINES) -c -fPIC -march=$(ARCH) -mabi=$(ABI) -nostartfiles -nostdlib -o etc/bios/bios.o etc/bios/bios.c
-	riscv64-unknown-elf-ld -m $(MACHINE) -o etc/bios/program.o etc/bios/start.o etc/bios/bios.o
-	riscv64-unknown-elf-objcopy -O binary etc/bios/program.o etc/bios/bios.bin
+	riscv64-unknown-elf-gcc $(DEFINES) -E -P -x c -o etc/bios/bios.ld etc/bios/bios.lds
+	riscv64-unknown-elf-gcc $(BIOS_CFLAGS) -c -o etc/bios/start.o etc/bios/start.S
+	riscv64-unknown-elf-gcc $(BIOS_CFLAGS) -c -o etc/bios/bios.o etc/bios/bios.c
+	riscv64-unknown-elf-gcc $(BIOS_CFLAGS) $(LIB_CFLAGS) -c -o etc/bios/string.o etc/lib/string.c
+	riscv64-unknown-elf-gcc $(BIOS_CFLAGS) -T etc/bios/bios.ld -Wl,--gc-sections -o etc/bios/program.elf etc/bios/start.o etc/bios/bios.o etc/bios/string.o -lgcc
+	riscv64-unknown-elf-size -A etc/bios/program.elf
+	riscv64-unknown-elf-objcopy -O binary etc/bios/program.elf etc/bios/bios.bin
+	@echo "bios.bin uses $$(stat -c %s etc/bios/bios.bin) of 256 ROM bytes"
 	riscv64-unknown-elf-objdump -D -b binary -m riscv:$(RV) -M numeric etc/bios/bios.bin > etc/bios/bios.opcodes
-	hexdump -v -e '1/1 "%02x\n"' etc/bios/bios.bin | \
-	awk 'BEGIN {desired=256} {print; count++} END {for(i=count+1;i<=desired;i++) print "00"}' > etc/bios/bios.hex
-	rm etc/bios/*.o
+	python etc/scripts/bin_to_sv_mem.py etc/bios/bios.bin etc/bios/bios.hex -f hex -x 8 -p 256
+	rm etc/bios/*.o etc/bios/program.elf etc/bios/bios.ld
 
 
 # Synthesis
 synthesis: src/p_soc.sv
 	mkdir -p ./graph
-	yosys -D SYNTHESIS -q -p "read_verilog -sv -I src/ src/p_soc.sv; hierarchy -check; check; show -colors 1 -width -signed -stretch -prefix graph/soc -format dot; synth_gowin -top top -noabc9 -json synthesis.json"
+	yosys -D SYNTHESIS $(DEFINES) -q -p "read_verilog -sv -I src/ src/p_soc.sv; hierarchy -check; check; show -colors 1 -width -signed -stretch -prefix graph/soc -format dot; synth_gowin -top top -noabc9 -json synthesis.json"
 
 stat:
-	yosys -D SYNTHESIS -p "read_verilog -sv src/p_soc.sv; hierarchy -check; check; synth_gowin -top top -noabc9; stat -hier"
+	yosys -D SYNTHESIS $(DEFINES) -p "read_verilog -sv -I src/ src/p_soc.sv; hierarchy -check; check; synth_gowin -top top -noabc9; stat -hier"
 
 # Place and Route
 bitstream: synthesis
@@ -93,23 +225,26 @@ tl_soc: bios2 out2
 # Compile a C program in riscv asm
 bios2: etc/main.c
 	echo $(ARCH)
-	riscv64-unknown-elf-gcc $(DEFINES) -c -fPIC -march=$(ARCH) -mabi=$(ABI) -nostartfiles -nostdlib -o etc/bios/start.o etc/bios/start.S
-	riscv64-unknown-elf-gcc $(DEFINES) -c -fPIC -march=$(ARCH) -mabi=$(ABI) -nostartfiles -nostdlib -o etc/bios/bios.o etc/bios/bios.c
-	riscv64-unknown-elf-ld -m $(MACHINE) -o etc/bios/program.o etc/bios/start.o etc/bios/bios.o
-	riscv64-unknown-elf-objcopy -O binary etc/bios/program.o etc/bios/bios.bin
+	riscv64-unknown-elf-gcc $(DEFINES) -E -P -x c -o etc/bios/bios.ld etc/bios/bios.lds
+	riscv64-unknown-elf-gcc $(BIOS_CFLAGS) -c -o etc/bios/start.o etc/bios/start.S
+	riscv64-unknown-elf-gcc $(BIOS_CFLAGS) -c -o etc/bios/bios.o etc/bios/bios.c
+	riscv64-unknown-elf-gcc $(BIOS_CFLAGS) $(LIB_CFLAGS) -c -o etc/bios/string.o etc/lib/string.c
+	riscv64-unknown-elf-gcc $(BIOS_CFLAGS) -T etc/bios/bios.ld -Wl,--gc-sections -o etc/bios/program.elf etc/bios/start.o etc/bios/bios.o etc/bios/string.o -lgcc
+	riscv64-unknown-elf-size -A etc/bios/program.elf
+	riscv64-unknown-elf-objcopy -O binary etc/bios/program.elf etc/bios/bios.bin
+	@echo "bios.bin uses $$(stat -c %s etc/bios/bios.bin) of 256 ROM bytes"
 	riscv64-unknown-elf-objdump -D -b binary -m riscv:$(RV) -M numeric etc/bios/bios.bin > etc/bios/bios.opcodes
-	hexdump -v -e '1/1 "%02x\n"' etc/bios/bios.bin | \
-	awk 'BEGIN {desired=256} {print; count++} END {for(i=count+1;i<=desired;i++) print "00"}' > etc/bios/bios.hex
-	rm etc/bios/*.o
+	python etc/scripts/bin_to_sv_mem.py etc/bios/bios.bin etc/bios/bios.hex -f hex -x 8 -p 256
+	rm etc/bios/*.o etc/bios/program.elf etc/bios/bios.ld
 
 
 # Synthesis
 synthesis2: src/tl_soc.sv
 	mkdir -p ./graph
-	yosys -D SYNTHESIS -q -p "read_verilog -sv -I src/ src/tl_soc.sv; hierarchy -check; check; show -colors 1 -width -signed -stretch -prefix graph/soc -format dot; synth_gowin -top top -noabc9 -json synthesis.json"
+	yosys -D SYNTHESIS $(DEFINES) -q -p "read_verilog -sv -I src/ src/tl_soc.sv; hierarchy -check; check; show -colors 1 -width -signed -stretch -prefix graph/soc -format dot; synth_gowin -top top -noabc9 -json synthesis.json"
 
 stat2:
-	yosys -D SYNTHESIS -p "read_verilog -sv src/tl_soc.sv; hierarchy -check; check; synth_gowin -top top -noabc9; stat -hier"
+	yosys -D SYNTHESIS $(DEFINES) -p "read_verilog -sv -I src/ src/tl_soc.sv; hierarchy -check; check; synth_gowin -top top -noabc9; stat -hier"
 
 # Place and Route
 bitstream2: synthesis2
@@ -131,6 +266,37 @@ graph:
 load:
 	openFPGALoader -b ${BOARD} out.fs -f
 
+##
+# Timing
+##
+
+# `make timing` synthesizes and places and routes every TIMING_SOCS top for every
+# TIMING_CONFIGS entry (make flags separated by commas) against a TIMING_FREQ MHz clock.
+# nextpnr writes a JSON report per run, etc/scripts/timing_report.py collects Fmax, the critical
+# path and the LUT/FF/BRAM/DSP usage into graph/timing/timing.json and prints a table.
+TIMING_SOCS ?= p_soc tl_soc
+TIMING_CONFIGS ?= XLEN=32 XLEN=32,SUPPORT_M=1,SUPPORT_ZICSR=1 XLEN=32,SUPPORT_M=1,SUPPORT_ZICSR=1,SUPPORT_B=1 \
+                  XLEN=32,PIPELINED=1 XLEN=32,SUPPORT_ICACHE=1,SUPPORT_DCACHE=1 XLEN=64,SUPPORT_M=1,SUPPORT_ZICSR=1
+TIMING_FREQ ?= $(if $(PLL_MHZ),$(PLL_MHZ),27)
+TIMING_DIR := graph/timing/$(TIMING_NAME)
+
+timing:
+	rm -rf graph/timing
+	$(foreach soc,$(TIMING_SOCS),$(foreach cfg,$(TIMING_CONFIGS),$(MAKE) --no-print-directory timing_run \
+		TIMING_SOC=$(soc) TIMING_NAME=$(soc)_$(subst =,,$(subst $(comma),_,$(cfg))) TIMING_CONFIG=$(cfg) \
+		$(subst $(comma), ,$(cfg)) &&)) true
+	python etc/scripts/timing_report.py graph/timing/*/run.txt --save graph/timing/timing.json
+
+# One TIMING_SOCS / TIMING_CONFIGS pair, a design that does not route is reported as failed
+timing_run: bios
+	mkdir -p $(TIMING_DIR)
+	echo "$(TIMING_SOC) $(TIMING_CONFIG) $(TIMING_FREQ)" > $(TIMING_DIR)/run.txt
+	yosys -D SYNTHESIS $(DEFINES) -q -l $(TIMING_DIR)/yosys.log -p "read_verilog -sv -I src/ src/$(TIMING_SOC).sv; \
+		synth_gowin -top top -noabc9 -json $(TIMING_DIR)/synthesis.json"
+	nextpnr-himbaechel --json $(TIMING_DIR)/synthesis.json --write $(TIMING_DIR)/bitstream.json \
+		--device ${DEVICE} --vopt family=${FAMILY} --vopt cst=etc/boards/${BOARD}.cst --freq $(TIMING_FREQ) --timing-allow-fail \
+		--report $(TIMING_DIR)/report.json --log $(TIMING_DIR)/nextpnr.log --quiet || true
+
 # Remove temp files
 clean:
 	rm -f etc/bios/bios.hex
@@ -148,17 +314,19 @@ clean:
 # Compile a C program in riscv asm
 asm: etc/main.c
 	echo $(ARCH)
-	rm -f etc/program.sv
+	rm -f etc/program.hex
 	riscv64-unknown-elf-gcc $(DEFINES) -c -fPIC -march=$(ARCH) -mabi=$(ABI) -nostartfiles -nostdlib -o etc/start.o etc/start.S
 	riscv64-unknown-elf-gcc $(DEFINES) -c -fPIC -march=$(ARCH) -mabi=$(ABI) -nostartfiles -nostdlib -o etc/main.o etc/main.c
-	riscv64-unknown-elf-ld -m $(MACHINE) -o etc/program.o etc/start.o etc/main.o
+	riscv64-unknown-elf-gcc $(DEFINES) -c -fPIC -O2 $(LIB_CFLAGS) -march=$(ARCH) -mabi=$(ABI) -nostartfiles -nostdlib -o etc/string.o etc/lib/string.c
+	riscv64-unknown-elf-ld -m $(MACHINE) -o etc/program.o etc/start.o etc/main.o etc/string.o
 	riscv64-unknown-elf-objcopy -O binary etc/program.o etc/program.bin
 	riscv64-unknown-elf-objdump -D -b binary -m riscv:$(RV) -M numeric etc/program.bin > etc/program.opcodes
 
 run_cpu: asm
 	mkdir -p ./graph
 
-	python etc/scripts/bin_to_sv_mem.py etc/program.bin etc/program.sv etc/program.opcodes -m mock_mem -x 16
+	# -x has to match MEM_WIDTH in etc/run.sv
+	python etc/scripts/bin_to_sv_mem.py etc/program.bin etc/program.hex etc/program.opcodes -f hex -x 16
 	rm etc/*.o etc/program.bin etc/program.opcodes
 
 	iverilog -g2012 -I src/  $(DEFINES) -o graph/cpu_runner.vvp -s cpu_runner etc/run.sv
@@ -174,6 +342,83 @@ run_soc: bios
 	mv ./soc_runner.vcd ./graph/soc_runner.vcd
 	rm -f graph/soc_runner.vvp
 
+# Verilator build of etc/runsim.sv with the etc/runsim.cpp harness. Runs the same system as
+# run_cpu, loads etc/program.bin directly and only writes graph/sim_runner.fst with TRACE=1.
+VERILATOR ?= verilator
+SIM_CYCLES ?= 10000000
+SIM_DIR ?= graph/sim_runner
+
+sim_runner:
+	mkdir -p ./$(SIM_DIR)
+	$(VERILATOR) --cc --exe --build -j 0 -O3 --trace-fst -Wno-fatal -Wno-lint -Wno-style \
+		-I. -Isrc/ $(DEFINES) --top-module sim_runner -Mdir $(SIM_DIR) -o Vsim_runner \
+		etc/runsim.sv etc/runsim.cpp
+
+# PROFILE=1 writes the graph/sim_runner.trace retire trace and prints the trace_profile.py hotspots
+run_sim: asm sim_runner
+	$(if $(PROFILE),riscv64-unknown-elf-objdump -d -M numeric etc/program.o > graph/program.dis)
+	rm -f etc/*.o etc/program.opcodes
+	./$(SIM_DIR)/Vsim_runner etc/program.bin --cycles $(SIM_CYCLES) $(if $(TRACE),--trace graph/sim_runner.fst) \
+		$(if $(PROFILE),--retire-trace graph/sim_runner.trace)
+	$(if $(PROFILE),python etc/scripts/trace_profile.py graph/sim_runner.trace graph/program.dis)
+
+##
+# Benchmarks
+##
+
+# `make bench` builds etc/bench for every BENCH_CONFIGS entry (make flags separated by commas)
+# with SUPPORT_ZICSR=1, runs it on sim_runner and prints the etc/scripts/bench_report.py table.
+# CoreMark and Dhrystone are not part of the repository, they are built and run when
+# COREMARK_DIR (a github.com/eembc/coremark checkout) and DHRYSTONE_DIR (dhry_1.c, dhry_2.c and
+# dhry.h of Dhrystone 2.1) are set. BENCH_BASELINE=file compares with an earlier results.json.
+BENCH_CONFIGS ?= XLEN=32 XLEN=32,SUPPORT_M=1 XLEN=32,SUPPORT_M=1,SUPPORT_B=1 \
+                 XLEN=64 XLEN=64,SUPPORT_M=1 XLEN=64,SUPPORT_M=1,SUPPORT_B=1
+BENCH_CYCLES ?= 200000000
+COREMARK_ITERATIONS ?= 10
+DHRYSTONE_RUNS ?= 2000
+COREMARK_DIR ?=
+DHRYSTONE_DIR ?=
+
+comma := ,
+
+# ARCH does not carry the Zba/Zbb/Zbs instructions of SUPPORT_B, the benchmarks are built with them
+BENCH_NAME ?= $(RV)
+BENCH_DIR := graph/bench/$(BENCH_NAME)
+BENCH_ARCH := $(ARCH)$(if $(filter 1,$(SUPPORT_B)),_zba_zbb_zbs)
+BENCH_CFLAGS := $(DEFINES) -march=$(BENCH_ARCH) -mabi=$(ABI) -mcmodel=medany -O2 -ffreestanding \
+                -nostartfiles -nostdlib -Ietc/bench
+BENCH_OBJS := $(BENCH_DIR)/start.o $(BENCH_DIR)/bench.o $(BENCH_DIR)/string.o
+BENCH_SIM := ./$(BENCH_DIR)/sim_runner/Vsim_runner --cycles $(BENCH_CYCLES) --console 0xF000
+
+bench:
+	rm -rf graph/bench
+	$(foreach cfg,$(BENCH_CONFIGS),$(MAKE) --no-print-directory bench_run SUPPORT_ZICSR=1 \
+		BENCH_NAME=$(subst =,,$(subst $(comma),_,$(cfg))) BENCH_CONFIG=$(cfg) $(subst $(comma), ,$(cfg)) &&) true
+	python etc/scripts/bench_report.py graph/bench/*/*.log --save graph/bench/results.json \
+		$(if $(BENCH_BASELINE),--baseline $(BENCH_BASELINE))
+
+# One BENCH_CONFIGS entry, the programs are run as linked ELF files
+bench_run: SIM_DIR = $(BENCH_DIR)/sim_runner
+bench_run: sim_runner
+	riscv64-unknown-elf-gcc $(BENCH_CFLAGS) -c -o $(BENCH_DIR)/start.o etc/bench/start.S
+	riscv64-unknown-elf-gcc $(BENCH_CFLAGS) $(LIB_CFLAGS) -DBENCH_DHRY_RUNS=$(DHRYSTONE_RUNS) -c -o $(BENCH_DIR)/bench.o etc/bench/bench.c
+	riscv64-unknown-elf-gcc $(BENCH_CFLAGS) $(LIB_CFLAGS) -c -o $(BENCH_DIR)/string.o etc/lib/string.c
+	riscv64-unknown-elf-gcc $(BENCH_CFLAGS) -T etc/bench/bench.ld -o $(BENCH_DIR)/micro.elf etc/bench/micro.c $(BENCH_OBJS) -lgcc
+	(echo "CONFIG $(BENCH_CONFIG)"; $(BENCH_SIM) $(BENCH_DIR)/micro.elf) > $(BENCH_DIR)/micro.log || true
+ifneq ($(COREMARK_DIR),)
+	riscv64-unknown-elf-gcc $(BENCH_CFLAGS) -DITERATIONS=$(COREMARK_ITERATIONS) -DPERFORMANCE_RUN=1 \
+		-Ietc/bench/coremark -I$(COREMARK_DIR) -T etc/bench/bench.ld -o $(BENCH_DIR)/coremark.elf \
+		$(addprefix $(COREMARK_DIR)/,core_list_join.c core_main.c core_matrix.c core_state.c core_util.c) \
+		etc/bench/coremark/core_portme.c $(BENCH_OBJS) -lgcc
+	(echo "CONFIG $(BENCH_CONFIG)"; $(BENCH_SIM) $(BENCH_DIR)/coremark.elf) > $(BENCH_DIR)/coremark.log || true
+endif
+ifneq ($(DHRYSTONE_DIR),)
+	riscv64-unknown-elf-gcc $(BENCH_CFLAGS) -std=gnu89 -fno-inline -DTIME -Wno-implicit-int \
+		-Wno-implicit-function-declaration -Wno-return-type -I$(DHRYSTONE_DIR) -T etc/bench/bench.ld \
+		-o $(BENCH_DIR)/dhrystone.elf $(DHRYSTONE_DIR)/dhry_1.c $(DHRYSTONE_DIR)/dhry_2.c $(BENCH_OBJS) -lgcc
+	(echo "CONFIG $(BENCH_CONFIG)"; $(BENCH_SIM) $(BENCH_DIR)/dhrystone.elf) > $(BENCH_DIR)/dhrystone.log || true
+endif
+
 ##
 # Tests
 ##
@@ -185,6 +430,6 @@ TESTS := $(shell grep -E '^[[:space:]]*test_[^:]+:$$' MakefileTests.mk | sed -E
 
 test: $(TESTS)
 
-.PHONY: load test $(TESTS)
+.PHONY: load test timing timing_run sim_runner run_sim bench bench_run $(TESTS)
 
 .INTERMEDIATE: synthesis.json bitstream.json
@@ -23,9 +23,59 @@ test_cpu_mdu:
 	vvp -N graph/cpu_mdu.vvp
 	mv ./cpu_mdu_tb.vcd ./graph/cpu_mdu_64.vcd
 
+	iverilog -g2012 -I src/ -DMDU_FAST -o graph/cpu_mdu.vvp -s cpu_mdu_tb test/cpu_mdu_tb.sv
+	vvp -N graph/cpu_mdu.vvp
+	mv ./cpu_mdu_tb.vcd ./graph/cpu_mdu_32_fast.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -DMDU_FAST -o graph/cpu_mdu.vvp -s cpu_mdu_tb test/cpu_mdu_tb.sv
+	vvp -N graph/cpu_mdu.vvp
+	mv ./cpu_mdu_tb.vcd ./graph/cpu_mdu_64_fast.vcd
+
 	# Clean Up: Remove intermediate .vvp files
 	rm -f graph/cpu_mdu.vvp
 
+test_cpu_icache:
+	mkdir -p ./graph
+
+	iverilog -g2012 -I src/ -o graph/cpu_icache.vvp -s cpu_icache_tb test/cpu_icache_tb.sv
+	vvp -N graph/cpu_icache.vvp
+	mv ./cpu_icache_tb.vcd ./graph/cpu_icache_32.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -o graph/cpu_icache.vvp -s cpu_icache_tb test/cpu_icache_tb.sv
+	vvp -N graph/cpu_icache.vvp
+	mv ./cpu_icache_tb.vcd ./graph/cpu_icache_64.vcd
+
+	# Clean Up: Remove intermediate .vvp files
+	rm -f graph/cpu_icache.vvp
+
+test_cpu_dcache:
+	mkdir -p ./graph
+
+	iverilog -g2012 -I src/ -o graph/cpu_dcache.vvp -s cpu_dcache_tb test/cpu_dcache_tb.sv
+	vvp -N graph/cpu_dcache.vvp
+	mv ./cpu_dcache_tb.vcd ./graph/cpu_dcache_32.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -o graph/cpu_dcache.vvp -s cpu_dcache_tb test/cpu_dcache_tb.sv
+	vvp -N graph/cpu_dcache.vvp
+	mv ./cpu_dcache_tb.vcd ./graph/cpu_dcache_64.vcd
+
+	# Clean Up: Remove intermediate .vvp files
+	rm -f graph/cpu_dcache.vvp
+
+test_cpu_tcm:
+	mkdir -p ./graph
+
+	iverilog -g2012 -I src/ -o graph/cpu_tcm.vvp -s cpu_tcm_tb test/cpu_tcm_tb.sv
+	vvp -N graph/cpu_tcm.vvp
+	mv ./cpu_tcm_tb.vcd ./graph/cpu_tcm_32.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -o graph/cpu_tcm.vvp -s cpu_tcm_tb test/cpu_tcm_tb.sv
+	vvp -N graph/cpu_tcm.vvp
+	mv ./cpu_tcm_tb.vcd ./graph/cpu_tcm_64.vcd
+
+	# Clean Up: Remove intermediate .vvp files
+	rm -f graph/cpu_tcm.vvp
+
 test_cpu_bmu:
 	mkdir -p ./graph
 
@@ -40,6 +90,20 @@ test_cpu_bmu:
 	# Clean Up: Remove intermediate .vvp files
 	rm -f graph/cpu_bmu.vvp
 
+test_cpu_exu:
+	mkdir -p ./graph
+
+	iverilog -g2012 -I src/ -o graph/cpu_exu.vvp -s cpu_exu_tb test/cpu_exu_tb.sv
+	vvp -N graph/cpu_exu.vvp
+	mv ./cpu_exu_tb.vcd ./graph/cpu_exu_32.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -o graph/cpu_exu.vvp -s cpu_exu_tb test/cpu_exu_tb.sv
+	vvp -N graph/cpu_exu.vvp
+	mv ./cpu_exu_tb.vcd ./graph/cpu_exu_64.vcd
+
+	# Clean Up: Remove intermediate .vvp files
+	rm -f graph/cpu_exu.vvp
+
 test_cpu_csr:
 	mkdir -p ./graph
 
@@ -68,6 +132,20 @@ test_cpu_regfile:
 	# Clean Up: Remove intermediate .vvp files
 	rm -f graph/cpu_regfile.vvp
 
+test_cpu_rvc:
+	mkdir -p ./graph
+
+	iverilog -g2012 -I src/ -o graph/cpu_rvc.vvp -s cpu_rvc_tb test/cpu_rvc_tb.sv
+	vvp -N graph/cpu_rvc.vvp
+	mv ./cpu_rvc_tb.vcd ./graph/cpu_rvc_32.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -o graph/cpu_rvc.vvp -s cpu_rvc_tb test/cpu_rvc_tb.sv
+	vvp -N graph/cpu_rvc.vvp
+	mv ./cpu_rvc_tb.vcd ./graph/cpu_rvc_64.vcd
+
+	# Clean Up: Remove intermediate .vvp files
+	rm -f graph/cpu_rvc.vvp
+
 test_cpu_insdecode:
 	mkdir -p ./graph
 
@@ -125,13 +203,144 @@ test_tl_cpu:
 	vvp -N graph/tl_cpu.vvp
 	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_64_m.vcd
 
+	iverilog -g2012 -I src/ -DXLEN=64 -DSUPPORT_M -DMDU_FAST -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_64_m_fast.vcd
+
 	iverilog -g2012 -I src/ -DXLEN=64 -DSUPPORT_B -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
 	vvp -N graph/tl_cpu.vvp
 	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_64_b.vcd
 
+	iverilog -g2012 -I src/ -DSUPPORT_ICACHE -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_32_icache.vcd
+
+	iverilog -g2012 -I src/ -DSUPPORT_DCACHE -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_32_dcache.vcd
+
+	iverilog -g2012 -I src/ -DSUPPORT_ICACHE -DSUPPORT_DCACHE -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_32_caches.vcd
+
+	iverilog -g2012 -I src/ -DSUPPORT_C -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_32_c.vcd
+
+	iverilog -g2012 -I src/ -DSUPPORT_C -DSUPPORT_ICACHE -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_32_c_icache.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -DSUPPORT_C -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_64_c.vcd
+
+	iverilog -g2012 -I src/ -DBRANCH_PREDICT -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_32_bp.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -DBRANCH_PREDICT -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_64_bp.vcd
+
+	iverilog -g2012 -I src/ -DBRANCH_PREDICT -DSUPPORT_C -DSUPPORT_ICACHE -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_32_bp_c_icache.vcd
+
+	iverilog -g2012 -I src/ -DFAST_REGFILE -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_32_fast_rf.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -DFAST_REGFILE -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_64_fast_rf.vcd
+
+	iverilog -g2012 -I src/ -DFAST_REGFILE -DBRANCH_PREDICT -DSUPPORT_C -DSUPPORT_ZICSR -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_32_fast_rf_bp_c_zicsr.vcd
+
+	iverilog -g2012 -I src/ -DFUSED_EXU -DSUPPORT_B -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_32_exu.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -DFUSED_EXU -DSUPPORT_B -DFAST_REGFILE -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_64_exu_fast_rf.vcd
+
+	iverilog -g2012 -I src/ -DSUPPORT_ZICSR -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_32_zicsr.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -DSUPPORT_ZICSR -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_64_zicsr.vcd
+
+	iverilog -g2012 -I src/ -DSUPPORT_ZAAMO -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_32_zaamo.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -DSUPPORT_ZAAMO -o graph/tl_cpu.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_64_zaamo.vcd
+
 	# Clean Up: Remove intermediate .vvp files
 	rm -f graph/tl_cpu.vvp
 
+test_tl_cpu_pipe:
+	mkdir -p ./graph
+
+	iverilog -g2012 -I src/ -DPIPELINED -o graph/tl_cpu_pipe.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu_pipe.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_pipe_32.vcd
+
+	iverilog -g2012 -I src/ -DPIPELINED -DSUPPORT_M -o graph/tl_cpu_pipe.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu_pipe.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_pipe_32_m.vcd
+
+	iverilog -g2012 -I src/ -DPIPELINED -DSUPPORT_B -o graph/tl_cpu_pipe.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu_pipe.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_pipe_32_b.vcd
+
+	iverilog -g2012 -I src/ -DPIPELINED -DXLEN=64 -o graph/tl_cpu_pipe.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu_pipe.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_pipe_64.vcd
+
+	iverilog -g2012 -I src/ -DPIPELINED -DXLEN=64 -DSUPPORT_M -o graph/tl_cpu_pipe.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu_pipe.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_pipe_64_m.vcd
+
+	iverilog -g2012 -I src/ -DPIPELINED -DXLEN=64 -DSUPPORT_M -DMDU_FAST -o graph/tl_cpu_pipe.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu_pipe.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_pipe_64_m_fast.vcd
+
+	iverilog -g2012 -I src/ -DPIPELINED -DSUPPORT_ICACHE -o graph/tl_cpu_pipe.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu_pipe.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_pipe_32_icache.vcd
+
+	iverilog -g2012 -I src/ -DPIPELINED -DSUPPORT_DCACHE -o graph/tl_cpu_pipe.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu_pipe.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_pipe_32_dcache.vcd
+
+	iverilog -g2012 -I src/ -DPIPELINED -DSUPPORT_ICACHE -DSUPPORT_DCACHE -o graph/tl_cpu_pipe.vvp -s tl_cpu_tb  test/tl_cpu_tb.sv
+	vvp -N graph/tl_cpu_pipe.vvp
+	mv ./tl_cpu_tb.vcd ./graph/tl_cpu_pipe_32_caches.vcd
+
+	# Clean Up: Remove intermediate .vvp files
+	rm -f graph/tl_cpu_pipe.vvp
+
+test_tl_soc:
+	mkdir -p ./graph
+
+	# Elaborate only, running the SoC needs the bios image
+	iverilog -g2012 -I src/ -o graph/tl_soc.vvp -s top src/tl_soc.sv
+	iverilog -g2012 -I src/ -DSUPPORT_ZICSR -o graph/tl_soc.vvp -s top src/tl_soc.sv
+	iverilog -g2012 -I src/ -DSUPPORT_ZICSR -DPIPELINED -o graph/tl_soc.vvp -s top src/tl_soc.sv
+	iverilog -g2012 -I src/ -DSUPPORT_ZICSR -DSUPPORT_ZAAMO -DNUM_HARTS=2 -o graph/tl_soc.vvp -s top src/tl_soc.sv
+	iverilog -g2012 -I src/ -DSUPPORT_ZICSR -DSUPPORT_ZAAMO -DNUM_HARTS=4 -DBUS_STATS -o graph/tl_soc.vvp -s top src/tl_soc.sv
+
+	# Clean Up: Remove intermediate .vvp files
+	rm -f graph/tl_soc.vvp
+
 test_tl_interface:
 	mkdir -p ./graph
 
@@ -143,8 +352,17 @@ test_tl_interface:
 	vvp -N graph/tl_interface_64.vvp
 	mv ./tl_interface_tb.vcd ./graph/tl_interface_64.vcd
 
+	iverilog -g2012 -I src/ -DTL_OUTSTANDING=4 -o graph/tl_interface_32_outstanding.vvp -s tl_interface_tb test/tl_interface_tb.sv
+	vvp -N graph/tl_interface_32_outstanding.vvp
+	mv ./tl_interface_tb.vcd ./graph/tl_interface_32_outstanding.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -DTL_OUTSTANDING=4 -o graph/tl_interface_64_outstanding.vvp -s tl_interface_tb test/tl_interface_tb.sv
+	vvp -N graph/tl_interface_64_outstanding.vvp
+	mv ./tl_interface_tb.vcd ./graph/tl_interface_64_outstanding.vcd
+
 	# Clean Up: Remove intermediate .vvp files
 	rm -f graph/tl_interface_32.vvp graph/tl_interface_64.vvp
+	rm -f graph/tl_interface_32_outstanding.vvp graph/tl_interface_64_outstanding.vvp
 
 test_tl_memory:
 	mkdir -p ./graph
@@ -157,8 +375,39 @@ test_tl_memory:
 	vvp -N graph/tl_memory_64.vvp
 	mv ./tl_memory_tb.vcd ./graph/tl_memory_64.vcd
 
+	iverilog -g2012 -I src/ -DTL_BURST -o graph/tl_memory_32_burst.vvp -s tl_memory_tb test/tl_memory_tb.sv
+	vvp -N graph/tl_memory_32_burst.vvp
+	mv ./tl_memory_tb.vcd ./graph/tl_memory_32_burst.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -DTL_BURST -o graph/tl_memory_64_burst.vvp -s tl_memory_tb test/tl_memory_tb.sv
+	vvp -N graph/tl_memory_64_burst.vvp
+	mv ./tl_memory_tb.vcd ./graph/tl_memory_64_burst.vcd
+
+	iverilog -g2012 -I src/ -DMEM_WIDE -o graph/tl_memory_32_wide.vvp -s tl_memory_tb test/tl_memory_tb.sv
+	vvp -N graph/tl_memory_32_wide.vvp
+	mv ./tl_memory_tb.vcd ./graph/tl_memory_32_wide.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -DMEM_WIDE -DTL_BURST -o graph/tl_memory_64_wide_burst.vvp -s tl_memory_tb test/tl_memory_tb.sv
+	vvp -N graph/tl_memory_64_wide_burst.vvp
+	mv ./tl_memory_tb.vcd ./graph/tl_memory_64_wide_burst.vcd
+
+	# Clean Up: Remove intermediate .vvp files
+	rm -f graph/tl_memory_32.vvp graph/tl_memory_64.vvp graph/tl_memory_32_burst.vvp graph/tl_memory_64_burst.vvp
+	rm -f graph/tl_memory_32_wide.vvp graph/tl_memory_64_wide_burst.vvp
+
+test_tl_memory_dp:
+	mkdir -p ./graph
+
+	iverilog -g2012 -I src/ -o graph/tl_memory_dp_32.vvp -s tl_memory_dp_tb test/tl_memory_dp_tb.sv
+	vvp -N graph/tl_memory_dp_32.vvp
+	mv ./tl_memory_dp_tb.vcd ./graph/tl_memory_dp_32.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -o graph/tl_memory_dp_64.vvp -s tl_memory_dp_tb test/tl_memory_dp_tb.sv
+	vvp -N graph/tl_memory_dp_64.vvp
+	mv ./tl_memory_dp_tb.vcd ./graph/tl_memory_dp_64.vcd
+
 	# Clean Up: Remove intermediate .vvp files
-	rm -f graph/tl_memory_32.vvp graph/tl_memory_64.vvp
+	rm -f graph/tl_memory_dp_32.vvp graph/tl_memory_dp_64.vvp
 
 test_tl_ul_uart:
 	mkdir -p ./graph
@@ -174,6 +423,48 @@ test_tl_ul_uart:
 	# Clean Up: Remove intermediate .vvp files
 	rm -f graph/tl_ul_uart_32.vvp graph/tl_ul_uart_64.vvp
 
+test_tl_ul_timer:
+	mkdir -p ./graph
+
+	iverilog -g2012 -I src/ -o graph/tl_ul_timer_32.vvp -s tl_ul_timer_tb test/tl_ul_timer_tb.sv
+	vvp -N graph/tl_ul_timer_32.vvp
+	mv ./tl_ul_timer_tb.vcd ./graph/tl_ul_timer_32.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -o graph/tl_ul_timer_64.vvp -s tl_ul_timer_tb test/tl_ul_timer_tb.sv
+	vvp -N graph/tl_ul_timer_64.vvp
+	mv ./tl_ul_timer_tb.vcd ./graph/tl_ul_timer_64.vcd
+
+	# Clean Up: Remove intermediate .vvp files
+	rm -f graph/tl_ul_timer_32.vvp graph/tl_ul_timer_64.vvp
+
+test_tl_ul_perf:
+	mkdir -p ./graph
+
+	iverilog -g2012 -I src/ -o graph/tl_ul_perf_32.vvp -s tl_ul_perf_tb test/tl_ul_perf_tb.sv
+	vvp -N graph/tl_ul_perf_32.vvp
+	mv ./tl_ul_perf_tb.vcd ./graph/tl_ul_perf_32.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -o graph/tl_ul_perf_64.vvp -s tl_ul_perf_tb test/tl_ul_perf_tb.sv
+	vvp -N graph/tl_ul_perf_64.vvp
+	mv ./tl_ul_perf_tb.vcd ./graph/tl_ul_perf_64.vcd
+
+	# Clean Up: Remove intermediate .vvp files
+	rm -f graph/tl_ul_perf_32.vvp graph/tl_ul_perf_64.vvp
+
+test_tl_ul_dma:
+	mkdir -p ./graph
+
+	iverilog -g2012 -I src/ -o graph/tl_ul_dma_32.vvp -s tl_ul_dma_tb test/tl_ul_dma_tb.sv
+	vvp -N graph/tl_ul_dma_32.vvp
+	mv ./tl_ul_dma_tb.vcd ./graph/tl_ul_dma_32.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -o graph/tl_ul_dma_64.vvp -s tl_ul_dma_tb test/tl_ul_dma_tb.sv
+	vvp -N graph/tl_ul_dma_64.vvp
+	mv ./tl_ul_dma_tb.vcd ./graph/tl_ul_dma_64.vcd
+
+	# Clean Up: Remove intermediate .vvp files
+	rm -f graph/tl_ul_dma_32.vvp graph/tl_ul_dma_64.vvp
+
 test_tl_switch:
 	mkdir -p ./graph
 
@@ -185,5 +476,29 @@ test_tl_switch:
 	vvp -N graph/tl_switch.vvp
 	mv ./tl_switch_tb.vcd ./graph/tl_switch_63.vcd
 
+	iverilog -g2012 -I src/ -DSWITCH_CROSSBAR -o graph/tl_switch.vvp -s tl_switch_tb test/tl_switch_tb.sv
+	vvp -N graph/tl_switch.vvp
+	mv ./tl_switch_tb.vcd ./graph/tl_switch_32_crossbar.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -DSWITCH_CROSSBAR -o graph/tl_switch.vvp -s tl_switch_tb test/tl_switch_tb.sv
+	vvp -N graph/tl_switch.vvp
+	mv ./tl_switch_tb.vcd ./graph/tl_switch_64_crossbar.vcd
+
+	iverilog -g2012 -I src/ -DSWITCH_DECODE_MASK -DSWITCH_DECODE_REG -o graph/tl_switch.vvp -s tl_switch_tb test/tl_switch_tb.sv
+	vvp -N graph/tl_switch.vvp
+	mv ./tl_switch_tb.vcd ./graph/tl_switch_32_decode.vcd
+
+	iverilog -g2012 -I src/ -DSWITCH_CROSSBAR -DSWITCH_DECODE_MASK -DSWITCH_DECODE_REG -o graph/tl_switch.vvp -s tl_switch_tb test/tl_switch_tb.sv
+	vvp -N graph/tl_switch.vvp
+	mv ./tl_switch_tb.vcd ./graph/tl_switch_32_crossbar_decode.vcd
+
+	iverilog -g2012 -I src/ -DTL_BURST -o graph/tl_switch.vvp -s tl_switch_tb test/tl_switch_tb.sv
+	vvp -N graph/tl_switch.vvp
+	mv ./tl_switch_tb.vcd ./graph/tl_switch_32_burst.vcd
+
+	iverilog -g2012 -I src/ -DXLEN=64 -DSWITCH_CROSSBAR -DTL_BURST -o graph/tl_switch.vvp -s tl_switch_tb test/tl_switch_tb.sv
+	vvp -N graph/tl_switch.vvp
+	mv ./tl_switch_tb.vcd ./graph/tl_switch_64_crossbar_burst.vcd
+
 	# Clean Up: Remove intermediate .vvp files
 	rm -f graph/tl_switch.vvp
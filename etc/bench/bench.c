@@ -0,0 +1,224 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bench.h"
+
+// Console, measurement and the few C library functions the benchmarks need on top of etc/lib.
+// printf, scanf, malloc, strcpy, strcmp and time are only there for Dhrystone.
+
+#ifndef BENCH_DHRY_RUNS
+#define BENCH_DHRY_RUNS 2000
+#endif
+
+static volatile char *console = (volatile char *)BENCH_CONSOLE;
+
+void bench_putc(char c) {
+    if ((uintptr_t)console < BENCH_CONSOLE_END - 1) {
+        *console++ = c;
+        *console   = 0;
+    }
+}
+
+static void put_string(const char *s, int width, int left) {
+    int len = 0;
+    while (s[len]) {
+        len++;
+    }
+    for (; !left && width > len; width--) {
+        bench_putc(' ');
+    }
+    while (*s) {
+        bench_putc(*s++);
+    }
+    for (; left && width > len; width--) {
+        bench_putc(' ');
+    }
+}
+
+static void put_number(unsigned long long value, unsigned base, int negative, int width, int left,
+                       char pad, int upper) {
+    const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char buffer[24];
+    int  len = 0;
+
+    do {
+        buffer[len++] = digits[value % base];
+        value /= base;
+    } while (value);
+    if (negative) {
+        if (pad == '0') {
+            bench_putc('-');
+            width--;
+        } else {
+            buffer[len++] = '-';
+        }
+    }
+    for (; !left && width > len; width--) {
+        bench_putc(pad);
+    }
+    for (int i = len; i > 0; i--) {
+        bench_putc(buffer[i - 1]);
+    }
+    for (; left && width > len; width--) {
+        bench_putc(' ');
+    }
+}
+
+// %d %i %u %x %X %p %c %s with flags '-' and '0', a width and the l/ll length modifiers. There is
+// no floating point formatting, %f prints '?'.
+int bench_vprintf(const char *fmt, va_list args) {
+    for (; *fmt; fmt++) {
+        if (*fmt != '%') {
+            bench_putc(*fmt);
+            continue;
+        }
+        fmt++;
+
+        int  left = 0;
+        char pad  = ' ';
+        for (; *fmt == '-' || *fmt == '0'; fmt++) {
+            if (*fmt == '-') left = 1;
+            else             pad  = '0';
+        }
+        int width = 0;
+        for (; *fmt >= '0' && *fmt <= '9'; fmt++) {
+            width = 10 * width + (*fmt - '0');
+        }
+        if (*fmt == '.') {
+            for (fmt++; *fmt >= '0' && *fmt <= '9'; fmt++) {
+            }
+        }
+        int longs = 0;
+        for (; *fmt == 'l'; fmt++) {
+            longs++;
+        }
+
+        switch (*fmt) {
+            case 'd':
+            case 'i': {
+                long long value = longs > 1 ? va_arg(args, long long) :
+                                  longs     ? va_arg(args, long) : va_arg(args, int);
+                put_number(value < 0 ? -(unsigned long long)value : (unsigned long long)value, 10,
+                           value < 0, width, left, pad, 0);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X': {
+                unsigned long long value = longs > 1 ? va_arg(args, unsigned long long) :
+                                           longs     ? va_arg(args, unsigned long) :
+                                                       va_arg(args, unsigned int);
+                put_number(value, *fmt == 'u' ? 10 : 16, 0, width, left, pad, *fmt == 'X');
+                break;
+            }
+            case 'p':
+                put_number((uintptr_t)va_arg(args, void *), 16, 0, width, left, pad, 0);
+                break;
+            case 'c':
+                bench_putc((char)va_arg(args, int));
+                break;
+            case 's':
+                put_string(va_arg(args, const char *), width, left);
+                break;
+            case 'f':
+            case 'e':
+            case 'g':
+                (void)va_arg(args, double);
+                bench_putc('?');
+                break;
+            case '%':
+                bench_putc('%');
+                break;
+            default:
+                return -1;
+        }
+    }
+    return 0;
+}
+
+int bench_printf(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int result = bench_vprintf(fmt, args);
+    va_end(args);
+    return result;
+}
+
+static uintptr_t begin_cycles;
+static uintptr_t begin_instret;
+
+void bench_begin(void) {
+    begin_instret = bench_instret();
+    begin_cycles  = bench_cycles();
+}
+
+void bench_end(const char *name, unsigned long ops) {
+    uintptr_t cycles  = bench_cycles() - begin_cycles;
+    uintptr_t instret = bench_instret() - begin_instret;
+    bench_printf("BENCH %s cycles=%lu instret=%lu ops=%lu\n", name, (unsigned long)cycles,
+                 (unsigned long)instret, ops);
+}
+
+// ──────────────────────────
+// Dhrystone support
+// ──────────────────────────
+int printf(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int result = bench_vprintf(fmt, args);
+    va_end(args);
+    return result;
+}
+
+// Dhrystone asks for the number of runs, answer BENCH_DHRY_RUNS
+int scanf(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    *va_arg(args, int *) = BENCH_DHRY_RUNS;
+    va_end(args);
+    (void)fmt;
+    return 1;
+}
+
+// Dhrystone built with -DTIME reads the time right before and right after its main loop
+long time(long *t) {
+    static int calls;
+    if (calls++ == 0) {
+        bench_begin();
+    } else {
+        bench_end("dhrystone", BENCH_DHRY_RUNS);
+    }
+    long now = (long)bench_cycles();
+    if (t) {
+        *t = now;
+    }
+    return now;
+}
+
+extern char __heap_start[];
+extern char __heap_end[];
+
+// Bump allocator, nothing is ever freed
+void *malloc(size_t size) {
+    static char *next = __heap_start;
+    char *block = next;
+    size = (size + 15) & ~(size_t)15;
+    if ((size_t)(__heap_end - next) < size) {
+        return NULL;
+    }
+    next += size;
+    return block;
+}
+
+char *strcpy(char *dst, const char *src) {
+    char *d = dst;
+    while ((*d++ = *src++)) {
+    }
+    return dst;
+}
+
+int strcmp(const char *a, const char *b) {
+    for (; *a && *a == *b; a++, b++) {
+    }
+    return (unsigned char)*a - (unsigned char)*b;
+}
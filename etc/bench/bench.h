@@ -0,0 +1,40 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdarg.h>
+#include <stdint.h>
+
+// Support code for the `make bench` programs, run on etc/runsim.sv with SUPPORT_ZICSR.
+//
+// Output goes to a zero terminated console buffer at BENCH_CONSOLE that etc/runsim.cpp prints
+// after the run (--console). Every measured kernel prints one
+//
+//     BENCH <name> cycles=<mcycle delta> instret=<minstret delta> ops=<operations>
+//
+// line, which etc/scripts/bench_report.py turns into the report table.
+
+#define BENCH_CONSOLE      0xF000u // Console buffer, up to the end of tl_memory
+#define BENCH_CONSOLE_END  0xFFF0u
+#define BENCH_UART         0x10000u // tl_ul_uart in etc/runsim.sv
+
+static inline uintptr_t bench_cycles(void) {
+    uintptr_t value;
+    __asm__ volatile("csrr %0, mcycle" : "=r"(value));
+    return value;
+}
+
+static inline uintptr_t bench_instret(void) {
+    uintptr_t value;
+    __asm__ volatile("csrr %0, minstret" : "=r"(value));
+    return value;
+}
+
+void bench_putc(char c);
+int  bench_vprintf(const char *fmt, va_list args);
+int  bench_printf(const char *fmt, ...);
+
+// Start measuring, bench_end() prints the BENCH line for everything since
+void bench_begin(void);
+void bench_end(const char *name, unsigned long ops);
+
+#endif // BENCH_H
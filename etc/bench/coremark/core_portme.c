@@ -0,0 +1,61 @@
+#include "coremark.h"
+#include "bench.h"
+
+#ifndef ITERATIONS
+#define ITERATIONS 10
+#endif
+
+// The seeds are volatile so the compiler can not fold the workload at build time
+volatile ee_s32 seed1_volatile = 0x0;
+volatile ee_s32 seed2_volatile = 0x0;
+volatile ee_s32 seed3_volatile = 0x66;
+volatile ee_s32 seed4_volatile = ITERATIONS;
+volatile ee_s32 seed5_volatile = 0;
+
+ee_u32 default_num_contexts = 1;
+
+static CORE_TICKS start_time_val;
+static CORE_TICKS stop_time_val;
+
+int ee_printf(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int result = bench_vprintf(fmt, args);
+    va_end(args);
+    return result;
+}
+
+void start_time(void) {
+    bench_begin();
+    start_time_val = (CORE_TICKS)bench_cycles();
+}
+
+void stop_time(void) {
+    stop_time_val = (CORE_TICKS)bench_cycles();
+    bench_end("coremark", ITERATIONS);
+}
+
+CORE_TICKS get_time(void) {
+    return stop_time_val - start_time_val;
+}
+
+// Ticks are cycles at a nominal 1 MHz
+secs_ret time_in_secs(CORE_TICKS ticks) {
+    return ticks / 1000000u;
+}
+
+void portable_init(core_portable *p, int *argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    if (sizeof(ee_ptr_int) != sizeof(ee_u8 *)) {
+        ee_printf("ERROR! Please define ee_ptr_int to a type that holds a pointer!\n");
+    }
+    if (sizeof(ee_u32) != 4) {
+        ee_printf("ERROR! Please define ee_u32 to a 32b unsigned type!\n");
+    }
+    p->portable_id = 1;
+}
+
+void portable_fini(core_portable *p) {
+    p->portable_id = 0;
+}
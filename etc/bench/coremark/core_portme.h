@@ -0,0 +1,56 @@
+#ifndef CORE_PORTME_H
+#define CORE_PORTME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CoreMark port for `make bench` on etc/runsim.sv. COREMARK_DIR points at a checkout of
+// https://github.com/eembc/coremark, only its core_*.c files and coremark.h are used.
+//
+// Time is mcycle at a nominal 1 MHz, so CoreMark's Iterations/Sec reads as CoreMark/MHz. Runs
+// shorter than 10 million cycles make CoreMark complain about the 10 second minimum, the
+// report only counts the CRC checks.
+
+#define HAS_FLOAT        0
+#define HAS_TIME_H       0
+#define USE_CLOCK        0
+#define HAS_STDIO        0
+#define HAS_PRINTF       0
+
+#define MEM_METHOD       MEM_STATIC
+#define SEED_METHOD      SEED_VOLATILE
+#define MULTITHREAD      1
+#define MAIN_HAS_NOARGC  1
+#define MAIN_HAS_NORETURN 0
+
+#ifndef COMPILER_VERSION
+#define COMPILER_VERSION "GCC " __VERSION__
+#endif
+#ifndef COMPILER_FLAGS
+#define COMPILER_FLAGS   "see Makefile.mk BENCH_CFLAGS"
+#endif
+#define MEM_LOCATION     "STATIC"
+
+typedef int16_t   ee_s16;
+typedef uint16_t  ee_u16;
+typedef int32_t   ee_s32;
+typedef uint8_t   ee_u8;
+typedef uint32_t  ee_u32;
+typedef uintptr_t ee_ptr_int;
+typedef size_t    ee_size_t;
+typedef ee_u32    CORE_TICKS;
+
+#define NULL_PTR  ((void *)0)
+#define align_mem(x) (void *)(4 + (((ee_ptr_int)(x) - 1) & ~3))
+
+typedef struct CORE_PORTABLE_S {
+    ee_u8 portable_id;
+} core_portable;
+
+extern ee_u32 default_num_contexts;
+
+void portable_init(core_portable *p, int *argc, char *argv[]);
+void portable_fini(core_portable *p);
+int  ee_printf(const char *fmt, ...);
+
+#endif // CORE_PORTME_H
@@ -0,0 +1,147 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "bench.h"
+
+// Microbenchmarks for `make bench`. Each kernel is timed with mcycle/minstret on its own, so the
+// report shows the cost of one operation without the startup code:
+//
+// - load_latency: chased pointers, every load needs the result of the one before
+// - store_load:   a store stream followed by a load stream over the same buffer
+// - branch:       a loop with a data dependent branch, taken in a pseudo random pattern
+// - mul / div:    dependent chains, calls into libgcc without SUPPORT_M
+// - memcpy:       the etc/lib copy, aligned buffers
+// - uart:         bytes written to tl_ul_uart at 16 clock cycles per bit (160 per byte), polling
+//                 the TX full flag, until the TX FIFO is empty again
+
+#define CHAIN_LENGTH  256
+#define CHAIN_LOADS   4096
+#define BUFFER_WORDS  512
+#define BRANCH_LOOPS  4096
+#define MUL_CHAIN     1024
+#define DIV_CHAIN     256
+#define COPY_BYTES    2048
+#define UART_BYTES    128
+
+#define UART_STATUS   (*(volatile uint8_t *)(BENCH_UART + 0x00))
+#define UART_DATA     (*(volatile uint8_t *)(BENCH_UART + 0x08))
+#define UART_DIVISOR  (*(volatile uint32_t *)(BENCH_UART + 0x14))
+
+#define UART_TX_EMPTY 0x01
+#define UART_TX_FULL  0x02
+
+// Results go here so the kernels are not optimized away
+volatile uintptr_t sink;
+
+static uintptr_t chain[CHAIN_LENGTH];
+static uint32_t  buffer[BUFFER_WORDS];
+static uint8_t   copy_src[COPY_BYTES] __attribute__((aligned(8)));
+static uint8_t   copy_dst[COPY_BYTES] __attribute__((aligned(8)));
+
+static void load_latency(void) {
+    // 97 is odd, so the chain visits every entry
+    for (unsigned i = 0; i < CHAIN_LENGTH; i++) {
+        chain[i] = (uintptr_t)&chain[(i + 97) % CHAIN_LENGTH];
+    }
+
+    uintptr_t *p = &chain[0];
+    bench_begin();
+    for (unsigned i = 0; i < CHAIN_LOADS; i++) {
+        p = (uintptr_t *)*p;
+    }
+    bench_end("load_latency", CHAIN_LOADS);
+    sink = (uintptr_t)p;
+}
+
+static void store_load(void) {
+    volatile uint32_t *b = buffer;
+    uint32_t sum = 0;
+
+    bench_begin();
+    for (unsigned i = 0; i < BUFFER_WORDS; i++) {
+        b[i] = i;
+    }
+    for (unsigned i = 0; i < BUFFER_WORDS; i++) {
+        sum += b[i];
+    }
+    bench_end("store_load", 2 * BUFFER_WORDS);
+    sink = sum;
+}
+
+static void branch(void) {
+    uint32_t lfsr  = 0xACE1u;
+    uint32_t taken = 0;
+
+    bench_begin();
+    for (unsigned i = 0; i < BRANCH_LOOPS; i++) {
+        lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+        if (lfsr & 1u) {
+            // Keeps GCC from turning the branch into arithmetic
+            __asm__ volatile("");
+            taken++;
+        }
+    }
+    bench_end("branch", BRANCH_LOOPS);
+    sink = taken;
+}
+
+static void multiply(void) {
+    uintptr_t x = sink | 1;
+
+    bench_begin();
+    for (unsigned i = 0; i < MUL_CHAIN; i++) {
+        x = x * (uintptr_t)0x9E3779B1u + 1;
+    }
+    bench_end("mul", MUL_CHAIN);
+    sink = x;
+}
+
+static void divide(void) {
+    uintptr_t x = ~(uintptr_t)0;
+    uintptr_t d = 3;
+
+    bench_begin();
+    for (unsigned i = 0; i < DIV_CHAIN; i++) {
+        uintptr_t q = x / d;
+        d = (q & 0xFF) + 3;
+        x = (q | 1) << 12 | x;
+    }
+    bench_end("div", DIV_CHAIN);
+    sink = x ^ d;
+}
+
+static void copy(void) {
+    for (unsigned i = 0; i < COPY_BYTES; i++) {
+        copy_src[i] = (uint8_t)i;
+    }
+
+    bench_begin();
+    memcpy(copy_dst, copy_src, COPY_BYTES);
+    bench_end("memcpy", COPY_BYTES);
+    sink = copy_dst[COPY_BYTES - 1];
+}
+
+static void uart(void) {
+    UART_DIVISOR = 16 << 8;
+
+    bench_begin();
+    for (unsigned i = 0; i < UART_BYTES; i++) {
+        while (UART_STATUS & UART_TX_FULL) {
+        }
+        UART_DATA = (uint8_t)('A' + i % 26);
+    }
+    while (!(UART_STATUS & UART_TX_EMPTY)) {
+    }
+    bench_end("uart", UART_BYTES);
+}
+
+int main(void) {
+    load_latency();
+    store_load();
+    branch();
+    multiply();
+    divide();
+    copy();
+    uart();
+    return 0;
+}
@@ -6,21 +6,54 @@
 // Bios memory is 0x8000_0000 to 0x0000_00FF
 // Output memory is 0x0002_0000 to 0x0000_0010
 // UART memory is 0x0001_0000 to 0x0000_0010
+// Timer memory is 0x0003_0000 to 0x0003_000F
 // CPU boots to 0x8000_0000
 
 #define CLOCK_MHZ      27
 #define MEMORY_ADDRESS 0x00000F00
 #define OUTPUT_ADDRESS 0x80000000
 #define UART_ADDRESS   0xC0000000
+#define TIMER_ADDRESS  0x00030000 // mtime counts milliseconds, see tl_soc.sv
 
-void delay(uint32_t ms) {
-    volatile uint32_t count;
-    while(ms > 0) {
-        for(count = 0; count < 2; count++) {
-            __asm__("nop");
-        }
-        ms--;
+#define TIMER_MTIME_LO    0
+#define TIMER_MTIME_HI    1
+#define TIMER_MTIMECMP_LO 2
+#define TIMER_MTIMECMP_HI 3
+#define MIE_MTIE          (1 << 7)
+
+static volatile uint32_t *const timer = (volatile uint32_t *)(TIMER_ADDRESS);
+
+// Read the 64 bit mtime with 32 bit loads, retry if the high half changed in between
+static uint64_t timer_now(void) {
+    uint32_t hi, lo;
+    do {
+        hi = timer[TIMER_MTIME_HI];
+        lo = timer[TIMER_MTIME_LO];
+    } while (hi != timer[TIMER_MTIME_HI]);
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// Sleep in wfi until mtime reaches deadline. Without Zicsr the timer interrupt can not be
+// enabled, so mtime is polled instead.
+void timer_sleep_until(uint64_t deadline) {
+#ifdef SUPPORT_ZICSR
+    timer[TIMER_MTIMECMP_HI] = 0xFFFFFFFF; // No false interrupt while the low half changes
+    timer[TIMER_MTIMECMP_LO] = (uint32_t)deadline;
+    timer[TIMER_MTIMECMP_HI] = (uint32_t)(deadline >> 32);
+    __asm__ volatile ("csrs mie, %0" :: "r"(MIE_MTIE));
+#endif
+    while (timer_now() < deadline) {
+#ifdef SUPPORT_ZICSR
+        __asm__ volatile ("wfi");
+#endif
     }
+#ifdef SUPPORT_ZICSR
+    __asm__ volatile ("csrc mie, %0" :: "r"(MIE_MTIE));
+#endif
+}
+
+void delay(uint32_t ms) {
+    timer_sleep_until(timer_now() + ms);
 }
 
 int main() {
@@ -12,7 +12,11 @@
 // `define LOG_CSR
 
 // Include necessary modules
+`ifdef PIPELINED
+`include "tl_cpu_pipe.sv"
+`else
 `include "tl_cpu.sv"
+`endif
 `include "tl_switch.sv"
 `include "tl_memory.sv"
 
@@ -101,7 +105,11 @@ logic [0:0]             external_nmi;
 // ====================================
 // Instantiate the CPU (TileLink Master)
 // ====================================
+`ifdef PIPELINED
+tl_cpu_pipe #(
+`else
 tl_cpu #(
+`endif
     .XLEN(XLEN),
     .SID_WIDTH(SID_WIDTH),
     .START_ADDRESS(32'h0000_0000) // force start address to 0
@@ -113,6 +121,7 @@ tl_cpu #(
     // No interrupts in this test
     .external_irq(external_irq),
     .external_nmi(external_nmi),
+    .external_timer(1'b0),
     `endif
 
     // TileLink A Channel
@@ -275,7 +284,8 @@ initial begin
     #10; // Hold reset for 10ns
     @(posedge clk);
 
-    `include "etc/program.sv"
+    // Written by bin_to_sv_mem.py -f hex, one MEM_WIDTH word per line
+    $readmemh("etc/program.hex", mock_mem.block_ram_inst.memory);
 
     @(posedge clk);
     $display("Program loaded...");
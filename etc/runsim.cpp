@@ -0,0 +1,325 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Verilator harness for etc/runsim.sv
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Loads a flat binary into tl_memory at address 0, runs the CPU until it halts (self jump),
+// traps or runs out of cycles, then prints the stop reason, the cycle and retired instruction
+// counts and a memory dump like etc/run.sv. A RISC-V ELF file (e.g. the linked etc/program.o) is
+// loaded the way objcopy -O binary would lay it out, its lowest load address at address 0.
+//
+// With --console ADDR the zero terminated string the program left at ADDR is printed as well,
+// the etc/bench programs write their results there.
+//
+// With --retire-trace FILE every retired instruction is written to FILE as one 40 byte record,
+// after a 16 byte header "RVTRACE\0", version (u32) and record size (u32). All little-endian:
+//
+//     u64 pc, u32 instruction, u32 cycles since the previous retirement,
+//     u16 cycles[12] of those spent in each tl_cpu.sv state (saturating, 11 and up in [11])
+//
+// etc/scripts/trace_profile.py turns it into a hotspot profile.
+//
+// Usage: Vsim_runner <program.bin|program.elf> [--cycles N] [--trace file.fst] [--dump START:END]
+//                    [--console ADDR] [--retire-trace FILE]
+//
+// Exit status: 0 on halt, 1 on trap, 2 when the cycle budget ran out, 3 on usage errors.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Vsim_runner.h"
+#include "Vsim_runner__Dpi.h"
+#include "svdpi.h"
+#include "verilated.h"
+#include "verilated_fst_c.h"
+
+static void usage(const char *name) {
+    std::fprintf(stderr, "Usage: %s <program.bin|program.elf> [--cycles N] [--trace file.fst] [--dump START:END] [--console ADDR] [--retire-trace FILE]\n", name);
+}
+
+// Retire trace, see the file header for the layout
+static constexpr unsigned TRACE_STATES = 12;
+static constexpr unsigned TRACE_RECORD = 8 + 4 + 4 + 2 * TRACE_STATES;
+
+static void put_le(uint8_t *out, uint64_t value, unsigned bytes) {
+    for (unsigned i = 0; i < bytes; i++) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+static constexpr uint16_t EM_RISCV = 243;
+
+// Flatten the PT_LOAD segments of a little-endian RISC-V ELF32/ELF64 file into image, at most
+// limit bytes. Returns false with the reason in error when the file is not such an ELF file, a
+// segment lies outside of it or the image would be larger than limit. Bytes past a segment's
+// file size, its .bss, stay zero.
+static bool load_elf(const std::vector<uint8_t> &file, std::vector<uint8_t> &image, uint64_t limit,
+                     std::string &error) {
+    auto field = [&](uint64_t offset, unsigned bytes) -> uint64_t {
+        uint64_t value = 0;
+        for (unsigned i = 0; i < bytes && offset + i < file.size(); i++) {
+            value |= static_cast<uint64_t>(file[offset + i]) << (8 * i);
+        }
+        return value;
+    };
+
+    if (file.size() < 52 || std::memcmp(file.data(), "\x7f" "ELF", 4) != 0 || file[5] != 1) {
+        error = "is not a little-endian ELF file";
+        return false;
+    }
+    if (field(18, 2) != EM_RISCV) {
+        error = "is an ELF file for machine " + std::to_string(field(18, 2)) + ", not RISC-V";
+        return false;
+    }
+    const bool     is64      = (file[4] == 2);
+    const uint64_t phoff     = is64 ? field(32, 8) : field(28, 4);
+    const uint64_t phentsize = is64 ? field(54, 2) : field(42, 2);
+    const uint64_t phnum     = is64 ? field(56, 2) : field(44, 2);
+
+    struct Segment { uint64_t offset, paddr, filesz, memsz; };
+    std::vector<Segment> segments;
+    uint64_t base = UINT64_MAX;
+    for (uint64_t i = 0; i < phnum; i++) {
+        const uint64_t ph = phoff + i * phentsize;
+        if (field(ph, 4) != 1) {
+            continue; // Not PT_LOAD
+        }
+        Segment seg;
+        seg.offset = is64 ? field(ph + 8, 8)  : field(ph + 4, 4);
+        seg.paddr  = is64 ? field(ph + 24, 8) : field(ph + 12, 4);
+        seg.filesz = is64 ? field(ph + 32, 8) : field(ph + 16, 4);
+        seg.memsz  = is64 ? field(ph + 40, 8) : field(ph + 20, 4);
+        if (seg.filesz == 0) {
+            continue;
+        }
+        if (seg.offset + seg.filesz > file.size()) {
+            error = "has a segment outside of the file";
+            return false;
+        }
+        segments.push_back(seg);
+        if (seg.paddr < base) base = seg.paddr;
+    }
+
+    if (segments.empty()) {
+        error = "has no loadable segments";
+        return false;
+    }
+
+    image.clear();
+    for (const Segment &seg : segments) {
+        // Checked before resizing, sparse load addresses would otherwise allocate gigabytes
+        const uint64_t start = seg.paddr - base;
+        if (start > limit || seg.filesz > limit - start) {
+            error = "spans more than the " + std::to_string(limit) + " bytes of memory";
+            return false;
+        }
+        if (image.size() < start + seg.filesz) {
+            image.resize(start + seg.filesz, 0);
+        }
+        std::memcpy(image.data() + start, file.data() + seg.offset, seg.filesz);
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    const char *bin_path   = nullptr;
+    const char *trace_path = nullptr;
+    const char *retire_path = nullptr;
+    uint64_t    max_cycles = 10000000;
+    uint32_t    dump_start = 0xFF00;
+    uint32_t    dump_end   = 0xFFFF;
+    bool        console    = false;
+    uint32_t    console_at = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--cycles") && i + 1 < argc) {
+            max_cycles = std::strtoull(argv[++i], nullptr, 0);
+        } else if (!std::strcmp(argv[i], "--trace") && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (!std::strcmp(argv[i], "--dump") && i + 1 < argc) {
+            char *end = nullptr;
+            dump_start = std::strtoul(argv[++i], &end, 0);
+            dump_end   = (end && *end == ':') ? std::strtoul(end + 1, nullptr, 0) : dump_start + 0xFF;
+        } else if (!std::strcmp(argv[i], "--retire-trace") && i + 1 < argc) {
+            retire_path = argv[++i];
+        } else if (!std::strcmp(argv[i], "--console") && i + 1 < argc) {
+            console    = true;
+            console_at = std::strtoul(argv[++i], nullptr, 0);
+        } else if (argv[i][0] == '+') {
+            // Plusargs are left for Verilator
+        } else if (!bin_path) {
+            bin_path = argv[i];
+        } else {
+            usage(argv[0]);
+            return 3;
+        }
+    }
+    if (!bin_path) {
+        usage(argv[0]);
+        return 3;
+    }
+
+    // Read the program
+    std::FILE *bin = std::fopen(bin_path, "rb");
+    if (!bin) {
+        std::fprintf(stderr, "Can not open %s\n", bin_path);
+        return 3;
+    }
+    std::vector<uint8_t> program;
+    for (int c; (c = std::fgetc(bin)) != EOF;) {
+        program.push_back(static_cast<uint8_t>(c));
+    }
+    std::fclose(bin);
+
+    auto context = std::make_unique<VerilatedContext>();
+    context->commandArgs(argc, argv);
+    if (trace_path) {
+        context->traceEverOn(true);
+    }
+    auto top = std::make_unique<Vsim_runner>(context.get());
+
+    std::unique_ptr<VerilatedFstC> trace;
+    if (trace_path) {
+        trace = std::make_unique<VerilatedFstC>();
+        top->trace(trace.get(), 99);
+        trace->open(trace_path);
+    }
+
+    uint64_t time = 0;
+    auto tick = [&]() {
+        top->clk = 1;
+        top->eval();
+        if (trace) trace->dump(time);
+        time += 5;
+        top->clk = 0;
+        top->eval();
+        if (trace) trace->dump(time);
+        time += 5;
+    };
+
+    // Hold reset while the program is loaded
+    top->clk   = 0;
+    top->reset = 1;
+    top->eval();
+    tick();
+
+    svSetScope(svGetScopeFromName("TOP.sim_runner"));
+    const uint32_t mem_size = static_cast<uint32_t>(sim_mem_size());
+    if (program.size() >= 4 && std::memcmp(program.data(), "\x7f" "ELF", 4) == 0) {
+        std::vector<uint8_t> image;
+        std::string error;
+        if (!load_elf(program, image, mem_size, error)) {
+            std::fprintf(stderr, "%s %s\n", bin_path, error.c_str());
+            return 3;
+        }
+        program.swap(image);
+    }
+    if (program.size() > mem_size) {
+        std::fprintf(stderr, "%s is %zu bytes, memory is %u bytes\n", bin_path, program.size(), mem_size);
+        return 3;
+    }
+    std::printf("Loading program...\n");
+    for (uint32_t address = 0; address < program.size(); address++) {
+        sim_write_byte(address, program[address]);
+    }
+    tick();
+    std::printf("Program loaded...\n");
+
+    std::FILE *retire_trace = nullptr;
+    if (retire_path) {
+        retire_trace = std::fopen(retire_path, "wb");
+        if (!retire_trace) {
+            std::fprintf(stderr, "Can not create %s\n", retire_path);
+            return 3;
+        }
+        uint8_t header[16] = {'R', 'V', 'T', 'R', 'A', 'C', 'E', 0};
+        put_le(header + 8, 1, 4);
+        put_le(header + 12, TRACE_RECORD, 4);
+        std::fwrite(header, 1, sizeof(header), retire_trace);
+    }
+    uint32_t state_cycles[TRACE_STATES] = {};
+    uint32_t retire_cycles = 0;
+
+    top->reset = 0;
+    std::printf("Running %s...\n", bin_path);
+
+    const auto started = std::chrono::steady_clock::now();
+    uint64_t cycles  = 0;
+    uint64_t instret = 0;
+    while (!context->gotFinish() && cycles < max_cycles && !top->halt && !top->trap) {
+        instret += top->retire;
+        if (retire_trace) {
+            // The retirement cycle is the first one of the next instruction
+            if (top->retire) {
+                uint8_t record[TRACE_RECORD];
+                put_le(record, top->retire_pc, 8);
+                put_le(record + 8, top->retire_instr, 4);
+                put_le(record + 12, retire_cycles, 4);
+                for (unsigned s = 0; s < TRACE_STATES; s++) {
+                    put_le(record + 16 + 2 * s, state_cycles[s] > 0xFFFF ? 0xFFFF : state_cycles[s], 2);
+                    state_cycles[s] = 0;
+                }
+                std::fwrite(record, 1, sizeof(record), retire_trace);
+                retire_cycles = 0;
+            }
+            state_cycles[top->cpu_state < TRACE_STATES ? top->cpu_state : TRACE_STATES - 1]++;
+            retire_cycles++;
+        }
+        tick();
+        cycles++;
+    }
+    if (retire_trace) {
+        std::fclose(retire_trace);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    int status = 2;
+    if (top->halt) {
+        std::printf("Stop reason: HALT\n");
+        status = 0;
+    } else if (top->trap) {
+        std::printf("Stop reason: TRAP\n");
+        status = 1;
+    } else {
+        std::printf("Stop reason: CYCLE LIMIT\n");
+    }
+    std::printf("Number of clock cycles: %llu pc=0x%llx\n",
+                static_cast<unsigned long long>(cycles), static_cast<unsigned long long>(top->pc));
+    std::printf("Number of instructions retired: %llu\n", static_cast<unsigned long long>(instret));
+    std::printf("IPC: %.3f\n", cycles ? static_cast<double>(instret) / cycles : 0.0);
+    std::printf("Simulation speed: %.0f cycles/s\n", seconds > 0 ? cycles / seconds : 0.0);
+
+    if (console) {
+        std::printf("\n\nConsole\n");
+        std::printf("----------------------------------------------------------------\n");
+        for (uint32_t address = console_at; address < mem_size; address++) {
+            const int c = sim_read_byte(address);
+            if (c == 0) break;
+            std::putchar(c);
+        }
+        std::printf("\n");
+    }
+
+    // Memory dump in the DISPLAY_MEM_RANGE_ARRAY layout
+    if (dump_end >= mem_size) dump_end = mem_size - 1;
+    std::printf("\n\nMemory dump\n");
+    std::printf("----------------------------------------------------------------\n");
+    std::printf("            0  1  2  3 |  4  5  6  7 |  8  9  A  B |  C  D  E  F\n");
+    std::printf("----------------------------------------------------------------\n");
+    for (uint32_t row = dump_start & ~0xFu; row <= dump_end; row += 16) {
+        std::printf("0x%08x:", row);
+        for (uint32_t b = 0; b < 16 && row + b < mem_size; b++) {
+            std::printf("%s%02x", (b && (b % 4) == 0) ? " | " : " ", sim_read_byte(row + b));
+        }
+        std::printf("\n");
+    }
+
+    top->final();
+    if (trace) trace->close();
+    return status;
+}
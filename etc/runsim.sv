@@ -0,0 +1,375 @@
+`timescale 1ns / 1ps
+`default_nettype none
+
+// Verilator top for `make run_sim` and `make bench`, driven by etc/runsim.cpp. Same system as
+// etc/run.sv: the CPU on a tl_switch with a tl_memory, starting at address 0, plus a tl_ul_uart at
+// 0x0001_0000 for the UART throughput benchmark. The clock, reset, program loading and the stop
+// condition are all left to the C++ harness, so there are no delays and no $dumpvars here.
+
+`define DEBUG       // Needed for debug signals
+// `define LOG_CPU
+// `define LOG_MEMORY
+// `define LOG_SWITCH
+
+// Include necessary modules
+`ifdef PIPELINED
+`include "tl_cpu_pipe.sv"
+`else
+`include "tl_cpu.sv"
+`endif
+`include "tl_switch.sv"
+`include "tl_memory.sv"
+`include "tl_ul_uart.sv"
+
+`ifndef XLEN
+`define XLEN 32
+`endif
+
+module sim_runner (
+    input  wire             clk,
+    input  wire             reset,
+    output wire             halt,
+    output wire             trap,
+    output wire             retire,     // An instruction retired this cycle
+    output wire [63:0]      retire_pc,  // its address
+    output wire [31:0]      retire_instr,
+    output wire [3:0]       cpu_state,  // tl_cpu.sv cpu_state_t
+    output wire             uart_tx,
+    output wire [63:0]      pc
+);
+
+// ====================================
+// Parameters
+// ====================================
+parameter XLEN = `XLEN;
+`ifdef MEM_WIDE
+parameter MEM_WIDTH   = XLEN;
+parameter MEM_BYTE_EN = 1;
+`else
+parameter MEM_WIDTH   = 16;
+parameter MEM_BYTE_EN = 0;
+`endif
+parameter MEM_SIZE  = 65520;
+parameter SID_WIDTH = 2;           // Source ID length for TileLink
+
+// CPU TileLink Signals
+logic                   cpu_tl_a_valid;
+logic                   cpu_tl_a_ready;
+logic [2:0]             cpu_tl_a_opcode;
+logic [2:0]             cpu_tl_a_param;
+logic [2:0]             cpu_tl_a_size;
+logic [SID_WIDTH-1:0]   cpu_tl_a_source;
+logic [XLEN-1:0]        cpu_tl_a_address;
+logic [XLEN/8-1:0]      cpu_tl_a_mask;
+logic [XLEN-1:0]        cpu_tl_a_data;
+
+logic                   cpu_tl_d_valid;
+logic                   cpu_tl_d_ready;
+logic [2:0]             cpu_tl_d_opcode;
+logic [1:0]             cpu_tl_d_param;
+logic [2:0]             cpu_tl_d_size;
+logic [SID_WIDTH-1:0]   cpu_tl_d_source;
+logic [XLEN-1:0]        cpu_tl_d_data;
+logic                   cpu_tl_d_corrupt;
+logic                   cpu_tl_d_denied;
+
+logic [XLEN-1:0]        dbg_pc;
+logic [XLEN-1:0]        dbg_retire_pc;
+
+assign pc        = {{(64-XLEN){1'b0}}, dbg_pc};
+assign retire_pc = {{(64-XLEN){1'b0}}, dbg_retire_pc};
+
+// Memory TileLink Signals
+logic                   memory_s_a_valid;
+logic                   memory_s_a_ready;
+logic [2:0]             memory_s_a_opcode;
+logic [2:0]             memory_s_a_param;
+logic [2:0]             memory_s_a_size;
+logic [SID_WIDTH-1:0]   memory_s_a_source;
+logic [XLEN-1:0]        memory_s_a_address;
+logic [XLEN/8-1:0]      memory_s_a_mask;
+logic [XLEN-1:0]        memory_s_a_data;
+
+logic                   memory_s_d_valid;
+logic                   memory_s_d_ready;
+logic [2:0]             memory_s_d_opcode;
+logic [1:0]             memory_s_d_param;
+logic [2:0]             memory_s_d_size;
+logic [SID_WIDTH-1:0]   memory_s_d_source;
+logic [XLEN-1:0]        memory_s_d_data;
+logic                   memory_s_d_corrupt;
+logic                   memory_s_d_denied;
+
+logic [XLEN-1:0]        memory_base_address;
+logic [XLEN-1:0]        memory_size;
+
+assign memory_base_address = 'h0000_0000;
+assign memory_size         = 65535;
+
+// UART TileLink Signals
+logic                   uart_s_a_valid;
+logic                   uart_s_a_ready;
+logic [2:0]             uart_s_a_opcode;
+logic [2:0]             uart_s_a_param;
+logic [2:0]             uart_s_a_size;
+logic [SID_WIDTH-1:0]   uart_s_a_source;
+logic [XLEN-1:0]        uart_s_a_address;
+logic [XLEN/8-1:0]      uart_s_a_mask;
+logic [XLEN-1:0]        uart_s_a_data;
+
+logic                   uart_s_d_valid;
+logic                   uart_s_d_ready;
+logic [2:0]             uart_s_d_opcode;
+logic [1:0]             uart_s_d_param;
+logic [2:0]             uart_s_d_size;
+logic [SID_WIDTH-1:0]   uart_s_d_source;
+logic [XLEN-1:0]        uart_s_d_data;
+logic                   uart_s_d_corrupt;
+logic                   uart_s_d_denied;
+
+logic [XLEN-1:0]        uart_base_address;
+logic [XLEN-1:0]        uart_size;
+
+assign uart_base_address = 'h0001_0000;
+assign uart_size         = 'h1F;
+
+// External signals
+logic [0:0]             external_irq;
+logic [0:0]             external_nmi;
+
+assign external_irq = 1'b0;
+assign external_nmi = 1'b0;
+
+// ====================================
+// Instantiate the CPU (TileLink Master)
+// ====================================
+`ifdef PIPELINED
+tl_cpu_pipe #(
+`else
+tl_cpu #(
+`endif
+    .XLEN(XLEN),
+    .SID_WIDTH(SID_WIDTH),
+    .START_ADDRESS(32'h0000_0000) // force start address to 0
+) uut (
+    .clk(clk),
+    .reset(reset),
+
+    `ifdef SUPPORT_ZICSR
+    // No interrupts in this test
+    .external_irq(external_irq),
+    .external_nmi(external_nmi),
+    .external_timer(1'b0),
+    `endif
+
+    // TileLink A Channel
+    .tl_a_valid   (cpu_tl_a_valid),
+    .tl_a_ready   (cpu_tl_a_ready),
+    .tl_a_opcode  (cpu_tl_a_opcode),
+    .tl_a_param   (cpu_tl_a_param),
+    .tl_a_size    (cpu_tl_a_size),
+    .tl_a_source  (cpu_tl_a_source),
+    .tl_a_address (cpu_tl_a_address),
+    .tl_a_mask    (cpu_tl_a_mask),
+    .tl_a_data    (cpu_tl_a_data),
+
+    // TileLink D Channel
+    .tl_d_valid   (cpu_tl_d_valid),
+    .tl_d_ready   (cpu_tl_d_ready),
+    .tl_d_opcode  (cpu_tl_d_opcode),
+    .tl_d_param   (cpu_tl_d_param),
+    .tl_d_size    (cpu_tl_d_size),
+    .tl_d_source  (cpu_tl_d_source),
+    .tl_d_data    (cpu_tl_d_data),
+    .tl_d_corrupt (cpu_tl_d_corrupt),
+    .tl_d_denied  (cpu_tl_d_denied),
+    .trap         (trap),
+    .test         (),
+
+    // Debug Signals
+    .dbg_pc       (dbg_pc),
+    .dbg_halt     (halt),
+    .dbg_x1       (),
+    .dbg_x2       (),
+    .dbg_x3       (),
+    .dbg_retire   (retire),
+    .dbg_retire_pc(dbg_retire_pc),
+    .dbg_retire_instr(retire_instr),
+    .dbg_state    (cpu_state)
+);
+
+// ====================================
+// Instantiate the TileLink Switch
+// ====================================
+tl_switch #(
+    .NUM_INPUTS    (1),
+    .NUM_OUTPUTS   (2),
+    .XLEN          (XLEN),
+    .SID_WIDTH     (SID_WIDTH),
+    .TRACK_DEPTH   (16)
+) switch_inst (
+    .clk        (clk),
+    .reset      (reset),
+
+    // ======================
+    // TileLink A Channel - Masters (CPU)
+    // ======================
+    .a_valid    (cpu_tl_a_valid),
+    .a_ready    (cpu_tl_a_ready),
+    .a_opcode   (cpu_tl_a_opcode),
+    .a_param    (cpu_tl_a_param),
+    .a_size     (cpu_tl_a_size),
+    .a_source   (cpu_tl_a_source),
+    .a_address  (cpu_tl_a_address),
+    .a_mask     (cpu_tl_a_mask),
+    .a_data     (cpu_tl_a_data),
+
+    // ======================
+    // TileLink D Channel - Masters (CPU)
+    // ======================
+    .d_valid    (cpu_tl_d_valid),
+    .d_ready    (cpu_tl_d_ready),
+    .d_opcode   (cpu_tl_d_opcode),
+    .d_param    (cpu_tl_d_param),
+    .d_size     (cpu_tl_d_size),
+    .d_source   (cpu_tl_d_source),
+    .d_data     (cpu_tl_d_data),
+    .d_corrupt  (cpu_tl_d_corrupt),
+    .d_denied   (cpu_tl_d_denied),
+
+    // ======================
+    // A Channel - Slaves (Memory)
+    // ======================
+    .s_a_valid   ({ uart_s_a_valid  , memory_s_a_valid   }),
+    .s_a_ready   ({ uart_s_a_ready  , memory_s_a_ready   }),
+    .s_a_opcode  ({ uart_s_a_opcode , memory_s_a_opcode  }),
+    .s_a_param   ({ uart_s_a_param  , memory_s_a_param   }),
+    .s_a_size    ({ uart_s_a_size   , memory_s_a_size    }),
+    .s_a_source  ({ uart_s_a_source , memory_s_a_source  }),
+    .s_a_mask    ({ uart_s_a_mask   , memory_s_a_mask    }),
+    .s_a_address ({ uart_s_a_address, memory_s_a_address }),
+    .s_a_data    ({ uart_s_a_data   , memory_s_a_data    }),
+
+    // ======================
+    // D Channel - Slaves (Memory)
+    // ======================
+    .s_d_valid    ({ uart_s_d_valid  , memory_s_d_valid   }),
+    .s_d_ready    ({ uart_s_d_ready  , memory_s_d_ready   }),
+    .s_d_opcode   ({ uart_s_d_opcode , memory_s_d_opcode  }),
+    .s_d_param    ({ uart_s_d_param  , memory_s_d_param   }),
+    .s_d_size     ({ uart_s_d_size   , memory_s_d_size    }),
+    .s_d_source   ({ uart_s_d_source , memory_s_d_source  }),
+    .s_d_data     ({ uart_s_d_data   , memory_s_d_data    }),
+    .s_d_corrupt  ({ uart_s_d_corrupt, memory_s_d_corrupt }),
+    .s_d_denied   ({ uart_s_d_denied , memory_s_d_denied  }),
+
+    // ======================
+    // Base Addresses for Slaves
+    // ======================
+    .base_addr    ({ uart_base_address, memory_base_address }),
+    .addr_mask    ({ uart_size        , memory_size         })
+);
+
+// ====================================
+// Instantiate Memory
+// ====================================
+tl_memory #(
+    .XLEN(XLEN),
+    .WIDTH(MEM_WIDTH),
+    .SID_WIDTH(SID_WIDTH),
+    .SIZE(MEM_SIZE),
+    .BYTE_ENABLE(MEM_BYTE_EN)
+) mock_mem (
+    .clk        (clk),
+    .reset      (reset),
+
+    // TileLink A Channel
+    .tl_a_valid   (memory_s_a_valid   ),
+    .tl_a_ready   (memory_s_a_ready   ),
+    .tl_a_opcode  (memory_s_a_opcode  ),
+    .tl_a_param   (memory_s_a_param   ),
+    .tl_a_size    (memory_s_a_size    ),
+    .tl_a_source  (memory_s_a_source  ),
+    .tl_a_address (memory_s_a_address ),
+    .tl_a_mask    (memory_s_a_mask    ),
+    .tl_a_data    (memory_s_a_data    ),
+
+    // TileLink D Channel
+    .tl_d_valid   (memory_s_d_valid   ),
+    .tl_d_ready   (memory_s_d_ready   ),
+    .tl_d_opcode  (memory_s_d_opcode  ),
+    .tl_d_param   (memory_s_d_param   ),
+    .tl_d_size    (memory_s_d_size    ),
+    .tl_d_source  (memory_s_d_source  ),
+    .tl_d_data    (memory_s_d_data    ),
+    .tl_d_corrupt (memory_s_d_corrupt ),
+    .tl_d_denied  (memory_s_d_denied  ),
+
+    // No injected errors
+    .dbg_wait                  (1'b0),
+    .dbg_corrupt_read_address  ({XLEN{1'b1}}),
+    .dbg_denied_read_address   ({XLEN{1'b1}}),
+    .dbg_corrupt_write_address ({XLEN{1'b1}}),
+    .dbg_denied_write_address  ({XLEN{1'b1}})
+);
+
+// ====================================
+// Instantiate UART, only transmitting
+// ====================================
+tl_ul_uart #(
+    .XLEN(XLEN),
+    .SID_WIDTH(SID_WIDTH)
+) uart_inst (
+    .clk        (clk),
+    .reset      (reset),
+
+    // TileLink A Channel
+    .tl_a_valid   (uart_s_a_valid   ),
+    .tl_a_ready   (uart_s_a_ready   ),
+    .tl_a_opcode  (uart_s_a_opcode  ),
+    .tl_a_param   (uart_s_a_param   ),
+    .tl_a_size    (uart_s_a_size    ),
+    .tl_a_source  (uart_s_a_source  ),
+    .tl_a_address (uart_s_a_address ),
+    .tl_a_mask    (uart_s_a_mask    ),
+    .tl_a_data    (uart_s_a_data    ),
+
+    // TileLink D Channel
+    .tl_d_valid   (uart_s_d_valid   ),
+    .tl_d_ready   (uart_s_d_ready   ),
+    .tl_d_opcode  (uart_s_d_opcode  ),
+    .tl_d_param   (uart_s_d_param   ),
+    .tl_d_size    (uart_s_d_size    ),
+    .tl_d_source  (uart_s_d_source  ),
+    .tl_d_data    (uart_s_d_data    ),
+    .tl_d_corrupt (uart_s_d_corrupt ),
+    .tl_d_denied  (uart_s_d_denied  ),
+
+    // UART Interface
+    .rx           (1'b1),
+    .tx           (uart_tx),
+    .irq          (),
+    .rts          (),
+    .cts          (1'b0)
+);
+
+// ====================================
+// Memory access for the harness
+// ====================================
+export "DPI-C" function sim_mem_size;
+export "DPI-C" function sim_write_byte;
+export "DPI-C" function sim_read_byte;
+
+function int sim_mem_size();
+    sim_mem_size = MEM_SIZE;
+endfunction
+
+function void sim_write_byte(input int unsigned address, input byte unsigned value);
+    mock_mem.block_ram_inst.memory[address / (MEM_WIDTH/8)][8 * (address % (MEM_WIDTH/8)) +: 8] = value;
+endfunction
+
+function byte unsigned sim_read_byte(input int unsigned address);
+    sim_read_byte = mock_mem.block_ram_inst.memory[address / (MEM_WIDTH/8)][8 * (address % (MEM_WIDTH/8)) +: 8];
+endfunction
+
+endmodule
@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+import sys
+import re
+import json
+import argparse
+
+# Dhrystone 2.1 on the VAX 11/780, the 1 DMIPS machine
+DHRYSTONE_VAX = 1757
+
+config_pattern  = re.compile(r"^CONFIG\s+(.*)$")
+stop_pattern    = re.compile(r"^Stop reason:\s+(.+)$")
+cycles_pattern  = re.compile(r"^Number of clock cycles:\s+(\d+)")
+instret_pattern = re.compile(r"^Number of instructions retired:\s+(\d+)")
+bench_pattern   = re.compile(r"^BENCH\s+(\S+)\s+cycles=(\d+)\s+instret=(\d+)\s+ops=(\d+)")
+
+def parse_log(log_file):
+    """
+    Read one `make bench` log, the output of etc/runsim.cpp with a CONFIG line in front.
+
+    Returns a list of result rows, one for every BENCH line of the console plus one named after
+    the program for the whole run.
+    """
+    config = "default"
+    stop = "UNKNOWN"
+    cycles = 0
+    instret = 0
+    rows = []
+    errors = 0
+
+    program = log_file.rsplit("/", 1)[-1].rsplit(".", 1)[0]
+
+    try:
+        with open(log_file, "r") as f:
+            for line in f:
+                line = line.strip()
+                match = config_pattern.match(line)
+                if match:
+                    config = match.group(1)
+                    continue
+                match = stop_pattern.match(line)
+                if match:
+                    stop = match.group(1)
+                    continue
+                match = cycles_pattern.match(line)
+                if match:
+                    cycles = int(match.group(1))
+                    continue
+                match = instret_pattern.match(line)
+                if match:
+                    instret = int(match.group(1))
+                    continue
+                match = bench_pattern.match(line)
+                if match:
+                    rows.append({
+                        "bench": match.group(1),
+                        "cycles": int(match.group(2)),
+                        "instret": int(match.group(3)),
+                        "ops": int(match.group(4)),
+                    })
+                    continue
+                # CoreMark's CRC checks, a short run always misses its 10 second minimum
+                if "ERROR!" in line and "10 secs" not in line:
+                    errors += 1
+    except FileNotFoundError:
+        print(f"Error: Log file {log_file} not found.")
+        sys.exit(1)
+
+    rows.append({"bench": f"{program} (total)", "cycles": cycles, "instret": instret, "ops": 0})
+
+    status = "ok" if stop == "HALT" and errors == 0 else stop if stop != "HALT" else "ERRORS"
+    for row in rows:
+        row["config"] = config
+        row["status"] = status
+    return rows
+
+def score(row):
+    """CoreMark/MHz or DMIPS/MHz, None for the other benchmarks."""
+    if not row["cycles"] or not row["ops"]:
+        return None
+    per_mhz = row["ops"] * 1e6 / row["cycles"]
+    if row["bench"] == "coremark":
+        return ("CoreMark/MHz", per_mhz)
+    if row["bench"] == "dhrystone":
+        return ("DMIPS/MHz", per_mhz / DHRYSTONE_VAX)
+    return None
+
+def print_table(rows, baseline):
+    """Print the results as a Markdown table, with the cycle change to baseline if given."""
+    header = ["Config", "Benchmark", "Cycles", "Instret", "IPC", "Cycles/op", "Score", "Status"]
+    if baseline:
+        header.insert(7, "vs. baseline")
+
+    lines = []
+    for row in rows:
+        ipc = f"{row['instret'] / row['cycles']:.3f}" if row["cycles"] else "-"
+        per_op = f"{row['cycles'] / row['ops']:.2f}" if row["ops"] else "-"
+        result = score(row)
+        line = [row["config"], row["bench"], str(row["cycles"]), str(row["instret"]), ipc, per_op,
+                f"{result[1]:.3f} {result[0]}" if result else "-", row["status"]]
+        if baseline:
+            old = baseline.get((row["config"], row["bench"]))
+            if old and old["cycles"]:
+                line.insert(7, f"{100.0 * (row['cycles'] - old['cycles']) / old['cycles']:+.1f}%")
+            else:
+                line.insert(7, "-")
+        lines.append(line)
+
+    widths = [max(len(h), *(len(l[i]) for l in lines)) if lines else len(h) for i, h in enumerate(header)]
+    print("| " + " | ".join(h.ljust(w) for h, w in zip(header, widths)) + " |")
+    print("|" + "|".join("-" * (w + 2) for w in widths) + "|")
+    for line in lines:
+        print("| " + " | ".join(c.ljust(w) for c, w in zip(line, widths)) + " |")
+
+def main():
+    parser = argparse.ArgumentParser(description="Summarize `make bench` logs as a table of cycles, instret, IPC and CoreMark/MHz.")
+    parser.add_argument("logs", nargs="+", help="Logs written by the bench_run target")
+    parser.add_argument("-s", "--save", default=None, help="Write the results to this JSON file")
+    parser.add_argument("-b", "--baseline", default=None, help="JSON file of an earlier --save to compare cycles with")
+
+    args = parser.parse_args()
+
+    rows = []
+    for log_file in args.logs:
+        rows.extend(parse_log(log_file))
+
+    baseline = {}
+    if args.baseline:
+        try:
+            with open(args.baseline, "r") as f:
+                for row in json.load(f):
+                    baseline[(row["config"], row["bench"])] = row
+        except FileNotFoundError:
+            print(f"Error: Baseline file {args.baseline} not found.")
+            sys.exit(1)
+
+    print_table(rows, baseline)
+
+    if args.save:
+        with open(args.save, "w") as f:
+            json.dump(rows, f, indent=2)
+        print(f"Results written to {args.save}")
+
+    # Fail the make target when a benchmark did not finish cleanly
+    if any(row["status"] != "ok" for row in rows):
+        sys.exit(1)
+
+if __name__ == "__main__":
+    main()
@@ -24,21 +24,27 @@ def parse_opcodes(opcode_file):
         sys.exit(1)
     return addr_to_instr
 
-def bin_to_sv_mem(bin_file, sv_file, opcode_file=None, memory_name="mock_mem", mem_width=8):
+def bin_to_sv_mem(bin_file, sv_file, opcode_file=None, memory_name="mock_mem", mem_width=8,
+                  out_format="sv", pad=0):
     """
     Convert a binary file into SystemVerilog word-based memory initialization.
 
     Args:
       bin_file (str): Path to input .bin file
-      sv_file (str): Path to output .sv or .txt file
+      sv_file (str): Path to output .sv, .txt or .hex file
       opcode_file (str): (Optional) Path to a file containing disassembly or instructions
       memory_name (str): Name of the memory instance (e.g. mock_mem)
       mem_width (int): Width of each memory word in bits (8, 16, 32, 64, etc.)
+      out_format (str): "sv" for one assignment per word, "hex" for a $readmemh image
+      pad (int): Pad the image with zero bytes up to this size
 
     In the generated output:
       - memory[i] corresponds to one mem_width-bit word.
-      - We group every 'mem_width/8' bytes into one assignment.
+      - We group every 'mem_width/8' bytes into one assignment (sv) or line (hex).
       - We interpret those bytes in little-endian order.
+
+    The hex image is read with $readmemh at time zero, so unlike the sv assignments it does not
+    have to be parsed and elaborated with the testbench.
     """
 
     # Validate mem_width
@@ -60,6 +66,10 @@ def bin_to_sv_mem(bin_file, sv_file, opcode_file=None, memory_name="mock_mem", m
     try:
         with open(bin_file, "rb") as f_in, open(sv_file, "w") as f_out:
             binary_data = f_in.read()
+            if len(binary_data) > pad > 0:
+                print(f"Error: {bin_file} is {len(binary_data)} bytes, more than the {pad} byte image.")
+                sys.exit(1)
+            binary_data = binary_data + b'\x00' * max(0, pad - len(binary_data))
 
             # Iterate over the input binary in chunks of 'word_bytes'
             # 'addr' is the starting byte index of each chunk.
@@ -95,13 +105,22 @@ def bin_to_sv_mem(bin_file, sv_file, opcode_file=None, memory_name="mock_mem", m
                 # Determine the number of hex digits based on mem_width
                 hex_digits = word_bytes * 2  # 2 hex digits per byte
 
+                if out_format == "hex":
+                    # Example line:
+                    #   44332211 // 0x0: add x1,x2,x3
+                    f_out.write(f"{word_value:0{hex_digits}x}{comment}\n")
+                    continue
+
                 # Example line:
                 #   mock_mem.memory['h0003] = 32'h44332211; // 0x0: add x1,x2,x3
                 f_out.write(
                     f"{memory_name}.block_ram_inst.memory['h{mem_index:04X}] = {mem_width}'h{word_value:0{hex_digits}X};{comment}\n"
                 )
 
-        print(f"SystemVerilog memory initialization written to {sv_file}")
+        if out_format == "hex":
+            print(f"$readmemh image written to {sv_file}")
+        else:
+            print(f"SystemVerilog memory initialization written to {sv_file}")
 
     except FileNotFoundError:
         print(f"Error: File {bin_file} not found.")
@@ -111,12 +130,15 @@ def bin_to_sv_mem(bin_file, sv_file, opcode_file=None, memory_name="mock_mem", m
         sys.exit(1)
 
 def main():
-    parser = argparse.ArgumentParser(description="Convert a binary file into SystemVerilog memory initialization.")
+    parser = argparse.ArgumentParser(description="Convert a binary file into SystemVerilog memory initialization or a $readmemh image.")
     parser.add_argument("input_bin_file", help="Path to input .bin file")
     parser.add_argument("output_sv_file", help="Path to output .sv or .txt file")
     parser.add_argument("input_opcode_file", nargs='?', default=None, help="(Optional) Path to a file containing disassembly or instructions")
     parser.add_argument("-m", "--memory_name", default="mock_mem", help="Name of the memory instance (default: mock_mem)")
     parser.add_argument("-x", "--mem_width", type=int, default=8, help="Width of each memory word in bits (default: 8)")
+    parser.add_argument("-f", "--format", choices=["sv", "hex"], default="sv",
+                        help="sv: memory assignments to `include, hex: $readmemh image (default: sv)")
+    parser.add_argument("-p", "--pad", type=int, default=0, help="Pad the image with zeros to this many bytes")
 
     args = parser.parse_args()
 
@@ -126,7 +148,7 @@ def main():
     memory_name = args.memory_name
     mem_width = args.mem_width
 
-    bin_to_sv_mem(bin_file, sv_file, opcode_file, memory_name, mem_width)
+    bin_to_sv_mem(bin_file, sv_file, opcode_file, memory_name, mem_width, args.format, args.pad)
 
 if __name__ == "__main__":
     main()
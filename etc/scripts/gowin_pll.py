@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+import sys
+import argparse
+
+# Gowin rPLL output dividers
+ODIV_VALUES = [2, 4, 8, 16, 32, 48, 64, 80, 96, 112, 128]
+
+# VCO and CLKOUT ranges in MHz from the GW1N and GW2A datasheets
+FAMILIES = {
+    "GW1N-9C":  {"vco": (400.0, 1200.0), "clkout": (3.125, 600.0)},
+    "GW2A-18C": {"vco": (500.0, 1250.0), "clkout": (3.90625, 625.0)},
+}
+
+def find_pll(clkin, target, family):
+    """
+    Find the rPLL IDIV_SEL, FBDIV_SEL and ODIV_SEL closest to target MHz.
+
+    CLKOUT = CLKIN * (FBDIV_SEL + 1) / (IDIV_SEL + 1) and VCO = CLKOUT * ODIV_SEL, the phase
+    detector runs at CLKIN / (IDIV_SEL + 1) and needs at least 3 MHz.
+
+    Returns (clkout, idiv, fbdiv, odiv) or None.
+    """
+    limits = FAMILIES[family]
+    best = None
+    for idiv in range(64):
+        pfd = clkin / (idiv + 1)
+        if pfd < 3.0:
+            break
+        for fbdiv in range(64):
+            clkout = pfd * (fbdiv + 1)
+            if not limits["clkout"][0] <= clkout <= limits["clkout"][1]:
+                continue
+            for odiv in ODIV_VALUES:
+                vco = clkout * odiv
+                if not limits["vco"][0] <= vco <= limits["vco"][1]:
+                    continue
+                # Closest output first, then the faster phase detector
+                key = (abs(clkout - target), idiv)
+                if best is None or key < best[0]:
+                    best = (key, (clkout, idiv, fbdiv, odiv))
+    return best[1] if best else None
+
+def main():
+    parser = argparse.ArgumentParser(description="Pick Gowin rPLL divider settings for a clock frequency.")
+    parser.add_argument("target_mhz", type=float, help="Wanted output clock in MHz")
+    parser.add_argument("-i", "--clkin", type=float, default=27.0, help="Input clock in MHz (default: 27, the Tang Nano crystal)")
+    parser.add_argument("-f", "--family", choices=sorted(FAMILIES), default="GW2A-18C", help="FPGA family (default: GW2A-18C)")
+    parser.add_argument("-d", "--defines", action="store_true", help="Print the settings as -D options for Makefile.mk")
+
+    args = parser.parse_args()
+
+    result = find_pll(args.clkin, args.target_mhz, args.family)
+    if result is None:
+        print(f"Error: No rPLL setting for {args.target_mhz} MHz on {args.family}.", file=sys.stderr)
+        sys.exit(1)
+    clkout, idiv, fbdiv, odiv = result
+
+    if args.defines:
+        print(f"-DPLL_IDIV={idiv} -DPLL_FBDIV={fbdiv} -DPLL_ODIV={odiv} -DPLL_MHZ={round(clkout)}")
+    else:
+        print(f"CLKOUT {clkout:.3f} MHz: IDIV_SEL={idiv} FBDIV_SEL={fbdiv} ODIV_SEL={odiv} "
+              f"(VCO {clkout * odiv:.1f} MHz)")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+import os
+import sys
+import re
+import json
+import argparse
+
+# nextpnr-himbaechel Gowin bel types by resource
+RESOURCES = {
+    "LUT":  ["LUT4"],
+    "FF":   ["DFF"],
+    "ALU":  ["ALU"],
+    "BRAM": ["BSRAM", "SP", "SDPB", "DPB", "ROM"],
+    "DSP":  ["MULT9X9", "MULT18X18", "MULT36X36", "MULTALU18X18", "MULTALU36X18", "MULTADDALU18X18",
+             "PADD9", "PADD18", "ALU54D", "DSP"],
+}
+
+fmax_pattern = re.compile(r"Max frequency for clock\s+'([^']+)':\s+([\d.]+) MHz\s+\((PASS|FAIL) at ([\d.]+) MHz\)")
+
+def module_of(cell):
+    """Instance path of a cell without the cell itself, the module the path starts or ends in."""
+    parts = cell.replace("\\", "").split(".")
+    return ".".join(parts[:-1]) if len(parts) > 1 else "top"
+
+def parse_run(run_file):
+    """
+    Read one timing_run directory: run.txt (soc, config and target MHz) and the nextpnr
+    report.json next to it, or its nextpnr.log when the report is missing.
+    """
+    directory = os.path.dirname(run_file)
+    try:
+        with open(run_file, "r") as f:
+            fields = f.read().split()
+    except FileNotFoundError:
+        print(f"Error: Run file {run_file} not found.")
+        sys.exit(1)
+    soc = fields[0] if fields else "?"
+    config = fields[1] if len(fields) > 2 else "default"
+    target = float(fields[-1]) if len(fields) > 1 else 0.0
+
+    result = {"soc": soc, "config": config, "target_mhz": target, "clocks": {}, "usage": {},
+              "critical_path": None, "status": "failed"}
+
+    report_file = os.path.join(directory, "report.json")
+    if os.path.exists(report_file):
+        with open(report_file, "r") as f:
+            report = json.load(f)
+        for clock, fmax in report.get("fmax", {}).items():
+            result["clocks"][clock] = {"achieved": fmax.get("achieved", 0.0),
+                                       "constraint": fmax.get("constraint", target)}
+        for bel, usage in report.get("utilization", {}).items():
+            result["usage"][bel] = {"used": usage.get("used", 0), "available": usage.get("available", 0)}
+        for path in report.get("critical_paths", [])[:1]:
+            steps = path.get("path", [])
+            if steps:
+                start = steps[0].get("from", {}).get("cell", "")
+                end = steps[-1].get("to", {}).get("cell", "")
+                delay = sum(step.get("delay", 0.0) for step in steps)
+                result["critical_path"] = {"from": module_of(start), "to": module_of(end),
+                                           "delay_ns": delay}
+        result["status"] = "ok"
+    else:
+        log_file = os.path.join(directory, "nextpnr.log")
+        if os.path.exists(log_file):
+            with open(log_file, "r") as f:
+                for line in f:
+                    match = fmax_pattern.search(line)
+                    if match:
+                        result["clocks"][match.group(1)] = {"achieved": float(match.group(2)),
+                                                            "constraint": float(match.group(4))}
+
+    return result
+
+def resource(usage, name):
+    """Used / available count of one RESOURCES group."""
+    used = available = 0
+    for bel, counts in usage.items():
+        if bel in RESOURCES[name]:
+            used += counts["used"]
+            available += counts["available"]
+    return f"{used}/{available}" if available else str(used)
+
+def print_table(results):
+    """Print one Markdown table row per run with the slowest clock."""
+    header = ["SoC", "Config", "Fmax MHz", "Target MHz", "Met", "LUT", "FF", "ALU", "BRAM", "DSP",
+              "Critical path"]
+    lines = []
+    for result in results:
+        clocks = result["clocks"]
+        if clocks:
+            slowest = min(clocks.values(), key=lambda c: c["achieved"])
+            fmax = f"{slowest['achieved']:.2f}"
+            met = "yes" if slowest["achieved"] >= slowest["constraint"] else "no"
+        else:
+            fmax = "-"
+            met = "-"
+        path = result["critical_path"]
+        path_text = f"{path['from']} -> {path['to']}" if path else "-"
+        if result["status"] != "ok":
+            path_text = result["status"]
+        lines.append([result["soc"], result["config"], fmax, f"{result['target_mhz']:g}", met,
+                      *(resource(result["usage"], name) for name in RESOURCES), path_text])
+
+    widths = [max(len(h), *(len(l[i]) for l in lines)) if lines else len(h) for i, h in enumerate(header)]
+    print("| " + " | ".join(h.ljust(w) for h, w in zip(header, widths)) + " |")
+    print("|" + "|".join("-" * (w + 2) for w in widths) + "|")
+    for line in lines:
+        print("| " + " | ".join(c.ljust(w) for c, w in zip(line, widths)) + " |")
+
+def main():
+    parser = argparse.ArgumentParser(description="Collect `make timing` nextpnr reports into a table and a JSON file.")
+    parser.add_argument("runs", nargs="+", help="run.txt files written by the timing_run target")
+    parser.add_argument("-s", "--save", default=None, help="Write the results to this JSON file")
+
+    args = parser.parse_args()
+
+    results = [parse_run(run_file) for run_file in args.runs]
+    print_table(results)
+
+    if args.save:
+        with open(args.save, "w") as f:
+            json.dump(results, f, indent=2)
+        print(f"Results written to {args.save}")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,241 @@
+#!/usr/bin/env python3
+import sys
+import re
+import struct
+import argparse
+
+# Record layout of etc/runsim.cpp --retire-trace
+TRACE_MAGIC  = b"RVTRACE\0"
+TRACE_STATES = 12
+RECORD       = struct.Struct(f"<QII{TRACE_STATES}H")
+
+# tl_cpu.sv cpu_state_t, tl_cpu_pipe.sv reports its stalls with the same numbers
+STATE_NAMES = ["RESET", "IF", "ID", "EX", "MEM", "WB", "WFI", "TRAP", "MUL_DIV", "9", "10", "11+"]
+
+label_pattern  = re.compile(r"^([0-9a-fA-F]+) <([^>]+)>:$")
+opcode_pattern = re.compile(r"^\s*([0-9a-fA-F]+):\s+([0-9a-fA-F ]+?)\s{2,}(.+)$")
+
+def parse_disassembly(dis_file):
+    """
+    Parse an objdump listing, the .opcodes file of a binary or `objdump -d` of the linked ELF.
+
+    Returns the instruction text by address and the sorted (address, name) function starts,
+    which are only there for an ELF listing.
+    """
+    addr_to_instr = {}
+    functions = []
+
+    try:
+        with open(dis_file, "r") as f:
+            for line in f:
+                line = line.rstrip()
+                match = label_pattern.match(line)
+                if match:
+                    functions.append((int(match.group(1), 16), match.group(2)))
+                    continue
+                match = opcode_pattern.match(line)
+                if match:
+                    addr_to_instr[int(match.group(1), 16)] = " ".join(match.group(3).split())
+    except FileNotFoundError:
+        print(f"Error: Disassembly file {dis_file} not found.")
+        sys.exit(1)
+
+    functions.sort()
+    return addr_to_instr, functions
+
+def read_trace(trace_file):
+    """Yield (pc, instruction, cycles, state cycles) for every record of a retire trace."""
+    try:
+        with open(trace_file, "rb") as f:
+            header = f.read(16)
+            if len(header) != 16 or header[:8] != TRACE_MAGIC:
+                print(f"Error: {trace_file} is not a retire trace.")
+                sys.exit(1)
+            version, size = struct.unpack("<II", header[8:])
+            if version != 1 or size != RECORD.size:
+                print(f"Error: {trace_file} is trace version {version} with {size} byte records.")
+                sys.exit(1)
+            while True:
+                data = f.read(RECORD.size)
+                if len(data) < RECORD.size:
+                    break
+                fields = RECORD.unpack(data)
+                yield fields[0], fields[1], fields[2], fields[3:]
+    except FileNotFoundError:
+        print(f"Error: Trace file {trace_file} not found.")
+        sys.exit(1)
+
+def function_of(functions, address):
+    """Name of the function holding address, by the closest label below it."""
+    low, high = 0, len(functions)
+    while low < high:
+        mid = (low + high) // 2
+        if functions[mid][0] <= address:
+            low = mid + 1
+        else:
+            high = mid
+    return functions[low - 1][1] if low else "?"
+
+def jump_target(pc, instruction):
+    """
+    Target of a conditional branch or a `jal x0` (a plain jump) at pc, None for anything else.
+
+    Calls, jalr (returns, indirect jumps) and trap entries have no target in the instruction
+    word, so they never look like a loop. Compressed instructions are recorded expanded.
+    """
+    opcode = instruction & 0x7F
+    if opcode == 0x63:
+        imm = (((instruction >> 31) & 0x1) << 12 | ((instruction >> 7) & 0x1) << 11 |
+               ((instruction >> 25) & 0x3F) << 5 | ((instruction >> 8) & 0xF) << 1)
+        bits = 13
+    elif opcode == 0x6F and (instruction >> 7) & 0x1F == 0:
+        imm = (((instruction >> 31) & 0x1) << 20 | ((instruction >> 12) & 0xFF) << 12 |
+               ((instruction >> 20) & 0x1) << 11 | ((instruction >> 21) & 0x3FF) << 1)
+        bits = 21
+    else:
+        return None
+    if imm >> (bits - 1):
+        imm -= 1 << bits
+    return (pc + imm) & 0xFFFF_FFFF_FFFF_FFFF
+
+def print_table(title, header, lines):
+    """Print a Markdown table."""
+    print(f"\n### {title}\n")
+    widths = [max(len(h), *(len(l[i]) for l in lines)) if lines else len(h) for i, h in enumerate(header)]
+    print("| " + " | ".join(h.ljust(w) for h, w in zip(header, widths)) + " |")
+    print("|" + "|".join("-" * (w + 2) for w in widths) + "|")
+    for line in lines:
+        print("| " + " | ".join(c.ljust(w) for c, w in zip(line, widths)) + " |")
+
+def top_state(states):
+    """Name and share of the state with the most cycles."""
+    total = sum(states)
+    if not total:
+        return "-"
+    index = max(range(TRACE_STATES), key=lambda s: states[s])
+    return f"{STATE_NAMES[index]} {100.0 * states[index] / total:.0f}%"
+
+def main():
+    parser = argparse.ArgumentParser(description="Aggregate a sim_runner retire trace into a per-function, per-loop and per-instruction hotspot profile.")
+    parser.add_argument("trace_file", help="Retire trace written by Vsim_runner --retire-trace")
+    parser.add_argument("dis_file", nargs="?", default=None, help="(Optional) objdump listing, `objdump -d` of the ELF adds function names")
+    parser.add_argument("-n", "--top", type=int, default=20, help="Rows in the loop and instruction tables (default: 20)")
+    parser.add_argument("-c", "--csv", default=None, help="Also write every record to this CSV file")
+
+    args = parser.parse_args()
+
+    addr_to_instr, functions = parse_disassembly(args.dis_file) if args.dis_file else ({}, [])
+
+    # Per address: retirements, cycles and cycles per state
+    per_pc = {}
+    # Per backward jump (branch, target): [iterations, cycles of the iterations]
+    loops = {}
+    # Per loop, the cycle count at which its current iteration started and at which it was last
+    # left, plus the cycle count before the latest retirement of every address
+    loop_begin = {}
+    loop_exit = {}
+    last_visit = {}
+    totals = [0] * TRACE_STATES
+    total_cycles = 0
+    retired = 0
+
+    csv = open(args.csv, "w") if args.csv else None
+    if csv:
+        csv.write("pc,instruction,cycles," + ",".join(STATE_NAMES) + ",disassembly\n")
+
+    previous = None
+    previous_target = None
+    for pc, instruction, cycles, states in read_trace(args.trace_file):
+        # An iteration runs from the arrival at the loop start to its backward jump, the first one
+        # from the latest retirement of the start since the loop was last left. Only a branch or
+        # jump whose target is pc counts, returns and trap entries do not
+        if previous_target is not None:
+            key = (previous, previous_target)
+            if pc == previous_target and previous_target <= previous:
+                begin = loop_begin.get(key)
+                visit = last_visit.get(pc)
+                if begin is None:
+                    # None when the loop is entered at its backward jump (a rotated loop)
+                    begin = visit if visit is not None and visit >= loop_exit.get(key, 0) else None
+                elif visit is not None and visit > begin:
+                    begin = visit
+                entry = loops.get(key)
+                if entry is None:
+                    entry = loops[key] = [0, 0]
+                if begin is not None:
+                    entry[0] += 1
+                    entry[1] += total_cycles - begin
+                loop_begin[key] = total_cycles
+            elif key in loop_begin:
+                # Not taken, the last pass ends the loop
+                entry = loops[key]
+                entry[0] += 1
+                entry[1] += total_cycles - loop_begin.pop(key)
+                loop_exit[key] = total_cycles
+        last_visit[pc] = total_cycles
+
+        entry = per_pc.get(pc)
+        if entry is None:
+            entry = per_pc[pc] = [0, 0, [0] * TRACE_STATES]
+        entry[0] += 1
+        entry[1] += cycles
+        for s in range(TRACE_STATES):
+            entry[2][s] += states[s]
+            totals[s] += states[s]
+        total_cycles += cycles
+        retired += 1
+
+        previous = pc
+        previous_target = jump_target(pc, instruction)
+
+        if csv:
+            csv.write(f"0x{pc:x},0x{instruction:08x},{cycles}," + ",".join(map(str, states)) +
+                      f",\"{addr_to_instr.get(pc, '')}\"\n")
+
+    if csv:
+        csv.close()
+        print(f"CSV trace written to {args.csv}")
+
+    if not retired:
+        print("The trace holds no retired instructions.")
+        return
+
+    print(f"Retired instructions: {retired}")
+    print(f"Cycles:               {total_cycles}")
+    print(f"CPI:                  {total_cycles / retired:.3f}")
+    print("Cycles per state:     " + ", ".join(f"{STATE_NAMES[s]} {100.0 * totals[s] / total_cycles:.1f}%"
+                                              for s in range(TRACE_STATES) if totals[s]))
+
+    if functions:
+        per_function = {}
+        for pc, (count, cycles, states) in per_pc.items():
+            name = function_of(functions, pc)
+            entry = per_function.get(name)
+            if entry is None:
+                entry = per_function[name] = [0, 0, [0] * TRACE_STATES]
+            entry[0] += count
+            entry[1] += cycles
+            for s in range(TRACE_STATES):
+                entry[2][s] += states[s]
+        lines = [[name, str(count), str(cycles), f"{100.0 * cycles / total_cycles:.1f}%",
+                  f"{cycles / count:.2f}", top_state(states)]
+                 for name, (count, cycles, states) in sorted(per_function.items(), key=lambda i: -i[1][1])]
+        print_table("Functions", ["Function", "Instructions", "Cycles", "Share", "CPI", "Top state"], lines)
+
+    # Loop cycles are those of its iterations, inner loops and calls made from it included
+    loop_cycles = [(cycles, start, end, iterations) for (end, start), (iterations, cycles) in loops.items()]
+    lines = []
+    for cycles, start, end, iterations in sorted(loop_cycles, reverse=True)[:args.top]:
+        name = function_of(functions, start) if functions else ""
+        lines.append([f"0x{start:x}-0x{end:x}", name, str(iterations), str(cycles),
+                      f"{100.0 * cycles / total_cycles:.1f}%", f"{cycles / iterations:.1f}"])
+    print_table("Loops", ["Range", "Function", "Iterations", "Cycles", "Share", "Cycles/iteration"], lines)
+
+    lines = []
+    for pc, (count, cycles, states) in sorted(per_pc.items(), key=lambda i: -i[1][1])[:args.top]:
+        lines.append([f"0x{pc:x}", addr_to_instr.get(pc, ""), str(count), str(cycles),
+                      f"{100.0 * cycles / total_cycles:.1f}%", f"{cycles / count:.2f}", top_state(states)])
+    print_table("Instructions", ["PC", "Instruction", "Count", "Cycles", "Share", "CPI", "Top state"], lines)
+
+if __name__ == "__main__":
+    main()
@@ -16,6 +16,8 @@
  *                            determines the depth of the memory array.
  * - `WIDTH` (default: 8): Defines the width of each memory word in bits. Common widths include
  *                            8, 16, 32, 64, etc.
+ * - `BYTE_ENABLE` (default: 0): When set, `write_strb` selects which bytes of the word a write
+ *                               updates. When clear, every write replaces the whole word.
  *
  * **Interface:**
  * 
@@ -30,6 +32,8 @@
  * - `write_address` (`input`): Address for the write operation. The width is determined by the
  *                              `SIZE` and `WIDTH` parameters to ensure proper addressing.
  * - `write_data` (`input` [WIDTH-1:0]): Data to be written to the memory.
+ * - `write_strb` (`input` [WIDTH/8-1:0]): Byte enables for the write, bit `n` covers
+ *                                         `write_data[8n+7:8n]`. Only used with `BYTE_ENABLE`.
  * 
  * - `read_address` (`input`): Address for the read operation. The width is determined by the
  *                             `SIZE` and `WIDTH` parameters to ensure proper addressing.
@@ -41,6 +45,9 @@
  *   - On the rising edge of `clk`, if `write_en` is asserted, `write_data` is written to the
  *     memory location specified by `write_address`.
  *   - The write operation is synchronous with the clock.
+ *   - With `BYTE_ENABLE` set only the bytes whose `write_strb` bit is high are written, the
+ *     other bytes of the word keep their value. Each byte lane has its own write process so
+ *     synthesis can map it onto the byte write enables of the block RAM.
  * 
  * - **Read Operation:**
  *   - On the rising edge of `clk`, the data stored at `read_address` is read and presented on
@@ -123,6 +130,7 @@
  *     .write_en(write_enable),
  *     .write_address(write_addr),
  *     .write_data(write_data),
+ *     .write_strb(4'b1111),
  *     .read_address(read_addr),
  *     .read_data(read_data)
  * );
@@ -136,13 +144,15 @@
 
 module block_ram #(
     parameter int SIZE  = 1024,
-    parameter int WIDTH = 8
+    parameter int WIDTH = 8,
+    parameter int BYTE_ENABLE = 0
 ) (
 	input  wire         						clk,
 	input  wire         						reset,
 	input  wire         						write_en,
 	input  wire [$clog2(SIZE/(WIDTH/8)) - 1:0]  write_address,
 	input  wire [WIDTH-1:0]   					write_data,
+	input  wire [WIDTH/8-1:0]   				write_strb,
 	input  wire [$clog2(SIZE/(WIDTH/8)) - 1:0]  read_address,
 	output reg  [WIDTH-1:0]   					read_data
 );
@@ -164,11 +174,24 @@ always @(posedge clk or posedge reset) begin
 	end
 end
 
-always @(posedge clk) begin
-	if (write_en) begin
-		memory[write_address] <= write_data;
+genvar lane;
+generate
+	if (BYTE_ENABLE) begin : gen_byte_write
+		for (lane = 0; lane < WIDTH/8; lane = lane + 1) begin : gen_lane
+			always @(posedge clk) begin
+				if (write_en && write_strb[lane]) begin
+					memory[write_address][8*lane +: 8] <= write_data[8*lane +: 8];
+				end
+			end
+		end
+	end else begin : gen_word_write
+		always @(posedge clk) begin
+			if (write_en) begin
+				memory[write_address] <= write_data;
+			end
+		end
 	end
-end
+endgenerate
 endmodule
 
 `endif // __BLOCK_RAM__
@@ -0,0 +1,105 @@
+`ifndef __BLOCK_RAM_DP__
+`define __BLOCK_RAM_DP__
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// block_ram_dp Module
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @module block_ram_dp
+ * @brief True Dual-Port Block RAM with Byte Enables.
+ *
+ * The `block_ram_dp` module is the dual-port counterpart of `block_ram`. It has two independent
+ * ports, `a` and `b`, and each of them can read or write any word in the same cycle as the
+ * other one. This maps onto the true dual-port mode of FPGA block RAMs.
+ *
+ * **Parameters:**
+ * - `SIZE` (default: 1024): Specifies the total size of the memory in bytes.
+ * - `WIDTH` (default: 32): Defines the width of each memory word in bits.
+ *
+ * **Ports (for each of `a` and `b`):**
+ * - `*_write_en` (`input`): Write enable. When high, the bytes of `*_write_data` selected by
+ *                           `*_write_strb` are written to `*_address` on the rising edge of `clk`.
+ * - `*_write_strb` (`input` [WIDTH/8-1:0]): Byte enables for the write.
+ * - `*_address` (`input`): Word address used for both the read and the write.
+ * - `*_write_data` (`input` [WIDTH-1:0]): Data to be written.
+ * - `*_read_data` (`output` reg [WIDTH-1:0]): Word at `*_address`, registered on the rising edge
+ *                                            of `clk`.
+ *
+ * **Behavior:**
+ * - Each port reads every cycle. A read returns the contents from before a write in the same
+ *   cycle, on its own port as well as on the other one (read-first).
+ * - Writes from both ports to the same byte in the same cycle are undefined, just like on the
+ *   hardware. Callers have to keep them apart.
+ * - `reset` asynchronously clears both `read_data` outputs; the memory contents are kept.
+ */
+
+`timescale 1ns / 1ps
+`default_nettype none
+
+`include "log.sv"
+
+module block_ram_dp #(
+    parameter int SIZE  = 1024,
+    parameter int WIDTH = 32
+) (
+	input  wire         						clk,
+	input  wire         						reset,
+
+	// Port A
+	input  wire         						a_write_en,
+	input  wire [WIDTH/8-1:0]   				a_write_strb,
+	input  wire [$clog2(SIZE/(WIDTH/8)) - 1:0]  a_address,
+	input  wire [WIDTH-1:0]   					a_write_data,
+	output reg  [WIDTH-1:0]   					a_read_data,
+
+	// Port B
+	input  wire         						b_write_en,
+	input  wire [WIDTH/8-1:0]   				b_write_strb,
+	input  wire [$clog2(SIZE/(WIDTH/8)) - 1:0]  b_address,
+	input  wire [WIDTH-1:0]   					b_write_data,
+	output reg  [WIDTH-1:0]   					b_read_data
+);
+
+initial begin
+    `ASSERT((WIDTH >= 8), "WIDTH must be at least 8 bits.");
+    `ASSERT((WIDTH % 8 == 0), "WIDTH must be divisible by 8 to ensure byte alignment.");
+    `ASSERT((SIZE % (WIDTH / 8) == 0), "SIZE must be a multiple of WIDTH/8 to ensure proper byte alignment.");
+end
+
+(* ram_style = "block" *)
+reg [WIDTH-1:0] memory[(SIZE/(WIDTH/8)) - 1:0];
+
+always @(posedge clk or posedge reset) begin
+	if (reset) begin
+		a_read_data <= 0;
+	end else begin
+		a_read_data <= memory[a_address];
+	end
+end
+
+always @(posedge clk or posedge reset) begin
+	if (reset) begin
+		b_read_data <= 0;
+	end else begin
+		b_read_data <= memory[b_address];
+	end
+end
+
+genvar lane;
+generate
+	for (lane = 0; lane < WIDTH/8; lane = lane + 1) begin : gen_lane
+		always @(posedge clk) begin
+			if (a_write_en && a_write_strb[lane]) begin
+				memory[a_address][8*lane +: 8] <= a_write_data[8*lane +: 8];
+			end
+		end
+
+		always @(posedge clk) begin
+			if (b_write_en && b_write_strb[lane]) begin
+				memory[b_address][8*lane +: 8] <= b_write_data[8*lane +: 8];
+			end
+		end
+	end
+endgenerate
+endmodule
+
+`endif // __BLOCK_RAM_DP__
@@ -20,13 +20,21 @@
  * - Detects rising edges on NMI inputs to handle edge-triggered NMIs.
  * - Updates `mip` based on `irq` and edge-detected `nmi` inputs.
  * - `mip` is read-only and cannot be modified via CSR writes.
+ * - `mip` bit 7 (MTIP) follows `timer_irq`, when `IRQ_COUNT + NMI_COUNT` leave it free.
  * - Supports CSR instructions by handling operations like CSRRW, CSRRS, etc.
+ * - `mcycle`, `minstret` and `HPM_COUNT` performance counters starting at `mhpmcounter3`,
+ *   each with a high half and an inhibit bit in `mcountinhibit`.
  *
  * @param XLEN            Data width (default: 32)
  * @param NMI_COUNT       Number of Non-Maskable Interrupts (default: 4)
  * @param IRQ_COUNT       Number of standard Interrupt Requests (default: 4)
  * @param MTVEC_RESET_VAL Reset value for `mtvec` register (default: 0)
  * @param MHARTID_VAL     Reset value for `mheartid` register (default: 0)
+ * @param HPM_COUNT       Number of `mhpmcounter` registers, 1 to 29 (default: 5)
+ *
+ * The events are hardwired: `mhpmcounter3+n` counts the cycles `perf_event[n]` is high, so the
+ * CPU decides what each counter measures. `minstret` counts the cycles `perf_retire` is high.
+ * There are no `mhpmevent` registers, they read as zero.
  *
  * Developers should ensure that `XLEN` is sufficiently large to accommodate
  * both standard interrupts and NMIs. Additionally, proper prioritization and
@@ -64,10 +72,12 @@
 
 // Performance Counters
 `define CSR_MCYCLE       12'hB00 // Machine Cycle Counter
-// `define CSR_MINSTRET     12'hB02 // Machine Instructions Retired Counter
+`define CSR_MINSTRET     12'hB02 // Machine Instructions Retired Counter
+`define CSR_MHPMCOUNTER3 12'hB03 // Machine Performance Counter 3, first of HPM_COUNT
 `define CSR_MCYCLEH      12'hB80 // Machine Cycle Counter High
-// `define CSR_MINSTRETH    12'hB82 // Machine Instructions Retired Counter High
-// `define CSR_MCOUNTINHIBIT  12'h320 // Machine Counter/Timer Inhibit Register
+`define CSR_MINSTRETH    12'hB82 // Machine Instructions Retired Counter High
+`define CSR_MHPMCOUNTER3H 12'hB83 // Machine Performance Counter 3 High, first of HPM_COUNT
+`define CSR_MCOUNTINHIBIT  12'h320 // Machine Counter/Timer Inhibit Register
 
 //*****************************
 // Supervisor-Level CSRs (S-mode)
@@ -159,9 +169,14 @@
 `define HAS_B 0
 `endif
 
+`ifdef SUPPORT_C
+`define HAS_C 1
+`else
+`define HAS_C 0
+`endif
+
 // Unsupported extentions 
 `define HAS_A 0 
-`define HAS_C 0 
 `define HAS_D 0 
 `define HAS_E 0 
 `define HAS_F 0 
@@ -181,7 +196,8 @@ module cpu_csr #(
     parameter NMI_COUNT = 4,                            // Number of NMIs (must satisfy XLEN > IRQ_COUNT + NMI_COUNT)
     parameter IRQ_COUNT = 4,                            // Number of standard IRQs (must satisfy XLEN > IRQ_COUNT + NMI_COUNT)
     parameter MTVEC_RESET_VAL = {XLEN{1'b0}},           // Reset value for mtvec_reg (default: 0)
-    parameter MHARTID_VAL = {XLEN{1'b0}}                // Reset value for mhartid_reg (default: 0)
+    parameter MHARTID_VAL = {XLEN{1'b0}},               // Reset value for mhartid_reg (default: 0)
+    parameter HPM_COUNT = 5                             // Number of mhpmcounters, starting at mhpmcounter3
 ) (
     input  wire                    clk,                // Shared Clock
     input  wire                    reset,              // Shared Reset
@@ -209,10 +225,16 @@ module cpu_csr #(
 
     // Output Signals
     output reg                     interrupt_pending,  // 
+    output reg                     interrupt_waiting,  // An enabled interrupt is pending, ignoring mstatus.MIE (wfi)
+
+    // Performance Counter Events
+    input  wire                    perf_retire,        // An instruction retired this cycle
+    input  wire [HPM_COUNT-1:0]    perf_event,         // Increment mhpmcounter3+n this cycle
 
     // Interrupt Request Lines
     input  wire [IRQ_COUNT-1:0]    irq,                // Standard IRQs
-    input  wire [NMI_COUNT-1:0]    nmi                 // Non-Maskable IRQs (Edge-Triggered)
+    input  wire [NMI_COUNT-1:0]    nmi,                // Non-Maskable IRQs (Edge-Triggered)
+    input  wire                    timer_irq           // Machine Timer Interrupt (mip.MTIP)
 );
 
 // ──────────────────────────
@@ -224,6 +246,10 @@ initial begin
                 XLEN, IRQ_COUNT, NMI_COUNT);
         $finish;
     end
+    if (HPM_COUNT < 1 || HPM_COUNT > 29) begin
+        $error("Parameter Error: HPM_COUNT (%0d) must be between 1 and 29", HPM_COUNT);
+        $finish;
+    end
 end
 
 // ──────────────────────────
@@ -233,6 +259,8 @@ localparam NMI_BITS_WIDTH  = NMI_COUNT;
 localparam IRQ_BITS_WIDTH  = IRQ_COUNT;
 localparam IRQ_BITS_START  = 0;
 localparam NMI_BITS_START  = IRQ_BITS_WIDTH; // Starting bit for NMIs
+localparam MTIP_BIT        = 7;              // Machine timer interrupt, unless IRQs or NMIs use it
+localparam HAS_MTIP        = (IRQ_COUNT + NMI_COUNT) <= MTIP_BIT;
 
 // ──────────────────────────
 // Define masks for writable bits
@@ -241,11 +269,16 @@ localparam NMI_BITS_START  = IRQ_BITS_WIDTH; // Starting bit for NMIs
 localparam MIP_WRITE_MASK     = ((1 << NMI_BITS_WIDTH) - 1) << NMI_BITS_START;
 // 2) MSTATUS_WRITE_MASK allows writing specific bits (e.g., MIE, etc.)
 localparam MSTATUS_WRITE_MASK = (1 << 3) | (1 << 1) | (1 << 0); 
+// 3) MCOUNTINHIBIT_WRITE_MASK covers CY, IR and one bit per mhpmcounter
+localparam MCOUNTINHIBIT_WRITE_MASK = (((1 << HPM_COUNT) - 1) << 3) | (1 << 2) | (1 << 0);
 
 // ──────────────────────────
 // Registers
 // ──────────────────────────
 logic [(XLEN*2)-1:0] cycle_counter;
+logic [(XLEN*2)-1:0] instret_counter;
+logic [HPM_COUNT-1:0][(XLEN*2)-1:0] hpm_counter;
+logic [XLEN-1:0]     mcountinhibit_reg;
 logic [XLEN-1:0]     marchid_reg;
 logic [XLEN-1:0]     mhartid_reg;
 logic [XLEN-1:0]     misa_reg;
@@ -292,21 +325,55 @@ assign mcause = mcause_reg;
 // ──────────────────────────
 // Interrupt pending logic
 // ──────────────────────────
-assign interrupt_pending = ((mip_reg & mie_reg) != 0) && mstatus_reg[3];
+assign interrupt_waiting = ((mip_reg & mie_reg) != 0);
+assign interrupt_pending = interrupt_waiting && mstatus_reg[3];
 
 logic op_busy;
 
 // ──────────────────────────
-// Cycle Counter Increment
+// Performance Counter Access
 // ──────────────────────────
-always_ff @(posedge clk or posedge reset) begin
-    if (reset) begin
-        cycle_counter <= {2*XLEN{1'b0}};
-    end else begin
-        cycle_counter <= cycle_counter + 1;
+// The counters are incremented in the write logic below, so a CSR write in the same cycle wins
+// over the increment. Each interface reads the mhpmcounter half at its address, or zero.
+logic [XLEN-1:0] hpm_reg_rdata;
+logic [XLEN-1:0] hpm_op_rdata;
+always_comb begin
+    hpm_reg_rdata = {XLEN{1'b0}};
+    hpm_op_rdata  = {XLEN{1'b0}};
+    for (int n = 0; n < HPM_COUNT; n++) begin
+        if (reg_addr == `CSR_MHPMCOUNTER3  + n) hpm_reg_rdata = hpm_counter[n][XLEN-1:0];
+        if (reg_addr == `CSR_MHPMCOUNTER3H + n) hpm_reg_rdata = hpm_counter[n][(XLEN*2)-1:XLEN];
+        if (op_addr  == `CSR_MHPMCOUNTER3  + n) hpm_op_rdata  = hpm_counter[n][XLEN-1:0];
+        if (op_addr  == `CSR_MHPMCOUNTER3H + n) hpm_op_rdata  = hpm_counter[n][(XLEN*2)-1:XLEN];
     end
 end
 
+// CSRRS/CSRRC with a zero operand and CSRRSI/CSRRCI with a zero immediate only read the CSR
+logic op_writes;
+always_comb begin
+    case (op_control)
+        `CSR_RW, `CSR_RWI: op_writes = 1'b1;
+        `CSR_RS, `CSR_RC : op_writes = (op_operand != 0);
+        `CSR_RSI, `CSR_RCI: op_writes = (op_imm != 0);
+        default          : op_writes = 1'b0;
+    endcase
+end
+
+// New value of a counter half for the CSR operation on the Operation Interface
+function automatic [XLEN-1:0] counter_op_result(input [XLEN-1:0] value);
+    logic [XLEN-1:0] imm_extended;
+    imm_extended = { {(XLEN-5){1'b0}}, op_imm };
+    case (op_control)
+        `CSR_RW : counter_op_result = op_operand;
+        `CSR_RS : counter_op_result = value | op_operand;
+        `CSR_RC : counter_op_result = value & ~op_operand;
+        `CSR_RWI: counter_op_result = imm_extended;
+        `CSR_RSI: counter_op_result = value | imm_extended;
+        `CSR_RCI: counter_op_result = value & ~imm_extended;
+        default : counter_op_result = value;
+    endcase
+endfunction
+
 // ──────────────────────────
 // Combine Standard IRQs and Edge-Detected NMIs into mip
 // ──────────────────────────
@@ -316,6 +383,7 @@ always_ff @(posedge clk or posedge reset) begin
     end else begin
         mip_reg[IRQ_BITS_START +: IRQ_BITS_WIDTH] <= irq;
         mip_reg[NMI_BITS_START +: NMI_BITS_WIDTH] <= mip_reg[NMI_BITS_START +: NMI_BITS_WIDTH] | nmi_edge;
+        if (HAS_MTIP) mip_reg[MTIP_BIT] <= timer_irq;
     end
 end
 
@@ -338,8 +406,11 @@ always_comb begin
         `CSR_MIP       : reg_rdata = mip_reg;
         `CSR_MCYCLE    : reg_rdata = cycle_counter[XLEN-1:0];
         `CSR_MCYCLEH   : reg_rdata = cycle_counter[(XLEN*2)-1:XLEN];
+        `CSR_MINSTRET  : reg_rdata = instret_counter[XLEN-1:0];
+        `CSR_MINSTRETH : reg_rdata = instret_counter[(XLEN*2)-1:XLEN];
+        `CSR_MCOUNTINHIBIT : reg_rdata = mcountinhibit_reg;
         `CSR_MSCRATCH  : reg_rdata = mscratch_reg;
-        default        : reg_rdata = {XLEN{1'b0}};
+        default        : reg_rdata = hpm_reg_rdata; // mhpmcounters or zero
     endcase
 end
 
@@ -359,8 +430,11 @@ always_comb begin
             `CSR_MCAUSE   : op_rdata = mcause_reg;
             `CSR_MCYCLE   : op_rdata = cycle_counter[XLEN-1:0];
             `CSR_MCYCLEH  : op_rdata = cycle_counter[(XLEN*2)-1:XLEN];
+            `CSR_MINSTRET : op_rdata = instret_counter[XLEN-1:0];
+            `CSR_MINSTRETH: op_rdata = instret_counter[(XLEN*2)-1:XLEN];
+            `CSR_MCOUNTINHIBIT : op_rdata = mcountinhibit_reg;
             `CSR_MSCRATCH : op_rdata = mscratch_reg;
-            default       : op_rdata = {XLEN{1'b0}};
+            default       : op_rdata = hpm_op_rdata;  // mhpmcounters or zero
         endcase
     end
 end
@@ -386,7 +460,12 @@ always_ff @(posedge clk or posedge reset) begin
                         (XLEN == 128) ? 2'b10 : 2'b11) |
                         ((`HAS_M) ? 3'b100 : 3'b000) |
                         ((`HAS_B) ? 4'b1000 : 4'b0000);
-        cycle_counter <= {2*XLEN{1'b0}};
+        cycle_counter     <= {2*XLEN{1'b0}};
+        instret_counter   <= {2*XLEN{1'b0}};
+        mcountinhibit_reg <= {XLEN{1'b0}};
+        for (int n = 0; n < HPM_COUNT; n++) begin
+            hpm_counter[n] <= {2*XLEN{1'b0}};
+        end
 
         misa_reg <= {(XLEN){1'b0}} |
                     // Base ISA width
@@ -417,6 +496,13 @@ always_ff @(posedge clk or posedge reset) begin
         op_busy  = 1'b0;
         op_done  = 1'b0;
     end else begin
+        // Performance counters, unless inhibited
+        if (~mcountinhibit_reg[0]) cycle_counter <= cycle_counter + 1;
+        if (~mcountinhibit_reg[2] && perf_retire) instret_counter <= instret_counter + 1;
+        for (int n = 0; n < HPM_COUNT; n++) begin
+            if (~mcountinhibit_reg[3 + n] && perf_event[n]) hpm_counter[n] <= hpm_counter[n] + 1;
+        end
+
         // Handle Operation Interface Writes
         if (op_valid && op_busy) begin
             // Let the write settle
@@ -438,11 +524,14 @@ always_ff @(posedge clk or posedge reset) begin
                         `CSR_MSCRATCH: mscratch_reg <= op_operand;
                         `CSR_MCYCLE  : cycle_counter[XLEN-1:0] <= op_operand;
                         `CSR_MCYCLEH : cycle_counter[(XLEN*2)-1:XLEN] <= op_operand;
+                        `CSR_MINSTRET: instret_counter[XLEN-1:0] <= op_operand;
+                        `CSR_MINSTRETH: instret_counter[(XLEN*2)-1:XLEN] <= op_operand;
+                        `CSR_MCOUNTINHIBIT: mcountinhibit_reg <= (op_operand & MCOUNTINHIBIT_WRITE_MASK);
                         default      : ; // No action for other addresses
                     endcase
                 end
                 `CSR_RS: begin // Atomic Read and Set CSR
-                    if (op_control != 0) begin
+                    if (op_operand != 0) begin
                         `ifdef LOG_CSR $display("[CSR Module]        Time %0t: Operation Interface: CSR_RS: %00h, %00h", $time, op_addr, op_operand); `endif
                         case (op_addr)
                             `CSR_MSTATUS : mstatus_reg  <= (mstatus_reg | (op_operand & MSTATUS_WRITE_MASK)) | (mstatus_reg & ~MSTATUS_WRITE_MASK);
@@ -454,12 +543,15 @@ always_ff @(posedge clk or posedge reset) begin
                             `CSR_MSCRATCH: mscratch_reg <= mscratch_reg | op_operand;
                             `CSR_MCYCLE  : cycle_counter[XLEN-1:0] <= cycle_counter[XLEN-1:0] | op_operand;
                             `CSR_MCYCLEH : cycle_counter[(XLEN*2)-1:XLEN] <= cycle_counter[(XLEN*2)-1:XLEN] | op_operand;
+                            `CSR_MINSTRET: instret_counter[XLEN-1:0] <= instret_counter[XLEN-1:0] | op_operand;
+                            `CSR_MINSTRETH: instret_counter[(XLEN*2)-1:XLEN] <= instret_counter[(XLEN*2)-1:XLEN] | op_operand;
+                            `CSR_MCOUNTINHIBIT: mcountinhibit_reg <= mcountinhibit_reg | (op_operand & MCOUNTINHIBIT_WRITE_MASK);
                             default      : ; // No action for other addresses
                         endcase
                     end
                 end
                 `CSR_RC: begin // Atomic Read and Clear CSR
-                    if (op_control != 0) begin
+                    if (op_operand != 0) begin
                         case (op_addr)
                             `CSR_MSTATUS : mstatus_reg  <= (mstatus_reg & ~op_operand) | (mstatus_reg & ~MSTATUS_WRITE_MASK);
                             `CSR_MIE     : mie_reg      <= mie_reg & ~op_operand;
@@ -470,6 +562,9 @@ always_ff @(posedge clk or posedge reset) begin
                             `CSR_MSCRATCH: mscratch_reg <= mscratch_reg & ~op_operand;
                             `CSR_MCYCLE  : cycle_counter[XLEN-1:0] <= cycle_counter[XLEN-1:0] & ~op_operand;
                             `CSR_MCYCLEH : cycle_counter[(XLEN*2)-1:XLEN] <= cycle_counter[(XLEN*2)-1:XLEN] & ~op_operand;
+                            `CSR_MINSTRET: instret_counter[XLEN-1:0] <= instret_counter[XLEN-1:0] & ~op_operand;
+                            `CSR_MINSTRETH: instret_counter[(XLEN*2)-1:XLEN] <= instret_counter[(XLEN*2)-1:XLEN] & ~op_operand;
+                            `CSR_MCOUNTINHIBIT: mcountinhibit_reg <= mcountinhibit_reg & ~op_operand;
                             default      : ; // No action for other addresses
                         endcase
                     end
@@ -487,6 +582,9 @@ always_ff @(posedge clk or posedge reset) begin
                         `CSR_MSCRATCH: mscratch_reg <= imm_extended;
                         `CSR_MCYCLE  : cycle_counter[XLEN-1:0] <= imm_extended;
                         `CSR_MCYCLEH : cycle_counter[(XLEN*2)-1:XLEN] <= imm_extended;
+                        `CSR_MINSTRET: instret_counter[XLEN-1:0] <= imm_extended;
+                        `CSR_MINSTRETH: instret_counter[(XLEN*2)-1:XLEN] <= imm_extended;
+                        `CSR_MCOUNTINHIBIT: mcountinhibit_reg <= (imm_extended & MCOUNTINHIBIT_WRITE_MASK);
                         default      : ; // No action for other addresses
                     endcase
                 end
@@ -504,6 +602,9 @@ always_ff @(posedge clk or posedge reset) begin
                             `CSR_MSCRATCH: mscratch_reg <= mscratch_reg | imm_extended;
                             `CSR_MCYCLE  : cycle_counter[XLEN-1:0] <= cycle_counter[XLEN-1:0] | imm_extended;
                             `CSR_MCYCLEH : cycle_counter[(XLEN*2)-1:XLEN] <= cycle_counter[(XLEN*2)-1:XLEN] | imm_extended;
+                            `CSR_MINSTRET: instret_counter[XLEN-1:0] <= instret_counter[XLEN-1:0] | imm_extended;
+                            `CSR_MINSTRETH: instret_counter[(XLEN*2)-1:XLEN] <= instret_counter[(XLEN*2)-1:XLEN] | imm_extended;
+                            `CSR_MCOUNTINHIBIT: mcountinhibit_reg <= mcountinhibit_reg | (imm_extended & MCOUNTINHIBIT_WRITE_MASK);
                             default      : ; // No action for other addresses
                         endcase
                     end
@@ -522,12 +623,23 @@ always_ff @(posedge clk or posedge reset) begin
                             `CSR_MSCRATCH: mscratch_reg <= mscratch_reg & ~imm_extended;
                             `CSR_MCYCLE  : cycle_counter[XLEN-1:0] <= cycle_counter[XLEN-1:0] & ~imm_extended;
                             `CSR_MCYCLEH : cycle_counter[(XLEN*2)-1:XLEN] <= cycle_counter[(XLEN*2)-1:XLEN] & ~imm_extended;
+                            `CSR_MINSTRET: instret_counter[XLEN-1:0] <= instret_counter[XLEN-1:0] & ~imm_extended;
+                            `CSR_MINSTRETH: instret_counter[(XLEN*2)-1:XLEN] <= instret_counter[(XLEN*2)-1:XLEN] & ~imm_extended;
+                            `CSR_MCOUNTINHIBIT: mcountinhibit_reg <= mcountinhibit_reg & ~imm_extended;
                             default      : ; // No action for other addresses
                         endcase
                     end
                 end
                 default: ; // No CSR operation
             endcase
+
+            // mhpmcounters, one case per counter would not scale with HPM_COUNT. A csrr does not
+            // write, so the counter keeps its increment
+            if (op_writes && op_addr >= `CSR_MHPMCOUNTER3H && op_addr < `CSR_MHPMCOUNTER3H + HPM_COUNT) begin
+                hpm_counter[op_addr - `CSR_MHPMCOUNTER3H][(XLEN*2)-1:XLEN] <= counter_op_result(hpm_op_rdata);
+            end else if (op_writes && op_addr >= `CSR_MHPMCOUNTER3 && op_addr < `CSR_MHPMCOUNTER3 + HPM_COUNT) begin
+                hpm_counter[op_addr - `CSR_MHPMCOUNTER3][XLEN-1:0] <= counter_op_result(hpm_op_rdata);
+            end
         end
         
         if (!reg_write_en && !op_valid) begin
@@ -0,0 +1,490 @@
+`ifndef __CPU_DCACHE__
+`define __CPU_DCACHE__
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// cpu_dcache Module
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @module cpu_dcache
+ * @brief Write-through data cache with a posted store buffer.
+ *
+ * The `cpu_dcache` module sits on the CPU side of `tl_interface` (behind `cpu_icache` when
+ * both are present) and speaks the same ready/ack/valid handshake on both of its ports.
+ * Loads and stores are handled locally, instruction fetches (`cpu_fetch` high) are passed
+ * through. The CPU side and the bus side run independently, so stores can be posted and
+ * loads can hit while an older store is still being written.
+ *
+ * Operation:
+ * - Stores: Every store is posted into the store buffer and acknowledged without waiting
+ *   for the bus. If the line is cached the store bytes are merged into it (write-through,
+ *   no write allocate). The buffer drains in order whenever the bus is not needed.
+ * - Cached loads: A hit is answered from the local memory. A miss is answered from the store
+ *   buffer when the youngest buffered store that touches the loaded bytes covers all of them
+ *   (load-after-store forwarding); otherwise the buffer is drained and the line refilled.
+ * - Uncached loads: The store buffer is drained first, so device registers observe stores in
+ *   program order, then the load is passed through to `tl_interface`.
+ * - Fetches pass the buffered stores unless the buffer is full. `fence` waits for the buffer
+ *   to drain before the next fetch, so `fence`/`fence.i` make earlier stores visible to the
+ *   instruction stream. `drained` reports an empty buffer with the bus idle.
+ *
+ * Address Map:
+ * - Addresses with `(address & ~CACHED_MASK) == CACHED_BASE` are cacheable, everything else
+ *   (UART, output and other peripheral windows) is uncached.
+ *
+ * Parameters:
+ * - `SIZE`: Cache size in bytes (power of two, at least two lines).
+ * - `LINE`: Line size in bytes (power of two, at least two XLEN words).
+ * - `SB_DEPTH`: Store buffer entries (power of two, at least 2).
+ *
+ * Counters:
+ * - `hit_count` and `miss_count` count cached loads served locally and cached loads that
+ *   needed the bus.
+ *
+ * @note Posted stores have no one to report an error to; a `denied` or `corrupt` response to
+ *       a buffered store is dropped.
+ */
+
+`timescale 1ns / 1ps
+`default_nettype none
+
+`include "log.sv"
+
+module cpu_dcache #(
+    parameter XLEN        = 32,
+    parameter SIZE        = 1024,          // Cache size in bytes
+    parameter LINE        = 16,            // Line size in bytes
+    parameter SB_DEPTH    = 4,             // Store buffer entries
+    parameter CACHED_BASE = 32'h0000_0000, // Base of the cacheable window
+    parameter CACHED_MASK = 32'h0000_FFFF  // Address bits inside the cacheable window
+) (
+    input  wire                 clk,
+    input  wire                 reset,
+
+    // CPU Side
+    input  wire                 cpu_ready,
+    input  wire                 cpu_fetch,      // Request is an instruction fetch (or I-cache refill)
+    input  wire [XLEN-1:0]      cpu_address,
+    input  wire [XLEN-1:0]      cpu_wdata,
+    input  wire [XLEN/8-1:0]    cpu_wstrb,
+    input  wire [2:0]           cpu_size,
+    input  wire                 cpu_read,
+    output wire                 cpu_ack,
+    output wire [XLEN-1:0]      cpu_rdata,
+    output wire                 cpu_denied,
+    output wire                 cpu_corrupt,
+    output wire                 cpu_valid,
+
+    // tl_interface Side
+    output wire                 if_ready,
+    output wire [XLEN-1:0]      if_address,
+    output wire [XLEN-1:0]      if_wdata,
+    output wire [XLEN/8-1:0]    if_wstrb,
+    output wire [2:0]           if_size,
+    output wire                 if_read,
+    input  wire                 if_ack,
+    input  wire [XLEN-1:0]      if_rdata,
+    input  wire                 if_denied,
+    input  wire                 if_corrupt,
+    input  wire                 if_valid,
+
+    // Control
+    input  wire                 fence,          // Drain the store buffer before the next fetch
+    output wire                 drained,        // Store buffer empty and no bus transaction
+
+    // Counters
+    output reg  [XLEN-1:0]      hit_count,
+    output reg  [XLEN-1:0]      miss_count
+);
+
+localparam BYTES       = XLEN / 8;
+localparam WORD_BITS   = $clog2(BYTES);
+localparam WORDS       = SIZE / BYTES;
+localparam LINES       = SIZE / LINE;
+localparam LINE_WORDS  = LINE / BYTES;
+localparam SIZE_BITS   = $clog2(SIZE);
+localparam OFFSET_BITS = $clog2(LINE);
+localparam BEAT_BITS   = OFFSET_BITS - WORD_BITS;
+localparam TAG_BITS    = XLEN - SIZE_BITS;
+localparam SB_BITS     = $clog2(SB_DEPTH);
+
+localparam [XLEN-1:0] BASE = CACHED_BASE;
+localparam [XLEN-1:0] MASK = CACHED_MASK;
+
+// ──────────────────────────
+// Cache States
+// ──────────────────────────
+typedef enum logic [2:0] {
+    DC_IDLE,         // Waiting for a request
+    DC_LOOKUP,       // Return a load hit
+    DC_ACK,          // Complete a buffered store or a forwarded load
+    DC_MISS,         // Wait for the line refill
+    DC_PASS          // Fetch or uncached load passed through to tl_interface
+} dcache_state_t;
+dcache_state_t state;
+
+typedef enum logic [2:0] {
+    BUS_IDLE,        // Bus free, drains the store buffer
+    BUS_DRAIN_WAIT,  // Wait for the oldest buffered store to complete
+    BUS_REFILL,      // Request the next word of the line
+    BUS_REFILL_WAIT, // Wait for the word from tl_interface
+    BUS_PASS         // Pass-through request in flight
+} dcache_bus_state_t;
+dcache_bus_state_t bus_state;
+
+// ──────────────────────────
+// Helpers
+// ──────────────────────────
+function automatic [BYTES-1:0] lane_mask(input [2:0] size, input [WORD_BITS-1:0] offset);
+    case (size)
+        3'b000:  lane_mask = {{(BYTES-1){1'b0}}, 1'b1} << offset;
+        3'b001:  lane_mask = {{(BYTES-2){1'b0}}, 2'b11} << offset;
+        3'b010:  lane_mask = {{(BYTES-4){1'b0}}, 4'b1111} << offset;
+        default: lane_mask = {BYTES{1'b1}};
+    endcase
+endfunction
+
+function automatic [XLEN-1:0] size_mask(input [2:0] size);
+    case (size)
+        3'b000:  size_mask = {{(XLEN-8){1'b0}}, 8'hFF};
+        3'b001:  size_mask = {{(XLEN-16){1'b0}}, 16'hFFFF};
+        3'b010:  size_mask = {{(XLEN-32){1'b0}}, 32'hFFFF_FFFF};
+        default: size_mask = {XLEN{1'b1}};
+    endcase
+endfunction
+
+// ──────────────────────────
+// Cache Storage
+// ──────────────────────────
+logic [XLEN-1:0]     data_mem [0:WORDS-1];
+logic [TAG_BITS-1:0] tag_mem  [0:LINES-1];
+logic [LINES-1:0]    line_valid;
+
+// ──────────────────────────
+// Store Buffer
+// ──────────────────────────
+logic [XLEN-1:0]    sb_address [0:SB_DEPTH-1];
+logic [XLEN-1:0]    sb_wdata   [0:SB_DEPTH-1]; // Right justified, as sent to tl_interface
+logic [2:0]         sb_size    [0:SB_DEPTH-1];
+logic [BYTES-1:0]   sb_lanes   [0:SB_DEPTH-1];
+logic [SB_BITS-1:0] sb_head;
+logic [SB_BITS-1:0] sb_tail;
+logic [SB_BITS:0]   sb_count;
+logic               sb_empty;
+logic               sb_full;
+
+assign sb_empty = (sb_count == 0);
+assign sb_full  = (sb_count == SB_DEPTH);
+assign drained  = sb_empty && (bus_state == BUS_IDLE);
+
+// ──────────────────────────
+// Request Decode
+// ──────────────────────────
+logic                 req_cached;
+logic [BYTES-1:0]     req_lanes;
+logic [XLEN-1:0]      req_wdata_lanes;
+logic                 tag_hit;
+logic                 fence_pending;
+
+assign req_cached      = ((cpu_address & ~MASK) == BASE);
+assign req_lanes       = lane_mask(cpu_size, cpu_address[WORD_BITS-1:0]);
+assign req_wdata_lanes = cpu_wdata << (8 * cpu_address[WORD_BITS-1:0]);
+assign tag_hit         = line_valid[cpu_address[SIZE_BITS-1:OFFSET_BITS]] &&
+                         (tag_mem[cpu_address[SIZE_BITS-1:OFFSET_BITS]] == cpu_address[XLEN-1:SIZE_BITS]);
+
+// Youngest buffered store touching the requested bytes
+logic               fwd_overlap;
+logic               fwd_cover;
+logic [XLEN-1:0]    fwd_word;
+logic [SB_BITS-1:0] fwd_idx;
+
+always_comb begin
+    fwd_idx     = sb_head;
+    fwd_overlap = 1'b0;
+    fwd_cover   = 1'b0;
+    fwd_word    = {XLEN{1'b0}};
+    for (int i = 0; i < SB_DEPTH; i++) begin
+        fwd_idx = sb_head + i;
+        if (i < sb_count &&
+            sb_address[fwd_idx][XLEN-1:WORD_BITS] == cpu_address[XLEN-1:WORD_BITS] &&
+            (sb_lanes[fwd_idx] & req_lanes) != {BYTES{1'b0}}) begin
+            fwd_overlap = 1'b1;
+            fwd_cover   = ((sb_lanes[fwd_idx] & req_lanes) == req_lanes);
+            fwd_word    = sb_wdata[fwd_idx] << (8 * sb_address[fwd_idx][WORD_BITS-1:0]);
+        end
+    end
+end
+
+// ──────────────────────────
+// Internal Registers
+// ──────────────────────────
+logic [XLEN-1:0]      req_address;
+logic [2:0]           req_size;
+logic [XLEN-1:0]      rd_word;
+logic [BEAT_BITS-1:0] beat;
+logic [XLEN-1:0]      load_word;
+logic                 refill_done;
+logic                 refill_denied;
+logic                 refill_corrupt;
+
+logic                 ack_reg;
+logic                 valid_reg;
+logic [XLEN-1:0]      rdata_reg;
+logic                 denied_reg;
+logic                 corrupt_reg;
+
+logic                 bus_ready;
+logic [XLEN-1:0]      bus_address;
+logic [XLEN-1:0]      bus_wdata;
+logic [XLEN/8-1:0]    bus_wstrb;
+logic [2:0]           bus_size;
+logic                 bus_read;
+
+// ──────────────────────────
+// Pass-through Routing
+// ──────────────────────────
+// Fetches and uncached loads go straight to tl_interface once the bus is free and no
+// buffered store has to go first. The route is selected combinationally in the first cycle
+// so it adds no latency.
+logic pass_now;
+logic pass;
+assign pass_now = (state == DC_IDLE) && (bus_state == BUS_IDLE) && cpu_ready &&
+                  ((cpu_fetch && ~sb_full && (~fence_pending || sb_empty)) ||
+                   (~cpu_fetch && cpu_read && ~req_cached && sb_empty));
+assign pass     = (bus_state == BUS_PASS) || pass_now;
+
+assign if_ready    = pass ? cpu_ready   : bus_ready;
+assign if_address  = pass ? cpu_address : bus_address;
+assign if_wdata    = pass ? cpu_wdata   : bus_wdata;
+assign if_wstrb    = pass ? cpu_wstrb   : bus_wstrb;
+assign if_size     = pass ? cpu_size    : bus_size;
+assign if_read     = pass ? cpu_read    : bus_read;
+
+assign cpu_ack     = pass ? if_ack      : ack_reg;
+assign cpu_valid   = pass ? if_valid    : valid_reg;
+assign cpu_rdata   = pass ? if_rdata    : rdata_reg;
+assign cpu_denied  = pass ? if_denied   : denied_reg;
+assign cpu_corrupt = pass ? if_corrupt  : corrupt_reg;
+
+// ──────────────────────────
+// Store Buffer Push/Pop
+// ──────────────────────────
+logic sb_push;
+logic sb_pop;
+assign sb_push = (state == DC_IDLE) && ~pass_now && cpu_ready && ~cpu_fetch && ~cpu_read && ~sb_full;
+assign sb_pop  = (bus_state == BUS_DRAIN_WAIT) && ~(bus_ready && if_ack) && if_valid;
+
+// ──────────────────────────
+// Cache Logic
+// ──────────────────────────
+always_ff @(posedge clk) begin
+    if (reset) begin
+        state          <= DC_IDLE;
+        bus_state      <= BUS_IDLE;
+        line_valid     <= {LINES{1'b0}};
+        sb_head        <= {SB_BITS{1'b0}};
+        sb_tail        <= {SB_BITS{1'b0}};
+        sb_count       <= {(SB_BITS+1){1'b0}};
+        fence_pending  <= 1'b0;
+        req_address    <= {XLEN{1'b0}};
+        req_size       <= 3'b000;
+        beat           <= {BEAT_BITS{1'b0}};
+        refill_done    <= 1'b0;
+        refill_denied  <= 1'b0;
+        refill_corrupt <= 1'b0;
+        ack_reg        <= 1'b0;
+        valid_reg      <= 1'b0;
+        rdata_reg      <= {XLEN{1'b0}};
+        denied_reg     <= 1'b0;
+        corrupt_reg    <= 1'b0;
+        bus_ready      <= 1'b0;
+        bus_address    <= {XLEN{1'b0}};
+        bus_wdata      <= {XLEN{1'b0}};
+        bus_wstrb      <= {(XLEN/8){1'b0}};
+        bus_size       <= 3'b000;
+        bus_read       <= 1'b1;
+        hit_count      <= {XLEN{1'b0}};
+        miss_count     <= {XLEN{1'b0}};
+    end else begin
+        ack_reg     <= 1'b0;
+        valid_reg   <= 1'b0;
+        refill_done <= 1'b0;
+        sb_count    <= sb_count + sb_push - sb_pop;
+
+        if (fence) begin
+            fence_pending <= 1'b1;
+        end else if (sb_empty) begin
+            fence_pending <= 1'b0;
+        end
+
+        // ──────────────────────────
+        // CPU side
+        // ──────────────────────────
+        case (state)
+            DC_IDLE: begin
+                denied_reg  <= 1'b0;
+                corrupt_reg <= 1'b0;
+                if (pass_now) begin
+                    state <= DC_PASS;
+                end else if (sb_push) begin
+                    // Post the store, merge it into the line when cached
+                    sb_address[sb_tail] <= cpu_address;
+                    sb_wdata[sb_tail]   <= cpu_wdata;
+                    sb_size[sb_tail]    <= cpu_size;
+                    sb_lanes[sb_tail]   <= req_lanes;
+                    sb_tail             <= sb_tail + 1;
+                    if (req_cached && tag_hit) begin
+                        for (int b = 0; b < BYTES; b++) begin
+                            if (req_lanes[b]) begin
+                                data_mem[cpu_address[SIZE_BITS-1:WORD_BITS]][8*b +: 8] <= req_wdata_lanes[8*b +: 8];
+                            end
+                        end
+                    end
+                    `ifdef LOG_DCACHE `LOG("cpu_dcache", ("Store buffered address=0x%0h data=0x%0h", cpu_address, cpu_wdata)); `endif
+                    ack_reg   <= 1'b1;
+                    rdata_reg <= {XLEN{1'b0}};
+                    state     <= DC_ACK;
+                end else if (cpu_ready && ~cpu_fetch && cpu_read && req_cached) begin
+                    ack_reg     <= 1'b1;
+                    req_address <= cpu_address;
+                    req_size    <= cpu_size;
+                    if (tag_hit) begin
+                        // Load hit, stores to cached lines are already merged
+                        rd_word   <= data_mem[cpu_address[SIZE_BITS-1:WORD_BITS]];
+                        hit_count <= hit_count + 1;
+                        state     <= DC_LOOKUP;
+                    end else if (fwd_overlap && fwd_cover) begin
+                        // Load miss answered from the store buffer
+                        `ifdef LOG_DCACHE `LOG("cpu_dcache", ("Load forwarded address=0x%0h", cpu_address)); `endif
+                        rdata_reg <= (fwd_word >> (8 * cpu_address[WORD_BITS-1:0])) & size_mask(cpu_size);
+                        hit_count <= hit_count + 1;
+                        state     <= DC_ACK;
+                    end else begin
+                        // Load miss, refill the line once the store buffer is empty
+                        `ifdef LOG_DCACHE `LOG("cpu_dcache", ("Load miss address=0x%0h", cpu_address)); `endif
+                        miss_count <= miss_count + 1;
+                        state      <= DC_MISS;
+                    end
+                end
+            end
+
+            DC_LOOKUP: begin
+                valid_reg <= 1'b1;
+                rdata_reg <= (rd_word >> (8 * req_address[WORD_BITS-1:0])) & size_mask(req_size);
+                state     <= DC_IDLE;
+            end
+
+            DC_ACK: begin
+                valid_reg <= 1'b1;
+                state     <= DC_IDLE;
+            end
+
+            DC_MISS: begin
+                if (refill_done) begin
+                    valid_reg   <= 1'b1;
+                    rdata_reg   <= (load_word >> (8 * req_address[WORD_BITS-1:0])) & size_mask(req_size);
+                    denied_reg  <= refill_denied;
+                    corrupt_reg <= refill_corrupt;
+                    state       <= DC_IDLE;
+                end
+            end
+
+            DC_PASS: begin
+                if (if_valid) begin
+                    state <= DC_IDLE;
+                end
+            end
+
+            default: state <= DC_IDLE;
+        endcase
+
+        // ──────────────────────────
+        // Bus side: pass-through, store buffer drain and line refill
+        // ──────────────────────────
+        case (bus_state)
+            BUS_IDLE: begin
+                if (pass_now) begin
+                    bus_state <= BUS_PASS;
+                end else if (~sb_empty && ~if_valid) begin
+                    bus_ready   <= 1'b1;
+                    bus_address <= sb_address[sb_head];
+                    bus_wdata   <= sb_wdata[sb_head];
+                    bus_wstrb   <= sb_lanes[sb_head];
+                    bus_size    <= sb_size[sb_head];
+                    bus_read    <= 1'b0;
+                    bus_state   <= BUS_DRAIN_WAIT;
+                end else if (state == DC_MISS && sb_empty && ~refill_done) begin
+                    // The line is overwritten word by word, drop it until the refill completes
+                    line_valid[req_address[SIZE_BITS-1:OFFSET_BITS]] <= 1'b0;
+                    beat           <= {BEAT_BITS{1'b0}};
+                    refill_denied  <= 1'b0;
+                    refill_corrupt <= 1'b0;
+                    bus_state      <= BUS_REFILL;
+                end
+            end
+
+            BUS_DRAIN_WAIT: begin
+                if (bus_ready && if_ack) begin
+                    bus_ready <= 1'b0; // Deassert after acknowledgment
+                end else if (if_valid) begin
+                    `ifdef LOG_DCACHE
+                    if (if_denied || if_corrupt) `WARN("cpu_dcache", ("Buffered store failed address=0x%0h", bus_address));
+                    `endif
+                    sb_head   <= sb_head + 1;
+                    bus_read  <= 1'b1;
+                    bus_state <= BUS_IDLE;
+                end
+            end
+
+            BUS_REFILL: begin
+                if (~if_valid && ~bus_ready) begin
+                    bus_ready   <= 1'b1;
+                    bus_address <= {req_address[XLEN-1:OFFSET_BITS], beat, {WORD_BITS{1'b0}}};
+                    bus_wdata   <= {XLEN{1'b0}};
+                    bus_wstrb   <= {(XLEN/8){1'b0}};
+                    bus_size    <= (XLEN == 64) ? 3'b011 : 3'b010;
+                    bus_read    <= 1'b1;
+                    bus_state   <= BUS_REFILL_WAIT;
+                end
+            end
+
+            BUS_REFILL_WAIT: begin
+                if (bus_ready && if_ack) begin
+                    bus_ready <= 1'b0; // Deassert after acknowledgment
+                end else if (if_valid) begin
+                    data_mem[{req_address[SIZE_BITS-1:OFFSET_BITS], beat}] <= if_rdata;
+                    if (beat == req_address[OFFSET_BITS-1:WORD_BITS]) begin
+                        load_word <= if_rdata;
+                    end
+
+                    if (if_denied || if_corrupt) begin
+                        `ifdef LOG_DCACHE `WARN("cpu_dcache", ("Refill failed address=0x%0h", bus_address)); `endif
+                        refill_denied  <= if_denied;
+                        refill_corrupt <= if_corrupt;
+                        load_word      <= if_rdata;
+                        refill_done    <= 1'b1;
+                        bus_state      <= BUS_IDLE;
+                    end else if (beat == LINE_WORDS - 1) begin
+                        tag_mem[req_address[SIZE_BITS-1:OFFSET_BITS]]    <= req_address[XLEN-1:SIZE_BITS];
+                        line_valid[req_address[SIZE_BITS-1:OFFSET_BITS]] <= 1'b1;
+                        refill_done    <= 1'b1;
+                        bus_state      <= BUS_IDLE;
+                    end else begin
+                        beat           <= beat + 1;
+                        bus_state      <= BUS_REFILL;
+                    end
+                end
+            end
+
+            BUS_PASS: begin
+                if (if_valid) begin
+                    bus_state <= BUS_IDLE;
+                end
+            end
+
+            default: bus_state <= BUS_IDLE;
+        endcase
+    end
+end
+
+endmodule
+
+`endif // __CPU_DCACHE__
@@ -0,0 +1,312 @@
+`ifndef __CPU_EXU__
+`define __CPU_EXU__
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EXU Module
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @module cpu_exu
+ * @brief Executes ALU and bit manipulation operations on shared data paths.
+ *
+ * The EXU (Execute Unit) takes the place of `cpu_alu` and `cpu_bmu` side by side. It decodes
+ * the `cpu_alu` control codes and, with `bmu_select` set, the `cpu_bmu` control codes of the
+ * Zba, Zbb and Zbs operations, and builds every result from one adder, one barrel shifter and
+ * one counting tree. The operations are all combinational logic, one cycle like `cpu_alu`.
+ *
+ * ## Features
+ * - **ALU Operations**: Every `cpu_alu` operation, with the same flags.
+ * - **Zba**: `sh1add`, `sh2add`, `sh3add`, `add.uw`, `shNadd.uw` and `slli.uw` on the adder and
+ *            the shifter.
+ * - **Zbb**: `andn`, `orn`, `xnor`, `clz`, `ctz`, `cpop`, `min[u]`, `max[u]`, `sext.b`,
+ *            `sext.h`, `zext.h`, `rol`, `ror`, `orc.b` and `rev8` (as `grevi`).
+ * - **Zbs**: `bset`, `bclr`, `binv` and `bext`, the single bit mask comes from the shifter.
+ * - **Shared Shifter**: A right funnel shifter. Rotates fill from the value, arithmetic shifts
+ *                       from its sign, and left shifts reverse the bits in and out.
+ * - **Counting Tree**: `clz` normalizes in $clog2(XLEN) steps, `ctz` is `clz` of the reversed
+ *                      value, and `cpop` sums the bits in a balanced adder tree.
+ *
+ * ## Parameters
+ * - `XLEN`: Configurable data width of the operands (default is 32 bits).
+ *
+ * ## Interface
+ * - Inputs:
+ *   - `operand_a`: First operand (XLEN bits).
+ *   - `operand_b`: Second operand, or the shift amount / bit index (XLEN bits).
+ *   - `alu_control`: `ALU_*` operation selector (4 bits).
+ *   - `bmu_control`: `BMU_*` operation selector (6 bits).
+ *   - `bmu_select`: Executes `bmu_control` instead of `alu_control`.
+ * - Outputs:
+ *   - `result`: Result of the selected operation (XLEN bits).
+ *   - `zero`: Flag indicating if the result is zero (1 bit).
+ *   - `less_than`: Flag for signed less-than comparison (1 bit).
+ *   - `unsigned_less_than`: Flag for unsigned less-than comparison (1 bit).
+ *
+ * Developers should be aware that:
+ * - The Zbc, Zbkx and draft `cpu_bmu` operations (`clmul*`, `xperm*`, `shfl`, `unshfl`, ...)
+ *   are not implemented and return zero, the core treats them as illegal with this unit.
+ * - `bext` is the Zbs single bit extract, `grev` is the generalized reverse of which `rev8` and
+ *   `brev8` are special cases.
+ **/
+
+`timescale 1ns / 1ps
+`default_nettype none
+
+`include "cpu_alu.sv"
+`include "cpu_bmu.sv"
+
+module cpu_exu #(
+    parameter XLEN = 32
+) (
+    input  wire [XLEN-1:0] operand_a,
+    input  wire [XLEN-1:0] operand_b,
+    input  wire [3:0]      alu_control,
+    input  wire [5:0]      bmu_control,
+    input  wire            bmu_select,
+    output reg  [XLEN-1:0] result,
+    output wire            zero,
+    output wire            less_than,
+    output wire            unsigned_less_than
+);
+
+// ──────────────────────────
+// Shift Bits Calculation
+// ──────────────────────────
+localparam SHIFT_BITS = $clog2(XLEN); // 5 for XLEN=32, 6 for XLEN=64
+localparam CNT_W      = SHIFT_BITS + 1;
+
+localparam [XLEN-1:0]  WORD_MASK = 32'hFFFF_FFFF;
+localparam [XLEN-1:0]  HALF_MASK = 16'hFFFF;
+localparam [CNT_W-1:0] CNT_XLEN  = XLEN;
+
+// ──────────────────────────
+// Internal Signals for Signed Comparisons
+// ──────────────────────────
+logic signed [XLEN-1:0] operand_a_signed;
+assign operand_a_signed = operand_a;
+
+logic signed [XLEN-1:0] operand_b_signed;
+assign operand_b_signed = operand_b;
+
+assign less_than          = (operand_a_signed < operand_b_signed); // Signed Comparison
+assign unsigned_less_than = (operand_a < operand_b);               // Unsigned Comparison
+
+function automatic [XLEN-1:0] bit_reverse(input [XLEN-1:0] data);
+    integer i;
+    begin
+        for (i = 0; i < XLEN; i = i + 1) begin
+            bit_reverse[i] = data[XLEN-1-i];
+        end
+    end
+endfunction
+
+// ──────────────────────────
+// Data Path Control
+// ──────────────────────────
+logic                  add_sub;    // Subtract operand_b
+logic                  add_uw;     // Zero extend the low word of operand_a
+logic [1:0]            add_shift;  // Shift operand_a left by 0 to 3 before the add
+logic [XLEN-1:0]       sh_in;      // Value into the shifter
+logic                  sh_left;    // Reverse in and out for a left shift
+logic                  sh_rotate;  // Fill from the value instead of zeros
+logic                  sh_arith;   // Fill from the sign
+logic [SHIFT_BITS-1:0] sh_amt;
+logic                  cnt_trailing;
+
+always_comb begin
+    add_sub      = 1'b0;
+    add_uw       = 1'b0;
+    add_shift    = 2'd0;
+    sh_in        = operand_a;
+    sh_left      = 1'b0;
+    sh_rotate    = 1'b0;
+    sh_arith     = 1'b0;
+    sh_amt       = operand_b[SHIFT_BITS-1:0];
+    cnt_trailing = 1'b0;
+
+    if (bmu_select) begin
+        case (bmu_control)
+            `BMU_SH1ADD:    add_shift = 2'd1;
+            `BMU_SH2ADD:    add_shift = 2'd2;
+            `BMU_SH3ADD:    add_shift = 2'd3;
+            `BMU_ADD_UW:    add_uw    = 1'b1;
+            `BMU_SH1ADD_UW: begin add_uw = 1'b1; add_shift = 2'd1; end
+            `BMU_SH2ADD_UW: begin add_uw = 1'b1; add_shift = 2'd2; end
+            `BMU_SH3ADD_UW: begin add_uw = 1'b1; add_shift = 2'd3; end
+            `BMU_ROL: begin
+                // Rotating left by n is rotating right by XLEN - n
+                sh_rotate = 1'b1;
+                sh_amt    = {SHIFT_BITS{1'b0}} - operand_b[SHIFT_BITS-1:0];
+            end
+            `BMU_ROR:       sh_rotate = 1'b1;
+            `BMU_SLLIUW: begin
+                sh_in   = operand_a & WORD_MASK;
+                sh_left = 1'b1;
+            end
+            `BMU_BSET, `BMU_BCLR, `BMU_BINV: begin
+                sh_in   = {{(XLEN-1){1'b0}}, 1'b1};
+                sh_left = 1'b1;
+            end
+            `BMU_CTZ:       cnt_trailing = 1'b1;
+            default: begin end
+        endcase
+    end else begin
+        case (alu_control)
+            `ALU_SUB: add_sub  = 1'b1;
+            `ALU_SLL: sh_left  = 1'b1;
+            `ALU_SRA: sh_arith = 1'b1;
+            default: begin end
+        endcase
+    end
+end
+
+// ──────────────────────────
+// Adder
+// ──────────────────────────
+logic [XLEN-1:0] add_a;
+logic [XLEN-1:0] add_result;
+
+assign add_a      = (add_uw ? (operand_a & WORD_MASK) : operand_a) << add_shift;
+assign add_result = add_a + (operand_b ^ {XLEN{add_sub}}) + add_sub;
+
+// ──────────────────────────
+// Barrel Shifter
+// ──────────────────────────
+// {fill, value} shifted right, the low half is the result
+logic [XLEN-1:0]   sh_value;
+logic [XLEN-1:0]   sh_fill;
+logic [2*XLEN-1:0] sh_funnel;
+logic [XLEN-1:0]   sh_result;
+
+assign sh_value  = sh_left ? bit_reverse(sh_in) : sh_in;
+assign sh_fill   = sh_rotate ? sh_value : {XLEN{sh_arith & sh_value[XLEN-1]}};
+assign sh_funnel = {sh_fill, sh_value} >> sh_amt;
+assign sh_result = sh_left ? bit_reverse(sh_funnel[XLEN-1:0]) : sh_funnel[XLEN-1:0];
+
+// ──────────────────────────
+// Counting Tree
+// ──────────────────────────
+// clz: stage s shifts out the top 2^s bits when they are all zero, each stage is one count bit.
+// ctz counts the leading zeros of the reversed value.
+wire [XLEN-1:0]                cnt_in;
+wire [(SHIFT_BITS+1)*XLEN-1:0] clz_stage;
+wire [SHIFT_BITS-1:0]          clz_bits;
+wire [CNT_W-1:0]               clz_count;
+
+assign cnt_in = cnt_trailing ? bit_reverse(operand_a) : operand_a;
+assign clz_stage[SHIFT_BITS*XLEN +: XLEN] = cnt_in;
+
+genvar s;
+generate
+    for (s = 0; s < SHIFT_BITS; s = s + 1) begin : g_clz
+        assign clz_bits[s] = (clz_stage[(s+1)*XLEN + XLEN - (1 << s) +: (1 << s)] == 0);
+        assign clz_stage[s*XLEN +: XLEN] = clz_bits[s] ? (clz_stage[(s+1)*XLEN +: XLEN] << (1 << s)) :
+                                                         clz_stage[(s+1)*XLEN +: XLEN];
+    end
+endgenerate
+
+assign clz_count = (cnt_in == {XLEN{1'b0}}) ? CNT_XLEN : {1'b0, clz_bits};
+
+// cpop: level 0 holds one bit per field, each level adds pairs of fields of the one below
+wire [(SHIFT_BITS+1)*XLEN*CNT_W-1:0] cpop_tree;
+wire [CNT_W-1:0]                     cpop_count;
+
+genvar l, i;
+generate
+    for (i = 0; i < XLEN; i = i + 1) begin : g_cpop_leaf
+        assign cpop_tree[i*CNT_W +: CNT_W] = {{(CNT_W-1){1'b0}}, operand_a[i]};
+    end
+    for (l = 1; l <= SHIFT_BITS; l = l + 1) begin : g_cpop_level
+        for (i = 0; i < (XLEN >> l); i = i + 1) begin : g_cpop_node
+            assign cpop_tree[(l*XLEN + i)*CNT_W +: CNT_W] =
+                cpop_tree[((l-1)*XLEN + 2*i)*CNT_W +: CNT_W] +
+                cpop_tree[((l-1)*XLEN + 2*i + 1)*CNT_W +: CNT_W];
+        end
+    end
+endgenerate
+
+assign cpop_count = cpop_tree[SHIFT_BITS*XLEN*CNT_W +: CNT_W];
+
+// ──────────────────────────
+// Generalized Reverse
+// ──────────────────────────
+// Stage k swaps neighbouring 2^k bit blocks when operand_b[k] is set
+wire [(SHIFT_BITS+1)*XLEN-1:0] grev_stage;
+
+assign grev_stage[XLEN-1:0] = operand_a;
+
+genvar k, j;
+generate
+    for (k = 0; k < SHIFT_BITS; k = k + 1) begin : g_grev
+        for (j = 0; j < XLEN; j = j + 1) begin : g_grev_bit
+            assign grev_stage[(k+1)*XLEN + j] = operand_b[k] ? grev_stage[k*XLEN + (j ^ (1 << k))] :
+                                                               grev_stage[k*XLEN + j];
+        end
+    end
+endgenerate
+
+// ──────────────────────────
+// Result Select
+// ──────────────────────────
+always_comb begin
+    result = {XLEN{1'b0}};
+
+    if (bmu_select) begin
+        case (bmu_control)
+            `BMU_ANDN:      result = operand_a & ~operand_b;
+            `BMU_ORN:       result = operand_a | ~operand_b;
+            `BMU_XNOR:      result = ~(operand_a ^ operand_b);
+            `BMU_SH1ADD,
+            `BMU_SH2ADD,
+            `BMU_SH3ADD,
+            `BMU_ADD_UW,
+            `BMU_SH1ADD_UW,
+            `BMU_SH2ADD_UW,
+            `BMU_SH3ADD_UW: result = add_result;
+            `BMU_ROL,
+            `BMU_ROR,
+            `BMU_SLLIUW:    result = sh_result;
+            `BMU_BSET:      result = operand_a | sh_result;
+            `BMU_BCLR:      result = operand_a & ~sh_result;
+            `BMU_BINV:      result = operand_a ^ sh_result;
+            `BMU_BEXT:      result = {{(XLEN-1){1'b0}}, sh_result[0]};
+            `BMU_CLZ,
+            `BMU_CTZ:       result = {{(XLEN-CNT_W){1'b0}}, clz_count};
+            `BMU_CPOP:      result = {{(XLEN-CNT_W){1'b0}}, cpop_count};
+            `BMU_MAX:       result = less_than ? operand_b : operand_a;
+            `BMU_MAXU:      result = unsigned_less_than ? operand_b : operand_a;
+            `BMU_MIN:       result = less_than ? operand_a : operand_b;
+            `BMU_MINU:      result = unsigned_less_than ? operand_a : operand_b;
+            `BMU_SEXTB:     result = {{(XLEN-8){operand_a[7]}}, operand_a[7:0]};
+            `BMU_SEXTH:     result = {{(XLEN-16){operand_a[15]}}, operand_a[15:0]};
+            `BMU_ZEXTH32,
+            `BMU_ZEXTH64:   result = operand_a & HALF_MASK;
+            `BMU_GREV:      result = grev_stage[SHIFT_BITS*XLEN +: XLEN];
+            `BMU_ORCB: begin
+                for (integer b = 0; b < XLEN/8; b = b + 1) begin
+                    result[8*b +: 8] = {8{|operand_a[8*b +: 8]}};
+                end
+            end
+            default:        result = {XLEN{1'b0}};
+        endcase
+    end else begin
+        case (alu_control)
+            `ALU_ADD,
+            `ALU_SUB:  result = add_result;
+            `ALU_AND:  result = operand_a & operand_b;
+            `ALU_OR:   result = operand_a | operand_b;
+            `ALU_XOR:  result = operand_a ^ operand_b;
+            `ALU_SLL,
+            `ALU_SRL,
+            `ALU_SRA:  result = sh_result;
+            `ALU_SLT:  result = {{(XLEN-1){1'b0}}, less_than};
+            `ALU_SLTU: result = {{(XLEN-1){1'b0}}, unsigned_less_than};
+            default:   result = {XLEN{1'b0}};
+        endcase
+    end
+end
+
+// Zero Flag: High if result is zero
+assign zero = (result == {XLEN{1'b0}});
+
+endmodule
+
+`endif // __CPU_EXU__
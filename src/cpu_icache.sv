@@ -0,0 +1,275 @@
+`ifndef __CPU_ICACHE__
+`define __CPU_ICACHE__
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// cpu_icache Module
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @module cpu_icache
+ * @brief Direct-mapped instruction cache between the CPU and `tl_interface`.
+ *
+ * The `cpu_icache` module sits on the CPU side of `tl_interface` and speaks the same
+ * ready/ack/valid handshake on both of its ports, so it can be dropped in without changing
+ * the CPU's fetch logic. Instruction fetches (`cpu_fetch` high) are looked up in a local
+ * direct-mapped cache; everything else (loads and stores) is passed straight through to
+ * `tl_interface`. `if_fetch` marks refills so a `cpu_dcache` behind it can tell them apart
+ * from data accesses.
+ *
+ * Operation:
+ * - Hit:  The request is acknowledged, the line is read from the local memory and the
+ *         instruction is returned two cycles after the request, without a bus transaction.
+ * - Miss: The whole line is refilled from memory, one 32-bit Get per word, then the
+ *         instruction is returned. The line's old contents are invalid from the first beat
+ *         on, and a refill that returns `denied` or `corrupt` leaves the line invalid and
+ *         passes the error on to the CPU.
+ * - `invalidate` clears every line (used for `fence.i`). A refill in progress when the cache
+ *   is invalidated is discarded once it completes.
+ *
+ * Parameters:
+ * - `SIZE`: Cache size in bytes (power of two, at least two lines).
+ * - `LINE`: Line size in bytes (power of two, at least 8).
+ *
+ * Counters:
+ * - `hit_count` and `miss_count` count fetches served from the cache and fetches that required
+ *   a refill. They are reset by `reset` only.
+ */
+
+`timescale 1ns / 1ps
+`default_nettype none
+
+`include "log.sv"
+
+module cpu_icache #(
+    parameter XLEN = 32,
+    parameter SIZE = 1024,   // Cache size in bytes
+    parameter LINE = 16      // Line size in bytes
+) (
+    input  wire                 clk,
+    input  wire                 reset,
+
+    // CPU Side
+    input  wire                 cpu_ready,
+    input  wire                 cpu_fetch,      // Request is an instruction fetch
+    input  wire [XLEN-1:0]      cpu_address,
+    input  wire [XLEN-1:0]      cpu_wdata,
+    input  wire [XLEN/8-1:0]    cpu_wstrb,
+    input  wire [2:0]           cpu_size,
+    input  wire                 cpu_read,
+    output wire                 cpu_ack,
+    output wire [XLEN-1:0]      cpu_rdata,
+    output wire                 cpu_denied,
+    output wire                 cpu_corrupt,
+    output wire                 cpu_valid,
+
+    // tl_interface Side
+    output wire                 if_ready,
+    output wire                 if_fetch,       // Request is a fetch or a line refill
+    output wire [XLEN-1:0]      if_address,
+    output wire [XLEN-1:0]      if_wdata,
+    output wire [XLEN/8-1:0]    if_wstrb,
+    output wire [2:0]           if_size,
+    output wire                 if_read,
+    input  wire                 if_ack,
+    input  wire [XLEN-1:0]      if_rdata,
+    input  wire                 if_denied,
+    input  wire                 if_corrupt,
+    input  wire                 if_valid,
+
+    // Control
+    input  wire                 invalidate,     // Invalidate all lines
+
+    // Counters
+    output reg  [XLEN-1:0]      hit_count,
+    output reg  [XLEN-1:0]      miss_count
+);
+
+localparam WORDS       = SIZE / 4;
+localparam LINES       = SIZE / LINE;
+localparam LINE_WORDS  = LINE / 4;
+localparam SIZE_BITS   = $clog2(SIZE);
+localparam OFFSET_BITS = $clog2(LINE);
+localparam BEAT_BITS   = OFFSET_BITS - 2;
+localparam TAG_BITS    = XLEN - SIZE_BITS;
+
+// ──────────────────────────
+// Cache States
+// ──────────────────────────
+typedef enum logic [2:0] {
+    IC_IDLE,         // Waiting for a request
+    IC_LOOKUP,       // Compare the tag of the requested line
+    IC_REFILL,       // Request the next word of the line
+    IC_REFILL_WAIT,  // Wait for the word from tl_interface
+    IC_RESPOND,      // Return the instruction after a refill
+    IC_PASS          // Non-fetch request passed through to tl_interface
+} icache_state_t;
+icache_state_t state;
+
+// ──────────────────────────
+// Cache Storage
+// ──────────────────────────
+logic [31:0]         data_mem [0:WORDS-1];
+logic [TAG_BITS-1:0] tag_mem  [0:LINES-1];
+logic [LINES-1:0]    line_valid;
+
+// ──────────────────────────
+// Internal Registers
+// ──────────────────────────
+logic [XLEN-1:0]      req_address;
+logic [31:0]          rd_word;
+logic [TAG_BITS-1:0]  rd_tag;
+logic                 rd_valid;
+logic [BEAT_BITS-1:0] beat;
+logic [31:0]          fetch_word;
+logic                 refill_stale;
+
+logic                 ack_reg;
+logic                 valid_reg;
+logic [XLEN-1:0]      rdata_reg;
+logic                 denied_reg;
+logic                 corrupt_reg;
+
+logic                 refill_ready;
+logic [XLEN-1:0]      refill_address;
+
+// ──────────────────────────
+// Pass-through Routing
+// ──────────────────────────
+// Requests that are not instruction fetches go straight to tl_interface. The route is
+// selected combinationally in the first cycle so pass-through adds no latency.
+logic pass;
+assign pass = (state == IC_PASS) || (state == IC_IDLE && cpu_ready && ~cpu_fetch);
+
+assign if_ready    = pass ? cpu_ready   : refill_ready;
+assign if_fetch    = pass ? cpu_fetch   : 1'b1;
+assign if_address  = pass ? cpu_address : refill_address;
+assign if_wdata    = pass ? cpu_wdata   : {XLEN{1'b0}};
+assign if_wstrb    = pass ? cpu_wstrb   : {(XLEN/8){1'b0}};
+assign if_size     = pass ? cpu_size    : 3'b010; // Word size
+assign if_read     = pass ? cpu_read    : 1'b1;
+
+assign cpu_ack     = pass ? if_ack      : ack_reg;
+assign cpu_valid   = pass ? if_valid    : valid_reg;
+assign cpu_rdata   = pass ? if_rdata    : rdata_reg;
+assign cpu_denied  = pass ? if_denied   : denied_reg;
+assign cpu_corrupt = pass ? if_corrupt  : corrupt_reg;
+
+// ──────────────────────────
+// Cache Logic
+// ──────────────────────────
+always_ff @(posedge clk) begin
+    if (reset) begin
+        state          <= IC_IDLE;
+        line_valid     <= {LINES{1'b0}};
+        req_address    <= {XLEN{1'b0}};
+        beat           <= {BEAT_BITS{1'b0}};
+        refill_stale   <= 1'b0;
+        ack_reg        <= 1'b0;
+        valid_reg      <= 1'b0;
+        rdata_reg      <= {XLEN{1'b0}};
+        denied_reg     <= 1'b0;
+        corrupt_reg    <= 1'b0;
+        refill_ready   <= 1'b0;
+        refill_address <= {XLEN{1'b0}};
+        hit_count      <= {XLEN{1'b0}};
+        miss_count     <= {XLEN{1'b0}};
+    end else begin
+        valid_reg <= 1'b0;
+
+        case (state)
+            IC_IDLE: begin
+                denied_reg  <= 1'b0;
+                corrupt_reg <= 1'b0;
+                if (cpu_ready && cpu_fetch) begin
+                    // Read the line while the CPU sees the acknowledgment
+                    ack_reg     <= 1'b1;
+                    req_address <= cpu_address;
+                    rd_word     <= data_mem[cpu_address[SIZE_BITS-1:2]];
+                    rd_tag      <= tag_mem[cpu_address[SIZE_BITS-1:OFFSET_BITS]];
+                    rd_valid    <= line_valid[cpu_address[SIZE_BITS-1:OFFSET_BITS]];
+                    state       <= IC_LOOKUP;
+                end else if (cpu_ready) begin
+                    state       <= IC_PASS;
+                end
+            end
+
+            IC_LOOKUP: begin
+                ack_reg <= 1'b0;
+                if (rd_valid && ~invalidate && rd_tag == req_address[XLEN-1:SIZE_BITS]) begin
+                    `ifdef LOG_ICACHE `LOG("cpu_icache", ("Hit address=0x%0h instr=0x%08h", req_address, rd_word)); `endif
+                    valid_reg  <= 1'b1;
+                    rdata_reg  <= {{(XLEN-32){1'b0}}, rd_word};
+                    hit_count  <= hit_count + 1;
+                    state      <= IC_IDLE;
+                end else begin
+                    `ifdef LOG_ICACHE `LOG("cpu_icache", ("Miss address=0x%0h", req_address)); `endif
+                    miss_count   <= miss_count + 1;
+                    // The refill overwrites the set, drop the old line until the last beat
+                    line_valid[req_address[SIZE_BITS-1:OFFSET_BITS]] <= 1'b0;
+                    beat         <= {BEAT_BITS{1'b0}};
+                    refill_stale <= 1'b0;
+                    state        <= IC_REFILL;
+                end
+            end
+
+            IC_REFILL: begin
+                if (~if_valid && ~refill_ready) begin
+                    refill_ready   <= 1'b1;
+                    refill_address <= {req_address[XLEN-1:OFFSET_BITS], beat, 2'b00};
+                    state          <= IC_REFILL_WAIT;
+                end
+            end
+
+            IC_REFILL_WAIT: begin
+                if (refill_ready && if_ack) begin
+                    refill_ready <= 1'b0; // Deassert after acknowledgment
+                end else if (if_valid) begin
+                    data_mem[{req_address[SIZE_BITS-1:OFFSET_BITS], beat}] <= if_rdata[31:0];
+                    if (beat == req_address[OFFSET_BITS-1:2]) begin
+                        fetch_word <= if_rdata[31:0];
+                    end
+
+                    if (if_denied || if_corrupt) begin
+                        `ifdef LOG_ICACHE `WARN("cpu_icache", ("Refill failed address=0x%0h", refill_address)); `endif
+                        denied_reg  <= if_denied;
+                        corrupt_reg <= if_corrupt;
+                        fetch_word  <= if_rdata[31:0];
+                        state       <= IC_RESPOND;
+                    end else if (beat == LINE_WORDS - 1) begin
+                        tag_mem[req_address[SIZE_BITS-1:OFFSET_BITS]]    <= req_address[XLEN-1:SIZE_BITS];
+                        line_valid[req_address[SIZE_BITS-1:OFFSET_BITS]] <= ~refill_stale && ~invalidate;
+                        state       <= IC_RESPOND;
+                    end else begin
+                        beat        <= beat + 1;
+                        state       <= IC_REFILL;
+                    end
+                end
+            end
+
+            IC_RESPOND: begin
+                valid_reg <= 1'b1;
+                rdata_reg <= {{(XLEN-32){1'b0}}, fetch_word};
+                state     <= IC_IDLE;
+            end
+
+            IC_PASS: begin
+                if (if_valid) begin
+                    state <= IC_IDLE;
+                end
+            end
+
+            default: state <= IC_IDLE;
+        endcase
+
+        // Invalidate all lines, a refill in progress is dropped when it completes
+        if (invalidate) begin
+            `ifdef LOG_ICACHE `LOG("cpu_icache", ("Invalidate")); `endif
+            line_valid <= {LINES{1'b0}};
+            if (state == IC_REFILL || state == IC_REFILL_WAIT) begin
+                refill_stale <= 1'b1;
+            end
+        end
+    end
+end
+
+endmodule
+
+`endif // __CPU_ICACHE__
@@ -56,6 +56,9 @@ module cpu_insdecode #(
     `ifdef SUPPORT_M
     ,output wire            is_mul_div
     `endif
+    `ifdef SUPPORT_ZAAMO
+    ,output wire            is_amo
+    `endif
     `ifdef SUPPORT_F
     ,output wire            is_fpu
     `endif
@@ -126,6 +129,10 @@ assign is_mul_div = ((opcode == 7'b0110011) && (funct7 == 7'b0000001) ||
                         (opcode == 7'b0111011) && (funct7 == 7'b0000001));
 `endif
 
+`ifdef SUPPORT_ZAAMO
+assign is_amo     = (opcode == 7'b0101111);
+`endif
+
 `ifdef SUPPORT_F
 assign is_fpu     = (opcode == 7'b1010011);
 `endif
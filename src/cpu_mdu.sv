@@ -9,6 +9,24 @@
  *
  * The MDU module executes multiplication and division operations based on the
  * `control` signal. It is designed to support riscv m instructions.
+ *
+ * An operation starts on the rising edge of `start`; `start` may stay high until `ready`
+ * pulses, it is not sampled again until it has been low. `ready` is high for one cycle with
+ * the `result`.
+ *
+ * Implementations (`MDU_IMPL`):
+ * - `MDU_IMPL_SIMPLE`: Behavioural `*`, `/` and `%` with a fixed XLEN cycle latency.
+ * - `MDU_IMPL_FAST`:   A pipelined multiplier written for DSP inference (`MUL_STAGES`
+ *                      register stages, 1 to 3, for the Gowin GW2A MULT36X36 blocks) and an
+ *                      iterative radix-4 divider. The divider skips the leading zero bits of
+ *                      the dividend and returns at once when the divisor is zero or larger
+ *                      than the dividend, so its latency tracks the operand magnitude.
+ *
+ * Fusion:
+ * - The full product and both the quotient and the remainder are kept with the operands
+ *   they were computed from. A `mul` after `mulh[s][u]` (or any repeated product), and a
+ *   `rem` after `div` (or `div` after `rem`) of the same signedness on the same operands,
+ *   return the kept value in one cycle.
  */
 
 `timescale 1ns / 1ps
@@ -28,8 +46,16 @@
 `define MDU_REM    3'b110 // 6 Remainder of signed division
 `define MDU_REMU   3'b111 // 7 Remainder of unsigned division
 
+// ──────────────────────────
+// MDU Implementations
+// ──────────────────────────
+`define MDU_IMPL_SIMPLE 0 // Behavioural operators, fixed latency
+`define MDU_IMPL_FAST   1 // Pipelined DSP multiplier, radix-4 early terminating divider
+
 module cpu_mdu #(
-    parameter XLEN = 32
+    parameter XLEN       = 32,
+    parameter MDU_IMPL   = `MDU_IMPL_SIMPLE,
+    parameter MUL_STAGES = 2     // Multiplier register stages (MDU_IMPL_FAST)
 ) (
     input  wire              clk,
     input  wire              reset,
@@ -42,136 +68,311 @@ module cpu_mdu #(
     output reg               ready       // High when MDU completes
 );
 
+localparam CNT_BITS = $clog2(XLEN) + 1;
+
+// ──────────────────────────
+// Helpers
+// ──────────────────────────
+function automatic [CNT_BITS-1:0] clz(input [XLEN-1:0] value);
+    clz = XLEN;
+    for (int i = 0; i < XLEN; i++) begin
+        if (value[i]) clz = XLEN - 1 - i;
+    end
+endfunction
+
+// Quotient of a division by zero, as returned by the original MDU
+function automatic [XLEN-1:0] div_zero(input is_signed, input [XLEN-1:0] dividend);
+    div_zero = (is_signed && ~dividend[XLEN-1]) ? {1'b0, {(XLEN-1){1'b1}}} : {XLEN{1'b1}};
+endfunction
+
+// Select the instruction result from the kept product, quotient and remainder
+function automatic [XLEN-1:0] pick(input [2:0] op, input [2*XLEN-1:0] prod,
+                                   input [XLEN-1:0] quot, input [XLEN-1:0] rem);
+    case (op)
+        `MDU_MUL:    pick = prod[XLEN-1:0];
+        `MDU_MULH,
+        `MDU_MULHSU,
+        `MDU_MULHU:  pick = prod[2*XLEN-1:XLEN];
+        `MDU_DIV,
+        `MDU_DIVU:   pick = quot;
+        default:     pick = rem;
+    endcase
+endfunction
+
+// ──────────────────────────
+// Request Decode
+// ──────────────────────────
+logic start_q;
+logic start_edge;
+logic is_mul;
+logic mul_sa;    // operand_a is signed
+logic mul_sb;    // operand_b is signed
+logic div_sign;  // Signed division
+assign start_edge = start && ~start_q;
+assign is_mul     = ~control[2];
+assign mul_sa     = (control == `MDU_MUL) || (control == `MDU_MULH) || (control == `MDU_MULHSU);
+assign mul_sb     = (control == `MDU_MUL) || (control == `MDU_MULH);
+assign div_sign   = ~control[0];
+
 // ──────────────────────────
-// Internally, handle signed versions of operand_a/b
+// Kept Results (fusion)
 // ──────────────────────────
-logic signed [XLEN-1:0] operand_a_signed;
-logic signed [XLEN-1:0] operand_b_signed;
-assign operand_a_signed = operand_a;
-assign operand_b_signed = operand_b;
+logic [2*XLEN-1:0] prod;
+logic [XLEN-1:0]   prod_a;
+logic [XLEN-1:0]   prod_b;
+logic [1:0]        prod_sign;
+logic              prod_valid;
+logic [XLEN-1:0]   quot;
+logic [XLEN-1:0]   rem;
+logic [XLEN-1:0]   div_a;
+logic [XLEN-1:0]   div_b;
+logic              div_signed;
+logic              div_valid;
+
+logic fuse_hit;
+assign fuse_hit = is_mul ? (prod_valid && prod_a == operand_a && prod_b == operand_b &&
+                            (control == `MDU_MUL || prod_sign == {mul_sa, mul_sb}))
+                         : (div_valid && div_a == operand_a && div_b == operand_b &&
+                            div_signed == div_sign);
 
 // ──────────────────────────
 // Internal signals
 // ──────────────────────────
-logic signed [2*XLEN-1:0] mul_result;
-logic signed [XLEN-1:0]   div_result;
-logic signed [XLEN-1:0]   rem_result;
-logic [5:0]               op_reg;
-logic                     mdu_active;
-logic [5:0]               counter;
+typedef enum logic [1:0] {
+    MDU_IDLE,        // Waiting for start
+    MDU_MUL_BUSY,    // Multiplication in flight
+    MDU_DIV_BUSY     // Division in flight
+} mdu_state_t;
+mdu_state_t state;
+
+logic [2:0]          op_reg;
+logic [XLEN-1:0]     a_reg;
+logic [XLEN-1:0]     b_reg;
+logic                sa_reg;
+logic                sb_reg;
+logic [CNT_BITS-1:0] counter;
+
+// ──────────────────────────
+// Pipelined Multiplier (MDU_IMPL_FAST)
+// ──────────────────────────
+// The operands are extended by one bit so a single signed multiply covers the signed,
+// unsigned and mixed products, the stages after it let synthesis retime into the DSP.
+logic signed [XLEN:0]     mul_a;
+logic signed [XLEN:0]     mul_b;
+logic signed [2*XLEN+1:0] mul_pipe [0:MUL_STAGES-1];
+assign mul_a = {sa_reg & a_reg[XLEN-1], a_reg};
+assign mul_b = {sb_reg & b_reg[XLEN-1], b_reg};
+
+generate
+if (MDU_IMPL == `MDU_IMPL_FAST) begin : g_mul_pipe
+    always_ff @(posedge clk) begin
+        mul_pipe[0] <= mul_a * mul_b;
+        for (int i = 1; i < MUL_STAGES; i++) begin
+            mul_pipe[i] <= mul_pipe[i-1];
+        end
+    end
+end
+endgenerate
+
+// ──────────────────────────
+// Radix-4 Divider (MDU_IMPL_FAST)
+// ──────────────────────────
+// Restoring division on the operand magnitudes, two quotient bits per cycle.
+logic [XLEN-1:0]   a_mag;
+logic [XLEN-1:0]   b_mag;
+logic [XLEN-1:0]   div_r;     // Partial remainder
+logic [XLEN-1:0]   div_dvd;   // Dividend bits still to be shifted in
+logic [XLEN-1:0]   div_q;
+logic [XLEN-1:0]   div_d;
+logic              div_neg_q;
+logic              div_neg_r;
+logic [XLEN+1:0]   div_shift;
+logic [XLEN+1:0]   div_d2;
+logic [XLEN+1:0]   div_d3;
+logic [XLEN-1:0]   div_r_next;
+logic [1:0]        div_q_next;
+logic [CNT_BITS-1:0] a_skip;
+
+assign a_mag  = (div_sign && operand_a[XLEN-1]) ? -operand_a : operand_a;
+assign b_mag  = (div_sign && operand_b[XLEN-1]) ? -operand_b : operand_b;
+assign a_skip = clz(a_mag) & ~{{(CNT_BITS-1){1'b0}}, 1'b1}; // Even, two bits per step
+
+always_comb begin
+    div_shift = {div_r, div_dvd[XLEN-1:XLEN-2]};
+    div_d2    = {1'b0, div_d, 1'b0};
+    div_d3    = div_d2 + {2'b00, div_d};
+    if (div_shift >= div_d3) begin
+        div_r_next = div_shift - div_d3;
+        div_q_next = 2'd3;
+    end else if (div_shift >= div_d2) begin
+        div_r_next = div_shift - div_d2;
+        div_q_next = 2'd2;
+    end else if (div_shift >= {2'b00, div_d}) begin
+        div_r_next = div_shift - {2'b00, div_d};
+        div_q_next = 2'd1;
+    end else begin
+        div_r_next = div_shift[XLEN-1:0];
+        div_q_next = 2'd0;
+    end
+end
 
 // ──────────────────────────
 // MDU State Machine
 // ──────────────────────────
 always_ff @(posedge clk or posedge reset) begin
     if (reset) begin
-        mdu_active <= 1'b0;
-        counter    <= 6'd0;
+        state      <= MDU_IDLE;
+        start_q    <= 1'b0;
+        counter    <= {CNT_BITS{1'b0}};
         ready      <= 1'b0;
         result     <= {XLEN{1'b0}};
-        mul_result <= {2*XLEN{1'b0}};
-        div_result <= {XLEN{1'b0}};
-        rem_result <= {XLEN{1'b0}};
-        op_reg     <= 6'b0;
-    end 
+        op_reg     <= 3'b0;
+        a_reg      <= {XLEN{1'b0}};
+        b_reg      <= {XLEN{1'b0}};
+        sa_reg     <= 1'b0;
+        sb_reg     <= 1'b0;
+        prod       <= {2*XLEN{1'b0}};
+        prod_a     <= {XLEN{1'b0}};
+        prod_b     <= {XLEN{1'b0}};
+        prod_sign  <= 2'b00;
+        prod_valid <= 1'b0;
+        quot       <= {XLEN{1'b0}};
+        rem        <= {XLEN{1'b0}};
+        div_a      <= {XLEN{1'b0}};
+        div_b      <= {XLEN{1'b0}};
+        div_signed <= 1'b0;
+        div_valid  <= 1'b0;
+        div_r      <= {XLEN{1'b0}};
+        div_dvd    <= {XLEN{1'b0}};
+        div_q      <= {XLEN{1'b0}};
+        div_d      <= {XLEN{1'b0}};
+        div_neg_q  <= 1'b0;
+        div_neg_r  <= 1'b0;
+    end
     else begin
-        // Start new MDU op
-        if (start && !mdu_active) begin
-            mdu_active <= 1'b1;
-            ready      <= 1'b0;
-            counter    <= XLEN;   // simplistic “latency”
-            op_reg     <= control;
-
-            // Initialize multiplication / division
-            case (control)
-                `MDU_MUL: begin // MUL (signed x signed)
-                    `ifdef LOG_MDU `LOG("mdu", (" MUL a=0x%00h b=0x%00h", operand_a_signed, operand_b_signed)); `endif
-                    mul_result <= { {XLEN{operand_a_signed[XLEN-1]}}, operand_a_signed }
-                                * { {XLEN{operand_b_signed[XLEN-1]}}, operand_b_signed };
-                end
-                `MDU_MULH: begin // MULH (signed x signed high)
-                    `ifdef LOG_MDU `LOG("mdu", (" MULH a=0x%00h b=0x%00h", operand_a_signed, operand_b_signed)); `endif
-                    mul_result <= { {XLEN{operand_a_signed[XLEN-1]}}, operand_a_signed }
-                                * { {XLEN{operand_b_signed[XLEN-1]}}, operand_b_signed };
-                end
-                `MDU_MULHSU: begin // MULHSU (signed x unsigned high)
-                    `ifdef LOG_MDU `LOG("mdu", (" MULHSU a=0x%00h b=0x%00h", operand_a_signed, operand_b_signed)); `endif
-                    mul_result <= { {XLEN{operand_a_signed[XLEN-1]}}, operand_a_signed }
-                                * { {XLEN{1'b0}}, operand_b };
-                end
-                `MDU_MULHU: begin // MULHU (unsigned x unsigned high)
-                    `ifdef LOG_MDU `LOG("mdu", (" MULHU a=0x%00h b=0x%00h", operand_a_signed, operand_b_signed)); `endif
-                    mul_result <= { {XLEN{1'b0}}, operand_a }
-                                * { {XLEN{1'b0}}, operand_b };
-                end
-                `MDU_DIV: begin // DIV (signed ÷ signed)
-                    `ifdef LOG_MDU `LOG("mdu", (" DIVU a=0x%00h b=0x%00h", operand_a, operand_b)); `endif
-                    if (operand_b != 0) begin
-                        div_result <= operand_a_signed / operand_b_signed;
-                        rem_result <= operand_a_signed % operand_b_signed;
-                    end else begin
-                        // Division by zero behavior
-                        div_result <= (operand_a_signed[XLEN-1] == 1) 
-                                        ? -1 
-                                        : { (XLEN-1){1'b1} };
-                        rem_result <= operand_a_signed;
-                    end
-                end
-                `MDU_DIVU: begin // DIVU (unsigned ÷ unsigned)
-                    `ifdef LOG_MDU `LOG("mdu", (" DIV a=0x%00h b=0x%00h", operand_a, operand_b)); `endif
-                    if (operand_b != 0) begin
-                        div_result <= operand_a / operand_b;
-                        rem_result <= operand_a % operand_b;
+        start_q <= start;
+        ready   <= 1'b0;
+
+        case (state)
+            MDU_IDLE: begin
+                if (start_edge) begin
+                    op_reg <= control;
+                    a_reg  <= operand_a;
+                    b_reg  <= operand_b;
+                    sa_reg <= mul_sa;
+                    sb_reg <= mul_sb;
+
+                    if (fuse_hit) begin
+                        // Same operands as the kept result
+                        `ifdef LOG_MDU `LOG("mdu", (" Fused op=%0d a=0x%00h b=0x%00h", control, operand_a, operand_b)); `endif
+                        ready  <= 1'b1;
+                        result <= pick(control, prod, quot, rem);
+                    end else if (is_mul) begin
+                        `ifdef LOG_MDU `LOG("mdu", (" MUL op=%0d a=0x%00h b=0x%00h", control, operand_a, operand_b)); `endif
+                        prod_valid <= 1'b0;
+                        prod_a     <= operand_a;
+                        prod_b     <= operand_b;
+                        prod_sign  <= {mul_sa, mul_sb};
+                        state      <= MDU_MUL_BUSY;
+                        if (MDU_IMPL == `MDU_IMPL_FAST) begin
+                            counter <= MUL_STAGES;
+                        end else begin
+                            counter <= XLEN;   // simplistic “latency”
+                            prod    <= $signed({mul_sa & operand_a[XLEN-1], operand_a})
+                                     * $signed({mul_sb & operand_b[XLEN-1], operand_b});
+                        end
                     end else begin
-                        div_result <= {XLEN{1'b1}};  // all 1s
-                        rem_result <= operand_a;
+                        `ifdef LOG_MDU `LOG("mdu", (" DIV op=%0d a=0x%00h b=0x%00h", control, operand_a, operand_b)); `endif
+                        div_valid  <= 1'b0;
+                        if (MDU_IMPL == `MDU_IMPL_FAST) begin
+                            if (operand_b == 0) begin
+                                // Division by zero behavior
+                                ready      <= 1'b1;
+                                result     <= control[1] ? operand_a : div_zero(div_sign, operand_a);
+                                quot       <= div_zero(div_sign, operand_a);
+                                rem        <= operand_a;
+                                div_valid  <= 1'b1;
+                            end else if (a_mag < b_mag) begin
+                                // Quotient is zero, the dividend is the remainder
+                                ready      <= 1'b1;
+                                result     <= control[1] ? operand_a : {XLEN{1'b0}};
+                                quot       <= {XLEN{1'b0}};
+                                rem        <= operand_a;
+                                div_valid  <= 1'b1;
+                            end else begin
+                                div_r      <= {XLEN{1'b0}};
+                                div_dvd    <= a_mag << a_skip;
+                                div_q      <= {XLEN{1'b0}};
+                                div_d      <= b_mag;
+                                div_neg_q  <= div_sign && (operand_a[XLEN-1] ^ operand_b[XLEN-1]);
+                                div_neg_r  <= div_sign && operand_a[XLEN-1];
+                                counter    <= (XLEN - a_skip) >> 1;
+                                state      <= MDU_DIV_BUSY;
+                            end
+                        end else begin
+                            counter <= XLEN;   // simplistic “latency”
+                            state   <= MDU_DIV_BUSY;
+                            if (operand_b == 0) begin
+                                // Division by zero behavior
+                                quot <= div_zero(div_sign, operand_a);
+                                rem  <= operand_a;
+                            end else if (div_sign) begin
+                                quot <= $signed(operand_a) / $signed(operand_b);
+                                rem  <= $signed(operand_a) % $signed(operand_b);
+                            end else begin
+                                quot <= operand_a / operand_b;
+                                rem  <= operand_a % operand_b;
+                            end
+                        end
+                        div_a      <= operand_a;
+                        div_b      <= operand_b;
+                        div_signed <= div_sign;
                     end
                 end
-                `MDU_REM: begin // REM (signed remainder)
-                    `ifdef LOG_MDU `LOG("mdu", (" REM a=0x%00h b=0x%00h", operand_a, operand_b)); `endif
-                    if (operand_b != 0) begin
-                        rem_result <= operand_a_signed % operand_b_signed;
+            end
+
+            MDU_MUL_BUSY: begin
+                if (counter > 0) begin
+                    counter <= counter - 1;
+                end else begin
+                    // Finished
+                    ready      <= 1'b1;
+                    prod_valid <= 1'b1;
+                    state      <= MDU_IDLE;
+                    if (MDU_IMPL == `MDU_IMPL_FAST) begin
+                        prod   <= mul_pipe[MUL_STAGES-1][2*XLEN-1:0];
+                        result <= pick(op_reg, mul_pipe[MUL_STAGES-1][2*XLEN-1:0], quot, rem);
                     end else begin
-                        rem_result <= operand_a_signed; 
+                        result <= pick(op_reg, prod, quot, rem);
                     end
                 end
-                `MDU_REMU: begin // REMU (unsigned remainder)
-                    `ifdef LOG_MDU `LOG("mdu", (" REMU a=0x%00h b=0x%00h", operand_a, operand_b)); `endif
-                    if (operand_b != 0) begin
-                        rem_result <= operand_a % operand_b;
+            end
+
+            MDU_DIV_BUSY: begin
+                if (MDU_IMPL == `MDU_IMPL_FAST && counter > 0) begin
+                    div_r   <= div_r_next;
+                    div_dvd <= {div_dvd[XLEN-3:0], 2'b00};
+                    div_q   <= {div_q[XLEN-3:0], div_q_next};
+                    counter <= counter - 1;
+                end else if (counter > 0) begin
+                    counter <= counter - 1;
+                end else begin
+                    // Finished
+                    ready     <= 1'b1;
+                    div_valid <= 1'b1;
+                    state     <= MDU_IDLE;
+                    if (MDU_IMPL == `MDU_IMPL_FAST) begin
+                        quot   <= div_neg_q ? -div_q : div_q;
+                        rem    <= div_neg_r ? -div_r : div_r;
+                        result <= pick(op_reg, prod, div_neg_q ? -div_q : div_q, div_neg_r ? -div_r : div_r);
                     end else begin
-                        rem_result <= operand_a;
+                        result <= pick(op_reg, prod, quot, rem);
                     end
                 end
-                default: begin
-                    mul_result <= {2*XLEN{1'b0}};
-                    div_result <= {XLEN{1'b0}};
-                    rem_result <= {XLEN{1'b0}};
-                end
-            endcase
-        end else if (mdu_active && counter > 0) begin
-            // If an op is in progress, decrement the counter
-            counter <= counter - 1;
-        end else if (mdu_active && counter == 0) begin
-            // Finished
-            mdu_active <= 1'b0;
-            ready      <= 1'b1;
-            // Pick the final result
-            case (op_reg)
-                `MDU_MUL:    result <= mul_result[XLEN-1 : 0];
-                `MDU_MULH:   result <= mul_result[2*XLEN-1 : XLEN];
-                `MDU_MULHSU: result <= mul_result[2*XLEN-1 : XLEN];
-                `MDU_MULHU:  result <= mul_result[2*XLEN-1 : XLEN];
-                `MDU_DIV,
-                `MDU_DIVU:   result <= div_result;
-                `MDU_REM,
-                `MDU_REMU:   result <= rem_result;
-                default:     result <= {XLEN{1'b0}};
-            endcase
-        end else begin
-            // Idle
-            ready <= 1'b0;
-        end
+            end
+
+            default: state <= MDU_IDLE;
+        endcase
     end
 end
 
@@ -14,9 +14,12 @@
  * Features:
  * - Supports register reads and writes.
  * - Ensures x0 is always zero.
+ * - Two combinational read ports, so a register can be read in the cycle its address is known.
+ * - With `BYPASS` set, a read of the register being written returns `rd_data` in the same cycle
+ *   (write-first) instead of the old value.
  *
  * Developers should be aware that:
- * - Writes to register x0 are ignored.
+ * - Writes to register x0 are ignored, also by the bypass.
  */
 
 `timescale 1ns / 1ps
@@ -25,7 +28,8 @@
 `include "log.sv"
 
 module cpu_regfile #(
-    parameter XLEN = 32  // Data width: 32 or 64 bits
+    parameter XLEN   = 32, // Data width: 32 or 64 bits
+    parameter BYPASS = 0   // 1 forwards rd_data to a read of rd_addr while it is written
 ) (
     input  wire             clk,
     input  wire             reset,
@@ -110,8 +114,12 @@ always_ff @(posedge clk or posedge reset) begin
 end
 
 // Read Ports
-assign rs1_data = reg_array[rs1_addr];
-assign rs2_data = reg_array[rs2_addr];
+logic rs1_bypass, rs2_bypass;
+assign rs1_bypass = (BYPASS != 0) && rd_write_en && rd_addr != 5'b0 && rd_addr == rs1_addr;
+assign rs2_bypass = (BYPASS != 0) && rd_write_en && rd_addr != 5'b0 && rd_addr == rs2_addr;
+
+assign rs1_data = rs1_bypass ? rd_data : reg_array[rs1_addr];
+assign rs2_data = rs2_bypass ? rd_data : reg_array[rs2_addr];
 
 // Debug Ports
 assign dbg_x1 = reg_array[1];
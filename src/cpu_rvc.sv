@@ -0,0 +1,265 @@
+`ifndef __CPU_RVC__
+`define __CPU_RVC__
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Compressed Instruction Expander Module
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @module cpu_rvc
+ * @brief Expands a 16-bit RISC-V compressed (C extension) instruction into the
+ * 32-bit instruction it stands for.
+ *
+ * The `cpu_rvc` module sits in front of `cpu_insdecode`, so the decoder and the
+ * rest of the core only ever see full-width instructions. A 32-bit instruction
+ * (`instr_in[1:0] == 2'b11`) is passed through unchanged.
+ *
+ * Features:
+ * - All RV32C and RV64C integer instructions, picked by `XLEN`.
+ * - `compressed` tells the core to step the PC by 2 instead of 4.
+ *
+ * Developers should be aware that:
+ * - There is no F or D support in the core, so the compressed floating-point
+ *   loads and stores are illegal, as are the reserved encodings (including
+ *   the all-zero parcel).
+ * - An illegal instruction expands to `32'h0000_0000`, which the core already
+ *   traps on as an unknown instruction.
+ * - HINT encodings (e.g., `c.addi x0`, `c.li x0`) expand to the equivalent
+ *   no-op write to `x0`.
+ */
+
+`timescale 1ns / 1ps
+`default_nettype none
+
+module cpu_rvc #(
+    parameter XLEN = 32  // Data width: 32 or 64 bits
+) (
+    input  wire  [31:0]     instr_in,    // Fetched bits, a compressed instruction is in [15:0]
+    output logic [31:0]     instr,       // Full-width instruction for cpu_insdecode
+    output wire             compressed,  // High if instr_in holds a compressed instruction
+    output logic            illegal      // High for reserved or unsupported compressed encodings
+);
+
+// ──────────────────────────
+// Opcodes
+// ──────────────────────────
+localparam [6:0] OP_LOAD   = 7'b0000011;
+localparam [6:0] OP_STORE  = 7'b0100011;
+localparam [6:0] OP_IMM    = 7'b0010011;
+localparam [6:0] OP_IMM_32 = 7'b0011011;
+localparam [6:0] OP        = 7'b0110011;
+localparam [6:0] OP_32     = 7'b0111011;
+localparam [6:0] OP_LUI    = 7'b0110111;
+localparam [6:0] OP_BRANCH = 7'b1100011;
+localparam [6:0] OP_JAL    = 7'b1101111;
+localparam [6:0] OP_JALR   = 7'b1100111;
+localparam [6:0] OP_SYSTEM = 7'b1110011;
+
+assign compressed = (instr_in[1:0] != 2'b11);
+
+// ──────────────────────────
+// Fields
+// ──────────────────────────
+wire [15:0] c      = instr_in[15:0];
+wire [4:0]  rd     = c[11:7];        // Also rs1 of the full register forms
+wire [4:0]  rs2    = c[6:2];
+wire [4:0]  rd_p   = {2'b01, c[4:2]}; // rd' / rs2', x8 - x15
+wire [4:0]  rs1_p  = {2'b01, c[9:7]}; // rs1' / rd', x8 - x15
+wire [5:0]  shamt  = {c[12], c[6:2]};
+
+// Immediates, already sign or zero extended to the width of the 32-bit format that uses them
+wire [11:0] imm_ci        = {{6{c[12]}}, c[12], c[6:2]};                                            // c.addi, c.li, c.andi
+wire [11:0] imm_addi4sp   = {2'b00, c[10:7], c[12:11], c[5], c[6], 2'b00};                          // c.addi4spn
+wire [11:0] imm_addi16sp  = {{2{c[12]}}, c[12], c[4:3], c[5], c[2], c[6], 4'b0000};                 // c.addi16sp
+wire [19:0] imm_lui       = {{14{c[12]}}, c[12], c[6:2]};                                           // c.lui
+wire [11:0] imm_lw        = {5'b00000, c[5], c[12:10], c[6], 2'b00};                                // c.lw, c.sw
+wire [11:0] imm_ld        = {4'b0000, c[6:5], c[12:10], 3'b000};                                    // c.ld, c.sd
+wire [11:0] imm_lwsp      = {4'b0000, c[3:2], c[12], c[6:4], 2'b00};                                // c.lwsp
+wire [11:0] imm_ldsp      = {3'b000, c[4:2], c[12], c[6:5], 3'b000};                                // c.ldsp
+wire [11:0] imm_swsp      = {4'b0000, c[8:7], c[12:9], 2'b00};                                      // c.swsp
+wire [11:0] imm_sdsp      = {3'b000, c[9:7], c[12:10], 3'b000};                                     // c.sdsp
+wire [20:0] imm_j         = {{10{c[12]}}, c[8], c[10:9], c[6], c[7], c[2], c[11], c[5:3], 1'b0};    // c.j, c.jal
+wire [12:0] imm_b         = {{5{c[12]}}, c[6:5], c[2], c[11:10], c[4:3], 1'b0};                     // c.beqz, c.bnez
+
+// ──────────────────────────
+// Expansion
+// ──────────────────────────
+always_comb begin
+    instr   = instr_in;
+    illegal = 1'b0;
+
+    if (compressed) begin
+        illegal = 1'b1;
+        instr   = 32'h0000_0000;
+
+        case ({c[1:0], c[15:13]})
+            // ======================
+            // Quadrant 0
+            // ======================
+            5'b00_000: if (c[12:5] != 8'd0) begin // c.addi4spn -> addi rd', x2, nzuimm
+                instr   = {imm_addi4sp, 5'd2, 3'b000, rd_p, OP_IMM};
+                illegal = 1'b0;
+            end
+            5'b00_010: begin // c.lw -> lw rd', uimm(rs1')
+                instr   = {imm_lw, rs1_p, 3'b010, rd_p, OP_LOAD};
+                illegal = 1'b0;
+            end
+            5'b00_011: if (XLEN >= 64) begin // c.ld -> ld rd', uimm(rs1')
+                instr   = {imm_ld, rs1_p, 3'b011, rd_p, OP_LOAD};
+                illegal = 1'b0;
+            end
+            5'b00_110: begin // c.sw -> sw rs2', uimm(rs1')
+                instr   = {imm_lw[11:5], rd_p, rs1_p, 3'b010, imm_lw[4:0], OP_STORE};
+                illegal = 1'b0;
+            end
+            5'b00_111: if (XLEN >= 64) begin // c.sd -> sd rs2', uimm(rs1')
+                instr   = {imm_ld[11:5], rd_p, rs1_p, 3'b011, imm_ld[4:0], OP_STORE};
+                illegal = 1'b0;
+            end
+
+            // ======================
+            // Quadrant 1
+            // ======================
+            5'b01_000: begin // c.addi / c.nop -> addi rd, rd, nzimm
+                instr   = {imm_ci, rd, 3'b000, rd, OP_IMM};
+                illegal = 1'b0;
+            end
+            5'b01_001: begin
+                if (XLEN == 32) begin // c.jal -> jal x1, offset
+                    instr   = {imm_j[20], imm_j[10:1], imm_j[11], imm_j[19:12], 5'd1, OP_JAL};
+                    illegal = 1'b0;
+                end else if (rd != 5'd0) begin // c.addiw -> addiw rd, rd, imm
+                    instr   = {imm_ci, rd, 3'b000, rd, OP_IMM_32};
+                    illegal = 1'b0;
+                end
+            end
+            5'b01_010: begin // c.li -> addi rd, x0, imm
+                instr   = {imm_ci, 5'd0, 3'b000, rd, OP_IMM};
+                illegal = 1'b0;
+            end
+            5'b01_011: begin
+                if (rd == 5'd2) begin // c.addi16sp -> addi x2, x2, nzimm
+                    if ({c[12], c[6:2]} != 6'd0) begin
+                        instr   = {imm_addi16sp, 5'd2, 3'b000, 5'd2, OP_IMM};
+                        illegal = 1'b0;
+                    end
+                end else if ({c[12], c[6:2]} != 6'd0) begin // c.lui -> lui rd, nzimm
+                    instr   = {imm_lui, rd, OP_LUI};
+                    illegal = 1'b0;
+                end
+            end
+            5'b01_100: begin
+                case (c[11:10])
+                    2'b00: if (XLEN >= 64 || c[12] == 1'b0) begin // c.srli -> srli rd', rd', shamt
+                        instr   = {6'b000000, shamt, rs1_p, 3'b101, rs1_p, OP_IMM};
+                        illegal = 1'b0;
+                    end
+                    2'b01: if (XLEN >= 64 || c[12] == 1'b0) begin // c.srai -> srai rd', rd', shamt
+                        instr   = {6'b010000, shamt, rs1_p, 3'b101, rs1_p, OP_IMM};
+                        illegal = 1'b0;
+                    end
+                    2'b10: begin // c.andi -> andi rd', rd', imm
+                        instr   = {imm_ci, rs1_p, 3'b111, rs1_p, OP_IMM};
+                        illegal = 1'b0;
+                    end
+                    2'b11: begin
+                        case ({c[12], c[6:5]})
+                            3'b000: begin // c.sub -> sub rd', rd', rs2'
+                                instr   = {7'b0100000, rd_p, rs1_p, 3'b000, rs1_p, OP};
+                                illegal = 1'b0;
+                            end
+                            3'b001: begin // c.xor -> xor rd', rd', rs2'
+                                instr   = {7'b0000000, rd_p, rs1_p, 3'b100, rs1_p, OP};
+                                illegal = 1'b0;
+                            end
+                            3'b010: begin // c.or -> or rd', rd', rs2'
+                                instr   = {7'b0000000, rd_p, rs1_p, 3'b110, rs1_p, OP};
+                                illegal = 1'b0;
+                            end
+                            3'b011: begin // c.and -> and rd', rd', rs2'
+                                instr   = {7'b0000000, rd_p, rs1_p, 3'b111, rs1_p, OP};
+                                illegal = 1'b0;
+                            end
+                            3'b100: if (XLEN >= 64) begin // c.subw -> subw rd', rd', rs2'
+                                instr   = {7'b0100000, rd_p, rs1_p, 3'b000, rs1_p, OP_32};
+                                illegal = 1'b0;
+                            end
+                            3'b101: if (XLEN >= 64) begin // c.addw -> addw rd', rd', rs2'
+                                instr   = {7'b0000000, rd_p, rs1_p, 3'b000, rs1_p, OP_32};
+                                illegal = 1'b0;
+                            end
+                            default: ;
+                        endcase
+                    end
+                endcase
+            end
+            5'b01_101: begin // c.j -> jal x0, offset
+                instr   = {imm_j[20], imm_j[10:1], imm_j[11], imm_j[19:12], 5'd0, OP_JAL};
+                illegal = 1'b0;
+            end
+            5'b01_110: begin // c.beqz -> beq rs1', x0, offset
+                instr   = {imm_b[12], imm_b[10:5], 5'd0, rs1_p, 3'b000, imm_b[4:1], imm_b[11], OP_BRANCH};
+                illegal = 1'b0;
+            end
+            5'b01_111: begin // c.bnez -> bne rs1', x0, offset
+                instr   = {imm_b[12], imm_b[10:5], 5'd0, rs1_p, 3'b001, imm_b[4:1], imm_b[11], OP_BRANCH};
+                illegal = 1'b0;
+            end
+
+            // ======================
+            // Quadrant 2
+            // ======================
+            5'b10_000: if (XLEN >= 64 || c[12] == 1'b0) begin // c.slli -> slli rd, rd, shamt
+                instr   = {6'b000000, shamt, rd, 3'b001, rd, OP_IMM};
+                illegal = 1'b0;
+            end
+            5'b10_010: if (rd != 5'd0) begin // c.lwsp -> lw rd, uimm(x2)
+                instr   = {imm_lwsp, 5'd2, 3'b010, rd, OP_LOAD};
+                illegal = 1'b0;
+            end
+            5'b10_011: if (XLEN >= 64 && rd != 5'd0) begin // c.ldsp -> ld rd, uimm(x2)
+                instr   = {imm_ldsp, 5'd2, 3'b011, rd, OP_LOAD};
+                illegal = 1'b0;
+            end
+            5'b10_100: begin
+                if (c[12] == 1'b0) begin
+                    if (rs2 == 5'd0) begin
+                        if (rd != 5'd0) begin // c.jr -> jalr x0, 0(rs1)
+                            instr   = {12'd0, rd, 3'b000, 5'd0, OP_JALR};
+                            illegal = 1'b0;
+                        end
+                    end else begin // c.mv -> add rd, x0, rs2
+                        instr   = {7'b0000000, rs2, 5'd0, 3'b000, rd, OP};
+                        illegal = 1'b0;
+                    end
+                end else begin
+                    if (rs2 == 5'd0) begin
+                        if (rd == 5'd0) begin // c.ebreak -> ebreak
+                            instr   = {12'd1, 5'd0, 3'b000, 5'd0, OP_SYSTEM};
+                            illegal = 1'b0;
+                        end else begin // c.jalr -> jalr x1, 0(rs1)
+                            instr   = {12'd0, rd, 3'b000, 5'd1, OP_JALR};
+                            illegal = 1'b0;
+                        end
+                    end else begin // c.add -> add rd, rd, rs2
+                        instr   = {7'b0000000, rs2, rd, 3'b000, rd, OP};
+                        illegal = 1'b0;
+                    end
+                end
+            end
+            5'b10_110: begin // c.swsp -> sw rs2, uimm(x2)
+                instr   = {imm_swsp[11:5], rs2, 5'd2, 3'b010, imm_swsp[4:0], OP_STORE};
+                illegal = 1'b0;
+            end
+            5'b10_111: if (XLEN >= 64) begin // c.sdsp -> sd rs2, uimm(x2)
+                instr   = {imm_sdsp[11:5], rs2, 5'd2, 3'b011, imm_sdsp[4:0], OP_STORE};
+                illegal = 1'b0;
+            end
+
+            // c.fld, c.flw, c.fsd, c.fsw and their sp forms, and the reserved slot
+            default: ;
+        endcase
+    end
+end
+
+endmodule
+
+`endif // __CPU_RVC__
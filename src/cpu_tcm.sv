@@ -0,0 +1,248 @@
+`ifndef __CPU_TCM__
+`define __CPU_TCM__
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// cpu_tcm Module
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @module cpu_tcm
+ * @brief Tightly-coupled scratchpad memory on the CPU load/store path.
+ *
+ * The `cpu_tcm` module sits directly behind the CPU's memory port, in front of `cpu_icache`,
+ * `cpu_dcache` and `tl_interface`, and speaks the same ready/ack/valid handshake on both of its
+ * ports. Loads and stores inside its window are answered from a local block RAM without a bus
+ * transaction, everything else is passed through.
+ *
+ * Operation:
+ * - Local loads and stores are acknowledged the cycle after the request and complete the cycle
+ *   after that, the same as a `cpu_dcache` hit. They never wait for the bus.
+ * - Fetches (`cpu_fetch` high), requests with `cpu_bypass` high and addresses outside the window
+ *   are passed through. The route is selected combinationally so it adds no latency.
+ * - The memory is not visible on the TileLink bus, the DMA engine and other harts cannot reach
+ *   it. Each CPU has its own.
+ *
+ * Address Map:
+ * - Addresses with `(address & ~(SIZE-1)) == BASE` are local.
+ *
+ * Parameters:
+ * - `SIZE`: Memory size in bytes (power of two, at least two XLEN words).
+ * - `BASE`: Window base, aligned to `SIZE`.
+ * - `INIT_FILE`: Optional `$readmemh` image with one XLEN word per line.
+ *
+ * @note Atomic memory operations are not executed here. tl_cpu bypasses them to the bus, where
+ *       the window is unmapped and they are denied.
+ */
+
+`timescale 1ns / 1ps
+`default_nettype none
+
+`include "log.sv"
+
+module cpu_tcm #(
+    parameter XLEN      = 32,
+    parameter SIZE      = 4096,          // Memory size in bytes
+    parameter BASE      = 32'h0010_0000, // Base of the local window
+    parameter INIT_FILE = ""             // Initial contents, one XLEN word per line
+) (
+    input  wire                 clk,
+    input  wire                 reset,
+
+    // CPU Side
+    input  wire                 cpu_ready,
+    input  wire                 cpu_fetch,      // Request is an instruction fetch
+    input  wire                 cpu_bypass,     // Send the request to the bus even when local
+    input  wire [XLEN-1:0]      cpu_address,
+    input  wire [XLEN-1:0]      cpu_wdata,
+    input  wire [XLEN/8-1:0]    cpu_wstrb,
+    input  wire [2:0]           cpu_size,
+    input  wire                 cpu_read,
+    output wire                 cpu_ack,
+    output wire [XLEN-1:0]      cpu_rdata,
+    output wire                 cpu_denied,
+    output wire                 cpu_corrupt,
+    output wire                 cpu_valid,
+
+    // Cache / tl_interface Side
+    output wire                 if_ready,
+    output wire                 if_fetch,
+    output wire [XLEN-1:0]      if_address,
+    output wire [XLEN-1:0]      if_wdata,
+    output wire [XLEN/8-1:0]    if_wstrb,
+    output wire [2:0]           if_size,
+    output wire                 if_read,
+    input  wire                 if_ack,
+    input  wire [XLEN-1:0]      if_rdata,
+    input  wire                 if_denied,
+    input  wire                 if_corrupt,
+    input  wire                 if_valid,
+
+    // Counters
+    output reg  [XLEN-1:0]      access_count
+);
+
+localparam BYTES     = XLEN / 8;
+localparam WORD_BITS = $clog2(BYTES);
+localparam WORDS     = SIZE / BYTES;
+localparam SIZE_BITS = $clog2(SIZE);
+
+localparam [XLEN-1:0] BASE_ADDR = BASE;
+localparam [XLEN-1:0] MASK      = SIZE - 1;
+
+initial begin
+    `ASSERT(((SIZE & (SIZE - 1)) == 0), "SIZE must be a power of 2.");
+    `ASSERT((SIZE >= 2 * BYTES), "SIZE must hold at least two XLEN words.");
+    `ASSERT(((BASE_ADDR & MASK) == 0), "BASE must be aligned to SIZE.");
+end
+
+// ──────────────────────────
+// States
+// ──────────────────────────
+typedef enum logic [1:0] {
+    TCM_IDLE,        // Waiting for a request
+    TCM_RESPOND,     // Return the local load or store
+    TCM_PASS         // Request passed through to the cache / tl_interface side
+} tcm_state_t;
+tcm_state_t state;
+
+// ──────────────────────────
+// Helpers
+// ──────────────────────────
+function automatic [BYTES-1:0] lane_mask(input [2:0] size, input [WORD_BITS-1:0] offset);
+    case (size)
+        3'b000:  lane_mask = {{(BYTES-1){1'b0}}, 1'b1} << offset;
+        3'b001:  lane_mask = {{(BYTES-2){1'b0}}, 2'b11} << offset;
+        3'b010:  lane_mask = {{(BYTES-4){1'b0}}, 4'b1111} << offset;
+        default: lane_mask = {BYTES{1'b1}};
+    endcase
+endfunction
+
+function automatic [XLEN-1:0] size_mask(input [2:0] size);
+    case (size)
+        3'b000:  size_mask = {{(XLEN-8){1'b0}}, 8'hFF};
+        3'b001:  size_mask = {{(XLEN-16){1'b0}}, 16'hFFFF};
+        3'b010:  size_mask = {{(XLEN-32){1'b0}}, 32'hFFFF_FFFF};
+        default: size_mask = {XLEN{1'b1}};
+    endcase
+endfunction
+
+// ──────────────────────────
+// Storage
+// ──────────────────────────
+logic [XLEN-1:0] data_mem [0:WORDS-1];
+
+// Words past the end of the image, e.g. .bss, start out as zero
+initial begin
+    for (int i = 0; i < WORDS; i++) begin
+        data_mem[i] = {XLEN{1'b0}};
+    end
+    if (INIT_FILE != "") begin
+        $readmemh(INIT_FILE, data_mem);
+    end
+end
+
+// ──────────────────────────
+// Request Decode
+// ──────────────────────────
+logic                       req_local;
+logic [BYTES-1:0]           req_lanes;
+logic [XLEN-1:0]            req_wdata_lanes;
+logic [SIZE_BITS-WORD_BITS-1:0] req_index;
+
+assign req_local       = ((cpu_address & ~MASK) == BASE_ADDR) && ~cpu_fetch && ~cpu_bypass;
+assign req_lanes       = lane_mask(cpu_size, cpu_address[WORD_BITS-1:0]);
+assign req_wdata_lanes = cpu_wdata << (8 * cpu_address[WORD_BITS-1:0]);
+assign req_index       = cpu_address[SIZE_BITS-1:WORD_BITS];
+
+// ──────────────────────────
+// Internal Registers
+// ──────────────────────────
+logic [XLEN-1:0]        rd_word;
+logic [WORD_BITS-1:0]   rd_offset;
+logic [2:0]             rd_size;
+logic                   ack_reg;
+logic                   valid_reg;
+
+// ──────────────────────────
+// Pass-through Routing
+// ──────────────────────────
+logic pass_now;
+logic pass;
+assign pass_now = (state == TCM_IDLE) && cpu_ready && ~req_local;
+assign pass     = (state == TCM_PASS) || pass_now;
+
+assign if_ready    = pass && cpu_ready;
+assign if_fetch    = cpu_fetch;
+assign if_address  = cpu_address;
+assign if_wdata    = cpu_wdata;
+assign if_wstrb    = cpu_wstrb;
+assign if_size     = cpu_size;
+assign if_read     = cpu_read;
+
+assign cpu_ack     = pass ? if_ack     : ack_reg;
+assign cpu_valid   = pass ? if_valid   : valid_reg;
+assign cpu_rdata   = pass ? if_rdata   : (rd_word >> (8 * rd_offset)) & size_mask(rd_size);
+assign cpu_denied  = pass ? if_denied  : 1'b0;
+assign cpu_corrupt = pass ? if_corrupt : 1'b0;
+
+// ──────────────────────────
+// Memory Logic
+// ──────────────────────────
+// The words are not reset, so the array can map onto block RAM
+always_ff @(posedge clk) begin
+    if (state == TCM_IDLE && cpu_ready && req_local) begin
+        if (cpu_read) begin
+            rd_word <= data_mem[req_index];
+        end else begin
+            for (int b = 0; b < BYTES; b++) begin
+                if (req_lanes[b]) begin
+                    data_mem[req_index][8*b +: 8] <= req_wdata_lanes[8*b +: 8];
+                end
+            end
+        end
+    end
+end
+
+always_ff @(posedge clk) begin
+    if (reset) begin
+        state        <= TCM_IDLE;
+        ack_reg      <= 1'b0;
+        valid_reg    <= 1'b0;
+        rd_offset    <= {WORD_BITS{1'b0}};
+        rd_size      <= 3'b000;
+        access_count <= {XLEN{1'b0}};
+    end else begin
+        ack_reg   <= 1'b0;
+        valid_reg <= 1'b0;
+
+        case (state)
+            TCM_IDLE: begin
+                if (pass_now) begin
+                    state <= TCM_PASS;
+                end else if (cpu_ready) begin
+                    `ifdef LOG_TCM `LOG("cpu_tcm", ("%s address=0x%0h data=0x%0h", cpu_read ? "Load" : "Store", cpu_address, cpu_wdata)); `endif
+                    ack_reg      <= 1'b1;
+                    rd_offset    <= cpu_read ? cpu_address[WORD_BITS-1:0] : {WORD_BITS{1'b0}};
+                    rd_size      <= cpu_read ? cpu_size : 3'b000;
+                    access_count <= access_count + 1;
+                    state        <= TCM_RESPOND;
+                end
+            end
+
+            TCM_RESPOND: begin
+                valid_reg <= 1'b1;
+                state     <= TCM_IDLE;
+            end
+
+            TCM_PASS: begin
+                if (if_valid) begin
+                    state <= TCM_IDLE;
+                end
+            end
+
+            default: state <= TCM_IDLE;
+        endcase
+    end
+end
+
+endmodule
+
+`endif // __CPU_TCM__
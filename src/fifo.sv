@@ -0,0 +1,100 @@
+`ifndef __FIFO__
+`define __FIFO__
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// fifo Module
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @module fifo
+ * @brief Synchronous First-In First-Out Queue with a Fill Level.
+ *
+ * The `fifo` module is a `DEPTH` entry queue of `WIDTH` bit words with one write and one read
+ * port. The oldest word is always presented on `read_data`, so a reader takes it and pops it in
+ * the same cycle.
+ *
+ * **Parameters:**
+ * - `WIDTH` (default: 8): Width of each word in bits.
+ * - `DEPTH` (default: 16): Number of words, a power of two of at least 2.
+ *
+ * **Ports:**
+ * - `clk` (`input`): Clock signal.
+ * - `reset` (`input`): Asynchronous reset, empties the queue.
+ * - `write_en` (`input`): Pushes `write_data` on the rising edge of `clk`. Ignored while `full`.
+ * - `write_data` (`input` [WIDTH-1:0]): Word to push.
+ * - `read_en` (`input`): Pops the word on `read_data` on the rising edge of `clk`. Ignored while
+ *                        `empty`.
+ * - `read_data` (`output` [WIDTH-1:0]): Oldest word, only meaningful while not `empty`.
+ * - `empty` (`output`): No words are queued.
+ * - `full` (`output`): `DEPTH` words are queued.
+ * - `count` (`output` [$clog2(DEPTH):0]): Number of words queued.
+ *
+ * **Behavior:**
+ * - A push and a pop in the same cycle are both taken, also while full, since the pop frees the
+ *   entry the push needs.
+ */
+
+`timescale 1ns / 1ps
+`default_nettype none
+
+`include "log.sv"
+
+module fifo #(
+    parameter int WIDTH = 8,
+    parameter int DEPTH = 16
+) (
+    input  wire                     clk,
+    input  wire                     reset,
+
+    input  wire                     write_en,
+    input  wire [WIDTH-1:0]         write_data,
+
+    input  wire                     read_en,
+    output wire [WIDTH-1:0]         read_data,
+
+    output wire                     empty,
+    output wire                     full,
+    output wire [$clog2(DEPTH):0]   count
+);
+
+initial begin
+    `ASSERT((DEPTH >= 2), "DEPTH must be 2 or more.");
+    `ASSERT(((DEPTH & (DEPTH - 1)) == 0), "DEPTH must be a power of 2.");
+end
+
+localparam int ADDR_WIDTH = $clog2(DEPTH);
+
+reg [WIDTH-1:0]    memory [0:DEPTH-1];
+reg [ADDR_WIDTH:0] write_ptr;
+reg [ADDR_WIDTH:0] read_ptr;
+
+wire do_read  = read_en && ~empty;
+wire do_write = write_en && (~full || do_read);
+
+assign read_data = memory[read_ptr[ADDR_WIDTH-1:0]];
+assign count     = write_ptr - read_ptr;
+assign empty     = (write_ptr == read_ptr);
+assign full      = (write_ptr[ADDR_WIDTH-1:0] == read_ptr[ADDR_WIDTH-1:0]) &&
+                   (write_ptr[ADDR_WIDTH] != read_ptr[ADDR_WIDTH]);
+
+always @(posedge clk or posedge reset) begin
+    if (reset) begin
+        write_ptr <= {(ADDR_WIDTH+1){1'b0}};
+        read_ptr  <= {(ADDR_WIDTH+1){1'b0}};
+    end else begin
+        if (do_write) begin
+            write_ptr <= write_ptr + 1'b1;
+        end
+        if (do_read) begin
+            read_ptr <= read_ptr + 1'b1;
+        end
+    end
+end
+
+// The words are not reset, so the array can map onto distributed RAM
+always @(posedge clk) begin
+    if (do_write) begin
+        memory[write_ptr[ADDR_WIDTH-1:0]] <= write_data;
+    end
+end
+endmodule
+
+`endif // __FIFO__
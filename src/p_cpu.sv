@@ -411,6 +411,40 @@ typedef enum logic [1:0] {
 } cpu_trap_state_t;
 cpu_state_t trap_state;
 
+// ──────────────────────────
+// Performance Counter Events
+// ──────────────────────────
+// mhpmcounter3: cycles in STATE_IF waiting on the instruction fetch
+// mhpmcounter4: cycles in STATE_MEM waiting on a load or store
+// mhpmcounter5: cycles in STATE_MUL_DIV
+// mhpmcounter6: traps taken
+// mhpmcounter7: conditional branches executed
+logic            perf_retire;
+logic [4:0]      perf_event;
+cpu_state_t      perf_last_state;
+
+always_ff @(posedge clk) begin
+    if (reset) perf_last_state <= STATE_RESET;
+    else       perf_last_state <= state;
+end
+
+// An instruction retires when it leaves for the next fetch. Only STATE_WB goes to STATE_TRAP
+// after finishing an instruction, for a pending interrupt; any other way in is an exception.
+assign perf_retire = (perf_last_state == STATE_EX || perf_last_state == STATE_MEM ||
+                      perf_last_state == STATE_WB
+                      `ifdef SUPPORT_M || perf_last_state == STATE_MUL_DIV `endif) &&
+                     (state == STATE_IF || (perf_last_state == STATE_WB && state == STATE_TRAP));
+
+assign perf_event[0] = (state == STATE_IF) && if_wait;
+assign perf_event[1] = (state == STATE_MEM) && mem_wait;
+`ifdef SUPPORT_M
+assign perf_event[2] = (state == STATE_MUL_DIV);
+`else
+assign perf_event[2] = 1'b0;
+`endif
+assign perf_event[3] = (state == STATE_TRAP) && (perf_last_state != STATE_TRAP);
+assign perf_event[4] = (state == STATE_WB) && is_branch;
+
 // ──────────────────────────
 // Instantiate CSR Module
 // ──────────────────────────
@@ -448,9 +482,14 @@ cpu_csr #(
     // Output Signals
     .interrupt_pending(interrupt_pending),
 
+    // Performance Counter Events
+    .perf_retire (perf_retire),      // minstret
+    .perf_event  (perf_event),       // mhpmcounter3..7
+
     // Interrupt Request Lines
     .irq         (external_irq),     // Standard IRQs
-    .nmi         (external_nmi)      // Non-Maskable IRQs (Edge-Triggered)
+    .nmi         (external_nmi),     // Non-Maskable IRQs (Edge-Triggered)
+    .timer_irq   (1'b0)              // No machine timer
 );
 `endif
 
@@ -124,6 +124,7 @@ block_ram #(
 	.write_en       (block_write_en),
 	.write_address  (block_write_address),
 	.write_data     (block_write_data),
+	.write_strb     ({(WIDTH/8){1'b1}}),
 	.read_address   (block_read_address),
 	.read_data      (block_read_data)
 );
@@ -39,12 +39,34 @@
  *   `mcause`.
  * - Halt Detection: Recognizes self-jump instructions (e.g., `jal x0, 0`) 
  *   to halt execution.
+ * - Wait For Interrupt: With SUPPORT_ZICSR, `wfi` parks the core in STATE_WFI
+ *   with no fetches until an interrupt enabled in `mie` is pending.
  *
  * Optional Extensions:
  * - SUPPORT_ZICSR: Enables access to Control and Status Registers for
  *                  managing exceptions and interrupts.
  * - SUPPORT_B: Adds bit manupulation operations via the BMU.
  * - SUPPORT_M: Adds multiplication and division operations via the MDU.
+ * - SUPPORT_C: Adds compressed instructions. Fetches are still aligned words, a 16-bit parcel
+ *              is expanded by `cpu_rvc` before decode, and the last fetched word is kept so a
+ *              second instruction in it needs no bus access.
+ * - BRANCH_PREDICT: Starts the fetch after a jump or branch while it is still in
+ *                   STATE_ID/STATE_EX/STATE_WB. `jal` fetches its target, a branch is predicted
+ *                   backward taken / forward not taken, and a `BTB_ENTRIES` branch target
+ *                   buffer of recently taken branches and `jalr` targets overrides that.
+ *                   On a wrong prediction STATE_IF waits for that fetch to finish and
+ *                   fetches again.
+ * - FUSED_EXU: Replaces `cpu_alu` and `cpu_bmu` with `cpu_exu`, one adder, shifter and counting
+ *              tree for the ALU and the Zba/Zbb/Zbs operations. The Zbc, Zbkx and draft BMU
+ *              instructions trap as illegal with it.
+ * - FAST_REGFILE: Reads the register file combinationally from the fetched instruction, so
+ *                 STATE_IF goes straight to STATE_EX. ALU instructions, `lui` and `auipc` are
+ *                 written back from STATE_EX and skip STATE_WB, two cycles less each.
+ * - SUPPORT_ZAAMO: Adds the Zaamo atomic memory operations (`amoswap`, `amoadd`, `amoand`,
+ *                  `amoor`, `amoxor`, `amomin[u]`, `amomax[u]`). STATE_MEM sends them as TL-UH
+ *                  `ArithmeticData`/`LogicalData` requests that the memory executes, so they
+ *                  are atomic between harts sharing a `tl_switch`. `lr`/`sc` trap as illegal.
+ *                  Not supported together with SUPPORT_DCACHE.
  *
  * Development Considerations:
  * - Simplicity: Focusing on clear state transitions without optimizations
@@ -70,11 +92,18 @@
  *   RISC-V core with optional extensions. Ensure that the memory interface 
  *   adheres to the TL-UL protocol and that optional extension parameters 
  *   (`SUPPORT_ZICSR`, `SUPPORT_B`, `SUPPORT_M`) are configured as 
- *   needed.
+ *   needed. `SUPPORT_ICACHE` places `cpu_icache` (sized by `ICACHE_SIZE` and
+ *   `ICACHE_LINE`) between the fetch path and `tl_interface` and makes
+ *   `fence.i` invalidate it. `SUPPORT_DCACHE` adds the write-through
+ *   `cpu_dcache` with its store buffer on the load/store path; addresses
+ *   outside `DCACHE_BASE`/`DCACHE_MASK` are not cached. `SUPPORT_TCM` puts the
+ *   `cpu_tcm` scratchpad (`TCM_SIZE` bytes at `TCM_BASE`, preloaded from
+ *   `TCM_INIT`) in front of both, loads and stores to it never reach the bus.
  * - Simulation: Ideal for educational simulations and testing scenarios 
  *   where a clear, step-by-step instruction flow is beneficial. Utilize the 
  *   debug outputs (`dbg_halt`, `dbg_pc`, `dbg_x1`, `dbg_x2`, 
- *   `dbg_x3`) for monitoring CPU state during simulations.
+ *   `dbg_x3`) for monitoring CPU state during simulations. `dbg_retire`, `dbg_retire_pc`,
+ *   `dbg_retire_instr` and `dbg_state` feed the retire trace of `etc/runsim.cpp`.
  *
  * @note The CPU's design emphasizes clarity and over performance and
  *       completeness. It serves as a foundational model for understanding
@@ -98,6 +127,47 @@
 `ifdef SUPPORT_B
 `include "cpu_bmu.sv"
 `endif
+`ifdef FUSED_EXU
+`include "cpu_exu.sv"
+`endif
+`ifdef SUPPORT_C
+`include "cpu_rvc.sv"
+`endif
+`ifdef SUPPORT_ICACHE
+`include "cpu_icache.sv"
+`endif
+`ifdef SUPPORT_DCACHE
+`include "cpu_dcache.sv"
+`endif
+`ifdef SUPPORT_TCM
+`include "cpu_tcm.sv"
+`endif
+
+// fence and fence.i are executed (instead of trapping) when a cache has to observe them
+`ifdef SUPPORT_ICACHE
+`define CPU_EXEC_FENCE
+`endif
+`ifdef SUPPORT_DCACHE
+`ifndef CPU_EXEC_FENCE
+`define CPU_EXEC_FENCE
+`endif
+`endif
+
+// The state a fetched instruction goes to, FAST_REGFILE needs no STATE_ID to read registers
+`ifdef FAST_REGFILE
+`define CPU_DECODE_STATE STATE_EX
+`else
+`define CPU_DECODE_STATE STATE_ID
+`endif
+
+// Default MDU implementation, MDU_FAST selects the DSP multiplier and radix-4 divider
+`ifndef CPU_MDU_IMPL
+`ifdef MDU_FAST
+`define CPU_MDU_IMPL 1
+`else
+`define CPU_MDU_IMPL 0
+`endif
+`endif
 
 module tl_cpu #(
     parameter MHARTID_VAL     = 32'h0000_0000,  // The Hardware ID for the CPU
@@ -106,14 +176,28 @@ module tl_cpu #(
     parameter START_ADDRESS   = 32'h8000_0000,  // Default start address
     parameter MTVEC_RESET_VAL = 32'h8000_0000,  // Default mtvec address
     parameter NMI_COUNT       = 1,              // Number of NMIs (must satisfy XLEN > IRQ_COUNT + NMI_COUNT)
-    parameter IRQ_COUNT       = 1               // Number of standard IRQs (must satisfy XLEN > IRQ_COUNT + NMI_COUNT)
+    parameter IRQ_COUNT       = 1,              // Number of standard IRQs (must satisfy XLEN > IRQ_COUNT + NMI_COUNT)
+    parameter ICACHE_SIZE     = 1024,           // Instruction cache size in bytes (SUPPORT_ICACHE)
+    parameter ICACHE_LINE     = 16,             // Instruction cache line size in bytes (SUPPORT_ICACHE)
+    parameter DCACHE_SIZE     = 1024,           // Data cache size in bytes (SUPPORT_DCACHE)
+    parameter DCACHE_LINE     = 16,             // Data cache line size in bytes (SUPPORT_DCACHE)
+    parameter DCACHE_SB_DEPTH = 4,              // Store buffer entries (SUPPORT_DCACHE)
+    parameter DCACHE_BASE     = 32'h0000_0000,  // Cacheable window base (SUPPORT_DCACHE)
+    parameter DCACHE_MASK     = 32'h0000_FFFF,  // Cacheable window address mask (SUPPORT_DCACHE)
+    parameter TCM_SIZE        = 4096,           // Scratchpad size in bytes (SUPPORT_TCM)
+    parameter TCM_BASE        = 32'h0010_0000,  // Scratchpad base address (SUPPORT_TCM)
+    parameter TCM_INIT        = "",             // Scratchpad $readmemh image (SUPPORT_TCM)
+    parameter MDU_IMPL        = `CPU_MDU_IMPL,  // MDU implementation, see cpu_mdu.sv (SUPPORT_M)
+    parameter MDU_MUL_STAGES  = 2,              // Multiplier register stages, 1 to 3 (SUPPORT_M)
+    parameter BTB_ENTRIES     = 8               // Branch target buffer entries, 0 or a power of two (BRANCH_PREDICT)
 ) (
     input wire                  clk,
     input wire                  reset,
 
     `ifdef SUPPORT_ZICSR
-    input wire                  external_irq, // Interrupt Request Lines
-    input wire                  external_nmi, // Non-Maskable Interrupt
+    input wire [IRQ_COUNT-1:0]  external_irq, // Interrupt Request Lines
+    input wire [NMI_COUNT-1:0]  external_nmi, // Non-Maskable Interrupt
+    input wire                  external_timer, // Machine Timer Interrupt
     `endif
 
     // TileLink TL-UL Interface signals
@@ -150,6 +234,10 @@ module tl_cpu #(
     ,output wire [XLEN-1:0]       dbg_x1
     ,output wire [XLEN-1:0]       dbg_x2
     ,output wire [XLEN-1:0]       dbg_x3
+    ,output wire                  dbg_retire
+    ,output wire [XLEN-1:0]       dbg_retire_pc    // Address of the instruction retiring
+    ,output wire [31:0]           dbg_retire_instr // and its instruction word
+    ,output wire [3:0]            dbg_state
     `endif
 );
 
@@ -165,6 +253,7 @@ typedef enum logic [3:0] {
     STATE_EX    = 4'b0011,  // Execute
     STATE_MEM   = 4'b0100,  // Memory Access
     STATE_WB    = 4'b0101,  // Write Back
+    STATE_WFI   = 4'b0110,  // Wait For Interrupt
     STATE_TRAP  = 4'b0111   // Trap Handling
     `ifdef SUPPORT_M
     ,STATE_MUL_DIV   // Multiplication and Division Operations
@@ -201,6 +290,7 @@ trap_cause_t trap_cause;
 // Internal Registers and Signals
 // ──────────────────────────
 logic [XLEN-1:0] pc;
+logic [XLEN-1:0] pc_next;  // Address of the instruction after the current one
 logic [31:0]     instr;
 logic            halt;
 logic [5:0]      test_cpu_reg;
@@ -232,6 +322,9 @@ logic            is_system;
 `ifdef SUPPORT_M
 logic            is_mul_div;
 `endif
+`ifdef SUPPORT_ZAAMO
+logic            is_amo;
+`endif
 
 // ──────────────────────────
 // Instantiate Instruction Decoder
@@ -258,6 +351,9 @@ cpu_insdecode #(.XLEN(XLEN)) instr_decoder_inst (
     `ifdef SUPPORT_M
     ,.is_mul_div(is_mul_div)
     `endif
+    `ifdef SUPPORT_ZAAMO
+    ,.is_amo  (is_amo)
+    `endif
 );
 
 // ──────────────────────────
@@ -275,7 +371,16 @@ logic [XLEN-1:0] dbg_rf_x1, dbg_rf_x2, dbg_rf_x3;
 // ──────────────────────────
 // Instantiate Register File
 // ──────────────────────────
+`ifdef FAST_REGFILE
+// The source registers come straight from the instruction, STATE_EX reads them in the cycle
+// after the fetch
+assign rs1_addr = rs1;
+assign rs2_addr = rs2;
+
+cpu_regfile #(.XLEN(XLEN), .BYPASS(1)) reg_file_inst (
+`else
 cpu_regfile #(.XLEN(XLEN)) reg_file_inst (
+`endif
     .clk        (clk),
     .reset      (reset),
     .rs1_addr   (rs1_addr),
@@ -298,8 +403,11 @@ assign dbg_x1   = dbg_rf_x1;
 assign dbg_x2   = dbg_rf_x2;
 assign dbg_x3   = dbg_rf_x3;
 assign dbg_pc   = pc;
+assign dbg_retire = perf_retire;
+`ifndef SUPPORT_DCACHE
 assign dbg_halt = halt;
 `endif
+`endif
 
 // ──────────────────────────
 // ALU Signals
@@ -310,35 +418,148 @@ logic [XLEN-1:0] alu_result;
 logic            alu_zero;
 logic            alu_less_than;
 logic            alu_unsigned_less_than;
+logic [XLEN-1:0] alu_in_a, alu_in_b;
+logic [3:0]      alu_in_control;
+
+`ifdef FAST_REGFILE
+// ──────────────────────────
+// Fast ALU Path
+// ──────────────────────────
+// Register and immediate ALU instructions, lui and auipc take their operands from the register
+// file reads in STATE_EX and the ALU result is written back from there. Other instructions,
+// including the W forms, M and B, keep the registered operands and STATE_WB.
+logic            fast_alu_op;
+logic [3:0]      fast_alu_control;
+logic [XLEN-1:0] fast_operand_a, fast_operand_b;
+logic            fast_shamt_ok;   // Shift amount is less than XLEN
+
+assign fast_shamt_ok = (XLEN >= 64) || ~instr[25];
+
+always_comb begin
+    fast_alu_op      = 1'b0;
+    fast_alu_control = `ALU_ADD;
+    fast_operand_a   = rs1_data;
+    fast_operand_b   = imm;
+
+    if (is_lui || is_auipc) begin
+        fast_alu_op    = 1'b1;
+        fast_operand_a = is_lui ? {XLEN{1'b0}} : pc;
+    end else if (opcode == 7'b0110011) begin
+        fast_operand_b = rs2_data;
+        case (funct3)
+            3'b000: begin
+                fast_alu_op      = (funct7 == 7'b0000000 || funct7 == 7'b0100000);
+                fast_alu_control = funct7[5] ? `ALU_SUB : `ALU_ADD;
+            end
+            3'b001: begin fast_alu_op = (funct7 == 7'b0000000); fast_alu_control = `ALU_SLL; end
+            3'b010: begin fast_alu_op = (funct7 == 7'b0000000); fast_alu_control = `ALU_SLT; end
+            3'b011: begin fast_alu_op = (funct7 == 7'b0000000); fast_alu_control = `ALU_SLTU; end
+            3'b100: begin fast_alu_op = (funct7 == 7'b0000000); fast_alu_control = `ALU_XOR; end
+            3'b101: begin
+                fast_alu_op      = (funct7 == 7'b0000000 || funct7 == 7'b0100000);
+                fast_alu_control = funct7[5] ? `ALU_SRA : `ALU_SRL;
+            end
+            3'b110: begin fast_alu_op = (funct7 == 7'b0000000); fast_alu_control = `ALU_OR; end
+            3'b111: begin fast_alu_op = (funct7 == 7'b0000000); fast_alu_control = `ALU_AND; end
+        endcase
+    end else if (opcode == 7'b0010011) begin
+        case (funct3)
+            3'b000: begin fast_alu_op = 1'b1; fast_alu_control = `ALU_ADD; end
+            3'b001: begin
+                fast_alu_op      = (instr[31:26] == 6'b000000) && fast_shamt_ok;
+                fast_alu_control = `ALU_SLL;
+            end
+            3'b010: begin fast_alu_op = 1'b1; fast_alu_control = `ALU_SLT; end
+            3'b011: begin fast_alu_op = 1'b1; fast_alu_control = `ALU_SLTU; end
+            3'b100: begin fast_alu_op = 1'b1; fast_alu_control = `ALU_XOR; end
+            3'b101: begin
+                fast_alu_op      = (instr[31:26] == 6'b000000 || instr[31:26] == 6'b010000) &&
+                                   fast_shamt_ok;
+                fast_alu_control = instr[30] ? `ALU_SRA : `ALU_SRL;
+            end
+            3'b110: begin fast_alu_op = 1'b1; fast_alu_control = `ALU_OR; end
+            3'b111: begin fast_alu_op = 1'b1; fast_alu_control = `ALU_AND; end
+        endcase
+    end
+end
+
+assign alu_in_a       = (state == STATE_EX) ? fast_operand_a   : alu_operand_a;
+assign alu_in_b       = (state == STATE_EX) ? fast_operand_b   : alu_operand_b;
+assign alu_in_control = (state == STATE_EX) ? fast_alu_control : alu_control;
+`else
+assign alu_in_a       = alu_operand_a;
+assign alu_in_b       = alu_operand_b;
+assign alu_in_control = alu_control;
+`endif
 
+`ifndef FUSED_EXU
 // ──────────────────────────
 // Instantiate ALU
 // ──────────────────────────
 cpu_alu #(.XLEN(XLEN)) alu_inst (
-    .operand_a          (alu_operand_a),
-    .operand_b          (alu_operand_b),
-    .control            (alu_control),
+    .operand_a          (alu_in_a),
+    .operand_b          (alu_in_b),
+    .control            (alu_in_control),
     .result             (alu_result),
     .zero               (alu_zero),
     .less_than          (alu_less_than),
     .unsigned_less_than (alu_unsigned_less_than)
 );
+`endif
 
 `ifdef SUPPORT_B
 // ──────────────────────────
 // BMU Signals
 // ──────────────────────────
 logic [XLEN-1:0] bmu_operand_a, bmu_operand_b;
-logic [3:0]      bmu_control;
+logic [5:0]      bmu_control;
 logic [XLEN-1:0] bmu_result;
 
-cpu_alu #(.XLEN(XLEN)) bmu_inst (
+`ifndef FUSED_EXU
+cpu_bmu #(.XLEN(XLEN)) bmu_inst (
     .operand_a          (bmu_operand_a),
     .operand_b          (bmu_operand_b),
     .control            (bmu_control),
     .result             (bmu_result)
 );
 `endif
+`endif
+
+`ifdef FUSED_EXU
+// ──────────────────────────
+// Instantiate EXU
+// ──────────────────────────
+// Takes the place of cpu_alu and cpu_bmu. Only STATE_WB of a BMU instruction reads bmu_result,
+// so the EXU is on the BMU operands there and on the ALU operands in every other state.
+logic            exu_bmu_select;
+logic [5:0]      exu_bmu_control;
+logic [XLEN-1:0] exu_operand_a, exu_operand_b;
+
+`ifdef SUPPORT_B
+assign exu_bmu_select  = (state == STATE_WB) && (work_unit == BMU);
+assign exu_bmu_control = bmu_control;
+assign exu_operand_a   = exu_bmu_select ? bmu_operand_a : alu_in_a;
+assign exu_operand_b   = exu_bmu_select ? bmu_operand_b : alu_in_b;
+assign bmu_result      = alu_result;
+`else
+assign exu_bmu_select  = 1'b0;
+assign exu_bmu_control = 6'b0;
+assign exu_operand_a   = alu_in_a;
+assign exu_operand_b   = alu_in_b;
+`endif
+
+cpu_exu #(.XLEN(XLEN)) exu_inst (
+    .operand_a          (exu_operand_a),
+    .operand_b          (exu_operand_b),
+    .alu_control        (alu_in_control),
+    .bmu_control        (exu_bmu_control),
+    .bmu_select         (exu_bmu_select),
+    .result             (alu_result),
+    .zero               (alu_zero),
+    .less_than          (alu_less_than),
+    .unsigned_less_than (alu_unsigned_less_than)
+);
+`endif
 
 `ifdef SUPPORT_M
 // ──────────────────────────
@@ -353,7 +574,11 @@ logic            mdu_ready;
 // ──────────────────────────
 // Instantiate MDU
 // ──────────────────────────
-cpu_mdu #(.XLEN(XLEN)) mdu_inst (
+cpu_mdu #(
+    .XLEN(XLEN),
+    .MDU_IMPL(MDU_IMPL),
+    .MUL_STAGES(MDU_MUL_STAGES)
+) mdu_inst (
     .clk                (clk),
     .reset              (reset),
     .operand_a          (mdu_operand_a),
@@ -379,20 +604,185 @@ logic [XLEN-1:0]        mem_rdata;
 logic                   mem_valid;
 logic                   mem_denied;
 logic                   mem_corrupt;
+`ifdef SUPPORT_ZAAMO
+logic [2:0]             mem_amo_opcode; // TileLink atomic of the AMO in STATE_MEM, 0 otherwise
+logic [2:0]             mem_amo_param;
+`endif
 
+`ifdef SUPPORT_C
+// ──────────────────────────
+// Compressed Instruction Fetch
+// ──────────────────────────
+// Instructions are fetched as aligned words. The last word fetched is kept, so when the next
+// instruction is in the same word, e.g. the upper half after a compressed one, it is taken from
+// there. A 32-bit instruction in the upper half of a word needs the lower half of the next word
+// as well, its first half waits in fetch_lo while that word is fetched.
+logic            instr_c;          // Current instruction is compressed
+logic            fetch_buf_valid;
+logic [XLEN-1:0] fetch_buf_addr;
+logic [31:0]     fetch_buf_data;
+logic            fetch_split;      // Fetching the second half of a 32-bit instruction
+logic [15:0]     fetch_lo;         // First half of that instruction
+logic [XLEN-1:0] fetch_word;       // Aligned word holding pc
+logic            fetch_buf_hit;    // The parcel at pc is in the fetch buffer
+logic            fetch_buf_whole;  // ...and so is the rest of its instruction
+logic [31:0]     fetch_word_data;
+logic [31:0]     fetch_raw;
+logic [31:0]     fetch_instr;
+logic            fetch_compressed;
+logic            fetch_illegal;
+
+assign fetch_word      = {pc[XLEN-1:2], 2'b00};
+assign fetch_buf_hit   = fetch_buf_valid && (fetch_buf_addr == fetch_word);
+assign fetch_buf_whole = ~pc[1] || (fetch_buf_data[17:16] != 2'b11);
+assign fetch_word_data = mem_valid ? mem_rdata[31:0] : fetch_buf_data;
+assign fetch_raw       = fetch_split ? {fetch_word_data[15:0], fetch_lo} :
+                         pc[1]       ? {16'h0000, fetch_word_data[31:16]} :
+                                       fetch_word_data;
+assign pc_next         = instr_c ? pc + 2 : pc + 4;
+
+cpu_rvc #(.XLEN(XLEN)) rvc_inst (
+    .instr_in   (fetch_raw),
+    .instr      (fetch_instr),
+    .compressed (fetch_compressed),
+    .illegal    (fetch_illegal)
+);
+`else
+assign pc_next = pc + 4;
+`endif
 
+`ifdef BRANCH_PREDICT
 // ──────────────────────────
-// Instantiate Memory Interface
+// Branch Prediction
 // ──────────────────────────
-tl_interface #(
+// The bus is idle while a jump or branch goes through STATE_ID, STATE_EX and STATE_WB, so the
+// fetch of the predicted next instruction is started in STATE_ID (STATE_EX with FAST_REGFILE,
+// which has no STATE_ID). The response is kept in
+// pf_data (or the compressed fetch buffer) and STATE_IF uses it when pc matches.
+localparam BTB_INDEX = (BTB_ENTRIES > 1) ? $clog2(BTB_ENTRIES) : 1;
+localparam BTB_SIZE  = (BTB_ENTRIES > 1) ? BTB_ENTRIES : 1;
+`ifdef SUPPORT_C
+localparam BTB_SHIFT = 1;
+`else
+localparam BTB_SHIFT = 2;
+`endif
+
+initial begin
+    `ASSERT((BTB_ENTRIES == 0 || (BTB_ENTRIES & (BTB_ENTRIES - 1)) == 0), "BTB_ENTRIES must be 0 or a power of two.");
+end
+
+logic                 pf_wait;         // Predicted fetch is on the bus
+logic [XLEN-1:0]      pf_addr;         // Word being fetched
+`ifndef SUPPORT_C
+logic                 pf_valid;
+logic [31:0]          pf_data;
+`endif
+logic [BTB_SIZE-1:0]  btb_valid;
+logic [XLEN-1:0]      btb_pc     [0:BTB_SIZE-1];
+logic [XLEN-1:0]      btb_target [0:BTB_SIZE-1];
+logic [BTB_INDEX-1:0] btb_index;
+logic                 btb_hit;
+logic                 bp_taken;        // Instruction being decoded is predicted to jump
+logic [XLEN-1:0]      bp_next;         // Predicted address of the next instruction
+logic [XLEN-1:0]      bp_word;         // Aligned word holding bp_next
+logic                 bp_fetch;        // Start the fetch of bp_word
+
+assign btb_index = pc[BTB_SHIFT +: BTB_INDEX];
+assign btb_hit   = (BTB_ENTRIES != 0) && btb_valid[btb_index] && (btb_pc[btb_index] == pc);
+assign bp_taken  = is_jal || ((is_branch || is_jalr) && btb_hit) || (is_branch && imm[XLEN-1]);
+assign bp_next   = ~bp_taken                ? pc_next :
+                   (btb_hit && ~is_jal)     ? btb_target[btb_index] :
+                                              pc + imm;
+assign bp_word   = {bp_next[XLEN-1:2], 2'b00};
+
+// jalr without a BTB entry has no prediction, a self jump halts and misaligned targets trap
+assign bp_fetch  = (is_jal || is_branch || (is_jalr && btb_hit)) && (bp_next != pc) &&
+                   `ifdef SUPPORT_C
+                   ~bp_next[0] && ~(fetch_buf_valid && fetch_buf_addr == bp_word);
+                   `else
+                   (bp_next[1:0] == 2'b00);
+                   `endif
+`endif
+
+// Instruction fetches, for the caches
+logic            mem_fetch;
+`ifdef BRANCH_PREDICT
+assign mem_fetch = (state == STATE_IF) || pf_wait;
+`else
+assign mem_fetch = (state == STATE_IF);
+`endif
+
+
+// ──────────────────────────
+// tl_interface CPU Side Signals
+// ──────────────────────────
+logic                   bus_ready;
+logic [XLEN-1:0]        bus_address;
+logic [XLEN-1:0]        bus_wdata;
+logic [XLEN/8-1:0]      bus_wstrb;
+logic [2:0]             bus_size;
+logic                   bus_read;
+logic                   bus_ack;
+logic [XLEN-1:0]        bus_rdata;
+logic                   bus_valid;
+logic                   bus_denied;
+logic                   bus_corrupt;
+
+// ──────────────────────────
+// Instruction Cache Side Signals
+// ──────────────────────────
+logic                   ic_ready;
+logic                   ic_fetch;
+logic [XLEN-1:0]        ic_address;
+logic [XLEN-1:0]        ic_wdata;
+logic [XLEN/8-1:0]      ic_wstrb;
+logic [2:0]             ic_size;
+logic                   ic_read;
+logic                   ic_ack;
+logic [XLEN-1:0]        ic_rdata;
+logic                   ic_valid;
+logic                   ic_denied;
+logic                   ic_corrupt;
+
+// ──────────────────────────
+// Data Cache Side Signals
+// ──────────────────────────
+logic                   dc_ready;
+logic                   dc_fetch;
+logic [XLEN-1:0]        dc_address;
+logic [XLEN-1:0]        dc_wdata;
+logic [XLEN/8-1:0]      dc_wstrb;
+logic [2:0]             dc_size;
+logic                   dc_read;
+logic                   dc_ack;
+logic [XLEN-1:0]        dc_rdata;
+logic                   dc_valid;
+logic                   dc_denied;
+logic                   dc_corrupt;
+
+`ifdef SUPPORT_TCM
+// ──────────────────────────
+// Instantiate Scratchpad Memory
+// ──────────────────────────
+logic [XLEN-1:0]        tcm_accesses;
+
+cpu_tcm #(
     .XLEN(XLEN),
-    .SID_WIDTH(SID_WIDTH)
-) mem_if_inst (
+    .SIZE(TCM_SIZE),
+    .BASE(TCM_BASE),
+    .INIT_FILE(TCM_INIT)
+) tcm_inst (
     .clk         (clk),
     .reset       (reset),
 
     // CPU Side
     .cpu_ready   (mem_ready),
+    .cpu_fetch   (mem_fetch),
+    `ifdef SUPPORT_ZAAMO
+    .cpu_bypass  (mem_amo_opcode != 3'b000),
+    `else
+    .cpu_bypass  (1'b0),
+    `endif
     .cpu_address (mem_address),
     .cpu_wdata   (mem_wdata),
     .cpu_wstrb   (mem_wstrb),
@@ -404,6 +794,199 @@ tl_interface #(
     .cpu_corrupt (mem_corrupt),
     .cpu_valid   (mem_valid),
 
+    // Instruction Cache Side
+    .if_ready    (ic_ready),
+    .if_fetch    (ic_fetch),
+    .if_address  (ic_address),
+    .if_wdata    (ic_wdata),
+    .if_wstrb    (ic_wstrb),
+    .if_size     (ic_size),
+    .if_read     (ic_read),
+    .if_ack      (ic_ack),
+    .if_rdata    (ic_rdata),
+    .if_denied   (ic_denied),
+    .if_corrupt  (ic_corrupt),
+    .if_valid    (ic_valid),
+
+    .access_count(tcm_accesses)
+);
+`else
+assign ic_ready    = mem_ready;
+assign ic_fetch    = mem_fetch;
+assign ic_address  = mem_address;
+assign ic_wdata    = mem_wdata;
+assign ic_wstrb    = mem_wstrb;
+assign ic_size     = mem_size;
+assign ic_read     = mem_read;
+assign mem_ack     = ic_ack;
+assign mem_rdata   = ic_rdata;
+assign mem_valid   = ic_valid;
+assign mem_denied  = ic_denied;
+assign mem_corrupt = ic_corrupt;
+`endif
+
+`ifdef SUPPORT_ICACHE
+// ──────────────────────────
+// Instantiate Instruction Cache
+// ──────────────────────────
+logic                   icache_invalidate;
+logic [XLEN-1:0]        icache_hits;
+logic [XLEN-1:0]        icache_misses;
+
+cpu_icache #(
+    .XLEN(XLEN),
+    .SIZE(ICACHE_SIZE),
+    .LINE(ICACHE_LINE)
+) icache_inst (
+    .clk         (clk),
+    .reset       (reset),
+
+    // Scratchpad Side
+    .cpu_ready   (ic_ready),
+    .cpu_fetch   (ic_fetch),
+    .cpu_address (ic_address),
+    .cpu_wdata   (ic_wdata),
+    .cpu_wstrb   (ic_wstrb),
+    .cpu_size    (ic_size),
+    .cpu_read    (ic_read),
+    .cpu_ack     (ic_ack),
+    .cpu_rdata   (ic_rdata),
+    .cpu_denied  (ic_denied),
+    .cpu_corrupt (ic_corrupt),
+    .cpu_valid   (ic_valid),
+
+    // Data Cache / tl_interface Side
+    .if_ready    (dc_ready),
+    .if_fetch    (dc_fetch),
+    .if_address  (dc_address),
+    .if_wdata    (dc_wdata),
+    .if_wstrb    (dc_wstrb),
+    .if_size     (dc_size),
+    .if_read     (dc_read),
+    .if_ack      (dc_ack),
+    .if_rdata    (dc_rdata),
+    .if_denied   (dc_denied),
+    .if_corrupt  (dc_corrupt),
+    .if_valid    (dc_valid),
+
+    .invalidate  (icache_invalidate),
+    .hit_count   (icache_hits),
+    .miss_count  (icache_misses)
+);
+`else
+assign dc_ready    = ic_ready;
+assign dc_fetch    = ic_fetch;
+assign dc_address  = ic_address;
+assign dc_wdata    = ic_wdata;
+assign dc_wstrb    = ic_wstrb;
+assign dc_size     = ic_size;
+assign dc_read     = ic_read;
+assign ic_ack      = dc_ack;
+assign ic_rdata    = dc_rdata;
+assign ic_valid    = dc_valid;
+assign ic_denied   = dc_denied;
+assign ic_corrupt  = dc_corrupt;
+`endif
+
+`ifdef SUPPORT_DCACHE
+// ──────────────────────────
+// Instantiate Data Cache
+// ──────────────────────────
+logic                   dcache_fence;
+logic                   dcache_drained;
+logic [XLEN-1:0]        dcache_hits;
+logic [XLEN-1:0]        dcache_misses;
+
+cpu_dcache #(
+    .XLEN(XLEN),
+    .SIZE(DCACHE_SIZE),
+    .LINE(DCACHE_LINE),
+    .SB_DEPTH(DCACHE_SB_DEPTH),
+    .CACHED_BASE(DCACHE_BASE),
+    .CACHED_MASK(DCACHE_MASK)
+) dcache_inst (
+    .clk         (clk),
+    .reset       (reset),
+
+    // Instruction Cache Side
+    .cpu_ready   (dc_ready),
+    .cpu_fetch   (dc_fetch),
+    .cpu_address (dc_address),
+    .cpu_wdata   (dc_wdata),
+    .cpu_wstrb   (dc_wstrb),
+    .cpu_size    (dc_size),
+    .cpu_read    (dc_read),
+    .cpu_ack     (dc_ack),
+    .cpu_rdata   (dc_rdata),
+    .cpu_denied  (dc_denied),
+    .cpu_corrupt (dc_corrupt),
+    .cpu_valid   (dc_valid),
+
+    // tl_interface Side
+    .if_ready    (bus_ready),
+    .if_address  (bus_address),
+    .if_wdata    (bus_wdata),
+    .if_wstrb    (bus_wstrb),
+    .if_size     (bus_size),
+    .if_read     (bus_read),
+    .if_ack      (bus_ack),
+    .if_rdata    (bus_rdata),
+    .if_denied   (bus_denied),
+    .if_corrupt  (bus_corrupt),
+    .if_valid    (bus_valid),
+
+    .fence       (dcache_fence),
+    .drained     (dcache_drained),
+    .hit_count   (dcache_hits),
+    .miss_count  (dcache_misses)
+);
+
+// Report the halt once every buffered store has reached memory
+assign dbg_halt = halt && dcache_drained;
+`else
+assign bus_ready   = dc_ready;
+assign bus_address = dc_address;
+assign bus_wdata   = dc_wdata;
+assign bus_wstrb   = dc_wstrb;
+assign bus_size    = dc_size;
+assign bus_read    = dc_read;
+assign dc_ack      = bus_ack;
+assign dc_rdata    = bus_rdata;
+assign dc_valid    = bus_valid;
+assign dc_denied   = bus_denied;
+assign dc_corrupt  = bus_corrupt;
+`endif
+
+// ──────────────────────────
+// Instantiate Memory Interface
+// ──────────────────────────
+tl_interface #(
+    .XLEN(XLEN),
+    .SID_WIDTH(SID_WIDTH)
+) mem_if_inst (
+    .clk         (clk),
+    .reset       (reset),
+
+    // CPU Side
+    .cpu_ready   (bus_ready),
+    .cpu_address (bus_address),
+    .cpu_wdata   (bus_wdata),
+    .cpu_wstrb   (bus_wstrb),
+    .cpu_size    (bus_size),
+    .cpu_read    (bus_read),
+    `ifdef SUPPORT_ZAAMO
+    .cpu_amo_opcode(mem_amo_opcode),
+    .cpu_amo_param (mem_amo_param),
+    `else
+    .cpu_amo_opcode(3'b000),
+    .cpu_amo_param (3'b000),
+    `endif
+    .cpu_ack     (bus_ack),
+    .cpu_rdata   (bus_rdata),
+    .cpu_denied  (bus_denied),
+    .cpu_corrupt (bus_corrupt),
+    .cpu_valid   (bus_valid),
+
     // TileLink TL-UL Interface signals
     .tl_a_valid  (tl_a_valid),
     .tl_a_ready  (tl_a_ready),
@@ -426,6 +1009,55 @@ tl_interface #(
     .tl_d_denied (tl_d_denied)
 );
 
+`ifdef SUPPORT_ZAAMO
+`ifdef SUPPORT_DCACHE
+// The store buffer would post an AMO like a store, without its old value
+initial begin
+    `ASSERT(0, "SUPPORT_ZAAMO cannot be combined with SUPPORT_DCACHE.");
+end
+`endif
+`endif
+
+// ──────────────────────────
+// Instruction Retirement
+// ──────────────────────────
+// Feeds minstret with SUPPORT_ZICSR and dbg_retire with DEBUG
+logic            perf_retire;
+cpu_state_t      perf_last_state;
+
+always_ff @(posedge clk) begin
+    if (reset) perf_last_state <= STATE_RESET;
+    else       perf_last_state <= state;
+end
+
+// An instruction retires when it leaves for the next fetch. Only STATE_WB and STATE_WFI go to
+// STATE_TRAP after finishing an instruction, for a pending interrupt; any other way in is an
+// exception. With FAST_REGFILE STATE_EX also does, told apart by trap_cause.
+assign perf_retire = (perf_last_state == STATE_EX || perf_last_state == STATE_MEM ||
+                      perf_last_state == STATE_WB || perf_last_state == STATE_WFI
+                      `ifdef SUPPORT_M || perf_last_state == STATE_MUL_DIV `endif) &&
+                     (state == STATE_IF || ((perf_last_state == STATE_WB || perf_last_state == STATE_WFI) &&
+                                            state == STATE_TRAP)
+                      `ifdef FAST_REGFILE
+                      || (perf_last_state == STATE_EX && state == STATE_TRAP &&
+                          trap_cause == TRAP_INTERRUPT)
+                      `endif
+                     );
+
+`ifdef DEBUG
+// pc already points at the next instruction while dbg_retire is high, so the retire trace gets
+// the address latched while the instruction was fetched. instr still holds the retiring one.
+logic [XLEN-1:0] dbg_fetch_pc;
+
+always_ff @(posedge clk) begin
+    if (state == STATE_IF) dbg_fetch_pc <= pc;
+end
+
+assign dbg_retire_pc    = dbg_fetch_pc;
+assign dbg_retire_instr = instr;
+assign dbg_state        = state;
+`endif
+
 `ifdef SUPPORT_ZICSR
 // ──────────────────────────
 // CSR Module Signals
@@ -450,6 +1082,7 @@ logic [XLEN-1:0] csr_mcause;     // Machine Cause Register
 
 // Interrupt CSRs
 logic            interrupt_pending;
+logic            interrupt_waiting;
 
 typedef enum logic [1:0] {
     STORE_PC,
@@ -458,6 +1091,26 @@ typedef enum logic [1:0] {
 } cpu_trap_state_t;
 cpu_state_t trap_state;
 
+// ──────────────────────────
+// Performance Counter Events
+// ──────────────────────────
+// mhpmcounter3: cycles in STATE_IF waiting on the instruction fetch
+// mhpmcounter4: cycles in STATE_MEM waiting on a load or store
+// mhpmcounter5: cycles in STATE_MUL_DIV
+// mhpmcounter6: traps taken
+// mhpmcounter7: conditional branches executed
+logic [4:0]      perf_event;
+
+assign perf_event[0] = (state == STATE_IF) && if_wait;
+assign perf_event[1] = (state == STATE_MEM) && mem_wait;
+`ifdef SUPPORT_M
+assign perf_event[2] = (state == STATE_MUL_DIV);
+`else
+assign perf_event[2] = 1'b0;
+`endif
+assign perf_event[3] = (state == STATE_TRAP) && (perf_last_state != STATE_TRAP);
+assign perf_event[4] = (state == STATE_WB) && is_branch;
+
 // ──────────────────────────
 // Instantiate CSR Module
 // ──────────────────────────
@@ -494,10 +1147,16 @@ cpu_csr #(
 
     // Output Signals
     .interrupt_pending(interrupt_pending),
+    .interrupt_waiting(interrupt_waiting),
+
+    // Performance Counter Events
+    .perf_retire (perf_retire),      // minstret
+    .perf_event  (perf_event),       // mhpmcounter3..7
 
     // Interrupt Request Lines
     .irq         (external_irq),     // Standard IRQs
-    .nmi         (external_nmi)      // Non-Maskable IRQs (Edge-Triggered)
+    .nmi         (external_nmi),     // Non-Maskable IRQs (Edge-Triggered)
+    .timer_irq   (external_timer)    // Machine Timer Interrupt
 );
 `endif
 
@@ -513,6 +1172,18 @@ always_ff @(posedge clk) begin
     if (reset) begin
         state               <= STATE_IF;
         pc                  <= START_ADDRESS;
+        `ifdef SUPPORT_C
+        instr_c             <= 1'b0;
+        fetch_buf_valid     <= 1'b0;
+        fetch_split         <= 1'b0;
+        `endif
+        `ifdef BRANCH_PREDICT
+        pf_wait             <= 1'b0;
+        `ifndef SUPPORT_C
+        pf_valid            <= 1'b0;
+        `endif
+        btb_valid           <= {BTB_SIZE{1'b0}};
+        `endif
         trap_cause          <= TRAP_UNKNOWN;
         trap_reg            <= 1'b0;
         rd_write_en         <= 1'b0;
@@ -529,6 +1200,16 @@ always_ff @(posedge clk) begin
         csr_op_valid        <= 1'b0;
         trap_state          <= STORE_PC;
         `endif
+        `ifdef SUPPORT_ICACHE
+        icache_invalidate   <= 1'b0;
+        `endif
+        `ifdef SUPPORT_DCACHE
+        dcache_fence        <= 1'b0;
+        `endif
+        `ifdef SUPPORT_ZAAMO
+        mem_amo_opcode      <= 3'b000;
+        mem_amo_param       <= 3'b000;
+        `endif
         `ifdef LOG_CPU `LOG("tl_cpu.sv", ("Reset, PC=0x%0h", START_ADDRESS)); `endif
     end else if (halt) begin
     end else begin
@@ -552,6 +1233,16 @@ always_ff @(posedge clk) begin
                 csr_op_valid        <= 1'b0;
                 trap_state          <= STORE_PC;
                 `endif
+                `ifdef SUPPORT_ICACHE
+                icache_invalidate   <= 1'b0;
+                `endif
+                `ifdef SUPPORT_DCACHE
+                dcache_fence        <= 1'b0;
+                `endif
+                `ifdef SUPPORT_ZAAMO
+                mem_amo_opcode      <= 3'b000;
+                mem_amo_param       <= 3'b000;
+                `endif
                 `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/RESET/, PC=0x%0h", START_ADDRESS)); `endif
             end
 
@@ -562,8 +1253,16 @@ always_ff @(posedge clk) begin
                     // trap_cause  <= TRAP_HALT;
                     // state       <= STATE_TRAP;
                     // test_cpu_reg    <= 6'b101010;
+                `ifdef BRANCH_PREDICT
+                end else if (pf_wait) begin
+                    // Wait for the predicted fetch to finish
+                `endif
                 end else if (~mem_valid && ~mem_ready && ~if_wait) begin
+                    `ifdef SUPPORT_C
+                    if (pc[0] != 1'b0) begin
+                    `else
                     if (pc[1:0] != 2'b00) begin
+                    `endif
                         // PC is misaligned
                         `ifdef LOG_CPU `ERROR("tl_cpu.sv", ("/STATE_IF/ Misaligned PC")); `endif
                         trap_cause  <= TRAP_I_MISALIGNED;
@@ -573,6 +1272,34 @@ always_ff @(posedge clk) begin
                         // Fetch instruction
                         rd_write_en      <= 1'b0; // Regfile Write enabled
                         trap_cause       <= TRAP_UNKNOWN;
+                        `ifdef SUPPORT_C
+                        if (fetch_buf_hit && fetch_buf_whole) begin
+                            // Already fetched, no bus access
+                            instr            <= fetch_instr;
+                            instr_c          <= fetch_compressed;
+                            state            <= `CPU_DECODE_STATE;
+                        end else begin
+                            // Fetch the word holding pc, or the next one for the second half
+                            // of a 32-bit instruction that starts in the upper half
+                            fetch_split      <= fetch_buf_hit;
+                            fetch_lo         <= fetch_buf_data[31:16];
+                            mem_ready        <= 1'b1;
+                            mem_address      <= fetch_buf_hit ? fetch_word + 4 : fetch_word;
+                            mem_wdata        <= {XLEN{1'b0}};
+                            mem_wstrb        <= {8{1'b0}};
+                            mem_read         <= 1'b1;
+                            mem_size         <= 3'b010; // Word size
+                            if_wait          <= 1'b1;
+                        end
+                        `else
+                        `ifdef BRANCH_PREDICT
+                        pf_valid         <= 1'b0;
+                        if (pf_valid && pf_addr == pc) begin
+                            // Predicted correctly, no bus access
+                            instr            <= pf_data;
+                            state            <= `CPU_DECODE_STATE;
+                        end else begin
+                        `endif
                         mem_ready        <= 1'b1;
                         mem_address      <= pc;
                         mem_wdata        <= {XLEN{1'b0}};
@@ -580,6 +1307,16 @@ always_ff @(posedge clk) begin
                         mem_read         <= 1'b1;
                         mem_size         <= 3'b010; // Word size
                         if_wait          <= 1'b1;
+                        `ifdef BRANCH_PREDICT
+                        end
+                        `endif
+                        `endif
+                        `ifdef SUPPORT_ICACHE
+                        icache_invalidate <= 1'b0;
+                        `endif
+                        `ifdef SUPPORT_DCACHE
+                        dcache_fence      <= 1'b0;
+                        `endif
                         `ifdef SUPPORT_ZICSR
                         csr_reg_write_en <= 1'b0; // CSR Register Write enabled
                         `endif
@@ -594,17 +1331,33 @@ always_ff @(posedge clk) begin
                     `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/STATE_IF/ Fetched instruction from mem_address=0x%0h INS=%31b (0x%00h)", mem_address, mem_rdata[31:0], mem_rdata[31:0])); `endif
                     // Fetched instruction
                     test_cpu_reg    <= 6'b000100;
-                    instr           <= mem_rdata[31:0]; // Instructions are 32 bits
                     if_wait         <= 1'b0;
-                    state           <= STATE_ID;
+                    `ifdef SUPPORT_C
+                    fetch_buf_valid <= 1'b1;
+                    fetch_buf_addr  <= mem_address;
+                    fetch_buf_data  <= mem_rdata[31:0];
+                    if (fetch_split || ~pc[1] || mem_rdata[17:16] != 2'b11) begin
+                        instr       <= fetch_instr;
+                        instr_c     <= fetch_compressed;
+                        fetch_split <= 1'b0;
+                        state       <= `CPU_DECODE_STATE;
+                    end
+                    // Otherwise a 32-bit instruction starts in the upper half, stay in
+                    // STATE_IF to fetch its second half
+                    `else
+                    instr           <= mem_rdata[31:0]; // Instructions are 32 bits
+                    state           <= `CPU_DECODE_STATE;
+                    `endif
                 end
             end
 
             STATE_ID: begin
                 `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/STATE_ID/ Instruction decoded")); `endif
                 // Decode Instruction
+                `ifndef FAST_REGFILE
                 rs1_addr    <= rs1;
                 rs2_addr    <= rs2;
+                `endif
                 rd_write_en <= 1'b0;
                 state       <= STATE_EX;
             end
@@ -626,7 +1379,30 @@ always_ff @(posedge clk) begin
                 mdu_operand_a <= rs1_data;
                 mdu_operand_b <= is_op_imm ? imm : rs2_data;
                 mdu_control  <= `MDU_MUL;
+                `endif // SUPPORT_M /////////////////////////////////////////////////
 
+                `ifdef FAST_REGFILE
+                if (fast_alu_op) begin
+                    // Write back from here, the ALU is on the fast operands in STATE_EX
+                    `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/STATE_EX/ Fast ALU writing 0x%0h to rd=%0d", alu_result, rd)); `endif
+                    rd_data     <= alu_result;
+                    rd_addr     <= rd;
+                    rd_write_en <= (rd != 5'b0);
+                    pc          <= pc_next;
+                    `ifdef SUPPORT_ZICSR
+                    if (interrupt_pending) begin
+                        trap_cause <= TRAP_INTERRUPT;
+                        state      <= STATE_TRAP;
+                    end else begin
+                        state      <= STATE_IF;
+                    end
+                    `else
+                    state       <= STATE_IF;
+                    `endif
+                end else
+                `endif
+
+                `ifdef SUPPORT_M ////////////////////////////////////////////////////
                 if (is_mul_div) begin
                     // Handle Multiplication and Division Instructions
                     // Set up ALU control for multiplication/division
@@ -667,7 +1443,7 @@ always_ff @(posedge clk) begin
                             `INST_ADD      : begin work_unit <= ALU; alu_control <= `ALU_ADD; end
                             `INST_SUB      : begin work_unit <= ALU; alu_control <= `ALU_SUB; end
                             `INST_SLT      : begin work_unit <= ALU; alu_control <= `ALU_SLT; end
-                            `INST_SLTU     : begin work_unit <= ALU; alu_control <= `ALU_SLT; end
+                            `INST_SLTU     : begin work_unit <= ALU; alu_control <= `ALU_SLTU; end
                             `INST_XOR      : begin work_unit <= ALU; alu_control <= `ALU_XOR; end
                             `INST_OR       : begin work_unit <= ALU; alu_control <= `ALU_OR; end
                             `INST_AND      : begin work_unit <= ALU; alu_control <= `ALU_AND; end
@@ -680,9 +1456,11 @@ always_ff @(posedge clk) begin
                             `INST_BEXT     : begin work_unit <= BMU; bmu_control = `BMU_BEXT; end
                             `INST_BINV     : begin work_unit <= BMU; bmu_control = `BMU_BINV; end
                             `INST_BSET     : begin work_unit <= BMU; bmu_control = `BMU_BSET; end
+                            `ifndef FUSED_EXU
                             `INST_CLMUL    : begin work_unit <= BMU; bmu_control = `BMU_CLMUL; end
                             `INST_CLMULH   : begin work_unit <= BMU; bmu_control = `BMU_CLMULH; end
                             `INST_CLMULR   : begin work_unit <= BMU; bmu_control = `BMU_CLMULR; end
+                            `endif
                             `INST_MAX      : begin work_unit <= BMU; bmu_control = `BMU_MAX; end
                             `INST_MAXU     : begin work_unit <= BMU; bmu_control = `BMU_MAXU; end
                             `INST_MIN      : begin work_unit <= BMU; bmu_control = `BMU_MIN; end
@@ -694,10 +1472,12 @@ always_ff @(posedge clk) begin
                             `INST_SH2ADD   : begin work_unit <= BMU; bmu_control = `BMU_SH2ADD; end
                             `INST_SH3ADD   : begin work_unit <= BMU; bmu_control = `BMU_SH3ADD; end
                             `INST_XNOR     : begin work_unit <= BMU; bmu_control = `BMU_XNOR; end
+                            `ifndef FUSED_EXU
                             `INST_XPERM16  : begin work_unit <= BMU; bmu_control = `BMU_XPERM16; end
                             `INST_XPERM32  : begin work_unit <= BMU; bmu_control = `BMU_XPERM32; end
                             `INST_XPERM4   : begin work_unit <= BMU; bmu_control = `BMU_XPERM4; end
                             `INST_XPERM8   : begin work_unit <= BMU; bmu_control = `BMU_XPERM8; end
+                            `endif
                             `INST_ZEXTH32  : begin work_unit <= BMU; bmu_control = `BMU_ZEXTH32; end
                             `INST_ZEXTH64  : begin work_unit <= BMU; bmu_control = `BMU_ZEXTH64; end
                             `INST_ROLW     : if (XLEN >= 64) begin work_unit <= BMU; bmu_control = `BMU_ROL; end
@@ -741,12 +1521,16 @@ always_ff @(posedge clk) begin
                             `INST_CTZ    : begin work_unit <= BMU; bmu_control = `BMU_CTZ; end
                             `INST_SEXT_B : begin work_unit <= BMU; bmu_control = `BMU_SEXTB; end
                             `INST_SEXT_H : begin work_unit <= BMU; bmu_control = `BMU_SEXTH; end
+                            `ifndef FUSED_EXU
                             `INST_SHFLI  : begin work_unit <= BMU; bmu_control = `BMU_SHFL; end
+                            `endif
                             `INST_BEXTI  : begin work_unit <= BMU; bmu_control = `BMU_BEXT; end
                             `INST_GREVI  : begin work_unit <= BMU; bmu_control = `BMU_GREV; end
                             `INST_ORCB   : begin work_unit <= BMU; bmu_control = `BMU_ORCB; end
                             `INST_RORI   : begin work_unit <= BMU; bmu_control = `BMU_ROR; end
+                            `ifndef FUSED_EXU
                             `INST_UNSHFLI: begin work_unit <= BMU; bmu_control = `BMU_UNSHFL; end
+                            `endif
                             `INST_CLZW   : if (XLEN >= 64) begin work_unit <= BMU; bmu_control = `BMU_CLZ; end
                             `INST_CPOPW  : if (XLEN >= 64) begin work_unit <= BMU; bmu_control = `BMU_CPOP; end
                             `INST_CTZW   : if (XLEN >= 64) begin work_unit <= BMU; bmu_control = `BMU_CTZ; end
@@ -802,6 +1586,16 @@ always_ff @(posedge clk) begin
                     work_unit     <= ALU;
                     state         <= STATE_MEM;
                     `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/STATE_EX/ Execute Memory request, ALU ADD rs1_data=0x%0h imm=0x%0h", rs1_data, imm)); `endif
+                `ifdef SUPPORT_ZAAMO ////////////////////////////////////////////////
+                end else if (is_amo) begin
+                    // AMOs address rs1 with no offset
+                    alu_operand_a <= rs1_data;
+                    alu_operand_b <= {XLEN{1'b0}};
+                    alu_control   <= `ALU_ADD; // ADD
+                    work_unit     <= ALU;
+                    state         <= STATE_MEM;
+                    `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/STATE_EX/ Execute AMO funct5=%0b rs1_data=0x%0h", funct7[6:2], rs1_data)); `endif
+                `endif // SUPPORT_ZAAMO /////////////////////////////////////////////
                 end else if (is_jal || is_jalr) begin
                     `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/STATE_EX/ Execute jal/jalr")); `endif
                     state         <= STATE_WB;
@@ -810,7 +1604,9 @@ always_ff @(posedge clk) begin
 
                 `ifdef SUPPORT_ZICSR ////////////////////////////////////////////////
                     rd_addr     <= rd;
+                    `ifndef FAST_REGFILE
                     rs1_addr    <= rs1;
+                    `endif
                     rd_data     <= csr_op_rdata;
                     csr_op_addr <= imm[11:0];
                 `endif
@@ -826,6 +1622,13 @@ always_ff @(posedge clk) begin
                             trap_cause <= TRAP_ECALL;
                             state      <= STATE_TRAP;
                         end
+                        `INST_WIFI: begin
+                            `ifdef LOG_CPU `LOG("tl_cpu.sv", ("INST_WFI")); `endif
+                            `ifdef SUPPORT_ZICSR
+                            state      <= STATE_WFI;
+                            `endif
+                            // Without Zicsr nothing can wake the core, wfi completes right away
+                        end
                 `ifdef SUPPORT_ZICSR ////////////////////////////////////////////////
                         `INST_MRET: begin
                             trap_reg <= 1'b0;
@@ -876,6 +1679,23 @@ always_ff @(posedge clk) begin
                         end
                     endcase
                     `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/STATE_EX/ Execute system")); `endif
+                `ifdef CPU_EXEC_FENCE ///////////////////////////////////////////////
+                end else if ({opcode, funct3} == `INST_FENCE || {opcode, funct3} == `INST_FENCEI) begin
+                    // fence lets buffered stores complete before the next fetch, fence.i
+                    // also drops every cached instruction
+                    `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/STATE_EX/ Execute fence funct3=%0b", funct3)); `endif
+                    `ifdef SUPPORT_ICACHE
+                    icache_invalidate <= (funct3 == 3'b001);
+                    `endif
+                    `ifdef SUPPORT_C
+                    fetch_buf_valid   <= fetch_buf_valid && (funct3 != 3'b001);
+                    `endif
+                    `ifdef SUPPORT_DCACHE
+                    dcache_fence      <= 1'b1;
+                    `endif
+                    pc                <= pc_next;
+                    state             <= STATE_IF;
+                `endif // CPU_EXEC_FENCE ////////////////////////////////////////////
                 end else begin
                     // Handle Undefined Instructions
                     `ifdef LOG_CPU `ERROR("tl_cpu.sv", ("/STATE_EX/ Execute unknown")); `endif
@@ -891,7 +1711,7 @@ always_ff @(posedge clk) begin
                     rd_data       <= mdu_result;
                     rd_write_en   <= (rd != 5'b0);
                     mdu_start <= 1'b0;
-                    pc            <= pc + 4;
+                    pc            <= pc_next;
                     state         <= STATE_IF;
                 end else begin
                     // Stay in this state until operation is ready
@@ -911,6 +1731,48 @@ always_ff @(posedge clk) begin
                     mem_wait    <= 1'b1;
                     mem_address <= alu_result;
                     // mem_wdata   <= rs2_data;
+                    `ifdef SUPPORT_ZAAMO ////////////////////////////////////////////
+                    if (is_amo) begin
+                        // The memory applies rs2 to the word or double-word at rs1 and
+                        // answers with the old value
+                        mem_read  <= 1'b0;
+                        mem_size  <= funct3;
+                        mem_wdata <= rs2_data;
+                        mem_wstrb <= ~({(WSTRB_WIDTH){1'b1}} << (1 << funct3[1:0]));
+                        case (funct7[6:2])
+                            5'b00000: begin mem_amo_opcode <= 3'b010; mem_amo_param <= 3'd4; end // AMOADD
+                            5'b00001: begin mem_amo_opcode <= 3'b011; mem_amo_param <= 3'd3; end // AMOSWAP
+                            5'b00100: begin mem_amo_opcode <= 3'b011; mem_amo_param <= 3'd0; end // AMOXOR
+                            5'b01000: begin mem_amo_opcode <= 3'b011; mem_amo_param <= 3'd1; end // AMOOR
+                            5'b01100: begin mem_amo_opcode <= 3'b011; mem_amo_param <= 3'd2; end // AMOAND
+                            5'b10000: begin mem_amo_opcode <= 3'b010; mem_amo_param <= 3'd0; end // AMOMIN
+                            5'b10100: begin mem_amo_opcode <= 3'b010; mem_amo_param <= 3'd1; end // AMOMAX
+                            5'b11000: begin mem_amo_opcode <= 3'b010; mem_amo_param <= 3'd2; end // AMOMINU
+                            5'b11100: begin mem_amo_opcode <= 3'b010; mem_amo_param <= 3'd3; end // AMOMAXU
+                            default: begin
+                                // LR/SC and reserved encodings
+                                mem_ready  <= 1'b0;
+                                mem_wait   <= 1'b0;
+                                trap_cause <= TRAP_INSTRUCTION;
+                                state      <= STATE_TRAP;
+                            end
+                        endcase
+                        if (funct3 != 3'b010 && !(XLEN >= 64 && funct3 == 3'b011)) begin
+                            mem_ready      <= 1'b0;
+                            mem_wait       <= 1'b0;
+                            mem_amo_opcode <= 3'b000;
+                            trap_cause     <= TRAP_INSTRUCTION;
+                            state          <= STATE_TRAP;
+                        end else if ((alu_result & ((1 << funct3[1:0]) - 1)) != 0) begin
+                            mem_ready      <= 1'b0;
+                            mem_wait       <= 1'b0;
+                            mem_amo_opcode <= 3'b000;
+                            trap_cause     <= TRAP_S_MISALIGNED;
+                            state          <= STATE_TRAP;
+                        end
+                        `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/STATE_MEM/ AMO funct5=%0b address 0x%0h rs2_data=%0h", funct7[6:2], alu_result, rs2_data)); `endif
+                    end else
+                    `endif // SUPPORT_ZAAMO /////////////////////////////////////////
                     case ({opcode, funct3})
                         `INST_LBU,
                         `INST_LB: begin
@@ -1138,8 +2000,8 @@ always_ff @(posedge clk) begin
                 end else if (mem_valid && mem_read) begin
                     // Memory is ready to be loaded
                     mem_wait  <= 1'b0;
-                    pc        <= pc + 4;
-                    `ifdef LOG_CPU `LOG("tl_cpu.sv", ("PC updated to 0x%0h", pc + 4)); `endif
+                    pc        <= pc_next;
+                    `ifdef LOG_CPU `LOG("tl_cpu.sv", ("PC updated to 0x%0h", pc_next)); `endif
                     state     <= STATE_IF;
                     case ({opcode, funct3})
                         `INST_LB: begin
@@ -1189,6 +2051,21 @@ always_ff @(posedge clk) begin
                     endcase
                 end else if (mem_valid && ~mem_read) begin
                     mem_wait  <= 1'b0;
+                    `ifdef SUPPORT_ZAAMO
+                    if (is_amo) begin
+                        // The old value goes to rd, a word is sign extended
+                        mem_amo_opcode <= 3'b000;
+                        mem_amo_param  <= 3'b000;
+                        rd_addr        <= rd;
+                        rd_write_en    <= (rd != 5'b0);
+                        if (funct3 == 3'b010) begin
+                            rd_data <= $signed(mem_rdata[31:0]);
+                        end else begin
+                            rd_data <= mem_rdata;
+                        end
+                        `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/STATE_MEM/ Received AMO Data=0x%0h for rd=%0d", mem_rdata, rd)); `endif
+                    end
+                    `endif
                     if (mem_corrupt) begin
                         `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/STATE_MEM/ Memory is corrupt")); `endif
                     end
@@ -1196,8 +2073,11 @@ always_ff @(posedge clk) begin
                         `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/STATE_MEM/ Memory is denied")); `endif
                     end
                     // Memory is written
-                    pc        <= pc + 4;
-                    `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/STATE_MEM/ PC updated to 0x%0h", pc + 4)); `endif
+                    `ifdef SUPPORT_C
+                    fetch_buf_valid <= 1'b0;
+                    `endif
+                    pc        <= pc_next;
+                    `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/STATE_MEM/ PC updated to 0x%0h", pc_next)); `endif
                     `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/STATE_MEM/ Write Done")); `endif
                     state     <= STATE_IF;
                 end else begin
@@ -1220,7 +2100,7 @@ always_ff @(posedge clk) begin
                         `ifdef SUPPORT_B
                         BMU: begin
                             rd_data <= bmu_result;
-                            `ifdef LOG_CPU `LOG("tl_cpu.sv", ("STATE_WB Writing BMU 0x%0h to rd=%0d", bmuu_result, rd)); `endif
+                            `ifdef LOG_CPU `LOG("tl_cpu.sv", ("STATE_WB Writing BMU 0x%0h to rd=%0d", bmu_result, rd)); `endif
                         end
                         `endif
                         `ifdef SUPPORT_M
@@ -1233,10 +2113,10 @@ always_ff @(posedge clk) begin
                     rd_addr     <= rd;
                     rd_write_en <= 1'b1;
                 end else if (is_jal || is_jalr) begin
-                    rd_data     <= pc + 4;
+                    rd_data     <= pc_next;
                     rd_addr     <= rd;
                     rd_write_en <= 1'b1;
-                    `ifdef LOG_CPU `LOG("tl_cpu.sv", ("STATE_WB JAL/JALR Writing 0x%0h to rd=%0d", pc + 4, rd)); `endif
+                    `ifdef LOG_CPU `LOG("tl_cpu.sv", ("STATE_WB JAL/JALR Writing 0x%0h to rd=%0d", pc_next, rd)); `endif
                 end
 
                 // Branch Decision Logic
@@ -1251,8 +2131,20 @@ always_ff @(posedge clk) begin
                         3'b111: take_branch = ~alu_unsigned_less_than;// BGEU
                         default: take_branch = 1'b0;
                     endcase
-                    pc <= take_branch ? pc + imm : pc + 4;
-                    `ifdef LOG_CPU `LOG("tl_cpu.sv", ("take_branch is %0d PC updated to 0x%0h", take_branch, (take_branch ? pc + imm : pc + 4))); `endif
+                    pc <= take_branch ? pc + imm : pc_next;
+                    `ifdef BRANCH_PREDICT
+                    if (BTB_ENTRIES != 0) begin
+                        // Remember taken branches, forget one that fell through
+                        if (take_branch) begin
+                            btb_valid[btb_index]  <= 1'b1;
+                            btb_pc[btb_index]     <= pc;
+                            btb_target[btb_index] <= pc + imm;
+                        end else if (btb_hit) begin
+                            btb_valid[btb_index]  <= 1'b0;
+                        end
+                    end
+                    `endif
+                    `ifdef LOG_CPU `LOG("tl_cpu.sv", ("take_branch is %0d PC updated to 0x%0h", take_branch, (take_branch ? pc + imm : pc_next))); `endif
                 end else if (is_jal) begin
                     if (pc == pc + imm) begin
                         halt <= 1'b1;
@@ -1267,6 +2159,13 @@ always_ff @(posedge clk) begin
                         halt <= 1'b1;
                     end
                     pc <= (rs1_data + imm) & ~32'b1; // Clear LSB
+                    `ifdef BRANCH_PREDICT
+                    if (BTB_ENTRIES != 0) begin
+                        btb_valid[btb_index]  <= 1'b1;
+                        btb_pc[btb_index]     <= pc;
+                        btb_target[btb_index] <= (rs1_data + imm) & ~32'b1;
+                    end
+                    `endif
                     `ifdef LOG_CPU `LOG("tl_cpu.sv", ("JALR PC updated to 0x%0h. rs1_addr=%0d rs1_data=0x%0h imm=0x%0h", (rs1_data + imm) & ~32'b1, rs1_addr, rs1_data, imm)); `endif
                 end else if (is_system) begin
                     `ifdef SUPPORT_ZICSR
@@ -1275,19 +2174,19 @@ always_ff @(posedge clk) begin
                         // CSR operation finished
                         csr_op_valid <= 1'b0;
                         rd_write_en  <= 1'b0;
-                        pc <= pc + 4;
+                        pc <= pc_next;
                     end else if (csr_op_valid && ~csr_op_done) begin
                         // Wait for CSR to finish
                     end else if (~csr_op_valid) begin
                         // Not CSR
-                        pc <= pc + 4;
+                        pc <= pc_next;
                     end
                     `else
-                    pc <= pc + 4;
+                    pc <= pc_next;
                     `endif
                 end else begin
-                    pc <= pc + 4;
-                    `ifdef LOG_CPU `LOG("tl_cpu.sv", ("PC updated to 0x%0h", pc + 4)); `endif
+                    pc <= pc_next;
+                    `ifdef LOG_CPU `LOG("tl_cpu.sv", ("PC updated to 0x%0h", pc_next)); `endif
                 end
 
                 // Check for Interrupts
@@ -1303,6 +2202,24 @@ always_ff @(posedge clk) begin
                 `endif
             end
 
+            `ifdef SUPPORT_ZICSR
+            STATE_WFI: begin
+                // No fetches, the bus stays idle until an interrupt enabled in mie is pending.
+                // With mstatus.MIE set it is taken with mepc after the wfi, without it the
+                // next instruction runs.
+                if (interrupt_waiting) begin
+                    `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/STATE_WFI/ Wake up, interrupt_pending=%0d", interrupt_pending)); `endif
+                    if (interrupt_pending) begin
+                        trap_cause <= TRAP_INTERRUPT;
+                        state      <= STATE_TRAP;
+                    end else begin
+                        pc         <= pc_next;
+                        state      <= STATE_IF;
+                    end
+                end
+            end
+            `endif
+
             STATE_TRAP: begin
                 // test_cpu_reg    <= 6'b001111;
                 `ifdef LOG_CPU `WARN("tl_cpu.sv", ("/TRAP/")); `endif
@@ -1311,7 +2228,7 @@ always_ff @(posedge clk) begin
                 case(trap_state)
                     STORE_PC: begin
                         csr_reg_addr     <= `CSR_MEPC;
-                        csr_reg_wdata    <= pc + 32'h4;
+                        csr_reg_wdata    <= pc_next;
                         csr_reg_write_en <= 1'b1;
                         trap_state       <= STORE_CAUSE;
                     end
@@ -1368,6 +2285,39 @@ always_ff @(posedge clk) begin
                 state <= STATE_RESET;
             end
         endcase
+
+        `ifdef BRANCH_PREDICT
+        // Start the predicted fetch while the jump or branch is decoded
+        if (state == `CPU_DECODE_STATE && bp_fetch) begin
+            `ifdef LOG_CPU `LOG("tl_cpu.sv", ("/BRANCH_PREDICT/ Predicted next PC=0x%0h", bp_next)); `endif
+            mem_ready   <= 1'b1;
+            mem_address <= bp_word;
+            mem_wdata   <= {XLEN{1'b0}};
+            mem_wstrb   <= {8{1'b0}};
+            mem_read    <= 1'b1;
+            mem_size    <= 3'b010; // Word size
+            pf_wait     <= 1'b1;
+            pf_addr     <= bp_word;
+        end
+
+        // Predicted fetch, runs beside whichever state the jump or branch is in
+        if (pf_wait) begin
+            if (mem_ready && mem_ack) begin
+                mem_ready <= 1'b0;
+            end
+            if (mem_valid) begin
+                pf_wait         <= 1'b0;
+                `ifdef SUPPORT_C
+                fetch_buf_valid <= ~mem_denied && ~mem_corrupt;
+                fetch_buf_addr  <= pf_addr;
+                fetch_buf_data  <= mem_rdata[31:0];
+                `else
+                pf_valid        <= ~mem_denied && ~mem_corrupt;
+                pf_data         <= mem_rdata[31:0];
+                `endif
+            end
+        end
+        `endif
     end
 end
 
@@ -0,0 +1,1638 @@
+`ifndef __CPU_PIPE__
+`define __CPU_PIPE__
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// tl_cpu_pipe.sv Module
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @module tl_cpu_pipe.sv
+ * @brief A pipelined RISC-V RV32/64I CPU Core with Optional Extensions.
+ *
+ * The `tl_cpu_pipe.sv` module is a drop-in alternative to `tl_cpu.sv`. It has the same parameters
+ * and ports, executes the same instruction set and uses the same building blocks (decoder,
+ * register file, ALU, BMU, MDU, CSR and `tl_interface`), but instead of walking one instruction
+ * through a state machine it overlaps five instructions in a classic in-order pipeline. It is
+ * selected with the `PIPELINED` define (`make ... PIPELINED=1`); `tl_cpu.sv` stays the default.
+ *
+ * Pipeline Structure (one instruction per stage):
+ * - IF:  Fetches the instruction at `pc` through `tl_interface` and predicts the next PC as
+ *        `pc + 4`. The fetched instruction is held in the IF/ID register (`id_*`).
+ * - ID:  Reads `rs1`/`rs2` from `cpu_regfile`. A result written back in the same cycle is
+ *        bypassed around the register file.
+ * - EX:  Decodes the instruction, forwards operands from the EX/MEM and MEM/WB registers,
+ *        runs the ALU/BMU/MDU/CSR, resolves branches and jumps and detects exceptions.
+ * - MEM: Performs loads and stores through `tl_interface`.
+ * - WB:  Writes the result into `cpu_regfile`.
+ *
+ * Hazards:
+ * - Data: Results still in EX/MEM or MEM/WB are forwarded into the EX operands. A load followed
+ *   by a dependent instruction stalls EX until the load data reaches MEM/WB (one bubble past the
+ *   bus access). While EX is stalled its operands are refreshed from the forwarding network every
+ *   cycle, so producers can retire underneath it.
+ * - Structural: IF and MEM share the single `tl_interface`. MEM has priority; a fetch already on
+ *   the bus is always allowed to finish.
+ * - Control: Taken branches, jumps, `mret` and `fence.i` redirect the fetch PC from EX, squash
+ *   the instruction in ID and drop the fetch in flight, if any.
+ * - Multi-cycle units: MDU and CSR operations hold EX until the unit reports completion.
+ *
+ * Exceptions and Interrupts:
+ * - An exception raised in EX waits for older instructions to leave MEM, flushes the younger
+ *   ones and then runs the same STORE_PC → STORE_CAUSE → CONTINUE sequence as `tl_cpu.sv`.
+ *   As in `tl_cpu.sv`, `mepc` receives the address of the instruction after the faulting one.
+ * - A pending interrupt stops new instructions from entering EX, waits for the pipeline to drain
+ *   and stores the address of the first instruction not executed in `mepc`.
+ * - Without SUPPORT_ZICSR a trap pulses `trap` and restarts at `START_ADDRESS`.
+ *
+ * Halt Detection:
+ * - A self-jump (e.g. `jal x0, 0`) sets `dbg_halt` when it reaches WB, after every older
+ *   instruction (including stores) has completed.
+ *
+ * Limitations:
+ * - Only one bus transaction can be in flight, so the fetch round trip through `tl_interface`
+ *   still bounds throughput; the pipeline hides the execute, memory and write back cycles.
+ * - `fence` and `wfi` are executed as no-ops. `fence.i` refetches the following instructions
+ *   and, with SUPPORT_ICACHE, invalidates the instruction cache. With SUPPORT_DCACHE both
+ *   let the store buffer drain before the next fetch.
+ *
+ * @note The `test` output reports the stage valid bits and bus state:
+ *       {id_valid, ex_valid, ex_mem_valid, mem_wb_valid, bus_state[1:0]}.
+ */
+
+`timescale 1ns / 1ps
+`default_nettype none
+
+`include "instructions.sv"
+`include "cpu_alu.sv"
+`include "cpu_insdecode.sv"
+`include "tl_interface.sv"
+`include "cpu_regfile.sv"
+`ifdef SUPPORT_ZICSR
+`include "cpu_csr.sv"
+`endif
+`ifdef SUPPORT_M
+`include "cpu_mdu.sv"
+`endif
+`ifdef SUPPORT_B
+`include "cpu_bmu.sv"
+`endif
+`ifdef SUPPORT_ICACHE
+`include "cpu_icache.sv"
+`endif
+`ifdef SUPPORT_DCACHE
+`include "cpu_dcache.sv"
+`endif
+
+// Default MDU implementation, MDU_FAST selects the DSP multiplier and radix-4 divider
+`ifndef CPU_MDU_IMPL
+`ifdef MDU_FAST
+`define CPU_MDU_IMPL 1
+`else
+`define CPU_MDU_IMPL 0
+`endif
+`endif
+
+module tl_cpu_pipe #(
+    parameter MHARTID_VAL     = 32'h0000_0000,  // The Hardware ID for the CPU
+    parameter XLEN            = 32,             // Data width: 32 bits
+    parameter SID_WIDTH       = 8,              // Source ID Width
+    parameter START_ADDRESS   = 32'h8000_0000,  // Default start address
+    parameter MTVEC_RESET_VAL = 32'h8000_0000,  // Default mtvec address
+    parameter NMI_COUNT       = 1,              // Number of NMIs (must satisfy XLEN > IRQ_COUNT + NMI_COUNT)
+    parameter IRQ_COUNT       = 1,              // Number of standard IRQs (must satisfy XLEN > IRQ_COUNT + NMI_COUNT)
+    parameter ICACHE_SIZE     = 1024,           // Instruction cache size in bytes (SUPPORT_ICACHE)
+    parameter ICACHE_LINE     = 16,             // Instruction cache line size in bytes (SUPPORT_ICACHE)
+    parameter DCACHE_SIZE     = 1024,           // Data cache size in bytes (SUPPORT_DCACHE)
+    parameter DCACHE_LINE     = 16,             // Data cache line size in bytes (SUPPORT_DCACHE)
+    parameter DCACHE_SB_DEPTH = 4,              // Store buffer entries (SUPPORT_DCACHE)
+    parameter DCACHE_BASE     = 32'h0000_0000,  // Cacheable window base (SUPPORT_DCACHE)
+    parameter DCACHE_MASK     = 32'h0000_FFFF,  // Cacheable window address mask (SUPPORT_DCACHE)
+    parameter MDU_IMPL        = `CPU_MDU_IMPL,  // MDU implementation, see cpu_mdu.sv (SUPPORT_M)
+    parameter MDU_MUL_STAGES  = 2               // Multiplier register stages, 1 to 3 (SUPPORT_M)
+) (
+    input wire                  clk,
+    input wire                  reset,
+
+    `ifdef SUPPORT_ZICSR
+    input wire [IRQ_COUNT-1:0]  external_irq, // Interrupt Request Lines
+    input wire [NMI_COUNT-1:0]  external_nmi, // Non-Maskable Interrupt
+    input wire                  external_timer, // Machine Timer Interrupt
+    `endif
+
+    // TileLink TL-UL Interface signals
+    // A Channel (Requests)
+    output wire                 tl_a_valid,
+    input  wire                 tl_a_ready,
+    output wire [2:0]           tl_a_opcode,
+    output wire [2:0]           tl_a_param,
+    output wire [2:0]           tl_a_size,
+    output wire [SID_WIDTH-1:0] tl_a_source,
+    output wire [XLEN-1:0]      tl_a_address,
+    output wire [XLEN/8-1:0]    tl_a_mask,
+    output wire [XLEN-1:0]      tl_a_data,
+
+    // D Channel (Responses)
+    input  wire                  tl_d_valid,
+    output wire                  tl_d_ready,
+    input  wire [2:0]            tl_d_opcode,
+    input  wire [1:0]            tl_d_param,
+    input  wire [2:0]            tl_d_size,
+    input  wire [SID_WIDTH-1:0]  tl_d_source,
+    input  wire [XLEN-1:0]       tl_d_data,
+    input  wire                  tl_d_corrupt,
+    input  wire                  tl_d_denied,
+
+    // Signals
+    output wire                  trap,
+    output wire [5:0]            test
+
+    `ifdef DEBUG
+    // Debug output
+    ,output wire                  dbg_halt
+    ,output wire [XLEN-1:0]       dbg_pc
+    ,output wire [XLEN-1:0]       dbg_x1
+    ,output wire [XLEN-1:0]       dbg_x2
+    ,output wire [XLEN-1:0]       dbg_x3
+    ,output wire                  dbg_retire
+    ,output wire [XLEN-1:0]       dbg_retire_pc
+    ,output wire [31:0]           dbg_retire_instr
+    ,output wire [3:0]            dbg_state
+    `endif
+);
+
+// ──────────────────────────
+// Configuration Validation
+// ──────────────────────────
+// These tl_cpu.sv features have no pipelined version, building without them would quietly give
+// a different CPU than the one asked for
+initial begin
+    `ifdef SUPPORT_C
+    $error("SUPPORT_C is only implemented by tl_cpu.sv, build without PIPELINED.");
+    $finish;
+    `endif
+    `ifdef SUPPORT_ZAAMO
+    $error("SUPPORT_ZAAMO is only implemented by tl_cpu.sv, build without PIPELINED.");
+    $finish;
+    `endif
+    `ifdef SUPPORT_TCM
+    $error("SUPPORT_TCM is only implemented by tl_cpu.sv, build without PIPELINED.");
+    $finish;
+    `endif
+    `ifdef FUSED_EXU
+    $error("FUSED_EXU is only implemented by tl_cpu.sv, build without PIPELINED.");
+    $finish;
+    `endif
+    `ifdef FAST_REGFILE
+    $error("FAST_REGFILE is only implemented by tl_cpu.sv, build without PIPELINED.");
+    $finish;
+    `endif
+    `ifdef BRANCH_PREDICT
+    $error("BRANCH_PREDICT is only implemented by tl_cpu.sv, build without PIPELINED.");
+    $finish;
+    `endif
+end
+
+localparam WSTRB_WIDTH = XLEN / 8;              // Number of bytes for mem write mask
+localparam LANE_BITS   = $clog2(WSTRB_WIDTH);   // Address bits selecting a byte lane
+
+// ──────────────────────────
+// Bus Arbiter States
+// ──────────────────────────
+typedef enum logic [1:0] {
+    BUS_IDLE  = 2'b00,  // No transaction on tl_interface
+    BUS_FETCH = 2'b01,  // Instruction fetch in flight
+    BUS_DATA  = 2'b10   // Load/store in flight
+} bus_state_t;
+bus_state_t bus_state;
+
+typedef enum logic [1:0] {
+    ALU,
+    BMU,
+    MDU
+} cpu_work_unit_t;
+
+// ──────────────────────────
+// Trap cause
+// ──────────────────────────
+typedef enum logic [3:0] {
+    TRAP_UNKNOWN,       // Default, unknown cause
+    TRAP_UNSUPPORTED,   // XLEN not supported
+    TRAP_HALT,          // Self jump detected
+    TRAP_INSTRUCTION,   // Unknow insstruction encountered
+    TRAP_EBREAK,        // EBreak instruction
+    TRAP_ECALL,         // ECall instruction
+    TRAP_INTERRUPT,     // Interrupt
+    TRAP_I_MISALIGNED,  // Misaligned instruction memory access
+    TRAP_L_MISALIGNED,  // Misaligned load memory access
+    TRAP_S_MISALIGNED   // Misaligned store memory access
+} trap_cause_t;
+trap_cause_t trap_cause;
+
+// ──────────────────────────
+// Internal Registers and Signals
+// ──────────────────────────
+logic [XLEN-1:0] pc;          // Next instruction to fetch
+logic [XLEN-1:0] fetch_pc;    // Address of the fetch in flight
+logic            fetch_kill;  // Drop the fetch in flight, the PC was redirected
+logic            halt;
+logic            trap_reg;
+
+assign trap = trap_reg;
+
+// ──────────────────────────
+// Pipeline Registers
+// ──────────────────────────
+// IF/ID
+logic            id_valid;
+logic [XLEN-1:0] id_pc;
+logic [31:0]     id_instr;
+
+// ID/EX
+logic            ex_valid;
+logic [XLEN-1:0] ex_pc;
+logic [31:0]     ex_instr;
+logic [XLEN-1:0] ex_rs1_data;
+logic [XLEN-1:0] ex_rs2_data;
+
+// EX/MEM
+logic            ex_mem_valid;
+logic [XLEN-1:0] ex_mem_pc;
+logic [4:0]      ex_mem_rd;
+logic            ex_mem_wen;
+logic [XLEN-1:0] ex_mem_result;   // ALU result, or the address for loads/stores
+logic            ex_mem_is_load;
+logic            ex_mem_is_store;
+logic [2:0]      ex_mem_funct3;
+logic [XLEN-1:0] ex_mem_wdata;
+logic [XLEN/8-1:0] ex_mem_wstrb;
+logic            ex_mem_halt;
+
+// MEM/WB
+logic            mem_wb_valid;
+logic [XLEN-1:0] mem_wb_pc;
+logic [4:0]      mem_wb_rd;
+logic            mem_wb_wen;
+logic [XLEN-1:0] mem_wb_data;
+logic            mem_wb_halt;
+
+assign test = {id_valid, ex_valid, ex_mem_valid, mem_wb_valid, bus_state};
+
+// ──────────────────────────
+// Instruction Decoder Signals (EX stage)
+// ──────────────────────────
+logic [6:0]      opcode;
+logic [4:0]      rd;
+logic [2:0]      funct3;
+logic [4:0]      rs1;
+logic [4:0]      rs2;
+logic [6:0]      funct7;
+logic [11:0]     funct12;
+logic [XLEN-1:0] imm;
+
+logic            is_mem, is_op_imm, is_op;
+logic            is_lui, is_auipc, is_branch, is_jal, is_jalr;
+logic            is_system;
+`ifdef SUPPORT_M
+logic            is_mul_div;
+`endif
+
+// ──────────────────────────
+// Instantiate Instruction Decoder
+// ──────────────────────────
+cpu_insdecode #(.XLEN(XLEN)) instr_decoder_inst (
+    .instr    (ex_instr),
+    .opcode   (opcode),
+    .rd       (rd),
+    .funct3   (funct3),
+    .rs1      (rs1),
+    .rs2      (rs2),
+    .funct7   (funct7),
+    .funct12  (funct12),
+    .imm      (imm),
+    .is_mem   (is_mem),
+    .is_op_imm(is_op_imm),
+    .is_op    (is_op),
+    .is_lui   (is_lui),
+    .is_auipc (is_auipc),
+    .is_branch(is_branch),
+    .is_jal   (is_jal),
+    .is_jalr  (is_jalr),
+    .is_system(is_system)
+    `ifdef SUPPORT_M
+    ,.is_mul_div(is_mul_div)
+    `endif
+);
+
+// ──────────────────────────
+// Register File Signals
+// ──────────────────────────
+logic [4:0]      rs1_addr, rs2_addr, rd_addr;
+logic [XLEN-1:0] rs1_data, rs2_data;
+logic [XLEN-1:0] rd_data;
+logic            rd_write_en;
+
+`ifdef DEBUG
+logic [XLEN-1:0] dbg_rf_x1, dbg_rf_x2, dbg_rf_x3;
+`endif
+
+// ID reads the register file, WB writes it
+assign rs1_addr    = id_instr[19:15];
+assign rs2_addr    = id_instr[24:20];
+assign rd_addr     = mem_wb_rd;
+assign rd_data     = mem_wb_data;
+assign rd_write_en = mem_wb_valid && mem_wb_wen && ~halt;
+
+// ──────────────────────────
+// Instantiate Register File
+// ──────────────────────────
+cpu_regfile #(.XLEN(XLEN)) reg_file_inst (
+    .clk        (clk),
+    .reset      (reset),
+    .rs1_addr   (rs1_addr),
+    .rs2_addr   (rs2_addr),
+    .rd_addr    (rd_addr),
+    .rd_data    (rd_data),
+    .rd_write_en(rd_write_en),
+    .rs1_data   (rs1_data),
+    .rs2_data   (rs2_data)
+
+    `ifdef DEBUG
+    ,.dbg_x1     (dbg_rf_x1)
+    ,.dbg_x2     (dbg_rf_x2)
+    ,.dbg_x3     (dbg_rf_x3)
+    `endif
+);
+
+`ifdef DEBUG
+assign dbg_x1   = dbg_rf_x1;
+assign dbg_x2   = dbg_rf_x2;
+assign dbg_x3   = dbg_rf_x3;
+assign dbg_pc   = mem_wb_pc;
+assign dbg_retire = mem_wb_valid;
+`ifndef SUPPORT_DCACHE
+assign dbg_halt = halt;
+`endif
+`endif
+
+// ──────────────────────────
+// ID Stage: Write Back Bypass
+// ──────────────────────────
+// The register file is written at the end of the cycle, so a value retiring in WB this cycle
+// is taken from MEM/WB instead of the (still old) register file contents.
+logic [XLEN-1:0] id_rs1_value, id_rs2_value;
+assign id_rs1_value = (rd_write_en && rd_addr != 5'b0 && rd_addr == rs1_addr) ? rd_data : rs1_data;
+assign id_rs2_value = (rd_write_en && rd_addr != 5'b0 && rd_addr == rs2_addr) ? rd_data : rs2_data;
+
+// ──────────────────────────
+// EX Stage: Operand Forwarding
+// ──────────────────────────
+logic [XLEN-1:0] ex_fwd_rs1, ex_fwd_rs2;
+always_comb begin
+    if (rs1 == 5'b0) begin
+        ex_fwd_rs1 = {XLEN{1'b0}};
+    end else if (ex_mem_valid && ex_mem_wen && ~ex_mem_is_load && ex_mem_rd == rs1) begin
+        ex_fwd_rs1 = ex_mem_result;
+    end else if (mem_wb_valid && mem_wb_wen && mem_wb_rd == rs1) begin
+        ex_fwd_rs1 = mem_wb_data;
+    end else begin
+        ex_fwd_rs1 = ex_rs1_data;
+    end
+
+    if (rs2 == 5'b0) begin
+        ex_fwd_rs2 = {XLEN{1'b0}};
+    end else if (ex_mem_valid && ex_mem_wen && ~ex_mem_is_load && ex_mem_rd == rs2) begin
+        ex_fwd_rs2 = ex_mem_result;
+    end else if (mem_wb_valid && mem_wb_wen && mem_wb_rd == rs2) begin
+        ex_fwd_rs2 = mem_wb_data;
+    end else begin
+        ex_fwd_rs2 = ex_rs2_data;
+    end
+end
+
+// ──────────────────────────
+// EX Stage: Control Decode
+// ──────────────────────────
+cpu_work_unit_t  ex_unit;
+logic [3:0]      ex_alu_control;
+logic            ex_illegal;
+logic            ex_writes_rd;
+logic            ex_uses_rs1;
+logic            ex_uses_rs2;
+logic            ex_word_op;    // RV64 *W instruction, operates on the low 32 bits
+logic            ex_word_zext;  // *W operand is zero extended (logical right shift, unsigned div)
+logic            ex_is_ecall;
+logic            ex_is_ebreak;
+logic            ex_is_mret;
+logic            ex_is_fence;
+logic            ex_is_fencei;
+logic            ex_is_load;
+logic            ex_is_store;
+`ifdef SUPPORT_B
+logic [5:0]      ex_bmu_control;
+`endif
+`ifdef SUPPORT_M
+logic [2:0]      ex_mdu_control;
+`endif
+`ifdef SUPPORT_ZICSR
+logic            ex_is_csr;
+logic [2:0]      ex_csr_control;
+`endif
+
+always_comb begin
+    ex_unit        = ALU;
+    ex_alu_control = `ALU_ADD;
+    ex_illegal     = 1'b0;
+    ex_writes_rd   = 1'b0;
+    ex_uses_rs1    = 1'b0;
+    ex_uses_rs2    = 1'b0;
+    ex_word_op     = 1'b0;
+    ex_word_zext   = 1'b0;
+    ex_is_ecall    = 1'b0;
+    ex_is_ebreak   = 1'b0;
+    ex_is_mret     = 1'b0;
+    ex_is_fence    = 1'b0;
+    ex_is_fencei   = 1'b0;
+    ex_is_load     = (opcode == 7'b0000011);
+    ex_is_store    = (opcode == 7'b0100011);
+    `ifdef SUPPORT_B
+    ex_bmu_control = `BMU_CLZ;
+    `endif
+    `ifdef SUPPORT_M
+    ex_mdu_control = `MDU_MUL;
+    `endif
+    `ifdef SUPPORT_ZICSR
+    ex_is_csr      = 1'b0;
+    ex_csr_control = `CSR_RW;
+    `endif
+
+    if (is_op) begin
+        ex_writes_rd = 1'b1;
+        ex_uses_rs1  = 1'b1;
+        ex_uses_rs2  = 1'b1;
+        `ifdef SUPPORT_M ////////////////////////////////////////////////////
+        if (is_mul_div) begin
+            ex_unit = MDU;
+            case ({opcode, funct7, funct3})
+                `INST_MUL   : ex_mdu_control = `MDU_MUL;
+                `INST_MULH  : ex_mdu_control = `MDU_MULH;
+                `INST_MULHSU: ex_mdu_control = `MDU_MULHSU;
+                `INST_MULHU : ex_mdu_control = `MDU_MULHU;
+                `INST_DIV   : ex_mdu_control = `MDU_DIV;
+                `INST_DIVU  : ex_mdu_control = `MDU_DIVU;
+                `INST_REM   : ex_mdu_control = `MDU_REM;
+                `INST_REMU  : ex_mdu_control = `MDU_REMU;
+                `INST_MULW  : if (XLEN >= 64) begin ex_mdu_control = `MDU_MUL;  ex_word_op = 1'b1; end else ex_illegal = 1'b1;
+                `INST_DIVW  : if (XLEN >= 64) begin ex_mdu_control = `MDU_DIV;  ex_word_op = 1'b1; end else ex_illegal = 1'b1;
+                `INST_DIVUW : if (XLEN >= 64) begin ex_mdu_control = `MDU_DIVU; ex_word_op = 1'b1; ex_word_zext = 1'b1; end else ex_illegal = 1'b1;
+                `INST_REMW  : if (XLEN >= 64) begin ex_mdu_control = `MDU_REM;  ex_word_op = 1'b1; end else ex_illegal = 1'b1;
+                `INST_REMUW : if (XLEN >= 64) begin ex_mdu_control = `MDU_REMU; ex_word_op = 1'b1; ex_word_zext = 1'b1; end else ex_illegal = 1'b1;
+                default     : ex_illegal = 1'b1;
+            endcase
+        end else
+        `endif // SUPPORT_M /////////////////////////////////////////////////
+        case ({opcode, funct7, funct3})
+            `INST_ADD      : ex_alu_control = `ALU_ADD;
+            `INST_SUB      : ex_alu_control = `ALU_SUB;
+            `INST_SLT      : ex_alu_control = `ALU_SLT;
+            `INST_SLTU     : ex_alu_control = `ALU_SLTU;
+            `INST_XOR      : ex_alu_control = `ALU_XOR;
+            `INST_OR       : ex_alu_control = `ALU_OR;
+            `INST_AND      : ex_alu_control = `ALU_AND;
+            `INST_SLL      : ex_alu_control = `ALU_SLL;
+            `INST_SRA      : ex_alu_control = `ALU_SRA;
+            `INST_SRL      : ex_alu_control = `ALU_SRL;
+            `ifdef SUPPORT_B ////////////////////////////////////////////////////
+            `INST_ANDN     : begin ex_unit = BMU; ex_bmu_control = `BMU_ANDN; end
+            `INST_BCLR     : begin ex_unit = BMU; ex_bmu_control = `BMU_BCLR; end
+            `INST_BEXT     : begin ex_unit = BMU; ex_bmu_control = `BMU_BEXT; end
+            `INST_BINV     : begin ex_unit = BMU; ex_bmu_control = `BMU_BINV; end
+            `INST_BSET     : begin ex_unit = BMU; ex_bmu_control = `BMU_BSET; end
+            `INST_CLMUL    : begin ex_unit = BMU; ex_bmu_control = `BMU_CLMUL; end
+            `INST_CLMULH   : begin ex_unit = BMU; ex_bmu_control = `BMU_CLMULH; end
+            `INST_CLMULR   : begin ex_unit = BMU; ex_bmu_control = `BMU_CLMULR; end
+            `INST_MAX      : begin ex_unit = BMU; ex_bmu_control = `BMU_MAX; end
+            `INST_MAXU     : begin ex_unit = BMU; ex_bmu_control = `BMU_MAXU; end
+            `INST_MIN      : begin ex_unit = BMU; ex_bmu_control = `BMU_MIN; end
+            `INST_MINU     : begin ex_unit = BMU; ex_bmu_control = `BMU_MINU; end
+            `INST_ORN      : begin ex_unit = BMU; ex_bmu_control = `BMU_ORN; end
+            `INST_ROL      : begin ex_unit = BMU; ex_bmu_control = `BMU_ROL; end
+            `INST_ROR      : begin ex_unit = BMU; ex_bmu_control = `BMU_ROR; end
+            `INST_SH1ADD   : begin ex_unit = BMU; ex_bmu_control = `BMU_SH1ADD; end
+            `INST_SH2ADD   : begin ex_unit = BMU; ex_bmu_control = `BMU_SH2ADD; end
+            `INST_SH3ADD   : begin ex_unit = BMU; ex_bmu_control = `BMU_SH3ADD; end
+            `INST_XNOR     : begin ex_unit = BMU; ex_bmu_control = `BMU_XNOR; end
+            `INST_XPERM16  : begin ex_unit = BMU; ex_bmu_control = `BMU_XPERM16; end
+            `INST_XPERM32  : begin ex_unit = BMU; ex_bmu_control = `BMU_XPERM32; end
+            `INST_XPERM4   : begin ex_unit = BMU; ex_bmu_control = `BMU_XPERM4; end
+            `INST_XPERM8   : begin ex_unit = BMU; ex_bmu_control = `BMU_XPERM8; end
+            `INST_ZEXTH32  : begin ex_unit = BMU; ex_bmu_control = `BMU_ZEXTH32; end
+            `INST_ZEXTH64  : begin ex_unit = BMU; ex_bmu_control = `BMU_ZEXTH64; end
+            `INST_ROLW     : if (XLEN >= 64) begin ex_unit = BMU; ex_bmu_control = `BMU_ROL; end else ex_illegal = 1'b1;
+            `INST_RORW     : if (XLEN >= 64) begin ex_unit = BMU; ex_bmu_control = `BMU_ROR; end else ex_illegal = 1'b1;
+            `INST_ADD_UW   : if (XLEN >= 64) begin ex_unit = BMU; ex_bmu_control = `BMU_ADD_UW; end else ex_illegal = 1'b1;
+            `INST_SH1ADD_UW: if (XLEN >= 64) begin ex_unit = BMU; ex_bmu_control = `BMU_SH1ADD_UW; end else ex_illegal = 1'b1;
+            `INST_SH2ADD_UW: if (XLEN >= 64) begin ex_unit = BMU; ex_bmu_control = `BMU_SH2ADD_UW; end else ex_illegal = 1'b1;
+            `INST_SH3ADD_UW: if (XLEN >= 64) begin ex_unit = BMU; ex_bmu_control = `BMU_SH3ADD_UW; end else ex_illegal = 1'b1;
+            `endif // SUPPORT_B /////////////////////////////////////////////////
+            `INST_ADDW     : if (XLEN >= 64) begin ex_alu_control = `ALU_ADD; ex_word_op = 1'b1; end else ex_illegal = 1'b1;
+            `INST_SUBW     : if (XLEN >= 64) begin ex_alu_control = `ALU_SUB; ex_word_op = 1'b1; end else ex_illegal = 1'b1;
+            `INST_SLLW     : if (XLEN >= 64) begin ex_alu_control = `ALU_SLL; ex_word_op = 1'b1; end else ex_illegal = 1'b1;
+            `INST_SRLW     : if (XLEN >= 64) begin ex_alu_control = `ALU_SRL; ex_word_op = 1'b1; ex_word_zext = 1'b1; end else ex_illegal = 1'b1;
+            `INST_SRAW     : if (XLEN >= 64) begin ex_alu_control = `ALU_SRA; ex_word_op = 1'b1; end else ex_illegal = 1'b1;
+            default        : ex_illegal = 1'b1;
+        endcase
+    end else if (is_op_imm) begin
+        ex_writes_rd = 1'b1;
+        ex_uses_rs1  = 1'b1;
+        casez ({opcode, funct3, funct12})
+            `INST_ADDI   : ex_alu_control = `ALU_ADD;
+            `INST_SLLI   : ex_alu_control = `ALU_SLL;
+            `INST_SLTI   : ex_alu_control = `ALU_SLT;
+            `INST_SLTIU  : ex_alu_control = `ALU_SLTU;
+            `INST_XORI   : ex_alu_control = `ALU_XOR;
+            `INST_ORI    : ex_alu_control = `ALU_OR;
+            `INST_ANDI   : ex_alu_control = `ALU_AND;
+            `INST_SRLI   : ex_alu_control = `ALU_SRL;
+            `INST_SRAI   : ex_alu_control = `ALU_SRA;
+            `ifdef SUPPORT_B ////////////////////////////////////////////////////
+            `INST_BCLRI  : begin ex_unit = BMU; ex_bmu_control = `BMU_BCLR; end
+            `INST_BINVI  : begin ex_unit = BMU; ex_bmu_control = `BMU_BINV; end
+            `INST_BSETI  : begin ex_unit = BMU; ex_bmu_control = `BMU_BSET; end
+            `INST_CLZ    : begin ex_unit = BMU; ex_bmu_control = `BMU_CLZ; end
+            `INST_CPOP   : begin ex_unit = BMU; ex_bmu_control = `BMU_CPOP; end
+            `INST_CTZ    : begin ex_unit = BMU; ex_bmu_control = `BMU_CTZ; end
+            `INST_SEXT_B : begin ex_unit = BMU; ex_bmu_control = `BMU_SEXTB; end
+            `INST_SEXT_H : begin ex_unit = BMU; ex_bmu_control = `BMU_SEXTH; end
+            `INST_SHFLI  : begin ex_unit = BMU; ex_bmu_control = `BMU_SHFL; end
+            `INST_BEXTI  : begin ex_unit = BMU; ex_bmu_control = `BMU_BEXT; end
+            `INST_GREVI  : begin ex_unit = BMU; ex_bmu_control = `BMU_GREV; end
+            `INST_ORCB   : begin ex_unit = BMU; ex_bmu_control = `BMU_ORCB; end
+            `INST_RORI   : begin ex_unit = BMU; ex_bmu_control = `BMU_ROR; end
+            `INST_UNSHFLI: begin ex_unit = BMU; ex_bmu_control = `BMU_UNSHFL; end
+            `INST_CLZW   : if (XLEN >= 64) begin ex_unit = BMU; ex_bmu_control = `BMU_CLZ; end else ex_illegal = 1'b1;
+            `INST_CPOPW  : if (XLEN >= 64) begin ex_unit = BMU; ex_bmu_control = `BMU_CPOP; end else ex_illegal = 1'b1;
+            `INST_CTZW   : if (XLEN >= 64) begin ex_unit = BMU; ex_bmu_control = `BMU_CTZ; end else ex_illegal = 1'b1;
+            `INST_RORIW  : if (XLEN >= 64) begin ex_unit = BMU; ex_bmu_control = `BMU_ROR; end else ex_illegal = 1'b1;
+            `INST_SLLIUW : if (XLEN >= 64) begin ex_unit = BMU; ex_bmu_control = `BMU_SLLIUW; end else ex_illegal = 1'b1;
+            `endif // SUPPORT_B /////////////////////////////////////////////////
+            `INST_ADDIW  : if (XLEN >= 64) begin ex_alu_control = `ALU_ADD; ex_word_op = 1'b1; end else ex_illegal = 1'b1;
+            `INST_SLLIW  : if (XLEN >= 64) begin ex_alu_control = `ALU_SLL; ex_word_op = 1'b1; end else ex_illegal = 1'b1;
+            `INST_SRLIW  : if (XLEN >= 64) begin ex_alu_control = `ALU_SRL; ex_word_op = 1'b1; ex_word_zext = 1'b1; end else ex_illegal = 1'b1;
+            `INST_SRAIW  : if (XLEN >= 64) begin ex_alu_control = `ALU_SRA; ex_word_op = 1'b1; end else ex_illegal = 1'b1;
+            default      : ex_illegal = 1'b1;
+        endcase
+    end else if (is_branch) begin
+        ex_uses_rs1 = 1'b1;
+        ex_uses_rs2 = 1'b1;
+        case ({opcode, funct3})
+            `INST_BEQ,
+            `INST_BNE,
+            `INST_BLT,
+            `INST_BLTU,
+            `INST_BGE,
+            `INST_BGEU: ex_alu_control = `ALU_SUB;
+            default   : ex_illegal = 1'b1;
+        endcase
+    end else if (ex_is_load) begin
+        ex_writes_rd = 1'b1;
+        ex_uses_rs1  = 1'b1;
+        case ({opcode, funct3})
+            `INST_LB, `INST_LH, `INST_LW, `INST_LBU, `INST_LHU: ;
+            `INST_LWU, `INST_LD: if (XLEN < 64) ex_illegal = 1'b1;
+            default: ex_illegal = 1'b1;
+        endcase
+    end else if (ex_is_store) begin
+        ex_uses_rs1 = 1'b1;
+        ex_uses_rs2 = 1'b1;
+        case ({opcode, funct3})
+            `INST_SB, `INST_SH, `INST_SW: ;
+            `INST_SD: if (XLEN < 64) ex_illegal = 1'b1;
+            default: ex_illegal = 1'b1;
+        endcase
+    end else if (is_lui || is_auipc || is_jal) begin
+        ex_writes_rd = 1'b1;
+    end else if (is_jalr) begin
+        ex_writes_rd = 1'b1;
+        ex_uses_rs1  = 1'b1;
+    end else if (is_system) begin
+        casez ({opcode, funct3, funct12})
+            `INST_EBREAK: ex_is_ebreak = 1'b1;
+            `INST_ECALL : ex_is_ecall  = 1'b1;
+            `INST_WIFI  : ; // Executed as a no-op
+            `ifdef SUPPORT_ZICSR ////////////////////////////////////////////////
+            `INST_MRET  : ex_is_mret = 1'b1;
+            `INST_CSRRW : begin ex_is_csr = 1'b1; ex_writes_rd = 1'b1; ex_uses_rs1 = 1'b1; ex_csr_control = `CSR_RW; end
+            `INST_CSRRS : begin ex_is_csr = 1'b1; ex_writes_rd = 1'b1; ex_uses_rs1 = 1'b1; ex_csr_control = `CSR_RS; end
+            `INST_CSRRC : begin ex_is_csr = 1'b1; ex_writes_rd = 1'b1; ex_uses_rs1 = 1'b1; ex_csr_control = `CSR_RC; end
+            `INST_CSRRWI: begin ex_is_csr = 1'b1; ex_writes_rd = 1'b1; ex_csr_control = `CSR_RWI; end
+            `INST_CSRRSI: begin ex_is_csr = 1'b1; ex_writes_rd = 1'b1; ex_csr_control = `CSR_RSI; end
+            `INST_CSRRCI: begin ex_is_csr = 1'b1; ex_writes_rd = 1'b1; ex_csr_control = `CSR_RCI; end
+            `endif // SUPPORT_ZICSR /////////////////////////////////////////////
+            default     : ex_illegal = 1'b1;
+        endcase
+    end else if (opcode == 7'b0001111) begin
+        // fence is a no-op for an in-order core, fence.i refetches everything after it
+        case ({opcode, funct3})
+            `INST_FENCE : ex_is_fence = 1'b1;
+            `INST_FENCEI: ex_is_fencei = 1'b1;
+            default     : ex_illegal = 1'b1;
+        endcase
+    end else begin
+        ex_illegal = 1'b1;
+    end
+
+    // Only RV64 has *W instructions
+    if (XLEN < 64) begin
+        ex_word_op   = 1'b0;
+        ex_word_zext = 1'b0;
+    end
+end
+
+// ──────────────────────────
+// EX Stage: Operands
+// ──────────────────────────
+logic [XLEN-1:0] ex_op_a, ex_op_b;  // rs1/rs2 after forwarding and *W extension
+logic [XLEN-1:0] ex_imm_operand;    // Immediate, or the shift amount for shift immediates
+
+always_comb begin
+    ex_op_a = ex_fwd_rs1;
+    ex_op_b = ex_fwd_rs2;
+    if (ex_word_op) begin
+        ex_op_a = ex_word_zext ? {{(XLEN-32){1'b0}}, ex_fwd_rs1[31:0]} : {{(XLEN-32){ex_fwd_rs1[31]}}, ex_fwd_rs1[31:0]};
+        ex_op_b = ex_word_zext ? {{(XLEN-32){1'b0}}, ex_fwd_rs2[31:0]} : {{(XLEN-32){ex_fwd_rs2[31]}}, ex_fwd_rs2[31:0]};
+        if (ex_unit == ALU && (funct3 == 3'b001 || funct3 == 3'b101)) begin
+            // Word shifts only use a 5 bit shift amount
+            ex_op_b = {{(XLEN-5){1'b0}}, ex_fwd_rs2[4:0]};
+        end
+    end
+
+    if (is_op_imm && (funct3 == 3'b001 || funct3 == 3'b101)) begin
+        if (XLEN >= 64 && ~ex_word_op) begin
+            ex_imm_operand = {{(XLEN-6){1'b0}}, ex_instr[25:20]};
+        end else begin
+            ex_imm_operand = {{(XLEN-5){1'b0}}, ex_instr[24:20]};
+        end
+    end else begin
+        ex_imm_operand = imm;
+    end
+end
+
+// ──────────────────────────
+// ALU Signals
+// ──────────────────────────
+logic [XLEN-1:0] alu_operand_a, alu_operand_b;
+logic [XLEN-1:0] alu_result;
+logic            alu_zero;
+logic            alu_less_than;
+logic            alu_unsigned_less_than;
+
+assign alu_operand_a = is_lui   ? {XLEN{1'b0}} :
+                       is_auipc ? ex_pc        :
+                                  ex_op_a;
+assign alu_operand_b = (is_op || is_branch) ? ex_op_b : ex_imm_operand;
+
+// ──────────────────────────
+// Instantiate ALU
+// ──────────────────────────
+cpu_alu #(.XLEN(XLEN)) alu_inst (
+    .operand_a          (alu_operand_a),
+    .operand_b          (alu_operand_b),
+    .control            (ex_alu_control),
+    .result             (alu_result),
+    .zero               (alu_zero),
+    .less_than          (alu_less_than),
+    .unsigned_less_than (alu_unsigned_less_than)
+);
+
+`ifdef SUPPORT_B
+// ──────────────────────────
+// Instantiate BMU
+// ──────────────────────────
+logic [XLEN-1:0] bmu_result;
+
+cpu_bmu #(.XLEN(XLEN)) bmu_inst (
+    .operand_a          (alu_operand_a),
+    .operand_b          (alu_operand_b),
+    .control            (ex_bmu_control),
+    .result             (bmu_result)
+);
+`endif
+
+`ifdef SUPPORT_M
+// ──────────────────────────
+// MDU Signals
+// ──────────────────────────
+logic [XLEN-1:0] mdu_result;
+logic            mdu_start;   // One cycle start pulse
+logic            mdu_ready;
+logic            mdu_issued;  // The MDU is working on the instruction in EX
+logic            mdu_done;    // The MDU result for the instruction in EX is available
+
+// ──────────────────────────
+// Instantiate MDU
+// ──────────────────────────
+cpu_mdu #(
+    .XLEN(XLEN),
+    .MDU_IMPL(MDU_IMPL),
+    .MUL_STAGES(MDU_MUL_STAGES)
+) mdu_inst (
+    .clk                (clk),
+    .reset              (reset),
+    .operand_a          (ex_op_a),
+    .operand_b          (ex_op_b),
+    .control            (ex_mdu_control),
+    .start              (mdu_start),
+    .result             (mdu_result),
+    .ready              (mdu_ready)
+);
+`endif
+
+// ──────────────────────────
+// Memory Interface Signals
+// ──────────────────────────
+logic                   mem_ready;
+logic [XLEN-1:0]        mem_address;
+logic [XLEN-1:0]        mem_wdata;
+logic [XLEN/8-1:0]      mem_wstrb;
+logic [2:0]             mem_size;   // Byte, Halfword, Word
+logic                   mem_read;
+logic                   mem_ack;
+logic [XLEN-1:0]        mem_rdata;
+logic                   mem_valid;
+logic                   mem_denied;
+logic                   mem_corrupt;
+
+// ──────────────────────────
+// tl_interface CPU Side Signals
+// ──────────────────────────
+logic                   bus_ready;
+logic [XLEN-1:0]        bus_address;
+logic [XLEN-1:0]        bus_wdata;
+logic [XLEN/8-1:0]      bus_wstrb;
+logic [2:0]             bus_size;
+logic                   bus_read;
+logic                   bus_ack;
+logic [XLEN-1:0]        bus_rdata;
+logic                   bus_valid;
+logic                   bus_denied;
+logic                   bus_corrupt;
+
+// ──────────────────────────
+// Data Cache Side Signals
+// ──────────────────────────
+logic                   dc_ready;
+logic                   dc_fetch;
+logic [XLEN-1:0]        dc_address;
+logic [XLEN-1:0]        dc_wdata;
+logic [XLEN/8-1:0]      dc_wstrb;
+logic [2:0]             dc_size;
+logic                   dc_read;
+logic                   dc_ack;
+logic [XLEN-1:0]        dc_rdata;
+logic                   dc_valid;
+logic                   dc_denied;
+logic                   dc_corrupt;
+
+`ifdef SUPPORT_ICACHE
+// ──────────────────────────
+// Instantiate Instruction Cache
+// ──────────────────────────
+logic                   icache_invalidate;
+logic [XLEN-1:0]        icache_hits;
+logic [XLEN-1:0]        icache_misses;
+
+cpu_icache #(
+    .XLEN(XLEN),
+    .SIZE(ICACHE_SIZE),
+    .LINE(ICACHE_LINE)
+) icache_inst (
+    .clk         (clk),
+    .reset       (reset),
+
+    // CPU Side
+    .cpu_ready   (mem_ready),
+    .cpu_fetch   (bus_state == BUS_FETCH),
+    .cpu_address (mem_address),
+    .cpu_wdata   (mem_wdata),
+    .cpu_wstrb   (mem_wstrb),
+    .cpu_size    (mem_size),
+    .cpu_read    (mem_read),
+    .cpu_ack     (mem_ack),
+    .cpu_rdata   (mem_rdata),
+    .cpu_denied  (mem_denied),
+    .cpu_corrupt (mem_corrupt),
+    .cpu_valid   (mem_valid),
+
+    // Data Cache / tl_interface Side
+    .if_ready    (dc_ready),
+    .if_fetch    (dc_fetch),
+    .if_address  (dc_address),
+    .if_wdata    (dc_wdata),
+    .if_wstrb    (dc_wstrb),
+    .if_size     (dc_size),
+    .if_read     (dc_read),
+    .if_ack      (dc_ack),
+    .if_rdata    (dc_rdata),
+    .if_denied   (dc_denied),
+    .if_corrupt  (dc_corrupt),
+    .if_valid    (dc_valid),
+
+    .invalidate  (icache_invalidate),
+    .hit_count   (icache_hits),
+    .miss_count  (icache_misses)
+);
+`else
+assign dc_ready    = mem_ready;
+assign dc_fetch    = (bus_state == BUS_FETCH);
+assign dc_address  = mem_address;
+assign dc_wdata    = mem_wdata;
+assign dc_wstrb    = mem_wstrb;
+assign dc_size     = mem_size;
+assign dc_read     = mem_read;
+assign mem_ack     = dc_ack;
+assign mem_rdata   = dc_rdata;
+assign mem_valid   = dc_valid;
+assign mem_denied  = dc_denied;
+assign mem_corrupt = dc_corrupt;
+`endif
+
+`ifdef SUPPORT_DCACHE
+// ──────────────────────────
+// Instantiate Data Cache
+// ──────────────────────────
+logic                   dcache_fence;
+logic                   dcache_drained;
+logic [XLEN-1:0]        dcache_hits;
+logic [XLEN-1:0]        dcache_misses;
+
+cpu_dcache #(
+    .XLEN(XLEN),
+    .SIZE(DCACHE_SIZE),
+    .LINE(DCACHE_LINE),
+    .SB_DEPTH(DCACHE_SB_DEPTH),
+    .CACHED_BASE(DCACHE_BASE),
+    .CACHED_MASK(DCACHE_MASK)
+) dcache_inst (
+    .clk         (clk),
+    .reset       (reset),
+
+    // Instruction Cache Side
+    .cpu_ready   (dc_ready),
+    .cpu_fetch   (dc_fetch),
+    .cpu_address (dc_address),
+    .cpu_wdata   (dc_wdata),
+    .cpu_wstrb   (dc_wstrb),
+    .cpu_size    (dc_size),
+    .cpu_read    (dc_read),
+    .cpu_ack     (dc_ack),
+    .cpu_rdata   (dc_rdata),
+    .cpu_denied  (dc_denied),
+    .cpu_corrupt (dc_corrupt),
+    .cpu_valid   (dc_valid),
+
+    // tl_interface Side
+    .if_ready    (bus_ready),
+    .if_address  (bus_address),
+    .if_wdata    (bus_wdata),
+    .if_wstrb    (bus_wstrb),
+    .if_size     (bus_size),
+    .if_read     (bus_read),
+    .if_ack      (bus_ack),
+    .if_rdata    (bus_rdata),
+    .if_denied   (bus_denied),
+    .if_corrupt  (bus_corrupt),
+    .if_valid    (bus_valid),
+
+    .fence       (dcache_fence),
+    .drained     (dcache_drained),
+    .hit_count   (dcache_hits),
+    .miss_count  (dcache_misses)
+);
+
+// Report the halt once every buffered store has reached memory
+assign dbg_halt = halt && dcache_drained;
+`else
+assign bus_ready   = dc_ready;
+assign bus_address = dc_address;
+assign bus_wdata   = dc_wdata;
+assign bus_wstrb   = dc_wstrb;
+assign bus_size    = dc_size;
+assign bus_read    = dc_read;
+assign dc_ack      = bus_ack;
+assign dc_rdata    = bus_rdata;
+assign dc_valid    = bus_valid;
+assign dc_denied   = bus_denied;
+assign dc_corrupt  = bus_corrupt;
+`endif
+
+// ──────────────────────────
+// Instantiate Memory Interface
+// ──────────────────────────
+tl_interface #(
+    .XLEN(XLEN),
+    .SID_WIDTH(SID_WIDTH)
+) mem_if_inst (
+    .clk         (clk),
+    .reset       (reset),
+
+    // CPU Side
+    .cpu_ready   (bus_ready),
+    .cpu_address (bus_address),
+    .cpu_wdata   (bus_wdata),
+    .cpu_wstrb   (bus_wstrb),
+    .cpu_size    (bus_size),
+    .cpu_read    (bus_read),
+    .cpu_amo_opcode(3'b000),
+    .cpu_amo_param (3'b000),
+    .cpu_ack     (bus_ack),
+    .cpu_rdata   (bus_rdata),
+    .cpu_denied  (bus_denied),
+    .cpu_corrupt (bus_corrupt),
+    .cpu_valid   (bus_valid),
+
+    // TileLink TL-UL Interface signals
+    .tl_a_valid  (tl_a_valid),
+    .tl_a_ready  (tl_a_ready),
+    .tl_a_opcode (tl_a_opcode),
+    .tl_a_param  (tl_a_param),
+    .tl_a_size   (tl_a_size),
+    .tl_a_source (tl_a_source),
+    .tl_a_address(tl_a_address),
+    .tl_a_mask   (tl_a_mask),
+    .tl_a_data   (tl_a_data),
+
+    .tl_d_valid  (tl_d_valid),
+    .tl_d_ready  (tl_d_ready),
+    .tl_d_opcode (tl_d_opcode),
+    .tl_d_param  (tl_d_param),
+    .tl_d_size   (tl_d_size),
+    .tl_d_source (tl_d_source),
+    .tl_d_data   (tl_d_data),
+    .tl_d_corrupt(tl_d_corrupt),
+    .tl_d_denied (tl_d_denied)
+);
+
+`ifdef SUPPORT_ZICSR
+// ──────────────────────────
+// CSR Module Signals
+// ──────────────────────────
+logic [XLEN-1:0] csr_reg_rdata;
+logic            csr_reg_write_en;
+logic [11:0]     csr_reg_addr;
+logic [XLEN-1:0] csr_reg_wdata;
+
+logic            csr_op_valid;
+logic            csr_op_ready;
+logic            csr_op_done;
+logic [XLEN-1:0] csr_op_rdata;
+logic [11:0]     csr_op_addr;    // CSR operation address
+logic [2:0]      csr_op_control; // CSR operation control signal
+logic [XLEN-1:0] csr_op_operand; // Operand for CSR operations
+logic [4:0]      csr_op_imm;     // Immediate for CSR operations
+
+logic [XLEN-1:0] csr_mtvec;      // Machine Trap-Vector Base-Address Register
+logic [XLEN-1:0] csr_mepc;       // Machine Exception Program Counter
+logic [XLEN-1:0] csr_mcause;     // Machine Cause Register
+
+// Interrupt CSRs
+logic            interrupt_pending;
+
+// Performance counter events, see below
+logic            perf_retire;
+logic [4:0]      perf_event;
+
+typedef enum logic [1:0] {
+    STORE_PC,
+    STORE_CAUSE,
+    CONTINUE
+} cpu_trap_state_t;
+cpu_trap_state_t trap_state;
+
+// CSR instruction sequencing in EX
+typedef enum logic [1:0] {
+    CSR_OP_IDLE,    // Issue the operation
+    CSR_OP_READ,    // Capture the old CSR value
+    CSR_OP_WAIT,    // Wait for the write to finish
+    CSR_OP_DONE     // Result ready, EX may advance
+} cpu_csr_op_state_t;
+cpu_csr_op_state_t csr_op_state;
+logic [XLEN-1:0]   csr_result;
+
+// ──────────────────────────
+// Instantiate CSR Module
+// ──────────────────────────
+cpu_csr #(
+    .XLEN(XLEN),
+    .NMI_COUNT(NMI_COUNT),
+    .IRQ_COUNT(IRQ_COUNT),
+    .MHARTID_VAL(MHARTID_VAL),
+    .MTVEC_RESET_VAL(MTVEC_RESET_VAL)
+) cpu_csr_inst (
+    .clk         (clk),
+    .reset       (reset),
+
+    // CSR Register Interface
+    .reg_addr    (csr_reg_addr),     // CSR address for Register Interface
+    .reg_write_en(csr_reg_write_en), // Write enable for Register Interface
+    .reg_wdata   (csr_reg_wdata),    // Write data for Register Interface
+    .reg_rdata   (csr_reg_rdata),    // Read data from Register Interface
+
+    // CSR Operation Interface
+    .op_valid    (csr_op_valid),     // Operation valid
+    .op_ready    (csr_op_ready),     // Operation ready
+    .op_control  (csr_op_control),   // CSR operation control signals
+    .op_addr     (csr_op_addr),      // CSR address for Operation Interface
+    .op_operand  (csr_op_operand),   // Operand for CSR operations
+    .op_imm      (csr_op_imm),       // Immediate for CSR operations
+    .op_rdata    (csr_op_rdata),     // Read data from Operation Interface
+    .op_done     (csr_op_done),      // Operation done signal
+
+    // Exposed Registers
+    .mtvec       (csr_mtvec),        // Exposed for trap logic
+    .mepc        (csr_mepc),         // Exposed for INST_MRET logic
+    .mcause      (csr_mcause),       // Exposed for trap logic
+
+    // Output Signals
+    .interrupt_pending(interrupt_pending),
+
+    // Performance Counter Events
+    .perf_retire (perf_retire),      // minstret
+    .perf_event  (perf_event),       // mhpmcounter3..7
+
+    // Interrupt Request Lines
+    .irq         (external_irq),     // Standard IRQs
+    .nmi         (external_nmi),     // Non-Maskable IRQs (Edge-Triggered)
+    .timer_irq   (external_timer)    // Machine Timer Interrupt
+);
+`endif
+
+// ──────────────────────────
+// EX Stage: Results, Branches and Exceptions
+// ──────────────────────────
+logic [XLEN-1:0]   ex_result;
+logic [XLEN-1:0]   ex_target;      // Redirect target for jumps, branches and mret
+logic              ex_take_branch;
+logic              ex_redirect_op; // Instruction in EX changes the fetch PC
+logic              ex_is_halt;     // Self jump
+logic              ex_misaligned;
+logic              ex_exception;
+trap_cause_t       ex_cause;
+logic [XLEN/8-1:0] ex_wstrb;
+logic [XLEN-1:0]   ex_wdata;
+
+always_comb begin
+    // Result
+    case (ex_unit)
+        `ifdef SUPPORT_B
+        BMU:     ex_result = bmu_result;
+        `endif
+        `ifdef SUPPORT_M
+        MDU:     ex_result = mdu_result;
+        `endif
+        default: ex_result = alu_result;
+    endcase
+    if (ex_word_op) begin
+        ex_result = {{(XLEN-32){ex_result[31]}}, ex_result[31:0]};
+    end
+    if (is_jal || is_jalr) begin
+        ex_result = ex_pc + 4;
+    end
+    `ifdef SUPPORT_ZICSR
+    if (ex_is_csr) begin
+        ex_result = csr_result;
+    end
+    `endif
+
+    // Branch Decision Logic
+    case (funct3)
+        3'b000:  ex_take_branch = alu_zero;                // BEQ
+        3'b001:  ex_take_branch = ~alu_zero;               // BNE
+        3'b100:  ex_take_branch = alu_less_than;           // BLT
+        3'b101:  ex_take_branch = ~alu_less_than;          // BGE
+        3'b110:  ex_take_branch = alu_unsigned_less_than;  // BLTU
+        3'b111:  ex_take_branch = ~alu_unsigned_less_than; // BGEU
+        default: ex_take_branch = 1'b0;
+    endcase
+
+    // Redirect target
+    ex_target = ex_pc + imm;
+    if (is_jalr) begin
+        ex_target = (ex_fwd_rs1 + imm) & ~{{(XLEN-1){1'b0}}, 1'b1}; // Clear LSB
+    end
+    `ifdef SUPPORT_ZICSR
+    if (ex_is_mret) begin
+        ex_target = csr_mepc;
+    end
+    `endif
+    if (ex_is_fencei) begin
+        ex_target = ex_pc + 4;
+    end
+
+    ex_redirect_op = (is_branch && ex_take_branch) || is_jal || is_jalr || ex_is_mret || ex_is_fencei;
+    ex_is_halt     = (is_jal || is_jalr) && (ex_target == ex_pc);
+
+    // Load/Store alignment
+    case (funct3[1:0])
+        2'b00:   ex_misaligned = 1'b0;
+        2'b01:   ex_misaligned = alu_result[0];
+        2'b10:   ex_misaligned = (alu_result[1:0] != 2'b00);
+        default: ex_misaligned = (alu_result[2:0] != 3'b000);
+    endcase
+
+    // Store data is right justified, the mask selects the byte lanes of the address
+    case (funct3[1:0])
+        2'b00: begin
+            ex_wdata = {{(XLEN-8){1'b0}}, ex_fwd_rs2[7:0]};
+            ex_wstrb = {{(WSTRB_WIDTH-1){1'b0}}, 1'b1} << alu_result[LANE_BITS-1:0];
+        end
+        2'b01: begin
+            ex_wdata = {{(XLEN-16){1'b0}}, ex_fwd_rs2[15:0]};
+            ex_wstrb = {{(WSTRB_WIDTH-2){1'b0}}, 2'b11} << alu_result[LANE_BITS-1:0];
+        end
+        2'b10: begin
+            ex_wdata = {{(XLEN-32){1'b0}}, ex_fwd_rs2[31:0]};
+            ex_wstrb = {{(WSTRB_WIDTH-4){1'b0}}, 4'b1111} << alu_result[LANE_BITS-1:0];
+        end
+        default: begin
+            ex_wdata = ex_fwd_rs2;
+            ex_wstrb = {WSTRB_WIDTH{1'b1}};
+        end
+    endcase
+
+    // Exceptions
+    ex_exception = 1'b1;
+    if (ex_illegal) begin
+        ex_cause = TRAP_INSTRUCTION;
+    end else if (ex_is_ecall) begin
+        ex_cause = TRAP_ECALL;
+    end else if (ex_is_ebreak) begin
+        ex_cause = TRAP_EBREAK;
+    end else if (ex_is_load && ex_misaligned) begin
+        ex_cause = TRAP_L_MISALIGNED;
+    end else if (ex_is_store && ex_misaligned) begin
+        ex_cause = TRAP_S_MISALIGNED;
+    end else if (ex_redirect_op && ex_target[1:0] != 2'b00) begin
+        ex_cause = TRAP_I_MISALIGNED;
+    end else begin
+        ex_cause     = TRAP_UNKNOWN;
+        ex_exception = 1'b0;
+    end
+end
+
+// ──────────────────────────
+// Hazard Detection and Stage Control
+// ──────────────────────────
+logic mem_data_done;    // The load/store in MEM finished this cycle
+logic mem_stall;        // MEM is waiting on the bus
+logic ex_load_hazard;   // EX needs a load result that is not on the forwarding network yet
+logic ex_unit_wait;     // EX waits on a multi-cycle unit (MDU or CSR)
+logic ex_advance;       // EX moves its instruction into MEM this cycle
+logic ex_redirect;      // EX redirects the fetch PC this cycle
+logic ex_trap;          // EX takes an exception this cycle
+logic take_interrupt;   // An interrupt is taken this cycle
+logic intr_drain;       // An interrupt is waiting for the pipeline to drain
+logic trap_active;      // The trap sequence is running
+logic trap_enter;       // A trap starts this cycle
+logic id_to_ex;         // ID moves its instruction into EX this cycle
+logic fetch_req;        // IF may start a new fetch this cycle
+logic [XLEN-1:0] load_data;
+
+assign mem_data_done  = (bus_state == BUS_DATA) && mem_valid;
+assign mem_stall      = ex_mem_valid && (ex_mem_is_load || ex_mem_is_store) && ~mem_data_done;
+
+assign ex_load_hazard = ex_valid && ex_mem_valid && ex_mem_is_load && ex_mem_rd != 5'b0 &&
+                        ((ex_uses_rs1 && ex_mem_rd == rs1) || (ex_uses_rs2 && ex_mem_rd == rs2));
+
+always_comb begin
+    ex_unit_wait = 1'b0;
+    `ifdef SUPPORT_M
+    if (ex_unit == MDU && ~mdu_done) ex_unit_wait = 1'b1;
+    `endif
+    `ifdef SUPPORT_ZICSR
+    if (ex_is_csr && csr_op_state != CSR_OP_DONE) ex_unit_wait = 1'b1;
+    `endif
+end
+
+`ifdef SUPPORT_ZICSR
+assign intr_drain     = interrupt_pending && ~trap_active;
+assign take_interrupt = intr_drain && id_valid && ~ex_valid && ~ex_mem_valid;
+`else
+assign intr_drain     = 1'b0;
+assign take_interrupt = 1'b0;
+`endif
+
+assign ex_advance  = ex_valid && ~trap_active && ~ex_load_hazard && ~ex_exception && ~ex_unit_wait && ~mem_stall;
+assign ex_redirect = ex_advance && ex_redirect_op;
+assign ex_trap     = ex_valid && ~trap_active && ~ex_load_hazard && ex_exception && ~ex_mem_valid;
+assign trap_enter  = ex_trap || take_interrupt;
+assign id_to_ex    = id_valid && (~ex_valid || ex_advance) && ~ex_redirect && ~trap_active && ~trap_enter && ~intr_drain;
+assign fetch_req   = (~id_valid || id_to_ex) && ~ex_redirect && ~trap_active && ~trap_enter;
+
+// Load data sign/zero extension
+always_comb begin
+    case (ex_mem_funct3)
+        3'b000:  load_data = {{(XLEN-8){mem_rdata[7]}}, mem_rdata[7:0]};     // LB
+        3'b001:  load_data = {{(XLEN-16){mem_rdata[15]}}, mem_rdata[15:0]};  // LH
+        3'b010:  load_data = {{(XLEN-32){mem_rdata[31]}}, mem_rdata[31:0]};  // LW
+        3'b100:  load_data = {{(XLEN-8){1'b0}}, mem_rdata[7:0]};             // LBU
+        3'b101:  load_data = {{(XLEN-16){1'b0}}, mem_rdata[15:0]};           // LHU
+        3'b110:  load_data = {{(XLEN-32){1'b0}}, mem_rdata[31:0]};           // LWU
+        default: load_data = mem_rdata;                                      // LD
+    endcase
+end
+
+`ifdef SUPPORT_ZICSR
+// ──────────────────────────
+// Performance Counter Events
+// ──────────────────────────
+// mhpmcounter3: cycles with an instruction fetch in flight
+// mhpmcounter4: cycles MEM stalls the pipeline on a load or store
+// mhpmcounter5: cycles EX waits on the MDU
+// mhpmcounter6: traps taken
+// mhpmcounter7: conditional branches executed
+assign perf_retire   = mem_wb_valid;
+assign perf_event[0] = (bus_state == BUS_FETCH) && ~mem_valid;
+assign perf_event[1] = mem_stall;
+`ifdef SUPPORT_M
+assign perf_event[2] = ex_valid && ex_unit == MDU && ~mdu_done;
+`else
+assign perf_event[2] = 1'b0;
+`endif
+assign perf_event[3] = trap_enter;
+assign perf_event[4] = ex_advance && is_branch;
+`endif
+
+// ──────────────────────────
+// Trap cause to mcause
+// ──────────────────────────
+function automatic [XLEN-1:0] trap_mcause(input [3:0] cause);
+    case (cause)
+        TRAP_I_MISALIGNED: trap_mcause = {XLEN{1'b0}} + 'h0;
+        TRAP_INSTRUCTION:  trap_mcause = {XLEN{1'b0}} + 'h2;
+        TRAP_EBREAK:       trap_mcause = {XLEN{1'b0}} + 'h3;
+        TRAP_L_MISALIGNED: trap_mcause = {XLEN{1'b0}} + 'h5;
+        TRAP_S_MISALIGNED: trap_mcause = {XLEN{1'b0}} + 'h6;
+        TRAP_ECALL:        trap_mcause = {XLEN{1'b0}} + 'hB;
+        TRAP_HALT:         trap_mcause = {XLEN{1'b0}} + 'h100;     // Custom
+        TRAP_INTERRUPT:    trap_mcause = {1'b1, {(XLEN-1){1'b0}}} + 'h3;
+        default:           trap_mcause = {1'b0, {(XLEN-1){1'b1}}}; // Custom
+    endcase
+endfunction
+
+`ifdef SUPPORT_ZICSR
+logic [XLEN-1:0] trap_pc;   // Value stored in mepc
+`endif
+
+// ──────────────────────────
+// Pipeline
+// ──────────────────────────
+always_ff @(posedge clk) begin
+    if (reset) begin
+        pc               <= START_ADDRESS;
+        fetch_pc         <= START_ADDRESS;
+        fetch_kill       <= 1'b0;
+        bus_state        <= BUS_IDLE;
+        trap_cause       <= TRAP_UNKNOWN;
+        trap_reg         <= 1'b0;
+        halt             <= 1'b0;
+        mem_ready        <= 1'b0;
+        mem_read         <= 1'b0;
+        mem_address      <= {XLEN{1'b0}};
+        mem_wdata        <= {XLEN{1'b0}};
+        mem_wstrb        <= {WSTRB_WIDTH{1'b0}};
+        mem_size         <= 3'b010;
+        id_valid         <= 1'b0;
+        id_pc            <= {XLEN{1'b0}};
+        id_instr         <= 32'h0000_0013; // nop
+        ex_valid         <= 1'b0;
+        ex_pc            <= {XLEN{1'b0}};
+        ex_instr         <= 32'h0000_0013; // nop
+        ex_mem_valid     <= 1'b0;
+        mem_wb_valid     <= 1'b0;
+        mem_wb_pc        <= {XLEN{1'b0}};
+        mem_wb_wen       <= 1'b0;
+        mem_wb_halt      <= 1'b0;
+        `ifdef SUPPORT_M
+        mdu_start        <= 1'b0;
+        mdu_issued       <= 1'b0;
+        mdu_done         <= 1'b0;
+        `endif
+        `ifdef SUPPORT_ZICSR
+        trap_active      <= 1'b0;
+        trap_state       <= STORE_PC;
+        trap_pc          <= {XLEN{1'b0}};
+        csr_reg_write_en <= 1'b0;
+        csr_op_valid     <= 1'b0;
+        csr_op_state     <= CSR_OP_IDLE;
+        `endif
+        `ifdef SUPPORT_ICACHE
+        icache_invalidate <= 1'b0;
+        `endif
+        `ifdef SUPPORT_DCACHE
+        dcache_fence      <= 1'b0;
+        `endif
+        `ifdef LOG_CPU `LOG("tl_cpu_pipe.sv", ("Reset, PC=0x%0h", START_ADDRESS)); `endif
+    end else if (halt) begin
+    end else begin
+        trap_reg <= 1'b0;
+        `ifdef SUPPORT_ICACHE
+        icache_invalidate <= 1'b0;
+        `endif
+        `ifdef SUPPORT_DCACHE
+        dcache_fence      <= 1'b0;
+        `endif
+
+        // ──────────────────────────
+        // Bus: one tl_interface shared by IF and MEM, MEM has priority
+        // ──────────────────────────
+        case (bus_state)
+            BUS_IDLE: begin
+                if (~mem_valid && ~mem_ready) begin
+                    if (ex_mem_valid && (ex_mem_is_load || ex_mem_is_store)) begin
+                        mem_ready   <= 1'b1;
+                        mem_address <= ex_mem_result;
+                        mem_read    <= ex_mem_is_load;
+                        mem_size    <= {1'b0, ex_mem_funct3[1:0]};
+                        mem_wdata   <= ex_mem_is_store ? ex_mem_wdata : {XLEN{1'b0}};
+                        mem_wstrb   <= ex_mem_is_store ? ex_mem_wstrb : {WSTRB_WIDTH{1'b0}};
+                        bus_state   <= BUS_DATA;
+                        `ifdef LOG_CPU `LOG("tl_cpu_pipe.sv", ("/MEM/ %0s address=0x%0h", ex_mem_is_load ? "Load" : "Store", ex_mem_result)); `endif
+                    end else if (fetch_req) begin
+                        mem_ready   <= 1'b1;
+                        mem_address <= pc;
+                        mem_read    <= 1'b1;
+                        mem_size    <= 3'b010; // Word size
+                        mem_wdata   <= {XLEN{1'b0}};
+                        mem_wstrb   <= {WSTRB_WIDTH{1'b0}};
+                        fetch_pc    <= pc;
+                        fetch_kill  <= 1'b0;
+                        pc          <= pc + 4;
+                        bus_state   <= BUS_FETCH;
+                        `ifdef LOG_CPU `LOG("tl_cpu_pipe.sv", ("/IF/ Fetching instruction from PC=0x%0h", pc)); `endif
+                    end
+                end
+            end
+
+            BUS_FETCH,
+            BUS_DATA: begin
+                if (mem_ready && mem_ack) begin
+                    mem_ready <= 1'b0; // Deassert after acknowledgment
+                end else if (mem_valid) begin
+                    bus_state <= BUS_IDLE;
+                    if (bus_state == BUS_FETCH && ~fetch_kill) begin
+                        id_valid <= 1'b1;
+                        id_pc    <= fetch_pc;
+                        id_instr <= mem_rdata[31:0]; // Instructions are 32 bits
+                        `ifdef LOG_CPU `LOG("tl_cpu_pipe.sv", ("/IF/ Fetched instruction 0x%08h from PC=0x%0h", mem_rdata[31:0], fetch_pc)); `endif
+                    end
+                    `ifdef LOG_CPU
+                    if (mem_denied) `LOG("tl_cpu_pipe.sv", ("/BUS/ Memory is denied"));
+                    if (mem_corrupt) `LOG("tl_cpu_pipe.sv", ("/BUS/ Memory is corrupt"));
+                    `endif
+                end
+            end
+
+            default: bus_state <= BUS_IDLE;
+        endcase
+
+        // ──────────────────────────
+        // WB: the register file write is combinational from MEM/WB
+        // ──────────────────────────
+        if (mem_wb_valid && mem_wb_halt) begin
+            `ifdef LOG_CPU `LOG("tl_cpu_pipe.sv", ("/WB/ HALT detected PC=0x%0h", mem_wb_pc)); `endif
+            halt <= 1'b1;
+        end
+
+        // ──────────────────────────
+        // MEM
+        // ──────────────────────────
+        if (~mem_stall) begin
+            mem_wb_valid <= ex_mem_valid;
+            mem_wb_pc    <= ex_mem_pc;
+            mem_wb_rd    <= ex_mem_rd;
+            mem_wb_wen   <= ex_mem_wen;
+            mem_wb_halt  <= ex_mem_halt;
+            mem_wb_data  <= ex_mem_is_load ? load_data : ex_mem_result;
+            `ifdef LOG_CPU
+            if (ex_mem_valid && ex_mem_is_load) `LOG("tl_cpu_pipe.sv", ("/MEM/ Received Data=0x%0h for rd=%0d", load_data, ex_mem_rd));
+            `endif
+        end else begin
+            mem_wb_valid <= 1'b0;
+        end
+
+        // ──────────────────────────
+        // EX
+        // ──────────────────────────
+        if (ex_advance) begin
+            ex_mem_valid    <= 1'b1;
+            ex_mem_pc       <= ex_pc;
+            ex_mem_rd       <= rd;
+            ex_mem_wen      <= ex_writes_rd && (rd != 5'b0);
+            ex_mem_result   <= ex_result;
+            ex_mem_is_load  <= ex_is_load;
+            ex_mem_is_store <= ex_is_store;
+            ex_mem_funct3   <= funct3;
+            ex_mem_wdata    <= ex_wdata;
+            ex_mem_wstrb    <= ex_wstrb;
+            ex_mem_halt     <= ex_is_halt;
+            `ifdef SUPPORT_M
+            mdu_issued      <= 1'b0;
+            mdu_done        <= 1'b0;
+            `endif
+            `ifdef SUPPORT_ZICSR
+            csr_op_state    <= CSR_OP_IDLE;
+            if (ex_is_mret) begin
+                trap_reg <= 1'b0;
+            end
+            `endif
+            `ifdef SUPPORT_ICACHE
+            if (ex_is_fencei) begin
+                icache_invalidate <= 1'b1;
+            end
+            `endif
+            `ifdef SUPPORT_DCACHE
+            if (ex_is_fence || ex_is_fencei) begin
+                dcache_fence <= 1'b1;
+            end
+            `endif
+            `ifdef LOG_CPU `LOG("tl_cpu_pipe.sv", ("/EX/ PC=0x%0h instr=0x%08h result=0x%0h", ex_pc, ex_instr, ex_result)); `endif
+        end else begin
+            if (~mem_stall) begin
+                ex_mem_valid <= 1'b0; // Bubble
+            end
+            // Keep the held operands current while producers retire
+            ex_rs1_data <= ex_fwd_rs1;
+            ex_rs2_data <= ex_fwd_rs2;
+        end
+
+        `ifdef SUPPORT_M ////////////////////////////////////////////////////
+        mdu_start <= 1'b0;
+        if (ex_valid && ex_unit == MDU && ~ex_exception && ~ex_load_hazard && ~mdu_issued && ~trap_active) begin
+            mdu_start  <= 1'b1;
+            mdu_issued <= 1'b1;
+        end else if (mdu_issued && mdu_ready) begin
+            mdu_done   <= 1'b1;
+        end
+        `endif // SUPPORT_M /////////////////////////////////////////////////
+
+        `ifdef SUPPORT_ZICSR ////////////////////////////////////////////////
+        if (ex_valid && ex_is_csr && ~ex_exception && ~ex_load_hazard && ~trap_active) begin
+            case (csr_op_state)
+                CSR_OP_IDLE: begin
+                    csr_op_addr    <= funct12;
+                    csr_op_control <= ex_csr_control;
+                    csr_op_operand <= ex_fwd_rs1;
+                    csr_op_imm     <= rs1;
+                    csr_op_valid   <= 1'b1;
+                    csr_op_state   <= CSR_OP_READ;
+                end
+                CSR_OP_READ: begin
+                    csr_result     <= csr_op_rdata;
+                    csr_op_state   <= CSR_OP_WAIT;
+                end
+                CSR_OP_WAIT: begin
+                    if (csr_op_done) begin
+                        csr_op_valid <= 1'b0;
+                        csr_op_state <= CSR_OP_DONE;
+                    end
+                end
+                default: ;
+            endcase
+        end
+        `endif // SUPPORT_ZICSR /////////////////////////////////////////////
+
+        // ──────────────────────────
+        // ID
+        // ──────────────────────────
+        if (id_to_ex) begin
+            ex_valid    <= 1'b1;
+            ex_pc       <= id_pc;
+            ex_instr    <= id_instr;
+            ex_rs1_data <= id_rs1_value;
+            ex_rs2_data <= id_rs2_value;
+            id_valid    <= 1'b0;
+        end else if (ex_advance) begin
+            ex_valid    <= 1'b0; // Bubble
+        end
+
+        // ──────────────────────────
+        // Redirect from EX: squash ID and the fetch in flight
+        // ──────────────────────────
+        if (ex_redirect) begin
+            pc       <= ex_target;
+            id_valid <= 1'b0;
+            if (bus_state == BUS_FETCH && ~mem_valid) begin
+                fetch_kill <= 1'b1;
+            end
+            `ifdef LOG_CPU `LOG("tl_cpu_pipe.sv", ("/EX/ PC redirected to 0x%0h", ex_target)); `endif
+        end
+
+        // ──────────────────────────
+        // Trap entry: flush everything younger than MEM
+        // ──────────────────────────
+        if (trap_enter) begin
+            id_valid   <= 1'b0;
+            ex_valid   <= 1'b0;
+            trap_cause <= take_interrupt ? TRAP_INTERRUPT : ex_cause;
+            if (bus_state == BUS_FETCH && ~mem_valid) begin
+                fetch_kill <= 1'b1;
+            end
+            `ifdef SUPPORT_M
+            mdu_issued <= 1'b0;
+            mdu_done   <= 1'b0;
+            `endif
+            `ifdef SUPPORT_ZICSR
+            // Exceptions resume after the faulting instruction (as tl_cpu.sv does), interrupts
+            // resume at the first instruction that did not execute
+            trap_pc     <= take_interrupt ? id_pc : ex_pc + 4;
+            trap_active <= 1'b1;
+            trap_state  <= STORE_PC;
+            `else
+            // If Zicsr not supported, reset the CPU
+            trap_reg    <= 1'b1;
+            pc          <= START_ADDRESS;
+            `endif
+            `ifdef LOG_CPU `WARN("tl_cpu_pipe.sv", ("/TRAP/ cause=%0d PC=0x%0h", take_interrupt ? TRAP_INTERRUPT : ex_cause, take_interrupt ? id_pc : ex_pc)); `endif
+        end
+
+        `ifdef SUPPORT_ZICSR ////////////////////////////////////////////////
+        // ──────────────────────────
+        // Trap sequence
+        // ──────────────────────────
+        if (trap_active) begin
+            case (trap_state)
+                STORE_PC: begin
+                    csr_reg_addr     <= `CSR_MEPC;
+                    csr_reg_wdata    <= trap_pc;
+                    csr_reg_write_en <= 1'b1;
+                    trap_state       <= STORE_CAUSE;
+                end
+                STORE_CAUSE: begin
+                    csr_reg_addr     <= `CSR_MCAUSE;
+                    csr_reg_wdata    <= trap_mcause(trap_cause);
+                    csr_reg_write_en <= 1'b1;
+                    trap_state       <= CONTINUE;
+                end
+                CONTINUE: begin
+                    // Reset for next trap
+                    csr_reg_write_en <= 1'b0;
+                    trap_state       <= STORE_PC;
+                    trap_active      <= 1'b0;
+
+                    // Set PC to csr_mtvec CSR (trap vector)
+                    if (csr_mtvec[1:0] == 2'b01 && trap_cause == TRAP_INTERRUPT) begin
+                        // Vector mode
+                        pc <= (csr_mtvec & ~{{(XLEN-2){1'b0}}, 2'b11}) + (trap_mcause(trap_cause) << 2);
+                    end else begin
+                        // Direct mode
+                        pc <= csr_mtvec & ~{{(XLEN-2){1'b0}}, 2'b11};
+                    end
+                    `ifdef LOG_CPU `LOG("tl_cpu_pipe.sv", ("/TRAP/ PC updated from mtvec=0x%0h", csr_mtvec)); `endif
+                end
+                default: trap_state <= STORE_PC;
+            endcase
+        end
+        `endif // SUPPORT_ZICSR /////////////////////////////////////////////
+    end
+end
+
+`ifdef SUPPORT_ZICSR
+`else
+assign trap_active = 1'b0;
+`endif
+
+`ifdef DEBUG
+// ──────────────────────────
+// Retire trace
+// ──────────────────────────
+// The instruction word follows its PC down to WB. dbg_state uses the tl_cpu.sv state encoding
+// for what holds the pipeline up: 4 (STATE_MEM) a load or store, 8 (STATE_MUL_DIV) the MDU or
+// another multi-cycle unit, 2 (STATE_ID) a load-use hazard, 1 (STATE_IF) an empty pipeline
+// waiting for a fetch and 3 (STATE_EX) none.
+logic [31:0] ex_mem_instr;
+logic [31:0] mem_wb_instr;
+
+always_ff @(posedge clk) begin
+    if (ex_advance) ex_mem_instr <= ex_instr;
+    if (~mem_stall) mem_wb_instr <= ex_mem_instr;
+end
+
+assign dbg_retire_pc    = mem_wb_pc;
+assign dbg_retire_instr = mem_wb_instr;
+assign dbg_state        = mem_stall                    ? 4'd4 :
+                          (ex_valid && ex_unit_wait)   ? 4'd8 :
+                          (ex_valid && ex_load_hazard) ? 4'd2 :
+                          (~id_valid && ~ex_valid)     ? 4'd1 : 4'd3;
+`endif
+
+`ifdef LOG_CPU_CLOCKED
+// ──────────────────────────
+// Debug pipeline occupancy
+// ──────────────────────────
+always_ff @(posedge clk) begin
+    `LOG("tl_cpu_pipe.sv", ("/CLK/ bus=%0d IF/ID=%0b(0x%0h) ID/EX=%0b(0x%0h) EX/MEM=%0b(0x%0h) MEM/WB=%0b(0x%0h)",
+        bus_state, id_valid, id_pc, ex_valid, ex_pc, ex_mem_valid, ex_mem_pc, mem_wb_valid, mem_wb_pc));
+end
+`endif
+
+endmodule
+
+`endif // __CPU_PIPE__
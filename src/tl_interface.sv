@@ -22,6 +22,8 @@
  *                         if `XLEN` ≥ 64.
  * - `SID_WIDTH` (default: 2): Defines the length of the Source ID for TileLink transactions.
  * - `MAX_RETRIES` (default: 3): Sets the maximum number of retry attempts for failed transactions.
+ * - `MAX_OUTSTANDING` (default: 1): Number of requests that may be in flight at once. Must be a
+ *                                   power of two no larger than 2^`SID_WIDTH`.
  *
  * **Interfaces:**
  *
@@ -33,6 +35,9 @@
  * - `cpu_size`: Specifies the size of the operation.
                  (0: byte, 1: halfword, 2: word, 3: doubleword)
  * - `cpu_read`: Indicates if the operation is a read (`1`) or write (`0`).
+ * - `cpu_amo_opcode`: TileLink opcode of an atomic operation, `ArithmeticData` (`2`) or
+ *                     `LogicalData` (`3`). `0` for a plain read or write.
+ * - `cpu_amo_param`: TileLink param of the atomic operation, see **Atomics** below.
  * - `cpu_ack`: CPU request acknowledgment signal, asserted when a request is captured.
  * - `cpu_rdata`: The read data returned to the CPU for read operations.
  * - `cpu_denied`: Indicates if the CPU request was denied after maximum retries.
@@ -66,6 +71,19 @@
  * for responses, writing read data back to the CPU, and completing transactions. It ensures proper
  * handling of different data sizes (subject to `XLEN`), validates write byte masks, and retries on
  * communication failures up to the configured maximum number of retries.
+ *
+ * With `MAX_OUTSTANDING` > 1 the FSM is replaced by a ring of request slots. `cpu_ack` is returned
+ * as soon as a slot is free, so the requester can issue the next request before the previous
+ * `cpu_valid`, and each slot is sent with its index as `tl_a_source`. D channel responses are
+ * matched by `tl_d_source` and returned to the CPU in request order, one `cpu_valid` per request.
+ * Requests are sent in order, but a retried request is resent after younger requests already on
+ * the bus.
+ *
+ * **Atomics:** A request with `cpu_amo_opcode` set to `ArithmeticData` or `LogicalData` is sent
+ * as that TL-UH atomic, with `cpu_wdata` and `cpu_wstrb` checked the same way as a write. The
+ * slave answers with the memory value from before the operation, which is returned through
+ * `cpu_rdata` like a read. Params are `MIN`, `MAX`, `MINU`, `MAXU`, `ADD` (0-4) for
+ * `ArithmeticData` and `XOR`, `OR`, `AND`, `SWAP` (0-3) for `LogicalData`.
  */
 
 `timescale 1ns / 1ps
@@ -76,7 +94,8 @@
 module tl_interface #(
     parameter XLEN = 32,                        // Bus data width
     parameter SID_WIDTH = 2,                    // Source ID length
-    parameter MAX_RETRIES = 3                   // Maximum number of retry attempts
+    parameter MAX_RETRIES = 3,                  // Maximum number of retry attempts
+    parameter MAX_OUTSTANDING = 1               // Requests in flight, power of two <= 2^SID_WIDTH
 ) (
     input  wire                 clk,
     input  wire                 reset,
@@ -88,6 +107,8 @@ module tl_interface #(
     input  wire [XLEN/8-1:0]    cpu_wstrb,
     input  wire [2:0]           cpu_size,       // 0:byte, 1:halfword, 2:word, 3:doubleword
     input  wire                 cpu_read,       // 1:read, 0:write
+    input  wire [2:0]           cpu_amo_opcode, // 2:ArithmeticData, 3:LogicalData, 0:none
+    input  wire [2:0]           cpu_amo_param,  // Atomic operation
     output reg                  cpu_ack,        // CPU request acknowledgment
     output reg  [XLEN-1:0]      cpu_rdata,      // CPU result data
     output reg                  cpu_denied,     // CPU result is denied
@@ -122,6 +143,8 @@ module tl_interface #(
 // Local parameters for TileLink A-channel opcodes
 localparam [2:0] TL_A_PUT_FULL_DATA_OPCODE    = 3'b000;  // Write full data
 localparam [2:0] TL_A_GET_OPCODE              = 3'b100;  // Read data
+localparam [2:0] TL_A_ARITHMETIC_DATA_OPCODE  = 3'b010;  // Atomic min/max/add
+localparam [2:0] TL_A_LOGICAL_DATA_OPCODE     = 3'b011;  // Atomic xor/or/and/swap
 
 // Local parameters for TileLink D-channel opcodes
 localparam [2:0] TL_D_ACCESS_ACK              = 3'b000;  // Acknowledge access (no data)
@@ -131,6 +154,8 @@ localparam [2:0] TL_D_ACCESS_ACK_ERROR        = 3'b111;  // Acknowledge access w
 
 localparam DEFAULT_PARAM                      = 3'b000;  // Default TL param
 
+localparam SLOT_BITS = (MAX_OUTSTANDING > 1) ? $clog2(MAX_OUTSTANDING) : 1;
+
 reg [5:0] test_reg;
 assign test = {cpu_ready, cpu_ack, test_reg[3:0]};
 
@@ -151,6 +176,13 @@ reg [XLEN-1:0]   req_wdata;
 reg [XLEN/8-1:0] req_wstrb;
 reg [2:0]        req_size;
 reg              req_read;
+reg [2:0]        req_amo_opcode;
+reg [2:0]        req_amo_param;
+
+// Atomics are checked like writes and answered with data like reads
+wire             req_amo  = (req_amo_opcode == TL_A_ARITHMETIC_DATA_OPCODE) ||
+                            (req_amo_opcode == TL_A_LOGICAL_DATA_OPCODE);
+wire             req_data = req_read || req_amo;
 
 // Retry mechanism
 reg [$clog2(MAX_RETRIES+1)-1:0] retry_count;
@@ -163,23 +195,6 @@ reg       do_cpu_corrupt;
 // Read data hold
 reg [XLEN-1:0] read_data_hold;
 
-// Assign a new source ID for each transaction
-// this module only support a single transacetion
-// at a time. This is only for logging/debugging
-reg [SID_WIDTH-1:0] current_source_id;
-assign tl_a_source = current_source_id;
-always_ff @(posedge clk or posedge reset) begin
-    if (reset) begin
-        current_source_id <= {SID_WIDTH{1'b0}};
-    end else if (tl_a_valid && tl_a_ready) begin
-        if (current_source_id < {SID_WIDTH{1'b1}}) begin
-            current_source_id <= (current_source_id + 1) & {SID_WIDTH{1'b1}};
-        end else begin
-            current_source_id <= {SID_WIDTH{1'b0}};
-        end
-    end
-end
-
 function integer count_wstrb_bits;
     input [XLEN/8-1:0] wstrb;
     integer j;
@@ -191,293 +206,537 @@ function integer count_wstrb_bits;
     end
 endfunction
 
-always_ff @(posedge clk or posedge reset) begin
-    if (reset) begin
-        // Initialize all registers on reset
-        tl_a_valid       <= 1'b0;
-        tl_a_opcode      <= 3'b000;
-        tl_a_param       <= 3'b000;
-        tl_a_size        <= 3'b000;
-        tl_a_address     <= {XLEN{1'b0}};
-        tl_a_mask        <= {XLEN/8{1'b0}};
-        tl_a_data        <= {XLEN{1'b0}};
-        tl_d_ready       <= 1'b0;
-        cpu_valid        <= 1'b0;
-        retry_count      <= 2'd0;
-        do_retry_max     <= 1'b0;
-        do_cpu_denied    <= 1'b0;
-        do_cpu_corrupt   <= 1'b0;
-        cpu_ack          <= 1'b0;
-        cpu_denied       <= 1'b0;
-        cpu_corrupt      <= 1'b0;
-        test_reg         <= 6'b100000;
-        read_data_hold   <= {XLEN{1'b0}};
-    end else begin
-        // `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("ack=%0b cpu_valid=%0b cpu_rdata=%0h cpu_denied=%0b cpu_corrupt=%0b", cpu_ack, cpu_valid, cpu_rdata, cpu_denied, cpu_corrupt)); `endif
-        // Default assignments
-        tl_a_valid       <= 1'b0;
-        tl_d_ready       <= 1'b0;
-        do_retry_max     <= 1'b0;
-
-        case (current_state)
-            IDLE: begin
-                // Reset outputs
-                cpu_ack       <= 1'b0;
-                cpu_rdata     <= 1'b0;
-                cpu_denied    <= 1'b0;
-                cpu_corrupt   <= 1'b0;
-                cpu_valid     <= 1'b0;
-
-                if (cpu_ready && ~cpu_ack) begin
-                    `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("Captured CPU request - Read: %0d, Address: 0x%h, Size: %0d", cpu_read, cpu_address, cpu_size)); `endif
-
-                    // Capture CPU request
-                    req_address <= cpu_address;
-                    req_wdata   <= cpu_wdata;
-                    req_wstrb   <= cpu_wstrb;
-                    req_size    <= cpu_size;
-                    req_read    <= cpu_read;
-                    cpu_ack     <= 1'b1;
-                    next_state  <= SEND_REQ;
-
-                    if (~cpu_read) begin
-                        test_reg <= 6'b000001;
-                        case (cpu_size)
-                            3'b000: begin // Store Byte (SB - 8bits)
-                                // Addresses from the CPU are byte aligned for byte
-                                // reads, cpu_wstrb is the byte for the word-aligned address
-                                // so it not needed to determin the cpu_wdata bytes.
-                                if (count_wstrb_bits(cpu_wstrb) == 1) begin
-                                    req_wdata <= { {(XLEN-8){1'b0}}, cpu_wdata[7:0] };
-                                end else begin
-                                    `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Captured CPU Byte request - invalid mask b%00b", cpu_wstrb)); `endif
-                                    // Invalid alignment
-                                    do_cpu_denied  <= 1'b1;
-                                    read_data_hold <= {XLEN{1'b0}};
-                                    next_state     <= WRITE_RDATA;
-                                end
-                            end
-                            3'b001: if (XLEN == 32) begin // Store Half-Word (SH - 16bits)
-                                // Addresses from the CPU are half-word aligned for half-word
-                                // reads, cpu_wstrb is the bytes for the word-aligned address
-                                // so it not needed to determin the cpu_wdata bytes.
-                                if (count_wstrb_bits(cpu_wstrb) == 2 &&
-                                    ((cpu_wstrb[0] && cpu_wstrb[1]) ||
-                                    (cpu_wstrb[2] && cpu_wstrb[3])))
-                                begin
-                                    req_wdata <= { {(XLEN-16){1'b0}}, cpu_wdata[15:0] };
-                                end else begin
-                                    `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Captured CPU Half-Word request - invalid mask b%0b", cpu_wstrb)); `endif
-                                    // Invalid alignment
-                                    do_cpu_denied  <= 1'b1;
-                                    read_data_hold <= {XLEN{1'b0}};
-                                    next_state     <= WRITE_RDATA;
+// Right-justify a value of the given size
+function automatic [XLEN-1:0] size_data;
+    input [2:0]      size;
+    input [XLEN-1:0] data;
+    begin
+        case (size)
+            3'b000:  size_data = data & ~({XLEN{1'b1}} << 8);
+            3'b001:  size_data = data & ~({XLEN{1'b1}} << 16);
+            3'b010:  size_data = data & ~({XLEN{1'b1}} << 32);
+            3'b011:  size_data = data;
+            default: size_data = {XLEN{1'b0}};
+        endcase
+    end
+endfunction
+
+// Write masks must select exactly the naturally aligned lanes of the access size
+function automatic valid_wstrb;
+    input [2:0]        size;
+    input [XLEN/8-1:0] wstrb;
+    integer j;
+    begin
+        valid_wstrb = 1'b0;
+        case (size)
+            3'b000: valid_wstrb = (count_wstrb_bits(wstrb) == 1);
+            3'b001: for (j = 0; j < XLEN/8; j = j + 2) begin
+                if (wstrb == (3 << j)) valid_wstrb = 1'b1;
+            end
+            3'b010: for (j = 0; j < XLEN/8; j = j + 4) begin
+                if (wstrb == (15 << j)) valid_wstrb = 1'b1;
+            end
+            3'b011: valid_wstrb = (XLEN >= 64) && (&wstrb);
+            default: valid_wstrb = 1'b0;
+        endcase
+    end
+endfunction
+
+generate
+if (MAX_OUTSTANDING <= 1) begin : g_single
+    // Assign a new source ID for each transaction
+    // this module only support a single transacetion
+    // at a time. This is only for logging/debugging
+    reg [SID_WIDTH-1:0] current_source_id;
+    assign tl_a_source = current_source_id;
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            current_source_id <= {SID_WIDTH{1'b0}};
+        end else if (tl_a_valid && tl_a_ready) begin
+            if (current_source_id < {SID_WIDTH{1'b1}}) begin
+                current_source_id <= (current_source_id + 1) & {SID_WIDTH{1'b1}};
+            end else begin
+                current_source_id <= {SID_WIDTH{1'b0}};
+            end
+        end
+    end
+
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            // Initialize all registers on reset
+            tl_a_valid       <= 1'b0;
+            tl_a_opcode      <= 3'b000;
+            tl_a_param       <= 3'b000;
+            tl_a_size        <= 3'b000;
+            tl_a_address     <= {XLEN{1'b0}};
+            tl_a_mask        <= {XLEN/8{1'b0}};
+            tl_a_data        <= {XLEN{1'b0}};
+            tl_d_ready       <= 1'b0;
+            cpu_valid        <= 1'b0;
+            retry_count      <= 2'd0;
+            do_retry_max     <= 1'b0;
+            do_cpu_denied    <= 1'b0;
+            do_cpu_corrupt   <= 1'b0;
+            cpu_ack          <= 1'b0;
+            cpu_denied       <= 1'b0;
+            cpu_corrupt      <= 1'b0;
+            test_reg         <= 6'b100000;
+            read_data_hold   <= {XLEN{1'b0}};
+        end else begin
+            // `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("ack=%0b cpu_valid=%0b cpu_rdata=%0h cpu_denied=%0b cpu_corrupt=%0b", cpu_ack, cpu_valid, cpu_rdata, cpu_denied, cpu_corrupt)); `endif
+            // Default assignments
+            tl_a_valid       <= 1'b0;
+            tl_d_ready       <= 1'b0;
+            do_retry_max     <= 1'b0;
+
+            case (current_state)
+                IDLE: begin
+                    // Reset outputs
+                    cpu_ack       <= 1'b0;
+                    cpu_rdata     <= 1'b0;
+                    cpu_denied    <= 1'b0;
+                    cpu_corrupt   <= 1'b0;
+                    cpu_valid     <= 1'b0;
+
+                    if (cpu_ready && ~cpu_ack) begin
+                        `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("Captured CPU request - Read: %0d, Address: 0x%h, Size: %0d", cpu_read, cpu_address, cpu_size)); `endif
+
+                        // Capture CPU request
+                        req_address <= cpu_address;
+                        req_wdata   <= cpu_wdata;
+                        req_wstrb   <= cpu_wstrb;
+                        req_size    <= cpu_size;
+                        req_read    <= cpu_read;
+                        req_amo_opcode <= cpu_read ? TL_A_PUT_FULL_DATA_OPCODE : cpu_amo_opcode;
+                        req_amo_param  <= cpu_amo_param;
+                        cpu_ack     <= 1'b1;
+                        next_state  <= SEND_REQ;
+
+                        if (~cpu_read) begin
+                            test_reg <= 6'b000001;
+                            case (cpu_size)
+                                3'b000: begin // Store Byte (SB - 8bits)
+                                    // Addresses from the CPU are byte aligned for byte
+                                    // reads, cpu_wstrb is the byte for the word-aligned address
+                                    // so it not needed to determin the cpu_wdata bytes.
+                                    if (count_wstrb_bits(cpu_wstrb) == 1) begin
+                                        req_wdata <= { {(XLEN-8){1'b0}}, cpu_wdata[7:0] };
+                                    end else begin
+                                        `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Captured CPU Byte request - invalid mask b%00b", cpu_wstrb)); `endif
+                                        // Invalid alignment
+                                        do_cpu_denied  <= 1'b1;
+                                        read_data_hold <= {XLEN{1'b0}};
+                                        next_state     <= WRITE_RDATA;
+                                    end
                                 end
-                            end else if (XLEN == 64) begin
-                                if (count_wstrb_bits(cpu_wstrb) == 2 &&
-                                    ((cpu_wstrb[0] && cpu_wstrb[1]) ||
-                                    (cpu_wstrb[2] && cpu_wstrb[3]) ||
-                                    (cpu_wstrb[4] && cpu_wstrb[5]) ||
-                                    (cpu_wstrb[6] && cpu_wstrb[7])))
-                                begin
-                                    req_wdata <= { {(XLEN-16){1'b0}}, cpu_wdata[15:0] };
-                                end else begin
-                                    `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Captured CPU Half-Word request - invalid mask b%0b", cpu_wstrb)); `endif
-                                    // Invalid alignment
-                                    do_cpu_denied  <= 1'b1;
-                                    read_data_hold <= {XLEN{1'b0}};
-                                    next_state     <= WRITE_RDATA;
+                                3'b001: if (XLEN == 32) begin // Store Half-Word (SH - 16bits)
+                                    // Addresses from the CPU are half-word aligned for half-word
+                                    // reads, cpu_wstrb is the bytes for the word-aligned address
+                                    // so it not needed to determin the cpu_wdata bytes.
+                                    if (count_wstrb_bits(cpu_wstrb) == 2 &&
+                                        ((cpu_wstrb[0] && cpu_wstrb[1]) ||
+                                        (cpu_wstrb[2] && cpu_wstrb[3])))
+                                    begin
+                                        req_wdata <= { {(XLEN-16){1'b0}}, cpu_wdata[15:0] };
+                                    end else begin
+                                        `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Captured CPU Half-Word request - invalid mask b%0b", cpu_wstrb)); `endif
+                                        // Invalid alignment
+                                        do_cpu_denied  <= 1'b1;
+                                        read_data_hold <= {XLEN{1'b0}};
+                                        next_state     <= WRITE_RDATA;
+                                    end
+                                end else if (XLEN == 64) begin
+                                    if (count_wstrb_bits(cpu_wstrb) == 2 &&
+                                        ((cpu_wstrb[0] && cpu_wstrb[1]) ||
+                                        (cpu_wstrb[2] && cpu_wstrb[3]) ||
+                                        (cpu_wstrb[4] && cpu_wstrb[5]) ||
+                                        (cpu_wstrb[6] && cpu_wstrb[7])))
+                                    begin
+                                        req_wdata <= { {(XLEN-16){1'b0}}, cpu_wdata[15:0] };
+                                    end else begin
+                                        `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Captured CPU Half-Word request - invalid mask b%0b", cpu_wstrb)); `endif
+                                        // Invalid alignment
+                                        do_cpu_denied  <= 1'b1;
+                                        read_data_hold <= {XLEN{1'b0}};
+                                        next_state     <= WRITE_RDATA;
+                                    end
                                 end
-                            end
-                            3'b010: if (XLEN == 32) begin // Store Word (SW 32-bits)
-                                // Addresses from the CPU are word aligned for word
-                                // reads, cpu_wstrb is the bytes for the word-aligned address
-                                // so it not needed to determin the cpu_wdata bytes.
-                                if (count_wstrb_bits(cpu_wstrb) == 4 &&
-                                    ((cpu_wstrb[0] && cpu_wstrb[1] && cpu_wstrb[2] && cpu_wstrb[3])))
-                                begin
-                                    req_wdata <= { {(XLEN-32){1'b0}}, cpu_wdata[31:0] };
-                                end else begin
-                                    `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Captured CPU Word request - invalid mask b%0b", cpu_wstrb)); `endif
-                                    // Invalid alignment
-                                    do_cpu_denied  <= 1'b1;
-                                    read_data_hold <= {XLEN{1'b0}};
-                                    next_state     <= WRITE_RDATA;
+                                3'b010: if (XLEN == 32) begin // Store Word (SW 32-bits)
+                                    // Addresses from the CPU are word aligned for word
+                                    // reads, cpu_wstrb is the bytes for the word-aligned address
+                                    // so it not needed to determin the cpu_wdata bytes.
+                                    if (count_wstrb_bits(cpu_wstrb) == 4 &&
+                                        ((cpu_wstrb[0] && cpu_wstrb[1] && cpu_wstrb[2] && cpu_wstrb[3])))
+                                    begin
+                                        req_wdata <= { {(XLEN-32){1'b0}}, cpu_wdata[31:0] };
+                                    end else begin
+                                        `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Captured CPU Word request - invalid mask b%0b", cpu_wstrb)); `endif
+                                        // Invalid alignment
+                                        do_cpu_denied  <= 1'b1;
+                                        read_data_hold <= {XLEN{1'b0}};
+                                        next_state     <= WRITE_RDATA;
+                                    end
+                                end else if (XLEN == 64) begin
+                                    if (count_wstrb_bits(cpu_wstrb) == 4 &&
+                                        ((cpu_wstrb[0] && cpu_wstrb[1] && cpu_wstrb[2] && cpu_wstrb[3]) ||
+                                        (cpu_wstrb[4] && cpu_wstrb[5] && cpu_wstrb[6] && cpu_wstrb[7])))
+                                    begin
+                                        req_wdata <= { {(XLEN-32){1'b0}}, cpu_wdata[31:0] };
+                                    end else begin
+                                        `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Captured CPU Word request - invalid mask b%0b", cpu_wstrb)); `endif
+                                        // Invalid alignment
+                                        do_cpu_denied  <= 1'b1;
+                                        read_data_hold <= {XLEN{1'b0}};
+                                        next_state     <= WRITE_RDATA;
+                                    end
                                 end
-                            end else if (XLEN == 64) begin
-                                if (count_wstrb_bits(cpu_wstrb) == 4 &&
-                                    ((cpu_wstrb[0] && cpu_wstrb[1] && cpu_wstrb[2] && cpu_wstrb[3]) ||
-                                    (cpu_wstrb[4] && cpu_wstrb[5] && cpu_wstrb[6] && cpu_wstrb[7])))
-                                begin
-                                    req_wdata <= { {(XLEN-32){1'b0}}, cpu_wdata[31:0] };
-                                end else begin
-                                    `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Captured CPU Word request - invalid mask b%0b", cpu_wstrb)); `endif
-                                    // Invalid alignment
-                                    do_cpu_denied  <= 1'b1;
-                                    read_data_hold <= {XLEN{1'b0}};
-                                    next_state     <= WRITE_RDATA;
+                                3'b011: if (XLEN >= 64) begin // Store Double-Word (SD 64-bits)
+                                    // Addresses from the CPU are double-word aligned for double-word
+                                    // reads, cpu_wstrb is the bytes for the word-aligned address
+                                    // so it not needed to determin the cpu_wdata bytes.
+                                    if (count_wstrb_bits(cpu_wstrb) == 8 &&
+                                        (cpu_wstrb[0] && cpu_wstrb[1] && cpu_wstrb[2] && cpu_wstrb[3] && cpu_wstrb[4] && cpu_wstrb[5] && cpu_wstrb[6] && cpu_wstrb[7]))
+                                    begin
+                                        req_wdata <= { {(XLEN-64){1'b0}}, cpu_wdata[63:0] };
+                                    end else begin
+                                        `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Captured CPU Double-Word request - invalid mask b%0b", cpu_wstrb)); `endif
+                                        // Invalid alignment
+                                        do_cpu_denied  <= 1'b1;
+                                        read_data_hold <= {XLEN{1'b0}};
+                                        next_state     <= WRITE_RDATA;
+                                    end
                                 end
-                            end
-                            3'b011: if (XLEN >= 64) begin // Store Double-Word (SD 64-bits)
-                                // Addresses from the CPU are double-word aligned for double-word
-                                // reads, cpu_wstrb is the bytes for the word-aligned address
-                                // so it not needed to determin the cpu_wdata bytes.
-                                if (count_wstrb_bits(cpu_wstrb) == 8 &&
-                                    (cpu_wstrb[0] && cpu_wstrb[1] && cpu_wstrb[2] && cpu_wstrb[3] && cpu_wstrb[4] && cpu_wstrb[5] && cpu_wstrb[6] && cpu_wstrb[7]))
-                                begin
-                                    req_wdata <= { {(XLEN-64){1'b0}}, cpu_wdata[63:0] };
-                                end else begin
-                                    `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Captured CPU Double-Word request - invalid mask b%0b", cpu_wstrb)); `endif
-                                    // Invalid alignment
+                                default: begin
+                                    `ifdef LOG_MEM_INTERFACE `ERROR("tl_interface", ("Captured CPU Double-Word request - invalid size b%0b", cpu_size)); `endif
+                                    // Invalid request size
                                     do_cpu_denied  <= 1'b1;
                                     read_data_hold <= {XLEN{1'b0}};
                                     next_state     <= WRITE_RDATA;
                                 end
+                            endcase
+                        end
+                    end else begin
+                        test_reg <= 6'b000010;
+                        next_state <= IDLE;
+                    end
+                end
+
+                SEND_REQ: begin
+                    test_reg <= 6'b000100;
+
+                    // Resend TileLink A Channel request until tl_a_ready is asserted
+                    tl_a_opcode  <= req_amo ? req_amo_opcode :
+                                    req_read ? TL_A_GET_OPCODE : TL_A_PUT_FULL_DATA_OPCODE;
+                    tl_a_param   <= req_amo ? req_amo_param : DEFAULT_PARAM;
+                    tl_a_size    <= req_size;
+                    tl_a_address <= req_address;
+                    tl_a_mask    <= req_wstrb;
+                    tl_a_data    <= req_wdata;
+                    tl_a_valid   <= 1'b1;
+                    cpu_ack      <= 1'b0;
+                    next_state   <= REQ_ACK;
+                end
+
+                REQ_ACK: begin
+                    if (tl_a_ready) begin
+                        test_reg <= 6'b001000;
+                        `ifdef LOG_MEM_INTERFACE
+                            if (req_read) begin
+                                `LOG("tl_interface", ("Sending TileLink A Channel GET request accepted - Address: 0x%h", req_address));
+                            end else begin
+                                `LOG("tl_interface", ("Sending TileLink A Channel PUT_FULL_DATA request accepted - Address: 0x%h, Mask: 0x%h, Data: 0x%h", req_address, req_wstrb, req_wdata));
                             end
-                            default: begin
-                                `ifdef LOG_MEM_INTERFACE `ERROR("tl_interface", ("Captured CPU Double-Word request - invalid size b%0b", cpu_size)); `endif
-                                // Invalid request size
-                                do_cpu_denied  <= 1'b1;
+                        `endif
+                        tl_a_valid <= 1'b0;
+                        next_state <= WAIT_RESP;
+                    end else begin
+                        `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("SEND_REQ waiting for tl_a_ready")); `endif
+                        next_state  <= SEND_REQ;
+                    end
+                end
+
+                WAIT_RESP: begin
+                    cpu_ack    <= 1'b0;
+                    if (tl_d_valid) begin
+                        test_reg <= 6'b010000;
+                        tl_d_ready <= 1'b1; // Acknowledge the response
+                        `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("Received TileLink D Channel response - Opcode: %0b, Data: 0x%h, tl_d_denied=%0b, tl_d_corrupt=%0b", tl_d_opcode, tl_d_data, tl_d_denied, tl_d_corrupt)); `endif
+
+                        if (tl_d_denied || tl_d_corrupt) begin
+                            if (retry_count < MAX_RETRIES) begin
+                                retry_count <= (retry_count + 1) & {2'b11};
+                                `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Response denied/corrupt, retrying (%0d/%0d)", retry_count, MAX_RETRIES)); `endif
+                                next_state <= SEND_REQ;
+                            end else begin
+                                `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Response denied/corrupt after max retries, transitioning to WRITE_RDATA tl_d_denied=%0b tl_d_corrupt=%0b", tl_d_denied, tl_d_corrupt)); `endif
+                                if (tl_d_denied) do_cpu_denied <= 1'b1;
+                                if (tl_d_corrupt) do_cpu_corrupt <= 1'b1;
                                 read_data_hold <= {XLEN{1'b0}};
                                 next_state     <= WRITE_RDATA;
                             end
-                        endcase
+                        end else begin
+                            // Successful response
+                            if (req_data && tl_d_opcode == TL_D_ACCESS_ACK_DATA) begin
+                                case (req_size)
+                                    3'b000: read_data_hold <= { {(XLEN-8){1'b0}}, tl_d_data[7:0] };
+                                    3'b001: read_data_hold <= { {(XLEN-16){1'b0}}, tl_d_data[15:0] };
+                                    3'b010: read_data_hold <= { {(XLEN-32){1'b0}}, tl_d_data[31:0] };
+                                    3'b011: if (XLEN >= 64) begin
+                                        read_data_hold <= { {(XLEN-64){1'b0}}, tl_d_data[63:0] };
+                                    end
+                                    default: read_data_hold <= {XLEN{1'b0}};
+                                endcase
+                                `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("Read data received - 0x%h", tl_d_data)); `endif
+                            end else if (req_data && tl_d_opcode == TL_D_ACCESS_ACK_DATA_CORRUPT) begin
+                                `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Read corrupt data received - 0x%h", tl_d_data)); `endif
+                                do_cpu_corrupt <= 1'b1;
+                            end else if (req_data && tl_d_opcode == TL_D_ACCESS_ACK_ERROR) begin
+                                `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Read error data received - 0x%h", tl_d_data)); `endif
+                                do_cpu_denied <= 1'b1;
+                            end else if (req_data) begin
+                                `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Unexpected Read response on D channel: 0x%0h", tl_d_opcode)); `endif
+                                do_cpu_corrupt <= 1'b1;
+                            end else if (!req_data) begin
+                                `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("Write operation acknowledged")); `endif
+                            end
+
+                            retry_count <= 2'd0;
+                            next_state  <= WRITE_RDATA;
+                        end
+                    end else begin
+                        // Waiting for D Channel response
+                        next_state <= WAIT_RESP;
                     end
-                end else begin
-                    test_reg <= 6'b000010;
-                    next_state <= IDLE;
                 end
-            end
 
-            SEND_REQ: begin
-                test_reg <= 6'b000100;
+                WRITE_RDATA: begin
+                    test_reg <= 6'b100000;
+                    `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("Assigning read data to CPU - 0x%h denied=%0d corrupt=%0d", read_data_hold, do_cpu_denied || do_retry_max, do_cpu_corrupt)); `endif
+                    cpu_ack      <= 1'b0;
+                    if (req_data) begin
+                        cpu_rdata <= read_data_hold;
+                    end else begin
+                        cpu_rdata <= {XLEN{1'b0}};
+                    end
+                    if (do_cpu_denied || do_retry_max) cpu_denied <= 1'b1;
+                    if (do_cpu_corrupt) cpu_corrupt <= 1'b1;
+                    cpu_valid  <= 1'b1;
+                    next_state <= COMPLETE;
+                end
 
-                // Resend TileLink A Channel request until tl_a_ready is asserted
-                tl_a_opcode  <= req_read ? TL_A_GET_OPCODE : TL_A_PUT_FULL_DATA_OPCODE;
-                tl_a_param   <= DEFAULT_PARAM;
-                tl_a_size    <= req_size;
-                tl_a_address <= req_address;
-                tl_a_mask    <= req_wstrb;
-                tl_a_data    <= req_wdata;
-                tl_a_valid   <= 1'b1;
-                cpu_ack      <= 1'b0;
-                next_state   <= REQ_ACK;
-            end
+                COMPLETE: begin
+                 // test_reg <= 6'b000110;
+                    `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("Memory operation complete, valid signals asserted")); `endif
+                    do_retry_max   <= 1'b0;
+                    do_cpu_denied  <= 1'b0;
+                    do_cpu_corrupt <= 1'b0;
+                    read_data_hold <= {XLEN{1'b0}};
+                    retry_count    <= 2'd0;
+                    cpu_valid      <= 1'b0;
+                    next_state     <= IDLE;
+                end
 
-            REQ_ACK: begin
-                if (tl_a_ready) begin
-                    test_reg <= 6'b001000;
-                    `ifdef LOG_MEM_INTERFACE
-                        if (req_read) begin
-                            `LOG("tl_interface", ("Sending TileLink A Channel GET request accepted - Address: 0x%h", req_address));
-                        end else begin
-                            `LOG("tl_interface", ("Sending TileLink A Channel PUT_FULL_DATA request accepted - Address: 0x%h, Mask: 0x%h, Data: 0x%h", req_address, req_wstrb, req_wdata));
-                        end
-                    `endif
-                    tl_a_valid <= 1'b0;
-                    next_state <= WAIT_RESP;
-                end else begin
-                    `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("SEND_REQ waiting for tl_a_ready")); `endif
-                    next_state  <= SEND_REQ;
+                default: begin
+                    next_state <= IDLE;
                 end
+            endcase
+        end
+    end
+
+    // FSM State Transition
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            current_state <= IDLE;
+        end else begin
+            current_state <= next_state;
+        end
+    end
+end else begin : g_multi
+    // ──────────────────────────
+    // Outstanding request slots
+    // ──────────────────────────
+    // Slots are allocated in CPU request order from a ring, and the slot index is the TileLink
+    // source ID of the request. Responses may return in any order; they are matched by
+    // tl_d_source and handed back to the CPU from the head of the ring, so the CPU still sees one
+    // cpu_valid per request in the order it issued them.
+    reg [XLEN-1:0]                  slot_address [0:MAX_OUTSTANDING-1];
+    reg [XLEN-1:0]                  slot_wdata   [0:MAX_OUTSTANDING-1];
+    reg [XLEN/8-1:0]                slot_wstrb   [0:MAX_OUTSTANDING-1];
+    reg [2:0]                       slot_size    [0:MAX_OUTSTANDING-1];
+    reg [2:0]                       slot_opcode  [0:MAX_OUTSTANDING-1];
+    reg [2:0]                       slot_param   [0:MAX_OUTSTANDING-1];
+    reg                             slot_data    [0:MAX_OUTSTANDING-1]; // Response carries data
+    reg [XLEN-1:0]                  slot_rdata   [0:MAX_OUTSTANDING-1];
+    reg [$clog2(MAX_RETRIES+1)-1:0] slot_retries [0:MAX_OUTSTANDING-1];
+    reg [MAX_OUTSTANDING-1:0]       slot_send;      // Waiting to go out on the A channel
+    reg [MAX_OUTSTANDING-1:0]       slot_done;      // Response received, waiting for the CPU
+    reg [MAX_OUTSTANDING-1:0]       slot_denied;
+    reg [MAX_OUTSTANDING-1:0]       slot_corrupt;
+
+    reg [SLOT_BITS-1:0]             slot_head;      // Oldest request, next to return to the CPU
+    reg [SLOT_BITS-1:0]             slot_tail;      // Next slot to allocate
+    reg [SLOT_BITS:0]               slot_count;     // Allocated slots
+    reg [SLOT_BITS-1:0]             a_slot;         // Slot currently on the A channel
+
+    wire [SLOT_BITS-1:0] d_slot = tl_d_source[SLOT_BITS-1:0];
+    wire                 alloc  = cpu_ready && ~cpu_ack && (slot_count < MAX_OUTSTANDING);
+    wire                 retire = slot_count != 0 && slot_done[slot_head];
+    wire                 cpu_is_amo = ~cpu_read && ((cpu_amo_opcode == TL_A_ARITHMETIC_DATA_OPCODE) ||
+                                                    (cpu_amo_opcode == TL_A_LOGICAL_DATA_OPCODE));
+
+    assign tl_a_source = a_slot;
+
+    // Oldest slot waiting to be sent, so requests (and retries) go out in CPU order
+    reg                  send_found;
+    reg [SLOT_BITS-1:0]  send_slot;
+    always_comb begin
+        send_found = 1'b0;
+        send_slot  = {SLOT_BITS{1'b0}};
+        for (int i = 0; i < MAX_OUTSTANDING; i = i + 1) begin
+            if (~send_found && slot_send[(slot_head + i) % MAX_OUTSTANDING]) begin
+                send_found = 1'b1;
+                send_slot  = (slot_head + i) % MAX_OUTSTANDING;
             end
+        end
+    end
 
-            WAIT_RESP: begin
-                cpu_ack    <= 1'b0;
-                if (tl_d_valid) begin
-                    test_reg <= 6'b010000;
-                    tl_d_ready <= 1'b1; // Acknowledge the response
-                    `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("Received TileLink D Channel response - Opcode: %0b, Data: 0x%h, tl_d_denied=%0b, tl_d_corrupt=%0b", tl_d_opcode, tl_d_data, tl_d_denied, tl_d_corrupt)); `endif
-
-                    if (tl_d_denied || tl_d_corrupt) begin
-                        if (retry_count < MAX_RETRIES) begin
-                            retry_count <= (retry_count + 1) & {2'b11};
-                            `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Response denied/corrupt, retrying (%0d/%0d)", retry_count, MAX_RETRIES)); `endif
-                            next_state <= SEND_REQ;
-                        end else begin
-                            `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Response denied/corrupt after max retries, transitioning to WRITE_RDATA tl_d_denied=%0b tl_d_corrupt=%0b", tl_d_denied, tl_d_corrupt)); `endif
-                            if (tl_d_denied) do_cpu_denied <= 1'b1;
-                            if (tl_d_corrupt) do_cpu_corrupt <= 1'b1;
-                            read_data_hold <= {XLEN{1'b0}};
-                            next_state     <= WRITE_RDATA;
-                        end
-                    end else begin
-                        // Successful response
-                        if (req_read && tl_d_opcode == TL_D_ACCESS_ACK_DATA) begin
-                            case (req_size)
-                                3'b000: read_data_hold <= { {(XLEN-8){1'b0}}, tl_d_data[7:0] };
-                                3'b001: read_data_hold <= { {(XLEN-16){1'b0}}, tl_d_data[15:0] };
-                                3'b010: read_data_hold <= { {(XLEN-32){1'b0}}, tl_d_data[31:0] };
-                                3'b011: if (XLEN >= 64) begin
-                                    read_data_hold <= { {(XLEN-64){1'b0}}, tl_d_data[63:0] };
-                                end
-                                default: read_data_hold <= {XLEN{1'b0}};
-                            endcase
-                            `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("Read data received - 0x%h", tl_d_data)); `endif
-                        end else if (req_read && tl_d_opcode == TL_D_ACCESS_ACK_DATA_CORRUPT) begin
-                            `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Read corrupt data received - 0x%h", tl_d_data)); `endif
-                            do_cpu_corrupt <= 1'b1;
-                        end else if (req_read && tl_d_opcode == TL_D_ACCESS_ACK_ERROR) begin
-                            `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Read error data received - 0x%h", tl_d_data)); `endif
-                            do_cpu_denied <= 1'b1;
-                        end else if (req_read) begin
-                            `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Unexpected Read response on D channel: 0x%0h", tl_d_opcode)); `endif
-                            do_cpu_corrupt <= 1'b1;
-                        end else if (!req_read) begin
-                            `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("Write operation acknowledged")); `endif
-                        end
+    initial begin
+        if (SID_WIDTH < SLOT_BITS || (MAX_OUTSTANDING & (MAX_OUTSTANDING - 1)) != 0) begin
+            $display("tl_interface: MAX_OUTSTANDING must be a power of two no larger than 2^SID_WIDTH");
+            $finish;
+        end
+    end
 
-                        retry_count <= 2'd0;
-                        next_state  <= WRITE_RDATA;
-                    end
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            tl_a_valid   <= 1'b0;
+            tl_a_opcode  <= 3'b000;
+            tl_a_param   <= 3'b000;
+            tl_a_size    <= 3'b000;
+            tl_a_address <= {XLEN{1'b0}};
+            tl_a_mask    <= {XLEN/8{1'b0}};
+            tl_a_data    <= {XLEN{1'b0}};
+            tl_d_ready   <= 1'b0;
+            cpu_ack      <= 1'b0;
+            cpu_rdata    <= {XLEN{1'b0}};
+            cpu_denied   <= 1'b0;
+            cpu_corrupt  <= 1'b0;
+            cpu_valid    <= 1'b0;
+            test_reg     <= 6'b000000;
+            slot_send    <= {MAX_OUTSTANDING{1'b0}};
+            slot_done    <= {MAX_OUTSTANDING{1'b0}};
+            slot_denied  <= {MAX_OUTSTANDING{1'b0}};
+            slot_corrupt <= {MAX_OUTSTANDING{1'b0}};
+            slot_head    <= {SLOT_BITS{1'b0}};
+            slot_tail    <= {SLOT_BITS{1'b0}};
+            slot_count   <= {(SLOT_BITS+1){1'b0}};
+            a_slot       <= {SLOT_BITS{1'b0}};
+        end else begin
+            tl_d_ready <= 1'b0;
+            cpu_ack    <= 1'b0;
+            cpu_valid  <= 1'b0;
+            test_reg   <= slot_count;
+
+            // ──────────────────────────
+            // Capture CPU requests
+            // ──────────────────────────
+            if (alloc) begin
+                `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("Captured CPU request %0d - Read: %0d, Address: 0x%h, Size: %0d", slot_tail, cpu_read, cpu_address, cpu_size)); `endif
+                slot_address[slot_tail] <= cpu_address;
+                slot_wdata[slot_tail]   <= cpu_read ? cpu_wdata : size_data(cpu_size, cpu_wdata);
+                slot_wstrb[slot_tail]   <= cpu_wstrb;
+                slot_size[slot_tail]    <= cpu_size;
+                slot_data[slot_tail]    <= cpu_read || cpu_is_amo;
+                slot_opcode[slot_tail]  <= cpu_read   ? TL_A_GET_OPCODE :
+                                           cpu_is_amo ? cpu_amo_opcode : TL_A_PUT_FULL_DATA_OPCODE;
+                slot_param[slot_tail]   <= cpu_is_amo ? cpu_amo_param : DEFAULT_PARAM;
+                slot_rdata[slot_tail]   <= {XLEN{1'b0}};
+                slot_retries[slot_tail] <= 0;
+                slot_corrupt[slot_tail] <= 1'b0;
+                if (~cpu_read && ~valid_wstrb(cpu_size, cpu_wstrb)) begin
+                    `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Captured CPU request - invalid size %0d or mask b%0b", cpu_size, cpu_wstrb)); `endif
+                    // Invalid alignment, answer without going to the bus
+                    slot_denied[slot_tail] <= 1'b1;
+                    slot_done[slot_tail]   <= 1'b1;
                 end else begin
-                    // Waiting for D Channel response
-                    next_state <= WAIT_RESP;
+                    slot_denied[slot_tail] <= 1'b0;
+                    slot_send[slot_tail]   <= 1'b1;
                 end
+                slot_tail <= slot_tail + 1'b1;
+                cpu_ack   <= 1'b1;
             end
 
-            WRITE_RDATA: begin
-                test_reg <= 6'b100000;
-                `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("Assigning read data to CPU - 0x%h denied=%0d corrupt=%0d", read_data_hold, do_cpu_denied || do_retry_max, do_cpu_corrupt)); `endif
-                cpu_ack      <= 1'b0;
-                if (req_read) begin
-                    cpu_rdata <= read_data_hold;
-                end else begin
-                    cpu_rdata <= {XLEN{1'b0}};
+            // ──────────────────────────
+            // A channel
+            // ──────────────────────────
+            // tl_a_valid is held until accepted, then dropped for a cycle so a slave with a
+            // registered tl_a_ready does not see the next request as already accepted.
+            if (tl_a_valid) begin
+                if (tl_a_ready) begin
+                    `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("TileLink A Channel request %0d accepted - Address: 0x%h", a_slot, tl_a_address)); `endif
+                    tl_a_valid        <= 1'b0;
+                    slot_send[a_slot] <= 1'b0;
                 end
-                if (do_cpu_denied || do_retry_max) cpu_denied <= 1'b1;
-                if (do_cpu_corrupt) cpu_corrupt <= 1'b1;
-                cpu_valid  <= 1'b1;
-                next_state <= COMPLETE;
+            end else if (send_found) begin
+                tl_a_opcode  <= slot_opcode[send_slot];
+                tl_a_param   <= slot_param[send_slot];
+                tl_a_size    <= slot_size[send_slot];
+                tl_a_address <= slot_address[send_slot];
+                tl_a_mask    <= slot_wstrb[send_slot];
+                tl_a_data    <= slot_wdata[send_slot];
+                tl_a_valid   <= 1'b1;
+                a_slot       <= send_slot;
             end
 
-            COMPLETE: begin
-             // test_reg <= 6'b000110;
-                `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("Memory operation complete, valid signals asserted")); `endif
-                do_retry_max   <= 1'b0;
-                do_cpu_denied  <= 1'b0;
-                do_cpu_corrupt <= 1'b0;
-                read_data_hold <= {XLEN{1'b0}};
-                retry_count    <= 2'd0;
-                cpu_valid      <= 1'b0;
-                next_state     <= IDLE;
+            // ──────────────────────────
+            // D channel
+            // ──────────────────────────
+            if (tl_d_valid && ~tl_d_ready) begin
+                tl_d_ready <= 1'b1; // Acknowledge the response
+                `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("Received TileLink D Channel response %0d - Opcode: %0b, Data: 0x%h, tl_d_denied=%0b, tl_d_corrupt=%0b", d_slot, tl_d_opcode, tl_d_data, tl_d_denied, tl_d_corrupt)); `endif
+
+                if (tl_d_denied || tl_d_corrupt) begin
+                    if (slot_retries[d_slot] < MAX_RETRIES) begin
+                        `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Response %0d denied/corrupt, retrying (%0d/%0d)", d_slot, slot_retries[d_slot], MAX_RETRIES)); `endif
+                        slot_retries[d_slot] <= slot_retries[d_slot] + 1'b1;
+                        slot_send[d_slot]    <= 1'b1;
+                    end else begin
+                        `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Response %0d denied/corrupt after max retries", d_slot)); `endif
+                        slot_denied[d_slot]  <= tl_d_denied;
+                        slot_corrupt[d_slot] <= tl_d_corrupt;
+                        slot_done[d_slot]    <= 1'b1;
+                    end
+                end else begin
+                    if (slot_data[d_slot] && tl_d_opcode == TL_D_ACCESS_ACK_DATA) begin
+                        slot_rdata[d_slot] <= size_data(slot_size[d_slot], tl_d_data);
+                    end else if (slot_data[d_slot] && tl_d_opcode == TL_D_ACCESS_ACK_ERROR) begin
+                        slot_denied[d_slot] <= 1'b1;
+                    end else if (slot_data[d_slot]) begin
+                        `ifdef LOG_MEM_INTERFACE `WARN("tl_interface", ("Unexpected Read response on D channel: 0x%0h", tl_d_opcode)); `endif
+                        slot_corrupt[d_slot] <= 1'b1;
+                    end
+                    slot_done[d_slot] <= 1'b1;
+                end
             end
 
-            default: begin
-                next_state <= IDLE;
+            // ──────────────────────────
+            // Return responses in order
+            // ──────────────────────────
+            if (retire) begin
+                `ifdef LOG_MEM_INTERFACE `LOG("tl_interface", ("Returning request %0d to CPU - 0x%h denied=%0d corrupt=%0d", slot_head, slot_rdata[slot_head], slot_denied[slot_head], slot_corrupt[slot_head])); `endif
+                cpu_rdata            <= slot_data[slot_head] ? slot_rdata[slot_head] : {XLEN{1'b0}};
+                cpu_denied           <= slot_denied[slot_head];
+                cpu_corrupt          <= slot_corrupt[slot_head];
+                cpu_valid            <= 1'b1;
+                slot_done[slot_head] <= 1'b0;
+                slot_head            <= slot_head + 1'b1;
             end
-        endcase
-    end
-end
 
-// FSM State Transition
-always_ff @(posedge clk or posedge reset) begin
-    if (reset) begin
-        current_state <= IDLE;
-    end else begin
-        current_state <= next_state;
+            slot_count <= slot_count + alloc - retire;
+        end
     end
 end
+endgenerate
 
 endmodule
 
@@ -19,6 +19,13 @@
  * - `SIZE` (default: 1024): Defines the size of the memory array in bytes.
  * - `WIDTH` (default: 8): Defines the memory data width
  * - `SID_WIDTH` (default: 2): Specifies the width of the Source ID used for TileLink transactions.
+ * - `BURST` (default: 0): Accepts TL-UH style multi-beat transfers whose `tl_a_size` is larger
+ *                        than the bus width.
+ * - `BYTE_ENABLE` (default: 0): Requires `WIDTH` == `XLEN`. The block RAM writes single bytes
+ *                              of a word, so every access takes one memory cycle (see
+ *                              **Wide Memory** below).
+ * - `ATOMICS` (default: 0): Executes TL-UH `ArithmeticData` and `LogicalData` requests (see
+ *                          **Atomics** below). Without it they are denied.
  *
  * **Interface:**
  * 
@@ -76,6 +83,29 @@
  *   - `PROCESS`: Processing the captured request (read/write operation).
  *   - `RESPOND`: Preparing the TileLink D channel response.
  *   - `RESPOND_WAIT`: Waiting for the TileLink D channel handshake to complete.
+ *   - `BURST_DATA`: Waiting for the next A channel beat of a burst write.
+ * 
+ * - **Bursts:** With `BURST` set, a `GET` or `PUT_FULL_DATA` whose `tl_a_size` is larger than
+ *               `XLEN/8` bytes moves `2^tl_a_size / (XLEN/8)` beats. The address must be aligned
+ *               to the full transfer size and is only taken from the first beat. A read answers
+ *               with one `ACCESS_ACK_DATA` beat per bus word, a write takes one A beat per bus
+ *               word with a full mask and answers with a single `ACCESS_ACK` after the last one.
+ *               `tl_d_size` always carries the size of the whole transfer.
+ * 
+ * - **Wide Memory:** With `BYTE_ENABLE` set the block RAM is read with the A channel address in
+ *                    the cycle the request is accepted, so `FETCH` already has the whole word and
+ *                    goes straight to `RESPOND`. Writes go out in `FETCH` with byte enables for
+ *                    the `2^tl_a_size` bytes at the address; `tl_a_mask` is checked the same way
+ *                    as on the narrow path. Accesses that do not fit inside one bus word are
+ *                    denied. `PROCESS` and `WRITE_BACK` are not used.
+ * 
+ * - **Atomics:** With `ATOMICS` set, a word or double-word `ArithmeticData` (`MIN`, `MAX`,
+ *                `MINU`, `MAXU`, `ADD`) or `LogicalData` (`XOR`, `OR`, `AND`, `SWAP`) request
+ *                reads the memory value, answers it with `ACCESS_ACK_DATA` and writes back the
+ *                result of the operation with `tl_a_data`. The mask is checked like a write.
+ *                The module serves one request at a time, so the read and write back cannot be
+ *                split by another master. Word operands are sign extended for the signed
+ *                compares.
  * 
  * - **Debug Features:** When the `DEBUG` macro is defined, the module can simulate corrupt or
  *                       denied responses for specific addresses, facilitating testing and 
@@ -110,7 +140,10 @@ module tl_memory #(
     parameter int XLEN = 32,
     parameter int SIZE = 1024,
     parameter int WIDTH = 8,
-    parameter int SID_WIDTH = 2
+    parameter int SID_WIDTH = 2,
+    parameter int BURST = 0,
+    parameter int BYTE_ENABLE = 0,
+    parameter int ATOMICS = 0
 ) (
     input  wire                 clk,
     input  wire                 reset,
@@ -154,6 +187,7 @@ initial begin
     `ASSERT((XLEN % WIDTH == 0), "XLEN must be divisible by WIDTH to ensure valid memory operations.");
     `ASSERT((SID_WIDTH >= 2), "SID_WIDTH must be 2 or more.");
     `ASSERT((SIZE % (WIDTH / 8) == 0), "SIZE must be a multiple of WIDTH/8 to ensure proper byte alignment.");
+    `ASSERT((BYTE_ENABLE == 0 || WIDTH == XLEN), "BYTE_ENABLE requires WIDTH to equal XLEN.");
     `ifdef LOG_MEMORY `LOG("tl_memory", ("memory address size is %00d bits", $clog2(SIZE/(WIDTH/8)))); `endif
 end
 
@@ -164,6 +198,8 @@ localparam [2:0] TL_ACCESS_ACK_DATA_CORRUPT = 3'b101;
 localparam [2:0] TL_ACCESS_ACK_ERROR        = 3'b111;
 localparam [2:0] PUT_FULL_DATA_OPCODE       = 3'b000;
 localparam [2:0] GET_OPCODE                 = 3'b100;
+localparam [2:0] ARITHMETIC_DATA_OPCODE     = 3'b010;
+localparam [2:0] LOGICAL_DATA_OPCODE        = 3'b011;
 
 // States
 typedef enum logic [2:0] {
@@ -172,7 +208,8 @@ typedef enum logic [2:0] {
     PROCESS         = 3'b010,
     WRITE_BACK      = 3'b011,
     RESPOND         = 3'b100,
-    RESPOND_WAIT    = 3'b101 
+    RESPOND_WAIT    = 3'b101,
+    BURST_DATA      = 3'b110
 } mem_state_t;
 mem_state_t state;
 
@@ -183,6 +220,14 @@ reg                 req_read;
 reg [SID_WIDTH-1:0] req_source;
 reg [XLEN/8-1:0]    req_wstrb;
 reg [XLEN-1:0]      req_wdata;
+reg                 req_atomic;
+reg [2:0]           req_opcode;
+reg [2:0]           req_param;
+
+// Burst beats, req_size is the size of one beat and burst_size the size of the whole transfer
+localparam int BEAT_SIZE = $clog2(XLEN/8);
+reg [2:0]           burst_size;
+reg [7:0]           burst_left;     // Beats still to move after the current one
 
 // Registers to hold computed response data before asserting tl_d_valid
 reg [XLEN-1:0]      resp_data;
@@ -201,10 +246,44 @@ function int max_valid_address(input [2:0] size);
         3'b010 : max_valid_address = SIZE - 4;            // Word
         3'b011 : max_valid_address = SIZE - 8;            // Double-Word
         3'b100 : max_valid_address = SIZE - 16;           // Quad-Word (if XLEN >= 128)
+        3'b101 : max_valid_address = SIZE - 32;           // Bursts
+        3'b110 : max_valid_address = SIZE - 64;
+        3'b111 : max_valid_address = SIZE - 128;
         default: max_valid_address = SIZE - 1;
     endcase
 endfunction
 
+// Result of an atomic request on the old memory value. Word operands are sign extended so the
+// signed compares see bit 31; the unsigned order is not changed by that.
+function [XLEN-1:0] amo_result(input [2:0] opcode, input [2:0] param, input [2:0] size,
+                               input [XLEN-1:0] old_value, input [XLEN-1:0] operand);
+    reg [XLEN-1:0] a;
+    reg [XLEN-1:0] b;
+    begin
+        a = old_value;
+        b = operand;
+        if (size == 3'b010) begin
+            a = $signed(old_value[31:0]);
+            b = $signed(operand[31:0]);
+        end
+        case ({opcode, param})
+            {ARITHMETIC_DATA_OPCODE, 3'd0}: amo_result = ($signed(a) < $signed(b)) ? a : b; // MIN
+            {ARITHMETIC_DATA_OPCODE, 3'd1}: amo_result = ($signed(a) < $signed(b)) ? b : a; // MAX
+            {ARITHMETIC_DATA_OPCODE, 3'd2}: amo_result = (a < b) ? a : b;                   // MINU
+            {ARITHMETIC_DATA_OPCODE, 3'd3}: amo_result = (a < b) ? b : a;                   // MAXU
+            {ARITHMETIC_DATA_OPCODE, 3'd4}: amo_result = a + b;                             // ADD
+            {LOGICAL_DATA_OPCODE,    3'd0}: amo_result = a ^ b;                             // XOR
+            {LOGICAL_DATA_OPCODE,    3'd1}: amo_result = a | b;                             // OR
+            {LOGICAL_DATA_OPCODE,    3'd2}: amo_result = a & b;                             // AND
+            {LOGICAL_DATA_OPCODE,    3'd3}: amo_result = b;                                 // SWAP
+            default:                        amo_result = a;
+        endcase
+    end
+endfunction
+
+// Atomics are word or double-word sized with the whole mask set
+wire amo_size_ok = (req_size == 3'b010) || (XLEN >= 64 && req_size == 3'b011);
+
 // Keep a count of req_wstrb bits
 reg [$clog2(XLEN/8+1)-1:0] wstrb_count;
 integer i;
@@ -218,13 +297,15 @@ end
 // Memory array, addresses and offsets.
 block_ram #(
     .SIZE           (SIZE),
-    .WIDTH          (WIDTH)
+    .WIDTH          (WIDTH),
+    .BYTE_ENABLE    (BYTE_ENABLE)
 ) block_ram_inst (
 	.clk            (clk),
 	.reset          (reset),
 	.write_en       (block_write_en),
 	.write_address  (block_write_address),
 	.write_data     (block_write_data),
+	.write_strb     (block_write_strb),
 	.read_address   (block_read_address),
 	.read_data      (block_read_data)
 );
@@ -233,6 +314,7 @@ localparam BLOCK_ADDRESS_SIZE = $clog2(SIZE/(WIDTH/8));
 reg                             block_write_en;
 reg [BLOCK_ADDRESS_SIZE - 1:0]  block_write_address;
 reg [WIDTH-1:0]                 block_write_data;
+reg [WIDTH/8-1:0]               block_write_strb;
 reg [BLOCK_ADDRESS_SIZE - 1:0]  block_read_address;
 reg [WIDTH-1:0]                 block_read_data;
 
@@ -263,77 +345,121 @@ reg [1:0]              mem_read_state; // 00 = set addr, 01 = wait, 10 = read da
 reg [XLEN-1:0]         mem_idata_reg;  // Input memory data register
 reg [XLEN-1:0]         mem_odata_reg;  // Output memory data register
 
-always_ff @(posedge clk or posedge reset) begin
-    if (reset) begin
-        // Reset all control and data registers
-        mem_count           <= 0;
-        mem_done            <= 0;
-        mem_read_state      <= 0;
-        block_write_en      <= 0;
-        block_write_address <= 0;
-        block_write_data    <= 0;
-        block_read_address  <= 0;
-        mem_odata_reg       <= 0;
-    end else if (mem_start && ~mem_done) begin
-        if (mem_write && ~mem_read) begin
-            if (mem_count < MEM_PARTS) begin
-                `ifdef LOG_MEMORY `LOG("tl_memory", ("/MEM_WRITE/ xlen=%0d width=%0d block_write_address=0x%0h block_write_data=0x%0h", XLEN, WIDTH, mem_word_addr + mem_count, mem_idata_reg[WIDTH*(mem_count+1)-1 -: WIDTH])); `endif
-                block_write_address <= mem_word_addr[BLOCK_ADDRESS_SIZE - 1 : 0] + mem_count;
-                block_write_data    <= mem_idata_reg[WIDTH*(mem_count+1)-1 -: WIDTH];
-                block_write_en      <= 1'b1;
-
-                // Increment the counter for the next part
-                mem_count <= (mem_count + 1) & {MEM_PARTS_LOG2{1'b1}};
-                mem_done  <= 1'b0;
-
-                // Memory operation completed
-                if (mem_count == MEM_PARTS - 1) begin
-                    mem_done  <= 1'b1;
-                    mem_count <= 1'b0;
-                end
-            end
+// Single word access on a wide memory, see Wide Memory above
+reg [XLEN/8-1:0] wide_strb;      // Bytes covered by the request
+reg [XLEN-1:0]   wide_data_mask; // Bits of the response data covered by the request
+reg              wide_fits;      // Request fits inside one bus word
+reg              wide_mask_ok;   // req_wstrb is an aligned run of 2^req_size bytes
+integer j;
+always_comb begin
+    wide_fits      = ({{(32-BYTE_OFFSET_WIDTH){1'b0}}, byte_offset} + (32'd1 << req_size)) <= XLEN/8;
+    wide_data_mask = ~({XLEN{1'b1}} << (8 << req_size));
+    wide_mask_ok   = 1'b0;
+    for (j = 0; j < XLEN/8; j++) begin
+        wide_strb[j] = (j >= byte_offset) && (j < byte_offset + (1 << req_size));
+        if ((j % (1 << req_size)) == 0 &&
+            {{(32-XLEN/8){1'b0}}, req_wstrb} == (((1 << (1 << req_size)) - 1) << j)) begin
+            wide_mask_ok = 1'b1;
         end
+    end
+end
 
-        if (~mem_write && mem_read) begin
-            if (mem_count < MEM_PARTS) begin
-                if (mem_read_state == 2'b00) begin
-                    `ifdef LOG_MEMORY `LOG("tl_memory", ("/MEM_READ/ xlen=%0d width=%0d block_read_address=0x%0h mem_part=%0d", XLEN, WIDTH, mem_word_addr + mem_count, mem_count)); `endif
-                    block_read_address <= mem_word_addr[BLOCK_ADDRESS_SIZE - 1 : 0] + mem_count;
-                    mem_read_state     <= 2'b01;
-                    if (mem_count == 0) begin
-                        mem_odata_reg <= {XLEN{1'b0}};
+generate
+    if (BYTE_ENABLE) begin : gen_wide_mem
+        // The word is read while the request is captured in IDLE, and for the next beat of a
+        // burst read while RESPOND_WAIT waits on the handshake
+        always_comb begin
+            mem_count           = 0;
+            mem_done            = 1'b0;
+            mem_read_state      = 2'b00;
+            mem_odata_reg       = {XLEN{1'b0}};
+            block_read_address  = (state == IDLE)         ? tl_a_address[BLOCK_ADDRESS_SIZE + BYTE_OFFSET_WIDTH - 1 : BYTE_OFFSET_WIDTH] :
+                                  (state == RESPOND_WAIT) ? mem_word_addr[BLOCK_ADDRESS_SIZE - 1 : 0] + 1'b1 :
+                                                            mem_word_addr[BLOCK_ADDRESS_SIZE - 1 : 0];
+            block_write_address = mem_word_addr[BLOCK_ADDRESS_SIZE - 1 : 0];
+            block_write_data    = req_wdata << (8 * byte_offset);
+            block_write_strb    = wide_strb;
+            // An atomic writes its result back one cycle later, from WRITE_BACK
+            block_write_en      = (req_atomic ? (state == WRITE_BACK) : (state == FETCH)) &&
+                                  ~req_read && ~resp_denied && ~resp_corrupt &&
+                                  wide_fits && wide_mask_ok;
+        end
+    end else begin : gen_narrow_mem
+        assign block_write_strb = {(WIDTH/8){1'b1}};
+
+        always_ff @(posedge clk or posedge reset) begin
+            if (reset) begin
+                // Reset all control and data registers
+                mem_count           <= 0;
+                mem_done            <= 0;
+                mem_read_state      <= 0;
+                block_write_en      <= 0;
+                block_write_address <= 0;
+                block_write_data    <= 0;
+                block_read_address  <= 0;
+                mem_odata_reg       <= 0;
+            end else if (mem_start && ~mem_done) begin
+                if (mem_write && ~mem_read) begin
+                    if (mem_count < MEM_PARTS) begin
+                        `ifdef LOG_MEMORY `LOG("tl_memory", ("/MEM_WRITE/ xlen=%0d width=%0d block_write_address=0x%0h block_write_data=0x%0h", XLEN, WIDTH, mem_word_addr + mem_count, mem_idata_reg[WIDTH*(mem_count+1)-1 -: WIDTH])); `endif
+                        block_write_address <= mem_word_addr[BLOCK_ADDRESS_SIZE - 1 : 0] + mem_count;
+                        block_write_data    <= mem_idata_reg[WIDTH*(mem_count+1)-1 -: WIDTH];
+                        block_write_en      <= 1'b1;
+
+                        // Increment the counter for the next part
+                        mem_count <= (mem_count + 1) & {MEM_PARTS_LOG2{1'b1}};
+                        mem_done  <= 1'b0;
+
+                        // Memory operation completed
+                        if (mem_count == MEM_PARTS - 1) begin
+                            mem_done  <= 1'b1;
+                            mem_count <= 1'b0;
+                        end
                     end
-                end else if (mem_read_state == 2'b10) begin
-                    `ifdef LOG_MEMORY `LOG("tl_memory", ("/MEM_READ/ xlen=%0d width=%0d block_read_address=0x%0h mem_part=%0d block_read_data=%00h", XLEN, WIDTH, block_read_address, mem_count, block_read_data)); `endif
-                    mem_read_state <= 2'b00;
-                    mem_odata_reg <= mem_odata_reg | block_read_data << (WIDTH * mem_count);
-
-                    // Increment the counter for the next part
-                    mem_count <= (mem_count + 1) & {MEM_PARTS_LOG2{1'b1}};
-                    mem_done  <= 1'b0;
-
-                    // Memory operation completed
-                    if (mem_count == MEM_PARTS - 1) begin
-                        mem_done  <= 1'b1;
-                        mem_count <= 1'b0;
+                end
+
+                if (~mem_write && mem_read) begin
+                    if (mem_count < MEM_PARTS) begin
+                        if (mem_read_state == 2'b00) begin
+                            `ifdef LOG_MEMORY `LOG("tl_memory", ("/MEM_READ/ xlen=%0d width=%0d block_read_address=0x%0h mem_part=%0d", XLEN, WIDTH, mem_word_addr + mem_count, mem_count)); `endif
+                            block_read_address <= mem_word_addr[BLOCK_ADDRESS_SIZE - 1 : 0] + mem_count;
+                            mem_read_state     <= 2'b01;
+                            if (mem_count == 0) begin
+                                mem_odata_reg <= {XLEN{1'b0}};
+                            end
+                        end else if (mem_read_state == 2'b10) begin
+                            `ifdef LOG_MEMORY `LOG("tl_memory", ("/MEM_READ/ xlen=%0d width=%0d block_read_address=0x%0h mem_part=%0d block_read_data=%00h", XLEN, WIDTH, block_read_address, mem_count, block_read_data)); `endif
+                            mem_read_state <= 2'b00;
+                            mem_odata_reg <= mem_odata_reg | block_read_data << (WIDTH * mem_count);
+
+                            // Increment the counter for the next part
+                            mem_count <= (mem_count + 1) & {MEM_PARTS_LOG2{1'b1}};
+                            mem_done  <= 1'b0;
+
+                            // Memory operation completed
+                            if (mem_count == MEM_PARTS - 1) begin
+                                mem_done  <= 1'b1;
+                                mem_count <= 1'b0;
+                            end
+                        end else begin
+                            // Just wait for block_read_data to be valid
+                            mem_read_state <= 2'b10;
+                        end
                     end
-                end else begin
-                    // Just wait for block_read_data to be valid
-                    mem_read_state <= 2'b10;
                 end
+            end else begin
+                // When not active, ensure mem_done is deasserted and control signals are reset
+                mem_done            <= 1'b0;
+                mem_count           <= 0;
+                mem_read_state      <= 2'b00;
+                block_write_en      <= 1'b0;
+                block_write_address <= 0;
+                block_write_data    <= 0;
+                block_read_address  <= 0;
             end
         end
-    end else begin
-        // When not active, ensure mem_done is deasserted and control signals are reset
-        mem_done            <= 1'b0;
-        mem_count           <= 0;
-        mem_read_state      <= 2'b00;
-        block_write_en      <= 1'b0;
-        block_write_address <= 0;
-        block_write_data    <= 0;
-        block_read_address  <= 0;
     end
-end
+endgenerate
 
 // TileLink Interface
 always_ff @(posedge clk or posedge reset) begin
@@ -357,7 +483,7 @@ always_ff @(posedge clk or posedge reset) begin
     `endif
     end else begin
         // Defaults
-        tl_a_ready <= (state == IDLE);
+        tl_a_ready <= ((state == IDLE) || (state == BURST_DATA)) && ~(tl_a_valid && tl_a_ready);
 
         case (state)
             IDLE: begin
@@ -365,7 +491,13 @@ always_ff @(posedge clk or posedge reset) begin
                     // Capture request
                     req_address  <= tl_a_address;
                     req_size     <= tl_a_size;
+                    burst_size   <= tl_a_size;
+                    burst_left   <= 8'd0;
                     req_read     <= (tl_a_opcode == GET_OPCODE);
+                    req_atomic   <= (tl_a_opcode == ARITHMETIC_DATA_OPCODE) ||
+                                    (tl_a_opcode == LOGICAL_DATA_OPCODE);
+                    req_opcode   <= tl_a_opcode;
+                    req_param    <= tl_a_param;
                     req_source   <= tl_a_source;
                     req_wstrb    <= tl_a_mask;
                     req_wdata    <= tl_a_data;
@@ -395,11 +527,28 @@ always_ff @(posedge clk or posedge reset) begin
                     end
                     `endif
 
+                    if (~ATOMICS && (tl_a_opcode == ARITHMETIC_DATA_OPCODE ||
+                                     tl_a_opcode == LOGICAL_DATA_OPCODE)) begin
+                        `ifdef LOG_MEMORY `LOG("tl_memory", ("Atomic access without ATOMICS: 0x%h", tl_a_address)); `endif
+                        resp_denied <= 1'b1;
+                    end
+
                     if (tl_a_address > max_valid_address(req_size)) begin
                         `ifdef LOG_MEMORY `LOG("tl_memory", ("Invalid address access: 0x%h", req_address)); `endif
                         resp_denied <= 1'b1;
                     end
 
+                    // Bursts are processed one bus word at a time
+                    if (BURST && tl_a_size > BEAT_SIZE) begin
+                        req_size   <= BEAT_SIZE;
+                        burst_left <= (8'd1 << (tl_a_size - BEAT_SIZE)) - 8'd1;
+                        if ((tl_a_address & ~({XLEN{1'b1}} << tl_a_size)) != 0 ||
+                            tl_a_address > max_valid_address(tl_a_size)) begin
+                            `ifdef LOG_MEMORY `LOG("tl_memory", ("Invalid burst access: 0x%h size=%0d", tl_a_address, tl_a_size)); `endif
+                            resp_denied <= 1'b1;
+                        end
+                    end
+
                     `ifdef LOG_MEMORY `LOG("tl_memory", ("/IDLE/ tl_a_address=%0h", tl_a_address)); `endif
                     state <= FETCH;
                 end
@@ -411,14 +560,43 @@ always_ff @(posedge clk or posedge reset) begin
                     resp_opcode <= TL_ACCESS_ACK_ERROR;
                     resp_param  <= 2'b10; // Error param
                     resp_data   <= {XLEN{1'b0}};
-                    state <= RESPOND;
+                    // A denied burst write still has to take the rest of its beats
+                    state <= (~req_read && burst_left != 0) ? BURST_DATA : RESPOND;
                 end else if (resp_corrupt) begin
                     resp_opcode <= TL_ACCESS_ACK_DATA_CORRUPT;
                     resp_param  <= 2'b01; // Error param
                     // Optionally, set resp_data to a corrupted value
                     // For demonstration, flipping the LSB
                     resp_data <= req_read ? (resp_data ^ {{(XLEN-1){1'b0}}, 1'b1}) : {XLEN{1'b1}};
-                    state <= RESPOND;
+                    state <= (~req_read && burst_left != 0) ? BURST_DATA : RESPOND;
+                end else if (BYTE_ENABLE) begin
+                    // Wide memory, block_read_data already holds the word
+                    resp_param  <= 2'b00;
+                    resp_source <= req_source;
+                    if (~wide_fits || (~req_read && ~wide_mask_ok) || (req_atomic && ~amo_size_ok)) begin
+                        `ifdef LOG_MEMORY `ERROR("tl_memory", ("/FETCH/ Alignment Error req_address=%0h req_size=%0b req_wstrb=%0b", req_address, req_size, req_wstrb)); `endif
+                        resp_opcode <= TL_ACCESS_ACK_ERROR;
+                        resp_denied <= 1'b1;
+                        resp_param  <= 2'b10; // Error param
+                        resp_data   <= {XLEN{1'b0}};
+                    end else if (req_read) begin
+                        `ifdef LOG_MEMORY `LOG("tl_memory", ("/FETCH/ READ req_address=%0h block_read_data=%0h req_size=%0b", req_address, block_read_data, req_size)); `endif
+                        resp_opcode <= TL_ACCESS_ACK_DATA;
+                        resp_data   <= (block_read_data >> (8 * byte_offset)) & wide_data_mask;
+                    end else if (req_atomic) begin
+                        `ifdef LOG_MEMORY `LOG("tl_memory", ("/FETCH/ ATOMIC req_address=%0h block_read_data=%0h req_wdata=%0h", req_address, block_read_data, req_wdata)); `endif
+                        resp_opcode <= TL_ACCESS_ACK_DATA;
+                        resp_data   <= (block_read_data >> (8 * byte_offset)) & wide_data_mask;
+                        req_wdata   <= amo_result(req_opcode, req_param, req_size,
+                                                  block_read_data >> (8 * byte_offset), req_wdata);
+                    end else begin
+                        `ifdef LOG_MEMORY `LOG("tl_memory", ("/FETCH/ WRITE req_address=%0h req_wdata=%0h req_size=%0b", req_address, req_wdata, req_size)); `endif
+                        resp_opcode <= TL_ACCESS_ACK;
+                        resp_data   <= {XLEN{1'b0}};
+                    end
+                    state <= (~req_read && burst_left != 0) ? BURST_DATA :
+                             (req_atomic && ~resp_denied && wide_fits && wide_mask_ok && amo_size_ok) ? WRITE_BACK :
+                             RESPOND;
                 end else begin
                     // Initiate multi-part memory read
                     if (!mem_done) begin
@@ -484,6 +662,27 @@ always_ff @(posedge clk or posedge reset) begin
                         end
                     endcase
 
+                end else if (req_atomic) begin
+                    // Answer with the old value and write back the result
+                    resp_opcode <= TL_ACCESS_ACK_DATA;
+                    if (amo_size_ok && wstrb_count == (1 << req_size)) begin
+                        `ifdef LOG_MEMORY `LOG("tl_memory", ("/PROCESS/ ATOMIC req_address=%0h old=%0h req_wdata=%0h req_size=%0b", req_address, mem_odata_reg >> (8*byte_offset), req_wdata, req_size)); `endif
+                        if (req_size == 3'b010) begin
+                            resp_data <= mem_odata_reg[ 8*byte_offset +: 32 ];
+                            mem_idata_reg[ 8*byte_offset +: 32 ] <= amo_result(req_opcode, req_param, req_size,
+                                                                               mem_odata_reg >> (8*byte_offset), req_wdata);
+                        end else if (XLEN >= 64) begin
+                            resp_data <= mem_odata_reg[ 8*byte_offset +: 64 ];
+                            mem_idata_reg[ 8*byte_offset +: 64 ] <= amo_result(req_opcode, req_param, req_size,
+                                                                               mem_odata_reg >> (8*byte_offset), req_wdata);
+                        end
+                    end else begin
+                        `ifdef LOG_MEMORY `ERROR("tl_memory", ("/PROCESS/ ATOMIC Size Error req_address=%0h req_size=%0b req_wstrb=%0b", req_address, req_size, req_wstrb)); `endif
+                        resp_opcode <= TL_ACCESS_ACK_ERROR;
+                        resp_denied <= 1'b1;
+                        resp_param  <= 2'b10; // Error param
+                        resp_data   <= {XLEN{1'b0}};
+                    end
                 end else begin
                     resp_opcode <= TL_ACCESS_ACK;
                     resp_data   <= {XLEN{1'b0}};
@@ -584,7 +783,11 @@ always_ff @(posedge clk or posedge reset) begin
             end
 
             WRITE_BACK: begin
-                if (!mem_done) begin
+                if (BYTE_ENABLE) begin
+                    // Atomic result on a wide memory, written this cycle by block_write_en
+                    `ifdef LOG_MEMORY `LOG("tl_memory", ("/WRITE_BACK/ ATOMIC req_address=%0h req_wdata=%0h", req_address, req_wdata)); `endif
+                    state <= RESPOND;
+                end else if (!mem_done) begin
                     `ifdef LOG_MEMORY `LOG("tl_memory", ("/WRITE_BACK/ tl_a_address=%0h", tl_a_address)); `endif
                     mem_read  <= 1'b0;
                     mem_write <= 1'b1;  // Indicate a write operation
@@ -592,7 +795,19 @@ always_ff @(posedge clk or posedge reset) begin
                     state <= WRITE_BACK;
                 end else if (mem_done) begin
                     mem_start <= 1'b0;
-                    state <= RESPOND;
+                    state <= (burst_left != 0) ? BURST_DATA : RESPOND;
+                end
+            end
+
+            BURST_DATA: begin
+                if (tl_a_valid && tl_a_ready) begin
+                    // Next beat of a burst write, the address only comes with the first beat
+                    `ifdef LOG_MEMORY `LOG("tl_memory", ("/BURST_DATA/ beats_left=%0d tl_a_data=%0h", burst_left, tl_a_data)); `endif
+                    req_address <= req_address + XLEN/8;
+                    req_wstrb   <= tl_a_mask;
+                    req_wdata   <= tl_a_data;
+                    burst_left  <= burst_left - 8'd1;
+                    state       <= FETCH;
                 end
             end
 
@@ -601,7 +816,7 @@ always_ff @(posedge clk or posedge reset) begin
                 // Assign response signals
                 tl_d_opcode  <= resp_opcode;
                 tl_d_param   <= resp_param;
-                tl_d_size    <= req_size;
+                tl_d_size    <= burst_size;
                 tl_d_source  <= resp_source;
                 tl_d_data    <= resp_data;
                 tl_d_corrupt <= resp_corrupt;
@@ -611,7 +826,13 @@ always_ff @(posedge clk or posedge reset) begin
             end
 
             RESPOND_WAIT: begin
-                if (tl_d_ready) begin
+                if (tl_d_ready && req_read && burst_left != 0) begin
+                    // Next beat of a burst read, keep any denied or corrupt state for the rest
+                    tl_d_valid  <= 1'b0;
+                    req_address <= req_address + XLEN/8;
+                    burst_left  <= burst_left - 8'd1;
+                    state       <= FETCH;
+                end else if (tl_d_ready) begin
                     `ifdef LOG_MEMORY `LOG("tl_memory", ("/COMPLETED/ resp_data=0x%08h resp_opcode=%0b resp_corrupt=%0b resp_denied=%0b", tl_d_data, tl_d_opcode, tl_d_corrupt, tl_d_denied)); `endif
                     // Handshake done, go back to IDLE
                     tl_d_opcode  <= 3'b000;
@@ -0,0 +1,271 @@
+`ifndef __TL_MEMORY_DP__
+`define __TL_MEMORY_DP__
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// tl_memory_dp Module
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @module tl_memory_dp
+ * @brief Dual-Port TileLink-UL Memory with Independent Slave Ports.
+ *
+ * The `tl_memory_dp` module puts two TileLink-UL slave ports in front of one `block_ram_dp`, so
+ * an instruction fetch master and a load/store master can both be served in the same cycle
+ * instead of taking turns on a single `tl_memory`. Each port has its own small state machine and
+ * its own block RAM port; the only thing the two ports share is the memory array.
+ *
+ * **Parameters:**
+ * - `XLEN` (default: 32): Specifies the bus data width, also the width of a memory word.
+ * - `SIZE` (default: 1024): Defines the size of the memory array in bytes.
+ * - `SID_WIDTH` (default: 2): Specifies the width of the Source ID used for TileLink transactions.
+ *
+ * **Interface:**
+ * The TileLink A and D channel signals are the same as on `tl_memory`, packed into vectors with
+ * one entry per port in the same way as the `tl_switch` master and slave ports: port `p` uses
+ * `tl_a_valid[p]`, `tl_a_address[p*XLEN +: XLEN]` and so on. Port 0 is meant for instruction
+ * fetches and port 1 for loads and stores, but the two ports are identical.
+ *
+ * **Behavior:**
+ * - **Timing:** The block RAM port is addressed from `tl_a_address` in the cycle the request is
+ *               accepted, so the response is driven on `tl_d_valid` one cycle later.
+ *               `tl_a_ready` drops while a port has a request in flight.
+ * - **Accesses:** `GET` returns the `2^tl_a_size` bytes at the address, LSB aligned on
+ *                 `tl_d_data`. Every other opcode writes the same bytes from the low bytes of
+ *                 `tl_a_data`. `tl_a_mask` has to be an aligned run of `2^tl_a_size` bytes.
+ * - **Errors:** Requests outside of `SIZE`, requests that do not fit inside one bus word and
+ *               writes with a bad mask are answered with `ACCESS_ACK_ERROR` and `tl_d_denied`.
+ * - **Ordering:** A read returns the memory contents from before a write that the other port
+ *                 makes in the same cycle. Writes from the two ports to the same byte in the
+ *                 same cycle are undefined, masters that share data have to order them.
+ */
+
+`timescale 1ns / 1ps
+`default_nettype none
+
+`include "block_ram_dp.sv"
+`include "log.sv"
+
+module tl_memory_dp #(
+    parameter int XLEN = 32,
+    parameter int SIZE = 1024,
+    parameter int SID_WIDTH = 2
+) (
+    input  wire                     clk,
+    input  wire                     reset,
+
+    // TileLink A Channel
+    input  wire [1:0]               tl_a_valid,
+    output wire [1:0]               tl_a_ready,
+    input  wire [2*3-1:0]           tl_a_opcode,
+    input  wire [2*3-1:0]           tl_a_param,
+    input  wire [2*3-1:0]           tl_a_size,
+    input  wire [2*SID_WIDTH-1:0]   tl_a_source,
+    input  wire [2*XLEN-1:0]        tl_a_address,
+    input  wire [2*(XLEN/8)-1:0]    tl_a_mask,
+    input  wire [2*XLEN-1:0]        tl_a_data,
+
+    // TileLink D Channel
+    output wire [1:0]               tl_d_valid,
+    input  wire [1:0]               tl_d_ready,
+    output wire [2*3-1:0]           tl_d_opcode,
+    output wire [2*2-1:0]           tl_d_param,
+    output wire [2*3-1:0]           tl_d_size,
+    output wire [2*SID_WIDTH-1:0]   tl_d_source,
+    output wire [2*XLEN-1:0]        tl_d_data,
+    output wire [1:0]               tl_d_corrupt,
+    output wire [1:0]               tl_d_denied
+);
+
+initial begin
+    `ASSERT((XLEN == 32 || XLEN == 64), "XLEN must be 32 or 64.");
+    `ASSERT((SID_WIDTH >= 2), "SID_WIDTH must be 2 or more.");
+    `ASSERT((SIZE % (XLEN / 8) == 0), "SIZE must be a multiple of XLEN/8 to ensure proper byte alignment.");
+end
+
+// Local parameters
+localparam [2:0] TL_ACCESS_ACK              = 3'b000;
+localparam [2:0] TL_ACCESS_ACK_DATA         = 3'b010;
+localparam [2:0] TL_ACCESS_ACK_ERROR        = 3'b111;
+localparam [2:0] GET_OPCODE                 = 3'b100;
+
+localparam int PORTS              = 2;
+localparam int BYTE_OFFSET_WIDTH  = $clog2(XLEN/8);
+localparam int BLOCK_ADDRESS_SIZE = $clog2(SIZE/(XLEN/8));
+
+// States
+localparam [1:0] IDLE         = 2'b00;
+localparam [1:0] ACCESS       = 2'b01;
+localparam [1:0] RESPOND_WAIT = 2'b10;
+
+// Block RAM ports, one slice per TileLink port
+wire [PORTS-1:0]                    block_write_en;
+wire [PORTS*(XLEN/8)-1:0]           block_write_strb;
+wire [PORTS*BLOCK_ADDRESS_SIZE-1:0] block_address;
+wire [PORTS*XLEN-1:0]               block_write_data;
+wire [PORTS*XLEN-1:0]               block_read_data;
+
+block_ram_dp #(
+    .SIZE           (SIZE),
+    .WIDTH          (XLEN)
+) block_ram_inst (
+	.clk            (clk),
+	.reset          (reset),
+	.a_write_en     (block_write_en[0]),
+	.a_write_strb   (block_write_strb[0 +: XLEN/8]),
+	.a_address      (block_address[0 +: BLOCK_ADDRESS_SIZE]),
+	.a_write_data   (block_write_data[0 +: XLEN]),
+	.a_read_data    (block_read_data[0 +: XLEN]),
+	.b_write_en     (block_write_en[1]),
+	.b_write_strb   (block_write_strb[XLEN/8 +: XLEN/8]),
+	.b_address      (block_address[BLOCK_ADDRESS_SIZE +: BLOCK_ADDRESS_SIZE]),
+	.b_write_data   (block_write_data[XLEN +: XLEN]),
+	.b_read_data    (block_read_data[XLEN +: XLEN])
+);
+
+genvar p;
+generate
+    for (p = 0; p < PORTS; p = p + 1) begin : gen_port
+        reg [1:0]               state;
+
+        // Registers to hold request info
+        reg [XLEN-1:0]          req_address;
+        reg [2:0]               req_size;
+        reg                     req_read;
+        reg [SID_WIDTH-1:0]     req_source;
+        reg [XLEN/8-1:0]        req_wstrb;
+        reg [XLEN-1:0]          req_wdata;
+        reg                     req_denied;
+
+        // TileLink outputs of this port
+        reg                     a_ready;
+        reg                     d_valid;
+        reg [2:0]               d_opcode;
+        reg [1:0]               d_param;
+        reg [2:0]               d_size;
+        reg [SID_WIDTH-1:0]     d_source;
+        reg [XLEN-1:0]          d_data;
+        reg                     d_denied;
+
+        assign tl_a_ready[p]                       = a_ready;
+        assign tl_d_valid[p]                       = d_valid;
+        assign tl_d_opcode[p*3 +: 3]               = d_opcode;
+        assign tl_d_param[p*2 +: 2]                = d_param;
+        assign tl_d_size[p*3 +: 3]                 = d_size;
+        assign tl_d_source[p*SID_WIDTH +: SID_WIDTH] = d_source;
+        assign tl_d_data[p*XLEN +: XLEN]           = d_data;
+        assign tl_d_corrupt[p]                     = 1'b0;
+        assign tl_d_denied[p]                      = d_denied;
+
+        // Incoming request of this port
+        wire [2:0]              a_size    = tl_a_size[p*3 +: 3];
+        wire [XLEN-1:0]         a_address = tl_a_address[p*XLEN +: XLEN];
+        wire [XLEN/8-1:0]       a_mask    = tl_a_mask[p*(XLEN/8) +: XLEN/8];
+        wire [BYTE_OFFSET_WIDTH-1:0] a_offset = a_address[BYTE_OFFSET_WIDTH-1:0];
+
+        // Request checks, see Errors above
+        reg                     a_fits;         // Request fits inside one bus word and SIZE
+        reg                     a_mask_ok;      // a_mask is an aligned run of 2^a_size bytes
+        integer j;
+        always_comb begin
+            a_fits    = ({{(32-BYTE_OFFSET_WIDTH){1'b0}}, a_offset} + (32'd1 << a_size)) <= XLEN/8 &&
+                        a_address <= SIZE - (32'd1 << a_size);
+            a_mask_ok = 1'b0;
+            for (j = 0; j < XLEN/8; j++) begin
+                if ((j % (1 << a_size)) == 0 &&
+                    {{(32-XLEN/8){1'b0}}, a_mask} == (((1 << (1 << a_size)) - 1) << j)) begin
+                    a_mask_ok = 1'b1;
+                end
+            end
+        end
+
+        // Bytes and data bits covered by the captured request
+        wire [BYTE_OFFSET_WIDTH-1:0] req_offset = req_address[BYTE_OFFSET_WIDTH-1:0];
+        wire [XLEN-1:0]         req_data_mask = ~({XLEN{1'b1}} << (8 << req_size));
+        reg  [XLEN/8-1:0]       req_strb;
+        integer k;
+        always_comb begin
+            for (k = 0; k < XLEN/8; k++) begin
+                req_strb[k] = (k >= req_offset) && (k < req_offset + (1 << req_size));
+            end
+        end
+
+        // The word is read while the request is accepted and written from ACCESS
+        assign block_address[p*BLOCK_ADDRESS_SIZE +: BLOCK_ADDRESS_SIZE] =
+            (state == IDLE) ? a_address[BLOCK_ADDRESS_SIZE + BYTE_OFFSET_WIDTH - 1 : BYTE_OFFSET_WIDTH]
+                            : req_address[BLOCK_ADDRESS_SIZE + BYTE_OFFSET_WIDTH - 1 : BYTE_OFFSET_WIDTH];
+        assign block_write_en[p]                    = (state == ACCESS) && ~req_read && ~req_denied;
+        assign block_write_strb[p*(XLEN/8) +: XLEN/8] = req_strb;
+        assign block_write_data[p*XLEN +: XLEN]     = req_wdata << (8 * req_offset);
+
+        always_ff @(posedge clk or posedge reset) begin
+            if (reset) begin
+                state       <= IDLE;
+                a_ready     <= 1'b0;
+                d_valid     <= 1'b0;
+                d_opcode    <= 3'b000;
+                d_param     <= 2'b00;
+                d_size      <= 3'b000;
+                d_source    <= {SID_WIDTH{1'b0}};
+                d_data      <= {XLEN{1'b0}};
+                d_denied    <= 1'b0;
+                req_denied  <= 1'b0;
+            end else begin
+                case (state)
+                    IDLE: begin
+                        a_ready <= 1'b1;
+                        if (tl_a_valid[p] && a_ready) begin
+                            // Capture request
+                            req_address <= a_address;
+                            req_size    <= a_size;
+                            req_read    <= (tl_a_opcode[p*3 +: 3] == GET_OPCODE);
+                            req_source  <= tl_a_source[p*SID_WIDTH +: SID_WIDTH];
+                            req_wstrb   <= a_mask;
+                            req_wdata   <= tl_a_data[p*XLEN +: XLEN];
+                            req_denied  <= ~a_fits || (tl_a_opcode[p*3 +: 3] != GET_OPCODE && ~a_mask_ok);
+                            a_ready     <= 1'b0;
+                            `ifdef LOG_MEMORY `LOG("tl_memory_dp", ("/IDLE/ port=%0d tl_a_address=%0h", p, a_address)); `endif
+                            state       <= ACCESS;
+                        end
+                    end
+
+                    ACCESS: begin
+                        // block_read_data holds the word, a write goes out this cycle
+                        d_size   <= req_size;
+                        d_source <= req_source;
+                        d_denied <= req_denied;
+                        if (req_denied) begin
+                            `ifdef LOG_MEMORY `ERROR("tl_memory_dp", ("/ACCESS/ port=%0d denied req_address=%0h req_size=%0b req_wstrb=%0b", p, req_address, req_size, req_wstrb)); `endif
+                            d_opcode <= TL_ACCESS_ACK_ERROR;
+                            d_param  <= 2'b10; // Error param
+                            d_data   <= {XLEN{1'b0}};
+                        end else if (req_read) begin
+                            d_opcode <= TL_ACCESS_ACK_DATA;
+                            d_param  <= 2'b00;
+                            d_data   <= (block_read_data[p*XLEN +: XLEN] >> (8 * req_offset)) & req_data_mask;
+                        end else begin
+                            d_opcode <= TL_ACCESS_ACK;
+                            d_param  <= 2'b00;
+                            d_data   <= {XLEN{1'b0}};
+                        end
+                        d_valid <= 1'b1;
+                        state   <= RESPOND_WAIT;
+                    end
+
+                    RESPOND_WAIT: begin
+                        if (tl_d_ready[p]) begin
+                            `ifdef LOG_MEMORY `LOG("tl_memory_dp", ("/COMPLETED/ port=%0d d_data=0x%0h d_opcode=%0b d_denied=%0b", p, d_data, d_opcode, d_denied)); `endif
+                            d_valid    <= 1'b0;
+                            d_denied   <= 1'b0;
+                            req_denied <= 1'b0;
+                            a_ready    <= 1'b1;
+                            state      <= IDLE;
+                        end
+                    end
+
+                    default: state <= IDLE;
+                endcase
+            end
+        end
+    end
+endgenerate
+endmodule
+
+`endif // __TL_MEMORY_DP__
@@ -5,17 +5,33 @@
  * @module soc
  * @brief Top level module for the System-on-Chip.
  *
+ * `NUM_HARTS` (default: 1) CPU cores are masters 0 to `NUM_HARTS`-1 of the switch and the DMA
+ * engine is the last master. Each core reads its index from `mhartid`; only hart 0 takes the
+ * external interrupts and drives the LEDs. With `SUPPORT_ZAAMO` the memory executes the cores'
+ * atomic memory operations, which is what keeps shared counters and locks consistent between
+ * harts.
+ *
+ * With `CLK_PLL` the system clock comes from a Gowin rPLL on the 27 MHz `CLK` pin, running at
+ * `27 * (PLL_FBDIV + 1) / (PLL_IDIV + 1)` MHz (`PLL_MHZ` rounded), and reset is held until the
+ * PLL locks. Simulations have no rPLL and take `CLK` to be the PLL output.
  */
 
 `timescale 1ns / 1ps
 `default_nettype none
 
 // Include necessary modules
+`ifdef PIPELINED
+`include "tl_cpu_pipe.sv"
+`else
 `include "tl_cpu.sv"
+`endif
 `include "tl_switch.sv"
 `include "tl_memory.sv"
 `include "tl_ul_bios.sv"
 `include "tl_ul_output.sv"
+`include "tl_ul_perf.sv"
+`include "tl_ul_timer.sv"
+`include "tl_ul_dma.sv"
 
 `ifndef XLEN
 `define XLEN 32
@@ -46,10 +62,56 @@ module top
 // ──────────────────────────
 parameter XLEN          = 32;
 parameter SID_WIDTH     = 2;
-parameter NUM_INPUTS    = 1;
-parameter NUM_OUTPUTS   = 3;
-parameter TRACK_DEPTH   = 2;
+`ifdef NUM_HARTS
+parameter NUM_HARTS     = `NUM_HARTS;
+`else
+parameter NUM_HARTS     = 1;
+`endif
+parameter NUM_INPUTS    = NUM_HARTS + 1;
+parameter NUM_OUTPUTS   = 6;
+parameter TRACK_DEPTH   = (NUM_HARTS > 1) ? 4 : 2;
+`ifdef SWITCH_CROSSBAR
+parameter CROSSBAR      = 1;
+`else
+parameter CROSSBAR      = 0;
+`endif
+`ifdef SWITCH_DECODE_MASK
+parameter DECODE_MASK   = 1;
+`else
+parameter DECODE_MASK   = 0;
+`endif
+`ifdef SWITCH_DECODE_REG
+parameter DECODE_REG    = 1;
+`else
+parameter DECODE_REG    = 0;
+`endif
+`ifdef TL_BURST
+parameter BURST         = 1;
+`else
+parameter BURST         = 0;
+`endif
+`ifdef BUS_STATS
+parameter STATS         = 1;
+`else
+parameter STATS         = 0;
+`endif
+`ifdef MEM_WIDE
+parameter MEM_WIDTH     = XLEN;
+parameter MEM_BYTE_EN   = 1;
+`else
+parameter MEM_WIDTH     = 8;
+parameter MEM_BYTE_EN   = 0;
+`endif
+`ifdef SUPPORT_ZAAMO
+parameter MEM_ATOMICS   = 1;
+`else
+parameter MEM_ATOMICS   = 0;
+`endif
+`ifdef CLK_PLL
+parameter CLK_FREQ_MHZ  = `PLL_MHZ;
+`else
 parameter CLK_FREQ_MHZ  = 27;
+`endif
 
 // ──────────────────────────
 // Clock and Reset
@@ -58,8 +120,62 @@ parameter CLK_FREQ_MHZ  = 27;
 (* DONT_TOUCH = "TRUE", KEEP = "TRUE" *) wire sys_clk;
 wire reset;
 
+`ifdef CLK_PLL
+`ifdef SYNTHESIS
+wire pll_clk;
+wire pll_lock;
+
+rPLL #(
+    .FCLKIN          ("27"),
+    .DEVICE          (`PLL_DEVICE),
+    .DYN_IDIV_SEL    ("false"),
+    .IDIV_SEL        (`PLL_IDIV),
+    .DYN_FBDIV_SEL   ("false"),
+    .FBDIV_SEL       (`PLL_FBDIV),
+    .DYN_ODIV_SEL    ("false"),
+    .ODIV_SEL        (`PLL_ODIV),
+    .PSDA_SEL        ("0000"),
+    .DYN_DA_EN       ("true"),
+    .DUTYDA_SEL      ("1000"),
+    .CLKOUT_FT_DIR   (1'b1),
+    .CLKOUTP_FT_DIR  (1'b1),
+    .CLKOUT_DLY_STEP (0),
+    .CLKOUTP_DLY_STEP(0),
+    .CLKFB_SEL       ("internal"),
+    .CLKOUT_BYPASS   ("false"),
+    .CLKOUTP_BYPASS  ("false"),
+    .CLKOUTD_BYPASS  ("false"),
+    .DYN_SDIV_SEL    (2),
+    .CLKOUTD_SRC     ("CLKOUT"),
+    .CLKOUTD3_SRC    ("CLKOUT")
+) pll_inst (
+    .CLKIN    (CLK),
+    .CLKOUT   (pll_clk),
+    .LOCK     (pll_lock),
+    .CLKOUTP  (),
+    .CLKOUTD  (),
+    .CLKOUTD3 (),
+    .RESET    (1'b0),
+    .RESET_P  (1'b0),
+    .CLKFB    (1'b0),
+    .FBDSEL   (6'b000000),
+    .IDSEL    (6'b000000),
+    .ODSEL    (6'b000000),
+    .PSDA     (4'b0000),
+    .DUTYDA   (4'b0000),
+    .FDLY     (4'b0000)
+);
+
+assign reset = BTN_S1 | ~pll_lock;
+assign sys_clk = pll_clk;
+`else
 assign reset = BTN_S1;
 assign sys_clk = CLK;
+`endif
+`else
+assign reset = BTN_S1;
+assign sys_clk = CLK;
+`endif
 
 // ──────────────────────────
 // LEDs
@@ -68,30 +184,56 @@ logic [5:0] leds;
 assign LED   = ~leds;
 
 // ──────────────────────────
-// Master 1 (CPU)
+// Masters 0 to NUM_HARTS-1 (CPUs)
+// ──────────────────────────
+
+// A Channel
+wire [NUM_HARTS-1:0]           cpu_tl_a_valid;
+wire [NUM_HARTS-1:0]           cpu_tl_a_ready;
+wire [NUM_HARTS*3-1:0]         cpu_tl_a_opcode;
+wire [NUM_HARTS*3-1:0]         cpu_tl_a_param;
+wire [NUM_HARTS*3-1:0]         cpu_tl_a_size;
+wire [NUM_HARTS*SID_WIDTH-1:0] cpu_tl_a_source;
+wire [NUM_HARTS*XLEN-1:0]      cpu_tl_a_address;
+wire [NUM_HARTS*XLEN/8-1:0]    cpu_tl_a_mask;
+wire [NUM_HARTS*XLEN-1:0]      cpu_tl_a_data;
+
+// D Channel
+wire [NUM_HARTS-1:0]           cpu_tl_d_valid;
+wire [NUM_HARTS-1:0]           cpu_tl_d_ready;
+wire [NUM_HARTS*3-1:0]         cpu_tl_d_opcode;
+wire [NUM_HARTS*2-1:0]         cpu_tl_d_param;
+wire [NUM_HARTS*3-1:0]         cpu_tl_d_size;
+wire [NUM_HARTS*SID_WIDTH-1:0] cpu_tl_d_source;
+wire [NUM_HARTS*XLEN-1:0]      cpu_tl_d_data;
+wire [NUM_HARTS-1:0]           cpu_tl_d_corrupt;
+wire [NUM_HARTS-1:0]           cpu_tl_d_denied;
+
+// ──────────────────────────
+// Master NUM_HARTS (DMA)
 // ──────────────────────────
 
 // A Channel
-wire                   cpu_tl_a_valid;
-wire                   cpu_tl_a_ready;
-wire [2:0]             cpu_tl_a_opcode;
-wire [2:0]             cpu_tl_a_param;
-wire [2:0]             cpu_tl_a_size;
-wire [SID_WIDTH-1:0]   cpu_tl_a_source;
-wire [XLEN-1:0]        cpu_tl_a_address;
-wire [XLEN/8-1:0]      cpu_tl_a_mask;
-wire [XLEN-1:0]        cpu_tl_a_data;
+wire                   dma_tl_a_valid;
+wire                   dma_tl_a_ready;
+wire [2:0]             dma_tl_a_opcode;
+wire [2:0]             dma_tl_a_param;
+wire [2:0]             dma_tl_a_size;
+wire [SID_WIDTH-1:0]   dma_tl_a_source;
+wire [XLEN-1:0]        dma_tl_a_address;
+wire [XLEN/8-1:0]      dma_tl_a_mask;
+wire [XLEN-1:0]        dma_tl_a_data;
 
 // D Channel
-wire                   cpu_tl_d_valid;
-wire                   cpu_tl_d_ready;
-wire [2:0]             cpu_tl_d_opcode;
-wire [1:0]             cpu_tl_d_param;
-wire [2:0]             cpu_tl_d_size;
-wire [SID_WIDTH-1:0]   cpu_tl_d_source;
-wire [XLEN-1:0]        cpu_tl_d_data;
-wire                   cpu_tl_d_corrupt;
-wire                   cpu_tl_d_denied;
+wire                   dma_tl_d_valid;
+wire                   dma_tl_d_ready;
+wire [2:0]             dma_tl_d_opcode;
+wire [1:0]             dma_tl_d_param;
+wire [2:0]             dma_tl_d_size;
+wire [SID_WIDTH-1:0]   dma_tl_d_source;
+wire [XLEN-1:0]        dma_tl_d_data;
+wire                   dma_tl_d_corrupt;
+wire                   dma_tl_d_denied;
 
 // ──────────────────────────
 // Slave - memory
@@ -186,6 +328,120 @@ wire [XLEN-1:0]        output_s_d_data;
 wire                   output_s_d_corrupt;
 wire                   output_s_d_denied;
 
+// ──────────────────────────
+// Slave - perf
+// ──────────────────────────
+
+logic [XLEN-1:0] perf_base_address;
+logic [XLEN-1:0] perf_size;
+assign perf_base_address = 32'h0002_0000;
+assign perf_size         = 32'h0000_03FF;
+
+// A Channel
+wire                   perf_s_a_valid;
+wire                   perf_s_a_ready;
+wire [2:0]             perf_s_a_opcode;
+wire [2:0]             perf_s_a_param;
+wire [2:0]             perf_s_a_size;
+wire [SID_WIDTH-1:0]   perf_s_a_source;
+wire [XLEN/8-1:0]      perf_s_a_mask;
+wire [XLEN-1:0]        perf_s_a_address;
+wire [XLEN-1:0]        perf_s_a_data;
+
+// D Channel
+wire                   perf_s_d_valid;
+wire                   perf_s_d_ready;
+wire [2:0]             perf_s_d_opcode;
+wire [1:0]             perf_s_d_param;
+wire [2:0]             perf_s_d_size;
+wire [SID_WIDTH-1:0]   perf_s_d_source;
+wire [XLEN-1:0]        perf_s_d_data;
+wire                   perf_s_d_corrupt;
+wire                   perf_s_d_denied;
+
+// ──────────────────────────
+// Slave - timer
+// ──────────────────────────
+
+logic [XLEN-1:0] timer_base_address;
+logic [XLEN-1:0] timer_size;
+assign timer_base_address = 32'h0003_0000;
+assign timer_size         = 32'h0000_000F;
+
+// A Channel
+wire                   timer_s_a_valid;
+wire                   timer_s_a_ready;
+wire [2:0]             timer_s_a_opcode;
+wire [2:0]             timer_s_a_param;
+wire [2:0]             timer_s_a_size;
+wire [SID_WIDTH-1:0]   timer_s_a_source;
+wire [XLEN/8-1:0]      timer_s_a_mask;
+wire [XLEN-1:0]        timer_s_a_address;
+wire [XLEN-1:0]        timer_s_a_data;
+
+// D Channel
+wire                   timer_s_d_valid;
+wire                   timer_s_d_ready;
+wire [2:0]             timer_s_d_opcode;
+wire [1:0]             timer_s_d_param;
+wire [2:0]             timer_s_d_size;
+wire [SID_WIDTH-1:0]   timer_s_d_source;
+wire [XLEN-1:0]        timer_s_d_data;
+wire                   timer_s_d_corrupt;
+wire                   timer_s_d_denied;
+
+// Machine Timer Interrupt
+wire                   timer_irq;
+
+// ──────────────────────────
+// Slave - dma
+// ──────────────────────────
+
+logic [XLEN-1:0] dma_base_address;
+logic [XLEN-1:0] dma_size;
+assign dma_base_address = 32'h0004_0000;
+assign dma_size         = 32'h0000_001F;
+
+// A Channel
+wire                   dma_s_a_valid;
+wire                   dma_s_a_ready;
+wire [2:0]             dma_s_a_opcode;
+wire [2:0]             dma_s_a_param;
+wire [2:0]             dma_s_a_size;
+wire [SID_WIDTH-1:0]   dma_s_a_source;
+wire [XLEN/8-1:0]      dma_s_a_mask;
+wire [XLEN-1:0]        dma_s_a_address;
+wire [XLEN-1:0]        dma_s_a_data;
+
+// D Channel
+wire                   dma_s_d_valid;
+wire                   dma_s_d_ready;
+wire [2:0]             dma_s_d_opcode;
+wire [1:0]             dma_s_d_param;
+wire [2:0]             dma_s_d_size;
+wire [SID_WIDTH-1:0]   dma_s_d_source;
+wire [XLEN-1:0]        dma_s_d_data;
+wire                   dma_s_d_corrupt;
+wire                   dma_s_d_denied;
+
+// DMA Completion Interrupt
+wire                   dma_irq;
+
+// tl_soc has no UART, IRQ 0 stays low so the DMA keeps IRQ 1
+wire                   uart_irq;
+assign uart_irq = 1'b0;
+
+// Switch Counters
+wire                          stats_clear;
+wire [NUM_INPUTS*32-1:0]      stats_m_requests;
+wire [NUM_INPUTS*32-1:0]      stats_m_latency;
+wire [NUM_INPUTS*32-1:0]      stats_m_max_latency;
+wire [NUM_OUTPUTS*32-1:0]     stats_s_requests;
+wire [NUM_OUTPUTS*32-1:0]     stats_s_latency;
+wire [NUM_OUTPUTS*32-1:0]     stats_s_max_latency;
+wire [31:0]                   stats_track_used;
+wire [31:0]                   stats_track_max;
+
 
 // ──────────────────────────
 // Instantiate the TileLink Switch
@@ -195,7 +451,12 @@ tl_switch #(
     .NUM_OUTPUTS    (NUM_OUTPUTS),
     .XLEN           (XLEN),
     .SID_WIDTH      (SID_WIDTH),
-    .TRACK_DEPTH    (TRACK_DEPTH)
+    .TRACK_DEPTH    (TRACK_DEPTH),
+    .CROSSBAR       (CROSSBAR),
+    .DECODE_MASK    (DECODE_MASK),
+    .DECODE_REG     (DECODE_REG),
+    .BURST          (BURST),
+    .STATS          (STATS)
 ) switch_inst (
     .clk            (sys_clk),
     .reset          (reset),
@@ -203,107 +464,139 @@ tl_switch #(
     // ======================
     // TileLink A Channel - Masters
     // ======================
-    .a_valid     ({ cpu_tl_a_valid   }),
-    .a_ready     ({ cpu_tl_a_ready   }),
-    .a_opcode    ({ cpu_tl_a_opcode  }),
-    .a_param     ({ cpu_tl_a_param   }),
-    .a_size      ({ cpu_tl_a_size    }),
-    .a_source    ({ cpu_tl_a_source  }),
-    .a_address   ({ cpu_tl_a_address }),
-    .a_mask      ({ cpu_tl_a_mask    }),
-    .a_data      ({ cpu_tl_a_data    }),
+    .a_valid     ({ dma_tl_a_valid   , cpu_tl_a_valid   }),
+    .a_ready     ({ dma_tl_a_ready   , cpu_tl_a_ready   }),
+    .a_opcode    ({ dma_tl_a_opcode  , cpu_tl_a_opcode  }),
+    .a_param     ({ dma_tl_a_param   , cpu_tl_a_param   }),
+    .a_size      ({ dma_tl_a_size    , cpu_tl_a_size    }),
+    .a_source    ({ dma_tl_a_source  , cpu_tl_a_source  }),
+    .a_address   ({ dma_tl_a_address , cpu_tl_a_address }),
+    .a_mask      ({ dma_tl_a_mask    , cpu_tl_a_mask    }),
+    .a_data      ({ dma_tl_a_data    , cpu_tl_a_data    }),
 
     // ======================
     // TileLink D Channel - Masters
     // ======================
-    .d_valid     ({ cpu_tl_d_valid   }),
-    .d_ready     ({ cpu_tl_d_ready   }),
-    .d_opcode    ({ cpu_tl_d_opcode  }),
-    .d_param     ({ cpu_tl_d_param   }),
-    .d_size      ({ cpu_tl_d_size    }),
-    .d_source    ({ cpu_tl_d_source  }),
-    .d_data      ({ cpu_tl_d_data    }),
-    .d_corrupt   ({ cpu_tl_d_corrupt }),
-    .d_denied    ({ cpu_tl_d_denied  }),
+    .d_valid     ({ dma_tl_d_valid   , cpu_tl_d_valid   }),
+    .d_ready     ({ dma_tl_d_ready   , cpu_tl_d_ready   }),
+    .d_opcode    ({ dma_tl_d_opcode  , cpu_tl_d_opcode  }),
+    .d_param     ({ dma_tl_d_param   , cpu_tl_d_param   }),
+    .d_size      ({ dma_tl_d_size    , cpu_tl_d_size    }),
+    .d_source    ({ dma_tl_d_source  , cpu_tl_d_source  }),
+    .d_data      ({ dma_tl_d_data    , cpu_tl_d_data    }),
+    .d_corrupt   ({ dma_tl_d_corrupt , cpu_tl_d_corrupt }),
+    .d_denied    ({ dma_tl_d_denied  , cpu_tl_d_denied  }),
 
     // ======================
     // A Channel - Slaves
     // ======================
-    .s_a_valid   ({ bios_s_a_valid    , memory_s_a_valid   , output_s_a_valid     }),
-    .s_a_ready   ({ bios_s_a_ready    , memory_s_a_ready   , output_s_a_ready     }),
-    .s_a_opcode  ({ bios_s_a_opcode   , memory_s_a_opcode  , output_s_a_opcode    }),
-    .s_a_param   ({ bios_s_a_param    , memory_s_a_param   , output_s_a_param     }),
-    .s_a_size    ({ bios_s_a_size     , memory_s_a_size    , output_s_a_size      }),
-    .s_a_source  ({ bios_s_a_source   , memory_s_a_source  , output_s_a_source    }),
-    .s_a_mask    ({ bios_s_a_mask     , memory_s_a_mask    , output_s_a_mask      }),
-    .s_a_address ({ bios_s_a_address  , memory_s_a_address , output_s_a_address   }),
-    .s_a_data    ({ bios_s_a_data     , memory_s_a_data    , output_s_a_data      }),
+    .s_a_valid   ({ dma_s_a_valid   , timer_s_a_valid   , perf_s_a_valid    , bios_s_a_valid     , memory_s_a_valid    , output_s_a_valid    }),
+    .s_a_ready   ({ dma_s_a_ready   , timer_s_a_ready   , perf_s_a_ready    , bios_s_a_ready     , memory_s_a_ready    , output_s_a_ready    }),
+    .s_a_opcode  ({ dma_s_a_opcode  , timer_s_a_opcode  , perf_s_a_opcode   , bios_s_a_opcode    , memory_s_a_opcode   , output_s_a_opcode   }),
+    .s_a_param   ({ dma_s_a_param   , timer_s_a_param   , perf_s_a_param    , bios_s_a_param     , memory_s_a_param    , output_s_a_param    }),
+    .s_a_size    ({ dma_s_a_size    , timer_s_a_size    , perf_s_a_size     , bios_s_a_size      , memory_s_a_size     , output_s_a_size     }),
+    .s_a_source  ({ dma_s_a_source  , timer_s_a_source  , perf_s_a_source   , bios_s_a_source    , memory_s_a_source   , output_s_a_source   }),
+    .s_a_mask    ({ dma_s_a_mask    , timer_s_a_mask    , perf_s_a_mask     , bios_s_a_mask      , memory_s_a_mask     , output_s_a_mask     }),
+    .s_a_address ({ dma_s_a_address , timer_s_a_address , perf_s_a_address  , bios_s_a_address   , memory_s_a_address  , output_s_a_address  }),
+    .s_a_data    ({ dma_s_a_data    , timer_s_a_data    , perf_s_a_data     , bios_s_a_data      , memory_s_a_data     , output_s_a_data     }),
 
     // ======================
     // D Channel - Slaves
     // ======================
-    .s_d_valid   ({ bios_s_d_valid    , memory_s_d_valid   , output_s_d_valid     }),
-    .s_d_ready   ({ bios_s_d_ready    , memory_s_d_ready   , output_s_d_ready     }),
-    .s_d_opcode  ({ bios_s_d_opcode   , memory_s_d_opcode  , output_s_d_opcode    }),
-    .s_d_param   ({ bios_s_d_param    , memory_s_d_param   , output_s_d_param     }),
-    .s_d_size    ({ bios_s_d_size     , memory_s_d_size    , output_s_d_size      }),
-    .s_d_source  ({ bios_s_d_source   , memory_s_d_source  , output_s_d_source    }),
-    .s_d_data    ({ bios_s_d_data     , memory_s_d_data    , output_s_d_data      }),
-    .s_d_corrupt ({ bios_s_d_corrupt  , memory_s_d_corrupt , output_s_d_corrupt   }),
-    .s_d_denied  ({ bios_s_d_denied   , memory_s_d_denied  , output_s_d_denied    }),
+    .s_d_valid   ({ dma_s_d_valid   , timer_s_d_valid   , perf_s_d_valid    , bios_s_d_valid     , memory_s_d_valid    , output_s_d_valid    }),
+    .s_d_ready   ({ dma_s_d_ready   , timer_s_d_ready   , perf_s_d_ready    , bios_s_d_ready     , memory_s_d_ready    , output_s_d_ready    }),
+    .s_d_opcode  ({ dma_s_d_opcode  , timer_s_d_opcode  , perf_s_d_opcode   , bios_s_d_opcode    , memory_s_d_opcode   , output_s_d_opcode   }),
+    .s_d_param   ({ dma_s_d_param   , timer_s_d_param   , perf_s_d_param    , bios_s_d_param     , memory_s_d_param    , output_s_d_param    }),
+    .s_d_size    ({ dma_s_d_size    , timer_s_d_size    , perf_s_d_size     , bios_s_d_size      , memory_s_d_size     , output_s_d_size     }),
+    .s_d_source  ({ dma_s_d_source  , timer_s_d_source  , perf_s_d_source   , bios_s_d_source    , memory_s_d_source   , output_s_d_source   }),
+    .s_d_data    ({ dma_s_d_data    , timer_s_d_data    , perf_s_d_data     , bios_s_d_data      , memory_s_d_data     , output_s_d_data     }),
+    .s_d_corrupt ({ dma_s_d_corrupt , timer_s_d_corrupt , perf_s_d_corrupt  , bios_s_d_corrupt   , memory_s_d_corrupt  , output_s_d_corrupt  }),
+    .s_d_denied  ({ dma_s_d_denied  , timer_s_d_denied  , perf_s_d_denied   , bios_s_d_denied    , memory_s_d_denied   , output_s_d_denied   }),
 
     // ======================
     // Base Addresses for Slaves
     // ======================
-    .base_addr   ({ bios_base_address , memory_base_address , output_base_address  }),
-    .addr_mask   ({ bios_size         , memory_size         , output_size          })
+    .base_addr   ({ dma_base_address  , timer_base_address, perf_base_address , bios_base_address  , memory_base_address , output_base_address }),
+    .addr_mask   ({ dma_size          , timer_size        , perf_size         , bios_size          , memory_size         , output_size         }),
+
+    // ======================
+    // Performance Counters
+    // ======================
+    .stats_clear         (stats_clear),
+    .stats_m_requests    (stats_m_requests),
+    .stats_m_latency     (stats_m_latency),
+    .stats_m_max_latency (stats_m_max_latency),
+    .stats_s_requests    (stats_s_requests),
+    .stats_s_latency     (stats_s_latency),
+    .stats_s_max_latency (stats_s_max_latency),
+    .stats_track_used    (stats_track_used),
+    .stats_track_max     (stats_track_max)
 );
 
 // ──────────────────────────
-// Instantiate the CPU
+// Instantiate the CPUs
 // ──────────────────────────
-tl_cpu #(
-    .MHARTID_VAL     (32'h0000_0000),
-    .XLEN            (XLEN),
-    .SID_WIDTH       (SID_WIDTH),
-    .START_ADDRESS   (32'h8000_0000),
-    .MTVEC_RESET_VAL (32'h0000_0000),
-    .NMI_COUNT       (1),
-    .IRQ_COUNT       (1)
-) cpu_inst (
-    .clk             (sys_clk),
-    .reset           (reset),
-
-    `ifdef SUPPORT_ZICSR
-    .external_irq ({ uart_irq }),
-    .external_nmi ({ 1'b0 }),
+// Every hart boots from the bios and start.S sends all but hart 0 to secondary_main
+genvar h;
+generate
+for (h = 0; h < NUM_HARTS; h = h + 1) begin : g_hart
+    wire [5:0] hart_test;
+
+    if (h == 0) begin : g_leds
+        assign leds = hart_test;
+    end
+
+    `ifdef PIPELINED
+    tl_cpu_pipe #(
+    `else
+    tl_cpu #(
     `endif
-
-    // TileLink A Channel (Master to Switch)
-    .tl_a_valid    (cpu_tl_a_valid),
-    .tl_a_ready    (cpu_tl_a_ready),
-    .tl_a_opcode   (cpu_tl_a_opcode),
-    .tl_a_param    (cpu_tl_a_param),
-    .tl_a_size     (cpu_tl_a_size),
-    .tl_a_source   (cpu_tl_a_source),
-    .tl_a_address  (cpu_tl_a_address),
-    .tl_a_mask     (cpu_tl_a_mask),
-    .tl_a_data     (cpu_tl_a_data),
-
-    // TileLink D Channel (Switch to Master)
-    .tl_d_valid    (cpu_tl_d_valid),
-    .tl_d_ready    (cpu_tl_d_ready),
-    .tl_d_opcode   (cpu_tl_d_opcode),
-    .tl_d_param    (cpu_tl_d_param),
-    .tl_d_size     (cpu_tl_d_size),
-    .tl_d_source   (cpu_tl_d_source),
-    .tl_d_data     (cpu_tl_d_data),
-    .tl_d_corrupt  (cpu_tl_d_corrupt),
-    .tl_d_denied   (cpu_tl_d_denied),
-
-    .test          (leds),
-    .trap          ()
-);
+        .MHARTID_VAL     (h),
+        .XLEN            (XLEN),
+        .SID_WIDTH       (SID_WIDTH),
+        .START_ADDRESS   (32'h8000_0000),
+        .MTVEC_RESET_VAL (32'h0000_0000),
+        .NMI_COUNT       (1),
+        .IRQ_COUNT       (2),
+        .DCACHE_BASE     (32'h0000_0000), // Only the tl_memory window is cached,
+        .DCACHE_MASK     (32'h0000_FFFF)  // bios and output are not
+    ) cpu_inst (
+        .clk             (sys_clk),
+        .reset           (reset),
+
+        `ifdef SUPPORT_ZICSR
+        .external_irq ((h == 0) ? { dma_irq, uart_irq } : 2'b00),
+        .external_nmi ({ 1'b0 }),
+        .external_timer ((h == 0) ? timer_irq : 1'b0),
+        `endif
+
+        // TileLink A Channel (Master to Switch)
+        .tl_a_valid    (cpu_tl_a_valid[h]),
+        .tl_a_ready    (cpu_tl_a_ready[h]),
+        .tl_a_opcode   (cpu_tl_a_opcode[h*3 +: 3]),
+        .tl_a_param    (cpu_tl_a_param[h*3 +: 3]),
+        .tl_a_size     (cpu_tl_a_size[h*3 +: 3]),
+        .tl_a_source   (cpu_tl_a_source[h*SID_WIDTH +: SID_WIDTH]),
+        .tl_a_address  (cpu_tl_a_address[h*XLEN +: XLEN]),
+        .tl_a_mask     (cpu_tl_a_mask[h*(XLEN/8) +: (XLEN/8)]),
+        .tl_a_data     (cpu_tl_a_data[h*XLEN +: XLEN]),
+
+        // TileLink D Channel (Switch to Master)
+        .tl_d_valid    (cpu_tl_d_valid[h]),
+        .tl_d_ready    (cpu_tl_d_ready[h]),
+        .tl_d_opcode   (cpu_tl_d_opcode[h*3 +: 3]),
+        .tl_d_param    (cpu_tl_d_param[h*2 +: 2]),
+        .tl_d_size     (cpu_tl_d_size[h*3 +: 3]),
+        .tl_d_source   (cpu_tl_d_source[h*SID_WIDTH +: SID_WIDTH]),
+        .tl_d_data     (cpu_tl_d_data[h*XLEN +: XLEN]),
+        .tl_d_corrupt  (cpu_tl_d_corrupt[h]),
+        .tl_d_denied   (cpu_tl_d_denied[h]),
+
+        .test          (hart_test),
+        .trap          ()
+    );
+end
+endgenerate
 
 // ──────────────────────────
 // Instantiate Memory 
@@ -311,7 +604,11 @@ tl_cpu #(
 tl_memory #(
     .XLEN           (XLEN),
     .SIZE           ('h10000),
-    .SID_WIDTH      (SID_WIDTH)
+    .WIDTH          (MEM_WIDTH),
+    .SID_WIDTH      (SID_WIDTH),
+    .BURST          (BURST),
+    .BYTE_ENABLE    (MEM_BYTE_EN),
+    .ATOMICS        (MEM_ATOMICS)
 ) memory_inst (
     .clk            (sys_clk),
     .reset          (reset),
@@ -409,4 +706,144 @@ tl_ul_output #(
     .tl_d_denied    (output_s_d_denied)
 );
 
+// ──────────────────────────
+// Instantiate perf
+// ──────────────────────────
+tl_ul_perf #(
+    .XLEN           (XLEN),
+    .SID_WIDTH      (SID_WIDTH),
+    .NUM_INPUTS     (NUM_INPUTS),
+    .NUM_OUTPUTS    (NUM_OUTPUTS),
+    .TRACK_DEPTH    (TRACK_DEPTH)
+) perf_inst (
+    .clk                 (sys_clk),
+    .reset               (reset),
+
+    // Switch Counters
+    .stats_clear         (stats_clear),
+    .stats_m_requests    (stats_m_requests),
+    .stats_m_latency     (stats_m_latency),
+    .stats_m_max_latency (stats_m_max_latency),
+    .stats_s_requests    (stats_s_requests),
+    .stats_s_latency     (stats_s_latency),
+    .stats_s_max_latency (stats_s_max_latency),
+    .stats_track_used    (stats_track_used),
+    .stats_track_max     (stats_track_max),
+
+    // TileLink A Channel
+    .tl_a_valid     (perf_s_a_valid),
+    .tl_a_ready     (perf_s_a_ready),
+    .tl_a_opcode    (perf_s_a_opcode),
+    .tl_a_param     (perf_s_a_param),
+    .tl_a_size      (perf_s_a_size),
+    .tl_a_source    (perf_s_a_source),
+    .tl_a_address   (perf_s_a_address),
+    .tl_a_mask      (perf_s_a_mask),
+    .tl_a_data      (perf_s_a_data),
+
+    // TileLink D Channel
+    .tl_d_valid     (perf_s_d_valid),
+    .tl_d_ready     (perf_s_d_ready),
+    .tl_d_opcode    (perf_s_d_opcode),
+    .tl_d_param     (perf_s_d_param),
+    .tl_d_size      (perf_s_d_size),
+    .tl_d_source    (perf_s_d_source),
+    .tl_d_data      (perf_s_d_data),
+    .tl_d_corrupt   (perf_s_d_corrupt),
+    .tl_d_denied    (perf_s_d_denied)
+);
+
+// ──────────────────────────
+// Instantiate timer
+// ──────────────────────────
+tl_ul_timer #(
+    .XLEN           (XLEN),
+    .SID_WIDTH      (SID_WIDTH),
+    .DIVIDER        (CLK_FREQ_MHZ * 1000) // mtime counts milliseconds
+) timer_inst (
+    .clk            (sys_clk),
+    .reset          (reset),
+
+    .irq            (timer_irq),
+
+    // TileLink A Channel
+    .tl_a_valid     (timer_s_a_valid),
+    .tl_a_ready     (timer_s_a_ready),
+    .tl_a_opcode    (timer_s_a_opcode),
+    .tl_a_param     (timer_s_a_param),
+    .tl_a_size      (timer_s_a_size),
+    .tl_a_source    (timer_s_a_source),
+    .tl_a_address   (timer_s_a_address),
+    .tl_a_mask      (timer_s_a_mask),
+    .tl_a_data      (timer_s_a_data),
+
+    // TileLink D Channel
+    .tl_d_valid     (timer_s_d_valid),
+    .tl_d_ready     (timer_s_d_ready),
+    .tl_d_opcode    (timer_s_d_opcode),
+    .tl_d_param     (timer_s_d_param),
+    .tl_d_size      (timer_s_d_size),
+    .tl_d_source    (timer_s_d_source),
+    .tl_d_data      (timer_s_d_data),
+    .tl_d_corrupt   (timer_s_d_corrupt),
+    .tl_d_denied    (timer_s_d_denied)
+);
+
+// ──────────────────────────
+// Instantiate dma
+// ──────────────────────────
+tl_ul_dma #(
+    .XLEN           (XLEN),
+    .SID_WIDTH      (SID_WIDTH)
+) dma_inst (
+    .clk            (sys_clk),
+    .reset          (reset),
+
+    .irq            (dma_irq),
+
+    // TileLink A Channel (Registers)
+    .tl_a_valid     (dma_s_a_valid),
+    .tl_a_ready     (dma_s_a_ready),
+    .tl_a_opcode    (dma_s_a_opcode),
+    .tl_a_param     (dma_s_a_param),
+    .tl_a_size      (dma_s_a_size),
+    .tl_a_source    (dma_s_a_source),
+    .tl_a_address   (dma_s_a_address),
+    .tl_a_mask      (dma_s_a_mask),
+    .tl_a_data      (dma_s_a_data),
+
+    // TileLink D Channel (Registers)
+    .tl_d_valid     (dma_s_d_valid),
+    .tl_d_ready     (dma_s_d_ready),
+    .tl_d_opcode    (dma_s_d_opcode),
+    .tl_d_param     (dma_s_d_param),
+    .tl_d_size      (dma_s_d_size),
+    .tl_d_source    (dma_s_d_source),
+    .tl_d_data      (dma_s_d_data),
+    .tl_d_corrupt   (dma_s_d_corrupt),
+    .tl_d_denied    (dma_s_d_denied),
+
+    // TileLink A Channel (Master to Switch)
+    .m_a_valid      (dma_tl_a_valid),
+    .m_a_ready      (dma_tl_a_ready),
+    .m_a_opcode     (dma_tl_a_opcode),
+    .m_a_param      (dma_tl_a_param),
+    .m_a_size       (dma_tl_a_size),
+    .m_a_source     (dma_tl_a_source),
+    .m_a_address    (dma_tl_a_address),
+    .m_a_mask       (dma_tl_a_mask),
+    .m_a_data       (dma_tl_a_data),
+
+    // TileLink D Channel (Switch to Master)
+    .m_d_valid      (dma_tl_d_valid),
+    .m_d_ready      (dma_tl_d_ready),
+    .m_d_opcode     (dma_tl_d_opcode),
+    .m_d_param      (dma_tl_d_param),
+    .m_d_size       (dma_tl_d_size),
+    .m_d_source     (dma_tl_d_source),
+    .m_d_data       (dma_tl_d_data),
+    .m_d_corrupt    (dma_tl_d_corrupt),
+    .m_d_denied     (dma_tl_d_denied)
+);
+
 endmodule
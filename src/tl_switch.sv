@@ -7,6 +7,28 @@
  * @module tl_switch
  * @brief TileLink-UL Switch for Routing Requests and Responses Between Masters and Slaves.
  *
+ * By default one A channel FSM and one D channel FSM step through the masters, slaves and
+ * tracking entries in turn. With `CROSSBAR` set, each slave has a round-robin arbiter over the
+ * masters and each master a round-robin arbiter over the slaves, the tracking table is searched in
+ * a single cycle, and requests to different slaves are forwarded in the same cycle.
+ *
+ * Slaves are decoded by comparing each address against `base_addr` .. `base_addr + addr_mask`.
+ * `DECODE_MASK` replaces that with a mask compare for naturally aligned power of two windows, and
+ * `DECODE_REG` registers the decode so it is off the request path, at the cost of a cycle.
+ *
+ * With `BURST` set, requests whose `a_size` is larger than the bus width are TL-UH multi-beat
+ * bursts: a Get is answered with one D beat per bus word and a PutFullData sends one A beat per
+ * bus word. The beats of a burst are never interleaved with another message, the slave stays
+ * with the master until its last A beat and the master's D channel stays with the slave until the
+ * last D beat, and the tracking entry is held until the whole burst has been answered.
+ *
+ * With `STATS` set, the switch watches its tracking table and counts, for every master and every
+ * slave, the transactions it finished, their summed latency and the longest one. A transaction's
+ * latency is the number of cycles its tracking entry was in use, from accepting the request to
+ * the last D beat. Requests to unmapped addresses are not counted. The number of tracking entries
+ * in use and its high-water mark are kept as well.
+ * All counters are 32 bits wide, wrap, and are cleared by `reset` or `stats_clear`.
+ * `tl_ul_perf` makes them readable from the bus.
  */
 
 `timescale 1ns / 1ps
@@ -24,7 +46,12 @@ module tl_switch #(
     parameter NUM_OUTPUTS   = 4,
     parameter XLEN          = 32,
     parameter SID_WIDTH     = 8,
-    parameter TRACK_DEPTH   = 16
+    parameter TRACK_DEPTH   = 16,
+    parameter CROSSBAR      = 0,    // 1: per-slave arbiters forward to different slaves in parallel
+    parameter DECODE_MASK   = 0,    // 1: decode slaves as (address & ~addr_mask) == base_addr
+    parameter DECODE_REG    = 0,    // 1: register the address decode, one cycle of request latency
+    parameter BURST         = 0,    // 1: forward multi-beat Get and PutFullData bursts
+    parameter STATS         = 0     // 1: per master and per slave performance counters
 )(
     input  wire                               clk,
     input  wire                               reset,
@@ -61,7 +88,7 @@ module tl_switch #(
     output reg   [NUM_OUTPUTS-1:0]           s_a_valid,      // Indicates that each master has a valid request
     input  wire  [NUM_OUTPUTS-1:0]           s_a_ready,      // Indicates that the switch has accepted requests from each master
     output reg   [NUM_OUTPUTS*3-1:0]         s_a_opcode,     // Operation codes for each master’s request 
-    output reg   [NUM_OUTPUTS*2-1:0]         s_a_param,      // Additional parameters for each master’s request 
+    output reg   [NUM_OUTPUTS*3-1:0]         s_a_param,      // Additional parameters for each master’s request 
     output reg   [NUM_OUTPUTS*3-1:0]         s_a_size,       // Size of each request in log2(Bytes per beat). 
     output reg   [NUM_OUTPUTS*SID_WIDTH-1:0] s_a_source,     // Source IDs for each master’s request 
     output reg   [NUM_OUTPUTS*XLEN-1:0]      s_a_address,    // Addresses for each master’s request 
@@ -85,7 +112,20 @@ module tl_switch #(
     // Base Addresses for Slaves
     // ======================
     input  wire [NUM_OUTPUTS*XLEN-1:0]        base_addr,     // Holds the base address for a slave
-    input  wire [NUM_OUTPUTS*XLEN-1:0]        addr_mask      // Holds the address space size for a slave
+    input  wire [NUM_OUTPUTS*XLEN-1:0]        addr_mask,     // Holds the address space size for a slave
+
+    // ======================
+    // Performance Counters, only with STATS
+    // ======================
+    input  wire                               stats_clear,         // Clears every counter
+    output wire [NUM_INPUTS*32-1:0]           stats_m_requests,    // Transactions finished per master
+    output wire [NUM_INPUTS*32-1:0]           stats_m_latency,     // Summed latency per master
+    output wire [NUM_INPUTS*32-1:0]           stats_m_max_latency, // Longest latency per master
+    output wire [NUM_OUTPUTS*32-1:0]          stats_s_requests,    // Transactions finished per slave
+    output wire [NUM_OUTPUTS*32-1:0]          stats_s_latency,     // Summed latency per slave
+    output wire [NUM_OUTPUTS*32-1:0]          stats_s_max_latency, // Longest latency per slave
+    output wire [31:0]                        stats_track_used,    // Tracking entries in use
+    output wire [31:0]                        stats_track_max      // Most tracking entries ever in use
 );
 
 initial begin
@@ -103,6 +143,18 @@ end
 localparam int NUM_INPUTS_LOG2  = (NUM_INPUTS > 1)  ? $clog2(NUM_INPUTS)  : 1;
 localparam int NUM_OUTPUTS_LOG2 = (NUM_OUTPUTS > 1) ? $clog2(NUM_OUTPUTS) : 1;
 localparam int TRACK_DEPTH_LOG2 = (TRACK_DEPTH > 1) ? $clog2(TRACK_DEPTH) : 1;
+localparam int BEAT_SIZE        = $clog2(XLEN/8);
+localparam [2:0] GET_OPCODE     = 3'b100;
+
+// Beats after the first one for a transfer of 2^size bytes. Gets have them on the D channel,
+// everything else on the A channel.
+function automatic [7:0] burst_beats(input [2:0] size);
+    if (BURST && size > BEAT_SIZE) begin
+        burst_beats = (8'd1 << (size - BEAT_SIZE)) - 8'd1;
+    end else begin
+        burst_beats = 8'd0;
+    end
+endfunction
 
 // ======================
 // Stats
@@ -128,6 +180,130 @@ logic [SID_WIDTH-1:0]        tracking_entry_source_id  [0:TRACK_DEPTH-1]; // Sou
 logic                        tracking_entry_auto_resp  [0:TRACK_DEPTH-1]; // A router sets high when there should be an atuo-responce
 logic                        tracking_entry_finished   [0:TRACK_DEPTH-1]; // D router sets high when finished
 logic                        tracking_entry_valid      [0:TRACK_DEPTH-1]; // High is entry is valid, Low if not
+logic [7:0]                  tracking_entry_beats      [0:TRACK_DEPTH-1]; // D beats after the first one
+
+// ======================
+// Performance Counters
+// ======================
+// A tracking entry is active from the cycle it is filled until the D router finishes it. The
+// serial routers mark it finished and free it later, the crossbar frees it right away.
+generate
+if (STATS) begin : g_stats
+    logic [TRACK_DEPTH-1:0]                stats_active;
+    logic [31:0]                           stats_age [0:TRACK_DEPTH-1];
+    logic [NUM_INPUTS-1:0][31:0]           m_requests, m_latency, m_max_latency;
+    logic [NUM_OUTPUTS-1:0][31:0]          s_requests, s_latency, s_max_latency;
+    logic [31:0]                           track_used, track_max;
+
+    assign stats_m_requests    = m_requests;
+    assign stats_m_latency     = m_latency;
+    assign stats_m_max_latency = m_max_latency;
+    assign stats_s_requests    = s_requests;
+    assign stats_s_latency     = s_latency;
+    assign stats_s_max_latency = s_max_latency;
+    assign stats_track_used    = track_used;
+    assign stats_track_max     = track_max;
+
+    always_comb begin
+        track_used = 32'd0;
+        for (int t = 0; t < TRACK_DEPTH; t++) begin
+            track_used = track_used + tracking_entry_valid[t];
+        end
+    end
+
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            stats_active <= {TRACK_DEPTH{1'b0}};
+            for (int t = 0; t < TRACK_DEPTH; t++) begin
+                stats_age[t] <= 32'd0;
+            end
+        end else begin
+            for (int t = 0; t < TRACK_DEPTH; t++) begin
+                if (stats_active[t]) begin
+                    if (~tracking_entry_valid[t] || tracking_entry_finished[t]) begin
+                        stats_active[t] <= 1'b0;
+                    end
+                    stats_age[t] <= stats_age[t] + 32'd1;
+                end else if (tracking_entry_valid[t] && ~tracking_entry_finished[t]) begin
+                    stats_active[t] <= 1'b1;
+                    stats_age[t]    <= 32'd1;
+                end
+            end
+        end
+    end
+
+    // At most one entry per master and one per slave finishes in a cycle, but the sums do not
+    // rely on it
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            m_requests    <= '0;
+            m_latency     <= '0;
+            m_max_latency <= '0;
+            s_requests    <= '0;
+            s_latency     <= '0;
+            s_max_latency <= '0;
+            track_max     <= 32'd0;
+        end else if (stats_clear) begin
+            m_requests    <= '0;
+            m_latency     <= '0;
+            m_max_latency <= '0;
+            s_requests    <= '0;
+            s_latency     <= '0;
+            s_max_latency <= '0;
+            track_max     <= 32'd0;
+        end else begin
+            for (int m = 0; m < NUM_INPUTS; m++) begin
+                logic [31:0] count, latency, longest;
+                count   = m_requests[m];
+                latency = m_latency[m];
+                longest = m_max_latency[m];
+                for (int t = 0; t < TRACK_DEPTH; t++) begin
+                    // Auto-responses are left out, the crossbar answers them without an entry
+                    if (stats_active[t] && (~tracking_entry_valid[t] || tracking_entry_finished[t]) &&
+                        tracking_entry_master_idx[t] == m &&
+                        tracking_entry_slave_idx[t] != {(NUM_OUTPUTS_LOG2+1){1'b1}}) begin
+                        count   = count + 32'd1;
+                        latency = latency + stats_age[t];
+                        if (stats_age[t] > longest) longest = stats_age[t];
+                    end
+                end
+                m_requests[m]    <= count;
+                m_latency[m]     <= latency;
+                m_max_latency[m] <= longest;
+            end
+
+            for (int s = 0; s < NUM_OUTPUTS; s++) begin
+                logic [31:0] count, latency, longest;
+                count   = s_requests[s];
+                latency = s_latency[s];
+                longest = s_max_latency[s];
+                for (int t = 0; t < TRACK_DEPTH; t++) begin
+                    if (stats_active[t] && (~tracking_entry_valid[t] || tracking_entry_finished[t]) &&
+                        tracking_entry_slave_idx[t] == s) begin
+                        count   = count + 32'd1;
+                        latency = latency + stats_age[t];
+                        if (stats_age[t] > longest) longest = stats_age[t];
+                    end
+                end
+                s_requests[s]    <= count;
+                s_latency[s]     <= latency;
+                s_max_latency[s] <= longest;
+            end
+
+            if (track_used > track_max) track_max <= track_used;
+        end
+    end
+end else begin : g_no_stats
+    assign stats_m_requests    = '0;
+    assign stats_m_latency     = '0;
+    assign stats_m_max_latency = '0;
+    assign stats_s_requests    = '0;
+    assign stats_s_latency     = '0;
+    assign stats_s_max_latency = '0;
+    assign stats_track_used    = 32'd0;
+    assign stats_track_max     = 32'd0;
+end
+endgenerate
 
 // ======================
 // Address Lookup Table
@@ -153,6 +329,11 @@ for (al_idx = 0; al_idx < NUM_OUTPUTS; al_idx++) begin : lookup_table
                                    {1'b0, addr_mask[al_idx*XLEN +: XLEN]};
 
         `ASSERT((!lookup_top_addr[al_idx][XLEN]), "Carry-over detected in lookup_top_addr");
+        if (DECODE_MASK) begin
+            `ASSERT(((addr_mask[al_idx*XLEN +: XLEN] & (addr_mask[al_idx*XLEN +: XLEN] + 1)) == 0 &&
+                     (base_addr[al_idx*XLEN +: XLEN] & addr_mask[al_idx*XLEN +: XLEN]) == 0),
+                    "DECODE_MASK needs each addr_mask to be 2^n-1 and base_addr aligned to it");
+        end
 
         `ifdef LOG_SWITCH_MAP
         `LOG("tl_switch", (format_str, al_idx, lookup_base_addr[al_idx][XLEN-1:0], lookup_top_addr[al_idx][XLEN-1:0]));
@@ -168,23 +349,61 @@ endgenerate
 // One bit larger so we can mark as invalid
 reg [NUM_OUTPUTS_LOG2:0] master_slave_idx      [0:NUM_INPUTS-1];
 reg [XLEN-1:0]           master_mapped_address [0:NUM_INPUTS-1];
+wire [NUM_INPUTS-1:0]    master_decode_valid;  // Decode matches the master's current a_address
 
 genvar ad_idx;
 generate
 for (ad_idx = 0; ad_idx < NUM_INPUTS; ad_idx++) begin : master_decode
+    reg [NUM_OUTPUTS_LOG2:0] slave_idx;
+    reg [XLEN-1:0]           mapped_address;
+
     always_comb begin
         // Default assignments
-        master_slave_idx[ad_idx]      = {(NUM_OUTPUTS_LOG2+1){1'b1}};
-        master_mapped_address[ad_idx] = {XLEN{1'b0}}; // Assign a default value
+        slave_idx      = {(NUM_OUTPUTS_LOG2+1){1'b1}};
+        mapped_address = {XLEN{1'b0}}; // Assign a default value
 
         for (integer al_lookup = 0; al_lookup < NUM_OUTPUTS; al_lookup++) begin
-            if ((a_address[ad_idx*XLEN +: XLEN] >= lookup_base_addr[al_lookup]) &&
-                (a_address[ad_idx*XLEN +: XLEN] <= lookup_top_addr[al_lookup])) begin
-                master_slave_idx[ad_idx]      = {1'b0, al_lookup[NUM_OUTPUTS_LOG2-1:0]};
-                master_mapped_address[ad_idx] = a_address[ad_idx*XLEN +: XLEN] - lookup_base_addr[al_lookup][XLEN-1:0];
+            if (DECODE_MASK) begin
+                // Slaves are naturally aligned power of two windows, no compare or subtract
+                if ((a_address[ad_idx*XLEN +: XLEN] & ~addr_mask[al_lookup*XLEN +: XLEN]) ==
+                    base_addr[al_lookup*XLEN +: XLEN]) begin
+                    slave_idx      = {1'b0, al_lookup[NUM_OUTPUTS_LOG2-1:0]};
+                    mapped_address = a_address[ad_idx*XLEN +: XLEN] & addr_mask[al_lookup*XLEN +: XLEN];
+                end
+            end else if ((a_address[ad_idx*XLEN +: XLEN] >= lookup_base_addr[al_lookup]) &&
+                         (a_address[ad_idx*XLEN +: XLEN] <= lookup_top_addr[al_lookup])) begin
+                slave_idx      = {1'b0, al_lookup[NUM_OUTPUTS_LOG2-1:0]};
+                mapped_address = a_address[ad_idx*XLEN +: XLEN] - lookup_base_addr[al_lookup][XLEN-1:0];
             end
         end
     end
+
+    if (DECODE_REG) begin : registered
+        // The decode is taken from the previous cycle's address and is only used by the routers
+        // once a_address has been stable for a cycle
+        reg [XLEN-1:0] decoded_address;
+
+        always_ff @(posedge clk or posedge reset) begin
+            if (reset) begin
+                decoded_address               <= {XLEN{1'b0}};
+                master_slave_idx[ad_idx]      <= {(NUM_OUTPUTS_LOG2+1){1'b1}};
+                master_mapped_address[ad_idx] <= {XLEN{1'b0}};
+            end else begin
+                decoded_address               <= a_address[ad_idx*XLEN +: XLEN];
+                master_slave_idx[ad_idx]      <= slave_idx;
+                master_mapped_address[ad_idx] <= mapped_address;
+            end
+        end
+
+        assign master_decode_valid[ad_idx] = (decoded_address == a_address[ad_idx*XLEN +: XLEN]);
+    end else begin : combinational
+        always_comb begin
+            master_slave_idx[ad_idx]      = slave_idx;
+            master_mapped_address[ad_idx] = mapped_address;
+        end
+
+        assign master_decode_valid[ad_idx] = 1'b1;
+    end
 end
 endgenerate
 
@@ -199,328 +418,700 @@ typedef enum logic [2:0] {
     A_SLAVE_READY    = 3'b011,
     A_SLAVE_ACK      = 3'b100,
     A_SLAVE_FINISH   = 3'b101,
-    A_NEXT_TRACKING  = 3'b110
+    A_NEXT_TRACKING  = 3'b110,
+    A_BURST          = 3'b111
 } a_channel_fsm;
 a_channel_fsm a_fsm_state;
 
 reg [NUM_INPUTS_LOG2-1:0] a_m_idx;   // A Channel Master Index
 reg [TRACK_DEPTH_LOG2-1:0] a_t_idx;  // A Channel Tracking Index
 reg [TRACK_DEPTH_LOG2:0] a_mts;      // A Channel Master's Tracking Slot
+reg [7:0] a_burst_left;              // A Channel beats still to forward for the current burst
+reg [NUM_OUTPUTS_LOG2-1:0] a_burst_slave; // A Channel slave taking the burst
+reg a_burst_drop;                    // A Channel burst is auto-responded, its beats are dropped
 
-always_ff @(posedge clk or posedge reset) begin
-    if (reset) begin
-        // Reset counters
-        a_m_idx <= {NUM_INPUTS_LOG2{1'b0}};
-        a_t_idx <= {TRACK_DEPTH_LOG2{1'b0}};
-        a_fsm_state <= A_RESET_TRACKING;
+// ======================
+// D Channel Router
+// ======================
 
-        // Reset channel acks
-        a_ready <= {NUM_INPUTS{1'b0}};
-        s_a_valid <= {NUM_OUTPUTS{1'b0}};
-    end else begin
-        case (a_fsm_state)
-            A_RESET_TRACKING: begin
-                `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_RESET_TRACKING/ a_t_idx=%0d", a_t_idx)); `endif
-
-                tracking_entry_master_idx[a_t_idx] <= {NUM_INPUTS_LOG2{1'b0}};
-                tracking_entry_slave_idx[a_t_idx]  <= {NUM_OUTPUTS_LOG2+1{1'b0}};
-                tracking_entry_source_id[a_t_idx]  <= {SID_WIDTH{1'b0}};
-                tracking_entry_auto_resp[a_t_idx]  <= 1'b0;
-                tracking_entry_valid[a_t_idx]      <= 1'b0;
-
-                if (a_t_idx == TRACK_DEPTH-1) begin
-                    a_t_idx <= {TRACK_DEPTH_LOG2{1'b0}};
-                    a_fsm_state <= A_NEXT_MASTER;
-                end else begin
-                    a_t_idx <= a_t_idx + 1'b1;
-                    a_fsm_state <= A_RESET_TRACKING;
+typedef enum logic [2:0] {
+    D_RESET_TRACKING   = 3'b000,
+    D_NEXT_SLAVE       = 3'b001,
+    D_TRACKING_SCAN    = 3'b010,
+    D_SLAVE_VALID      = 3'b011,
+    D_MASTER_ACK       = 3'b100,
+    D_AUTO_RESPOND     = 3'b101,
+    D_AUTO_RESPOND_ACK = 3'b110,
+    D_FINISH           = 3'b111
+} d_channel_fsm;
+d_channel_fsm d_fsm_state;
+
+reg [NUM_OUTPUTS_LOG2-1:0] d_s_idx;  // A Channel Slace Index
+reg [TRACK_DEPTH_LOG2-1:0] d_t_idx;  // A Channel Tracking Index
+reg [TRACK_DEPTH_LOG2:0] d_sts;      // A Channel Slave's Tracking Slot
+reg [7:0] d_beat;                    // D Channel beats delivered for the current burst
+
+// ======================
+// Router Selection
+// ======================
+
+generate
+if (CROSSBAR) begin : g_crossbar
+    // Every slave has its own A channel arbiter and every master its own D channel arbiter, so
+    // requests to different slaves (and responses to different masters) move in the same cycle.
+    // The tracking table is searched in parallel: a priority encoder hands out free entries, a
+    // (master, source) compare holds back duplicate requests and a (slave, source) compare routes
+    // each response.
+
+    reg   [NUM_INPUTS_LOG2-1:0]  x_a_rr          [0:NUM_OUTPUTS-1]; // Round-robin start per slave
+    reg   [NUM_OUTPUTS_LOG2-1:0] x_d_rr          [0:NUM_INPUTS-1];  // Round-robin start per master
+    reg   [NUM_INPUTS-1:0]       x_auto_pending;                    // Auto response owed to master
+    reg   [SID_WIDTH-1:0]        x_auto_source   [0:NUM_INPUTS-1];
+    reg   [NUM_INPUTS-1:0]       x_d_busy;                          // d_valid raised, waiting for d_ready
+    reg   [NUM_INPUTS-1:0]       x_d_auto;                          // Busy with an auto response
+    reg   [NUM_OUTPUTS_LOG2-1:0] x_d_slave       [0:NUM_INPUTS-1];  // Slave being responded for
+    reg   [TRACK_DEPTH_LOG2-1:0] x_d_entry       [0:NUM_INPUTS-1];  // Tracking entry being responded for
+    reg   [7:0]                  x_d_beat        [0:NUM_INPUTS-1];  // D beats delivered for the current burst
+    reg   [7:0]                  x_auto_beats    [0:NUM_INPUTS-1];  // Auto response beats after this one
+    reg   [7:0]                  x_a_burst       [0:NUM_INPUTS-1];  // A beats still to come from the master
+    reg   [NUM_INPUTS-1:0]       x_a_drop;                          // Burst is auto-responded, beats are dropped
+    reg   [NUM_OUTPUTS-1:0]      x_s_lock;                          // Slave is taking a burst
+    reg   [NUM_INPUTS_LOG2-1:0]  x_s_lock_master [0:NUM_OUTPUTS-1]; // Master sending that burst
+
+    logic [NUM_INPUTS-1:0]       x_tracked;                         // Master's request must wait
+    logic [NUM_INPUTS-1:0]       x_unmapped;                        // Master's request gets an auto response
+    logic [NUM_INPUTS-1:0]       x_a_cont;                          // Master is in the middle of a burst
+    logic [NUM_OUTPUTS-1:0]      x_a_grant;                         // Slave takes a request this cycle
+    logic [NUM_OUTPUTS-1:0]      x_a_next;                          // Grant is the next beat of a burst
+    logic [NUM_INPUTS_LOG2-1:0]  x_a_master      [0:NUM_OUTPUTS-1]; // Master granted on each slave
+    logic [TRACK_DEPTH_LOG2-1:0] x_a_entry       [0:NUM_OUTPUTS-1]; // Free entry for each grant
+    logic [TRACK_DEPTH-1:0]      x_a_taken;
+    logic                        x_a_found;
+    logic [NUM_OUTPUTS-1:0]      x_s_serving;                       // Slave response is on a master's D channel
+    logic [NUM_OUTPUTS-1:0]      x_s_match;                         // Slave response has a tracking entry
+    logic [TRACK_DEPTH_LOG2-1:0] x_s_entry       [0:NUM_OUTPUTS-1];
+    logic [NUM_INPUTS-1:0]       x_d_grant;                         // Master takes a response this cycle
+    logic [NUM_OUTPUTS_LOG2-1:0] x_d_grant_slave [0:NUM_INPUTS-1];
+    logic [NUM_INPUTS-1:0]       x_d_done;                          // Master accepted its response
+    int                          x_done_count;                      // Responses accepted this cycle
+    int                          x_auto_count;                      // Of which auto responses
+    int                          x_m;
+    int                          x_s;
+
+    // Duplicate and unmapped requests
+    always_comb begin
+        for (int m = 0; m < NUM_INPUTS; m++) begin
+            x_a_cont[m]  = (x_a_burst[m] != 0);
+            x_tracked[m] = x_auto_pending[m];
+            for (int t = 0; t < TRACK_DEPTH; t++) begin
+                // Same master and source, or another master's request with the same source to
+                // the same slave, whose response could not be told apart
+                if (tracking_entry_valid[t] &&
+                    tracking_entry_source_id[t] == a_source[m*SID_WIDTH +: SID_WIDTH] &&
+                    (tracking_entry_master_idx[t] == m || tracking_entry_slave_idx[t] == master_slave_idx[m])) begin
+                    x_tracked[m] = 1'b1;
                 end
             end
+            x_unmapped[m] = a_valid[m] && ~a_ready[m] && ~x_tracked[m] && ~x_a_cont[m] && master_decode_valid[m] &&
+                            master_slave_idx[m][NUM_OUTPUTS_LOG2];
+        end
+    end
 
-            A_NEXT_MASTER: begin
-                `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_NEXT_MASTER/")); `endif
+    // A channel: per slave round-robin grant, then the lowest free tracking entry
+    always_comb begin
+        for (int t = 0; t < TRACK_DEPTH; t++) begin
+            x_a_taken[t] = tracking_entry_valid[t];
+        end
+        for (int s = 0; s < NUM_OUTPUTS; s++) begin
+            x_a_grant[s]  = 1'b0;
+            x_a_next[s]   = 1'b0;
+            x_a_master[s] = {NUM_INPUTS_LOG2{1'b0}};
+            x_a_entry[s]  = {TRACK_DEPTH_LOG2{1'b0}};
+            x_a_found     = 1'b0;
+            if (~s_a_valid[s] && x_s_lock[s]) begin
+                // Only the master sending a burst to this slave, no new tracking entry
+                x_m = x_s_lock_master[s];
+                if (a_valid[x_m] && ~a_ready[x_m]) begin
+                    x_a_grant[s]  = 1'b1;
+                    x_a_next[s]   = 1'b1;
+                    x_a_master[s] = x_m;
+                end
+            end else if (~s_a_valid[s]) begin
+                for (int k = 0; k < NUM_INPUTS; k++) begin
+                    x_m = (x_a_rr[s] + k) % NUM_INPUTS;
+                    if (~x_a_grant[s] && a_valid[x_m] && ~a_ready[x_m] && ~x_tracked[x_m] && ~x_a_cont[x_m] &&
+                        master_decode_valid[x_m] && master_slave_idx[x_m] == s) begin
+                        x_a_grant[s]  = 1'b1;
+                        x_a_master[s] = x_m;
+                    end
+                end
+            end
+            for (int t = 0; t < TRACK_DEPTH; t++) begin
+                if (~x_a_found && ~x_a_taken[t]) begin
+                    x_a_found    = 1'b1;
+                    x_a_entry[s] = t;
+                end
+            end
+            if (x_a_next[s]) begin
+                // Burst beats use the entry of the first beat
+            end else if (x_a_grant[s] && x_a_found) begin
+                x_a_taken[x_a_entry[s]] = 1'b1;
+            end else begin
+                x_a_grant[s] = 1'b0; // Nothing to forward, or the table is full
+            end
+        end
+    end
 
-                a_mts = TRACK_DEPTH; // No slot found
+    // D channel: match slave responses, then per master round-robin grant
+    always_comb begin
+        x_s_serving = {NUM_OUTPUTS{1'b0}};
+        for (int m = 0; m < NUM_INPUTS; m++) begin
+            if (x_d_busy[m] && ~x_d_auto[m]) x_s_serving[x_d_slave[m]] = 1'b1;
+        end
+        for (int s = 0; s < NUM_OUTPUTS; s++) begin
+            x_s_match[s] = 1'b0;
+            x_s_entry[s] = {TRACK_DEPTH_LOG2{1'b0}};
+            for (int t = 0; t < TRACK_DEPTH; t++) begin
+                if (~x_s_match[s] && s_d_valid[s] && ~s_d_ready[s] && ~x_s_serving[s] &&
+                    tracking_entry_valid[t] && tracking_entry_slave_idx[t] == s &&
+                    tracking_entry_source_id[t] == s_d_source[s*SID_WIDTH +: SID_WIDTH]) begin
+                    x_s_match[s] = 1'b1;
+                    x_s_entry[s] = t;
+                end
+            end
+        end
+        x_done_count = 0;
+        x_auto_count = 0;
+        for (int m = 0; m < NUM_INPUTS; m++) begin
+            x_d_done[m]        = x_d_busy[m] && d_ready[m];
+            x_done_count       = x_done_count + x_d_done[m];
+            x_auto_count       = x_auto_count + (x_d_done[m] && x_d_auto[m]);
+            x_d_grant[m]       = 1'b0;
+            x_d_grant_slave[m] = {NUM_OUTPUTS_LOG2{1'b0}};
+            if (~x_d_busy[m] && ~x_auto_pending[m]) begin
+                for (int k = 0; k < NUM_OUTPUTS; k++) begin
+                    x_s = (x_d_rr[m] + k) % NUM_OUTPUTS;
+                    // In the middle of a burst only the slave sending it
+                    if (~x_d_grant[m] && x_s_match[x_s] && tracking_entry_master_idx[x_s_entry[x_s]] == m &&
+                        (x_d_beat[m] == 0 || x_s == x_d_slave[m])) begin
+                        x_d_grant[m]       = 1'b1;
+                        x_d_grant_slave[m] = x_s;
+                    end
+                end
+            end
+        end
+    end
 
-                if (a_m_idx == NUM_INPUTS-1) begin
-                    a_m_idx <= {NUM_INPUTS_LOG2{1'b0}};
-                end else begin
-                    a_m_idx <= a_m_idx + 1'b1;
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            a_ready        <= {NUM_INPUTS{1'b0}};
+            s_a_valid      <= {NUM_OUTPUTS{1'b0}};
+            d_valid        <= {NUM_INPUTS{1'b0}};
+            s_d_ready      <= {NUM_OUTPUTS{1'b0}};
+            x_auto_pending <= {NUM_INPUTS{1'b0}};
+            x_d_busy       <= {NUM_INPUTS{1'b0}};
+            x_d_auto       <= {NUM_INPUTS{1'b0}};
+            x_a_drop       <= {NUM_INPUTS{1'b0}};
+            x_s_lock       <= {NUM_OUTPUTS{1'b0}};
+            for (int s = 0; s < NUM_OUTPUTS; s++) x_a_rr[s] <= {NUM_INPUTS_LOG2{1'b0}};
+            for (int m = 0; m < NUM_INPUTS; m++) begin
+                x_d_rr[m]       <= {NUM_OUTPUTS_LOG2{1'b0}};
+                x_d_beat[m]     <= 8'd0;
+                x_auto_beats[m] <= 8'd0;
+                x_a_burst[m]    <= 8'd0;
+            end
+            for (int t = 0; t < TRACK_DEPTH; t++) begin
+                tracking_entry_valid[t]     <= 1'b0;
+                tracking_entry_finished[t]  <= 1'b0;
+                tracking_entry_auto_resp[t] <= 1'b0;
+            end
+        end else begin
+            a_ready   <= {NUM_INPUTS{1'b0}};
+            s_d_ready <= {NUM_OUTPUTS{1'b0}};
+
+            // ======================
+            // A Channel
+            // ======================
+            for (int s = 0; s < NUM_OUTPUTS; s++) begin
+                if (s_a_valid[s] && s_a_ready[s]) begin
+                    s_a_valid[s] <= 1'b0;
                 end
 
-                a_fsm_state <= A_TRACKING_SCAN;
+                if (x_a_next[s]) begin
+                    // Next beat of a burst, the control fields of the first beat stay in place
+                    `ifdef LOG_SWITCH_A `LOG("tl_switch", ("/A_CROSSBAR/ burst beat master=%0d slave=%0d left=%0d", x_a_master[s], s, x_a_burst[x_a_master[s]])); `endif
+                    a_ready[x_a_master[s]]           <= 1'b1;
+                    x_a_burst[x_a_master[s]]         <= x_a_burst[x_a_master[s]] - 8'd1;
+                    if (x_a_burst[x_a_master[s]] == 8'd1) begin
+                        x_s_lock[s] <= 1'b0;
+                    end
+
+                    s_a_valid[s]                     <= 1'b1;
+                    s_a_mask[s*(XLEN/8) +: (XLEN/8)] <= a_mask[x_a_master[s]*(XLEN/8) +: (XLEN/8)];
+                    s_a_data[s*XLEN +: XLEN]         <= a_data[x_a_master[s]*XLEN +: XLEN];
+                end else if (x_a_grant[s]) begin
+                    `ifdef LOG_SWITCH_A `LOG("tl_switch", ("/A_CROSSBAR/ forwarding master=%0d slave=%0d tracking=%0d", x_a_master[s], s, x_a_entry[s])); `endif
+                    if (a_opcode[x_a_master[s]*3 +: 3] == GET_OPCODE) begin
+                        tracking_entry_beats[x_a_entry[s]] <= burst_beats(a_size[x_a_master[s]*3 +: 3]);
+                    end else begin
+                        tracking_entry_beats[x_a_entry[s]] <= 8'd0;
+                        if (burst_beats(a_size[x_a_master[s]*3 +: 3]) != 0) begin
+                            x_a_burst[x_a_master[s]] <= burst_beats(a_size[x_a_master[s]*3 +: 3]);
+                            x_a_drop[x_a_master[s]]  <= 1'b0;
+                            x_s_lock[s]              <= 1'b1;
+                            x_s_lock_master[s]       <= x_a_master[s];
+                        end
+                    end
+                    tracking_entry_master_idx[x_a_entry[s]] <= x_a_master[s];
+                    tracking_entry_slave_idx[x_a_entry[s]]  <= s;
+                    tracking_entry_source_id[x_a_entry[s]]  <= a_source[x_a_master[s]*SID_WIDTH +: SID_WIDTH];
+                    tracking_entry_valid[x_a_entry[s]]      <= 1'b1;
+                    a_ready[x_a_master[s]]                  <= 1'b1;
+                    x_a_rr[s]                               <= (x_a_master[s] == NUM_INPUTS-1) ? {NUM_INPUTS_LOG2{1'b0}} : x_a_master[s] + 1'b1;
+
+                    s_a_valid[s]                           <= 1'b1;
+                    s_a_opcode[s*3 +: 3]                   <= a_opcode[x_a_master[s]*3 +: 3];
+                    s_a_param[s*3 +: 3]                    <= a_param[x_a_master[s]*3 +: 3];
+                    s_a_size[s*3 +: 3]                     <= a_size[x_a_master[s]*3 +: 3];
+                    s_a_source[s*SID_WIDTH +: SID_WIDTH]   <= a_source[x_a_master[s]*SID_WIDTH +: SID_WIDTH];
+                    s_a_address[s*XLEN +: XLEN]            <= master_mapped_address[x_a_master[s]];
+                    s_a_mask[s*(XLEN/8) +: (XLEN/8)]       <= a_mask[x_a_master[s]*(XLEN/8) +: (XLEN/8)];
+                    s_a_data[s*XLEN +: XLEN]               <= a_data[x_a_master[s]*XLEN +: XLEN];
+                end
             end
 
-            A_TRACKING_SCAN: begin
-                `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_TRACKING_SCAN/ a_m_idx=%0d a_t_idx=%0d", a_m_idx, a_t_idx)); `endif
+            for (int m = 0; m < NUM_INPUTS; m++) begin
+                if (x_unmapped[m]) begin
+                    `ifdef LOG_SWITCH_A `LOG("tl_switch", ("/A_CROSSBAR/ auto-respond master=%0d", m)); `endif
+                    a_ready[m]        <= 1'b1;
+                    x_auto_pending[m] <= 1'b1;
+                    x_auto_source[m]  <= a_source[m*SID_WIDTH +: SID_WIDTH];
+                    if (a_opcode[m*3 +: 3] == GET_OPCODE) begin
+                        x_auto_beats[m] <= burst_beats(a_size[m*3 +: 3]);
+                    end else begin
+                        x_auto_beats[m] <= 8'd0;
+                        x_a_burst[m]    <= burst_beats(a_size[m*3 +: 3]);
+                        x_a_drop[m]     <= 1'b1;
+                    end
+                end else if (x_a_cont[m] && x_a_drop[m] && a_valid[m] && ~a_ready[m]) begin
+                    // Beats of a burst that is auto-responded
+                    a_ready[m]   <= 1'b1;
+                    x_a_burst[m] <= x_a_burst[m] - 8'd1;
+                end
+            end
 
-                if (tracking_entry_valid[a_t_idx] && tracking_entry_master_idx[a_t_idx] == a_m_idx &&
-                    tracking_entry_source_id[a_t_idx] == a_source[a_m_idx*SID_WIDTH +: SID_WIDTH])
-                begin
-                    a_mts <= a_t_idx;
+            // ======================
+            // D Channel
+            // ======================
+            for (int m = 0; m < NUM_INPUTS; m++) begin
+                if (x_d_done[m]) begin
+                    `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_CROSSBAR/ response to master %0d acknowledged", m)); `endif
+                    d_valid[m]  <= 1'b0;
+                    x_d_busy[m] <= 1'b0;
+                    if (x_d_auto[m]) begin
+                        // Auto responses to a burst Get repeat for every beat
+                        if (x_auto_beats[m] != 0) begin
+                            x_auto_beats[m] <= x_auto_beats[m] - 8'd1;
+                        end else begin
+                            x_auto_pending[m] <= 1'b0;
+                        end
+                    end else begin
+                        s_d_ready[x_d_slave[m]] <= 1'b1;
+                        if (x_d_beat[m] == tracking_entry_beats[x_d_entry[m]]) begin
+                            x_d_beat[m]                        <= 8'd0;
+                            tracking_entry_valid[x_d_entry[m]] <= 1'b0;
+                        end else begin
+                            x_d_beat[m] <= x_d_beat[m] + 8'd1;
+                        end
+                    end
+                end else if (~x_d_busy[m] && x_auto_pending[m]) begin
+                    `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_CROSSBAR/ auto response to master %0d", m)); `endif
+                    d_valid[m]                         <= 1'b1;
+                    d_opcode[m*3 +: 3]                 <= 3'b111;
+                    d_param[m*2 +: 2]                  <= 2'b00;
+                    d_size[m*3 +: 3]                   <= 3'b000;
+                    d_source[m*SID_WIDTH +: SID_WIDTH] <= x_auto_source[m];
+                    d_data[m*XLEN +: XLEN]             <= {XLEN{1'b0}};
+                    d_corrupt[m]                       <= 1'b0;
+                    d_denied[m]                        <= 1'b1;
+                    x_d_busy[m]                        <= 1'b1;
+                    x_d_auto[m]                        <= 1'b1;
+                end else if (x_d_grant[m]) begin
+                    `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_CROSSBAR/ response from slave %0d to master %0d", x_d_grant_slave[m], m)); `endif
+                    d_valid[m]                         <= 1'b1;
+                    d_opcode[m*3 +: 3]                 <= s_d_opcode[x_d_grant_slave[m]*3 +: 3];
+                    d_param[m*2 +: 2]                  <= s_d_param[x_d_grant_slave[m]*2 +: 2];
+                    d_size[m*3 +: 3]                   <= s_d_size[x_d_grant_slave[m]*3 +: 3];
+                    d_source[m*SID_WIDTH +: SID_WIDTH] <= s_d_source[x_d_grant_slave[m]*SID_WIDTH +: SID_WIDTH];
+                    d_data[m*XLEN +: XLEN]             <= s_d_data[x_d_grant_slave[m]*XLEN +: XLEN];
+                    d_corrupt[m]                       <= s_d_corrupt[x_d_grant_slave[m]];
+                    d_denied[m]                        <= s_d_denied[x_d_grant_slave[m]];
+                    x_d_busy[m]                        <= 1'b1;
+                    x_d_auto[m]                        <= 1'b0;
+                    x_d_slave[m]                       <= x_d_grant_slave[m];
+                    x_d_entry[m]                       <= x_s_entry[x_d_grant_slave[m]];
+                    x_d_rr[m]                          <= (x_d_grant_slave[m] == NUM_OUTPUTS-1) ? {NUM_OUTPUTS_LOG2{1'b0}} : x_d_grant_slave[m] + 1'b1;
+                end
+            end
+
+            stats_global_responces     <= stats_global_responces + x_done_count;
+            stats_global_autoresponces <= stats_global_autoresponces + x_auto_count;
+        end
+    end
+end else begin : g_serial
+    // A Channel Router
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            // Reset counters
+            a_m_idx <= {NUM_INPUTS_LOG2{1'b0}};
+            a_t_idx <= {TRACK_DEPTH_LOG2{1'b0}};
+            a_fsm_state <= A_RESET_TRACKING;
+            a_burst_left <= 8'd0;
+
+            // Reset channel acks
+            a_ready <= {NUM_INPUTS{1'b0}};
+            s_a_valid <= {NUM_OUTPUTS{1'b0}};
+        end else begin
+            case (a_fsm_state)
+                A_RESET_TRACKING: begin
+                    `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_RESET_TRACKING/ a_t_idx=%0d", a_t_idx)); `endif
+
+                    tracking_entry_master_idx[a_t_idx] <= {NUM_INPUTS_LOG2{1'b0}};
+                    tracking_entry_slave_idx[a_t_idx]  <= {NUM_OUTPUTS_LOG2+1{1'b0}};
+                    tracking_entry_source_id[a_t_idx]  <= {SID_WIDTH{1'b0}};
+                    tracking_entry_auto_resp[a_t_idx]  <= 1'b0;
+                    tracking_entry_valid[a_t_idx]      <= 1'b0;
+                    tracking_entry_beats[a_t_idx]      <= 8'd0;
+
+                    if (a_t_idx == TRACK_DEPTH-1) begin
+                        a_t_idx <= {TRACK_DEPTH_LOG2{1'b0}};
+                        a_fsm_state <= A_NEXT_MASTER;
+                    end else begin
+                        a_t_idx <= a_t_idx + 1'b1;
+                        a_fsm_state <= A_RESET_TRACKING;
+                    end
                 end
 
-                if (a_t_idx == TRACK_DEPTH-1) begin
-                    a_t_idx <= {TRACK_DEPTH_LOG2{1'b0}};
-                    a_fsm_state <= A_SLAVE_READY;
-                end else begin
-                    a_t_idx <= a_t_idx + 1'b1;
+                A_NEXT_MASTER: begin
+                    `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_NEXT_MASTER/")); `endif
+
+                    a_mts = TRACK_DEPTH; // No slot found
+
+                    if (a_m_idx == NUM_INPUTS-1) begin
+                        a_m_idx <= {NUM_INPUTS_LOG2{1'b0}};
+                    end else begin
+                        a_m_idx <= a_m_idx + 1'b1;
+                    end
+
                     a_fsm_state <= A_TRACKING_SCAN;
                 end
-            end
 
-            A_SLAVE_READY: begin
-                if (a_mts == TRACK_DEPTH && a_valid[a_m_idx] && ~a_ready[a_m_idx] && 
-                    ~tracking_entry_valid[a_t_idx] && ~tracking_entry_finished[a_t_idx]) 
-                begin
-                    // Auto-respond if slave_idx is invalid
-                    if (master_slave_idx[a_m_idx] == {(NUM_OUTPUTS_LOG2+1){1'b1}}) begin
-                        `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_SLAVE_READY/ auto-respond a_m_idx=%0d a_mts=%0d slave=%0d", a_m_idx, a_mts, master_slave_idx[a_m_idx])); `endif
-                        tracking_entry_master_idx[a_t_idx] <= a_m_idx;
-                        tracking_entry_slave_idx[a_t_idx]  <= master_slave_idx[a_m_idx];
-                        tracking_entry_source_id[a_t_idx]  <= a_source[a_m_idx*SID_WIDTH +: SID_WIDTH];
-                        tracking_entry_valid[a_t_idx]      <= 1'b1;
-                        a_ready[a_m_idx]                   <= 1'b1;
-
-                        a_mts       <= a_t_idx;
-                        a_fsm_state <= A_SLAVE_FINISH;
+                A_TRACKING_SCAN: begin
+                    `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_TRACKING_SCAN/ a_m_idx=%0d a_t_idx=%0d", a_m_idx, a_t_idx)); `endif
+
+                    if (tracking_entry_valid[a_t_idx] && tracking_entry_master_idx[a_t_idx] == a_m_idx &&
+                        tracking_entry_source_id[a_t_idx] == a_source[a_m_idx*SID_WIDTH +: SID_WIDTH])
+                    begin
+                        a_mts <= a_t_idx;
                     end
 
-                    // Otherwise forward to that slave if it is free
-                    else if (~s_a_valid[ master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0] ]) begin
-                        `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_SLAVE_READY/ forwarding request a_m_idx=%0d a_mts=%0d slave=%0d", a_m_idx, a_mts, master_slave_idx[a_m_idx])); `endif
-                        tracking_entry_master_idx[a_t_idx]  <= a_m_idx;
-                        tracking_entry_slave_idx[a_t_idx]   <= master_slave_idx[a_m_idx];
-                        tracking_entry_source_id[a_t_idx]   <= a_source[a_m_idx*SID_WIDTH +: SID_WIDTH];
-                        tracking_entry_valid[a_t_idx]       <= 1'b1;
-                        a_ready[a_m_idx]                    <= 1'b1;
-
-                        s_a_valid[master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0]]                           <= a_valid[a_m_idx];
-                        s_a_opcode[(master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0])*3 +: 3]                 <= a_opcode[a_m_idx*3 +: 3];
-                        s_a_param[(master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0])*2 +: 2]                  <= a_param[a_m_idx*2 +: 2];
-                        s_a_size[(master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0])*3 +: 3]                   <= a_size[a_m_idx*3 +: 3];
-                        s_a_source[(master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0])*SID_WIDTH +: SID_WIDTH] <= a_source[a_m_idx*SID_WIDTH +: SID_WIDTH];
-                        s_a_address[(master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0])*XLEN +: XLEN]          <= master_mapped_address[a_m_idx];
-                        s_a_mask[(master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0])*(XLEN/8) +: (XLEN/8)]     <= a_mask[a_m_idx*(XLEN/8) +: (XLEN/8)];
-                        s_a_data[(master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0])*XLEN +: XLEN]             <= a_data[a_m_idx*XLEN +: XLEN];
-
-                        a_mts       <= a_t_idx;
-                        a_fsm_state <= A_SLAVE_ACK;
+                    if (a_t_idx == TRACK_DEPTH-1) begin
+                        a_t_idx <= {TRACK_DEPTH_LOG2{1'b0}};
+                        a_fsm_state <= A_SLAVE_READY;
+                    end else begin
+                        a_t_idx <= a_t_idx + 1'b1;
+                        a_fsm_state <= A_TRACKING_SCAN;
                     end
+                end
 
-                    // Otherwise slave is still busy, move on
-                    else begin
-                        `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_SLAVE_READY/ busy a_m_idx=%0d a_mts=%0d slave=%0d", a_m_idx, a_mts, master_slave_idx[a_m_idx])); `endif
+                A_SLAVE_READY: begin
+                    if (a_mts == TRACK_DEPTH && a_valid[a_m_idx] && ~a_ready[a_m_idx] && master_decode_valid[a_m_idx] &&
+                        ~tracking_entry_valid[a_t_idx] && ~tracking_entry_finished[a_t_idx]) 
+                    begin
+                        // Auto-respond if slave_idx is invalid
+                        if (master_slave_idx[a_m_idx] == {(NUM_OUTPUTS_LOG2+1){1'b1}}) begin
+                            `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_SLAVE_READY/ auto-respond a_m_idx=%0d a_mts=%0d slave=%0d", a_m_idx, a_mts, master_slave_idx[a_m_idx])); `endif
+                            tracking_entry_master_idx[a_t_idx] <= a_m_idx;
+                            tracking_entry_slave_idx[a_t_idx]  <= master_slave_idx[a_m_idx];
+                            tracking_entry_source_id[a_t_idx]  <= a_source[a_m_idx*SID_WIDTH +: SID_WIDTH];
+                            tracking_entry_valid[a_t_idx]      <= 1'b1;
+                            a_ready[a_m_idx]                   <= 1'b1;
+
+                            if (a_opcode[a_m_idx*3 +: 3] == GET_OPCODE) begin
+                                tracking_entry_beats[a_t_idx] <= burst_beats(a_size[a_m_idx*3 +: 3]);
+                                a_burst_left                  <= 8'd0;
+                            end else begin
+                                tracking_entry_beats[a_t_idx] <= 8'd0;
+                                a_burst_left                  <= burst_beats(a_size[a_m_idx*3 +: 3]);
+                            end
+                            a_burst_drop <= 1'b1;
+
+                            a_mts       <= a_t_idx;
+                            a_fsm_state <= A_SLAVE_FINISH;
+                        end
+
+                        // Otherwise forward to that slave if it is free
+                        else if (~s_a_valid[ master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0] ]) begin
+                            `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_SLAVE_READY/ forwarding request a_m_idx=%0d a_mts=%0d slave=%0d", a_m_idx, a_mts, master_slave_idx[a_m_idx])); `endif
+                            tracking_entry_master_idx[a_t_idx]  <= a_m_idx;
+                            tracking_entry_slave_idx[a_t_idx]   <= master_slave_idx[a_m_idx];
+                            tracking_entry_source_id[a_t_idx]   <= a_source[a_m_idx*SID_WIDTH +: SID_WIDTH];
+                            tracking_entry_valid[a_t_idx]       <= 1'b1;
+                            a_ready[a_m_idx]                    <= 1'b1;
+
+                            if (a_opcode[a_m_idx*3 +: 3] == GET_OPCODE) begin
+                                tracking_entry_beats[a_t_idx] <= burst_beats(a_size[a_m_idx*3 +: 3]);
+                                a_burst_left                  <= 8'd0;
+                            end else begin
+                                tracking_entry_beats[a_t_idx] <= 8'd0;
+                                a_burst_left                  <= burst_beats(a_size[a_m_idx*3 +: 3]);
+                            end
+                            a_burst_drop  <= 1'b0;
+                            a_burst_slave <= master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0];
+
+                            s_a_valid[master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0]]                           <= a_valid[a_m_idx];
+                            s_a_opcode[(master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0])*3 +: 3]                 <= a_opcode[a_m_idx*3 +: 3];
+                            s_a_param[(master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0])*3 +: 3]                  <= a_param[a_m_idx*3 +: 3];
+                            s_a_size[(master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0])*3 +: 3]                   <= a_size[a_m_idx*3 +: 3];
+                            s_a_source[(master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0])*SID_WIDTH +: SID_WIDTH] <= a_source[a_m_idx*SID_WIDTH +: SID_WIDTH];
+                            s_a_address[(master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0])*XLEN +: XLEN]          <= master_mapped_address[a_m_idx];
+                            s_a_mask[(master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0])*(XLEN/8) +: (XLEN/8)]     <= a_mask[a_m_idx*(XLEN/8) +: (XLEN/8)];
+                            s_a_data[(master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0])*XLEN +: XLEN]             <= a_data[a_m_idx*XLEN +: XLEN];
+
+                            a_mts       <= a_t_idx;
+                            a_fsm_state <= A_SLAVE_ACK;
+                        end
+
+                        // Otherwise slave is still busy, move on
+                        else begin
+                            `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_SLAVE_READY/ busy a_m_idx=%0d a_mts=%0d slave=%0d", a_m_idx, a_mts, master_slave_idx[a_m_idx])); `endif
+                            a_fsm_state <= A_NEXT_TRACKING;
+                        end
+                    end else begin
+                        `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_SLAVE_READY/ auto-respond a_t_idx=%0d a_m_idx=%0d a_mts=%0d a_valid=%0d a_ready=%0d tracking_entry_valid=%0d tracking_entry_finished=%0d", a_t_idx, a_m_idx, a_mts, a_valid[a_m_idx], a_ready[a_m_idx], tracking_entry_valid[a_t_idx], tracking_entry_finished[a_t_idx])); `endif
                         a_fsm_state <= A_NEXT_TRACKING;
                     end
-                end else begin
-                    `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_SLAVE_READY/ auto-respond a_t_idx=%0d a_m_idx=%0d a_mts=%0d a_valid=%0d a_ready=%0d tracking_entry_valid=%0d tracking_entry_finished=%0d", a_t_idx, a_m_idx, a_mts, a_valid[a_m_idx], a_ready[a_m_idx], tracking_entry_valid[a_t_idx], tracking_entry_finished[a_t_idx])); `endif
-                    a_fsm_state <= A_NEXT_TRACKING;
                 end
-            end
 
-            A_SLAVE_ACK: begin
-                a_ready[a_m_idx] <= 1'b0;
-                if (s_a_valid[master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0]] &&
-                    s_a_ready[master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0]] ) 
-                begin
-                    `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_SLAVE_ACK/ a_m_idx=%0d a_mts=%0d slave=%0d", a_m_idx, a_mts, master_slave_idx[a_m_idx])); `endif
-                    s_a_valid[master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0]] <= 1'b0;
+                A_SLAVE_ACK: begin
+                    a_ready[a_m_idx] <= 1'b0;
+                    if (s_a_valid[master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0]] &&
+                        s_a_ready[master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0]] ) 
+                    begin
+                        `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_SLAVE_ACK/ a_m_idx=%0d a_mts=%0d slave=%0d", a_m_idx, a_mts, master_slave_idx[a_m_idx])); `endif
+                        s_a_valid[master_slave_idx[a_m_idx][NUM_OUTPUTS_LOG2-1:0]] <= 1'b0;
+                    end
+                    a_fsm_state <= (a_burst_left != 0) ? A_BURST : A_NEXT_TRACKING;
                 end
-                a_fsm_state <= A_NEXT_TRACKING;
-            end
-
-            A_SLAVE_FINISH: begin
-                `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_SLAVE_FINISH/ a_m_idx=%0d a_mts=%0d", a_m_idx, a_mts)); `endif
-                a_ready[a_m_idx] <= 1'b0; // Clear the request Ack
-                tracking_entry_auto_resp[a_t_idx] <= 1'b1;
-                a_fsm_state <= A_NEXT_TRACKING;
-            end
 
-            A_NEXT_TRACKING: begin
-                `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_NEXT_TRACKING/ a_m_idx=%0d a_mts=%0d", a_m_idx, a_mts)); `endif
+                A_BURST: begin
+                    // Stay with this master until the last beat of its burst has been forwarded,
+                    // the control fields of the first beat stay on the slave's A channel
+                    a_ready[a_m_idx] <= 1'b0;
+                    if (~a_burst_drop && s_a_valid[a_burst_slave]) begin
+                        if (s_a_ready[a_burst_slave]) begin
+                            s_a_valid[a_burst_slave] <= 1'b0;
+                        end
+                    end else if (a_burst_left == 0) begin
+                        `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_BURST/ done a_m_idx=%0d", a_m_idx)); `endif
+                        a_fsm_state <= A_NEXT_TRACKING;
+                    end else if (a_valid[a_m_idx] && ~a_ready[a_m_idx]) begin
+                        `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_BURST/ beat a_m_idx=%0d slave=%0d left=%0d drop=%0d", a_m_idx, a_burst_slave, a_burst_left, a_burst_drop)); `endif
+                        if (~a_burst_drop) begin
+                            s_a_valid[a_burst_slave]                     <= 1'b1;
+                            s_a_mask[a_burst_slave*(XLEN/8) +: (XLEN/8)] <= a_mask[a_m_idx*(XLEN/8) +: (XLEN/8)];
+                            s_a_data[a_burst_slave*XLEN +: XLEN]         <= a_data[a_m_idx*XLEN +: XLEN];
+                        end
+                        a_ready[a_m_idx] <= 1'b1;
+                        a_burst_left     <= a_burst_left - 8'd1;
+                    end
+                end
 
-                // Start resetting the tracker
-                if (tracking_entry_valid[a_t_idx] == 1'b1 && tracking_entry_finished[a_t_idx] == 1'b1) begin
-                    tracking_entry_valid[a_t_idx] <= 1'b0;
+                A_SLAVE_FINISH: begin
+                    `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_SLAVE_FINISH/ a_m_idx=%0d a_mts=%0d", a_m_idx, a_mts)); `endif
+                    a_ready[a_m_idx] <= 1'b0; // Clear the request Ack
+                    tracking_entry_auto_resp[a_t_idx] <= 1'b1;
+                    a_fsm_state <= (a_burst_left != 0) ? A_BURST : A_NEXT_TRACKING;
                 end
 
-                if (a_t_idx == TRACK_DEPTH-1) begin
-                    a_t_idx <= {TRACK_DEPTH_LOG2{1'b0}};
-                    a_fsm_state <= A_NEXT_MASTER;
-                end else begin
-                    a_t_idx <= a_t_idx + 1'b1;
-                    a_fsm_state <= A_SLAVE_READY;
+                A_NEXT_TRACKING: begin
+                    `ifdef LOG_SWITCH_A`LOG("tl_switch", ("/A_NEXT_TRACKING/ a_m_idx=%0d a_mts=%0d", a_m_idx, a_mts)); `endif
+
+                    // Start resetting the tracker
+                    if (tracking_entry_valid[a_t_idx] == 1'b1 && tracking_entry_finished[a_t_idx] == 1'b1) begin
+                        tracking_entry_valid[a_t_idx]     <= 1'b0;
+                        tracking_entry_auto_resp[a_t_idx] <= 1'b0;
+                    end
+
+                    if (a_t_idx == TRACK_DEPTH-1) begin
+                        a_t_idx <= {TRACK_DEPTH_LOG2{1'b0}};
+                        a_fsm_state <= A_NEXT_MASTER;
+                    end else begin
+                        a_t_idx <= a_t_idx + 1'b1;
+                        a_fsm_state <= A_SLAVE_READY;
+                    end
                 end
-            end
 
-            default: a_fsm_state <= A_RESET_TRACKING;
-        endcase
+                default: a_fsm_state <= A_RESET_TRACKING;
+            endcase
+        end
     end
-end
 
-// ======================
-// D Channel Router
-// ======================
+    // D Channel Router
+    initial begin
+        s_d_ready = {NUM_INPUTS{1'b0}};
+    end
 
-typedef enum logic [2:0] {
-    D_RESET_TRACKING   = 3'b000,
-    D_NEXT_SLAVE       = 3'b001,
-    D_TRACKING_SCAN    = 3'b010,
-    D_SLAVE_VALID      = 3'b011,
-    D_MASTER_ACK       = 3'b100,
-    D_AUTO_RESPOND     = 3'b101,
-    D_AUTO_RESPOND_ACK = 3'b110,
-    D_FINISH           = 3'b111
-} d_channel_fsm;
-d_channel_fsm d_fsm_state;
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            // Reset counters
+            d_s_idx <= {NUM_OUTPUTS_LOG2{1'b0}};
+            d_t_idx <= {TRACK_DEPTH_LOG2{1'b0}};
+            d_beat  <= 8'd0;
+            d_fsm_state <= D_RESET_TRACKING;
+        end else begin
+            case (d_fsm_state)
+                D_RESET_TRACKING: begin
+                    `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_RESET_TRACKING/ d_t_idx=%0d", d_t_idx)); `endif
 
-reg [NUM_OUTPUTS_LOG2-1:0] d_s_idx;  // A Channel Slace Index
-reg [TRACK_DEPTH_LOG2-1:0] d_t_idx;  // A Channel Tracking Index
-reg [TRACK_DEPTH_LOG2:0] d_sts;      // A Channel Slave's Tracking Slot
+                    tracking_entry_finished[d_t_idx] <= 1'b0;
 
-initial begin
-    s_d_ready = {NUM_INPUTS{1'b0}};
-end;
-
-always_ff @(posedge clk or posedge reset) begin
-    if (reset) begin
-        // Reset counters
-        d_s_idx <= {NUM_OUTPUTS_LOG2{1'b0}};
-        d_t_idx <= {TRACK_DEPTH_LOG2{1'b0}};
-        d_fsm_state <= D_RESET_TRACKING;
-    end else begin
-        case (d_fsm_state)
-            D_RESET_TRACKING: begin
-                `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_RESET_TRACKING/ d_t_idx=%0d", d_t_idx)); `endif
-
-                tracking_entry_finished[d_t_idx] <= 1'b0;
-
-                if (d_t_idx == TRACK_DEPTH-1) begin
-                    d_t_idx <= {TRACK_DEPTH_LOG2{1'b0}};
-                    d_fsm_state <= D_NEXT_SLAVE;
-                end else begin
-                    d_t_idx <= d_t_idx + 1'b1;
-                    d_fsm_state <= D_RESET_TRACKING;
+                    if (d_t_idx == TRACK_DEPTH-1) begin
+                        d_t_idx <= {TRACK_DEPTH_LOG2{1'b0}};
+                        d_fsm_state <= D_NEXT_SLAVE;
+                    end else begin
+                        d_t_idx <= d_t_idx + 1'b1;
+                        d_fsm_state <= D_RESET_TRACKING;
+                    end
                 end
-            end
 
-            D_NEXT_SLAVE: begin
-                `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_NEXT_SLAVE/ d_s_idx=%0d of %0d", d_s_idx, NUM_OUTPUTS-1)); `endif
+                D_NEXT_SLAVE: begin
+                    `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_NEXT_SLAVE/ d_s_idx=%0d of %0d", d_s_idx, NUM_OUTPUTS-1)); `endif
 
-                d_sts = TRACK_DEPTH; // No slot found
+                    d_sts = TRACK_DEPTH; // No slot found
 
-                if (d_s_idx == NUM_OUTPUTS-1) begin
-                    d_s_idx <= {NUM_OUTPUTS_LOG2{1'b0}};
-                end else begin
-                    d_s_idx <= d_s_idx + 1'b1;
+                    if (d_s_idx == NUM_OUTPUTS-1) begin
+                        d_s_idx <= {NUM_OUTPUTS_LOG2{1'b0}};
+                    end else begin
+                        d_s_idx <= d_s_idx + 1'b1;
+                    end
+
+                    d_fsm_state <= D_TRACKING_SCAN;
                 end
 
-                d_fsm_state <= D_TRACKING_SCAN;
-            end
+                D_TRACKING_SCAN: begin
+                    `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_TRACKING_SCAN/ d_s_idx=%0d d_t_idx=%0d", d_s_idx, d_t_idx)); `endif
 
-            D_TRACKING_SCAN: begin
-                `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_TRACKING_SCAN/ d_s_idx=%0d d_t_idx=%0d", d_s_idx, d_t_idx)); `endif
 
+                    // Finish resetting the tracker
+                    if (tracking_entry_valid[d_t_idx] == 1'b0 && tracking_entry_finished[d_t_idx] == 1'b1) begin
+                        `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_TRACKING_SCAN/ tracker reset d_t_idx=%0d", d_t_idx)); `endif
+                        tracking_entry_finished[d_t_idx] <= 1'b0;
+                    end
 
-                // Finish resetting the tracker
-                if (tracking_entry_valid[d_t_idx] == 1'b0 && tracking_entry_finished[d_t_idx] == 1'b1) begin
-                    `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_TRACKING_SCAN/ tracker reset d_t_idx=%0d", d_t_idx)); `endif
-                    tracking_entry_finished[d_t_idx] <= 1'b0;
-                end
+                    // Set start to auto respond
+                    else if (tracking_entry_auto_resp[d_t_idx] == 1'b1 && tracking_entry_valid[d_t_idx] &&
+                             tracking_entry_finished[d_t_idx] == 1'b0) begin
+                        d_sts <= d_t_idx;
+                        d_fsm_state <= D_AUTO_RESPOND;
+                    end
 
-                // Set start to auto respond
-                else if (tracking_entry_auto_resp[d_t_idx] == 1'b1) begin
-                    d_sts <= d_t_idx;
-                    d_fsm_state <= D_AUTO_RESPOND;
-                end
+                    // Check if this a valid tracker for the current slave
+                    else if (s_d_valid[d_s_idx] && tracking_entry_valid[d_t_idx] && tracking_entry_slave_idx[d_t_idx] == d_s_idx &&
+                        tracking_entry_source_id[d_t_idx] == s_d_source[d_s_idx*SID_WIDTH +: SID_WIDTH])
+                    begin
+                        d_sts <= d_t_idx;
+                        d_fsm_state <= D_SLAVE_VALID;
+                    end
 
-                // Check if this a valid tracker for the current slave
-                else if (s_d_valid[d_s_idx] && tracking_entry_valid[d_t_idx] && tracking_entry_slave_idx[d_t_idx] == d_s_idx &&
-                    tracking_entry_source_id[d_t_idx] == s_d_source[d_s_idx*SID_WIDTH +: SID_WIDTH])
-                begin
-                    d_sts <= d_t_idx;
-                    d_fsm_state <= D_SLAVE_VALID;
+                    // Move to the next tracker
+                    else if (d_t_idx == TRACK_DEPTH-1) begin
+                        d_t_idx <= {TRACK_DEPTH_LOG2{1'b0}};
+                        d_fsm_state <= D_NEXT_SLAVE;
+                    end else begin
+                        d_t_idx <= d_t_idx + 1'b1;
+                        d_fsm_state <= D_TRACKING_SCAN;
+                    end
                 end
 
-                // Move to the next tracker
-                else if (d_t_idx == TRACK_DEPTH-1) begin
-                    d_t_idx <= {TRACK_DEPTH_LOG2{1'b0}};
-                    d_fsm_state <= D_NEXT_SLAVE;
-                end else begin
-                    d_t_idx <= d_t_idx + 1'b1;
-                    d_fsm_state <= D_TRACKING_SCAN;
+                D_SLAVE_VALID: begin
+                    if (d_sts < TRACK_DEPTH && s_d_valid[d_s_idx]) begin
+                        `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_SLAVE_VALID/ Response from Slave %0d to Master %0d tracking at %0h. data=%0h", d_s_idx, tracking_entry_master_idx[d_sts], d_sts, s_d_data[d_s_idx*XLEN +: XLEN])); `endif
+                        d_valid[tracking_entry_master_idx[d_sts]]                          <= s_d_valid[d_s_idx];
+                        d_opcode[tracking_entry_master_idx[d_sts]*3 +: 3]                  <= s_d_opcode[d_s_idx*3 +: 3];
+                        d_param[tracking_entry_master_idx[d_sts]*2 +: 2]                   <= s_d_param[d_s_idx*2 +: 2];
+                        d_size[tracking_entry_master_idx[d_sts]*3 +:3]                     <= s_d_size[d_s_idx*3 +: 3];
+                        d_source[tracking_entry_master_idx[d_sts]*SID_WIDTH +: SID_WIDTH]  <= s_d_source[d_s_idx*SID_WIDTH +: SID_WIDTH];
+                        d_data[tracking_entry_master_idx[d_sts]*XLEN +: XLEN]              <= s_d_data[d_s_idx*XLEN +: XLEN];
+                        d_corrupt[tracking_entry_master_idx[d_sts]]                        <= s_d_corrupt[d_s_idx];
+                        d_denied[tracking_entry_master_idx[d_sts]]                         <= s_d_denied[d_s_idx];
+                        d_fsm_state <= D_MASTER_ACK;
+                    end else begin
+                        `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_SLAVE_VALID/ waiting d_s_idx=%0d d_sts=%0d", d_s_idx, d_sts)); `endif
+                        // In the middle of a burst wait for the next beat from this slave
+                        d_fsm_state <= (d_beat != 0) ? D_SLAVE_VALID : D_NEXT_SLAVE;
+                    end
                 end
-            end
 
-            D_SLAVE_VALID: begin
-                if (d_sts < TRACK_DEPTH && s_d_valid[d_s_idx]) begin
-                    `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_SLAVE_VALID/ Response from Slave %0d to Master %0d tracking at %0h. data=%0h", d_s_idx, tracking_entry_master_idx[d_sts], d_sts, s_d_data[d_s_idx*XLEN +: XLEN])); `endif
-                    d_valid[tracking_entry_master_idx[d_sts]]                          <= s_d_valid[d_s_idx];
-                    d_opcode[tracking_entry_master_idx[d_sts]*3 +: 3]                  <= s_d_opcode[d_s_idx*3 +: 3];
-                    d_param[tracking_entry_master_idx[d_sts]*2 +: 2]                   <= s_d_param[d_s_idx*2 +: 2];
-                    d_size[tracking_entry_master_idx[d_sts]*3 +:3]                     <= s_d_size[d_s_idx*3 +: 3];
-                    d_source[tracking_entry_master_idx[d_sts]*SID_WIDTH +: SID_WIDTH]  <= s_d_source[d_s_idx*SID_WIDTH +: SID_WIDTH];
-                    d_data[tracking_entry_master_idx[d_sts]*XLEN +: XLEN]              <= s_d_data[d_s_idx*XLEN +: XLEN];
-                    d_corrupt[tracking_entry_master_idx[d_sts]]                        <= s_d_corrupt[d_s_idx];
-                    d_denied[tracking_entry_master_idx[d_sts]]                         <= s_d_denied[d_s_idx];
-                    d_fsm_state <= D_MASTER_ACK;
-                end else begin
-                    `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_SLAVE_VALID/ waiting d_s_idx=%0d d_sts=%0d", d_s_idx, d_sts)); `endif
-                    d_fsm_state <= D_NEXT_SLAVE;
+                D_MASTER_ACK: begin
+                    if (d_ready[tracking_entry_master_idx[d_sts]]) begin
+                        `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_MASTER_ACK/ Response is acknowleged from Slave %0d to Master %0d tracking at %0h.", d_s_idx, tracking_entry_master_idx[d_sts], d_sts)); `endif
+                        // Ack the slave
+                        s_d_ready[d_s_idx] <= 1;
+                        d_fsm_state <= D_FINISH;
+                    end else begin
+                        `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_MASTER_ACK/ waiting d_s_idx=%0d d_sts=%0d", d_s_idx, d_sts)); `endif
+                    end
                 end
-            end
 
-            D_MASTER_ACK: begin
-                if (d_ready[tracking_entry_master_idx[d_sts]]) begin
-                    `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_MASTER_ACK/ Response is acknowleged from Slave %0d to Master %0d tracking at %0h.", d_s_idx, tracking_entry_master_idx[d_sts], d_sts)); `endif
-                    // Ack the slave
-                    s_d_ready[d_s_idx] <= 1;
-                    d_fsm_state <= D_FINISH;
-                end else begin
-                    `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_MASTER_ACK/ waiting d_s_idx=%0d d_sts=%0d", d_s_idx, d_sts)); `endif
+                D_AUTO_RESPOND: begin
+                    `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_AUTO_RESPOND/ Auto Response to Master %0d tracking at %0h.", tracking_entry_master_idx[d_sts], d_sts)); `endif
+                    d_valid[tracking_entry_master_idx[d_sts]]                         <= 1'b1;
+                    d_opcode[tracking_entry_master_idx[d_sts]*3 +: 3]                 <= 3'b111;
+                    d_param[tracking_entry_master_idx[d_sts]*2 +: 2]                  <= 3'b00;
+                    d_size[tracking_entry_master_idx[d_sts]*3 +: 3]                   <= 3'b000;
+                    d_source[tracking_entry_master_idx[d_sts]*SID_WIDTH +: SID_WIDTH] <= tracking_entry_source_id[d_sts];
+                    d_data[tracking_entry_master_idx[d_sts]*XLEN +: XLEN]             <= {XLEN{1'b0}};
+                    d_corrupt[tracking_entry_master_idx[d_sts]]                       <= 1'b0;
+                    d_denied[tracking_entry_master_idx[d_sts]]                        <= 1'b1;
+
+                    d_fsm_state <= D_AUTO_RESPOND_ACK;
                 end
-            end
 
-            D_AUTO_RESPOND: begin
-                `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_AUTO_RESPOND/ Auto Response to Master %0d tracking at %0h.", tracking_entry_master_idx[d_sts], d_sts)); `endif
-                d_valid[tracking_entry_master_idx[d_sts]]                         <= 1'b1;
-                d_opcode[tracking_entry_master_idx[d_sts]*3 +: 3]                 <= 3'b111;
-                d_param[tracking_entry_master_idx[d_sts]*2 +: 2]                  <= 3'b00;
-                d_size[tracking_entry_master_idx[d_sts]*3 +: 3]                   <= 3'b000;
-                d_source[tracking_entry_master_idx[d_sts]*SID_WIDTH +: SID_WIDTH] <= tracking_entry_source_id[d_sts];
-                d_data[tracking_entry_master_idx[d_sts]*XLEN +: XLEN]             <= {XLEN{1'b0}};
-                d_corrupt[tracking_entry_master_idx[d_sts]]                       <= 1'b0;
-                d_denied[tracking_entry_master_idx[d_sts]]                        <= 1'b1;
-
-                d_fsm_state <= D_AUTO_RESPOND_ACK;
-            end
+                D_AUTO_RESPOND_ACK: begin
+                    if (d_ready[tracking_entry_master_idx[d_sts]]) begin
+                        `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_AUTO_RESPOND_ACK/ Auto Response to Master %0d is acknowleged tracking at %0h.", tracking_entry_master_idx[d_sts], d_sts)); `endif
+                        stats_global_responces <= stats_global_responces + 1;
+                        stats_global_autoresponces <= stats_global_autoresponces + 1;
+                        d_fsm_state <= D_FINISH;
+                    end
+                end
 
-            D_AUTO_RESPOND_ACK: begin
-                if (d_ready[tracking_entry_master_idx[d_sts]]) begin
-                    `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_AUTO_RESPOND_ACK/ Auto Response to Master %0d is acknowleged tracking at %0h.", tracking_entry_master_idx[d_sts], d_sts)); `endif
+                D_FINISH: begin
+                    `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_FINISH/ d_s_idx=%0d", d_s_idx)); `endif
+                    // Cleanup, mark the tracking record as invalid so it can be reused
+                    // turn off the slave ack
+                    s_d_ready[d_s_idx]                        <= 0;
+                    d_valid[tracking_entry_master_idx[d_sts]] <= 0;
+
+                    if (d_beat != tracking_entry_beats[d_sts]) begin
+                        // More beats to come, keep the master's D channel on this entry
+                        d_beat      <= d_beat + 8'd1;
+                        d_fsm_state <= tracking_entry_auto_resp[d_sts] ? D_AUTO_RESPOND : D_SLAVE_VALID;
+                    end else begin
+                        d_beat                         <= 8'd0;
+                        tracking_entry_finished[d_sts] <= 1;
+                        d_fsm_state                    <= D_NEXT_SLAVE;
+                    end
                     stats_global_responces <= stats_global_responces + 1;
-                    stats_global_autoresponces <= stats_global_autoresponces + 1;
-                    d_fsm_state <= D_FINISH;
                 end
-            end
 
-            D_FINISH: begin
-                `ifdef LOG_SWITCH_D `LOG("tl_switch", ("/D_FINISH/ d_s_idx=%0d", d_s_idx)); `endif
-                // Cleanup, mark the tracking record as invalid so it can be reused
-                // turn off the slave ack
-                s_d_ready[d_s_idx]                        <= 0;
-                d_valid[tracking_entry_master_idx[d_sts]] <= 0;
-                tracking_entry_finished[d_sts]            <= 1;
-
-                d_fsm_state <= D_NEXT_SLAVE;
-                stats_global_responces <= stats_global_responces + 1;
-            end
-
-            default: d_fsm_state <= D_RESET_TRACKING;
-        endcase
+                default: d_fsm_state <= D_RESET_TRACKING;
+            endcase
+        end
     end
 end
+endgenerate
 
 endmodule
 
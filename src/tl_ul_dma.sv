@@ -0,0 +1,468 @@
+`ifndef __TL_UL_DMA__
+`define __TL_UL_DMA__
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// tl_ul_dma Module
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @module tl_ul_dma
+ * @brief TileLink-UL DMA Engine, a Register Slave and a Bus Master.
+ *
+ * @details
+ * The `tl_ul_dma` module copies `LENGTH` elements of 1, 2, 4 or (on a 64 bit bus) 8 bytes from
+ * `SRC` to `DST` on its own master port, so bulk copies run while the CPU does other work. Each
+ * element is a Get from the source followed by a PutFullData to the destination, sent through a
+ * `tl_interface`. The source and destination each either step by a stride or stay fixed, so a
+ * buffer can be streamed into or out of a FIFO register such as the `tl_ul_uart` data register.
+ *
+ * **Parameters:**
+ * - `XLEN` (default: 32): The width of the data bus.
+ * - `SID_WIDTH` (default: 2): The width of the source ID.
+ *
+ * **Register Map (byte offsets):**
+ * - `0x00` `SRC`: Address of the next element to read.
+ * - `0x04` `DST`: Address of the next element to write.
+ * - `0x08` `LENGTH`: Elements left to copy.
+ * - `0x0C` `STRIDE`: Bytes added to `SRC` (bits 15:0) and `DST` (bits 31:16) after each element,
+ *                    zero steps by the element size.
+ * - `0x10` `CONTROL`:
+ *   - Bit 0 `START`: Writing 1 starts a transfer, reads as busy. Writing 0 while busy stops the
+ *                    transfer after the element in flight.
+ *   - Bits 2:1 `SIZE`: log2 of the element size in bytes.
+ *   - Bit 3 `SRC_FIXED`: `SRC` does not move, e.g. to drain a receive FIFO.
+ *   - Bit 4 `DST_FIXED`: `DST` does not move, e.g. to fill a transmit FIFO.
+ *   - Bit 5 `IRQ_EN`: Raise `irq` while `DONE` or `ERROR` is set.
+ *   - Bit 6 `RETRY`: Repeat a denied access until it succeeds instead of stopping with `ERROR`,
+ *                    for slaves that deny writes while a FIFO is full.
+ * - `0x14` `STATUS`: Bit 0 `BUSY`, bit 1 `DONE`, bit 2 `ERROR`. Writing 1 to `DONE` or `ERROR`
+ *                    clears it.
+ *
+ * **Behavior:**
+ * - `SRC`, `DST` and `LENGTH` move as the transfer runs. After an error they point at the
+ *   element that failed.
+ * - A start with `SRC`, `DST` or a stride that is not a multiple of the element size, or an 8 byte
+ *   element on a 32 bit bus, sets `ERROR` without touching the bus. A start with `LENGTH` zero
+ *   sets `DONE` right away.
+ * - Registers are read and written as aligned 4 byte words. Anything else, a write to `0x18` and
+ *   above, or a write to `SRC`, `DST`, `LENGTH` or `STRIDE` while busy, is denied.
+ * - Each register request is answered one cycle after it is accepted and the module takes one
+ *   request at a time, also while a transfer is running.
+ */
+
+`timescale 1ns / 1ps
+`default_nettype none
+
+`include "log.sv"
+`include "tl_interface.sv"
+
+module tl_ul_dma #(
+    parameter int XLEN      = 32,
+    parameter int SID_WIDTH = 2
+) (
+    input  wire                         clk,
+    input  wire                         reset,
+
+    // Completion Interrupt
+    output reg                          irq,
+
+    // TileLink A Channel (Registers)
+    input  wire                         tl_a_valid,
+    output reg                          tl_a_ready,
+    input  wire [2:0]                   tl_a_opcode,
+    input  wire [2:0]                   tl_a_param,     // Included for TileLink, not used by module
+    input  wire [2:0]                   tl_a_size,
+    input  wire [SID_WIDTH-1:0]         tl_a_source,
+    input  wire [XLEN-1:0]              tl_a_address,
+    input  wire [XLEN/8-1:0]            tl_a_mask,      // Writes are whole words, not used
+    input  wire [XLEN-1:0]              tl_a_data,
+
+    // TileLink D Channel (Registers)
+    output reg                          tl_d_valid,
+    input  wire                         tl_d_ready,
+    output reg  [2:0]                   tl_d_opcode,
+    output reg  [1:0]                   tl_d_param,
+    output reg  [2:0]                   tl_d_size,
+    output reg  [SID_WIDTH-1:0]         tl_d_source,
+    output reg  [XLEN-1:0]              tl_d_data,
+    output reg                          tl_d_corrupt,
+    output reg                          tl_d_denied,
+
+    // TileLink A Channel (Master to Switch)
+    output wire                         m_a_valid,
+    input  wire                         m_a_ready,
+    output wire [2:0]                   m_a_opcode,
+    output wire [2:0]                   m_a_param,
+    output wire [2:0]                   m_a_size,
+    output wire [SID_WIDTH-1:0]         m_a_source,
+    output wire [XLEN-1:0]              m_a_address,
+    output wire [XLEN/8-1:0]            m_a_mask,
+    output wire [XLEN-1:0]              m_a_data,
+
+    // TileLink D Channel (Switch to Master)
+    input  wire                         m_d_valid,
+    output wire                         m_d_ready,
+    input  wire [2:0]                   m_d_opcode,
+    input  wire [1:0]                   m_d_param,
+    input  wire [2:0]                   m_d_size,
+    input  wire [SID_WIDTH-1:0]         m_d_source,
+    input  wire [XLEN-1:0]              m_d_data,
+    input  wire                         m_d_corrupt,
+    input  wire                         m_d_denied
+);
+
+initial begin
+    `ASSERT((XLEN == 32 || XLEN == 64), "XLEN must be 32 or 64.");
+end
+
+// Local parameters
+localparam [2:0] TL_ACCESS_ACK       = 3'b000;
+localparam [2:0] TL_ACCESS_ACK_DATA  = 3'b010;
+localparam [2:0] TL_ACCESS_ACK_ERROR = 3'b111;
+localparam [2:0] GET_OPCODE          = 3'b100;
+
+// ──────────────────────────
+// Registers
+// ──────────────────────────
+logic [31:0] src_reg;
+logic [31:0] dst_reg;
+logic [31:0] length_reg;
+logic [31:0] stride_reg;
+logic [1:0]  size_reg;
+logic        src_fixed;
+logic        dst_fixed;
+logic        irq_en;
+logic        retry_en;
+logic        busy;
+logic        done;
+logic        error;
+logic        stop;
+
+// Address steps after each element
+logic [31:0] elem_bytes;
+logic [31:0] src_step;
+logic [31:0] dst_step;
+
+assign elem_bytes = 32'd1 << size_reg;
+assign src_step   = src_fixed ? 32'd0 : (stride_reg[15:0]  != 16'd0) ? {16'd0, stride_reg[15:0]}  : elem_bytes;
+assign dst_step   = dst_fixed ? 32'd0 : (stride_reg[31:16] != 16'd0) ? {16'd0, stride_reg[31:16]} : elem_bytes;
+
+function automatic [31:0] dma_register(input [4:0] address);
+    case (address[4:2])
+        3'd0:    dma_register = src_reg;
+        3'd1:    dma_register = dst_reg;
+        3'd2:    dma_register = length_reg;
+        3'd3:    dma_register = stride_reg;
+        3'd4:    dma_register = {25'd0, retry_en, irq_en, dst_fixed, src_fixed, size_reg, busy};
+        3'd5:    dma_register = {29'd0, error, done, busy};
+        default: dma_register = 32'd0;
+    endcase
+endfunction
+
+// Byte lanes of an element at address
+function automatic [XLEN/8-1:0] lane_mask(input [1:0] size, input [XLEN-1:0] address);
+    lane_mask = ~({(XLEN/8){1'b1}} << (1 << size)) << (address & (XLEN/8 - 1));
+endfunction
+
+// ──────────────────────────
+// Bus Master
+// ──────────────────────────
+logic                   bus_ready;
+logic                   bus_wait;
+logic                   bus_read;
+logic [XLEN-1:0]        bus_address;
+logic [XLEN-1:0]        bus_wdata;
+logic [XLEN/8-1:0]      bus_wstrb;
+logic [2:0]             bus_size;
+logic                   bus_ack;
+logic [XLEN-1:0]        bus_rdata;
+logic                   bus_denied;
+logic                   bus_corrupt;
+logic                   bus_valid;
+
+logic [XLEN-1:0]        src_address;
+logic [XLEN-1:0]        dst_address;
+assign src_address = src_reg;
+assign dst_address = dst_reg;
+
+tl_interface #(
+    .XLEN           (XLEN),
+    .SID_WIDTH      (SID_WIDTH)
+) bus_interface (
+    .clk            (clk),
+    .reset          (reset),
+
+    .cpu_ready      (bus_ready),
+    .cpu_address    (bus_address),
+    .cpu_wdata      (bus_wdata),
+    .cpu_wstrb      (bus_wstrb),
+    .cpu_size       (bus_size),
+    .cpu_read       (bus_read),
+    .cpu_amo_opcode (3'b000),
+    .cpu_amo_param  (3'b000),
+    .cpu_ack        (bus_ack),
+    .cpu_rdata      (bus_rdata),
+    .cpu_denied     (bus_denied),
+    .cpu_corrupt    (bus_corrupt),
+    .cpu_valid      (bus_valid),
+
+    .tl_a_valid     (m_a_valid),
+    .tl_a_ready     (m_a_ready),
+    .tl_a_opcode    (m_a_opcode),
+    .tl_a_param     (m_a_param),
+    .tl_a_size      (m_a_size),
+    .tl_a_source    (m_a_source),
+    .tl_a_address   (m_a_address),
+    .tl_a_mask      (m_a_mask),
+    .tl_a_data      (m_a_data),
+
+    .tl_d_valid     (m_d_valid),
+    .tl_d_ready     (m_d_ready),
+    .tl_d_opcode    (m_d_opcode),
+    .tl_d_param     (m_d_param),
+    .tl_d_size      (m_d_size),
+    .tl_d_source    (m_d_source),
+    .tl_d_data      (m_d_data),
+    .tl_d_corrupt   (m_d_corrupt),
+    .tl_d_denied    (m_d_denied),
+
+    .test           ()
+);
+
+// States
+typedef enum logic [1:0] {
+    IDLE,
+    PROCESS,
+    RESPOND_WAIT
+} dma_state_t;
+dma_state_t state;
+
+typedef enum logic [1:0] {
+    COPY_IDLE,
+    COPY_READ,
+    COPY_WRITE
+} dma_copy_state_t;
+dma_copy_state_t copy_state;
+
+// Registers to hold request info
+reg [4:0]           req_address;
+reg [2:0]           req_size;
+reg                 req_read;
+reg [SID_WIDTH-1:0] req_source;
+reg [XLEN-1:0]      req_wdata;
+
+// Element being copied
+reg [XLEN-1:0]      copy_data;
+
+always @(posedge clk or posedge reset) begin
+    if (reset) begin
+        state        <= IDLE;
+        copy_state   <= COPY_IDLE;
+        src_reg      <= 32'd0;
+        dst_reg      <= 32'd0;
+        length_reg   <= 32'd0;
+        stride_reg   <= 32'd0;
+        size_reg     <= 2'd0;
+        src_fixed    <= 1'b0;
+        dst_fixed    <= 1'b0;
+        irq_en       <= 1'b0;
+        retry_en     <= 1'b0;
+        busy         <= 1'b0;
+        done         <= 1'b0;
+        error        <= 1'b0;
+        stop         <= 1'b0;
+        irq          <= 1'b0;
+        bus_ready    <= 1'b0;
+        bus_wait     <= 1'b0;
+        bus_read     <= 1'b0;
+        bus_address  <= {XLEN{1'b0}};
+        bus_wdata    <= {XLEN{1'b0}};
+        bus_wstrb    <= {(XLEN/8){1'b0}};
+        bus_size     <= 3'd0;
+        copy_data    <= {XLEN{1'b0}};
+        tl_a_ready   <= 1'b0;
+        tl_d_valid   <= 1'b0;
+        tl_d_opcode  <= 3'b000;
+        tl_d_param   <= 2'b00;
+        tl_d_size    <= 3'b000;
+        tl_d_source  <= {SID_WIDTH{1'b0}};
+        tl_d_data    <= {XLEN{1'b0}};
+        tl_d_corrupt <= 1'b0;
+        tl_d_denied  <= 1'b0;
+    end else begin
+        // Defaults, drop ready right after the handshake so a second request waits
+        tl_a_ready <= (state == IDLE) && ~(tl_a_valid && tl_a_ready);
+        irq        <= irq_en && (done || error);
+
+        // ──────────────────────────
+        // Register Access
+        // ──────────────────────────
+        case (state)
+            IDLE: begin
+                if (tl_a_valid && tl_a_ready) begin
+                    req_address <= tl_a_address[4:0];
+                    req_size    <= tl_a_size;
+                    req_read    <= (tl_a_opcode == GET_OPCODE);
+                    req_source  <= tl_a_source;
+                    req_wdata   <= tl_a_data;
+                    `ifdef LOG_MMIO `LOG("dma", ("/IDLE/ tl_a_address=%0h", tl_a_address)); `endif
+                    state <= PROCESS;
+                end
+            end
+
+            PROCESS: begin
+                logic        bad;
+                logic [31:0] wdata;
+                logic [31:0] align;
+                wdata = req_wdata[31:0];
+                bad   = (req_size != 3'd2) || (req_address[1:0] != 2'b00) ||
+                        (~req_read && (req_address[4:2] > 3'd5 ||
+                                       (busy && req_address[4:2] < 3'd4)));
+
+                tl_d_opcode  <= req_read ? TL_ACCESS_ACK_DATA : TL_ACCESS_ACK;
+                tl_d_param   <= 2'b00;
+                tl_d_size    <= req_size;
+                tl_d_source  <= req_source;
+                tl_d_corrupt <= 1'b0;
+                tl_d_data    <= {XLEN{1'b0}};
+                tl_d_denied  <= 1'b0;
+
+                if (bad) begin
+                    `ifdef LOG_MMIO `ERROR("dma", ("/PROCESS/ Bad access req_address=0x%0h req_size=%0d busy=%0d", req_address, req_size, busy)); `endif
+                    tl_d_opcode <= TL_ACCESS_ACK_ERROR;
+                    tl_d_param  <= 2'b10; // Error param
+                    tl_d_denied <= 1'b1;
+                end else if (req_read) begin
+                    tl_d_data <= dma_register(req_address);
+                end else begin
+                    case (req_address[4:2])
+                        3'd0: src_reg    <= wdata;
+                        3'd1: dst_reg    <= wdata;
+                        3'd2: length_reg <= wdata;
+                        3'd3: stride_reg <= wdata;
+                        3'd4: begin
+                            if (busy) begin
+                                // Only a stop is taken while a transfer runs
+                                if (~wdata[0]) stop <= 1'b1;
+                            end else begin
+                                size_reg  <= wdata[2:1];
+                                src_fixed <= wdata[3];
+                                dst_fixed <= wdata[4];
+                                irq_en    <= wdata[5];
+                                retry_en  <= wdata[6];
+
+                                align = (32'd1 << wdata[2:1]) - 32'd1;
+                                if (~wdata[0]) begin
+                                    // Only the options
+                                end else if ((wdata[2:1] == 2'd3 && XLEN == 32) ||
+                                    ((src_reg | dst_reg | stride_reg[15:0] | stride_reg[31:16]) & align) != 32'd0) begin
+                                    `ifdef LOG_MMIO `ERROR("dma", ("/PROCESS/ Misaligned transfer src=0x%0h dst=0x%0h stride=0x%0h", src_reg, dst_reg, stride_reg)); `endif
+                                    error <= 1'b1;
+                                end else if (length_reg == 32'd0) begin
+                                    done <= 1'b1;
+                                end else begin
+                                    `ifdef LOG_MMIO `LOG("dma", ("/PROCESS/ Start src=0x%0h dst=0x%0h length=%0d", src_reg, dst_reg, length_reg)); `endif
+                                    busy       <= 1'b1;
+                                    copy_state <= COPY_READ;
+                                end
+                            end
+                        end
+                        default: begin
+                            // STATUS, write 1 to clear
+                            if (wdata[1]) done  <= 1'b0;
+                            if (wdata[2]) error <= 1'b0;
+                        end
+                    endcase
+                end
+
+                tl_d_valid <= 1'b1;
+                state      <= RESPOND_WAIT;
+            end
+
+            RESPOND_WAIT: begin
+                if (tl_d_ready) begin
+                    tl_d_valid  <= 1'b0;
+                    tl_d_denied <= 1'b0;
+                    state       <= IDLE;
+                end
+            end
+
+            default: state <= IDLE;
+        endcase
+
+        // ──────────────────────────
+        // Copy
+        // ──────────────────────────
+        // One element is read into copy_data and then written, each access is requested from
+        // tl_interface and waited on before the next one
+        case (copy_state)
+            COPY_READ: begin
+                if (~bus_ready && ~bus_wait) begin
+                    bus_ready   <= 1'b1;
+                    bus_wait    <= 1'b1;
+                    bus_read    <= 1'b1;
+                    bus_address <= src_address;
+                    bus_size    <= {1'b0, size_reg};
+                    bus_wstrb   <= {(XLEN/8){1'b0}};
+                end else if (bus_ready && bus_ack) begin
+                    bus_ready <= 1'b0;
+                end else if (bus_wait && bus_valid) begin
+                    bus_wait <= 1'b0;
+                    if (bus_denied || bus_corrupt) begin
+                        if (~(retry_en && bus_denied) || stop) begin
+                            `ifdef LOG_MMIO `ERROR("dma", ("/COPY_READ/ Read failed src=0x%0h", src_reg)); `endif
+                            error      <= ~(retry_en && bus_denied);
+                            busy       <= 1'b0;
+                            stop       <= 1'b0;
+                            copy_state <= COPY_IDLE;
+                        end
+                    end else begin
+                        copy_data  <= bus_rdata;
+                        copy_state <= COPY_WRITE;
+                    end
+                end
+            end
+
+            COPY_WRITE: begin
+                if (~bus_ready && ~bus_wait) begin
+                    bus_ready   <= 1'b1;
+                    bus_wait    <= 1'b1;
+                    bus_read    <= 1'b0;
+                    bus_address <= dst_address;
+                    bus_size    <= {1'b0, size_reg};
+                    bus_wdata   <= copy_data;
+                    bus_wstrb   <= lane_mask(size_reg, dst_address);
+                end else if (bus_ready && bus_ack) begin
+                    bus_ready <= 1'b0;
+                end else if (bus_wait && bus_valid) begin
+                    bus_wait <= 1'b0;
+                    if (bus_denied || bus_corrupt) begin
+                        if (~(retry_en && bus_denied) || stop) begin
+                            `ifdef LOG_MMIO `ERROR("dma", ("/COPY_WRITE/ Write failed dst=0x%0h", dst_reg)); `endif
+                            error      <= ~(retry_en && bus_denied);
+                            busy       <= 1'b0;
+                            stop       <= 1'b0;
+                            copy_state <= COPY_IDLE;
+                        end
+                    end else begin
+                        src_reg    <= src_reg + src_step;
+                        dst_reg    <= dst_reg + dst_step;
+                        length_reg <= length_reg - 32'd1;
+                        if (length_reg == 32'd1 || stop) begin
+                            `ifdef LOG_MMIO `LOG("dma", ("/COPY_WRITE/ Finished length=%0d", length_reg - 32'd1)); `endif
+                            done       <= (length_reg == 32'd1);
+                            busy       <= 1'b0;
+                            stop       <= 1'b0;
+                            copy_state <= COPY_IDLE;
+                        end else begin
+                            copy_state <= COPY_READ;
+                        end
+                    end
+                end
+            end
+
+            default: ;
+        endcase
+    end
+end
+endmodule
+
+`endif // __TL_UL_DMA__
@@ -0,0 +1,242 @@
+`ifndef __TL_UL_PERF__
+`define __TL_UL_PERF__
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// tl_ul_perf Module
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @module tl_ul_perf
+ * @brief TileLink-UL Slave Exposing the tl_switch Performance Counters.
+ *
+ * @details
+ * The `tl_ul_perf` module makes the counters of a `tl_switch` built with `STATS` readable by
+ * software, so firmware can see where the bus time goes. Every register is 32 bits wide and read
+ * only, except `CONTROL`.
+ *
+ * **Parameters:**
+ * - `XLEN` (default: 32): The width of the data bus.
+ * - `SID_WIDTH` (default: 2): The width of the source ID.
+ * - `NUM_INPUTS` (default: 1): Masters on the switch, at most 16.
+ * - `NUM_OUTPUTS` (default: 1): Slaves on the switch, at most 16.
+ * - `TRACK_DEPTH` (default: 16): Tracking entries in the switch, reported in `CONTROL`.
+ *
+ * **Register Map (byte offsets):**
+ * - `0x000` `CONTROL`: Reads `{NUM_INPUTS[7:0], NUM_OUTPUTS[7:0], TRACK_DEPTH[15:0]}`. Writing bit
+ *                      0 set clears every counter in the switch.
+ * - `0x004` `TRACK_USED`: Tracking entries in use.
+ * - `0x008` `TRACK_MAX`: Most tracking entries ever in use.
+ * - `0x100 + 0x10 * m`: Master `m` `REQUESTS`, `+0x4` `LATENCY` (summed cycles), `+0x8`
+ *                       `MAX_LATENCY`.
+ * - `0x200 + 0x10 * s`: Slave `s` `REQUESTS`, `LATENCY` and `MAX_LATENCY`, laid out like the
+ *                       masters.
+ * - Anything else reads as zero.
+ *
+ * **Behavior:**
+ * - Reads of 1, 2 or 4 bytes return the addressed part of a register, LSB aligned. On a 64 bit
+ *   bus an aligned 8 byte read returns two neighbouring registers.
+ * - A write to anything but `CONTROL`, or a read or write that is not naturally aligned, is
+ *   denied.
+ * - Each request is answered one cycle after it is accepted and the module takes one request at
+ *   a time.
+ */
+
+`timescale 1ns / 1ps
+`default_nettype none
+
+`include "log.sv"
+
+module tl_ul_perf #(
+    parameter int XLEN        = 32,
+    parameter int SID_WIDTH   = 2,
+    parameter int NUM_INPUTS  = 1,
+    parameter int NUM_OUTPUTS = 1,
+    parameter int TRACK_DEPTH = 16
+) (
+    input  wire                         clk,
+    input  wire                         reset,
+
+    // Switch Counters
+    output reg                          stats_clear,
+    input  wire [NUM_INPUTS*32-1:0]     stats_m_requests,
+    input  wire [NUM_INPUTS*32-1:0]     stats_m_latency,
+    input  wire [NUM_INPUTS*32-1:0]     stats_m_max_latency,
+    input  wire [NUM_OUTPUTS*32-1:0]    stats_s_requests,
+    input  wire [NUM_OUTPUTS*32-1:0]    stats_s_latency,
+    input  wire [NUM_OUTPUTS*32-1:0]    stats_s_max_latency,
+    input  wire [31:0]                  stats_track_used,
+    input  wire [31:0]                  stats_track_max,
+
+    // TileLink A Channel
+    input  wire                         tl_a_valid,
+    output reg                          tl_a_ready,
+    input  wire [2:0]                   tl_a_opcode,
+    input  wire [2:0]                   tl_a_param,     // Included for TileLink, not used by module
+    input  wire [2:0]                   tl_a_size,
+    input  wire [SID_WIDTH-1:0]         tl_a_source,
+    input  wire [XLEN-1:0]              tl_a_address,
+    input  wire [XLEN/8-1:0]            tl_a_mask,      // Writes only need bit 0 of CONTROL
+    input  wire [XLEN-1:0]              tl_a_data,
+
+    // TileLink D Channel
+    output reg                          tl_d_valid,
+    input  wire                         tl_d_ready,
+    output reg  [2:0]                   tl_d_opcode,
+    output reg  [1:0]                   tl_d_param,
+    output reg  [2:0]                   tl_d_size,
+    output reg  [SID_WIDTH-1:0]         tl_d_source,
+    output reg  [XLEN-1:0]              tl_d_data,
+    output reg                          tl_d_corrupt,
+    output reg                          tl_d_denied
+);
+
+initial begin
+    `ASSERT((XLEN == 32 || XLEN == 64), "XLEN must be 32 or 64.");
+    `ASSERT((NUM_INPUTS >= 1 && NUM_INPUTS <= 16), "NUM_INPUTS must be 1 to 16.");
+    `ASSERT((NUM_OUTPUTS >= 1 && NUM_OUTPUTS <= 16), "NUM_OUTPUTS must be 1 to 16.");
+end
+
+// Local parameters
+localparam [2:0] TL_ACCESS_ACK       = 3'b000;
+localparam [2:0] TL_ACCESS_ACK_DATA  = 3'b010;
+localparam [2:0] TL_ACCESS_ACK_ERROR = 3'b111;
+localparam [2:0] GET_OPCODE          = 3'b100;
+
+// ──────────────────────────
+// Register Read
+// ──────────────────────────
+function automatic [31:0] perf_register(input [9:0] address);
+    logic [3:0] port;
+    port = address[7:4];
+    perf_register = 32'd0;
+    case (address[9:8])
+        2'b00: begin
+            case (address[7:2])
+                6'd0: perf_register = (NUM_INPUTS << 24) | (NUM_OUTPUTS << 16) | TRACK_DEPTH;
+                6'd1: perf_register = stats_track_used;
+                6'd2: perf_register = stats_track_max;
+                default: ;
+            endcase
+        end
+        2'b01: if (port < NUM_INPUTS) begin
+            case (address[3:2])
+                2'd0: perf_register = stats_m_requests[port*32 +: 32];
+                2'd1: perf_register = stats_m_latency[port*32 +: 32];
+                2'd2: perf_register = stats_m_max_latency[port*32 +: 32];
+                default: ;
+            endcase
+        end
+        2'b10: if (port < NUM_OUTPUTS) begin
+            case (address[3:2])
+                2'd0: perf_register = stats_s_requests[port*32 +: 32];
+                2'd1: perf_register = stats_s_latency[port*32 +: 32];
+                2'd2: perf_register = stats_s_max_latency[port*32 +: 32];
+                default: ;
+            endcase
+        end
+        default: ;
+    endcase
+endfunction
+
+// States
+typedef enum logic [1:0] {
+    IDLE,
+    PROCESS,
+    RESPOND_WAIT
+} perf_state_t;
+perf_state_t state;
+
+// Registers to hold request info
+reg [9:0]           req_address;
+reg [2:0]           req_size;
+reg                 req_read;
+reg [SID_WIDTH-1:0] req_source;
+reg [XLEN-1:0]      req_wdata;
+
+always @(posedge clk or posedge reset) begin
+    if (reset) begin
+        state        <= IDLE;
+        stats_clear  <= 1'b0;
+        tl_a_ready   <= 1'b0;
+        tl_d_valid   <= 1'b0;
+        tl_d_opcode  <= 3'b000;
+        tl_d_param   <= 2'b00;
+        tl_d_size    <= 3'b000;
+        tl_d_source  <= {SID_WIDTH{1'b0}};
+        tl_d_data    <= {XLEN{1'b0}};
+        tl_d_corrupt <= 1'b0;
+        tl_d_denied  <= 1'b0;
+    end else begin
+        // Defaults, drop ready right after the handshake so a second request waits
+        tl_a_ready  <= (state == IDLE) && ~(tl_a_valid && tl_a_ready);
+        stats_clear <= 1'b0;
+
+        case (state)
+            IDLE: begin
+                if (tl_a_valid && tl_a_ready) begin
+                    req_address <= tl_a_address[9:0];
+                    req_size    <= tl_a_size;
+                    req_read    <= (tl_a_opcode == GET_OPCODE);
+                    req_source  <= tl_a_source;
+                    req_wdata   <= tl_a_data;
+                    `ifdef LOG_MMIO `LOG("perf", ("/IDLE/ tl_a_address=%0h", tl_a_address)); `endif
+                    state <= PROCESS;
+                end
+            end
+
+            PROCESS: begin
+                logic aligned;
+                logic [63:0] value;
+                aligned = (req_size == 3'd0) ||
+                          (req_size == 3'd1 && req_address[0] == 1'b0) ||
+                          (req_size == 3'd2 && req_address[1:0] == 2'b00) ||
+                          (req_size == 3'd3 && XLEN == 64 && req_address[2:0] == 3'b000);
+                value = {perf_register(req_address + 10'd4), perf_register(req_address)};
+
+                tl_d_opcode  <= req_read ? TL_ACCESS_ACK_DATA : TL_ACCESS_ACK;
+                tl_d_param   <= 2'b00;
+                tl_d_size    <= req_size;
+                tl_d_source  <= req_source;
+                tl_d_corrupt <= 1'b0;
+                tl_d_data    <= {XLEN{1'b0}};
+                tl_d_denied  <= 1'b0;
+
+                if (~aligned) begin
+                    `ifdef LOG_MMIO `ERROR("perf", ("/PROCESS/ Misaligned req_address=0x%0h req_size=%0d", req_address, req_size)); `endif
+                    tl_d_opcode <= TL_ACCESS_ACK_ERROR;
+                    tl_d_param  <= 2'b10; // Error param
+                    tl_d_denied <= 1'b1;
+                end else if (req_read) begin
+                    case (req_size)
+                        3'd0:    tl_d_data <= value[8*req_address[1:0] +: 8];
+                        3'd1:    tl_d_data <= value[16*req_address[1] +: 16];
+                        3'd2:    tl_d_data <= value[31:0];
+                        default: tl_d_data <= value[XLEN-1:0];
+                    endcase
+                end else if (req_address[9:2] == 8'd0) begin
+                    // CONTROL
+                    stats_clear <= req_wdata[0];
+                end else begin
+                    `ifdef LOG_MMIO `ERROR("perf", ("/PROCESS/ Write to read only req_address=0x%0h", req_address)); `endif
+                    tl_d_opcode <= TL_ACCESS_ACK_ERROR;
+                    tl_d_param  <= 2'b10; // Error param
+                    tl_d_denied <= 1'b1;
+                end
+
+                tl_d_valid <= 1'b1;
+                state      <= RESPOND_WAIT;
+            end
+
+            RESPOND_WAIT: begin
+                if (tl_d_ready) begin
+                    tl_d_valid  <= 1'b0;
+                    tl_d_denied <= 1'b0;
+                    state       <= IDLE;
+                end
+            end
+
+            default: state <= IDLE;
+        endcase
+    end
+end
+endmodule
+
+`endif // __TL_UL_PERF__
@@ -0,0 +1,232 @@
+`ifndef __TL_UL_TIMER__
+`define __TL_UL_TIMER__
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// tl_ul_timer Module
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @module tl_ul_timer
+ * @brief TileLink-UL Slave with the RISC-V Machine Timer (`mtime` / `mtimecmp`).
+ *
+ * @details
+ * The `tl_ul_timer` module is a CLINT style machine timer. `mtime` counts up once every `DIVIDER`
+ * clock cycles and `irq` is high while `mtime >= mtimecmp`. `irq` is meant for the machine timer
+ * interrupt (`mip.MTIP`) of `cpu_csr`, so firmware can sleep with `wfi` until a deadline instead
+ * of counting `nop`s.
+ *
+ * **Parameters:**
+ * - `XLEN` (default: 32): The width of the data bus.
+ * - `SID_WIDTH` (default: 2): The width of the source ID.
+ * - `DIVIDER` (default: 1): Clock cycles per `mtime` tick, e.g. the clock in MHz for a 1 us tick.
+ *
+ * **Register Map (byte offsets):**
+ * - `0x0` `MTIME`: Low 32 bits of `mtime`, `0x4` the high 32 bits.
+ * - `0x8` `MTIMECMP`: Low 32 bits of `mtimecmp`, `0xC` the high 32 bits. Resets to all ones, so
+ *                     `irq` stays low until it is written.
+ * - Both registers are 64 bits wide and can be read and written.
+ *
+ * **Behavior:**
+ * - Reads of 1, 2 or 4 bytes return the addressed part of a register, LSB aligned. On a 64 bit
+ *   bus an aligned 8 byte access reads or writes a whole register.
+ * - Writes must be 4 bytes, or 8 bytes on a 64 bit bus, and naturally aligned, anything else is
+ *   denied. A write to `mtime` wins over the tick in the same cycle.
+ * - On a 32 bit bus, set `mtimecmp` high to all ones first, then write the low half and then the
+ *   real high half, so no false interrupt is seen between the two writes.
+ * - Each request is answered one cycle after it is accepted and the module takes one request at
+ *   a time.
+ */
+
+`timescale 1ns / 1ps
+`default_nettype none
+
+`include "log.sv"
+
+module tl_ul_timer #(
+    parameter int XLEN      = 32,
+    parameter int SID_WIDTH = 2,
+    parameter int DIVIDER   = 1
+) (
+    input  wire                         clk,
+    input  wire                         reset,
+
+    // Machine Timer Interrupt
+    output reg                          irq,
+
+    // TileLink A Channel
+    input  wire                         tl_a_valid,
+    output reg                          tl_a_ready,
+    input  wire [2:0]                   tl_a_opcode,
+    input  wire [2:0]                   tl_a_param,     // Included for TileLink, not used by module
+    input  wire [2:0]                   tl_a_size,
+    input  wire [SID_WIDTH-1:0]         tl_a_source,
+    input  wire [XLEN-1:0]              tl_a_address,
+    input  wire [XLEN/8-1:0]            tl_a_mask,      // Writes are whole words, not used
+    input  wire [XLEN-1:0]              tl_a_data,
+
+    // TileLink D Channel
+    output reg                          tl_d_valid,
+    input  wire                         tl_d_ready,
+    output reg  [2:0]                   tl_d_opcode,
+    output reg  [1:0]                   tl_d_param,
+    output reg  [2:0]                   tl_d_size,
+    output reg  [SID_WIDTH-1:0]         tl_d_source,
+    output reg  [XLEN-1:0]              tl_d_data,
+    output reg                          tl_d_corrupt,
+    output reg                          tl_d_denied
+);
+
+initial begin
+    `ASSERT((XLEN == 32 || XLEN == 64), "XLEN must be 32 or 64.");
+    `ASSERT((DIVIDER >= 1), "DIVIDER must be at least 1.");
+end
+
+// Local parameters
+localparam [2:0] TL_ACCESS_ACK       = 3'b000;
+localparam [2:0] TL_ACCESS_ACK_DATA  = 3'b010;
+localparam [2:0] TL_ACCESS_ACK_ERROR = 3'b111;
+localparam [2:0] GET_OPCODE          = 3'b100;
+localparam int   DIVIDER_WIDTH       = (DIVIDER > 1) ? $clog2(DIVIDER) : 1;
+
+// ──────────────────────────
+// Timer
+// ──────────────────────────
+logic [63:0]              mtime;
+logic [63:0]              mtimecmp;
+logic [DIVIDER_WIDTH-1:0] prescale;
+logic                     tick;
+
+assign tick = (DIVIDER == 1) || (prescale == DIVIDER - 1);
+
+// ──────────────────────────
+// Register Read
+// ──────────────────────────
+function automatic [31:0] timer_register(input [3:0] address);
+    case (address[3:2])
+        2'd0:    timer_register = mtime[31:0];
+        2'd1:    timer_register = mtime[63:32];
+        2'd2:    timer_register = mtimecmp[31:0];
+        default: timer_register = mtimecmp[63:32];
+    endcase
+endfunction
+
+// States
+typedef enum logic [1:0] {
+    IDLE,
+    PROCESS,
+    RESPOND_WAIT
+} timer_state_t;
+timer_state_t state;
+
+// Registers to hold request info
+reg [3:0]           req_address;
+reg [2:0]           req_size;
+reg                 req_read;
+reg [SID_WIDTH-1:0] req_source;
+reg [XLEN-1:0]      req_wdata;
+
+always @(posedge clk or posedge reset) begin
+    if (reset) begin
+        state        <= IDLE;
+        mtime        <= 64'd0;
+        mtimecmp     <= {64{1'b1}};
+        prescale     <= {DIVIDER_WIDTH{1'b0}};
+        irq          <= 1'b0;
+        tl_a_ready   <= 1'b0;
+        tl_d_valid   <= 1'b0;
+        tl_d_opcode  <= 3'b000;
+        tl_d_param   <= 2'b00;
+        tl_d_size    <= 3'b000;
+        tl_d_source  <= {SID_WIDTH{1'b0}};
+        tl_d_data    <= {XLEN{1'b0}};
+        tl_d_corrupt <= 1'b0;
+        tl_d_denied  <= 1'b0;
+    end else begin
+        // Defaults, drop ready right after the handshake so a second request waits
+        tl_a_ready <= (state == IDLE) && ~(tl_a_valid && tl_a_ready);
+        irq        <= (mtime >= mtimecmp);
+
+        // Count, a register write below wins
+        if (tick) begin
+            prescale <= {DIVIDER_WIDTH{1'b0}};
+            mtime    <= mtime + 64'd1;
+        end else begin
+            prescale <= prescale + 1'b1;
+        end
+
+        case (state)
+            IDLE: begin
+                if (tl_a_valid && tl_a_ready) begin
+                    req_address <= tl_a_address[3:0];
+                    req_size    <= tl_a_size;
+                    req_read    <= (tl_a_opcode == GET_OPCODE);
+                    req_source  <= tl_a_source;
+                    req_wdata   <= tl_a_data;
+                    `ifdef LOG_MMIO `LOG("timer", ("/IDLE/ tl_a_address=%0h", tl_a_address)); `endif
+                    state <= PROCESS;
+                end
+            end
+
+            PROCESS: begin
+                logic        aligned;
+                logic        write_ok;
+                logic [63:0] value;
+                logic [63:0] wdata;
+                aligned  = (req_size == 3'd0) ||
+                           (req_size == 3'd1 && req_address[0] == 1'b0) ||
+                           (req_size == 3'd2 && req_address[1:0] == 2'b00) ||
+                           (req_size == 3'd3 && XLEN == 64 && req_address[2:0] == 3'b000);
+                write_ok = (req_size == 3'd2 || req_size == 3'd3);
+                value    = {timer_register(req_address + 4'd4), timer_register(req_address)};
+                wdata    = 64'd0;
+                wdata[XLEN-1:0] = req_wdata;
+
+                tl_d_opcode  <= req_read ? TL_ACCESS_ACK_DATA : TL_ACCESS_ACK;
+                tl_d_param   <= 2'b00;
+                tl_d_size    <= req_size;
+                tl_d_source  <= req_source;
+                tl_d_corrupt <= 1'b0;
+                tl_d_data    <= {XLEN{1'b0}};
+                tl_d_denied  <= 1'b0;
+
+                if (~aligned || (~req_read && ~write_ok)) begin
+                    `ifdef LOG_MMIO `ERROR("timer", ("/PROCESS/ Bad access req_address=0x%0h req_size=%0d", req_address, req_size)); `endif
+                    tl_d_opcode <= TL_ACCESS_ACK_ERROR;
+                    tl_d_param  <= 2'b10; // Error param
+                    tl_d_denied <= 1'b1;
+                end else if (req_read) begin
+                    case (req_size)
+                        3'd0:    tl_d_data <= value[8*req_address[1:0] +: 8];
+                        3'd1:    tl_d_data <= value[16*req_address[1] +: 16];
+                        3'd2:    tl_d_data <= value[31:0];
+                        default: tl_d_data <= value[XLEN-1:0];
+                    endcase
+                end else if (req_size == 3'd3) begin
+                    if (req_address[3]) mtimecmp <= wdata;
+                    else                mtime    <= wdata;
+                end else begin
+                    case (req_address[3:2])
+                        2'd0:    mtime[31:0]     <= wdata[31:0];
+                        2'd1:    mtime[63:32]    <= wdata[31:0];
+                        2'd2:    mtimecmp[31:0]  <= wdata[31:0];
+                        default: mtimecmp[63:32] <= wdata[31:0];
+                    endcase
+                end
+
+                tl_d_valid <= 1'b1;
+                state      <= RESPOND_WAIT;
+            end
+
+            RESPOND_WAIT: begin
+                if (tl_d_ready) begin
+                    tl_d_valid  <= 1'b0;
+                    tl_d_denied <= 1'b0;
+                    state       <= IDLE;
+                end
+            end
+
+            default: state <= IDLE;
+        endcase
+    end
+end
+endmodule
+
+`endif // __TL_UL_TIMER__
@@ -5,19 +5,23 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /**
  * @module tl_ul_uart
- * @brief UART Interface with TileLink Uncached Lightweight (TL-UL) Support, 16-Byte FIFOs, and IRQ
+ * @brief UART Interface with TileLink Uncached Lightweight (TL-UL) Support, Sized FIFOs, and IRQ
  *        Handling
  *
  * The `tl_ul_uart` module implements a Universal Asynchronous Receiver/Transmitter (UART)
  * interfaced via the TileLink Uncached Lightweight (TL-UL) protocol. It features separate
- * 16-byte FIFOs for transmission (TX) and reception (RX), configurable baud rates, parity
- * settings, and interrupt request (IRQ) capabilities to notify the system of incoming data.
+ * `FIFO_DEPTH` byte FIFOs for transmission (TX) and reception (RX), configurable baud rates, parity
+ * settings, and interrupt request (IRQ) capabilities to notify the system of incoming data. A
+ * fractional baud divisor reaches the Mbaud rates and optional RTS/CTS flow control paces both
+ * directions without dropped bytes.
  *
  * **Parameters:**
  * - `XLEN` (integer, default: 32): Defines the data width for the TileLink interface.
  * - `SID_WIDTH` (integer, default: 2): Specifies the Source ID width for TileLink transactions.
  * - `CLK_FREQ_MHZ` (real, default: 100.0): Sets the system clock frequency in MHz, used for
  *   accurate baud rate generation.
+ * - `FIFO_DEPTH` (integer, default: 16): Depth in bytes of each of the TX and RX FIFOs, a power of
+ *   two from 2 to 256.
  *
  * **Ports:**
  * - **Clock and Reset:**
@@ -51,6 +55,10 @@
  *   - `rx` (input wire): UART receive line.
  *   - `tx` (output wire): UART transmit line.
  *   - `irq` (output wire): Interrupt Request signal, asserted when new data is received.
+ *   - `rts` (output wire): Request To Send, active low, high while flow control is on and the RX
+ *                          FIFO has room for one more byte only.
+ *   - `cts` (input wire): Clear To Send, active low, a new byte is only started while it is low
+ *                         when flow control is on.
  *
  * **Address Map:**
  * - `0x00`: **Status Register** (8 bits, Read/Write)
@@ -67,12 +75,18 @@
  *     - **Bit 3**: RX FIFO Full Status
  *       - `1`: Receive FIFO is full.
  *       - `0`: Receive FIFO is not full.
- *     - **Bit 4**: IRQ Status
- *       - `1`: IRQ is pending (new data received).
+ *     - **Bit 4**: RX Threshold IRQ Status
+ *       - `1`: IRQ is pending (the RX FIFO filled up to the RX threshold).
  *       - `0`: No IRQ pending.
- *     - **Bits 7:5**: Reserved (read as `0`).
+ *     - **Bit 5**: TX Threshold IRQ Status
+ *       - `1`: TX threshold IRQs are enabled and the TX FIFO holds the TX threshold or less.
+ *       - `0`: No IRQ pending.
+ *     - **Bit 6**: RX Timeout IRQ Status
+ *       - `1`: IRQ is pending (the RX FIFO holds data and the line was idle for 4 characters).
+ *       - `0`: No IRQ pending.
+ *     - **Bit 7**: Reserved (read as `0`).
  *   - **Write Operation:**
- *     - Ignores data sent, clears the IRQ bit in the Status Register.
+ *     - Ignores data sent, clears the RX threshold and RX timeout bits in the Status Register.
  *
  * - `0x04`: **Configuration Register** (8 bits, Read/Write)
  *   - **Bits [2:0]**: Baud Rate Settings
@@ -92,21 +106,47 @@
  *   - **Bit 5**: IRQ Enable
  *     - `1`: IRQ enabled (default)
  *     - `0`: IRQ disabled
- *   - **Bits 7:6**: Reserved (read as `0`).
+ *   - **Bit 6**: RTS/CTS Flow Control Enable
+ *     - `1`: `rts` follows the RX FIFO and `cts` gates transmission
+ *     - `0`: `rts` is held low and `cts` is ignored (default)
+ *   - **Bit 7**: Reserved (read as `0`).
  *
- * - `0x08`: **Data Register** (8 bits, Read/Write)
+ * - `0x08`: **Data Register** (8 bits up to XLEN bits, Read/Write)
+ *   - Accepts any power of two size up to `XLEN/8` bytes, moving one byte per cycle, the first
+ *     byte in the least significant lane.
  *   - **Write Operation:**
- *     - Accepts byte-sized (`8-bit`) writes only.
- *     - Writing a byte enqueues it into the Transmit FIFO for transmission.
- *     - If the Transmit FIFO is full, the write operation is denied, and an error response is
- *       generated.
- *     - Writes with byte masks other than single-byte writes are denied with an error response.
+ *     - Writing enqueues all of the bytes into the Transmit FIFO for transmission.
+ *     - If the Transmit FIFO has no room for all of the bytes, the write operation is denied, and an
+ *       error response is generated.
+ *     - Writes whose byte mask does not cover exactly the size are denied with an error response.
  *   - **Read Operation:**
- *     - Accepts byte-sized (`8-bit`) reads only.
- *     - **When RX FIFO is not empty:**
- *       - Reading retrieves a byte from the Receive FIFO.
+ *     - **When RX FIFO holds enough bytes:**
+ *       - Reading retrieves the bytes from the Receive FIFO.
  *     - **When RX FIFO is empty:**
- *       - Reading returns zero data without generating an error response.
+ *       - A byte read returns zero data without generating an error response.
+ *     - **When RX FIFO holds fewer bytes than a multi-byte read:**
+ *       - The read is denied with an error response and nothing is removed.
+ *
+ * - `0x0C`: **FIFO Configuration Register** (32 bits, Read/Write, word access only)
+ *   - **Bits [7:0]**: RX Threshold, the RX FIFO level that raises the RX threshold IRQ (default
+ *     `1`, `0` acts as `1`).
+ *   - **Bits [15:8]**: TX Threshold, the TX FIFO level at or below which the TX threshold IRQ is
+ *     raised (default `0`).
+ *   - **Bit 16**: TX Threshold IRQ Enable (default `0`).
+ *   - **Bit 17**: RX Timeout IRQ Enable (default `0`).
+ *   - **Bits 31:18**: Reserved (read as `0`).
+ *
+ * - `0x10`: **FIFO Level Register** (32 bits, Read only, word access only)
+ *   - **Bits [15:0]**: Number of bytes in the RX FIFO.
+ *   - **Bits [31:16]**: Number of bytes in the TX FIFO.
+ *
+ * - `0x14`: **Baud Divisor Register** (32 bits, Read/Write, word access only)
+ *   - **Bits [31:8]**: Whole clock cycles per bit, `0` selects the Configuration Register baud
+ *     rate (default `0`).
+ *   - **Bits [7:0]**: Fraction of a clock cycle per bit in 1/256ths, spread over the bits by
+ *     stretching some of them by one cycle.
+ *   - For example `CLK_FREQ_MHZ` 27.0 at 3 Mbaud is `0x0000_0900`, and at 2 Mbaud is
+ *     `0x0000_0D80`. Fewer than 2 cycles per bit is not supported.
  *
  * **Operational Overview:**
  * - **TileLink Interface Handling:**
@@ -136,12 +176,19 @@
  *
  * - **Interrupt Handling:**
  *   - **IRQ Assertion:**
- *     - The `irq` output is asserted when new data is received and enqueued into the Receive FIFO.
+ *     - The `irq` output is asserted when any of Status Register bits [6:4] is set:
+ *       - Bit [4] when a received byte brings the Receive FIFO up to the RX threshold.
+ *       - Bit [5] while TX threshold IRQs are enabled and the Transmit FIFO has drained to the TX
+ *         threshold.
+ *       - Bit [6] when RX timeout IRQs are enabled and the Receive FIFO holds bytes with no new
+ *         byte and no read for 40 bit times, so a short tail below the RX threshold is not stuck.
  *     - This occurs only if IRQs are enabled via the Configuration Register.
  *   - **IRQ Clearing:**
- *     - Writing to the **Status Register** (`0x00`) clears the IRQ status.
+ *     - Bit [4] clears once reads drop the Receive FIFO below the RX threshold, bit [6] once it is
+ *       empty and bit [5] once writes fill the Transmit FIFO past the TX threshold.
+ *     - Writing to the **Status Register** (`0x00`) clears the RX IRQ status.
  *       - **Write Operation:**
- *         - Ignores the data written but clears Bit [4] of the Status Register.
+ *         - Ignores the data written but clears Bits [4] and [6] of the Status Register.
  *       - **Effect:**
  *         - De-asserts the `irq` signal until new data is received.
  *
@@ -150,16 +197,19 @@
  *     selection among various standard baud rates.
  *   - The baud rate generator calculates the number of clock cycles per bit based on the system
  *     clock frequency (`CLK_FREQ_MHZ`) and the selected baud rate.
+ *   - Any other rate is set through the **Baud Divisor Register** (`0x14`) as a fixed point number
+ *     of clock cycles per bit, keeping the average bit time within 1/256 of a cycle.
+ *   - The receiver restarts its bit timer on each start bit and samples every bit in its middle.
  *
  * **FIFO Management:**
  * - **Transmit FIFO (TX FIFO):**
- *   - 16-byte deep FIFO for managing outgoing data.
+ *   - `FIFO_DEPTH` byte deep `fifo` for managing outgoing data.
  *   - Monitored via Status Register bits to indicate full or not full status.
  *   - Ensures smooth data transmission without data loss, provided the system handles FIFO full
  *     conditions appropriately.
  *
  * - **Receive FIFO (RX FIFO):**
- *   - 16-byte deep FIFO for managing incoming data.
+ *   - `FIFO_DEPTH` byte deep `fifo` for managing incoming data.
  *   - Monitored via Status Register bits to indicate empty or not empty status.
  *   - Ensures reliable data reception, provided the system reads data promptly to prevent FIFO
  *     overflows.
@@ -174,8 +224,8 @@
  * - **Write Errors:**
  *   - Attempting to write to the **Data Register** (`0x08`) when the Transmit FIFO is full results
  *     in an error response.
- *   - Writes with data sizes other than byte-sized writes to `0x08` or writes to unsupported
- *     addresses result in an error response.
+ *   - Writes with data sizes larger than `XLEN/8` bytes to `0x08`, writes to `0x10` or writes to
+ *     unsupported addresses result in an error response.
  *
  * **Usage Guidelines:**
  * - **Initialization:**
@@ -189,26 +239,34 @@
  *     - Read from `0x04` to obtain the current Configuration Register.
  *     - Read from `0x08` to retrieve received data from the Receive FIFO. If the RX FIFO is empty,
  *       zero data is returned without an error.
+ *     - Read from `0x10` to see how many bytes each FIFO holds.
+ *     - Read from `0x14` to obtain the current Baud Divisor Register.
  *   - **Write Operations:**
  *     - Write to `0x04` to configure baud rate, parity, and IRQ settings.
  *     - Write to `0x08` to send data via the UART.
- *     - Write to `0x00` to clear the IRQ status by ignoring the written data and resetting Bit [4].
+ *     - Write to `0x00` to clear the IRQ status by ignoring the written data and resetting Bits [4]
+ *       and [6].
+ *     - Write to `0x0C` to set the FIFO thresholds and the TX threshold and RX timeout IRQs.
+ *     - Write to `0x14` to set a baud rate outside of the Configuration Register table.
  *
  * - **Data Transmission and Reception:**
  *   - **Sending Data:**
- *     - Write byte-sized data to the **Data Register** (`0x08`). The data is enqueued into the
- *       Transmit FIFO and sent serially over the `tx` line.
+ *     - Write up to `XLEN/8` bytes to the **Data Register** (`0x08`). The data is enqueued into
+ *       the Transmit FIFO and sent serially over the `tx` line.
  *     - Monitor the Status Register to ensure the Transmit FIFO is not full before writing.
  *   - **Receiving Data:**
  *     - Data received on the `rx` line is enqueued into the Receive FIFO.
  *     - An IRQ is asserted if enabled, signaling that data is available.
- *     - Read byte-sized data from the **Data Register** (`0x08`) to retrieve received bytes.
+ *     - Read from the **Data Register** (`0x08`) to retrieve received bytes, a whole word at a
+ *       time once the RX threshold IRQ reports enough of them.
  *     - If the Receive FIFO is empty, reading from `0x08` returns zero data without an error.
  *
  * **Notes:**
  * - **Flow Control:**
- *   - The module does not implement hardware flow control (e.g., RTS/CTS). Ensure that the system
- *     manages FIFO statuses to prevent data loss.
+ *   - With Configuration Register bit 6 set, `rts` is raised while one more byte would fill the
+ *     RX FIFO, leaving room for a byte the far end has already started. A byte from the TX FIFO is
+ *     only started while `cts` is low; a byte in flight is always finished. Without it, ensure
+ *     that the system manages FIFO statuses to prevent data loss.
  * - **Parity and Error Checking:**
  *   - Parity settings are configurable via the Configuration Register. Ensure parity is correctly
  *     configured to match the communicating device.
@@ -219,12 +277,11 @@
  *   - Properly handle IRQs by clearing the IRQ status after servicing the interrupt to ensure
  *     subsequent interrupts are correctly generated.
  * - **Extensibility:**
- *   - The module can be extended to support additional features such as flow control, multiple
- *     parity options, or larger FIFOs based on system requirements.
+ *   - The module can be extended to support additional features such as software flow control
+ *     or multiple parity options based on system requirements.
  *
  * **TODO:**
  * - Implement Parity bits.
- * - Move to an external FIFO module.
  * - Add a config option and logic to support XON/XOFF software flow control.
  * - Add a config option and logic to support echoing.
  *
@@ -234,11 +291,13 @@
 `default_nettype none
     
 `include "log.sv"
+`include "fifo.sv"
 
 module tl_ul_uart #(
     parameter int XLEN = 32,
     parameter int SID_WIDTH = 2,
-    parameter real CLK_FREQ_MHZ = 100.0 // System clock frequency in MHz
+    parameter real CLK_FREQ_MHZ = 100.0, // System clock frequency in MHz
+    parameter int FIFO_DEPTH = 16        // Bytes in each of the TX and RX FIFOs
 ) (
     input  wire                 clk,
     input  wire                 reset,
@@ -267,8 +326,10 @@ module tl_ul_uart #(
 
     // UART Interface
     input  wire                 rx, // UART Receive line
-    output wire                 tx, // UART Transmit line
-    output wire                 irq // IRQ output
+    output wire                 tx,  // UART Transmit line
+    output wire                 irq, // IRQ output
+    output wire                 rts, // Request To Send, active low
+    input  wire                 cts  // Clear To Send, active low
 );
 
 // Local Parameters for TileLink Opcodes
@@ -285,11 +346,25 @@ localparam [2:0] GET_OPCODE           = 3'b100;
 localparam STATUS_ADDRESS = 32'h00;
 localparam CONFIG_ADDRESS = 32'h04;
 localparam DATA_ADDRESS   = 32'h08;
+localparam FIFO_CONFIG_ADDRESS = 32'h0C;
+localparam FIFO_LEVEL_ADDRESS  = 32'h10;
+localparam BAUD_DIVISOR_ADDRESS = 32'h14;
+
+// Largest DATA access, one XLEN word
+localparam int BEAT_SIZE = $clog2(XLEN/8);
+
+// Idle bit times before the RX timeout IRQ, 4 characters of 10 bits
+localparam int RX_TIMEOUT_BITS = 40;
+
+initial begin
+    `ASSERT((FIFO_DEPTH <= 256), "FIFO_DEPTH must be 256 or less.");
+end
 
 // State Definitions
-typedef enum logic [1:0] {
+typedef enum logic [2:0] {
     IDLE,
     PROCESS,
+    MOVE,
     RESPOND,
     RESPOND_WAIT
 } state_t;
@@ -303,6 +378,10 @@ reg [SID_WIDTH-1:0] req_source;
 reg [XLEN/8-1:0]    req_wstrb;
 reg [XLEN-1:0]      req_wdata;
 
+// Byte of a DATA access moved to or from a FIFO by the MOVE state
+reg [3:0]           move_index;
+reg [3:0]           move_last;
+
 // Registers to hold computed response data before asserting tl_d_valid
 reg [XLEN-1:0]      resp_data;
 reg [2:0]           resp_opcode;
@@ -312,28 +391,58 @@ reg [SID_WIDTH-1:0] resp_source;
 reg                 resp_denied;
 reg                 resp_corrupt;
 
-// FIFO Parameters
-localparam FIFO_DEPTH = 16;
-localparam FIFO_ADDR_WIDTH = 4; // 16 entries
-
 // Transmit FIFO
-reg [7:0] tx_fifo [0:FIFO_DEPTH-1];
-reg [FIFO_ADDR_WIDTH:0] tx_fifo_wr_ptr;
-reg [FIFO_ADDR_WIDTH:0] tx_fifo_rd_ptr;
-wire tx_fifo_full;
-wire tx_fifo_empty;
-
-assign tx_fifo_full = (tx_fifo_wr_ptr[FIFO_ADDR_WIDTH-1:0] == tx_fifo_rd_ptr[FIFO_ADDR_WIDTH-1:0]) && 
-                      (tx_fifo_wr_ptr[FIFO_ADDR_WIDTH] != tx_fifo_rd_ptr[FIFO_ADDR_WIDTH]);
-assign tx_fifo_empty = (tx_fifo_wr_ptr == tx_fifo_rd_ptr);
+wire [7:0]                    tx_fifo_head;
+wire [7:0]                    tx_fifo_wdata;
+wire                          tx_fifo_push;
+wire                          tx_fifo_pop;
+wire                          tx_fifo_full;
+wire                          tx_fifo_empty;
+wire [$clog2(FIFO_DEPTH):0]   tx_fifo_count;
+
+fifo #(
+    .WIDTH(8),
+    .DEPTH(FIFO_DEPTH)
+) tx_fifo (
+    .clk        (clk),
+    .reset      (reset),
+    .write_en   (tx_fifo_push),
+    .write_data (tx_fifo_wdata),
+    .read_en    (tx_fifo_pop),
+    .read_data  (tx_fifo_head),
+    .empty      (tx_fifo_empty),
+    .full       (tx_fifo_full),
+    .count      (tx_fifo_count)
+);
 
 // Receive FIFO
-reg [7:0] rx_fifo [0:FIFO_DEPTH-1];
-reg [FIFO_ADDR_WIDTH:0] rx_fifo_wr_ptr;
-reg [FIFO_ADDR_WIDTH:0] rx_fifo_rd_ptr;
-wire rx_fifo_full = (rx_fifo_wr_ptr[FIFO_ADDR_WIDTH-1:0] == rx_fifo_rd_ptr[FIFO_ADDR_WIDTH-1:0]) && 
-                    (rx_fifo_wr_ptr[FIFO_ADDR_WIDTH] != rx_fifo_rd_ptr[FIFO_ADDR_WIDTH]);
-wire rx_fifo_empty = (rx_fifo_wr_ptr == rx_fifo_rd_ptr);
+wire [7:0]                    rx_fifo_head;
+wire [7:0]                    rx_fifo_wdata;
+wire                          rx_fifo_push;
+wire                          rx_fifo_pop;
+wire                          rx_fifo_full;
+wire                          rx_fifo_empty;
+wire [$clog2(FIFO_DEPTH):0]   rx_fifo_count;
+
+fifo #(
+    .WIDTH(8),
+    .DEPTH(FIFO_DEPTH)
+) rx_fifo (
+    .clk        (clk),
+    .reset      (reset),
+    .write_en   (rx_fifo_push),
+    .write_data (rx_fifo_wdata),
+    .read_en    (rx_fifo_pop),
+    .read_data  (rx_fifo_head),
+    .empty      (rx_fifo_empty),
+    .full       (rx_fifo_full),
+    .count      (rx_fifo_count)
+);
+
+// The TileLink side moves one byte per cycle in the MOVE state
+assign tx_fifo_push  = (state == MOVE) && !req_read;
+assign tx_fifo_wdata = req_wdata[move_index*8 +: 8];
+assign rx_fifo_pop   = (state == MOVE) && req_read;
 
 // Status Register Bits
 // [0] - TX FIFO Empty Status
@@ -348,10 +457,16 @@ wire rx_fifo_empty = (rx_fifo_wr_ptr == rx_fifo_rd_ptr);
 // [3] - RX FIFO Full Status
 //       - 1: RX FIFO is Full
 //       - 0: RX FIFO is Not Full
-// [4] - IRQ Status
-//       - 1: IRQ Pending (new data received)
+// [4] - RX Threshold IRQ Status
+//       - 1: IRQ Pending (RX FIFO reached the RX threshold)
+//       - 0: No IRQ
+// [5] - TX Threshold IRQ Status
+//       - 1: IRQ Pending (TX FIFO at or below the TX threshold)
 //       - 0: No IRQ
-// [7:5] - Reserved
+// [6] - RX Timeout IRQ Status
+//       - 1: IRQ Pending (RX FIFO not empty and RX idle for RX_TIMEOUT_BITS)
+//       - 0: No IRQ
+// [7] - Reserved
 reg [7:0] status_reg;
 
 // Config Register Bits
@@ -372,11 +487,49 @@ reg [7:0] status_reg;
 // [5]   - IRQ Enabled
 //       - 0: IRQ Disabled
 //       - 1: IRQ Enabled (default)
-// [7:6] - Reserved
+// [6]   - RTS/CTS Flow Control Enabled
+//       - 0: Flow Control Disabled (default)
+//       - 1: Flow Control Enabled
+// [7]   - Reserved
 reg [7:0] config_reg;
 
+// FIFO Config Register Bits
+// [7:0]   - RX Threshold, 0 acts as 1 (default 1)
+// [15:8]  - TX Threshold (default 0)
+// [16]    - TX Threshold IRQ Enabled (default 0)
+// [17]    - RX Timeout IRQ Enabled (default 0)
+reg [17:0] fifo_config_reg;
+
+wire [7:0]  rx_threshold = (fifo_config_reg[7:0] == 8'd0) ? 8'd1 : fifo_config_reg[7:0];
+wire [7:0]  tx_threshold = fifo_config_reg[15:8];
+
+// FIFO Level Register
+wire [15:0] rx_level = rx_fifo_count;
+wire [15:0] tx_level = tx_fifo_count;
+
+// Baud Divisor Register Bits
+// [31:8] - Clock cycles per bit, 0 uses config_reg[2:0] (default 0)
+// [7:0]  - Fraction of a clock cycle per bit, in 1/256ths
+reg [31:0] baud_divisor_reg;
+
+// Bit times the RX line has been idle with bytes waiting in the RX FIFO
+reg [5:0] rx_idle_bits;
+
+// Flow Control, cts is synchronized since it comes from off chip
+reg [1:0] cts_sync;
+wire      tx_clear_to_send = !config_reg[6] || !cts_sync[1];
+assign    rts = config_reg[6] && (rx_fifo_count >= FIFO_DEPTH - 1);
+
+always @(posedge clk or posedge reset) begin
+    if (reset) begin
+        cts_sync <= 2'b11;
+    end else begin
+        cts_sync <= { cts_sync[0], cts };
+    end
+end
+
 // IRQ Handling
-assign irq = config_reg[5] & status_reg[4]; // Drive the IRQ line directly from the status register
+assign irq = config_reg[5] & (|status_reg[6:4]); // Drive the IRQ line directly from the status register
 
 // Utility function for WSTRB
 function integer count_wstrb_bits;
@@ -402,13 +555,19 @@ localparam integer CYCLES_1200   = (CLK_FREQ_MHZ * 1000000) / 1200;    // ≈ 34
 localparam integer CYCLES_300    = (CLK_FREQ_MHZ * 1000000) / 300;     // ≈ 10416 for 100MHz
 
 // Register to hold current cycles per bit based on baud rate
-reg [18:0] cycles_per_bit_reg; // baud reate cycle ounter
+reg [23:0] cycles_per_bit_reg; // whole clock cycles per bit
+reg [7:0]  baud_frac_reg;      // 1/256ths of a clock cycle per bit
 
-// Update cycles_per_bit_reg based on config_reg[2:0]
+// Update cycles_per_bit_reg based on baud_divisor_reg, or config_reg[2:0] when it is 0
 always @(posedge clk or posedge reset) begin
     if (reset) begin
         cycles_per_bit_reg <= CYCLES_115200;
+        baud_frac_reg      <= 8'd0;
+    end else if (baud_divisor_reg[31:8] != 24'd0) begin
+        cycles_per_bit_reg <= baud_divisor_reg[31:8];
+        baud_frac_reg      <= baud_divisor_reg[7:0];
     end else begin
+        baud_frac_reg      <= 8'd0;
         case (config_reg[2:0])
             3'b000 : cycles_per_bit_reg <= CYCLES_230400;
             3'b001 : cycles_per_bit_reg <= CYCLES_115200;
@@ -423,21 +582,26 @@ always @(posedge clk or posedge reset) begin
     end
 end
 
-// Baud rate generator using cycles_per_bit_reg
-reg [13:0] baud_counter;
-reg baud_tick;
+// Baud rate generator using cycles_per_bit_reg, a bit lasts one cycle longer whenever the
+// fraction accumulator carries
+reg [23:0] baud_counter;
+reg [7:0]  baud_frac_acc;
+reg        baud_tick;
+wire [8:0] baud_frac_sum = {1'b0, baud_frac_acc} + {1'b0, baud_frac_reg};
 
 always @(posedge clk or posedge reset) begin
     if (reset) begin
-        baud_counter <= 0;
-        baud_tick    <= 0;
+        baud_counter  <= 0;
+        baud_frac_acc <= 0;
+        baud_tick     <= 0;
     end else begin
-        if (baud_counter == cycles_per_bit_reg) begin
-            baud_counter <= 0;
-            baud_tick    <= 1;
+        if (baud_counter == 24'd0) begin
+            baud_counter  <= cycles_per_bit_reg - 24'd1 + baud_frac_sum[8];
+            baud_frac_acc <= baud_frac_sum[7:0];
+            baud_tick     <= 1;
         end else begin
-            baud_counter <= baud_counter + 1;
-            baud_tick    <= 0;
+            baud_counter  <= baud_counter - 24'd1;
+            baud_tick     <= 0;
         end
     end
 end
@@ -477,13 +641,13 @@ always @(posedge clk or posedge reset) begin
                 // TX_IDLE: Check if there's data to dequeue
                 //---------------------------------------------------
                 TX_IDLE: begin
-                    if (!tx_fifo_empty) begin
-                        tx_shift_reg   <= tx_fifo[tx_fifo_rd_ptr[FIFO_ADDR_WIDTH-1:0]];
-                        tx_fifo_rd_ptr <= tx_fifo_rd_ptr + 1;
+                    if (!tx_fifo_empty && tx_clear_to_send) begin
+                        // tx_fifo_pop removes the byte on this same edge
+                        tx_shift_reg <= tx_fifo_head;
                         tx_serial    <= 1'b0;  // Start bit
                         tx_bit_cnt   <= 0;
-                        tx_state_reg   <= TX_DATA;
-                        `ifdef LOG_UART `LOG("uart", ("Dequeued FIFO[%0d]: %h, transitioning to TX_DATA", tx_fifo_rd_ptr, tx_fifo[tx_fifo_rd_ptr[FIFO_ADDR_WIDTH-1:0]])); `endif
+                        tx_state_reg <= TX_DATA;
+                        `ifdef LOG_UART `LOG("uart", ("Dequeued FIFO (%0d left): %h, transitioning to TX_DATA", tx_fifo_count - 1, tx_fifo_head)); `endif
                     end
                 end
 
@@ -544,17 +708,34 @@ rx_state_t rx_state_reg;
 reg [3:0] rx_bit_cnt;       // Bit counter for data bits
 reg [7:0] rx_shift_reg;     // Shift register to store received bits
 
+// Receive bit timer, started half a bit into the start bit so each bit is sampled in its middle
+reg [23:0] rx_baud_counter;
+reg [7:0]  rx_frac_acc;
+wire [8:0] rx_frac_sum = {1'b0, rx_frac_acc} + {1'b0, baud_frac_reg};
+wire       rx_bit_tick = (rx_state_reg != RX_IDLE) && (rx_baud_counter == 24'd0);
+
 // Initialize Receive State Machine
 always @(posedge clk or posedge reset) begin
     if (reset) begin
-        rx_state_reg  <= RX_IDLE;
-        rx_bit_cnt    <= 0;
-        rx_shift_reg  <= 0;
-        status_reg[4] <= 1'b0; // Clear IRQ
+        rx_state_reg    <= RX_IDLE;
+        rx_bit_cnt      <= 0;
+        rx_shift_reg    <= 0;
+        rx_baud_counter <= 0;
+        rx_frac_acc     <= 0;
         `ifdef LOG_UART
             `LOG("uart", ("Receiver reset to RX_IDLE"));
         `endif
     end else begin
+        if (rx_state_reg == RX_IDLE) begin
+            rx_baud_counter <= cycles_per_bit_reg >> 1;
+            rx_frac_acc     <= 8'd0;
+        end else if (rx_bit_tick) begin
+            rx_baud_counter <= cycles_per_bit_reg - 24'd1 + rx_frac_sum[8];
+            rx_frac_acc     <= rx_frac_sum[7:0];
+        end else begin
+            rx_baud_counter <= rx_baud_counter - 24'd1;
+        end
+
         case (rx_state_reg)
             RX_IDLE: begin
                 if (rx == 1'b0) begin // Start bit detected
@@ -566,19 +747,24 @@ always @(posedge clk or posedge reset) begin
             end
 
             RX_START: begin
-                if (baud_tick) begin
-                    // Move to data sampling
-                    rx_state_reg <= RX_DATA;
-                    rx_bit_cnt   <= 0;
-                    rx_shift_reg <= 0;
-                    `ifdef LOG_UART
-                        `LOG("uart", ("Half baud period passed, transitioning to RX_DATA"));
-                    `endif
+                if (rx_bit_tick) begin
+                    if (rx == 1'b0) begin
+                        // Move to data sampling
+                        rx_state_reg <= RX_DATA;
+                        rx_bit_cnt   <= 0;
+                        rx_shift_reg <= 0;
+                        `ifdef LOG_UART
+                            `LOG("uart", ("Half baud period passed, transitioning to RX_DATA"));
+                        `endif
+                    end else begin
+                        // Too short for a start bit, a glitch on the line
+                        rx_state_reg <= RX_IDLE;
+                    end
                 end
             end
 
             RX_DATA: begin
-                if (baud_tick) begin
+                if (rx_bit_tick) begin
                     // Sample the current data bit
                     rx_shift_reg[rx_bit_cnt] <= rx;
                     `ifdef LOG_UART
@@ -597,14 +783,11 @@ always @(posedge clk or posedge reset) begin
             end
 
             RX_STOP: begin
-                if (baud_tick) begin
+                if (rx_bit_tick) begin
                     if (rx == 1'b1 && !rx_fifo_full) begin
-                        // Valid stop bit and RX FIFO not full
-                        rx_fifo[rx_fifo_wr_ptr[FIFO_ADDR_WIDTH-1:0]] <= rx_shift_reg;
-                        rx_fifo_wr_ptr <= rx_fifo_wr_ptr + 1;
-                        status_reg[4]  <= 1'b1; // Set IRQ
+                        // Valid stop bit and RX FIFO not full, rx_fifo_push enqueues on this edge
                         `ifdef LOG_UART
-                            `LOG("uart", ("Stop bit received, data enqueued to RX FIFO: %h, IRQ set", rx_shift_reg));
+                            `LOG("uart", ("Stop bit received, data enqueued to RX FIFO: %h", rx_shift_reg));
                         `endif
                     end else begin
                         // Stop bit error or RX FIFO full
@@ -630,6 +813,11 @@ always @(posedge clk or posedge reset) begin
     end
 end
 
+// The FIFO side of the transmitter and receiver, taken on the baud tick the state machines act on
+assign tx_fifo_pop  = baud_tick && (tx_state_reg == TX_IDLE) && !tx_fifo_empty && tx_clear_to_send;
+assign rx_fifo_push = rx_bit_tick && (rx_state_reg == RX_STOP) && (rx == 1'b1);
+assign rx_fifo_wdata = rx_shift_reg;
+
 // ------------- Handle TileLink + IRQ in same always block -------------
 always @(posedge clk or posedge reset) begin
     if (reset) begin
@@ -647,15 +835,15 @@ always @(posedge clk or posedge reset) begin
         resp_denied  <= 1'b0;
         resp_corrupt <= 1'b0;
 
-        // Reset FIFOs
-        tx_fifo_wr_ptr <= 0;
-        tx_fifo_rd_ptr <= 0;
-        rx_fifo_wr_ptr <= 0;
-        rx_fifo_rd_ptr <= 0;
+        move_index   <= 4'd0;
+        move_last    <= 4'd0;
+        rx_idle_bits <= 6'd0;
 
         // Registers Register
-        status_reg     <= 8'b0000_0000;
-        config_reg     <= 8'b0010_0001; // IRQ Enabled, 115200 Baud
+        status_reg      <= 8'b0000_0000;
+        config_reg      <= 8'b0010_0001; // IRQ Enabled, 115200 Baud
+        fifo_config_reg <= 18'h0_0001;   // RX threshold 1, TX threshold and RX timeout IRQs off
+        baud_divisor_reg <= 32'd0;       // Baud rate from config_reg
 
         `ifdef LOG_UART
             `LOG("uart", ("Reset complete"));
@@ -670,9 +858,32 @@ always @(posedge clk or posedge reset) begin
         status_reg[2] <= rx_fifo_empty;
         status_reg[3] <= rx_fifo_full;
 
+        // RX threshold IRQ, set by the byte that fills the RX FIFO up to the threshold and held
+        // until reads drop below it
+        if (rx_fifo_push && !rx_fifo_full && ((rx_fifo_count + 1'b1) >= rx_threshold)) begin
+            status_reg[4] <= 1'b1;
+        end else if (rx_fifo_count < rx_threshold) begin
+            status_reg[4] <= 1'b0;
+        end
+
+        // TX threshold IRQ, follows the TX FIFO level
+        status_reg[5] <= fifo_config_reg[16] && (tx_fifo_count <= tx_threshold);
+
+        // RX timeout IRQ, counts bit times without RX traffic or reads while bytes wait
+        if (rx_fifo_empty || rx_fifo_push || rx_fifo_pop || rx_state_reg != RX_IDLE) begin
+            rx_idle_bits <= 6'd0;
+        end else if (baud_tick && rx_idle_bits != RX_TIMEOUT_BITS) begin
+            rx_idle_bits <= rx_idle_bits + 1'b1;
+        end
+        if (rx_fifo_empty || !fifo_config_reg[17]) begin
+            status_reg[6] <= 1'b0;
+        end else if (baud_tick && rx_idle_bits == RX_TIMEOUT_BITS - 1) begin
+            status_reg[6] <= 1'b1;
+        end
+
         // Zero out reserved bits
-        status_reg[7:5] <= 3'b000;
-        config_reg[7:6] <= 2'b00;
+        status_reg[7]   <= 1'b0;
+        config_reg[7]   <= 1'b0;
 
         // TileLink handshake signals
         tl_a_ready <= (state == IDLE);
@@ -700,6 +911,9 @@ always @(posedge clk or posedge reset) begin
                 // Initialize response flags
                 resp_param   <= 2'b00;
                 resp_source  <= req_source;
+                move_index   <= 4'd0;
+                move_last    <= (4'd1 << req_size) - 4'd1;
+                state        <= RESPOND;
 
                 // Handle Read vs Write
                 if (req_read) begin
@@ -734,18 +948,19 @@ always @(posedge clk or posedge reset) begin
                             end
                         end
                         DATA_ADDRESS: begin
-                            if (req_size == 3'b000) begin
-                                if (!rx_fifo_empty) begin
-                                    `ifdef LOG_UART `LOG("uart", ("Read byte from DATA_ADDRESS: %h", rx_fifo[rx_fifo_rd_ptr[FIFO_ADDR_WIDTH-1:0]])); `endif
-                                    resp_data  <= {{(XLEN-8){1'b0}}, rx_fifo[rx_fifo_rd_ptr[FIFO_ADDR_WIDTH-1:0]]};
+                            if (req_size <= BEAT_SIZE) begin
+                                if (rx_fifo_count >= (1 << req_size)) begin
+                                    `ifdef LOG_UART `LOG("uart", ("Read %0d byte(s) from DATA_ADDRESS", 1 << req_size)); `endif
+                                    // MOVE pops the bytes into resp_data
+                                    resp_data   <= {XLEN{1'b0}};
                                     resp_opcode <= TL_D_ACCESS_ACK_DATA;
-                                    rx_fifo_rd_ptr <= rx_fifo_rd_ptr + 1;
-
-                                    // If RX FIFO becomes empty => clear IRQ
-                                    if (rx_fifo_rd_ptr + 1 == rx_fifo_wr_ptr) begin
-                                        status_reg[4] <= 1'b0;
-                                        `ifdef LOG_UART `LOG("uart", ("RX_FIFO is now empty, IRQ cleared")); `endif
-                                    end
+                                    state       <= MOVE;
+                                end else if (req_size != 3'b000) begin
+                                    resp_data   <= {XLEN{1'b0}};
+                                    resp_opcode <= TL_D_ACCESS_ACK_ERROR;
+                                    resp_denied <= 1'b1;
+                                    resp_param  <= 2'b10; // Error param
+                                    `ifdef LOG_UART `LOG("uart", ("Read of %0d bytes from RX_FIFO holding %0d denied", 1 << req_size, rx_fifo_count)); `endif
                                 end else begin
                                     resp_data   <= {XLEN{1'b0}};
                                     resp_denied <= 1'b0;
@@ -759,6 +974,26 @@ always @(posedge clk or posedge reset) begin
                                 `ifdef LOG_UART `LOG("uart", ("Read from RX_FIFO denied due to invalid size: %b", req_size)); `endif
                             end
                         end
+                        FIFO_CONFIG_ADDRESS, FIFO_LEVEL_ADDRESS, BAUD_DIVISOR_ADDRESS: begin
+                            if (req_size == 3'b010) begin
+                                `ifdef LOG_UART `LOG("uart", ("Processing Read from %h", req_address)); `endif
+                                if (req_address == FIFO_CONFIG_ADDRESS) begin
+                                    resp_data <= fifo_config_reg;
+                                end else if (req_address == FIFO_LEVEL_ADDRESS) begin
+                                    resp_data <= { tx_level, rx_level };
+                                end else begin
+                                    resp_data <= baud_divisor_reg;
+                                end
+                                resp_opcode <= TL_D_ACCESS_ACK_DATA;
+                            end else begin
+                                resp_opcode <= TL_D_ACCESS_ACK_ERROR;
+                                resp_denied <= 1'b1;
+                                resp_param  <= 2'b10; // Error param
+                                `ifdef LOG_UART
+                                    `LOG("uart", ("Read from %h denied due to invalid size: %b", req_address, req_size));
+                                `endif
+                            end
+                        end
                         default: begin
                             resp_data   <= {XLEN{1'b0}};
                             resp_opcode <= TL_D_ACCESS_ACK_ERROR;
@@ -778,8 +1013,9 @@ always @(posedge clk or posedge reset) begin
                                     `ifdef LOG_UART
                                         `LOG("uart", ("Processing Write to STATUS_ADDRESS, Data: %h", req_wdata));
                                     `endif
-                                    // Ignore teh content, just clear the IRQ bit in the status_reg
+                                    // Ignore teh content, just clear the RX IRQ bits in the status_reg
                                     status_reg[4] <= 1'b0;
+                                    status_reg[6] <= 1'b0;
                                     resp_data   <= {XLEN{1'b0}};
                                     resp_opcode <= TL_D_ACCESS_ACK;
                                 end else begin
@@ -829,17 +1065,17 @@ always @(posedge clk or posedge reset) begin
                         end
 
                         DATA_ADDRESS: begin
-                            // Only accept byte writes
-                            if (req_size == 3'b000) begin
-                                if (count_wstrb_bits(req_wstrb) == 1) begin
-                                    if (!tx_fifo_full) begin
+                            // Accept up to a whole word of bytes
+                            if (req_size <= BEAT_SIZE) begin
+                                if (count_wstrb_bits(req_wstrb) == (1 << req_size)) begin
+                                    if ((FIFO_DEPTH - tx_fifo_count) >= (1 << req_size)) begin
                                         `ifdef LOG_UART
-                                            `LOG("uart", ("Byte enqueued to TX_FIFO: %h", req_wdata[7:0]));
+                                            `LOG("uart", ("Bytes enqueued to TX_FIFO: %h", req_wdata));
                                         `endif
-                                        tx_fifo[tx_fifo_wr_ptr[FIFO_ADDR_WIDTH-1:0]] <= req_wdata[7:0];
-                                        tx_fifo_wr_ptr <= tx_fifo_wr_ptr + 1;
+                                        // MOVE pushes the bytes from req_wdata
                                         resp_opcode <= TL_D_ACCESS_ACK;
                                         resp_data   <= {XLEN{1'b0}};
+                                        state       <= MOVE;
                                     end else begin
                                         resp_opcode <= TL_D_ACCESS_ACK_ERROR;
                                         resp_denied <= 1'b1;
@@ -866,6 +1102,42 @@ always @(posedge clk or posedge reset) begin
                             end
                         end
 
+                        FIFO_CONFIG_ADDRESS: begin
+                            if (req_size == 3'b010 && count_wstrb_bits(req_wstrb) == 4) begin
+                                `ifdef LOG_UART
+                                    `LOG("uart", ("Processing Write to FIFO_CONFIG_ADDRESS, Data: %h", req_wdata));
+                                `endif
+                                fifo_config_reg <= req_wdata[17:0];
+                                resp_data       <= {XLEN{1'b0}};
+                                resp_opcode     <= TL_D_ACCESS_ACK;
+                            end else begin
+                                resp_opcode <= TL_D_ACCESS_ACK_ERROR;
+                                resp_denied <= 1'b1;
+                                resp_param  <= 2'b10; // Error param
+                                `ifdef LOG_UART
+                                    `LOG("uart", ("Write to FIFO_CONFIG_ADDRESS denied due to invalid size or mask"));
+                                `endif
+                            end
+                        end
+
+                        BAUD_DIVISOR_ADDRESS: begin
+                            if (req_size == 3'b010 && count_wstrb_bits(req_wstrb) == 4) begin
+                                `ifdef LOG_UART
+                                    `LOG("uart", ("Processing Write to BAUD_DIVISOR_ADDRESS, Data: %h", req_wdata));
+                                `endif
+                                baud_divisor_reg <= req_wdata[31:0];
+                                resp_data        <= {XLEN{1'b0}};
+                                resp_opcode      <= TL_D_ACCESS_ACK;
+                            end else begin
+                                resp_opcode <= TL_D_ACCESS_ACK_ERROR;
+                                resp_denied <= 1'b1;
+                                resp_param  <= 2'b10; // Error param
+                                `ifdef LOG_UART
+                                    `LOG("uart", ("Write to BAUD_DIVISOR_ADDRESS denied due to invalid size or mask"));
+                                `endif
+                            end
+                        end
+
                         default: begin
                             resp_opcode <= TL_D_ACCESS_ACK_ERROR;
                             resp_denied <= 1'b1;
@@ -876,7 +1148,17 @@ always @(posedge clk or posedge reset) begin
                         end
                     endcase
                 end
-                state <= RESPOND;
+            end
+
+            MOVE: begin
+                // One byte per cycle through the FIFO ports, least significant lane first
+                if (req_read) begin
+                    resp_data[move_index*8 +: 8] <= rx_fifo_head;
+                end
+                move_index <= move_index + 4'd1;
+                if (move_index == move_last) begin
+                    state <= RESPOND;
+                end
             end
 
             RESPOND: begin
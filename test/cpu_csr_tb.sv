@@ -48,6 +48,10 @@ logic                interrupt_pending;
 logic [IRQ_COUNT-1:0] irq;
 logic [NMI_COUNT-1:0] nmi;
 
+// Performance Counter Events
+logic                perf_retire;
+logic [4:0]          perf_event;
+
 // DUT (Device Under Test) Instantiation
 cpu_csr #(
     .XLEN(XLEN),
@@ -82,9 +86,14 @@ cpu_csr #(
     // Output Signals
     .interrupt_pending  (interrupt_pending),
 
+    // Performance Counter Events
+    .perf_retire        (perf_retire),
+    .perf_event         (perf_event),
+
     // Interrupt Request Lines
     .irq                (irq),
-    .nmi                (nmi)
+    .nmi                (nmi),
+    .timer_irq          (1'b0)
 );
 
 //-----------------------------------------------------
@@ -165,6 +174,13 @@ logic [XLEN-1:0] new_cycle;
 logic [XLEN-1:0] initial_cycle_high;
 logic [XLEN-1:0] new_cycle_high;
 logic [XLEN-1:0] old_val;
+integer          hpm_ticks;     // Cycles with perf_event[0] set
+integer          retire_ticks;  // Cycles with perf_retire set
+
+always @(posedge clk) begin
+    if (perf_event[0]) hpm_ticks    <= hpm_ticks + 1;
+    if (perf_retire)   retire_ticks <= retire_ticks + 1;
+end
 
 //-----------------------------------------------------
 // Test Sequence
@@ -192,6 +208,10 @@ initial begin
     irq          = {IRQ_COUNT{1'b0}};
     nmi          = {NMI_COUNT{1'b0}};
 
+    // Initialize Performance Counter Events
+    perf_retire  = 1'b0;
+    perf_event   = 5'b00000;
+
     // De-assert reset after two clock cycles
     @(posedge clk);
     @(posedge clk);
@@ -739,6 +759,100 @@ initial begin
     //-------------------------------------------------
 
 
+    //-------------------------------------------------
+    `TEST("cpu_csr", "minstret counts retired instructions")
+    reg_read(`CSR_MINSTRET, initial_cycle);
+    @(negedge clk) perf_retire = 1'b1;
+    repeat(3) @(posedge clk);
+    @(negedge clk) perf_retire = 1'b0;
+    reg_read(`CSR_MINSTRET, new_cycle);
+    `EXPECT("minstret +3", new_cycle, initial_cycle + 3);
+    reg_read(`CSR_MINSTRETH, new_cycle_high);
+    `EXPECT("minstreth unchanged", new_cycle_high, {XLEN{1'b0}});
+
+    `TEST("cpu_csr", "mhpmcounters count their own events")
+    @(negedge clk) perf_event = 5'b00101;
+    repeat(4) @(posedge clk);
+    @(negedge clk) perf_event = 5'b10000;
+    @(posedge clk);
+    @(negedge clk) perf_event = 5'b00000;
+    reg_read(`CSR_MHPMCOUNTER3, new_cycle);
+    `EXPECT("mhpmcounter3 = 4", new_cycle, 4);
+    reg_read(`CSR_MHPMCOUNTER3 + 1, new_cycle);
+    `EXPECT("mhpmcounter4 = 0", new_cycle, 0);
+    reg_read(`CSR_MHPMCOUNTER3 + 2, new_cycle);
+    `EXPECT("mhpmcounter5 = 4", new_cycle, 4);
+    reg_read(`CSR_MHPMCOUNTER3 + 4, new_cycle);
+    `EXPECT("mhpmcounter7 = 1", new_cycle, 1);
+    reg_read(`CSR_MHPMCOUNTER3 + 5, new_cycle);
+    `EXPECT("No mhpmcounter8", new_cycle, 0);
+
+    `TEST("cpu_csr", "CSRRW: Write mhpmcounter4 and mhpmcounter3h")
+    csr_operation(`CSR_RW, `CSR_MHPMCOUNTER3 + 1, 32'h0000_1000, 5'b00000, old_val);
+    `EXPECT("Old mhpmcounter4", old_val, 0);
+    csr_operation(`CSR_RW, `CSR_MHPMCOUNTER3H, 32'h0000_0002, 5'b00000, old_val);
+    reg_read(`CSR_MHPMCOUNTER3 + 1, new_cycle);
+    `EXPECT("mhpmcounter4 written", new_cycle, 32'h0000_1000);
+    reg_read(`CSR_MHPMCOUNTER3H, new_cycle_high);
+    `EXPECT("mhpmcounter3h written", new_cycle_high, 32'h0000_0002);
+    reg_read(`CSR_MHPMCOUNTER3, new_cycle);
+    `EXPECT("mhpmcounter3 low half kept", new_cycle, 4);
+
+    `TEST("cpu_csr", "csrr of a counting mhpmcounter3 and minstret keeps every tick")
+    reg_read(`CSR_MHPMCOUNTER3, initial_cycle);
+    reg_read(`CSR_MINSTRET, initial_cycle_high);
+    hpm_ticks    = 0;
+    retire_ticks = 0;
+    @(negedge clk) begin
+        perf_retire = 1'b1;
+        perf_event  = 5'b00001;
+    end
+    csr_operation(`CSR_RS, `CSR_MHPMCOUNTER3, {XLEN{1'b0}}, 5'b00000, old_val);
+    csr_operation(`CSR_RC, `CSR_MHPMCOUNTER3, {XLEN{1'b0}}, 5'b00000, old_val);
+    csr_operation(`CSR_RSI, `CSR_MHPMCOUNTER3, {XLEN{1'b0}}, 5'b00000, old_val);
+    csr_operation(`CSR_RCI, `CSR_MHPMCOUNTER3, {XLEN{1'b0}}, 5'b00000, old_val);
+    csr_operation(`CSR_RS, `CSR_MINSTRET, {XLEN{1'b0}}, 5'b00000, old_val);
+    csr_operation(`CSR_RCI, `CSR_MINSTRET, {XLEN{1'b0}}, 5'b00000, old_val);
+    @(negedge clk) begin
+        perf_retire = 1'b0;
+        perf_event  = 5'b00000;
+    end
+    reg_read(`CSR_MHPMCOUNTER3, new_cycle);
+    `EXPECT("mhpmcounter3 counted every cycle", new_cycle, initial_cycle + hpm_ticks);
+    reg_read(`CSR_MINSTRET, new_cycle_high);
+    `EXPECT("minstret counted every cycle", new_cycle_high, initial_cycle_high + retire_ticks);
+
+    `TEST("cpu_csr", "mcountinhibit stops the counters")
+    csr_operation(`CSR_RW, `CSR_MCOUNTINHIBIT, {XLEN{1'b1}}, 5'b00000, old_val);
+    `EXPECT("mcountinhibit was clear", old_val, 0);
+    reg_read(`CSR_MCOUNTINHIBIT, new_cycle);
+    `EXPECT("Only CY, IR and HPM3-7 are writable", new_cycle, 32'h0000_00FD);
+    reg_read(`CSR_MCYCLE, initial_cycle);
+    reg_read(`CSR_MINSTRET, initial_cycle_high);
+    @(negedge clk) begin
+        perf_retire = 1'b1;
+        perf_event  = 5'b11111;
+    end
+    repeat(3) @(posedge clk);
+    @(negedge clk) begin
+        perf_retire = 1'b0;
+        perf_event  = 5'b00000;
+    end
+    reg_read(`CSR_MCYCLE, new_cycle);
+    `EXPECT("mcycle stopped", new_cycle, initial_cycle);
+    reg_read(`CSR_MINSTRET, new_cycle_high);
+    `EXPECT("minstret stopped", new_cycle_high, initial_cycle_high);
+    reg_read(`CSR_MHPMCOUNTER3 + 2, new_cycle);
+    `EXPECT("mhpmcounter5 stopped", new_cycle, 4);
+    csr_operation(`CSR_RCI, `CSR_MCOUNTINHIBIT, {XLEN{1'b0}}, 5'b00001, old_val);
+    reg_read(`CSR_MCYCLE, initial_cycle);
+    repeat(4) @(posedge clk);
+    reg_read(`CSR_MCYCLE, new_cycle);
+    `EXPECT("mcycle runs again", new_cycle, initial_cycle + 5);
+    reg_read(`CSR_MCOUNTINHIBIT, new_cycle);
+    `EXPECT("Other counters still inhibited", new_cycle, 32'h0000_00FC);
+    //-------------------------------------------------
+
     //-------------------------------------------------
     // Finish Testbench
     //-------------------------------------------------
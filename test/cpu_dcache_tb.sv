@@ -0,0 +1,280 @@
+`timescale 1ns / 1ps
+`default_nettype none
+
+// `define LOG_DCACHE
+
+`include "cpu_dcache.sv"
+
+`ifndef XLEN
+`define XLEN 32
+`endif
+
+module cpu_dcache_tb;
+`include "test/test_macros.sv"
+
+// ====================================
+// Parameters
+// ====================================
+localparam XLEN  = `XLEN;
+localparam BYTES = XLEN / 8;
+localparam SIZE  = 128;  // 8 lines
+localparam LINE  = 16;   // 16 bytes per line
+
+// ====================================
+// Clock and Reset
+// ====================================
+reg clk;
+reg reset;
+
+initial begin
+    clk = 0;
+    forever #5 clk = ~clk; // 100MHz clock
+end
+
+// ====================================
+// CPU Side
+// ====================================
+reg                  cpu_ready;
+reg                  cpu_fetch;
+reg [XLEN-1:0]       cpu_address;
+reg [XLEN-1:0]       cpu_wdata;
+reg [2:0]            cpu_size;
+reg                  cpu_read;
+wire                 cpu_ack;
+wire [XLEN-1:0]      cpu_rdata;
+wire                 cpu_denied;
+wire                 cpu_corrupt;
+wire                 cpu_valid;
+
+// ====================================
+// tl_interface Side
+// ====================================
+wire                 if_ready;
+wire [XLEN-1:0]      if_address;
+wire [XLEN-1:0]      if_wdata;
+wire [XLEN/8-1:0]    if_wstrb;
+wire [2:0]           if_size;
+wire                 if_read;
+reg                  if_ack;
+reg  [XLEN-1:0]      if_rdata;
+reg                  if_denied;
+reg                  if_corrupt;
+reg                  if_valid;
+
+reg                  fence;
+wire                 drained;
+wire [XLEN-1:0]      hit_count;
+wire [XLEN-1:0]      miss_count;
+
+cpu_dcache #(
+    .XLEN(XLEN),
+    .SIZE(SIZE),
+    .LINE(LINE),
+    .SB_DEPTH(4),
+    .CACHED_BASE(32'h0000_0000),
+    .CACHED_MASK(32'h0000_FFFF)
+) uut (
+    .clk         (clk),
+    .reset       (reset),
+    .cpu_ready   (cpu_ready),
+    .cpu_fetch   (cpu_fetch),
+    .cpu_address (cpu_address),
+    .cpu_wdata   (cpu_wdata),
+    .cpu_wstrb   ({(XLEN/8){1'b0}}),
+    .cpu_size    (cpu_size),
+    .cpu_read    (cpu_read),
+    .cpu_ack     (cpu_ack),
+    .cpu_rdata   (cpu_rdata),
+    .cpu_denied  (cpu_denied),
+    .cpu_corrupt (cpu_corrupt),
+    .cpu_valid   (cpu_valid),
+    .if_ready    (if_ready),
+    .if_address  (if_address),
+    .if_wdata    (if_wdata),
+    .if_wstrb    (if_wstrb),
+    .if_size     (if_size),
+    .if_read     (if_read),
+    .if_ack      (if_ack),
+    .if_rdata    (if_rdata),
+    .if_denied   (if_denied),
+    .if_corrupt  (if_corrupt),
+    .if_valid    (if_valid),
+    .fence       (fence),
+    .drained     (drained),
+    .hit_count   (hit_count),
+    .miss_count  (miss_count)
+);
+
+// ====================================
+// Byte addressed memory model with slow tl_interface timing. Both windows (0x0000 cached,
+// 0x1_0000 uncached) map onto the same bytes.
+// ====================================
+reg [7:0]  memory [0:255];
+integer    bus_reads;
+integer    bus_writes;
+integer    last_write_done; // Request number of the last completed write
+integer    last_read_start; // Request number of the last read
+integer    bus_requests;
+
+initial begin
+    if_ack          = 0;
+    if_valid        = 0;
+    if_rdata        = 0;
+    if_denied       = 0;
+    if_corrupt      = 0;
+    bus_reads       = 0;
+    bus_writes      = 0;
+    bus_requests    = 0;
+    last_write_done = 0;
+    last_read_start = 0;
+    forever begin
+        @(posedge clk);
+        if (if_ready && !if_ack) begin
+            bus_requests = bus_requests + 1;
+            if_ack <= 1;
+            if (if_read) begin
+                bus_reads       = bus_reads + 1;
+                last_read_start = bus_requests;
+                for (int b = 0; b < BYTES; b++) begin
+                    if_rdata[8*b +: 8] <= memory[(if_address + b) & 8'hFF];
+                end
+            end else begin
+                bus_writes = bus_writes + 1;
+                for (int b = 0; b < BYTES; b++) begin
+                    if (if_wstrb[b]) begin
+                        memory[((if_address & ~(BYTES-1)) + b) & 8'hFF] = if_wdata[8*(b - (if_address % BYTES)) +: 8];
+                    end
+                end
+                last_write_done = bus_requests;
+            end
+            @(posedge clk);
+            if_ack <= 0;
+            repeat (6) @(posedge clk);
+            if_valid <= 1;
+            @(posedge clk);
+            if_valid <= 0;
+        end
+    end
+end
+
+// ====================================
+// CPU access, same handshake as the tl_cpu load/store states
+// ====================================
+reg [XLEN-1:0] result;
+integer        cycles;
+
+task automatic Access(input [XLEN-1:0] address, input is_read, input [2:0] size,
+                      input [XLEN-1:0] data, input is_fetch);
+    begin
+        @(posedge clk);
+        cycles      = 0;
+        cpu_ready   <= 1;
+        cpu_fetch   <= is_fetch;
+        cpu_read    <= is_read;
+        cpu_size    <= size;
+        cpu_address <= address;
+        cpu_wdata   <= data;
+        @(posedge clk);
+        while (!cpu_ack) begin
+            @(posedge clk);
+            cycles = cycles + 1;
+        end
+        cpu_ready   <= 0;
+        while (!cpu_valid) begin
+            @(posedge clk);
+            cycles = cycles + 1;
+        end
+        result = cpu_rdata;
+        cpu_fetch   <= 0;
+    end
+endtask
+
+task automatic WaitDrained;
+    begin
+        @(posedge clk);
+        while (!drained) @(posedge clk);
+    end
+endtask
+
+initial begin
+    $dumpfile("cpu_dcache_tb.vcd");
+    $dumpvars(0, cpu_dcache_tb);
+
+    for (int i = 0; i < 256; i++) memory[i] = i;
+    reset       = 1;
+    cpu_ready   = 0;
+    cpu_fetch   = 0;
+    cpu_read    = 0;
+    cpu_size    = 3'b010;
+    cpu_address = 0;
+    cpu_wdata   = 0;
+    fence       = 0;
+    repeat (2) @(posedge clk);
+    reset = 0;
+
+    `TEST("cpu_dcache", "Stores are posted and drain in order");
+    Access('h40, 0, 3'b010, 'h1122_3344, 0);
+    `EXPECT("Store completes before the bus", cycles < 4, 1);
+    Access('h44, 0, 3'b000, 'hAA, 0);
+    `EXPECT("Second store also posted", cycles < 4, 1);
+    WaitDrained();
+    `EXPECT("Bus writes", bus_writes, 2);
+    `EXPECT("Byte 0x40", memory['h40], 8'h44);
+    `EXPECT("Byte 0x43", memory['h43], 8'h11);
+    `EXPECT("Byte 0x44", memory['h44], 8'hAA);
+    `EXPECT("Byte 0x45", memory['h45], 8'h45);
+
+    `TEST("cpu_dcache", "Load miss refills the line");
+    bus_reads = 0;
+    Access('h84, 1, 3'b010, 0, 0);
+    `EXPECT("Data", result[31:0], 32'h8786_8584);
+    `EXPECT("Misses", miss_count, 1);
+    `EXPECT("Bus reads", bus_reads, LINE / BYTES);
+
+    `TEST("cpu_dcache", "Load from the same line hits");
+    bus_reads = 0;
+    Access('h8A, 1, 3'b001, 0, 0);
+    `EXPECT("Data", result, 'h8B8A);
+    Access('h8F, 1, 3'b000, 0, 0);
+    `EXPECT("Data", result, 'h8F);
+    `EXPECT("Hits", hit_count, 2);
+    `EXPECT("Bus reads", bus_reads, 0);
+
+    `TEST("cpu_dcache", "Store to a cached line updates it");
+    Access('h89, 0, 3'b000, 'h5A, 0);
+    Access('h88, 1, 3'b010, 0, 0);
+    `EXPECT("Merged data", result[31:0], 32'h8B8A_5A88);
+    `EXPECT("Bus reads", bus_reads, 0);
+    WaitDrained();
+    `EXPECT("Memory", memory['h89], 8'h5A);
+
+    `TEST("cpu_dcache", "Load after store is forwarded from the store buffer");
+    bus_reads = 0;
+    Access('hC0, 0, 3'b010, 'hDEAD_BEEF, 0);
+    Access('hC2, 1, 3'b001, 0, 0);
+    `EXPECT("Forwarded data", result, 'hDEAD);
+    `EXPECT("Bus reads", bus_reads, 0);
+    `EXPECT("Hits", hit_count, 4);
+    WaitDrained();
+
+    `TEST("cpu_dcache", "Uncached load waits for buffered stores");
+    Access('h1_0050, 0, 3'b010, 'hCAFE_F00D, 0);
+    Access('h1_0050, 1, 3'b010, 0, 0);
+    `EXPECT("Data", result[31:0], 32'hCAFE_F00D);
+    `EXPECT("Read after write", last_read_start > last_write_done, 1);
+    `EXPECT("Uncached loads are not counted", miss_count, 1);
+
+    `TEST("cpu_dcache", "Fence drains the store buffer before the next fetch");
+    Access('h60, 0, 3'b010, 'h1357_9BDF, 0);
+    @(posedge clk);
+    fence <= 1;
+    @(posedge clk);
+    fence <= 0;
+    Access('h60, 1, 3'b010, 0, 1);
+    `EXPECT("Fetched data", result[31:0], 32'h1357_9BDF);
+    `EXPECT("Read after write", last_read_start > last_write_done, 1);
+
+    `FINISH;
+end
+
+endmodule
@@ -0,0 +1,200 @@
+`default_nettype none
+`timescale 1ns / 1ps
+
+`include "cpu_exu.sv"
+
+`ifndef XLEN
+`define XLEN 32
+`endif
+
+module cpu_exu_tb;
+`include "test/test_macros.sv"
+
+// Parameters for XLEN
+localparam XLEN = `XLEN;
+
+// -----------------------------
+// EXU Signals
+// -----------------------------
+// Inputs
+logic [XLEN-1:0] operand_a;
+logic [XLEN-1:0] operand_b;
+logic [3:0]      alu_control;
+logic [5:0]      bmu_control;
+logic            bmu_select;
+
+// Outputs
+logic [XLEN-1:0] result;
+logic            zero;
+logic            less_than;
+logic            unsigned_less_than;
+
+// Instantiate the EXU
+cpu_exu #(
+    .XLEN(XLEN)
+) uut (
+    .operand_a          (operand_a),
+    .operand_b          (operand_b),
+    .alu_control        (alu_control),
+    .bmu_control        (bmu_control),
+    .bmu_select         (bmu_select),
+    .result             (result),
+    .zero               (zero),
+    .less_than          (less_than),
+    .unsigned_less_than (unsigned_less_than)
+);
+
+task TestAlu(
+    input string     desc,
+    input [3:0]      in_control,
+    input [XLEN-1:0] in_operand_a,
+    input [XLEN-1:0] in_operand_b,
+    input [XLEN-1:0] expected_result
+);
+    begin
+        `TEST("cpu_exu", desc);
+        operand_a   = in_operand_a;
+        operand_b   = in_operand_b;
+        alu_control = in_control;
+        bmu_control = 6'b0;
+        bmu_select  = 1'b0;
+
+        #10;
+
+        `EXPECT("Result", result, expected_result);
+        `EXPECT("Zero Flag", zero, (expected_result == {XLEN{1'b0}}));
+
+        #10;
+    end
+endtask
+
+task TestBmu(
+    input string     desc,
+    input [5:0]      in_control,
+    input [XLEN-1:0] in_operand_a,
+    input [XLEN-1:0] in_operand_b,
+    input [XLEN-1:0] expected_result
+);
+    begin
+        `TEST("cpu_exu", desc);
+        operand_a   = in_operand_a;
+        operand_b   = in_operand_b;
+        alu_control = 4'b0;
+        bmu_control = in_control;
+        bmu_select  = 1'b1;
+
+        #10;
+
+        `EXPECT("Result", result, expected_result);
+
+        #10;
+    end
+endtask
+
+//-----------------------------------------------------
+// Clock Generation
+// Needed for `FINISH macro
+//-----------------------------------------------------
+logic clk;
+initial begin
+    clk = 0;
+    forever #5 clk = ~clk;
+end
+
+initial begin
+    $dumpfile("cpu_exu_tb.vcd");
+    $dumpvars(0, cpu_exu_tb);
+
+    operand_a   = 0;
+    operand_b   = 0;
+    alu_control = 0;
+    bmu_control = 0;
+    bmu_select  = 0;
+
+    //////////////////////////////////////////////////////////////
+    // ALU Operations
+    //////////////////////////////////////////////////////////////
+    TestAlu("ADD: 0x20 + 0x0A = 0x2A", `ALU_ADD, 'h20, 'h0A, 'h2A);
+    TestAlu("SUB: 0x0A - 0x0A = 0", `ALU_SUB, 'h0A, 'h0A, 'h0);
+    TestAlu("SUB: 0 - 1 = -1", `ALU_SUB, 'h0, 'h1, {XLEN{1'b1}});
+    TestAlu("XOR: 0xF0F0 ^ 0xFF00 = 0x0FF0", `ALU_XOR, 'hF0F0, 'hFF00, 'h0FF0);
+    TestAlu("SLL: 0x1 << 4 = 0x10", `ALU_SLL, 'h1, 'h4, 'h10);
+    TestAlu("SLL: 0x1 << XLEN-1 is the sign bit", `ALU_SLL, 'h1, XLEN-1, {1'b1, {(XLEN-1){1'b0}}});
+    TestAlu("SRL: sign bit >> XLEN-1 = 1", `ALU_SRL, {1'b1, {(XLEN-1){1'b0}}}, XLEN-1, 'h1);
+    TestAlu("SRA: sign bit >>> 4 keeps the sign", `ALU_SRA, {1'b1, {(XLEN-1){1'b0}}}, 'h4,
+            {5'b11111, {(XLEN-5){1'b0}}});
+    TestAlu("SRA: 0x80 >>> 4 = 0x8", `ALU_SRA, 'h80, 'h4, 'h8);
+    TestAlu("SLT: -1 < 1", `ALU_SLT, {XLEN{1'b1}}, 'h1, 'h1);
+    TestAlu("SLTU: 0xFF..FF < 1 is false", `ALU_SLTU, {XLEN{1'b1}}, 'h1, 'h0);
+
+    //////////////////////////////////////////////////////////////
+    // Zba
+    //////////////////////////////////////////////////////////////
+    TestBmu("SH1ADD: (0x10 << 1) + 3 = 0x23", `BMU_SH1ADD, 'h10, 'h3, 'h23);
+    TestBmu("SH2ADD: (0x10 << 2) + 3 = 0x43", `BMU_SH2ADD, 'h10, 'h3, 'h43);
+    TestBmu("SH3ADD: (0x10 << 3) + 3 = 0x83", `BMU_SH3ADD, 'h10, 'h3, 'h83);
+
+    //////////////////////////////////////////////////////////////
+    // Zbb
+    //////////////////////////////////////////////////////////////
+    TestBmu("ANDN: 0xFF & ~0x0F = 0xF0", `BMU_ANDN, 'hFF, 'h0F, 'hF0);
+    TestBmu("ORN: 0 | ~0 = all ones", `BMU_ORN, 'h0, 'h0, {XLEN{1'b1}});
+    TestBmu("XNOR: x ~^ x = all ones", `BMU_XNOR, 'h1234, 'h1234, {XLEN{1'b1}});
+    TestBmu("CLZ: 1 has XLEN-1 leading zeros", `BMU_CLZ, 'h1, 'h0, XLEN-1);
+    TestBmu("CLZ: 0x00010000", `BMU_CLZ, 'h0001_0000, 'h0, XLEN-17);
+    TestBmu("CLZ: 0 has XLEN leading zeros", `BMU_CLZ, 'h0, 'h0, XLEN);
+    TestBmu("CLZ: sign bit has no leading zeros", `BMU_CLZ, {1'b1, {(XLEN-1){1'b0}}}, 'h0, 'h0);
+    TestBmu("CTZ: 0x00010000 has 16 trailing zeros", `BMU_CTZ, 'h0001_0000, 'h0, 'd16);
+    TestBmu("CTZ: 0 has XLEN trailing zeros", `BMU_CTZ, 'h0, 'h0, XLEN);
+    TestBmu("CPOP: 0xF0F1 has 9 bits set", `BMU_CPOP, 'hF0F1, 'h0, 'd9);
+    TestBmu("CPOP: all ones has XLEN bits set", `BMU_CPOP, {XLEN{1'b1}}, 'h0, XLEN);
+    TestBmu("MAX: max(-1, 1) = 1", `BMU_MAX, {XLEN{1'b1}}, 'h1, 'h1);
+    TestBmu("MAXU: maxu(-1, 1) = -1", `BMU_MAXU, {XLEN{1'b1}}, 'h1, {XLEN{1'b1}});
+    TestBmu("MIN: min(-1, 1) = -1", `BMU_MIN, {XLEN{1'b1}}, 'h1, {XLEN{1'b1}});
+    TestBmu("MINU: minu(-1, 1) = 1", `BMU_MINU, {XLEN{1'b1}}, 'h1, 'h1);
+    TestBmu("SEXT.B: 0x180 = -128", `BMU_SEXTB, 'h180, 'h0, {{(XLEN-8){1'b1}}, 8'h80});
+    TestBmu("SEXT.H: 0x18000 = -32768", `BMU_SEXTH, 'h1_8000, 'h0, {{(XLEN-16){1'b1}}, 16'h8000});
+    TestBmu("ZEXT.H: 0x12345678 = 0x5678", `BMU_ZEXTH32, 'h1234_5678, 'h0, 'h5678);
+    TestBmu("ROL: sign bit rotl 1 = 1", `BMU_ROL, {1'b1, {(XLEN-1){1'b0}}}, 'h1, 'h1);
+    TestBmu("ROL: rotl 0 keeps the value", `BMU_ROL, 'h1234, 'h0, 'h1234);
+    TestBmu("ROR: 1 rotr 1 = sign bit", `BMU_ROR, 'h1, 'h1, {1'b1, {(XLEN-1){1'b0}}});
+    TestBmu("ROR: 0x0F rotr 4 moves the low nibble to the top", `BMU_ROR, 'h0F, 'h4,
+            {4'hF, {(XLEN-4){1'b0}}});
+    TestBmu("ORC.B: 0x00100001 = 0x00FF00FF", `BMU_ORCB, 'h0010_0001, 'h0, 'h00FF_00FF);
+
+    if (XLEN == 32) begin
+    TestBmu("REV8: 0x12345678 = 0x78563412", `BMU_GREV, 'h1234_5678, 'd24, 'h7856_3412);
+    end else begin
+    TestBmu("REV8: 0x0123456789ABCDEF = 0xEFCDAB8967452301", `BMU_GREV, 'h0123_4567_89AB_CDEF,
+            'd56, 'hEFCD_AB89_6745_2301);
+    end
+    TestBmu("BREV8: 0x01 = 0x80", `BMU_GREV, 'h01, 'd7, 'h80);
+
+    //////////////////////////////////////////////////////////////
+    // Zbs
+    //////////////////////////////////////////////////////////////
+    TestBmu("BSET: set bit 4 of 0x1 = 0x11", `BMU_BSET, 'h1, 'h4, 'h11);
+    TestBmu("BCLR: clear bit 0 of 0x11 = 0x10", `BMU_BCLR, 'h11, 'h0, 'h10);
+    TestBmu("BINV: invert bit 31 of 0", `BMU_BINV, 'h0, 'd31, 'h8000_0000);
+    TestBmu("BEXT: bit 4 of 0x10 = 1", `BMU_BEXT, 'h10, 'h4, 'h1);
+    TestBmu("BEXT: bit 3 of 0x10 = 0", `BMU_BEXT, 'h10, 'h3, 'h0);
+
+    if (XLEN >= 64) begin
+    //////////////////////////////////////////////////////////////
+    // RV64 Zba / Zbb
+    //////////////////////////////////////////////////////////////
+    TestBmu("ADD.UW: zext(0xFFFFFFFF_FFFFFFFF[31:0]) + 1", `BMU_ADD_UW, {XLEN{1'b1}}, 'h1,
+            'h1_0000_0000);
+    TestBmu("SH2ADD.UW: (zext(0xF_00000001[31:0]) << 2) + 1 = 5", `BMU_SH2ADD_UW,
+            'hF_0000_0001, 'h1, 'h5);
+    TestBmu("SLLI.UW: zext(0xF_80000000[31:0]) << 1", `BMU_SLLIUW, 'hF_8000_0000, 'h1,
+            'h1_0000_0000);
+    TestBmu("ROR: 1 rotr 32 = 1 << 32", `BMU_ROR, 'h1, 'd32, 'h1_0000_0000);
+    TestBmu("BSET: set bit 40 of 0", `BMU_BSET, 'h0, 'd40, 'h100_0000_0000);
+    TestBmu("CTZ: 1 << 40 has 40 trailing zeros", `BMU_CTZ, 'h100_0000_0000, 'h0, 'd40);
+    end
+
+    `FINISH;
+end
+
+endmodule
@@ -0,0 +1,237 @@
+`timescale 1ns / 1ps
+`default_nettype none
+
+// `define LOG_ICACHE
+
+`include "cpu_icache.sv"
+
+`ifndef XLEN
+`define XLEN 32
+`endif
+
+module cpu_icache_tb;
+`include "test/test_macros.sv"
+
+// ====================================
+// Parameters
+// ====================================
+localparam XLEN = `XLEN;
+localparam SIZE = 64;   // 4 lines
+localparam LINE = 16;   // 4 words per line
+
+// ====================================
+// Clock and Reset
+// ====================================
+reg clk;
+reg reset;
+
+initial begin
+    clk = 0;
+    forever #5 clk = ~clk; // 100MHz clock
+end
+
+// ====================================
+// CPU Side
+// ====================================
+reg                  cpu_ready;
+reg                  cpu_fetch;
+reg [XLEN-1:0]       cpu_address;
+reg                  cpu_read;
+wire                 cpu_ack;
+wire [XLEN-1:0]      cpu_rdata;
+wire                 cpu_denied;
+wire                 cpu_corrupt;
+wire                 cpu_valid;
+
+// ====================================
+// tl_interface Side
+// ====================================
+wire                 if_ready;
+wire [XLEN-1:0]      if_address;
+wire [XLEN-1:0]      if_wdata;
+wire [XLEN/8-1:0]    if_wstrb;
+wire [2:0]           if_size;
+wire                 if_read;
+reg                  if_ack;
+reg  [XLEN-1:0]      if_rdata;
+reg                  if_denied;
+reg                  if_corrupt;
+reg                  if_valid;
+
+reg                  invalidate;
+wire [XLEN-1:0]      hit_count;
+wire [XLEN-1:0]      miss_count;
+
+cpu_icache #(
+    .XLEN(XLEN),
+    .SIZE(SIZE),
+    .LINE(LINE)
+) uut (
+    .clk         (clk),
+    .reset       (reset),
+    .cpu_ready   (cpu_ready),
+    .cpu_fetch   (cpu_fetch),
+    .cpu_address (cpu_address),
+    .cpu_wdata   ({XLEN{1'b0}}),
+    .cpu_wstrb   ({(XLEN/8){1'b0}}),
+    .cpu_size    (3'b010),
+    .cpu_read    (cpu_read),
+    .cpu_ack     (cpu_ack),
+    .cpu_rdata   (cpu_rdata),
+    .cpu_denied  (cpu_denied),
+    .cpu_corrupt (cpu_corrupt),
+    .cpu_valid   (cpu_valid),
+    .if_ready    (if_ready),
+    .if_fetch    (),
+    .if_address  (if_address),
+    .if_wdata    (if_wdata),
+    .if_wstrb    (if_wstrb),
+    .if_size     (if_size),
+    .if_read     (if_read),
+    .if_ack      (if_ack),
+    .if_rdata    (if_rdata),
+    .if_denied   (if_denied),
+    .if_corrupt  (if_corrupt),
+    .if_valid    (if_valid),
+    .invalidate  (invalidate),
+    .hit_count   (hit_count),
+    .miss_count  (miss_count)
+);
+
+// ====================================
+// Memory model with tl_interface timing: the data word is the address xor a seed, a read of
+// fail_address is denied while fail_enable is set
+// ====================================
+reg [31:0]     seed;
+integer        bus_requests;
+reg            fail_enable;
+reg [XLEN-1:0] fail_address;
+
+initial begin
+    if_ack       = 0;
+    if_valid     = 0;
+    if_rdata     = 0;
+    if_denied    = 0;
+    if_corrupt   = 0;
+    bus_requests = 0;
+    fail_enable  = 0;
+    fail_address = 0;
+    forever begin
+        @(posedge clk);
+        if (if_ready && !if_ack) begin
+            bus_requests = bus_requests + 1;
+            if_ack      <= 1;
+            if_rdata    <= {{(XLEN-32){1'b0}}, if_address[31:0] ^ seed};
+            if_denied   <= fail_enable && (if_address == fail_address);
+            @(posedge clk);
+            if_ack      <= 0;
+            repeat (3) @(posedge clk);
+            if_valid    <= 1;
+            @(posedge clk);
+            if_valid    <= 0;
+            if_denied   <= 0;
+        end
+    end
+end
+
+// ====================================
+// CPU fetch, same handshake as the tl_cpu STATE_IF
+// ====================================
+reg [XLEN-1:0] result;
+reg            result_denied;
+
+task automatic Fetch(input [XLEN-1:0] address, input is_fetch);
+    begin
+        @(posedge clk);
+        cpu_ready   <= 1;
+        cpu_fetch   <= is_fetch;
+        cpu_read    <= 1;
+        cpu_address <= address;
+        @(posedge clk);
+        while (!cpu_ack) @(posedge clk);
+        cpu_ready   <= 0;
+        while (!cpu_valid) @(posedge clk);
+        result        = cpu_rdata;
+        result_denied = cpu_denied;
+        cpu_fetch   <= 0;
+    end
+endtask
+
+initial begin
+    $dumpfile("cpu_icache_tb.vcd");
+    $dumpvars(0, cpu_icache_tb);
+
+    reset       = 1;
+    cpu_ready   = 0;
+    cpu_fetch   = 0;
+    cpu_read    = 0;
+    cpu_address = 0;
+    invalidate  = 0;
+    seed        = 32'hA5A5_0000;
+    repeat (2) @(posedge clk);
+    reset = 0;
+
+    `TEST("cpu_icache", "Cold fetch misses and refills the line");
+    Fetch('h104, 1);
+    `EXPECT("Instruction", result, {{(XLEN-32){1'b0}}, 32'hA5A5_0104});
+    `EXPECT("Misses", miss_count, 1);
+    `EXPECT("Hits", hit_count, 0);
+    `EXPECT("Bus requests", bus_requests, LINE / 4);
+
+    `TEST("cpu_icache", "Fetch from the same line hits");
+    bus_requests = 0;
+    Fetch('h100, 1);
+    `EXPECT("Instruction", result, {{(XLEN-32){1'b0}}, 32'hA5A5_0100});
+    Fetch('h10C, 1);
+    `EXPECT("Instruction", result, {{(XLEN-32){1'b0}}, 32'hA5A5_010C});
+    `EXPECT("Hits", hit_count, 2);
+    `EXPECT("Bus requests", bus_requests, 0);
+
+    `TEST("cpu_icache", "Data reads pass through");
+    seed = 32'h5A5A_0000;
+    Fetch('h100, 0);
+    `EXPECT("Data", result, {{(XLEN-32){1'b0}}, 32'h5A5A_0100});
+    `EXPECT("Bus requests", bus_requests, 1);
+    `EXPECT("Hits", hit_count, 2);
+    `EXPECT("Misses", miss_count, 1);
+
+    `TEST("cpu_icache", "Stale line is served until invalidated");
+    Fetch('h108, 1);
+    `EXPECT("Cached instruction", result, {{(XLEN-32){1'b0}}, 32'hA5A5_0108});
+    @(posedge clk);
+    invalidate <= 1;
+    @(posedge clk);
+    invalidate <= 0;
+    Fetch('h108, 1);
+    `EXPECT("Refilled instruction", result, {{(XLEN-32){1'b0}}, 32'h5A5A_0108});
+    `EXPECT("Misses", miss_count, 2);
+
+    `TEST("cpu_icache", "Conflicting lines evict each other");
+    Fetch('h100 + SIZE, 1);
+    `EXPECT("Instruction", result, {{(XLEN-32){1'b0}}, 32'h5A5A_0140});
+    Fetch('h100, 1);
+    `EXPECT("Instruction", result, {{(XLEN-32){1'b0}}, 32'h5A5A_0100});
+    `EXPECT("Misses", miss_count, 4);
+    `EXPECT("Hits", hit_count, 3);
+
+    `TEST("cpu_icache", "A failed refill does not leave the old line valid");
+    fail_enable  = 1;
+    fail_address = 'h148;
+    Fetch('h140, 1);
+    `EXPECT("Refill denied", result_denied, 1'b1);
+    fail_enable  = 0;
+    seed         = 32'h3C3C_0000;
+    bus_requests = 0;
+    Fetch('h100, 1);
+    `EXPECT("Old address misses", miss_count, 6);
+    `EXPECT("Instruction", result, {{(XLEN-32){1'b0}}, 32'h3C3C_0100});
+    `EXPECT("Not denied", result_denied, 1'b0);
+    `EXPECT("Bus requests", bus_requests, LINE / 4);
+    Fetch('h104, 1);
+    `EXPECT("Refilled line hits", hit_count, 4);
+    `EXPECT("Instruction", result, {{(XLEN-32){1'b0}}, 32'h3C3C_0104});
+
+    `FINISH;
+end
+
+endmodule
@@ -12,6 +12,11 @@ module cpu_mdu_tb;
         
 // Parameters for XLEN
 localparam XLEN = `XLEN;
+`ifdef MDU_FAST
+localparam MDU_IMPL = `MDU_IMPL_FAST;
+`else
+localparam MDU_IMPL = `MDU_IMPL_SIMPLE;
+`endif
 
 // -----------------------------
 // 32-bit MDU Signals
@@ -25,10 +30,14 @@ logic [2:0]              control;
 logic                    start;
 logic [XLEN-1:0]         result;
 logic                    ready;
+integer                  cycle_count;
+integer                  start_cycle;
+integer                  latency;    // Cycles from start to ready of the last Test
 
 // Instantiate the 32-bit MDU
 cpu_mdu #(
-    .XLEN(XLEN)
+    .XLEN(XLEN),
+    .MDU_IMPL(MDU_IMPL)
 ) uut (
     .clk                 (clk),
     .reset               (reset),
@@ -55,12 +64,14 @@ task Test(
         operand_b = in_operand_b;
         control   = in_control;
         start     = 1;
+        start_cycle = cycle_count;
 
         @(posedge clk);
 
         fork
             begin
                 wait (ready);
+                latency = cycle_count - start_cycle;
                 disable timeout;
             end
             begin: timeout
@@ -85,6 +96,9 @@ initial begin
     forever #5 clk = ~clk; // 100MHz clock
 end
 
+initial cycle_count = 0;
+always @(posedge clk) cycle_count <= cycle_count + 1;
+
 initial begin
     $dumpfile("cpu_mdu_tb.vcd");
     $dumpvars(0, cpu_mdu_tb);
@@ -247,6 +261,39 @@ initial begin
     );
     end
 
+    // Signed division rounds towards zero, the remainder takes the sign of the dividend
+    Test("DIV: -7 / 2 = -3", `MDU_DIV, -7, 2, -3);
+    Test("REM: -7 % 2 = -1 (fused with the DIV)", `MDU_REM, -7, 2, -1);
+    `EXPECT("Fused REM latency", latency <= 2, 1);
+    Test("DIV: 7 / -2 = -3", `MDU_DIV, 7, -2, -3);
+    Test("DIV overflow: MIN / -1 = MIN", `MDU_DIV, {1'b1, {(XLEN-1){1'b0}}}, -1, {1'b1, {(XLEN-1){1'b0}}});
+    Test("REM overflow: MIN % -1 = 0", `MDU_REM, {1'b1, {(XLEN-1){1'b0}}}, -1, 0);
+    Test("DIVU: 5 / 7 = 0", `MDU_DIVU, 5, 7, 0);
+    Test("REMU: 5 % 7 = 5", `MDU_REMU, 5, 7, 5);
+    Test("DIVU: MAX / 3", `MDU_DIVU, {XLEN{1'b1}}, 3, {XLEN{1'b1}} / 3);
+    Test("REMU by Zero: 9 % 0 = 9", `MDU_REMU, 9, 0, 9);
+
+    // The low half of a product is kept from the high half
+    Test("MULHU: MAX * MAX = MAX - 1", `MDU_MULHU, {XLEN{1'b1}}, {XLEN{1'b1}}, {{(XLEN-1){1'b1}}, 1'b0});
+    Test("MUL: MAX * MAX = 1 (fused with the MULHU)", `MDU_MUL, {XLEN{1'b1}}, {XLEN{1'b1}}, 1);
+    `EXPECT("Fused MUL latency", latency <= 2, 1);
+    Test("MULH: -1 * -1 = 0 (not fused with the MULHU)", `MDU_MULH, {XLEN{1'b1}}, {XLEN{1'b1}}, 0);
+    `EXPECT("MULH after the fused MUL recomputes", latency > 2, 1);
+
+    // A fused MUL must not retag the unsigned product as signed
+    Test("MULHU: MAX * 2 = 1", `MDU_MULHU, {XLEN{1'b1}}, 2, 1);
+    Test("MUL: MAX * 2 = -2 (fused with the MULHU)", `MDU_MUL, {XLEN{1'b1}}, 2, {{(XLEN-1){1'b1}}, 1'b0});
+    Test("MULH: -1 * 2 = -1 (not fused with the MULHU)", `MDU_MULH, {XLEN{1'b1}}, 2, {XLEN{1'b1}});
+    Test("MULH: -1 * 2 = -1 (fused with the MULH)", `MDU_MULH, {XLEN{1'b1}}, 2, {XLEN{1'b1}});
+    `EXPECT("Fused MULH latency", latency <= 2, 1);
+
+    if (MDU_IMPL == `MDU_IMPL_FAST) begin
+    Test("MUL: 0x1234 * 0x5678 = 0x6260060", `MDU_MUL, 'h1234, 'h5678, 'h6260060);
+    `EXPECT("Pipelined MUL latency", latency <= 4, 1);
+    Test("DIV: 100 / 7 = 14", `MDU_DIV, 100, 7, 14);
+    `EXPECT("Small DIV latency tracks the dividend", latency <= 6, 1);
+    end
+
     `FINISH;
 end
     
@@ -30,6 +30,8 @@ logic            rd_write_en;
 // Outputs
 logic [XLEN-1:0] rs1_data;
 logic [XLEN-1:0] rs2_data;
+logic [XLEN-1:0] byp_rs1_data;
+logic [XLEN-1:0] byp_rs2_data;
 
 
 // Instantiate the Register File
@@ -47,6 +49,22 @@ cpu_regfile #(
     .rs2_data    (rs2_data)
 );
 
+// Register File with the write-first bypass, on the same inputs
+cpu_regfile #(
+    .XLEN(XLEN),
+    .BYPASS(1)
+) uut_bypass (
+    .clk         (clk),
+    .reset       (reset),
+    .rs1_addr    (rs1_addr),
+    .rs2_addr    (rs2_addr),
+    .rd_addr     (rd_addr),
+    .rd_data     (rd_data),
+    .rd_write_en (rd_write_en),
+    .rs1_data    (byp_rs1_data),
+    .rs2_data    (byp_rs2_data)
+);
+
 // Task to perform a write test
 task Test(
     input string     desc,
@@ -75,6 +93,38 @@ task Test(
     end
 endtask
 
+// Task to check the read ports while a write is pending, before the clock edge commits it
+task BypassTest(
+    input string     desc,
+    input [4:0]      in_rd_addr,
+    input [XLEN-1:0] in_rd_data,
+    input [4:0]      in_rs1_addr,
+    input [4:0]      in_rs2_addr,
+    input [XLEN-1:0] expected_rs1_data,
+    input [XLEN-1:0] expected_rs2_data,
+    input [XLEN-1:0] expected_byp_rs1_data,
+    input [XLEN-1:0] expected_byp_rs2_data
+);
+    begin
+        `TEST("cpu_regfile", desc);
+        rd_addr     = in_rd_addr;
+        rd_data     = in_rd_data;
+        rd_write_en = 1'b1;
+        rs1_addr    = in_rs1_addr;
+        rs2_addr    = in_rs2_addr;
+
+        #1;
+
+        `EXPECT("rs1_data value", rs1_data, expected_rs1_data);
+        `EXPECT("rs2_data value", rs2_data, expected_rs2_data);
+        `EXPECT("bypass rs1_data value", byp_rs1_data, expected_byp_rs1_data);
+        `EXPECT("bypass rs2_data value", byp_rs2_data, expected_byp_rs2_data);
+
+        @(posedge clk);
+        rd_write_en = 0;
+    end
+endtask
+
 // Clock generation for 32-bit Register File
 initial begin
     clk = 0;
@@ -172,6 +222,29 @@ initial begin
                     5'd7, 5'd8,               // Read from x7 and x8
                     32'h00000000, 32'hFFFFFFFF); // Expected x7=0, x8=0xFFFFFFFF
 
+    BypassTest("Write x5=0x12345678 and read x5, x8 in the same cycle",
+                    5'd5, 32'h12345678,          // Write to x5
+                    5'd5, 5'd8,                  // Read from x5 and x8
+                    32'h55555555, 32'hFFFFFFFF,  // Without bypass x5 is still the old value
+                    32'h12345678, 32'hFFFFFFFF); // With bypass x5 is the value being written
+
+    BypassTest("Write x8=0x0000BEEF and read x8 on both ports in the same cycle",
+                    5'd8, 32'h0000BEEF,          // Write to x8
+                    5'd8, 5'd8,                  // Read from x8 twice
+                    32'hFFFFFFFF, 32'hFFFFFFFF,  // Without bypass x8 is still the old value
+                    32'h0000BEEF, 32'h0000BEEF); // With bypass both ports see the new value
+
+    BypassTest("Write x0=0xDEADBEEF and read x0, x5 in the same cycle",
+                    5'd0, 32'hDEADBEEF,          // Write to x0
+                    5'd0, 5'd5,                  // Read from x0 and x5
+                    32'h00000000, 32'h12345678,  // x0 stays zero
+                    32'h00000000, 32'h12345678); // The bypass ignores x0
+
+    Test("After the bypass writes: read x5, x8",
+                    5'd0, 32'h00000000, 1'b0,    // No write
+                    5'd5, 5'd8,                  // Read from x5 and x8
+                    32'h12345678, 32'h0000BEEF); // Both writes were committed
+
     if (XLEN >=64) begin
     Test("Write x1=0x123456789ABCDEF0 and read x1, x2",
                     5'd1, 64'h123456789ABCDEF0, 1'b1, // Write to x1
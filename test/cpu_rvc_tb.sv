@@ -0,0 +1,168 @@
+`default_nettype none
+`timescale 1ns / 1ps
+
+`include "cpu_rvc.sv"
+
+`ifndef XLEN
+`define XLEN 32
+`endif
+
+module cpu_rvc_tb;
+`include "test/test_macros.sv"
+
+// Parameters for XLEN
+localparam XLEN = `XLEN;
+
+// Testbench Signals
+logic [31:0] instr_in;
+logic [31:0] instr;
+logic        compressed;
+logic        illegal;
+
+cpu_rvc #(
+    .XLEN(XLEN)
+) uut (
+    .instr_in   (instr_in),
+    .instr      (instr),
+    .compressed (compressed),
+    .illegal    (illegal)
+);
+
+//-----------------------------------------------------
+// Clock Generation
+// Needed for `FINISH macro
+//-----------------------------------------------------
+logic clk;
+initial begin
+    clk = 0;
+    forever #5 clk = ~clk;
+end
+
+// Compressed Test Macro
+// Checks: expanded instruction, compressed=1, illegal=0
+// The upper half is filled with a 32-bit instruction to show it is ignored
+`define TEST_C(desc, c_val, instr_val) \
+    `TEST("cpu_rvc", desc); \
+    instr_in = {16'h1137, c_val}; \
+    #10; \
+    `EXPECT("Expanded instruction", instr, instr_val); \
+    `EXPECT("compressed should be 1", compressed, 1'b1); \
+    `EXPECT("illegal should be 0", illegal, 1'b0);
+
+// Illegal Test Macro
+// Checks: expanded instruction is zero, compressed=1, illegal=1
+`define TEST_ILLEGAL(desc, c_val) \
+    `TEST("cpu_rvc", desc); \
+    instr_in = {16'h0000, c_val}; \
+    #10; \
+    `EXPECT("Expanded instruction should be 0", instr, 32'h0000_0000); \
+    `EXPECT("compressed should be 1", compressed, 1'b1); \
+    `EXPECT("illegal should be 1", illegal, 1'b1);
+
+
+initial begin
+    $dumpfile("cpu_rvc_tb.vcd");
+    $dumpvars(0, cpu_rvc_tb);
+
+    // Initialize Inputs
+    instr_in = 32'h0000_0013;
+
+    #10;
+
+    //////////////////////////////////////////////////////////////
+    // 32-bit Instructions
+    //////////////////////////////////////////////////////////////
+
+    `TEST("cpu_rvc", "Pass through LUI x2, 0x12345");
+    instr_in = 32'h1234_5137;
+    #10;
+    `EXPECT("Instruction unchanged", instr, 32'h1234_5137);
+    `EXPECT("compressed should be 0", compressed, 1'b0);
+    `EXPECT("illegal should be 0", illegal, 1'b0);
+
+    //////////////////////////////////////////////////////////////
+    // Compressed Instructions
+    //////////////////////////////////////////////////////////////
+
+    `TEST_C("Expand C.ADDI4SPN x8, sp, 16", 16'h0800, 32'h01010413)
+    `TEST_C("Expand C.ADDI4SPN x15, sp, 1020", 16'h1ffc, 32'h3fc10793)
+    `TEST_C("Expand C.LW x9, 4(x10)", 16'h4144, 32'h00452483)
+    `TEST_C("Expand C.LW x15, 124(x8)", 16'h5c7c, 32'h07c42783)
+    `TEST_C("Expand C.SW x9, 64(x10)", 16'hc124, 32'h04952023)
+    `TEST_C("Expand C.NOP", 16'h0001, 32'h00000013)
+    `TEST_C("Expand C.ADDI x5, -3", 16'h12f5, 32'hffd28293)
+    `TEST_C("Expand C.LI x6, 31", 16'h437d, 32'h01f00313)
+    `TEST_C("Expand C.LI x6, -32", 16'h5301, 32'hfe000313)
+    `TEST_C("Expand C.LUI x7, 0x1f", 16'h63fd, 32'h0001f3b7)
+    `TEST_C("Expand C.LUI x7, 0xfffe0", 16'h7381, 32'hfffe03b7)
+    `TEST_C("Expand C.ADDI16SP -64", 16'h7139, 32'hfc010113)
+    `TEST_C("Expand C.ADDI16SP 496", 16'h617d, 32'h1f010113)
+    `TEST_C("Expand C.SRLI x8, 3", 16'h800d, 32'h00345413)
+    `TEST_C("Expand C.SRAI x9, 31", 16'h84fd, 32'h41f4d493)
+    `TEST_C("Expand C.ANDI x10, -1", 16'h997d, 32'hfff57513)
+    `TEST_C("Expand C.SUB x8, x9", 16'h8c05, 32'h40940433)
+    `TEST_C("Expand C.XOR x8, x9", 16'h8c25, 32'h00944433)
+    `TEST_C("Expand C.OR x8, x9", 16'h8c45, 32'h00946433)
+    `TEST_C("Expand C.AND x8, x9", 16'h8c65, 32'h00947433)
+    `TEST_C("Expand C.J 0", 16'ha001, 32'h0000006f)
+    `TEST_C("Expand C.J -4", 16'hbff5, 32'hffdff06f)
+    `TEST_C("Expand C.J 2046", 16'haffd, 32'h7fe0006f)
+    `TEST_C("Expand C.J -2048", 16'hb001, 32'h801ff06f)
+    `TEST_C("Expand C.BEQZ x8, -8", 16'hdc65, 32'hfe040ce3)
+    `TEST_C("Expand C.BNEZ x9, 254", 16'hecfd, 32'h0e049f63)
+    `TEST_C("Expand C.BNEZ x9, -256", 16'hf081, 32'hf00490e3)
+    `TEST_C("Expand C.SLLI x5, 1", 16'h0286, 32'h00129293)
+    `TEST_C("Expand C.LWSP x1, 252", 16'h50fe, 32'h0fc12083)
+    `TEST_C("Expand C.SWSP x1, 124", 16'hde86, 32'h06112e23)
+    `TEST_C("Expand C.SWSP x31, 252", 16'hdffe, 32'h0ff12e23)
+    `TEST_C("Expand C.JR x1", 16'h8082, 32'h00008067)
+    `TEST_C("Expand C.MV x5, x6", 16'h829a, 32'h006002b3)
+    `TEST_C("Expand C.EBREAK", 16'h9002, 32'h00100073)
+    `TEST_C("Expand C.JALR x5", 16'h9282, 32'h000280e7)
+    `TEST_C("Expand C.ADD x5, x6", 16'h929a, 32'h006282b3)
+
+    if (XLEN == 32) begin
+        `TEST_C("Expand C.JAL 2046", 16'h2ffd, 32'h7fe000ef)
+        `TEST_C("Expand C.JAL -2", 16'h3ffd, 32'hfffff0ef)
+    end else begin
+        `TEST_C("Expand C.ADDIW x5, -1", 16'h32fd, 32'hfff2829b)
+        `TEST_C("Expand C.LD x9, 248(x10)", 16'h7d64, 32'h0f853483)
+        `TEST_C("Expand C.SD x9, 8(x10)", 16'he504, 32'h00953423)
+        `TEST_C("Expand C.LDSP x1, 504", 16'h70fe, 32'h1f813083)
+        `TEST_C("Expand C.SDSP x1, 504", 16'hff86, 32'h1e113c23)
+        `TEST_C("Expand C.SUBW x8, x9", 16'h9c05, 32'h4094043b)
+        `TEST_C("Expand C.ADDW x8, x9", 16'h9c25, 32'h0094043b)
+        `TEST_C("Expand C.SLLI x5, 33", 16'h1286, 32'h02129293)
+        `TEST_C("Expand C.SRLI x8, 40", 16'h9021, 32'h02845413)
+    end
+
+    //////////////////////////////////////////////////////////////
+    // Illegal Instructions
+    //////////////////////////////////////////////////////////////
+
+    `TEST_ILLEGAL("Illegal All zero parcel", 16'h0000)
+    `TEST_ILLEGAL("Illegal C.ADDI4SPN with zero immediate", 16'h0004)
+    `TEST_ILLEGAL("Illegal C.FLD", 16'h2000)
+    `TEST_ILLEGAL("Illegal C.LWSP x0", 16'h4012)
+    `TEST_ILLEGAL("Illegal C.JR x0", 16'h8002)
+    `TEST_ILLEGAL("Illegal C.ADDI16SP 0", 16'h6101)
+    `TEST_ILLEGAL("Illegal C.LUI x7, 0", 16'h6381)
+    `TEST_ILLEGAL("Illegal C.FSDSP", 16'ha002)
+
+    if (XLEN == 32) begin
+        `TEST_ILLEGAL("Illegal C.FLW", 16'h6000)
+        `TEST_ILLEGAL("Illegal C.SRLI with shamt 32", 16'h9001)
+        `TEST_ILLEGAL("Illegal C.ADDW", 16'h9c25)
+    end else begin
+        `TEST_ILLEGAL("Illegal C.ADDIW x0", 16'h2005)
+        `TEST_ILLEGAL("Illegal Reserved CA encoding", 16'h9c45)
+    end
+
+    //////////////////////////////////////////////////////////////
+    // Finalizing Testbench
+    //////////////////////////////////////////////////////////////
+
+    `FINISH;
+    end
+
+endmodule
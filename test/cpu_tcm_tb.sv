@@ -0,0 +1,234 @@
+`timescale 1ns / 1ps
+`default_nettype none
+
+// `define LOG_TCM
+
+`include "cpu_tcm.sv"
+
+`ifndef XLEN
+`define XLEN 32
+`endif
+
+module cpu_tcm_tb;
+`include "test/test_macros.sv"
+
+// ====================================
+// Parameters
+// ====================================
+localparam XLEN  = `XLEN;
+localparam BYTES = XLEN / 8;
+localparam SIZE  = 256;
+localparam BASE  = 32'h0010_0000;
+
+// ====================================
+// Clock and Reset
+// ====================================
+reg clk;
+reg reset;
+
+initial begin
+    clk = 0;
+    forever #5 clk = ~clk; // 100MHz clock
+end
+
+// ====================================
+// CPU Side
+// ====================================
+reg                  cpu_ready;
+reg                  cpu_fetch;
+reg                  cpu_bypass;
+reg [XLEN-1:0]       cpu_address;
+reg [XLEN-1:0]       cpu_wdata;
+reg [2:0]            cpu_size;
+reg                  cpu_read;
+wire                 cpu_ack;
+wire [XLEN-1:0]      cpu_rdata;
+wire                 cpu_denied;
+wire                 cpu_corrupt;
+wire                 cpu_valid;
+
+// ====================================
+// Bus Side
+// ====================================
+wire                 if_ready;
+wire                 if_fetch;
+wire [XLEN-1:0]      if_address;
+wire [XLEN-1:0]      if_wdata;
+wire [XLEN/8-1:0]    if_wstrb;
+wire [2:0]           if_size;
+wire                 if_read;
+reg                  if_ack;
+reg  [XLEN-1:0]      if_rdata;
+reg                  if_denied;
+reg                  if_corrupt;
+reg                  if_valid;
+
+wire [XLEN-1:0]      access_count;
+
+cpu_tcm #(
+    .XLEN(XLEN),
+    .SIZE(SIZE),
+    .BASE(BASE)
+) uut (
+    .clk         (clk),
+    .reset       (reset),
+    .cpu_ready   (cpu_ready),
+    .cpu_fetch   (cpu_fetch),
+    .cpu_bypass  (cpu_bypass),
+    .cpu_address (cpu_address),
+    .cpu_wdata   (cpu_wdata),
+    .cpu_wstrb   ({(XLEN/8){1'b0}}),
+    .cpu_size    (cpu_size),
+    .cpu_read    (cpu_read),
+    .cpu_ack     (cpu_ack),
+    .cpu_rdata   (cpu_rdata),
+    .cpu_denied  (cpu_denied),
+    .cpu_corrupt (cpu_corrupt),
+    .cpu_valid   (cpu_valid),
+    .if_ready    (if_ready),
+    .if_fetch    (if_fetch),
+    .if_address  (if_address),
+    .if_wdata    (if_wdata),
+    .if_wstrb    (if_wstrb),
+    .if_size     (if_size),
+    .if_read     (if_read),
+    .if_ack      (if_ack),
+    .if_rdata    (if_rdata),
+    .if_denied   (if_denied),
+    .if_corrupt  (if_corrupt),
+    .if_valid    (if_valid),
+    .access_count(access_count)
+);
+
+// ====================================
+// Slow bus model, reads return the address and everything is denied inside the TCM window
+// ====================================
+integer bus_requests;
+
+initial begin
+    if_ack       = 0;
+    if_valid     = 0;
+    if_rdata     = 0;
+    if_denied    = 0;
+    if_corrupt   = 0;
+    bus_requests = 0;
+    forever begin
+        @(posedge clk);
+        if (if_ready && !if_ack) begin
+            bus_requests = bus_requests + 1;
+            if_ack    <= 1;
+            if_rdata  <= if_address;
+            if_denied <= ((if_address & ~(SIZE - 1)) == BASE);
+            @(posedge clk);
+            if_ack <= 0;
+            repeat (6) @(posedge clk);
+            if_valid <= 1;
+            @(posedge clk);
+            if_valid  <= 0;
+            if_denied <= 0;
+        end
+    end
+end
+
+// ====================================
+// CPU access, same handshake as the tl_cpu load/store states
+// ====================================
+reg [XLEN-1:0] result;
+reg            denied;
+integer        cycles;
+
+task automatic Access(input [XLEN-1:0] address, input is_read, input [2:0] size,
+                      input [XLEN-1:0] data, input is_fetch);
+    begin
+        @(posedge clk);
+        cycles      = 0;
+        cpu_ready   <= 1;
+        cpu_fetch   <= is_fetch;
+        cpu_read    <= is_read;
+        cpu_size    <= size;
+        cpu_address <= address;
+        cpu_wdata   <= data;
+        @(posedge clk);
+        while (!cpu_ack) begin
+            @(posedge clk);
+            cycles = cycles + 1;
+        end
+        cpu_ready   <= 0;
+        while (!cpu_valid) begin
+            @(posedge clk);
+            cycles = cycles + 1;
+        end
+        result = cpu_rdata;
+        denied = cpu_denied;
+        cpu_fetch   <= 0;
+    end
+endtask
+
+initial begin
+    $dumpfile("cpu_tcm_tb.vcd");
+    $dumpvars(0, cpu_tcm_tb);
+
+    reset       = 1;
+    cpu_ready   = 0;
+    cpu_fetch   = 0;
+    cpu_bypass  = 0;
+    cpu_read    = 0;
+    cpu_size    = 3'b010;
+    cpu_address = 0;
+    cpu_wdata   = 0;
+    repeat (2) @(posedge clk);
+    reset = 0;
+
+    `TEST("cpu_tcm", "Local stores and loads do not use the bus");
+    Access(BASE + 'h10, 0, 3'b010, 'h1122_3344, 0);
+    `EXPECT("Store completes locally", cycles < 3, 1);
+    Access(BASE + 'h10, 1, 3'b010, 0, 0);
+    `EXPECT("Load completes locally", cycles < 3, 1);
+    `EXPECT("Data", result[31:0], 32'h1122_3344);
+    `EXPECT("Denied", denied, 0);
+    `EXPECT("Bus requests", bus_requests, 0);
+    `EXPECT("Accesses", access_count, 2);
+
+    `TEST("cpu_tcm", "Byte and halfword accesses use their lanes");
+    Access(BASE + 'h11, 0, 3'b000, 'hAA, 0);
+    Access(BASE + 'h12, 1, 3'b001, 0, 0);
+    `EXPECT("Upper halfword", result, 'h1122);
+    Access(BASE + 'h11, 1, 3'b000, 0, 0);
+    `EXPECT("Stored byte", result, 'hAA);
+    Access(BASE + 'h10, 1, 3'b010, 0, 0);
+    `EXPECT("Merged word", result[31:0], 32'h1122_AA44);
+    `EXPECT("Bus requests", bus_requests, 0);
+
+    `TEST("cpu_tcm", "Addresses outside the window are passed through");
+    Access('h0000_0F00, 1, 3'b010, 0, 0);
+    `EXPECT("Bus data", result, 'h0F00);
+    `EXPECT("Bus requests", bus_requests, 1);
+    `EXPECT("Slow bus", cycles > 4, 1);
+    Access(BASE + SIZE, 1, 3'b010, 0, 0);
+    `EXPECT("Address past the window", bus_requests, 2);
+
+    `TEST("cpu_tcm", "Fetches and bypassed requests are passed through");
+    Access(BASE + 'h10, 1, 3'b010, 0, 1);
+    `EXPECT("Fetch reaches the bus", bus_requests, 3);
+    cpu_bypass = 1;
+    Access(BASE + 'h10, 0, 3'b010, 'h5555_5555, 0);
+    cpu_bypass = 0;
+    `EXPECT("Bypass reaches the bus", bus_requests, 4);
+    `EXPECT("Bus denies the window", denied, 1);
+    Access(BASE + 'h10, 1, 3'b010, 0, 0);
+    `EXPECT("TCM unchanged", result[31:0], 32'h1122_AA44);
+    `EXPECT("Bus requests", bus_requests, 4);
+
+    if (XLEN == 64) begin
+    `TEST("cpu_tcm", "Doubleword accesses");
+    Access(BASE + 'h20, 0, 3'b011, 'h0123_4567_89AB_CDEF, 0);
+    Access(BASE + 'h20, 1, 3'b011, 0, 0);
+    `EXPECT("Data", result, 'h0123_4567_89AB_CDEF);
+    Access(BASE + 'h24, 1, 3'b010, 0, 0);
+    `EXPECT("Upper word", result, 'h0123_4567);
+    end
+
+    `FINISH;
+end
+
+endmodule
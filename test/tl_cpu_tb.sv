@@ -4,7 +4,11 @@
 `define DEBUG // Turn on debugging ports
 // `define LOG_MEMORY
 
+`ifdef PIPELINED
+`include "tl_cpu_pipe.sv"
+`else
 `include "tl_cpu.sv"
+`endif
 `include "tl_memory.sv"
 
 `ifndef XLEN
@@ -63,20 +67,31 @@ wire [31:0]             cpu_x3;
 wire                    cpu_halt;
 wire                    cpu_trap;
 
+// Interrupts
+reg                     cpu_timer;
+initial cpu_timer = 1'b0;
+
 // ====================================
 // Instantiate the CPU (TileLink Master)
 // The CPU includes the cpu_mem_interface internally with the timing fix.
 // ====================================
+`ifdef PIPELINED
+tl_cpu_pipe #(
+`else
 tl_cpu #(
+`endif
     .XLEN(XLEN),
     .START_ADDRESS(32'h0000_0000) // force start address to 0
 ) uut (
     .clk(clk),
     .reset(reset),
 
-    // No interrupts in this test
-    // .external_irq(),
-    // .external_nmi(),
+    `ifdef SUPPORT_ZICSR
+    // Only the timer interrupt is driven, by the wfi test
+    .external_irq(1'b0),
+    .external_nmi(1'b0),
+    .external_timer(cpu_timer),
+    `endif
 
     // TileLink A Channel
     .tl_a_valid(tl_a_valid),
@@ -115,7 +130,8 @@ tl_memory #(
     .XLEN(XLEN),
     .WIDTH(MEM_WIDTH),
     .SID_WIDTH(SID_WIDTH),
-    .SIZE(MEM_SIZE)
+    .SIZE(MEM_SIZE),
+    .ATOMICS(1)
 ) mock_mem (
     .clk          (clk),
     .reset        (reset),
@@ -814,6 +830,142 @@ initial begin
     // `EXPECT("Verify memory 0x001E", `GET_BYTE_FROM_MEM(mock_mem.block_ram_inst.memory, MEM_WIDTH, 'h001E), 8'h00)
     // `EXPECT("Verify memory 0x001F", `GET_BYTE_FROM_MEM(mock_mem.block_ram_inst.memory, MEM_WIDTH, 'h001F), 8'h00)
 
+    `TEST("tl_cpu.sv", "Loop with a backward branch around a call and return")
+    mock_mem.block_ram_inst.memory['h0000] = 32'h00500093; // addi x1, x0, 5
+    mock_mem.block_ram_inst.memory['h0001] = 32'h00000113; // addi x2, x0, 0
+    mock_mem.block_ram_inst.memory['h0002] = 32'h010001EF; // jal x3, +16         (Loop)
+    mock_mem.block_ram_inst.memory['h0003] = 32'hFFF08093; // addi x1, x1, -1
+    mock_mem.block_ram_inst.memory['h0004] = 32'hFE009CE3; // bne x1, x0, -8
+    mock_mem.block_ram_inst.memory['h0005] = 32'h0000006F; // jal x0, 0
+    mock_mem.block_ram_inst.memory['h0006] = 32'h00310113; // addi x2, x2, 3      (Call target)
+    mock_mem.block_ram_inst.memory['h0007] = 32'h00018067; // jalr x0, 0(x3)
+
+    @(posedge clk);
+    reset = 0;
+    wait (cpu_halt == 1 || cpu_trap == 1);
+
+    `EXPECT("Verify x1 register", cpu_x1, 32'h0000_0000)
+    `EXPECT("Verify x2 register", cpu_x2, 32'h0000_000F)
+    `EXPECT("Verify x3 register", cpu_x3, 32'h0000_000C)
+    `EXPECT("Verify PC", cpu_pc, 32'h0000_0014)
+
+    reset = 1;
+    #10; // Hold reset for 10ns
+    @(posedge clk);
+
+    `ifdef SUPPORT_ZICSR
+    `ifndef PIPELINED
+    // ====================================
+    // Wait for interrupt
+    // ====================================
+    $display("\n==\n== Verify wfi\n==");
+
+    `TEST("tl_cpu.sv", "wfi waits without fetching until the timer interrupt is pending")
+    mock_mem.block_ram_inst.memory['h0000] = 32'h00000113; // addi x2, x0, 0
+    mock_mem.block_ram_inst.memory['h0001] = 32'h08000093; // addi x1, x0, 0x80
+    mock_mem.block_ram_inst.memory['h0002] = 32'h3040A073; // csrs mie, x1         (MTIE)
+    mock_mem.block_ram_inst.memory['h0003] = 32'h10500073; // wfi
+    mock_mem.block_ram_inst.memory['h0004] = 32'h00100113; // addi x2, x0, 1
+    mock_mem.block_ram_inst.memory['h0005] = 32'h0000006F; // jal x0, 0
+
+    @(posedge clk);
+    reset = 0;
+    #2000;
+
+    `EXPECT("Verify PC is on the wfi", cpu_pc, 32'h0000_000C)
+    `EXPECT("Verify x2 register", cpu_x2, 32'h0000_0000)
+    `EXPECT("Verify no bus request", tl_a_valid, 1'b0)
+
+    cpu_timer = 1'b1;
+    wait (cpu_halt == 1 || cpu_trap == 1);
+    cpu_timer = 1'b0;
+
+    `EXPECT("Verify x2 register", cpu_x2, 32'h0000_0001)
+    `EXPECT("Verify PC", cpu_pc, 32'h0000_0014)
+
+    reset = 1;
+    #10; // Hold reset for 10ns
+    @(posedge clk);
+    `endif
+    `endif
+
+    `ifdef SUPPORT_ZAAMO
+    `ifndef PIPELINED
+    // ====================================
+    // Atomic memory operations
+    // ====================================
+    $display("\n==\n== Verify amoadd.w and amomaxu.w\n==");
+
+    `TEST("tl_cpu.sv", "AMOs write the old value to rd and the result to memory")
+    mock_mem.block_ram_inst.memory['h0000] = 32'h10000093; // addi x1, x0, 0x100
+    mock_mem.block_ram_inst.memory['h0001] = 32'h00500113; // addi x2, x0, 5
+    mock_mem.block_ram_inst.memory['h0002] = 32'h0020A023; // sw x2, 0(x1)
+    mock_mem.block_ram_inst.memory['h0003] = 32'h00300113; // addi x2, x0, 3
+    mock_mem.block_ram_inst.memory['h0004] = 32'h0020A1AF; // amoadd.w x3, x2, (x1)
+    mock_mem.block_ram_inst.memory['h0005] = 32'h0000A103; // lw x2, 0(x1)
+    mock_mem.block_ram_inst.memory['h0006] = 32'hFFF00113; // addi x2, x0, -1
+    mock_mem.block_ram_inst.memory['h0007] = 32'hE020A1AF; // amomaxu.w x3, x2, (x1)
+    mock_mem.block_ram_inst.memory['h0008] = 32'h0000A103; // lw x2, 0(x1)
+    mock_mem.block_ram_inst.memory['h0009] = 32'h0000006F; // jal x0, 0
+
+    @(posedge clk);
+    reset = 0;
+    wait (cpu_halt == 1 || cpu_trap == 1);
+
+    `EXPECT("Verify x1 register", cpu_x1, 32'h0000_0100)
+    `EXPECT("Verify x2 register", cpu_x2, 32'hFFFF_FFFF)
+    `EXPECT("Verify x3 register", cpu_x3, 32'h0000_0008)
+    `EXPECT("Verify PC", cpu_pc, 32'h0000_0024)
+
+    reset = 1;
+    #10; // Hold reset for 10ns
+    @(posedge clk);
+    `endif
+    `endif
+
+    `ifdef SUPPORT_C
+    // ====================================
+    // Compressed instructions
+    // ====================================
+    $display("\n==\n== Verify compressed instructions\n==");
+
+    `TEST("tl_cpu.sv", "Compressed instructions and a 32-bit instruction across a word boundary")
+    mock_mem.block_ram_inst.memory['h0000] = 32'h008D4095; // c.li x1, 5 ; c.addi x1, 3
+    mock_mem.block_ram_inst.memory['h0001] = 32'h01938106; // c.mv x2, x1 ; addi x3, x0, 7 (low half)
+    mock_mem.block_ram_inst.memory['h0002] = 32'hA0010070; // addi x3, x0, 7 (high half) ; c.j 0
+
+    @(posedge clk);
+    reset = 0;
+    wait (cpu_halt == 1 || cpu_trap == 1);
+
+    `EXPECT("Verify x1 register", cpu_x1, 32'h0000_0008)
+    `EXPECT("Verify x2 register", cpu_x2, 32'h0000_0008)
+    `EXPECT("Verify x3 register", cpu_x3, 32'h0000_0007)
+    `EXPECT("Verify PC", cpu_pc, 32'h0000_000A)
+
+    reset = 1;
+    #10; // Hold reset for 10ns
+    @(posedge clk);
+
+    `TEST("tl_cpu.sv", "Branch back to the upper half of a word")
+    mock_mem.block_ram_inst.memory['h0000] = 32'h4101408D; // c.li x1, 3 ; c.li x2, 0
+    mock_mem.block_ram_inst.memory['h0001] = 32'h10FD0001; // c.nop ; c.addi x1, -1 (Branch target)
+    mock_mem.block_ram_inst.memory['h0002] = 32'h9EE30109; // c.addi x2, 2 ; bne x1, x0, -4 (low half)
+    mock_mem.block_ram_inst.memory['h0003] = 32'hA001FE00; // bne x1, x0, -4 (high half) ; c.j 0
+
+    @(posedge clk);
+    reset = 0;
+    wait (cpu_halt == 1 || cpu_trap == 1);
+
+    `EXPECT("Verify x1 register", cpu_x1, 32'h0000_0000)
+    `EXPECT("Verify x2 register", cpu_x2, 32'h0000_0006)
+    `EXPECT("Verify PC", cpu_pc, 32'h0000_000E)
+
+    reset = 1;
+    #10; // Hold reset for 10ns
+    @(posedge clk);
+    `endif
+
     `FINISH;
 end
 
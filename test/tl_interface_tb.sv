@@ -12,6 +12,10 @@
 `define XLEN 32
 `endif
 
+`ifndef TL_OUTSTANDING
+`define TL_OUTSTANDING 1
+`endif
+
 module tl_interface_tb;
 `include "test/test_macros.sv"
 
@@ -23,6 +27,7 @@ parameter SID_WIDTH = 2;     // Source ID length for TileLink
 parameter MEM_SIZE = 4096;   // Memory size (supports addresses up to 0x0FFF)
 parameter MAX_RETRIES = 3;   // Maximum number of retry attempts
 parameter MEM_WIDTH = 8;
+parameter MAX_OUTSTANDING = `TL_OUTSTANDING;
 
 // ====================================
 // Clock and Reset
@@ -46,6 +51,8 @@ reg [XLEN-1:0]       cpu_wdata;
 reg [XLEN/8-1:0]     cpu_wstrb;
 reg [2:0]            cpu_size;     // 0:byte, 1:halfword, 2:word, 3:doubleword
 reg                  cpu_read;
+reg [2:0]            cpu_amo_opcode;
+reg [2:0]            cpu_amo_param;
 wire [XLEN-1:0]      cpu_rdata;
 wire                 cpu_valid;
 wire                 cpu_ack;
@@ -92,7 +99,8 @@ reg [XLEN-1:0] dbg_denied_write_address;
 tl_interface #(
     .XLEN(XLEN),
     .SID_WIDTH(SID_WIDTH),
-    .MAX_RETRIES(MAX_RETRIES)
+    .MAX_RETRIES(MAX_RETRIES),
+    .MAX_OUTSTANDING(MAX_OUTSTANDING)
 ) dut (
     .clk(clk),
     .reset(reset),
@@ -104,6 +112,8 @@ tl_interface #(
     .cpu_wstrb(cpu_wstrb),
     .cpu_size(cpu_size),
     .cpu_read(cpu_read),
+    .cpu_amo_opcode(cpu_amo_opcode),
+    .cpu_amo_param(cpu_amo_param),
     .cpu_rdata(cpu_rdata),
     .cpu_valid(cpu_valid),
     .cpu_ack(cpu_ack),
@@ -140,7 +150,8 @@ tl_memory #(
     .XLEN(XLEN),
     .WIDTH(MEM_WIDTH),
     .SID_WIDTH(SID_WIDTH),
-    .SIZE(MEM_SIZE)
+    .SIZE(MEM_SIZE),
+    .ATOMICS(1)
 ) mock_mem (
     .clk        (clk),
     .reset      (reset),
@@ -174,6 +185,130 @@ tl_memory #(
     .dbg_denied_write_address(dbg_denied_write_address)
 );
 
+// ====================================
+// Out of order responder: a second interface whose slave collects two requests and answers them
+// in reverse order. Read data is the address xor OOO_PATTERN.
+// ====================================
+localparam [XLEN-1:0] OOO_PATTERN = 'h5A5A_0000;
+
+reg                  ooo_ready;
+reg  [XLEN-1:0]      ooo_address;
+wire [XLEN-1:0]      ooo_rdata;
+wire                 ooo_valid;
+wire                 ooo_ack;
+wire                 ooo_denied;
+wire                 ooo_corrupt;
+
+wire                 ooo_a_valid;
+reg                  ooo_a_ready;
+wire [SID_WIDTH-1:0] ooo_a_source;
+wire [XLEN-1:0]      ooo_a_address;
+reg                  ooo_d_valid;
+wire                 ooo_d_ready;
+reg  [SID_WIDTH-1:0] ooo_d_source;
+reg  [XLEN-1:0]      ooo_d_data;
+
+tl_interface #(
+    .XLEN(XLEN),
+    .SID_WIDTH(SID_WIDTH),
+    .MAX_RETRIES(MAX_RETRIES),
+    .MAX_OUTSTANDING(4)
+) dut_ooo (
+    .clk(clk),
+    .reset(reset),
+
+    .cpu_ready(ooo_ready),
+    .cpu_address(ooo_address),
+    .cpu_wdata({XLEN{1'b0}}),
+    .cpu_wstrb({(XLEN/8){1'b0}}),
+    .cpu_size(3'b010),
+    .cpu_read(1'b1),
+    .cpu_amo_opcode(3'b000),
+    .cpu_amo_param(3'b000),
+    .cpu_rdata(ooo_rdata),
+    .cpu_valid(ooo_valid),
+    .cpu_ack(ooo_ack),
+    .cpu_denied(ooo_denied),
+    .cpu_corrupt(ooo_corrupt),
+
+    .tl_a_valid(ooo_a_valid),
+    .tl_a_ready(ooo_a_ready),
+    .tl_a_opcode(),
+    .tl_a_param(),
+    .tl_a_size(),
+    .tl_a_source(ooo_a_source),
+    .tl_a_address(ooo_a_address),
+    .tl_a_mask(),
+    .tl_a_data(),
+
+    .tl_d_valid(ooo_d_valid),
+    .tl_d_ready(ooo_d_ready),
+    .tl_d_opcode(3'b010),
+    .tl_d_param(2'b00),
+    .tl_d_size(3'b010),
+    .tl_d_source(ooo_d_source),
+    .tl_d_data(ooo_d_data),
+    .tl_d_corrupt(1'b0),
+    .tl_d_denied(1'b0),
+
+    .test()
+);
+
+reg [XLEN-1:0]      ooo_req_address [0:1];
+reg [SID_WIDTH-1:0] ooo_req_source  [0:1];
+
+initial begin
+    ooo_a_ready  = 1'b0;
+    ooo_d_valid  = 1'b0;
+    ooo_d_source = {SID_WIDTH{1'b0}};
+    ooo_d_data   = {XLEN{1'b0}};
+    forever begin
+        for (int n = 0; n < 2; n = n + 1) begin
+            @(posedge clk);
+            while (!ooo_a_valid) @(posedge clk);
+            ooo_req_address[n] = ooo_a_address;
+            ooo_req_source[n]  = ooo_a_source;
+            ooo_a_ready <= 1'b1;
+            @(posedge clk);
+            ooo_a_ready <= 1'b0;
+        end
+        for (int n = 1; n >= 0; n = n - 1) begin
+            @(posedge clk);
+            ooo_d_valid  <= 1'b1;
+            ooo_d_source <= ooo_req_source[n];
+            ooo_d_data   <= ooo_req_address[n] ^ OOO_PATTERN;
+            @(posedge clk);
+            while (!ooo_d_ready) @(posedge clk);
+            ooo_d_valid  <= 1'b0;
+        end
+    end
+end
+
+// ====================================
+// Response monitors, count responses and requests in flight
+// ====================================
+integer        resp_count;
+integer        inflight;
+integer        max_inflight;
+reg [XLEN-1:0] resp_data   [0:7];
+reg            resp_denied [0:7];
+integer        ooo_count;
+reg [XLEN-1:0] ooo_data    [0:1];
+
+always @(posedge clk) begin
+    if (cpu_valid) begin
+        resp_data[resp_count % 8]   = cpu_rdata;
+        resp_denied[resp_count % 8] = cpu_denied;
+        resp_count                  = resp_count + 1;
+    end
+    inflight = inflight + cpu_ack - cpu_valid;
+    if (inflight > max_inflight) max_inflight = inflight;
+    if (ooo_valid) begin
+        ooo_data[ooo_count % 2] = ooo_rdata;
+        ooo_count               = ooo_count + 1;
+    end
+end
+
 // ====================================
 // Testbench Tasks
 // ====================================
@@ -264,6 +399,64 @@ begin
 end
 endtask
 
+task AtomicData(
+    input [XLEN-1:0]   address,
+    input [2:0]        opcode,
+    input [2:0]        param,
+    input [XLEN-1:0]   value,
+    input [XLEN-1:0]   expected_value
+);
+begin
+    @(posedge clk);
+    // Drive an atomic word request, answered with the old value like a read
+    cpu_ready      = 1'b1;
+    cpu_read       = 1'b0;
+    cpu_amo_opcode = opcode;
+    cpu_amo_param  = param;
+    cpu_address    = address;
+    cpu_wstrb      = 4'b1111;
+    cpu_size       = 3'b010;
+    cpu_wdata      = value;
+
+    @(posedge clk);
+    wait (cpu_ack == 1'b1);
+    cpu_ready      = 1'b0;
+    cpu_amo_opcode = 3'b000;
+    cpu_amo_param  = 3'b000;
+
+    @(posedge clk);
+    wait (cpu_valid == 1'b1);
+
+    `EXPECT("Verify atomic old value", cpu_rdata, expected_value);
+    `EXPECT("Verify atomic cpu_denied", cpu_denied, 1'b0);
+
+    @(posedge clk);
+end
+endtask
+
+task IssueRequest(
+    input [XLEN-1:0]   address,
+    input              read,
+    input [2:0]        size,
+    input [XLEN/8-1:0] mask,
+    input [XLEN-1:0]   value
+);
+begin
+    @(posedge clk);
+    // Drive the request, but only wait for it to be acknowledged
+    cpu_ready    = 1'b1;
+    cpu_read     = read;
+    cpu_address  = address;
+    cpu_wstrb    = mask;
+    cpu_size     = size;
+    cpu_wdata    = value;
+
+    @(posedge clk);
+    wait (cpu_ack == 1'b1);
+    cpu_ready = 1'b0;
+end
+endtask
+
 // ====================================
 // Test Sequence
 // ====================================
@@ -273,9 +466,18 @@ initial begin
 
     test = 0;
 
+    resp_count   = 0;
+    inflight     = 0;
+    max_inflight = 0;
+    ooo_count    = 0;
+    ooo_ready    = 1'b0;
+    ooo_address  = {XLEN{1'b0}};
+
     // Initialize CPU Interface Signals
     cpu_ready    = 1'b0;
     cpu_read     = 1'b0;
+    cpu_amo_opcode = 3'b000;
+    cpu_amo_param  = 3'b000;
     cpu_address  = {XLEN{1'b0}};
     cpu_wdata    = {XLEN{1'b0}};
     cpu_wstrb    = {(XLEN/8){1'b0}};
@@ -517,6 +719,71 @@ initial begin
     WriteData(32'h24, 3'b010, 4'b1111, 32'hBADF00D, 0, 1); // Expect corrupt
     dbg_corrupt_write_address = {XLEN{1'b1}}; // Clear corrupt condition
 
+    // ====================================
+    // Test: Atomics, ArithmeticData (2) and LogicalData (3)
+    // ====================================
+    `TEST("tl_interface", "Atomic word operations return the old value");
+    WriteData(32'h50, 3'b010, 4'b1111, 32'h5, 0, 0);
+    AtomicData(32'h50, 3'b010, 3'd4, 32'h3, 'h5);               // ADD
+    ReadData(32'h50, 3'b010, 'h8, 0, 0);
+    AtomicData(32'h50, 3'b011, 3'd3, 32'hFFFF_FFFF, 'h8);       // SWAP
+    AtomicData(32'h50, 3'b010, 3'd0, 32'h2, 'hFFFF_FFFF);       // MIN keeps -1
+    AtomicData(32'h50, 3'b010, 3'd3, 32'h2, 'hFFFF_FFFF);       // MAXU keeps 0xFFFFFFFF
+    AtomicData(32'h50, 3'b010, 3'd1, 32'h2, 'hFFFF_FFFF);       // MAX takes 2
+    AtomicData(32'h50, 3'b011, 3'd1, 32'h10, 'h2);              // OR
+    AtomicData(32'h50, 3'b011, 3'd2, 32'h1F, 'h12);             // AND
+    AtomicData(32'h50, 3'b011, 3'd0, 32'h3, 'h12);              // XOR
+    ReadData(32'h50, 3'b010, 'h11, 0, 0);
+
+    // ====================================
+    // Test: Back to back requests
+    // ====================================
+    if (MAX_OUTSTANDING > 1) begin
+    `TEST("tl_interface", "Pipelined requests return in order");
+    resp_count   = 0;
+    max_inflight = 0;
+    IssueRequest(32'h40, 0, 3'b010, 15 << ('h40 % (XLEN/8)), 32'h11223344);
+    IssueRequest(32'h44, 0, 3'b010, 15 << ('h44 % (XLEN/8)), 32'h55667788);
+    IssueRequest(32'h40, 1, 3'b010, {XLEN/8{1'b1}}, 0);
+    IssueRequest(32'h44, 1, 3'b010, {XLEN/8{1'b1}}, 0);
+    IssueRequest(32'h41, 1, 3'b000, {XLEN/8{1'b1}}, 0);
+    IssueRequest(32'h46, 1, 3'b001, {XLEN/8{1'b1}}, 0);
+    IssueRequest(32'h42, 0, 3'b001, 3 << ('h42 % (XLEN/8)), 32'h7F);
+    IssueRequest(32'h48, 0, 3'b010, 4'b0110, 32'hBAD);
+    wait (resp_count == 8);
+    `EXPECT("Requests overlapped", max_inflight > 1, 1);
+    `EXPECT("Write word 0x40", resp_denied[0], 0);
+    `EXPECT("Write word 0x44", resp_denied[1], 0);
+    `EXPECT("Read word 0x40", resp_data[2], 'h11223344);
+    `EXPECT("Read word 0x44", resp_data[3], 'h55667788);
+    `EXPECT("Read byte 0x41", resp_data[4], 'h33);
+    `EXPECT("Read half-word 0x46", resp_data[5], 'h5566);
+    `EXPECT("Write half-word 0x42", resp_denied[6], 0);
+    `EXPECT("Invalid mask is denied", resp_denied[7], 1);
+    `EXPECT("Half-word at 0x42 is valid", `GET_BYTE_FROM_MEM(mock_mem.block_ram_inst.memory, MEM_WIDTH, 'h42), 'h7F);
+    end
+
+    // ====================================
+    // Test: Out of order responses
+    // ====================================
+    `TEST("tl_interface", "Out of order responses return in request order");
+    @(posedge clk);
+    ooo_ready   = 1'b1;
+    ooo_address = 32'h100;
+    @(posedge clk);
+    wait (ooo_ack == 1'b1);
+    ooo_ready   = 1'b0;
+    @(posedge clk);
+    ooo_ready   = 1'b1;
+    ooo_address = 32'h104;
+    @(posedge clk);
+    wait (ooo_ack == 1'b1);
+    ooo_ready   = 1'b0;
+    wait (ooo_count == 2);
+    `EXPECT("Distinct source IDs", ooo_req_source[0] != ooo_req_source[1], 1);
+    `EXPECT("First response", ooo_data[0], 32'h100 ^ OOO_PATTERN);
+    `EXPECT("Second response", ooo_data[1], 32'h104 ^ OOO_PATTERN);
+
     // ====================================
     // Finish Testbench
     // ====================================
@@ -0,0 +1,198 @@
+`timescale 1ns / 1ps
+`default_nettype none
+
+// `define LOG_MEMORY
+
+`include "tl_memory_dp.sv"
+
+`ifndef XLEN
+`define XLEN 32
+`endif
+
+module tl_memory_dp_tb;
+`include "test/test_macros.sv"
+
+// ====================================
+// Parameters
+// ====================================
+parameter XLEN = `XLEN;
+parameter SID_WIDTH = 2;
+parameter MEM_SIZE = 1024;
+
+// ====================================
+// Clock and Reset
+// ====================================
+reg clk;
+reg reset;
+
+initial begin
+    clk = 0;
+    forever #5 clk = ~clk; // 100MHz clock
+end
+
+integer cycle;
+always @(posedge clk) begin
+    if (reset) cycle <= 0;
+    else       cycle <= cycle + 1;
+end
+
+// ====================================
+// TileLink Ports, [0] instruction side, [1] data side
+// ====================================
+reg  [1:0]              tl_a_valid;
+wire [1:0]              tl_a_ready;
+reg  [2*3-1:0]          tl_a_opcode;
+reg  [2*3-1:0]          tl_a_param;
+reg  [2*3-1:0]          tl_a_size;
+reg  [2*SID_WIDTH-1:0]  tl_a_source;
+reg  [2*XLEN-1:0]       tl_a_address;
+reg  [2*(XLEN/8)-1:0]   tl_a_mask;
+reg  [2*XLEN-1:0]       tl_a_data;
+
+wire [1:0]              tl_d_valid;
+reg  [1:0]              tl_d_ready;
+wire [2*3-1:0]          tl_d_opcode;
+wire [2*2-1:0]          tl_d_param;
+wire [2*3-1:0]          tl_d_size;
+wire [2*SID_WIDTH-1:0]  tl_d_source;
+wire [2*XLEN-1:0]       tl_d_data;
+wire [1:0]              tl_d_corrupt;
+wire [1:0]              tl_d_denied;
+
+tl_memory_dp #(
+    .XLEN           (XLEN),
+    .SIZE           (MEM_SIZE),
+    .SID_WIDTH      (SID_WIDTH)
+) uut (
+    .clk            (clk),
+    .reset          (reset),
+    .tl_a_valid     (tl_a_valid),
+    .tl_a_ready     (tl_a_ready),
+    .tl_a_opcode    (tl_a_opcode),
+    .tl_a_param     (tl_a_param),
+    .tl_a_size      (tl_a_size),
+    .tl_a_source    (tl_a_source),
+    .tl_a_address   (tl_a_address),
+    .tl_a_mask      (tl_a_mask),
+    .tl_a_data      (tl_a_data),
+    .tl_d_valid     (tl_d_valid),
+    .tl_d_ready     (tl_d_ready),
+    .tl_d_opcode    (tl_d_opcode),
+    .tl_d_param     (tl_d_param),
+    .tl_d_size      (tl_d_size),
+    .tl_d_source    (tl_d_source),
+    .tl_d_data      (tl_d_data),
+    .tl_d_corrupt   (tl_d_corrupt),
+    .tl_d_denied    (tl_d_denied)
+);
+
+// ====================================
+// One request on one port. The signals are driven with non-blocking assignments so the
+// handshake is sampled on the clock edge the memory sees it.
+// ====================================
+reg [XLEN-1:0] result      [0:1];
+reg            result_err  [0:1];
+integer        accept_cycle[0:1];
+integer        done_cycle  [0:1];
+
+task automatic Access(input integer port, input is_read, input [XLEN-1:0] address,
+                      input [2:0] size, input [XLEN/8-1:0] mask, input [XLEN-1:0] data);
+    begin
+        @(posedge clk);
+        tl_a_valid[port]                          <= 1'b1;
+        tl_a_opcode[port*3 +: 3]                  <= is_read ? 3'b100 : 3'b000;
+        tl_a_size[port*3 +: 3]                    <= size;
+        tl_a_source[port*SID_WIDTH +: SID_WIDTH]  <= port;
+        tl_a_address[port*XLEN +: XLEN]           <= address;
+        tl_a_mask[port*(XLEN/8) +: XLEN/8]        <= mask;
+        tl_a_data[port*XLEN +: XLEN]              <= data;
+        @(posedge clk);
+        while (!tl_a_ready[port]) @(posedge clk);
+        accept_cycle[port] = cycle;
+        tl_a_valid[port] <= 1'b0;
+        @(posedge clk);
+        while (!tl_d_valid[port]) @(posedge clk);
+        done_cycle[port]  = cycle;
+        result[port]      = tl_d_data[port*XLEN +: XLEN];
+        result_err[port]  = tl_d_denied[port];
+        `EXPECT("Source", tl_d_source[port*SID_WIDTH +: SID_WIDTH], port[SID_WIDTH-1:0])
+        tl_d_ready[port] <= 1'b1;
+        @(posedge clk);
+        tl_d_ready[port] <= 1'b0;
+    end
+endtask
+
+initial begin
+    $dumpfile("tl_memory_dp_tb.vcd");
+    $dumpvars(0, tl_memory_dp_tb);
+
+    reset        = 1;
+    tl_a_valid   = 0;
+    tl_a_opcode  = 0;
+    tl_a_param   = 0;
+    tl_a_size    = 0;
+    tl_a_source  = 0;
+    tl_a_address = 0;
+    tl_a_mask    = 0;
+    tl_a_data    = 0;
+    tl_d_ready   = 0;
+    for (int i = 0; i < MEM_SIZE; i++) begin
+        `SET_BYTE_IN_MEM(uut.block_ram_inst.memory, XLEN, i, i);
+    end
+    repeat (2) @(posedge clk);
+    reset = 0;
+
+    `TEST("tl_memory_dp", "Fetch and store proceed in the same cycle");
+    fork
+        Access(0, 1, 'h40, 3'b010, 0, 0);
+        Access(1, 0, 'h80, 3'b010, 4'b1111, 'hCAFE_F00D);
+    join
+    `EXPECT("Fetched word", result[0][31:0], 32'h4342_4140)
+    `EXPECT("Store acknowledged", result_err[1], 1'b0)
+    `EXPECT("Accepted together", accept_cycle[0], accept_cycle[1])
+    `EXPECT("Answered together", done_cycle[0], done_cycle[1])
+    `EXPECT("Answered the cycle after the request", done_cycle[0] - accept_cycle[0] <= 2, 1)
+    `EXPECT("Stored byte 0x80", `GET_BYTE_FROM_MEM(uut.block_ram_inst.memory, XLEN, 'h80), 8'h0D)
+    `EXPECT("Stored byte 0x83", `GET_BYTE_FROM_MEM(uut.block_ram_inst.memory, XLEN, 'h83), 8'hCA)
+
+    `TEST("tl_memory_dp", "Each port sees the other port's writes");
+    Access(0, 1, 'h80, 3'b010, 0, 0);
+    `EXPECT("Fetched store", result[0][31:0], 32'hCAFE_F00D)
+    Access(0, 0, 'h85, 3'b000, 4'b0010, 'h5A);
+    Access(1, 1, 'h84, 3'b010, 0, 0);
+    `EXPECT("Byte write keeps the rest of the word", result[1][31:0], 32'h8786_5A84)
+    Access(1, 1, 'h86, 3'b001, 0, 0);
+    `EXPECT("Half-word read", result[1], 'h8786)
+
+    `TEST("tl_memory_dp", "Back to back loads on one port while the other fetches");
+    fork
+        begin
+            Access(0, 1, 'h10, 3'b010, 0, 0);
+            `EXPECT("Fetch 0x10", result[0][31:0], 32'h1312_1110)
+            Access(0, 1, 'h14, 3'b010, 0, 0);
+            `EXPECT("Fetch 0x14", result[0][31:0], 32'h1716_1514)
+        end
+        begin
+            Access(1, 1, 'h21, 3'b000, 0, 0);
+            `EXPECT("Load 0x21", result[1], 'h21)
+            Access(1, 1, 'h22, 3'b001, 0, 0);
+            `EXPECT("Load 0x22", result[1], 'h2322)
+        end
+    join
+
+    `TEST("tl_memory_dp", "Bad requests are denied");
+    Access(1, 1, MEM_SIZE, 3'b010, 0, 0);
+    `EXPECT("Out of range", result_err[1], 1'b1)
+    Access(1, 1, 'h46, 3'b010, 0, 0);
+    `EXPECT("Across a bus word", result_err[1], 1'b1)
+    Access(1, 0, 'h48, 3'b001, 4'b0110, 'hFFFF);
+    `EXPECT("Bad mask", result_err[1], 1'b1)
+    `EXPECT("Byte 0x48 unchanged", `GET_BYTE_FROM_MEM(uut.block_ram_inst.memory, XLEN, 'h48), 8'h48)
+    Access(0, 1, 'h48, 3'b000, 0, 0);
+    `EXPECT("Port 0 still answers", result[0], 'h48)
+    `EXPECT("Not denied", result_err[0], 1'b0)
+
+    `FINISH;
+end
+
+endmodule
@@ -19,7 +19,18 @@ module tl_memory_tb;
 parameter XLEN = `XLEN;
 parameter SID_WIDTH = 2;     // Source ID length for TileLink
 parameter MEM_SIZE = 4096;   // Memory size (supports addresses up to 0x0FFF)
+`ifdef MEM_WIDE
+parameter MEM_WIDTH = XLEN;
+parameter BYTE_ENABLE = 1;
+`else
 parameter MEM_WIDTH = 8;
+parameter BYTE_ENABLE = 0;
+`endif
+`ifdef TL_BURST
+parameter BURST = 1;
+`else
+parameter BURST = 0;
+`endif
 
 // ====================================
 // Clock and Reset
@@ -74,7 +85,9 @@ tl_memory #(
     .XLEN(XLEN),
     .WIDTH(MEM_WIDTH),
     .SID_WIDTH(SID_WIDTH),
-    .SIZE(MEM_SIZE)
+    .SIZE(MEM_SIZE),
+    .BURST(BURST),
+    .BYTE_ENABLE(BYTE_ENABLE)
 ) mock_mem (
     .clk        (clk),
     .reset      (reset),
@@ -112,6 +125,9 @@ tl_memory #(
 // Testbench Tasks
 // ====================================
 
+// Cycles the last WriteData or ReadData waited for tl_d_valid after the A handshake
+integer response_cycles;
+
 // Task to perform a write operation directly via TileLink A and D channels
 task WriteData(
     input [XLEN-1:0]   address,
@@ -168,6 +184,7 @@ task WriteData(
             @(posedge clk);
             wait_cycles = wait_cycles + 1;
         end
+        response_cycles = wait_cycles;
         `ifdef LOG_MEMORY `LOG("test", ("Channel D is Valid")); `endif
 
         if (!tl_d_valid) begin
@@ -267,6 +284,7 @@ task ReadData(
             $display("\033[91mERROR: ReadData timeout waiting for tl_d_valid\033[0m");
             $stop;
         end
+        response_cycles = wait_cycles;
 
         // Verify the response
         if (expected_denied) begin
@@ -304,6 +322,145 @@ task ReadData(
     end
 endtask
 
+// Bus word of a burst, every 32 bit word holds seed + its word index in the burst
+function [XLEN-1:0] BurstBeat(input [31:0] seed, input integer beat);
+    integer w;
+    begin
+        BurstBeat = {XLEN{1'b0}};
+        for (w = 0; w < XLEN/32; w++) begin
+            BurstBeat[32*w +: 32] = seed + beat * (XLEN/32) + w;
+        end
+    end
+endfunction
+
+// Task to write a multi-beat burst, one A beat per bus word and a single D response. The beats
+// are streamed with tl_a_valid held high, and the signals are driven with non-blocking
+// assignments so the handshake is sampled on the clock edge the memory sees it.
+task BurstWrite(
+    input [XLEN-1:0]   address,
+    input [2:0]        size,
+    input [31:0]       seed,
+    input              expected_denied
+);
+    integer beats;
+    integer beat;
+    integer wait_cycles;
+
+    begin
+        beats = (1 << size) / (XLEN/8);
+        for (beat = 0; beat < beats; beat++) begin
+            tl_a_valid   <= 1'b1;
+            tl_a_opcode  <= 3'b000; // PUT_FULL_DATA_OPCODE
+            tl_a_param   <= 3'b000;
+            tl_a_size    <= size;
+            tl_a_source  <= 2'b01;
+            tl_a_address <= address;
+            tl_a_mask    <= {(XLEN/8){1'b1}};
+            tl_a_data    <= BurstBeat(seed, beat);
+
+            wait_cycles = 0;
+            @(posedge clk);
+            while (!tl_a_ready && wait_cycles < 100) begin
+                @(posedge clk);
+                wait_cycles = wait_cycles + 1;
+            end
+            if (!tl_a_ready) begin
+                $display("\033[91mERROR: BurstWrite timeout waiting for tl_a_ready on beat %0d\033[0m", beat);
+                $stop;
+            end
+        end
+        tl_a_valid <= 1'b0;
+
+        wait_cycles = 0;
+        while (!tl_d_valid && wait_cycles < 200) begin
+            @(posedge clk);
+            wait_cycles = wait_cycles + 1;
+        end
+        if (!tl_d_valid) begin
+            $display("\033[91mERROR: BurstWrite timeout waiting for tl_d_valid\033[0m");
+            $stop;
+        end
+
+        `EXPECT("BurstWrite: tl_d_denied", tl_d_denied, expected_denied);
+        `EXPECT("BurstWrite: tl_d_opcode", tl_d_opcode, expected_denied ? 3'b111 : 3'b000);
+        `EXPECT("BurstWrite: tl_d_size", tl_d_size, size);
+
+        tl_d_ready <= 1'b1;
+        @(posedge clk);
+        tl_d_ready <= 1'b0;
+
+        // Only one response for the whole burst
+        repeat (40) @(posedge clk);
+        `EXPECT("BurstWrite: single response", tl_d_valid, 1'b0);
+    end
+endtask
+
+// Task to read a multi-beat burst, one D beat per bus word
+task BurstRead(
+    input [XLEN-1:0]   address,
+    input [2:0]        size,
+    input [31:0]       seed,
+    input              expected_denied
+);
+    integer beats;
+    integer beat;
+    integer wait_cycles;
+
+    begin
+        beats = (1 << size) / (XLEN/8);
+        tl_a_valid   <= 1'b1;
+        tl_a_opcode  <= 3'b100; // GET_OPCODE
+        tl_a_param   <= 3'b000;
+        tl_a_size    <= size;
+        tl_a_source  <= 2'b10;
+        tl_a_address <= address;
+        tl_a_mask    <= {(XLEN/8){1'b0}};
+        tl_a_data    <= {XLEN{1'b0}};
+
+        wait_cycles = 0;
+        @(posedge clk);
+        while (!tl_a_ready && wait_cycles < 100) begin
+            @(posedge clk);
+            wait_cycles = wait_cycles + 1;
+        end
+        if (!tl_a_ready) begin
+            $display("\033[91mERROR: BurstRead timeout waiting for tl_a_ready\033[0m");
+            $stop;
+        end
+        tl_a_valid <= 1'b0;
+
+        for (beat = 0; beat < beats; beat++) begin
+            wait_cycles = 0;
+            @(posedge clk);
+            while (!tl_d_valid && wait_cycles < 200) begin
+                @(posedge clk);
+                wait_cycles = wait_cycles + 1;
+            end
+            if (!tl_d_valid) begin
+                $display("\033[91mERROR: BurstRead timeout waiting for tl_d_valid on beat %0d\033[0m", beat);
+                $stop;
+            end
+
+            `EXPECT("BurstRead: tl_d_denied", tl_d_denied, expected_denied);
+            `EXPECT("BurstRead: tl_d_size", tl_d_size, size);
+            if (expected_denied) begin
+                `EXPECT("BurstRead: tl_d_opcode", tl_d_opcode, 3'b111); // TL_ACCESS_ACK_ERROR
+            end else begin
+                `EXPECT("BurstRead: tl_d_opcode", tl_d_opcode, 3'b010); // TL_ACCESS_ACK_DATA
+                `EXPECT("BurstRead: tl_d_data", tl_d_data, BurstBeat(seed, beat));
+            end
+
+            tl_d_ready <= 1'b1;
+            @(posedge clk);
+            tl_d_ready <= 1'b0;
+        end
+
+        // No beats past the end of the burst
+        repeat (40) @(posedge clk);
+        `EXPECT("BurstRead: beat count", tl_d_valid, 1'b0);
+    end
+endtask
+
 // ====================================
 // Test Sequence
 // ====================================
@@ -574,6 +731,51 @@ initial begin
     WriteData(32'h24, 3'b010, 8'b11110000, 32'hBADF00D, 0, 1); // Expect corrupt
     dbg_corrupt_write_address = {XLEN{1'b1}}; // Clear corrupt condition
 
+    // ====================================
+    // Test: Wide memory
+    // ====================================
+    if (BYTE_ENABLE) begin
+        `TEST("memory", "Wide memory answers two cycles after the request");
+        WriteData(32'h40, 3'b010, 4'b1111, 32'hA1B2C3D4, 0, 0);
+        `EXPECT("Write response cycles", response_cycles <= 3, 1);
+        ReadData(32'h40, 3'b010, 32'hA1B2C3D4, 0, 0);
+        `EXPECT("Read response cycles", response_cycles <= 3, 1);
+
+        `TEST("memory", "Wide memory byte writes leave the rest of the word");
+        WriteData(32'h41, 3'b000, 4'b0010, 32'h0000005A, 0, 0);
+        ReadData(32'h40, 3'b010, 32'hA1B25AD4, 0, 0);
+        ReadData(32'h41, 3'b000, 32'h5A, 0, 0);
+
+        `TEST("memory", "Wide memory denies accesses across a bus word");
+        ReadData(XLEN/8 * 16 - 2, 3'b010, 'h0, 1, 0);
+        WriteData(XLEN/8 * 16 - 1, 3'b001, 4'b0011, 32'h0000BEEF, 1, 0);
+    end
+
+    // ====================================
+    // Test: Bursts
+    // ====================================
+    if (BURST) begin
+        `TEST("memory", "Burst write and read of a 16 byte line");
+        BurstWrite(32'h100, 3'b100, 32'hC0DE_0000, 0);
+        BurstRead(32'h100, 3'b100, 32'hC0DE_0000, 0);
+        ReadData(32'h108, 3'b010, 32'hC0DE_0002, 0, 0);
+        ReadData(32'h10C, 3'b010, 32'hC0DE_0003, 0, 0);
+
+        `TEST("memory", "Burst write and read of 32 bytes");
+        BurstWrite(32'h140, 3'b101, 32'hBEEF_0000, 0);
+        BurstRead(32'h140, 3'b101, 32'hBEEF_0000, 0);
+
+        `TEST("memory", "Single beats still work after a burst");
+        WriteData(32'h144, 3'b010, 8'b00001111, 32'h1234_5678, 0, 0);
+        ReadData(32'h144, 3'b010, 32'h1234_5678, 0, 0);
+
+        `TEST("memory", "Misaligned and out of range bursts are denied");
+        BurstRead(32'h104, 3'b100, 32'h0, 1);
+        BurstRead(MEM_SIZE, 3'b100, 32'h0, 1);
+        BurstWrite(32'h184, 3'b100, 32'hDEAD_0000, 1);
+        BurstRead(32'h100, 3'b100, 32'hC0DE_0000, 0);
+    end
+
     // ====================================
     // Finish Testbench
     // ====================================
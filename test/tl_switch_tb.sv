@@ -25,6 +25,26 @@ parameter SID_WIDTH = 8;     // Source ID length for TileLink (updated to match
 parameter MEM_SIZE = 4096;   // Memory size (supports addresses up to 0x0FFF)
 parameter MAX_RETRIES = 3;   // Maximum number of retry attempts
 parameter TRACK_DEPTH = 4;
+`ifdef SWITCH_CROSSBAR
+parameter CROSSBAR = 1;
+`else
+parameter CROSSBAR = 0;
+`endif
+`ifdef SWITCH_DECODE_MASK
+parameter DECODE_MASK = 1;
+`else
+parameter DECODE_MASK = 0;
+`endif
+`ifdef SWITCH_DECODE_REG
+parameter DECODE_REG = 1;
+`else
+parameter DECODE_REG = 0;
+`endif
+`ifdef TL_BURST
+parameter BURST = 1;
+`else
+parameter BURST = 0;
+`endif
 
 // ====================================
 // Clock and Reset
@@ -113,7 +133,7 @@ wire [XLEN-1:0]      switch_base_addr;
 wire [XLEN-1:0]      switch_addr_mask;
 
 assign switch_base_addr = 32'h0000_0000;
-assign switch_addr_mask = 32'h0000_1000; // Covers addresses 0x0000 to 0x0FFF
+assign switch_addr_mask = 32'h0000_0FFF; // Covers addresses 0x0000 to 0x0FFF
 
 wire [TRACK_DEPTH*SID_WIDTH-1:0] dbg_request_entry_source_id;
 wire [TRACK_DEPTH*SID_WIDTH-1:0] dbg_request_entry_master_idx;
@@ -129,7 +149,10 @@ tl_switch #(
     .NUM_OUTPUTS(1),
     .XLEN(XLEN),
     .SID_WIDTH(SID_WIDTH),
-    .TRACK_DEPTH(TRACK_DEPTH)
+    .TRACK_DEPTH(TRACK_DEPTH),
+    .CROSSBAR(CROSSBAR),
+    .DECODE_MASK(DECODE_MASK),
+    .DECODE_REG(DECODE_REG)
 ) switch_inst (
     .clk(clk),
     .reset(reset),
@@ -284,6 +307,371 @@ tl_memory #(
     .dbg_denied_write_address(dbg_denied_write_address)
 );
 
+// ====================================
+// 2x2 Crossbar: two tl_interface masters and two tl_memory slaves at 0x0000 and 0x1000
+// ====================================
+localparam XM = 2;
+
+reg  [XM-1:0]            xm_ready;
+reg  [XM*XLEN-1:0]       xm_address;
+reg  [XM*XLEN-1:0]       xm_wdata;
+reg  [XM*(XLEN/8)-1:0]   xm_wstrb;
+reg  [XM-1:0]            xm_read;
+wire [XM*XLEN-1:0]       xm_rdata;
+wire [XM-1:0]            xm_valid;
+wire [XM-1:0]            xm_ack;
+wire [XM-1:0]            xm_denied;
+wire [XM-1:0]            xm_corrupt;
+
+wire [XM-1:0]            xa_valid;
+wire [XM-1:0]            xa_ready;
+wire [XM*3-1:0]          xa_opcode;
+wire [XM*3-1:0]          xa_param;
+wire [XM*3-1:0]          xa_size;
+wire [XM*SID_WIDTH-1:0]  xa_source;
+wire [XM*XLEN-1:0]       xa_address;
+wire [XM*(XLEN/8)-1:0]   xa_mask;
+wire [XM*XLEN-1:0]       xa_data;
+wire [XM-1:0]            xd_valid;
+wire [XM-1:0]            xd_ready;
+wire [XM*3-1:0]          xd_opcode;
+wire [XM*2-1:0]          xd_param;
+wire [XM*3-1:0]          xd_size;
+wire [XM*SID_WIDTH-1:0]  xd_source;
+wire [XM*XLEN-1:0]       xd_data;
+wire [XM-1:0]            xd_corrupt;
+wire [XM-1:0]            xd_denied;
+
+wire [XM-1:0]            xs_a_valid;
+wire [XM-1:0]            xs_a_ready;
+wire [XM*3-1:0]          xs_a_opcode;
+wire [XM*3-1:0]          xs_a_param;
+wire [XM*3-1:0]          xs_a_size;
+wire [XM*SID_WIDTH-1:0]  xs_a_source;
+wire [XM*XLEN-1:0]       xs_a_address;
+wire [XM*(XLEN/8)-1:0]   xs_a_mask;
+wire [XM*XLEN-1:0]       xs_a_data;
+wire [XM-1:0]            xs_d_valid;
+wire [XM-1:0]            xs_d_ready;
+wire [XM*3-1:0]          xs_d_opcode;
+wire [XM*2-1:0]          xs_d_param;
+wire [XM*3-1:0]          xs_d_size;
+wire [XM*SID_WIDTH-1:0]  xs_d_source;
+wire [XM*XLEN-1:0]       xs_d_data;
+wire [XM-1:0]            xs_d_corrupt;
+wire [XM-1:0]            xs_d_denied;
+
+reg                      xstats_clear;
+wire [XM*32-1:0]         xstats_m_requests;
+wire [XM*32-1:0]         xstats_m_latency;
+wire [XM*32-1:0]         xstats_m_max_latency;
+wire [XM*32-1:0]         xstats_s_requests;
+wire [XM*32-1:0]         xstats_s_latency;
+wire [XM*32-1:0]         xstats_s_max_latency;
+wire [31:0]              xstats_track_used;
+wire [31:0]              xstats_track_max;
+
+wire [XLEN-1:0]          xs_base0 = 'h0000;
+wire [XLEN-1:0]          xs_base1 = 'h1000;
+wire [XLEN-1:0]          xs_mask  = 'h0FFF;
+
+tl_switch #(
+    .NUM_INPUTS(XM),
+    .NUM_OUTPUTS(XM),
+    .XLEN(XLEN),
+    .SID_WIDTH(SID_WIDTH),
+    .TRACK_DEPTH(TRACK_DEPTH),
+    .CROSSBAR(1),
+    .DECODE_MASK(DECODE_MASK),
+    .DECODE_REG(DECODE_REG),
+    .STATS(1)
+) xbar (
+    .clk(clk),
+    .reset(reset),
+
+    .a_valid(xa_valid),
+    .a_ready(xa_ready),
+    .a_opcode(xa_opcode),
+    .a_param(xa_param),
+    .a_size(xa_size),
+    .a_source(xa_source),
+    .a_address(xa_address),
+    .a_mask(xa_mask),
+    .a_data(xa_data),
+
+    .d_valid(xd_valid),
+    .d_ready(xd_ready),
+    .d_opcode(xd_opcode),
+    .d_param(xd_param),
+    .d_size(xd_size),
+    .d_source(xd_source),
+    .d_data(xd_data),
+    .d_corrupt(xd_corrupt),
+    .d_denied(xd_denied),
+
+    .s_a_valid(xs_a_valid),
+    .s_a_ready(xs_a_ready),
+    .s_a_opcode(xs_a_opcode),
+    .s_a_param(xs_a_param),
+    .s_a_size(xs_a_size),
+    .s_a_source(xs_a_source),
+    .s_a_address(xs_a_address),
+    .s_a_mask(xs_a_mask),
+    .s_a_data(xs_a_data),
+
+    .s_d_valid(xs_d_valid),
+    .s_d_ready(xs_d_ready),
+    .s_d_opcode(xs_d_opcode),
+    .s_d_param(xs_d_param),
+    .s_d_size(xs_d_size),
+    .s_d_source(xs_d_source),
+    .s_d_data(xs_d_data),
+    .s_d_corrupt(xs_d_corrupt),
+    .s_d_denied(xs_d_denied),
+
+    .base_addr({xs_base1, xs_base0}),
+    .addr_mask({xs_mask, xs_mask}),
+
+    .stats_clear(xstats_clear),
+    .stats_m_requests(xstats_m_requests),
+    .stats_m_latency(xstats_m_latency),
+    .stats_m_max_latency(xstats_m_max_latency),
+    .stats_s_requests(xstats_s_requests),
+    .stats_s_latency(xstats_s_latency),
+    .stats_s_max_latency(xstats_s_max_latency),
+    .stats_track_used(xstats_track_used),
+    .stats_track_max(xstats_track_max)
+);
+
+genvar xi;
+generate
+for (xi = 0; xi < XM; xi++) begin : xbar_port
+    tl_interface #(
+        .XLEN(XLEN),
+        .SID_WIDTH(SID_WIDTH),
+        .MAX_RETRIES(MAX_RETRIES)
+    ) master (
+        .clk(clk),
+        .reset(reset),
+
+        .cpu_ready(xm_ready[xi]),
+        .cpu_address(xm_address[xi*XLEN +: XLEN]),
+        .cpu_wdata(xm_wdata[xi*XLEN +: XLEN]),
+        .cpu_wstrb(xm_wstrb[xi*(XLEN/8) +: (XLEN/8)]),
+        .cpu_size(3'b010),
+        .cpu_read(xm_read[xi]),
+        .cpu_rdata(xm_rdata[xi*XLEN +: XLEN]),
+        .cpu_valid(xm_valid[xi]),
+        .cpu_ack(xm_ack[xi]),
+        .cpu_denied(xm_denied[xi]),
+        .cpu_corrupt(xm_corrupt[xi]),
+
+        .tl_a_valid(xa_valid[xi]),
+        .tl_a_ready(xa_ready[xi]),
+        .tl_a_opcode(xa_opcode[xi*3 +: 3]),
+        .tl_a_param(xa_param[xi*3 +: 3]),
+        .tl_a_size(xa_size[xi*3 +: 3]),
+        .tl_a_source(xa_source[xi*SID_WIDTH +: SID_WIDTH]),
+        .tl_a_address(xa_address[xi*XLEN +: XLEN]),
+        .tl_a_mask(xa_mask[xi*(XLEN/8) +: (XLEN/8)]),
+        .tl_a_data(xa_data[xi*XLEN +: XLEN]),
+
+        .tl_d_valid(xd_valid[xi]),
+        .tl_d_ready(xd_ready[xi]),
+        .tl_d_opcode(xd_opcode[xi*3 +: 3]),
+        .tl_d_param(xd_param[xi*2 +: 2]),
+        .tl_d_size(xd_size[xi*3 +: 3]),
+        .tl_d_source(xd_source[xi*SID_WIDTH +: SID_WIDTH]),
+        .tl_d_data(xd_data[xi*XLEN +: XLEN]),
+        .tl_d_corrupt(xd_corrupt[xi]),
+        .tl_d_denied(xd_denied[xi])
+    );
+
+    tl_memory #(
+        .XLEN(XLEN),
+        .SID_WIDTH(SID_WIDTH),
+        .SIZE(MEM_SIZE)
+    ) memory (
+        .clk        (clk),
+        .reset      (reset),
+
+        .tl_a_valid (xs_a_valid[xi]),
+        .tl_a_ready (xs_a_ready[xi]),
+        .tl_a_opcode(xs_a_opcode[xi*3 +: 3]),
+        .tl_a_param (xs_a_param[xi*3 +: 3]),
+        .tl_a_size  (xs_a_size[xi*3 +: 3]),
+        .tl_a_source(xs_a_source[xi*SID_WIDTH +: SID_WIDTH]),
+        .tl_a_address(xs_a_address[xi*XLEN +: XLEN]),
+        .tl_a_mask  (xs_a_mask[xi*(XLEN/8) +: (XLEN/8)]),
+        .tl_a_data  (xs_a_data[xi*XLEN +: XLEN]),
+
+        .tl_d_valid (xs_d_valid[xi]),
+        .tl_d_ready (xs_d_ready[xi]),
+        .tl_d_opcode(xs_d_opcode[xi*3 +: 3]),
+        .tl_d_param (xs_d_param[xi*2 +: 2]),
+        .tl_d_size  (xs_d_size[xi*3 +: 3]),
+        .tl_d_source(xs_d_source[xi*SID_WIDTH +: SID_WIDTH]),
+        .tl_d_data  (xs_d_data[xi*XLEN +: XLEN]),
+        .tl_d_corrupt(xs_d_corrupt[xi]),
+        .tl_d_denied (xs_d_denied[xi]),
+
+        .dbg_wait(1'b0),
+        .dbg_corrupt_read_address({XLEN{1'b1}}),
+        .dbg_denied_read_address({XLEN{1'b1}}),
+        .dbg_corrupt_write_address({XLEN{1'b1}}),
+        .dbg_denied_write_address({XLEN{1'b1}})
+    );
+end
+endgenerate
+
+// ====================================
+// Burst master driven by the testbench and one tl_memory slave at 0x0000
+// ====================================
+reg                  ba_valid;
+wire                 ba_ready;
+reg  [2:0]           ba_opcode;
+reg  [2:0]           ba_size;
+reg  [SID_WIDTH-1:0] ba_source;
+reg  [XLEN-1:0]      ba_address;
+reg  [XLEN/8-1:0]    ba_mask;
+reg  [XLEN-1:0]      ba_data;
+wire                 bd_valid;
+reg                  bd_ready;
+wire [2:0]           bd_opcode;
+wire [1:0]           bd_param;
+wire [2:0]           bd_size;
+wire [SID_WIDTH-1:0] bd_source;
+wire [XLEN-1:0]      bd_data;
+wire                 bd_corrupt;
+wire                 bd_denied;
+
+wire                 bs_a_valid;
+wire                 bs_a_ready;
+wire [2:0]           bs_a_opcode;
+wire [1:0]           bs_a_param;
+wire [2:0]           bs_a_size;
+wire [SID_WIDTH-1:0] bs_a_source;
+wire [XLEN-1:0]      bs_a_address;
+wire [XLEN/8-1:0]    bs_a_mask;
+wire [XLEN-1:0]      bs_a_data;
+wire                 bs_d_valid;
+wire                 bs_d_ready;
+wire [2:0]           bs_d_opcode;
+wire [1:0]           bs_d_param;
+wire [2:0]           bs_d_size;
+wire [SID_WIDTH-1:0] bs_d_source;
+wire [XLEN-1:0]      bs_d_data;
+wire                 bs_d_corrupt;
+wire                 bs_d_denied;
+
+wire [XLEN-1:0]      bs_base = 'h0000;
+wire [XLEN-1:0]      bs_mask = 'h0FFF;
+
+tl_switch #(
+    .NUM_INPUTS(1),
+    .NUM_OUTPUTS(1),
+    .XLEN(XLEN),
+    .SID_WIDTH(SID_WIDTH),
+    .TRACK_DEPTH(TRACK_DEPTH),
+    .CROSSBAR(CROSSBAR),
+    .DECODE_MASK(DECODE_MASK),
+    .DECODE_REG(DECODE_REG),
+    .BURST(BURST)
+) burst_switch (
+    .clk(clk),
+    .reset(reset),
+
+    .a_valid(ba_valid),
+    .a_ready(ba_ready),
+    .a_opcode(ba_opcode),
+    .a_param(3'b000),
+    .a_size(ba_size),
+    .a_source(ba_source),
+    .a_address(ba_address),
+    .a_mask(ba_mask),
+    .a_data(ba_data),
+
+    .d_valid(bd_valid),
+    .d_ready(bd_ready),
+    .d_opcode(bd_opcode),
+    .d_param(bd_param),
+    .d_size(bd_size),
+    .d_source(bd_source),
+    .d_data(bd_data),
+    .d_corrupt(bd_corrupt),
+    .d_denied(bd_denied),
+
+    .s_a_valid(bs_a_valid),
+    .s_a_ready(bs_a_ready),
+    .s_a_opcode(bs_a_opcode),
+    .s_a_param(bs_a_param),
+    .s_a_size(bs_a_size),
+    .s_a_source(bs_a_source),
+    .s_a_address(bs_a_address),
+    .s_a_mask(bs_a_mask),
+    .s_a_data(bs_a_data),
+
+    .s_d_valid(bs_d_valid),
+    .s_d_ready(bs_d_ready),
+    .s_d_opcode(bs_d_opcode),
+    .s_d_param(bs_d_param),
+    .s_d_size(bs_d_size),
+    .s_d_source(bs_d_source),
+    .s_d_data(bs_d_data),
+    .s_d_corrupt(bs_d_corrupt),
+    .s_d_denied(bs_d_denied),
+
+    .base_addr(bs_base),
+    .addr_mask(bs_mask)
+);
+
+tl_memory #(
+    .XLEN(XLEN),
+    .SID_WIDTH(SID_WIDTH),
+    .SIZE(MEM_SIZE),
+    .BURST(BURST)
+) burst_mem (
+    .clk        (clk),
+    .reset      (reset),
+
+    .tl_a_valid (bs_a_valid),
+    .tl_a_ready (bs_a_ready),
+    .tl_a_opcode(bs_a_opcode),
+    .tl_a_param ({1'b0, bs_a_param}),
+    .tl_a_size  (bs_a_size),
+    .tl_a_source(bs_a_source),
+    .tl_a_address(bs_a_address),
+    .tl_a_mask  (bs_a_mask),
+    .tl_a_data  (bs_a_data),
+
+    .tl_d_valid (bs_d_valid),
+    .tl_d_ready (bs_d_ready),
+    .tl_d_opcode(bs_d_opcode),
+    .tl_d_param (bs_d_param),
+    .tl_d_size  (bs_d_size),
+    .tl_d_source(bs_d_source),
+    .tl_d_data  (bs_d_data),
+    .tl_d_corrupt(bs_d_corrupt),
+    .tl_d_denied (bs_d_denied),
+
+    .dbg_wait(1'b0),
+    .dbg_corrupt_read_address({XLEN{1'b1}}),
+    .dbg_denied_read_address({XLEN{1'b1}}),
+    .dbg_corrupt_write_address({XLEN{1'b1}}),
+    .dbg_denied_write_address({XLEN{1'b1}})
+);
+
+// Cycle each slave last accepted a request
+integer xbar_cycle;
+integer xbar_accept [0:XM-1];
+initial xbar_cycle = 0;
+always @(posedge clk) begin
+    xbar_cycle = xbar_cycle + 1;
+    for (int i = 0; i < XM; i++) begin
+        if (xs_a_valid[i] && xs_a_ready[i]) xbar_accept[i] = xbar_cycle;
+    end
+end
+
 // ====================================
 // Helper Tasks
 // ====================================
@@ -375,12 +763,113 @@ begin
 end
 endtask
 
+// Task to perform a word access through one of the crossbar masters
+task automatic xbar_access (
+    input int          m,
+    input [XLEN-1:0]   address,
+    input              read,
+    input [XLEN-1:0]   value,
+    output [XLEN-1:0]  rdata,
+    output             denied
+);
+begin
+    @(posedge clk);
+    xm_ready[m]                      = 1'b1;
+    xm_read[m]                       = read;
+    xm_address[m*XLEN +: XLEN]       = address;
+    xm_wdata[m*XLEN +: XLEN]         = value;
+    xm_wstrb[m*(XLEN/8) +: (XLEN/8)] = 15 << (address % (XLEN/8));
+
+    @(posedge clk);
+    wait (xm_ack[m] == 1'b1);
+    xm_ready[m] = 1'b0;
+
+    @(posedge clk);
+    wait (xm_valid[m] == 1'b1);
+    rdata  = xm_rdata[m*XLEN +: XLEN];
+    denied = xm_denied[m];
+
+    @(posedge clk);
+end
+endtask
+
+// Bus word of a burst, every 32 bit word holds seed + its word index in the burst
+function automatic [XLEN-1:0] burst_word (input [31:0] seed, input int beat);
+    burst_word = {XLEN{1'b0}};
+    for (int w = 0; w < XLEN/32; w++) begin
+        burst_word[32*w +: 32] = seed + beat * (XLEN/32) + w;
+    end
+endfunction
+
+// Task to send one burst from the burst master. A Get returns one D beat per bus word, a
+// PutFullData sends one A beat per bus word and gets one D response. Signals are driven with
+// non-blocking assignments and sampled on the clock edge after they change.
+task automatic burst_access (
+    input [XLEN-1:0]   address,
+    input [2:0]        size,
+    input              read,
+    input [31:0]       seed,
+    output int         d_beats,
+    output int         d_errors,  // D beats with the wrong data or size
+    output             denied
+);
+    int beats;
+    int wait_cycles;
+begin
+    beats    = (1 << size) / (XLEN/8);
+    d_beats  = 0;
+    d_errors = 0;
+    denied   = 1'b0;
+
+    for (int beat = 0; beat < (read ? 1 : beats); beat++) begin
+        ba_valid   <= 1'b1;
+        ba_opcode  <= read ? 3'b100 : 3'b000;
+        ba_size    <= size;
+        ba_source  <= 'h3;
+        ba_address <= address;
+        ba_mask    <= {(XLEN/8){1'b1}};
+        ba_data    <= read ? {XLEN{1'b0}} : burst_word(seed, beat);
+        @(posedge clk);
+        while (!ba_ready) @(posedge clk);
+        ba_valid   <= 1'b0;
+        @(posedge clk);
+    end
+
+    // Collect D beats until the channel has been quiet for a while
+    wait_cycles = 0;
+    while (wait_cycles < 100) begin
+        @(posedge clk);
+        if (bd_valid) begin
+            if ((read && ~bd_denied && bd_data !== burst_word(seed, d_beats)) || bd_size !== size) begin
+                d_errors = d_errors + 1;
+            end
+            denied      = denied | bd_denied;
+            d_beats     = d_beats + 1;
+            wait_cycles = 0;
+            bd_ready   <= 1'b1;
+            @(posedge clk);
+            bd_ready   <= 1'b0;
+            while (bd_valid) @(posedge clk);
+        end else begin
+            wait_cycles = wait_cycles + 1;
+        end
+    end
+end
+endtask
+
 // Temporary variables and registers
 logic [XLEN-1:0] read_data;
 
 reg should_expect_denied;
 reg should_expect_corrupt;
 
+logic [XLEN-1:0] xbar_rdata [0:XM-1];
+logic            xbar_denied [0:XM-1];
+
+int              burst_beats;
+int              burst_errors;
+logic            burst_denied;
+
 // Declare Debug Signals
 reg [XLEN-1:0] dbg_corrupt_read_address;
 reg [XLEN-1:0] dbg_denied_read_address;
@@ -395,6 +884,24 @@ initial begin
     $dumpfile("tl_switch_tb.vcd");
     $dumpvars(0, tl_switch_tb);
 
+    // Initialize Crossbar Master Signals
+    xm_ready     = {XM{1'b0}};
+    xm_read      = {XM{1'b0}};
+    xm_address   = {(XM*XLEN){1'b0}};
+    xm_wdata     = {(XM*XLEN){1'b0}};
+    xm_wstrb     = {(XM*(XLEN/8)){1'b0}};
+    xstats_clear = 1'b0;
+
+    // Initialize Burst Master Signals
+    ba_valid     = 1'b0;
+    ba_opcode    = 3'b000;
+    ba_size      = 3'b000;
+    ba_source    = {SID_WIDTH{1'b0}};
+    ba_address   = {XLEN{1'b0}};
+    ba_mask      = {(XLEN/8){1'b0}};
+    ba_data      = {XLEN{1'b0}};
+    bd_ready     = 1'b0;
+
     // Initialize CPU Interface Signals
     cpu_ready    = 1'b0;
     cpu_read     = 1'b0;
@@ -629,6 +1136,117 @@ initial begin
     dbg_denied_write_address = {XLEN{1'b0}};
     @(posedge clk); // Allow clock cycle for reset to take effect
 
+    // ====================================
+    // Crossbar: requests to different slaves in parallel
+    // ====================================
+    `TEST("tl_switch", "Crossbar forwards to different slaves in parallel")
+    fork
+        xbar_access(0, 32'h0000_0010, 0, 32'h1111_2222, xbar_rdata[0], xbar_denied[0]);
+        xbar_access(1, 32'h0000_1010, 0, 32'h3333_4444, xbar_rdata[1], xbar_denied[1]);
+    join
+    `EXPECT("Write to slave 0", xbar_denied[0], 1'b0)
+    `EXPECT("Write to slave 1", xbar_denied[1], 1'b0)
+    `EXPECT("Slaves accepted in the same cycle", xbar_accept[0], xbar_accept[1])
+    fork
+        xbar_access(0, 32'h0000_1010, 1, 0, xbar_rdata[0], xbar_denied[0]);
+        xbar_access(1, 32'h0000_0010, 1, 0, xbar_rdata[1], xbar_denied[1]);
+    join
+    `EXPECT("Master 0 reads slave 1", xbar_rdata[0], 32'h3333_4444)
+    `EXPECT("Master 1 reads slave 0", xbar_rdata[1], 32'h1111_2222)
+    `EXPECT("Slaves accepted in the same cycle", xbar_accept[0], xbar_accept[1])
+
+    // ====================================
+    // Crossbar: both masters share one slave
+    // ====================================
+    `TEST("tl_switch", "Crossbar arbitrates masters on a shared slave")
+    fork
+        begin
+            xbar_access(0, 32'h0000_0020, 0, 32'hA0A0_0001, xbar_rdata[0], xbar_denied[0]);
+            xbar_access(0, 32'h0000_0024, 0, 32'hA0A0_0002, xbar_rdata[0], xbar_denied[0]);
+            xbar_access(0, 32'h0000_0028, 0, 32'hA0A0_0003, xbar_rdata[0], xbar_denied[0]);
+        end
+        begin
+            xbar_access(1, 32'h0000_0030, 0, 32'hB0B0_0001, xbar_rdata[1], xbar_denied[1]);
+            xbar_access(1, 32'h0000_0034, 0, 32'hB0B0_0002, xbar_rdata[1], xbar_denied[1]);
+            xbar_access(1, 32'h0000_0038, 0, 32'hB0B0_0003, xbar_rdata[1], xbar_denied[1]);
+        end
+    join
+    xbar_access(1, 32'h0000_0024, 1, 0, xbar_rdata[1], xbar_denied[1]);
+    `EXPECT("Master 0 write", xbar_rdata[1], 32'hA0A0_0002)
+    xbar_access(0, 32'h0000_0038, 1, 0, xbar_rdata[0], xbar_denied[0]);
+    `EXPECT("Master 1 write", xbar_rdata[0], 32'hB0B0_0003)
+
+    // ====================================
+    // Crossbar: unmapped address
+    // ====================================
+    `TEST("tl_switch", "Crossbar auto-responds to unmapped addresses")
+    xbar_access(1, 32'h0000_4000, 1, 0, xbar_rdata[1], xbar_denied[1]);
+    `EXPECT("Denied", xbar_denied[1], 1'b1)
+    `EXPECT("Read data", xbar_rdata[1], {XLEN{1'b0}})
+    xbar_access(1, 32'h0000_1010, 1, 0, xbar_rdata[1], xbar_denied[1]);
+    `EXPECT("Switch still routes", xbar_rdata[1], 32'h3333_4444)
+
+    // ====================================
+    // Crossbar: performance counters
+    // ====================================
+    `TEST("tl_switch", "Crossbar counts requests and latency")
+    `EXPECT("Master 0 counted", xstats_m_requests[31:0] != 0, 1'b1)
+    @(negedge clk);
+    xstats_clear = 1'b1;
+    @(negedge clk);
+    xstats_clear = 1'b0;
+    `EXPECT("Cleared requests", xstats_m_requests, {(XM*32){1'b0}})
+    `EXPECT("Cleared latency", xstats_s_latency, {(XM*32){1'b0}})
+    `EXPECT("Cleared high-water mark", xstats_track_max, 32'd0)
+    xbar_access(0, 32'h0000_1040, 0, 32'h5555_6666, xbar_rdata[0], xbar_denied[0]);
+    xbar_access(0, 32'h0000_1040, 1, 0, xbar_rdata[0], xbar_denied[0]);
+    xbar_access(1, 32'h0000_0040, 1, 0, xbar_rdata[1], xbar_denied[1]);
+    xbar_access(1, 32'h0000_4000, 1, 0, xbar_rdata[1], xbar_denied[1]);
+    repeat (2) @(posedge clk);
+    `EXPECT("Master 0 requests", xstats_m_requests[31:0], 32'd2)
+    `EXPECT("Master 1 requests, unmapped left out", xstats_m_requests[63:32], 32'd1)
+    `EXPECT("Slave 0 requests", xstats_s_requests[31:0], 32'd1)
+    `EXPECT("Slave 1 requests", xstats_s_requests[63:32], 32'd2)
+    `EXPECT("Slave 1 latency", xstats_s_latency[63:32], xstats_m_latency[31:0])
+    `EXPECT("Latency includes the slave", xstats_s_max_latency[63:32] >= 2, 1'b1)
+    `EXPECT("Latency sums the longest", xstats_s_latency[63:32] >= xstats_s_max_latency[63:32], 1'b1)
+    `EXPECT("Sum of two requests", xstats_s_latency[63:32] <= 2 * xstats_s_max_latency[63:32], 1'b1)
+    `EXPECT("Entries in use", xstats_track_used, 32'd0)
+    `EXPECT("High-water mark", xstats_track_max, 32'd1)
+
+    // ====================================
+    // Bursts
+    // ====================================
+    if (BURST) begin
+        `TEST("tl_switch", "Burst write and read of a 16 byte line")
+        burst_access(32'h0000_0100, 3'b100, 0, 32'hC0DE_0000, burst_beats, burst_errors, burst_denied);
+        `EXPECT("Write responses", burst_beats, 1)
+        `EXPECT("Write denied", burst_denied, 1'b0)
+        `EXPECT("Line in memory", burst_mem.block_ram_inst.memory[32'h0108], 8'h02)
+        burst_access(32'h0000_0100, 3'b100, 1, 32'hC0DE_0000, burst_beats, burst_errors, burst_denied);
+        `EXPECT("Read beats", burst_beats, 16 / (XLEN/8))
+        `EXPECT("Read beat errors", burst_errors, 0)
+        `EXPECT("Read denied", burst_denied, 1'b0)
+
+        `TEST("tl_switch", "Burst write and read of 64 bytes")
+        burst_access(32'h0000_0200, 3'b110, 0, 32'hBEEF_0000, burst_beats, burst_errors, burst_denied);
+        `EXPECT("Write responses", burst_beats, 1)
+        burst_access(32'h0000_0200, 3'b110, 1, 32'hBEEF_0000, burst_beats, burst_errors, burst_denied);
+        `EXPECT("Read beats", burst_beats, 64 / (XLEN/8))
+        `EXPECT("Read beat errors", burst_errors, 0)
+
+        `TEST("tl_switch", "Unmapped bursts are auto-responded")
+        burst_access(32'h0000_4000, 3'b100, 1, 0, burst_beats, burst_errors, burst_denied);
+        `EXPECT("Denied read beats", burst_beats, 16 / (XLEN/8))
+        `EXPECT("Denied", burst_denied, 1'b1)
+        burst_access(32'h0000_4000, 3'b100, 0, 32'hDEAD_0000, burst_beats, burst_errors, burst_denied);
+        `EXPECT("Denied write responses", burst_beats, 1)
+        `EXPECT("Denied", burst_denied, 1'b1)
+        burst_access(32'h0000_0100, 3'b100, 1, 32'hC0DE_0000, burst_beats, burst_errors, burst_denied);
+        `EXPECT("Switch still routes", burst_errors, 0)
+        `EXPECT("Read beats", burst_beats, 16 / (XLEN/8))
+    end
+
     // ====================================
     // Finish Testbench
     // ====================================
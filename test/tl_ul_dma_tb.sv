@@ -0,0 +1,449 @@
+`timescale 1ns / 1ps
+`default_nettype none
+
+`define DEBUG // Turn on debugging ports
+// `define LOG_MMIO
+// `define LOG_MEMORY
+
+`include "tl_ul_dma.sv"
+`include "tl_memory.sv"
+
+`ifndef XLEN
+`define XLEN 32
+`endif
+
+`include "log.sv"
+
+module tl_ul_dma_tb;
+`include "test/test_macros.sv"
+
+// ====================================
+// Parameters
+// ====================================
+parameter XLEN = `XLEN;
+parameter SID_WIDTH = 2;      // Source ID length for TileLink
+parameter MEM_SIZE = 'h100;   // Memory the DMA copies in, in bytes
+
+// ====================================
+// Clock and Reset
+// ====================================
+reg clk;
+reg reset;
+
+// Clock Generation: 100MHz Clock (10ns period)
+initial begin
+    clk = 0;
+    forever #5 clk = ~clk;
+end
+
+// ====================================
+// TileLink A Channel (Registers)
+// ====================================
+reg                     tl_a_valid;
+wire                    tl_a_ready;
+reg [2:0]               tl_a_opcode;
+reg [2:0]               tl_a_param;
+reg [2:0]               tl_a_size;
+reg [SID_WIDTH-1:0]     tl_a_source;
+reg [XLEN-1:0]          tl_a_address;
+reg [XLEN/8-1:0]        tl_a_mask;
+reg [XLEN-1:0]          tl_a_data;
+
+// ====================================
+// TileLink D Channel (Registers)
+// ====================================
+wire                    tl_d_valid;
+reg                     tl_d_ready;
+wire [2:0]              tl_d_opcode;
+wire [1:0]              tl_d_param;
+wire [2:0]              tl_d_size;
+wire [SID_WIDTH-1:0]    tl_d_source;
+wire [XLEN-1:0]         tl_d_data;
+wire                    tl_d_corrupt;
+wire                    tl_d_denied;
+
+// ====================================
+// TileLink Master (DMA to Memory)
+// ====================================
+wire                    m_a_valid;
+wire                    m_a_ready;
+wire [2:0]              m_a_opcode;
+wire [2:0]              m_a_param;
+wire [2:0]              m_a_size;
+wire [SID_WIDTH-1:0]    m_a_source;
+wire [XLEN-1:0]         m_a_address;
+wire [XLEN/8-1:0]       m_a_mask;
+wire [XLEN-1:0]         m_a_data;
+
+wire                    m_d_valid;
+wire                    m_d_ready;
+wire [2:0]              m_d_opcode;
+wire [1:0]              m_d_param;
+wire [2:0]              m_d_size;
+wire [SID_WIDTH-1:0]    m_d_source;
+wire [XLEN-1:0]         m_d_data;
+wire                    m_d_corrupt;
+wire                    m_d_denied;
+
+// ====================================
+// DMA
+// ====================================
+wire                    dma_irq;
+
+// Memory debug
+reg [XLEN-1:0]          dbg_denied_write_address;
+
+// ====================================
+// Instantiate DMA
+// ====================================
+tl_ul_dma #(
+    .XLEN(XLEN),
+    .SID_WIDTH(SID_WIDTH)
+) dma (
+    .clk         (clk),
+    .reset       (reset),
+
+    .irq         (dma_irq),
+
+    // TileLink A Channel (Registers)
+    .tl_a_valid  (tl_a_valid),
+    .tl_a_ready  (tl_a_ready),
+    .tl_a_opcode (tl_a_opcode),
+    .tl_a_param  (tl_a_param),
+    .tl_a_size   (tl_a_size),
+    .tl_a_source (tl_a_source),
+    .tl_a_address(tl_a_address),
+    .tl_a_mask   (tl_a_mask),
+    .tl_a_data   (tl_a_data),
+
+    // TileLink D Channel (Registers)
+    .tl_d_valid  (tl_d_valid),
+    .tl_d_ready  (tl_d_ready),
+    .tl_d_opcode (tl_d_opcode),
+    .tl_d_param  (tl_d_param),
+    .tl_d_size   (tl_d_size),
+    .tl_d_source (tl_d_source),
+    .tl_d_data   (tl_d_data),
+    .tl_d_corrupt(tl_d_corrupt),
+    .tl_d_denied (tl_d_denied),
+
+    // TileLink A Channel (Master)
+    .m_a_valid   (m_a_valid),
+    .m_a_ready   (m_a_ready),
+    .m_a_opcode  (m_a_opcode),
+    .m_a_param   (m_a_param),
+    .m_a_size    (m_a_size),
+    .m_a_source  (m_a_source),
+    .m_a_address (m_a_address),
+    .m_a_mask    (m_a_mask),
+    .m_a_data    (m_a_data),
+
+    // TileLink D Channel (Master)
+    .m_d_valid   (m_d_valid),
+    .m_d_ready   (m_d_ready),
+    .m_d_opcode  (m_d_opcode),
+    .m_d_param   (m_d_param),
+    .m_d_size    (m_d_size),
+    .m_d_source  (m_d_source),
+    .m_d_data    (m_d_data),
+    .m_d_corrupt (m_d_corrupt),
+    .m_d_denied  (m_d_denied)
+);
+
+// ====================================
+// Instantiate Memory
+// ====================================
+tl_memory #(
+    .XLEN(XLEN),
+    .SID_WIDTH(SID_WIDTH),
+    .SIZE(MEM_SIZE)
+) mock_mem (
+    .clk          (clk),
+    .reset        (reset),
+
+    // TileLink A Channel
+    .tl_a_valid   (m_a_valid),
+    .tl_a_ready   (m_a_ready),
+    .tl_a_opcode  (m_a_opcode),
+    .tl_a_param   (m_a_param),
+    .tl_a_size    (m_a_size),
+    .tl_a_source  (m_a_source),
+    .tl_a_address (m_a_address),
+    .tl_a_mask    (m_a_mask),
+    .tl_a_data    (m_a_data),
+
+    // TileLink D Channel
+    .tl_d_valid   (m_d_valid),
+    .tl_d_ready   (m_d_ready),
+    .tl_d_opcode  (m_d_opcode),
+    .tl_d_param   (m_d_param),
+    .tl_d_size    (m_d_size),
+    .tl_d_source  (m_d_source),
+    .tl_d_data    (m_d_data),
+    .tl_d_corrupt (m_d_corrupt),
+    .tl_d_denied  (m_d_denied),
+
+    // Debug inputs
+    .dbg_wait                 (1'b0),
+    .dbg_corrupt_read_address ({XLEN{1'b1}}),
+    .dbg_denied_read_address  ({XLEN{1'b1}}),
+    .dbg_corrupt_write_address({XLEN{1'b1}}),
+    .dbg_denied_write_address (dbg_denied_write_address)
+);
+
+// ====================================
+// Testbench Tasks
+// ====================================
+
+// Task to perform one request via the TileLink A and D channels, the response is kept in
+// last_opcode, last_denied and last_read
+reg [2:0]      last_opcode;
+reg            last_denied;
+reg [XLEN-1:0] last_read;
+task Access(
+    input              read,
+    input [XLEN-1:0]   address,
+    input [2:0]        size,
+    input [XLEN-1:0]   value
+);
+    integer wait_cycles;
+
+    begin
+        @(posedge clk);
+        // Drive TileLink A channel signals
+        tl_a_valid   = 1'b1;
+        tl_a_opcode  = read ? 3'b100 : 3'b000; // GET or PUT_FULL_DATA
+        tl_a_param   = 3'b000;
+        tl_a_size    = size;
+        tl_a_source  = 2'b01;
+        tl_a_address = address;
+        tl_a_mask    = {(XLEN/8){1'b1}};
+        tl_a_data    = value;
+
+        // Wait for tl_a_ready
+        wait_cycles = 0;
+        while (!tl_a_ready && wait_cycles < 100) begin
+            @(posedge clk);
+            wait_cycles = wait_cycles + 1;
+        end
+
+        if (!tl_a_ready) begin
+            $display("\033[91mERROR: Access timeout waiting for tl_a_ready\033[0m");
+            $stop;
+        end
+
+        // Handshake complete, deassert tl_a_valid
+        @(posedge clk);
+        tl_a_valid = 1'b0;
+
+        // Wait for D channel response
+        wait_cycles = 0;
+        while (!tl_d_valid && wait_cycles < 100) begin
+            @(posedge clk);
+            wait_cycles = wait_cycles + 1;
+        end
+
+        if (!tl_d_valid) begin
+            $display("\033[91mERROR: Access timeout waiting for tl_d_valid\033[0m");
+            $stop;
+        end
+
+        last_opcode = tl_d_opcode;
+        last_denied = tl_d_denied;
+        last_read   = tl_d_data;
+
+        // Assert tl_d_ready to acknowledge reception
+        tl_d_ready = 1'b1;
+
+        @(posedge clk);
+        tl_d_ready = 1'b0;
+
+        @(posedge clk);
+    end
+endtask
+
+// Task to poll STATUS until the transfer is no longer busy
+task WaitIdle;
+    integer polls;
+    begin
+        polls = 0;
+        Access(1'b1, 'h14, 3'd2, {XLEN{1'b0}});
+        while (last_read[0] && polls < 1000) begin
+            Access(1'b1, 'h14, 3'd2, {XLEN{1'b0}});
+            polls = polls + 1;
+        end
+
+        if (last_read[0]) begin
+            $display("\033[91mERROR: Timeout waiting for the transfer to finish\033[0m");
+            $stop;
+        end
+    end
+endtask
+
+`define WRITE(address, value) Access(1'b0, address, 3'd2, value)
+`define READ(address)         Access(1'b1, address, 3'd2, {XLEN{1'b0}})
+
+integer i;
+
+// ====================================
+// Test Sequence
+// ====================================
+initial begin
+    $dumpfile("tl_ul_dma_tb.vcd");
+    $dumpvars(0, tl_ul_dma_tb);
+
+    // Initialize Inputs
+    reset        = 1;
+    tl_a_valid   = 0;
+    tl_a_opcode  = 3'b000;
+    tl_a_param   = 3'b000;
+    tl_a_size    = 3'b000;
+    tl_a_source  = {SID_WIDTH{1'b0}};
+    tl_a_address = {XLEN{1'b0}};
+    tl_a_mask    = {(XLEN/8){1'b0}};
+    tl_a_data    = {XLEN{1'b0}};
+    tl_d_ready   = 0;
+    dbg_denied_write_address = {XLEN{1'b1}};
+
+    // Source bytes 0xA0 .. 0xAF at 0x10, the rest of the memory is zero
+    for (i = 0; i < MEM_SIZE; i = i + 1) begin
+        mock_mem.block_ram_inst.memory[i] = 8'h00;
+    end
+    for (i = 0; i < 16; i = i + 1) begin
+        mock_mem.block_ram_inst.memory['h10 + i] = 8'hA0 + i;
+    end
+
+    #20;
+    reset = 0;
+    @(posedge clk);
+
+    `TEST("tl_ul_dma", "DMA resets idle")
+    `READ('h14);
+    `EXPECT("STATUS", last_read[31:0], 32'h0000_0000)
+    `EXPECT("irq is low", dma_irq, 1'b0)
+
+    `TEST("tl_ul_dma", "Copy words memory to memory and raise irq")
+    `WRITE('h00, 'h0000_0010);
+    `WRITE('h04, 'h0000_0040);
+    `WRITE('h08, 'h0000_0002);
+    `WRITE('h10, 'h0000_0025); // START, SIZE=2, IRQ_EN
+    `EXPECT("Response is AccessAck", last_opcode, 3'b000)
+    wait (dma_irq == 1'b1);
+    `READ('h14);
+    `EXPECT("STATUS is DONE", last_read[31:0], 32'h0000_0002)
+    `READ('h08);
+    `EXPECT("LENGTH counted down", last_read[31:0], 32'h0000_0000)
+    `READ('h00);
+    `EXPECT("SRC moved", last_read[31:0], 32'h0000_0018)
+    `READ('h04);
+    `EXPECT("DST moved", last_read[31:0], 32'h0000_0048)
+    `EXPECT("Byte 0x40", mock_mem.block_ram_inst.memory['h40], 8'hA0)
+    `EXPECT("Byte 0x43", mock_mem.block_ram_inst.memory['h43], 8'hA3)
+    `EXPECT("Byte 0x47", mock_mem.block_ram_inst.memory['h47], 8'hA7)
+    `EXPECT("Byte 0x48", mock_mem.block_ram_inst.memory['h48], 8'h00)
+    `WRITE('h14, 'h0000_0002);
+    @(posedge clk);
+    `EXPECT("irq drops when DONE is cleared", dma_irq, 1'b0)
+
+    `TEST("tl_ul_dma", "Fixed destination streams bytes into one address")
+    `WRITE('h00, 'h0000_0010);
+    `WRITE('h04, 'h0000_0080);
+    `WRITE('h08, 'h0000_0004);
+    `WRITE('h10, 'h0000_0011); // START, SIZE=0, DST_FIXED
+    WaitIdle();
+    `EXPECT("STATUS is DONE", last_read[31:0], 32'h0000_0002)
+    `EXPECT("Last byte written", mock_mem.block_ram_inst.memory['h80], 8'hA3)
+    `EXPECT("Next byte untouched", mock_mem.block_ram_inst.memory['h81], 8'h00)
+    `READ('h04);
+    `EXPECT("DST did not move", last_read[31:0], 32'h0000_0080)
+    `WRITE('h14, 'h0000_0002);
+
+    `TEST("tl_ul_dma", "Source stride gathers every other byte")
+    `WRITE('h00, 'h0000_0010);
+    `WRITE('h04, 'h0000_0090);
+    `WRITE('h08, 'h0000_0004);
+    `WRITE('h0C, 'h0000_0002); // SRC stride 2, DST steps by the element size
+    `WRITE('h10, 'h0000_0001); // START, SIZE=0
+    WaitIdle();
+    `EXPECT("Byte 0x90", mock_mem.block_ram_inst.memory['h90], 8'hA0)
+    `EXPECT("Byte 0x91", mock_mem.block_ram_inst.memory['h91], 8'hA2)
+    `EXPECT("Byte 0x93", mock_mem.block_ram_inst.memory['h93], 8'hA6)
+    `WRITE('h0C, 'h0000_0000);
+    `WRITE('h14, 'h0000_0002);
+
+    `TEST("tl_ul_dma", "Misaligned start sets ERROR without a transfer")
+    `WRITE('h00, 'h0000_0011);
+    `WRITE('h04, 'h0000_00C0);
+    `WRITE('h08, 'h0000_0001);
+    `WRITE('h10, 'h0000_0005); // START, SIZE=2
+    `READ('h14);
+    `EXPECT("STATUS is ERROR", last_read[31:0], 32'h0000_0004)
+    `EXPECT("Destination untouched", mock_mem.block_ram_inst.memory['hC0], 8'h00)
+    `WRITE('h14, 'h0000_0004);
+
+    `TEST("tl_ul_dma", "Denied write stops with ERROR at the failing element")
+    dbg_denied_write_address = 'hA4;
+    `WRITE('h00, 'h0000_0010);
+    `WRITE('h04, 'h0000_00A0);
+    `WRITE('h08, 'h0000_0004);
+    `WRITE('h10, 'h0000_0005); // START, SIZE=2
+    WaitIdle();
+    `EXPECT("STATUS is ERROR", last_read[31:0], 32'h0000_0004)
+    `READ('h08);
+    `EXPECT("LENGTH left", last_read[31:0], 32'h0000_0003)
+    `READ('h04);
+    `EXPECT("DST at the failing element", last_read[31:0], 32'h0000_00A4)
+    `EXPECT("First element copied", mock_mem.block_ram_inst.memory['hA0], 8'hA0)
+    `WRITE('h14, 'h0000_0004);
+
+    `TEST("tl_ul_dma", "RETRY waits out a denying slave")
+    `WRITE('h00, 'h0000_0010);
+    `WRITE('h04, 'h0000_00A0);
+    `WRITE('h08, 'h0000_0004);
+    `WRITE('h10, 'h0000_0045); // START, SIZE=2, RETRY
+    repeat (200) @(posedge clk);
+    `READ('h14);
+    `EXPECT("Still BUSY", last_read[31:0], 32'h0000_0001)
+    `WRITE('h00, 'h0000_0000);
+    `EXPECT("Write to SRC while busy is denied", last_denied, 1'b1)
+    dbg_denied_write_address = {XLEN{1'b1}};
+    WaitIdle();
+    `EXPECT("STATUS is DONE", last_read[31:0], 32'h0000_0002)
+    `EXPECT("Byte 0xA4", mock_mem.block_ram_inst.memory['hA4], 8'hA4)
+    `EXPECT("Byte 0xAF", mock_mem.block_ram_inst.memory['hAF], 8'hAF)
+    `WRITE('h14, 'h0000_0002);
+
+    `TEST("tl_ul_dma", "Writing 0 to START stops a transfer")
+    `WRITE('h00, 'h0000_0010);
+    `WRITE('h04, 'h0000_00D0);
+    `WRITE('h08, 'h0000_0010);
+    `WRITE('h10, 'h0000_0001); // START, SIZE=0
+    `WRITE('h10, 'h0000_0000);
+    WaitIdle();
+    `EXPECT("Neither DONE nor ERROR", last_read[31:0], 32'h0000_0000)
+    `READ('h08);
+    `EXPECT("Elements left", (last_read[31:0] != 0 && last_read[31:0] < 32'h10), 1'b1)
+
+    `TEST("tl_ul_dma", "Register access must be aligned words")
+    Access(1'b1, 'h00, 3'd0, {XLEN{1'b0}});
+    `EXPECT("Byte read is denied", last_denied, 1'b1)
+    `EXPECT("Response is AccessAckError", last_opcode, 3'b111)
+    `WRITE('h18, 'h0000_0000);
+    `EXPECT("Write past STATUS is denied", last_denied, 1'b1)
+
+    if (XLEN == 64) begin
+        `TEST("tl_ul_dma", "Copy a double word")
+        `WRITE('h00, 'h0000_0010);
+        `WRITE('h04, 'h0000_00E0);
+        `WRITE('h08, 'h0000_0001);
+        `WRITE('h10, 'h0000_0007); // START, SIZE=3
+        WaitIdle();
+        `EXPECT("STATUS is DONE", last_read[31:0], 32'h0000_0002)
+        `EXPECT("Byte 0xE0", mock_mem.block_ram_inst.memory['hE0], 8'hA0)
+        `EXPECT("Byte 0xE7", mock_mem.block_ram_inst.memory['hE7], 8'hA7)
+    end
+
+    `FINISH;
+end
+
+endmodule
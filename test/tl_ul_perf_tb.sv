@@ -0,0 +1,339 @@
+`timescale 1ns / 1ps
+`default_nettype none
+
+// `define LOG_MMIO
+
+`include "tl_ul_perf.sv"
+
+`ifndef XLEN
+`define XLEN 32
+`endif
+
+`include "log.sv"
+
+module tl_ul_perf_tb;
+`include "test/test_macros.sv"
+
+// ====================================
+// Parameters
+// ====================================
+parameter XLEN = `XLEN;
+parameter SID_WIDTH = 2;      // Source ID length for TileLink
+parameter NUM_INPUTS = 2;     // Masters on the simulated switch
+parameter NUM_OUTPUTS = 3;    // Slaves on the simulated switch
+parameter TRACK_DEPTH = 4;    // Tracking entries of the simulated switch
+
+// ====================================
+// Clock and Reset
+// ====================================
+reg clk;
+reg reset;
+
+// Clock Generation: 100MHz Clock (10ns period)
+initial begin
+    clk = 0;
+    forever #5 clk = ~clk;
+end
+
+// ====================================
+// TileLink A Channel
+// ====================================
+reg                     tl_a_valid;
+wire                    tl_a_ready;
+reg [2:0]               tl_a_opcode;
+reg [2:0]               tl_a_param;
+reg [2:0]               tl_a_size;
+reg [SID_WIDTH-1:0]     tl_a_source;
+reg [XLEN-1:0]          tl_a_address;
+reg [XLEN/8-1:0]        tl_a_mask;
+reg [XLEN-1:0]          tl_a_data;
+
+// ====================================
+// TileLink D Channel
+// ====================================
+wire                    tl_d_valid;
+reg                     tl_d_ready;
+wire [2:0]              tl_d_opcode;
+wire [1:0]              tl_d_param;
+wire [2:0]              tl_d_size;
+wire [SID_WIDTH-1:0]    tl_d_source;
+wire [XLEN-1:0]         tl_d_data;
+wire                    tl_d_corrupt;
+wire                    tl_d_denied;
+
+// ====================================
+// Switch Counters
+// ====================================
+// Stand in for a tl_switch built with STATS, stats_clear zeroes them like the switch does
+wire                        stats_clear;
+reg [NUM_INPUTS*32-1:0]     stats_m_requests;
+reg [NUM_INPUTS*32-1:0]     stats_m_latency;
+reg [NUM_INPUTS*32-1:0]     stats_m_max_latency;
+reg [NUM_OUTPUTS*32-1:0]    stats_s_requests;
+reg [NUM_OUTPUTS*32-1:0]    stats_s_latency;
+reg [NUM_OUTPUTS*32-1:0]    stats_s_max_latency;
+reg [31:0]                  stats_track_used;
+reg [31:0]                  stats_track_max;
+integer                     clear_count;
+
+task FillCounters;
+    begin
+        for (int m = 0; m < NUM_INPUTS; m++) begin
+            stats_m_requests[m*32 +: 32]    = 32'hA1B2_C300 + m;
+            stats_m_latency[m*32 +: 32]     = 32'h0000_1000 + m;
+            stats_m_max_latency[m*32 +: 32] = 32'h0000_0020 + m;
+        end
+        for (int s = 0; s < NUM_OUTPUTS; s++) begin
+            stats_s_requests[s*32 +: 32]    = 32'h5000_0000 + s;
+            stats_s_latency[s*32 +: 32]     = 32'h0000_6000 + s;
+            stats_s_max_latency[s*32 +: 32] = 32'h0000_0070 + s;
+        end
+        stats_track_used = 32'd2;
+        stats_track_max  = 32'd3;
+    end
+endtask
+
+always @(posedge clk) begin
+    if (stats_clear) begin
+        stats_m_requests    <= {NUM_INPUTS*32{1'b0}};
+        stats_m_latency     <= {NUM_INPUTS*32{1'b0}};
+        stats_m_max_latency <= {NUM_INPUTS*32{1'b0}};
+        stats_s_requests    <= {NUM_OUTPUTS*32{1'b0}};
+        stats_s_latency     <= {NUM_OUTPUTS*32{1'b0}};
+        stats_s_max_latency <= {NUM_OUTPUTS*32{1'b0}};
+        stats_track_max     <= stats_track_used;
+        clear_count         <= clear_count + 1;
+    end
+end
+
+// ====================================
+// Instantiate Performance Counter Slave
+// ====================================
+tl_ul_perf #(
+    .XLEN(XLEN),
+    .SID_WIDTH(SID_WIDTH),
+    .NUM_INPUTS(NUM_INPUTS),
+    .NUM_OUTPUTS(NUM_OUTPUTS),
+    .TRACK_DEPTH(TRACK_DEPTH)
+) perf (
+    .clk                (clk),
+    .reset              (reset),
+
+    // Switch Counters
+    .stats_clear        (stats_clear),
+    .stats_m_requests   (stats_m_requests),
+    .stats_m_latency    (stats_m_latency),
+    .stats_m_max_latency(stats_m_max_latency),
+    .stats_s_requests   (stats_s_requests),
+    .stats_s_latency    (stats_s_latency),
+    .stats_s_max_latency(stats_s_max_latency),
+    .stats_track_used   (stats_track_used),
+    .stats_track_max    (stats_track_max),
+
+    // TileLink A Channel
+    .tl_a_valid  (tl_a_valid),
+    .tl_a_ready  (tl_a_ready),
+    .tl_a_opcode (tl_a_opcode),
+    .tl_a_param  (tl_a_param),
+    .tl_a_size   (tl_a_size),
+    .tl_a_source (tl_a_source),
+    .tl_a_address(tl_a_address),
+    .tl_a_mask   (tl_a_mask),
+    .tl_a_data   (tl_a_data),
+
+    // TileLink D Channel
+    .tl_d_valid  (tl_d_valid),
+    .tl_d_ready  (tl_d_ready),
+    .tl_d_opcode (tl_d_opcode),
+    .tl_d_param  (tl_d_param),
+    .tl_d_size   (tl_d_size),
+    .tl_d_source (tl_d_source),
+    .tl_d_data   (tl_d_data),
+    .tl_d_corrupt(tl_d_corrupt),
+    .tl_d_denied (tl_d_denied)
+);
+
+// ====================================
+// Testbench Tasks
+// ====================================
+
+// Task to perform one request via the TileLink A and D channels, the response is kept in
+// last_opcode, last_denied and last_read
+reg [2:0]      last_opcode;
+reg            last_denied;
+reg [XLEN-1:0] last_read;
+task Access(
+    input              read,
+    input [XLEN-1:0]   address,
+    input [2:0]        size,
+    input [XLEN-1:0]   value
+);
+    integer wait_cycles;
+
+    begin
+        @(posedge clk);
+        // Drive TileLink A channel signals
+        tl_a_valid   = 1'b1;
+        tl_a_opcode  = read ? 3'b100 : 3'b000; // GET or PUT_FULL_DATA
+        tl_a_param   = 3'b000;
+        tl_a_size    = size;
+        tl_a_source  = 2'b01;
+        tl_a_address = address;
+        tl_a_mask    = {(XLEN/8){1'b1}};
+        tl_a_data    = value;
+
+        // Wait for tl_a_ready
+        wait_cycles = 0;
+        while (!tl_a_ready && wait_cycles < 100) begin
+            @(posedge clk);
+            wait_cycles = wait_cycles + 1;
+        end
+
+        if (!tl_a_ready) begin
+            $display("\033[91mERROR: Access timeout waiting for tl_a_ready\033[0m");
+            $stop;
+        end
+
+        // Handshake complete, deassert tl_a_valid
+        @(posedge clk);
+        tl_a_valid = 1'b0;
+
+        // Wait for D channel response
+        wait_cycles = 0;
+        while (!tl_d_valid && wait_cycles < 100) begin
+            @(posedge clk);
+            wait_cycles = wait_cycles + 1;
+        end
+
+        if (!tl_d_valid) begin
+            $display("\033[91mERROR: Access timeout waiting for tl_d_valid\033[0m");
+            $stop;
+        end
+
+        last_opcode = tl_d_opcode;
+        last_denied = tl_d_denied;
+        last_read   = tl_d_data;
+
+        // Assert tl_d_ready to acknowledge reception
+        tl_d_ready = 1'b1;
+
+        @(posedge clk);
+        tl_d_ready = 1'b0;
+
+        @(posedge clk);
+    end
+endtask
+
+`define WRITE(address, size, value) Access(1'b0, address, size, value)
+`define READ(address, size)         Access(1'b1, address, size, {XLEN{1'b0}})
+
+// ====================================
+// Test Sequence
+// ====================================
+initial begin
+    $dumpfile("tl_ul_perf_tb.vcd");
+    $dumpvars(0, tl_ul_perf_tb);
+
+    // Initialize Inputs
+    reset        = 1;
+    tl_a_valid   = 0;
+    tl_a_opcode  = 3'b000;
+    tl_a_param   = 3'b000;
+    tl_a_size    = 3'b000;
+    tl_a_source  = {SID_WIDTH{1'b0}};
+    tl_a_address = {XLEN{1'b0}};
+    tl_a_mask    = {(XLEN/8){1'b0}};
+    tl_a_data    = {XLEN{1'b0}};
+    tl_d_ready   = 0;
+    clear_count  = 0;
+    FillCounters();
+
+    #20;
+    reset = 0;
+    @(posedge clk);
+
+    `TEST("tl_ul_perf", "CONTROL reports the switch size")
+    `READ('h000, 3'd2);
+    `EXPECT("Response is AccessAckData", last_opcode, 3'b010)
+    `EXPECT("CONTROL", last_read[31:0], 32'h0203_0004)
+    `READ('h004, 3'd2);
+    `EXPECT("TRACK_USED", last_read[31:0], 32'd2)
+    `READ('h008, 3'd2);
+    `EXPECT("TRACK_MAX", last_read[31:0], 32'd3)
+
+    `TEST("tl_ul_perf", "Master and slave counters")
+    `READ('h100, 3'd2);
+    `EXPECT("Master 0 REQUESTS", last_read[31:0], 32'hA1B2_C300)
+    `READ('h114, 3'd2);
+    `EXPECT("Master 1 LATENCY", last_read[31:0], 32'h0000_1001)
+    `READ('h118, 3'd2);
+    `EXPECT("Master 1 MAX_LATENCY", last_read[31:0], 32'h0000_0021)
+    `READ('h200, 3'd2);
+    `EXPECT("Slave 0 REQUESTS", last_read[31:0], 32'h5000_0000)
+    `READ('h224, 3'd2);
+    `EXPECT("Slave 2 LATENCY", last_read[31:0], 32'h0000_6002)
+    `READ('h228, 3'd2);
+    `EXPECT("Slave 2 MAX_LATENCY", last_read[31:0], 32'h0000_0072)
+
+    `TEST("tl_ul_perf", "Unused addresses read as zero")
+    `READ('h00C, 3'd2);
+    `EXPECT("After TRACK_MAX", last_read[31:0], 32'h0)
+    `READ('h10C, 3'd2);
+    `EXPECT("After master 0 MAX_LATENCY", last_read[31:0], 32'h0)
+    `READ('h120, 3'd2);
+    `EXPECT("No master 2", last_read[31:0], 32'h0)
+    `READ('h230, 3'd2);
+    `EXPECT("No slave 3", last_read[31:0], 32'h0)
+    `READ('h300, 3'd2);
+    `EXPECT("Past the slaves", last_read[31:0], 32'h0)
+
+    `TEST("tl_ul_perf", "Byte and halfword reads")
+    `READ('h101, 3'd0);
+    `EXPECT("Master 0 REQUESTS byte 1", last_read[7:0], 8'hC3)
+    `READ('h102, 3'd1);
+    `EXPECT("Master 0 REQUESTS upper half", last_read[15:0], 16'hA1B2)
+
+    `TEST("tl_ul_perf", "Writes other than CONTROL and misaligned accesses are denied")
+    `WRITE('h004, 3'd2, 'h0000_0000);
+    `EXPECT("Write to TRACK_USED is denied", last_denied, 1'b1)
+    `EXPECT("Response is AccessAckError", last_opcode, 3'b111)
+    `WRITE('h100, 3'd2, 'h0000_0000);
+    `EXPECT("Write to a counter is denied", last_denied, 1'b1)
+    `READ('h100, 3'd2);
+    `EXPECT("Master 0 REQUESTS not changed", last_read[31:0], 32'hA1B2_C300)
+    `READ('h102, 3'd2);
+    `EXPECT("Misaligned read is denied", last_denied, 1'b1)
+    `READ('h101, 3'd1);
+    `EXPECT("Misaligned halfword read is denied", last_denied, 1'b1)
+    `EXPECT("No counter was cleared", clear_count, 0)
+
+    `TEST("tl_ul_perf", "Writing CONTROL bit 0 clears the counters")
+    `WRITE('h000, 3'd2, 'h0000_0000);
+    `EXPECT("Response is AccessAck", last_opcode, 3'b000)
+    `EXPECT("Writing 0 does not clear", clear_count, 0)
+    `WRITE('h000, 3'd2, 'h0000_0001);
+    `EXPECT("Response is AccessAck", last_opcode, 3'b000)
+    `EXPECT("Not denied", last_denied, 1'b0)
+    `EXPECT("One clear pulse", clear_count, 1)
+    `READ('h100, 3'd2);
+    `EXPECT("Master 0 REQUESTS cleared", last_read[31:0], 32'h0)
+    `READ('h228, 3'd2);
+    `EXPECT("Slave 2 MAX_LATENCY cleared", last_read[31:0], 32'h0)
+    `READ('h008, 3'd2);
+    `EXPECT("TRACK_MAX restarts at TRACK_USED", last_read[31:0], 32'd2)
+    `READ('h000, 3'd2);
+    `EXPECT("CONTROL is not a counter", last_read[31:0], 32'h0203_0004)
+
+    if (XLEN == 64) begin
+        `TEST("tl_ul_perf", "64 bit reads return two registers")
+        FillCounters();
+        `READ('h110, 3'd3);
+        `EXPECT("Master 1 LATENCY and REQUESTS", last_read, 'h0000_1001_A1B2_C301)
+        `READ('h004, 3'd3);
+        `EXPECT("Misaligned 64 bit read is denied", last_denied, 1'b1)
+    end
+
+    `FINISH;
+end
+
+endmodule
@@ -0,0 +1,269 @@
+`timescale 1ns / 1ps
+`default_nettype none
+
+// `define LOG_MMIO
+
+`include "tl_ul_timer.sv"
+
+`ifndef XLEN
+`define XLEN 32
+`endif
+
+`include "log.sv"
+
+module tl_ul_timer_tb;
+`include "test/test_macros.sv"
+
+// ====================================
+// Parameters
+// ====================================
+parameter XLEN = `XLEN;
+parameter SID_WIDTH = 2;      // Source ID length for TileLink
+parameter DIVIDER = 4;        // mtime ticks every 4 clock cycles
+
+// ====================================
+// Clock and Reset
+// ====================================
+reg clk;
+reg reset;
+
+// Clock Generation: 100MHz Clock (10ns period)
+initial begin
+    clk = 0;
+    forever #5 clk = ~clk;
+end
+
+// ====================================
+// TileLink A Channel
+// ====================================
+reg                     tl_a_valid;
+wire                    tl_a_ready;
+reg [2:0]               tl_a_opcode;
+reg [2:0]               tl_a_param;
+reg [2:0]               tl_a_size;
+reg [SID_WIDTH-1:0]     tl_a_source;
+reg [XLEN-1:0]          tl_a_address;
+reg [XLEN/8-1:0]        tl_a_mask;
+reg [XLEN-1:0]          tl_a_data;
+
+// ====================================
+// TileLink D Channel
+// ====================================
+wire                    tl_d_valid;
+reg                     tl_d_ready;
+wire [2:0]              tl_d_opcode;
+wire [1:0]              tl_d_param;
+wire [2:0]              tl_d_size;
+wire [SID_WIDTH-1:0]    tl_d_source;
+wire [XLEN-1:0]         tl_d_data;
+wire                    tl_d_corrupt;
+wire                    tl_d_denied;
+
+// ====================================
+// Timer
+// ====================================
+wire                    timer_irq;
+
+// ====================================
+// Instantiate Timer
+// ====================================
+tl_ul_timer #(
+    .XLEN(XLEN),
+    .SID_WIDTH(SID_WIDTH),
+    .DIVIDER(DIVIDER)
+) timer (
+    .clk         (clk),
+    .reset       (reset),
+
+    .irq         (timer_irq),
+
+    // TileLink A Channel
+    .tl_a_valid  (tl_a_valid),
+    .tl_a_ready  (tl_a_ready),
+    .tl_a_opcode (tl_a_opcode),
+    .tl_a_param  (tl_a_param),
+    .tl_a_size   (tl_a_size),
+    .tl_a_source (tl_a_source),
+    .tl_a_address(tl_a_address),
+    .tl_a_mask   (tl_a_mask),
+    .tl_a_data   (tl_a_data),
+
+    // TileLink D Channel
+    .tl_d_valid  (tl_d_valid),
+    .tl_d_ready  (tl_d_ready),
+    .tl_d_opcode (tl_d_opcode),
+    .tl_d_param  (tl_d_param),
+    .tl_d_size   (tl_d_size),
+    .tl_d_source (tl_d_source),
+    .tl_d_data   (tl_d_data),
+    .tl_d_corrupt(tl_d_corrupt),
+    .tl_d_denied (tl_d_denied)
+);
+
+// ====================================
+// Testbench Tasks
+// ====================================
+
+// Task to perform one request via the TileLink A and D channels, the response is kept in
+// last_opcode, last_denied and last_read
+reg [2:0]      last_opcode;
+reg            last_denied;
+reg [XLEN-1:0] last_read;
+task Access(
+    input              read,
+    input [XLEN-1:0]   address,
+    input [2:0]        size,
+    input [XLEN-1:0]   value
+);
+    integer wait_cycles;
+
+    begin
+        @(posedge clk);
+        // Drive TileLink A channel signals
+        tl_a_valid   = 1'b1;
+        tl_a_opcode  = read ? 3'b100 : 3'b000; // GET or PUT_FULL_DATA
+        tl_a_param   = 3'b000;
+        tl_a_size    = size;
+        tl_a_source  = 2'b01;
+        tl_a_address = address;
+        tl_a_mask    = {(XLEN/8){1'b1}};
+        tl_a_data    = value;
+
+        // Wait for tl_a_ready
+        wait_cycles = 0;
+        while (!tl_a_ready && wait_cycles < 100) begin
+            @(posedge clk);
+            wait_cycles = wait_cycles + 1;
+        end
+
+        if (!tl_a_ready) begin
+            $display("\033[91mERROR: Access timeout waiting for tl_a_ready\033[0m");
+            $stop;
+        end
+
+        // Handshake complete, deassert tl_a_valid
+        @(posedge clk);
+        tl_a_valid = 1'b0;
+
+        // Wait for D channel response
+        wait_cycles = 0;
+        while (!tl_d_valid && wait_cycles < 100) begin
+            @(posedge clk);
+            wait_cycles = wait_cycles + 1;
+        end
+
+        if (!tl_d_valid) begin
+            $display("\033[91mERROR: Access timeout waiting for tl_d_valid\033[0m");
+            $stop;
+        end
+
+        last_opcode = tl_d_opcode;
+        last_denied = tl_d_denied;
+        last_read   = tl_d_data;
+
+        // Assert tl_d_ready to acknowledge reception
+        tl_d_ready = 1'b1;
+
+        @(posedge clk);
+        tl_d_ready = 1'b0;
+
+        @(posedge clk);
+    end
+endtask
+
+`define WRITE(address, size, value) Access(1'b0, address, size, value)
+`define READ(address, size)         Access(1'b1, address, size, {XLEN{1'b0}})
+
+reg [XLEN-1:0] first_read;
+
+// ====================================
+// Test Sequence
+// ====================================
+initial begin
+    $dumpfile("tl_ul_timer_tb.vcd");
+    $dumpvars(0, tl_ul_timer_tb);
+
+    // Initialize Inputs
+    reset        = 1;
+    tl_a_valid   = 0;
+    tl_a_opcode  = 3'b000;
+    tl_a_param   = 3'b000;
+    tl_a_size    = 3'b000;
+    tl_a_source  = {SID_WIDTH{1'b0}};
+    tl_a_address = {XLEN{1'b0}};
+    tl_a_mask    = {(XLEN/8){1'b0}};
+    tl_a_data    = {XLEN{1'b0}};
+    tl_d_ready   = 0;
+
+    #20;
+    reset = 0;
+    @(posedge clk);
+
+    `TEST("tl_ul_timer", "Timer resets with mtimecmp all ones and irq low")
+    `READ('h8, 3'd2);
+    `EXPECT("MTIMECMP low", last_read[31:0], 32'hFFFF_FFFF)
+    `READ('hC, 3'd2);
+    `EXPECT("MTIMECMP high", last_read[31:0], 32'hFFFF_FFFF)
+    `EXPECT("irq is low", timer_irq, 1'b0)
+
+    `TEST("tl_ul_timer", "mtime counts once every DIVIDER cycles")
+    `READ('h0, 3'd2);
+    first_read = last_read;
+    repeat (40) @(posedge clk);
+    `READ('h0, 3'd2);
+    `EXPECT("Response is AccessAckData", last_opcode, 3'b010)
+    `EXPECT("mtime advanced about 13 ticks", ((last_read[31:0] - first_read[31:0]) >= 10 &&
+                                                (last_read[31:0] - first_read[31:0]) <= 16), 1'b1)
+
+    `TEST("tl_ul_timer", "Write mtime")
+    `WRITE('h4, 3'd2, 'h0000_0001);
+    `EXPECT("Response is AccessAck", last_opcode, 3'b000)
+    `WRITE('h0, 3'd2, 'h0000_0100);
+    `READ('h4, 3'd2);
+    `EXPECT("MTIME high", last_read[31:0], 32'h0000_0001)
+    `READ('h0, 3'd2);
+    `EXPECT("MTIME low counts on from the written value", (last_read[31:0] >= 32'h100 &&
+                                                           last_read[31:0] < 32'h110), 1'b1)
+    `READ('h1, 3'd0);
+    `EXPECT("MTIME byte 1", last_read[7:0], 8'h01)
+
+    `TEST("tl_ul_timer", "irq rises when mtime reaches mtimecmp")
+    `WRITE('h0, 3'd2, 'h0000_0000);
+    `WRITE('hC, 3'd2, 'hFFFF_FFFF);
+    `WRITE('h8, 3'd2, 'h0000_0080);
+    `WRITE('hC, 3'd2, 'h0000_0001);
+    `EXPECT("irq is low before the deadline", timer_irq, 1'b0)
+    wait (timer_irq == 1'b1);
+    `READ('h0, 3'd2);
+    `EXPECT("MTIME low is past the deadline", (last_read[31:0] >= 32'h80), 1'b1)
+    `EXPECT("irq stays high", timer_irq, 1'b1)
+
+    `TEST("tl_ul_timer", "irq drops when mtimecmp moves")
+    `WRITE('hC, 3'd2, 'hFFFF_FFFF);
+    @(posedge clk);
+    `EXPECT("irq is low", timer_irq, 1'b0)
+
+    `TEST("tl_ul_timer", "Byte and misaligned writes are denied")
+    `WRITE('h8, 3'd0, 'h0000_0012);
+    `EXPECT("Byte write is denied", last_denied, 1'b1)
+    `EXPECT("Response is AccessAckError", last_opcode, 3'b111)
+    `WRITE('h9, 3'd2, 'h0000_0012);
+    `EXPECT("Misaligned write is denied", last_denied, 1'b1)
+    `READ('h8, 3'd2);
+    `EXPECT("MTIMECMP low not changed", last_read[31:0], 32'h0000_0080)
+
+    if (XLEN == 64) begin
+        `TEST("tl_ul_timer", "64 bit access to a whole register")
+        `WRITE('h8, 3'd3, 'h1234_5678_9ABC_DEF0);
+        `READ('h8, 3'd3);
+        `EXPECT("MTIMECMP", last_read, 'h1234_5678_9ABC_DEF0)
+        `READ('hC, 3'd2);
+        `EXPECT("MTIMECMP high", last_read[31:0], 32'h1234_5678)
+        `WRITE('h4, 3'd3, 'h0000_0000_0000_0000);
+        `EXPECT("Misaligned 64 bit write is denied", last_denied, 1'b1)
+    end
+
+    `FINISH;
+end
+
+endmodule
@@ -69,6 +69,8 @@ wire                    tl_d_denied;
 wire                    uart_tx;
 reg                     uart_rx;
 wire                    uart_irq;
+wire                    uart_rts;
+reg                     uart_cts;
 
 // ====================================
 // Instantiate UART
@@ -106,7 +108,9 @@ tl_ul_uart #(
     // UART
     .rx          (uart_rx),
     .tx          (uart_tx),
-    .irq         (uart_irq)
+    .irq         (uart_irq),
+    .rts         (uart_rts),
+    .cts         (uart_cts)
 );
 
 // ====================================
@@ -327,6 +331,23 @@ uart_baud_monitor #(
     .out_byte   (rx_byte)
 );
 
+// Decoder for the 3 Mbaud tests
+reg       fast_rx_ready;
+reg [7:0] fast_rx_byte;
+uart_baud_monitor #(
+    .CLK_FREQ_MHZ(`CLK_FREQ_MHZ),
+    .BAUD_RATE(3000000),
+    .OVERSAMPLE(16)
+) fast_monitor (
+    .clk        (clk),
+    .reset      (reset),
+    .uart_tx    (uart_tx),
+    .out_ready  (fast_rx_ready),
+    .out_byte   (fast_rx_byte)
+);
+
+integer n;
+
 // ====================================
 // Test Sequence
 // ====================================
@@ -348,6 +369,7 @@ initial begin
     tl_d_ready = 1'b0;
 
     uart_rx = 1'b1; // Idle high
+    uart_cts = 1'b0; // Clear to send
 
     // ====================================
     // Apply Reset
@@ -446,6 +468,137 @@ initial begin
     `EXPECT("UART IRQ should still be high after last read", uart_irq, 1'b0);
     `EXPECT("Read byte from RX buffer 'O'", last_read, 'h4F);
 
+    // ====================================
+    // Test Word Send
+    // ====================================
+    `TEST("tl_ul_uart", "Word Send (0x41, 0x42, 0x43, 0x44)");
+    @(posedge clk);
+    wait(~rx_ready);
+
+    WriteData('h08, 3'b010, 4'b1111, 'h44434241); // Queue "ABCD" in one write
+    ReadData(32'h10, 3'b010);
+    `EXPECT("TX FIFO holds the other 3 or 4 bytes", (last_read[31:16] >= 3 && last_read[31:16] <= 4), 1'b1);
+    wait(rx_ready);
+    `EXPECT("Should recieve 'A'", rx_byte, 'h41);
+    wait(~rx_ready);
+    wait(rx_ready);
+    `EXPECT("Should recieve 'B'", rx_byte, 'h42);
+    wait(~rx_ready);
+    wait(rx_ready);
+    `EXPECT("Should recieve 'C'", rx_byte, 'h43);
+    wait(~rx_ready);
+    wait(rx_ready);
+    `EXPECT("Should recieve 'D'", rx_byte, 'h44);
+    wait(~rx_ready);
+
+    // ====================================
+    // Test RX Threshold and Multi Byte Read
+    // ====================================
+    `TEST("tl_ul_uart", "RX Threshold IRQ and Half Word Read");
+    @(posedge clk);
+    WriteData('h0C, 3'b010, 4'b1111, 'h0000_0003); // RX threshold of 3 bytes
+    SendByte(8'h31, 115200);
+    SendByte(8'h32, 115200);
+    `EXPECT("UART IRQ should be low below the threshold", uart_irq, 1'b0);
+    SendByte(8'h33, 115200);
+    `EXPECT("UART IRQ should be high at the threshold", uart_irq, 1'b1);
+    ReadData(32'h10, 3'b010);
+    `EXPECT("RX FIFO holds 3 bytes", last_read[15:0], 16'd3);
+    ReadData(32'h08, 3'b001);
+    `EXPECT("Read half word from RX buffer", last_read[15:0], 16'h3231);
+    `EXPECT("UART IRQ should be low below the threshold", uart_irq, 1'b0);
+    ReadData(32'h08, 3'b000);
+    `EXPECT("Read byte from RX buffer '3'", last_read, 'h33);
+
+    // ====================================
+    // Test RX Timeout
+    // ====================================
+    `TEST("tl_ul_uart", "RX Timeout IRQ");
+    @(posedge clk);
+    WriteData('h0C, 3'b010, 4'b1111, 'h0002_0004); // RX threshold of 4 bytes, RX timeout on
+    SendByte(8'h5A, 115200);
+    `EXPECT("UART IRQ should be low below the threshold", uart_irq, 1'b0);
+    repeat (42 * ((`CLK_FREQ_MHZ * 1000000) / 115200)) @(posedge clk);
+    `EXPECT("UART IRQ should be high after the timeout", uart_irq, 1'b1);
+    ReadData(32'h00, 3'b000);
+    `EXPECT("Status shows the RX timeout", last_read[6], 1'b1);
+    ReadData(32'h08, 3'b000);
+    `EXPECT("Read byte from RX buffer 'Z'", last_read, 'h5A);
+    `EXPECT("UART IRQ should be low once empty", uart_irq, 1'b0);
+
+    // ====================================
+    // Test TX Threshold
+    // ====================================
+    `TEST("tl_ul_uart", "TX Threshold IRQ");
+    @(posedge clk);
+    WriteData('h0C, 3'b010, 4'b1111, 'h0001_0001); // TX threshold of 0 bytes, TX IRQ on
+    @(posedge clk);
+    `EXPECT("UART IRQ should be high with an empty TX FIFO", uart_irq, 1'b1);
+    WriteData('h08, 3'b001, 4'b0011, 'h4B4F); // Queue "OK"
+    `EXPECT("UART IRQ should be low while sending", uart_irq, 1'b0);
+    wait(rx_ready);
+    `EXPECT("Should recieve 'O'", rx_byte, 'h4F);
+    wait(~rx_ready);
+    wait(rx_ready);
+    `EXPECT("Should recieve 'K'", rx_byte, 'h4B);
+    `EXPECT("UART IRQ should be high once drained", uart_irq, 1'b1);
+    WriteData('h0C, 3'b010, 4'b1111, 'h0000_0001); // Back to the reset thresholds
+    @(posedge clk);
+    `EXPECT("UART IRQ should be low", uart_irq, 1'b0);
+
+    // ====================================
+    // Test Fractional Baud Divisor
+    // ====================================
+    `TEST("tl_ul_uart", "3 Mbaud from a Fractional Divisor");
+    @(posedge clk);
+    WriteData('h14, 3'b010, 4'b1111, 'h0000_2155); // 33.33 cycles per bit
+    ReadData(32'h14, 3'b010);
+    `EXPECT("Baud divisor reads back", last_read[31:0], 32'h0000_2155);
+    WriteData('h08, 3'b000, 4'b0001, 'h55);
+    wait(fast_rx_ready);
+    `EXPECT("Should recieve 0x55 at 3 Mbaud", fast_rx_byte, 'h55);
+    SendByte(8'hC3, 3000000);
+    ReadData(32'h08, 3'b000);
+    `EXPECT("Read byte from RX buffer at 3 Mbaud", last_read, 'hC3);
+
+    // ====================================
+    // Test RTS
+    // ====================================
+    `TEST("tl_ul_uart", "RTS Rises When the RX FIFO Is Nearly Full");
+    @(posedge clk);
+    `EXPECT("RTS should be low without flow control", uart_rts, 1'b0);
+    WriteData('h04, 3'b000, 4'b0001, 'h61); // Flow control, IRQ enabled
+    for (n = 0; n < 14; n = n + 1) begin
+        SendByte(n, 3000000);
+    end
+    `EXPECT("RTS should be low with room left", uart_rts, 1'b0);
+    SendByte(8'h0E, 3000000);
+    `EXPECT("RTS should be high with one byte of room", uart_rts, 1'b1);
+    ReadData(32'h08, 3'b000);
+    `EXPECT("Read byte from RX buffer", last_read, 'h00);
+    `EXPECT("RTS should be low after a read", uart_rts, 1'b0);
+    for (n = 1; n < 15; n = n + 1) begin
+        ReadData(32'h08, 3'b000);
+        `EXPECT("Read byte from RX buffer", last_read, n);
+    end
+
+    // ====================================
+    // Test CTS
+    // ====================================
+    `TEST("tl_ul_uart", "CTS Holds Transmission");
+    @(posedge clk);
+    uart_cts = 1'b1;
+    WriteData('h08, 3'b000, 4'b0001, 'h5A);
+    repeat (200) @(posedge clk);
+    `EXPECT("TX should stay idle", uart_tx, 1'b1);
+    ReadData(32'h10, 3'b010);
+    `EXPECT("TX FIFO still holds the byte", last_read[31:16], 16'd1);
+    uart_cts = 1'b0;
+    wait(fast_rx_ready);
+    `EXPECT("Should recieve 0x5A once clear to send", fast_rx_byte, 'h5A);
+    WriteData('h04, 3'b000, 4'b0001, 'h21); // Back to the reset config
+    WriteData('h14, 3'b010, 4'b1111, 'h0000_0000);
+
     // ====================================
     // Finish Testbench
     // ====================================